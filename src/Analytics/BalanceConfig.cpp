@@ -0,0 +1,68 @@
+#include "BalanceConfig.h"
+
+namespace ArenaFighter {
+
+namespace {
+
+const char* const ATTACK_NAMES[BalanceConfig::ATTACK_KINDS] = {
+    "light", "medium", "heavy", "special", "ultimate"
+};
+
+bool SetFrameData(FrameData& data, float& range, const std::string& field, float value) {
+    int frames = static_cast<int>(value);
+    if (field == "startup") data.startupFrames = frames;
+    else if (field == "active") data.activeFrames = frames;
+    else if (field == "recovery") data.recoveryFrames = frames;
+    else if (field == "hitstun") data.hitstunFrames = frames;
+    else if (field == "blockstun") data.blockstunFrames = frames;
+    else if (field == "damage") data.baseDamage = value;
+    else if (field == "mana") data.manaCost = value;
+    else if (field == "range") range = value;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+BalanceConfig BalanceConfig::Defaults() {
+    BalanceConfig config;
+    config.attacks[static_cast<int>(AttackType::Light)] = FrameDataPresets::CreateLightAttack();
+    config.attacks[static_cast<int>(AttackType::Medium)] = FrameDataPresets::CreateMediumAttack();
+    config.attacks[static_cast<int>(AttackType::Heavy)] = FrameDataPresets::CreateHeavyAttack();
+    config.attacks[static_cast<int>(AttackType::Special)] = FrameDataPresets::CreateSpecialMove();
+    config.attacks[static_cast<int>(AttackType::Ultimate)] = FrameDataPresets::CreateUltimateSkill();
+
+    const float ranges[ATTACK_KINDS] = { 70.0f, 90.0f, 110.0f, 160.0f, 140.0f };
+    for (int i = 0; i < ATTACK_KINDS; ++i) {
+        config.attackRange[i] = ranges[i];
+    }
+    return config;
+}
+
+bool BalanceConfig::Set(const std::string& name, float value) {
+    size_t dot = name.find('.');
+    if (dot == std::string::npos) {
+        if (name == "health") maxHealth = value;
+        else if (name == "mana") maxMana = value;
+        else if (name == "regen") manaRegen = value;
+        else if (name == "defense") defense = value;
+        else if (name == "speed") walkSpeed = value;
+        else return false;
+        return true;
+    }
+
+    std::string attack = name.substr(0, dot);
+    for (int i = 0; i < ATTACK_KINDS; ++i) {
+        if (attack == ATTACK_NAMES[i]) {
+            return SetFrameData(attacks[i], attackRange[i], name.substr(dot + 1), value);
+        }
+    }
+    return false;
+}
+
+const char* GetAttackName(AttackType type) {
+    int index = static_cast<int>(type);
+    return index >= 0 && index < BalanceConfig::ATTACK_KINDS ? ATTACK_NAMES[index] : "unknown";
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include "../Combat/CombatEnums.h"
+#include "../Combat/FrameData.h"
+
+namespace ArenaFighter {
+
+// The tunable numbers a match is simulated with: the frame data of the
+// five kinds of attack plus the fighters' stats. Defaults() is the game's
+// current tuning, built from FrameDataPresets; balance changes are tried
+// by changing single values with Set() and re-simulating recorded matches.
+struct BalanceConfig {
+    static constexpr int ATTACK_KINDS = 5;   // Indexed by AttackType
+
+    FrameData attacks[ATTACK_KINDS];
+    float attackRange[ATTACK_KINDS];   // Reach in front of the attacker
+    float maxHealth = BASE_HEALTH;
+    float maxMana = BASE_MANA;
+    float manaRegen = MANA_REGEN;      // Per second
+    float defense = BASE_DEFENSE;
+    float walkSpeed = 300.0f;          // Units per second
+
+    static BalanceConfig Defaults();
+
+    // Changes one value: "<attack>.<field>" such as "heavy.startup" or
+    // "light.damage", or a fighter stat such as "health". Returns false
+    // for an unknown name.
+    bool Set(const std::string& name, float value);
+
+    const FrameData& GetAttack(AttackType type) const { return attacks[static_cast<int>(type)]; }
+    float GetRange(AttackType type) const { return attackRange[static_cast<int>(type)]; }
+};
+
+// Lowercase name as used by BalanceConfig::Set(), e.g. "heavy"
+const char* GetAttackName(AttackType type);
+
+} // namespace ArenaFighter
@@ -0,0 +1,141 @@
+#include "BalanceConfig.h"
+#include "DuelBot.h"
+#include "ReplayAnalyzer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ArenaFighter;
+
+namespace {
+
+constexpr const char* REPLAY_EXTENSION = ".dfrp";
+
+void PrintStats(const char* title, const BatchResult& result) {
+    const BalanceStats& stats = result.stats;
+    std::cout << "\n" << title << ": " << result.replays << " replays, " << stats.frames << " frames, "
+              << stats.knockouts << " knockouts";
+    if (result.unreadable > 0) {
+        std::cout << ", " << result.unreadable << " unreadable";
+    }
+    std::cout << "\n";
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  attack      uses    hit%  block%  counter%  dmg/hit  dmg share  adv hit  adv block\n";
+    double totalDamage = 0.0;
+    for (const AttackStats& attack : stats.attacks) {
+        totalDamage += attack.damage;
+    }
+
+    for (int i = 0; i < BalanceConfig::ATTACK_KINDS; ++i) {
+        const AttackStats& attack = stats.attacks[i];
+        double uses = static_cast<double>(std::max<uint64_t>(attack.uses, 1));
+        double hits = static_cast<double>(std::max<uint64_t>(attack.hits, 1));
+        double blocks = static_cast<double>(std::max<uint64_t>(attack.blocks, 1));
+        std::cout << "  " << std::left << std::setw(10) << GetAttackName(static_cast<AttackType>(i)) << std::right
+                  << std::setw(6) << attack.uses
+                  << std::setw(8) << attack.hits * 100.0 / uses
+                  << std::setw(8) << attack.blocks * 100.0 / uses
+                  << std::setw(10) << attack.counterHits * 100.0 / hits
+                  << std::setw(9) << attack.damage / hits
+                  << std::setw(10) << (totalDamage > 0.0 ? attack.damage * 100.0 / totalDamage : 0.0) << "%"
+                  << std::setw(9) << static_cast<double>(attack.advantageOnHit) / hits
+                  << std::setw(11) << static_cast<double>(attack.advantageOnBlock) / blocks << "\n";
+    }
+
+    uint64_t combos = stats.GetCombos(2);
+    std::cout << "  combos of 2+ hits: " << combos << ", average " << stats.GetAverageComboLength(2)
+              << " hits, " << (combos > 0 ? stats.comboDamage / static_cast<double>(combos) : 0.0)
+              << " damage, " << stats.repetitiveCombos << " repetitive\n  lengths:";
+    for (int hits = 2; hits <= BalanceStats::MAX_COMBO; ++hits) {
+        if (stats.comboLengths[hits] > 0) {
+            std::cout << " " << hits << "x" << stats.comboLengths[hits];
+        }
+    }
+    std::cout << "\n  " << std::setprecision(0) << result.GetRealTimeFactor() << "x real time per core"
+              << std::defaultfloat << std::endl;
+}
+
+void PrintUsage() {
+    std::cout << "Usage: dfr_balance [options] [replay files or directories]\n"
+              << "Re-simulates recorded duels and reports per-attack damage, combo lengths and\n"
+              << "frame advantage.\n"
+              << "  --threads N          Worker threads (default: one per core)\n"
+              << "  --set NAME=VALUE     Change a balance value, e.g. heavy.startup=20, light.damage=60\n"
+              << "                       or health=1200; may be repeated. The replays are then also\n"
+              << "                       simulated with the changes and both results are printed.\n"
+              << "  --bots N             Add N bot matches instead of recorded ones\n"
+              << "  --frames N           Length of bot matches (default 5940, a 99 second round)\n"
+              << "Directories are searched for *" << REPLAY_EXTENSION << " files." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t bots = 0;
+    uint32_t botFrames = 99 * 60;
+    BalanceConfig changed = BalanceConfig::Defaults();
+    bool hasChanges = false;
+    ReplayBatch batch;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--threads" && hasValue) {
+            threads = static_cast<unsigned>(std::max(std::atoi(argv[++i]), 1));
+        } else if (arg == "--bots" && hasValue) {
+            bots = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 0));
+        } else if (arg == "--frames" && hasValue) {
+            botFrames = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+        } else if (arg == "--set" && hasValue) {
+            std::string assignment = argv[++i];
+            size_t equals = assignment.find('=');
+            if (equals == std::string::npos ||
+                !changed.Set(assignment.substr(0, equals), std::strtof(assignment.c_str() + equals + 1, nullptr))) {
+                std::cerr << "Unknown balance value: " << assignment << std::endl;
+                return 1;
+            }
+            hasChanges = true;
+        } else if (arg == "--help" || arg.rfind("--", 0) == 0) {
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        } else if (std::filesystem::is_directory(arg)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(arg)) {
+                if (entry.is_regular_file() && entry.path().extension() == REPLAY_EXTENSION) {
+                    batch.AddFile(entry.path().string());
+                }
+            }
+        } else {
+            batch.AddFile(arg);
+        }
+    }
+
+    for (uint32_t i = 0; i < bots; ++i) {
+        batch.AddData(RecordBotMatch(i + 1, botFrames));
+    }
+    if (batch.GetCount() == 0) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::cout << "Re-simulating " << batch.GetCount() << " replays on " << threads << " threads" << std::endl;
+
+    BatchResult baseline = batch.Run(BalanceConfig::Defaults(), threads);
+    PrintStats("Current balance", baseline);
+    if (baseline.unverified > 0) {
+        std::cout << "  " << baseline.unverified << " replays did not reach their recorded final state;"
+                  << " they were played with other values" << std::endl;
+    }
+
+    if (hasChanges) {
+        PrintStats("With changes", batch.Run(changed, threads));
+    }
+    return 0;
+}
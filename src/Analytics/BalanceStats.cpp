@@ -0,0 +1,108 @@
+#include "BalanceStats.h"
+#include "../Network/NetworkConfig.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+void AttackStats::Merge(const AttackStats& other) {
+    uses += other.uses;
+    hits += other.hits;
+    blocks += other.blocks;
+    counterHits += other.counterHits;
+    damage += other.damage;
+    advantageOnHit += other.advantageOnHit;
+    advantageOnBlock += other.advantageOnBlock;
+    worstAdvantageOnHit = std::min(worstAdvantageOnHit, other.worstAdvantageOnHit);
+    bestAdvantageOnHit = std::max(bestAdvantageOnHit, other.bestAdvantageOnHit);
+}
+
+void BalanceStats::Merge(const BalanceStats& other) {
+    for (int i = 0; i < BalanceConfig::ATTACK_KINDS; ++i) {
+        attacks[i].Merge(other.attacks[i]);
+    }
+    for (int i = 0; i <= MAX_COMBO; ++i) {
+        comboLengths[i] += other.comboLengths[i];
+    }
+    comboDamage += other.comboDamage;
+    repetitiveCombos += other.repetitiveCombos;
+    matches += other.matches;
+    knockouts += other.knockouts;
+    frames += other.frames;
+}
+
+uint64_t BalanceStats::GetCombos(int minHits) const {
+    uint64_t combos = 0;
+    for (int i = std::max(minHits, 0); i <= MAX_COMBO; ++i) {
+        combos += comboLengths[i];
+    }
+    return combos;
+}
+
+double BalanceStats::GetAverageComboLength(int minHits) const {
+    uint64_t combos = 0;
+    uint64_t hits = 0;
+    for (int i = std::max(minHits, 0); i <= MAX_COMBO; ++i) {
+        combos += comboLengths[i];
+        hits += comboLengths[i] * static_cast<uint64_t>(i);
+    }
+    return combos > 0 ? static_cast<double>(hits) / static_cast<double>(combos) : 0.0;
+}
+
+BalanceRecorder::BalanceRecorder(BalanceStats& stats)
+    : m_stats(stats) {
+}
+
+void BalanceRecorder::OnAttack(int /*fighter*/, AttackType type) {
+    m_stats.attacks[static_cast<int>(type)].uses++;
+}
+
+void BalanceRecorder::OnHit(const DuelHit& hit) {
+    AttackStats& attack = m_stats.attacks[static_cast<int>(hit.type)];
+
+    if (hit.blocked) {
+        attack.blocks++;
+        attack.advantageOnBlock += hit.frameAdvantage;
+        return;
+    }
+
+    attack.hits++;
+    attack.counterHits += hit.counter ? 1 : 0;
+    attack.damage += hit.damage;
+    attack.advantageOnHit += hit.frameAdvantage;
+    attack.worstAdvantageOnHit = std::min(attack.worstAdvantageOnHit, hit.frameAdvantage);
+    attack.bestAdvantageOnHit = std::max(attack.bestAdvantageOnHit, hit.frameAdvantage);
+
+    m_combos[hit.attacker].RegisterHit(hit.type, hit.damage, 1 - hit.attacker);
+}
+
+void BalanceRecorder::OnComboEnd(int attacker) {
+    ComboSystem& combo = m_combos[attacker];
+    int hits = std::min(combo.GetHitCount(), BalanceStats::MAX_COMBO);
+    if (hits == 0) {
+        return;
+    }
+
+    m_stats.comboLengths[hits]++;
+    if (hits > 1) {
+        m_stats.comboDamage += combo.GetTotalDamage();
+    }
+    m_stats.repetitiveCombos += combo.IsRepetitive() ? 1 : 0;
+    combo.Reset();
+}
+
+void BalanceRecorder::OnFrameEnd(uint32_t /*frame*/) {
+    // Keeps the combo clocks in step with the simulation
+    for (ComboSystem& combo : m_combos) {
+        combo.Update(1.0f / NetworkConfig::TICK_RATE);
+    }
+}
+
+void BalanceRecorder::FinishMatch(const DuelSimulation& simulation) {
+    OnComboEnd(0);
+    OnComboEnd(1);
+    m_stats.matches++;
+    m_stats.knockouts += simulation.IsOver() ? 1 : 0;
+    m_stats.frames += simulation.GetState().frame;
+}
+
+} // namespace ArenaFighter
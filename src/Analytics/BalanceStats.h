@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include "BalanceConfig.h"
+#include "DuelSimulation.h"
+#include "../Combat/ComboSystem.h"
+
+namespace ArenaFighter {
+
+struct AttackStats {
+    uint64_t uses = 0;
+    uint64_t hits = 0;
+    uint64_t blocks = 0;
+    uint64_t counterHits = 0;
+    double damage = 0.0;
+    int64_t advantageOnHit = 0;     // Sums; divide by hits or blocks
+    int64_t advantageOnBlock = 0;
+    int32_t worstAdvantageOnHit = INT32_MAX;
+    int32_t bestAdvantageOnHit = INT32_MIN;
+
+    void Merge(const AttackStats& other);
+};
+
+// Totals over any number of matches; merging per-thread totals gives the
+// same result as counting on one thread
+struct BalanceStats {
+    static constexpr int MAX_COMBO = ComboSystem::MAX_COMBO_LENGTH;
+
+    AttackStats attacks[BalanceConfig::ATTACK_KINDS];   // By AttackType
+    uint64_t comboLengths[MAX_COMBO + 1] = {};          // Combos by hit count
+    double comboDamage = 0.0;                           // Of combos of two or more hits
+    uint64_t repetitiveCombos = 0;                      // Flagged by ComboSystem::IsRepetitive()
+    uint64_t matches = 0;
+    uint64_t knockouts = 0;
+    uint64_t frames = 0;
+
+    void Merge(const BalanceStats& other);
+
+    const AttackStats& GetAttack(AttackType type) const { return attacks[static_cast<int>(type)]; }
+    uint64_t GetCombos(int minHits) const;
+    double GetAverageComboLength(int minHits) const;
+};
+
+// Turns a DuelSimulation's events into BalanceStats. Each fighter's combo
+// is fed to a ComboSystem as it happens, and its totals are counted once
+// the defender recovers.
+class BalanceRecorder : public DuelObserver {
+public:
+    explicit BalanceRecorder(BalanceStats& stats);
+
+    void OnAttack(int fighter, AttackType type) override;
+    void OnHit(const DuelHit& hit) override;
+    void OnComboEnd(int attacker) override;
+    void OnFrameEnd(uint32_t frame) override;
+
+    // Counts the match and any combo still running
+    void FinishMatch(const DuelSimulation& simulation);
+
+private:
+    BalanceStats& m_stats;
+    ComboSystem m_combos[2];
+};
+
+} // namespace ArenaFighter
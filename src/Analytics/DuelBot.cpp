@@ -0,0 +1,95 @@
+#include "DuelBot.h"
+#include "../Core/FixedPoint.h"
+#include "../Network/Replay.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+namespace ArenaFighter {
+
+DuelBot::DuelBot(int fighter, uint64_t seed)
+    : m_fighter(fighter)
+    , m_random(seed)
+    , m_held(0)
+    , m_framesLeft(0) {
+}
+
+uint32_t DuelBot::NextInput(const DuelSimulation& simulation) {
+    if (m_framesLeft == 0) {
+        // Attack buttons are let go for a frame so the next press registers
+        if (m_held >= DuelSimulation::Light) {
+            m_held = 0;
+            m_framesLeft = 1;
+        } else {
+            m_held = Decide(simulation);
+        }
+    }
+    m_framesLeft--;
+    return m_held;
+}
+
+uint32_t DuelBot::Decide(const DuelSimulation& simulation) {
+    const DuelSimulation::Fighter& self = simulation.GetState().fighters[m_fighter];
+    const DuelSimulation::Fighter& other = simulation.GetState().fighters[1 - m_fighter];
+    float distance = Fixed::FromRaw(std::abs(self.x - other.x)).ToFloat();
+    uint32_t toward = other.x > self.x ? DuelSimulation::Right : DuelSimulation::Left;
+    uint32_t away = toward == DuelSimulation::Right ? DuelSimulation::Left : DuelSimulation::Right;
+
+    // Keep a combo going by chaining into a stronger attack
+    if (other.hitstun > 0 && distance <= simulation.GetConfig().attackRange[0] + 20.0f) {
+        m_framesLeft = 1;
+        if (self.attack == DuelSimulation::NO_ATTACK) {
+            return DuelSimulation::Light;
+        }
+        int next = std::min(self.attack + 1 + static_cast<int>(m_random.NextInt(2)), BalanceConfig::ATTACK_KINDS - 1);
+        return DuelSimulation::Light << next;
+    }
+
+    if (other.attack != DuelSimulation::NO_ATTACK && distance < 180.0f && m_random.NextChance(35)) {
+        m_framesLeft = static_cast<uint32_t>(m_random.NextRange(6, 16));
+        return DuelSimulation::Block;
+    }
+
+    if (distance > 120.0f || m_random.NextChance(15)) {
+        m_framesLeft = static_cast<uint32_t>(m_random.NextRange(3, 12));
+        return m_random.NextChance(85) ? toward : away;
+    }
+
+    // Light 40%, medium 25%, heavy 18%, special 12%, ultimate 5%
+    const uint32_t weights[BalanceConfig::ATTACK_KINDS] = { 40, 25, 18, 12, 5 };
+    uint32_t roll = m_random.NextInt(100);
+    int type = 0;
+    while (type < BalanceConfig::ATTACK_KINDS - 1 && roll >= weights[type]) {
+        roll -= weights[type];
+        type++;
+    }
+    m_framesLeft = static_cast<uint32_t>(m_random.NextRange(1, 3));
+    return DuelSimulation::Light << type;
+}
+
+std::string RecordBotMatch(uint64_t seed, uint32_t maxFrames, const BalanceConfig& config) {
+    ReplayHeader header;
+    header.matchId = static_cast<uint32_t>(seed);
+    header.randomSeed = static_cast<uint32_t>(seed * 2654435761u);
+    header.playerCount = 2;
+    header.playerIds[0] = 1;
+    header.playerIds[1] = 2;
+
+    std::ostringstream out;
+    ReplayWriter writer(out);
+    writer.Begin(header);
+    SeedSimulationRandom(header.randomSeed);
+
+    DuelSimulation simulation(config);
+    DuelBot bots[2] = { DuelBot(0, seed * 2 + 1), DuelBot(1, seed * 2 + 2) };
+    for (uint32_t frame = 0; frame < maxFrames && !simulation.IsOver(); ++frame) {
+        uint32_t inputs[2] = { bots[0].NextInput(simulation), bots[1].NextInput(simulation) };
+        simulation.AdvanceFrame(inputs, 2);
+        writer.AddFrame(inputs);
+    }
+
+    writer.Finish(HashSimulationState(simulation));
+    return out.str();
+}
+
+} // namespace ArenaFighter
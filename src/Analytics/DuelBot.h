@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "BalanceConfig.h"
+#include "DuelSimulation.h"
+#include "../Core/DeterministicRandom.h"
+
+namespace ArenaFighter {
+
+// Plays one side of a DuelSimulation: closes in, attacks when in range,
+// chains stronger attacks into a defender still in hitstun and sometimes
+// blocks what it sees coming. Decisions depend only on the seed and the
+// simulation state, so a bot match is reproducible.
+class DuelBot {
+public:
+    DuelBot(int fighter, uint64_t seed);
+
+    uint32_t NextInput(const DuelSimulation& simulation);
+
+private:
+    uint32_t Decide(const DuelSimulation& simulation);
+
+    int m_fighter;
+    DeterministicRandom m_random;
+    uint32_t m_held;
+    uint32_t m_framesLeft;
+};
+
+// Plays two bots against each other until a knockout or maxFrames and
+// returns the match as a replay stream, with the final state hash
+std::string RecordBotMatch(uint64_t seed, uint32_t maxFrames,
+                           const BalanceConfig& config = BalanceConfig::Defaults());
+
+} // namespace ArenaFighter
@@ -0,0 +1,261 @@
+#include "DuelSimulation.h"
+#include "../Combat/ComboSystem.h"
+#include "../Core/FixedPoint.h"
+#include "../Network/NetworkConfig.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ArenaFighter {
+
+namespace {
+
+constexpr Fixed HITSTUN_DECAY = Fixed::FromFloat(ComboSystem::HITSTUN_DECAY);
+
+Fixed PerFrame(float perSecond) {
+    return Fixed::FromFloat(perSecond) / Fixed(NetworkConfig::TICK_RATE);
+}
+
+} // namespace
+
+DuelSimulation::DuelSimulation(const BalanceConfig& config)
+    : m_config(config)
+    , m_observer(nullptr) {
+
+    m_damage.Initialize();
+
+    std::memset(&m_state, 0, sizeof(m_state));
+    for (int i = 0; i < 2; ++i) {
+        Fighter& fighter = m_state.fighters[i];
+        fighter.x = Fixed(i == 0 ? -100 : 100).Raw();
+        fighter.health = Fixed::FromFloat(m_config.maxHealth).Raw();
+        fighter.mana = Fixed::FromFloat(m_config.maxMana).Raw();
+        fighter.attack = NO_ATTACK;
+    }
+}
+
+size_t DuelSimulation::SaveState(uint8_t* buffer, size_t capacity) const {
+    if (capacity < sizeof(m_state)) return 0;
+    std::memcpy(buffer, &m_state, sizeof(m_state));
+    return sizeof(m_state);
+}
+
+void DuelSimulation::LoadState(const uint8_t* data, size_t size) {
+    if (size == sizeof(m_state)) std::memcpy(&m_state, data, size);
+}
+
+size_t DuelSimulation::DescribeState(StateField* fields, size_t maxFields) const {
+    const StateField layout[] = {
+        {"frame", offsetof(State, frame), sizeof(uint32_t)},
+        {"fighters[0]", offsetof(State, fighters), sizeof(Fighter)},
+        {"fighters[1]", offsetof(State, fighters) + sizeof(Fighter), sizeof(Fighter)},
+    };
+    size_t count = std::min(maxFields, sizeof(layout) / sizeof(layout[0]));
+    std::copy(layout, layout + count, fields);
+    return count;
+}
+
+bool DuelSimulation::IsOver() const {
+    return m_state.fighters[0].health <= 0 || m_state.fighters[1].health <= 0;
+}
+
+float DuelSimulation::GetHealth(int fighter) const {
+    return Fixed::FromRaw(m_state.fighters[fighter].health).ToFloat();
+}
+
+void DuelSimulation::AdvanceFrame(const uint32_t* inputs, size_t playerCount) {
+    m_state.frame++;
+
+    if (!IsOver()) {
+        // Stun from earlier frames runs out first, so a fighter can act on
+        // the frame their stun ends
+        for (int i = 0; i < 2; ++i) {
+            Fighter& fighter = m_state.fighters[i];
+            Fighter& other = m_state.fighters[1 - i];
+            if (fighter.blockstun > 0) {
+                fighter.blockstun--;
+            }
+            if (fighter.hitstun > 0 && --fighter.hitstun == 0 && other.comboHits > 0) {
+                other.comboHits = 0;
+                other.comboDamage = 0;
+                if (m_observer) m_observer->OnComboEnd(1 - i);
+            }
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            StepFighter(i, static_cast<size_t>(i) < playerCount ? inputs[i] : 0);
+        }
+
+        // Both checks see the same frame, so attacks landing together trade
+        bool connects[2] = { Connects(0), Connects(1) };
+        bool counters[2];
+        int32_t attacks[2];
+        int32_t attackFrames[2];
+        for (int i = 0; i < 2; ++i) {
+            const Fighter& defender = m_state.fighters[1 - i];
+            counters[i] = defender.attack != NO_ATTACK &&
+                !m_config.attacks[defender.attack].IsInRecovery(defender.attackFrame);
+            attacks[i] = m_state.fighters[i].attack;
+            attackFrames[i] = m_state.fighters[i].attackFrame;
+        }
+        for (int i = 0; i < 2; ++i) {
+            if (connects[i]) {
+                ResolveHit(i, attacks[i], attackFrames[i], counters[i]);
+            }
+        }
+    }
+
+    if (m_observer) {
+        m_observer->OnFrameEnd(m_state.frame);
+    }
+}
+
+void DuelSimulation::StepFighter(int index, uint32_t input) {
+    Fighter& fighter = m_state.fighters[index];
+    const Fighter& other = m_state.fighters[1 - index];
+    uint32_t pressed = input & ~fighter.lastInput;
+    fighter.lastInput = input;
+
+    Fixed maxMana = Fixed::FromFloat(m_config.maxMana);
+    fighter.mana = Fixed::Min(Fixed::FromRaw(fighter.mana) + PerFrame(m_config.manaRegen), maxMana).Raw();
+
+    if (fighter.attack != NO_ATTACK) {
+        const FrameData& data = m_config.attacks[fighter.attack];
+        fighter.attackFrame++;
+
+        // An attack that connected can be cancelled into a stronger one
+        // inside its cancel window
+        uint32_t stronger = pressed & ~((Light << (fighter.attack + 1)) - 1);
+        if (fighter.attackHit && data.CanBeCanceled(fighter.attackFrame) && StartAttack(index, stronger)) {
+            return;
+        }
+        if (fighter.attackFrame < data.GetTotalFrames()) {
+            return;
+        }
+        fighter.attack = NO_ATTACK;
+    }
+    if (fighter.hitstun > 0 || fighter.blockstun > 0) {
+        return;
+    }
+
+    if (StartAttack(index, pressed)) {
+        return;
+    }
+
+    if (input & Block) {
+        return;
+    }
+
+    int direction = (input & Right ? 1 : 0) - (input & Left ? 1 : 0);
+    if (direction == 0) {
+        return;
+    }
+
+    Fixed x = Fixed::FromRaw(fighter.x) + PerFrame(m_config.walkSpeed) * Fixed(direction);
+    x = Fixed::Clamp(x, Fixed::FromFloat(-STAGE_HALF_WIDTH), Fixed::FromFloat(STAGE_HALF_WIDTH));
+
+    Fixed otherX = Fixed::FromRaw(other.x);
+    Fixed spacing = Fixed::FromFloat(MIN_SPACING);
+    if (fighter.x < other.x) {
+        x = Fixed::Min(x, otherX - spacing);
+    } else {
+        x = Fixed::Max(x, otherX + spacing);
+    }
+    fighter.x = x.Raw();
+}
+
+bool DuelSimulation::StartAttack(int index, uint32_t pressed) {
+    Fighter& fighter = m_state.fighters[index];
+
+    // The strongest attack pressed this frame that the fighter can pay for
+    for (int type = BalanceConfig::ATTACK_KINDS - 1; type >= 0; --type) {
+        if (!(pressed & (Light << type))) continue;
+
+        Fixed cost = Fixed::FromFloat(m_config.attacks[type].manaCost);
+        if (Fixed::FromRaw(fighter.mana) < cost) continue;
+
+        fighter.mana = (Fixed::FromRaw(fighter.mana) - cost).Raw();
+        fighter.attack = type;
+        fighter.attackFrame = 0;
+        fighter.attackHit = 0;
+        if (m_observer) m_observer->OnAttack(index, static_cast<AttackType>(type));
+        return true;
+    }
+    return false;
+}
+
+bool DuelSimulation::Connects(int attacker) const {
+    const Fighter& fighter = m_state.fighters[attacker];
+    const Fighter& defender = m_state.fighters[1 - attacker];
+    if (fighter.attack == NO_ATTACK || fighter.attackHit ||
+        !m_config.attacks[fighter.attack].IsActive(fighter.attackFrame)) {
+        return false;
+    }
+
+    Fixed distance = Fixed::FromRaw(std::abs(fighter.x - defender.x));
+    return distance <= Fixed::FromFloat(m_config.attackRange[fighter.attack]);
+}
+
+void DuelSimulation::ResolveHit(int attacker, int32_t attack, int32_t attackFrame, bool counter) {
+    Fighter& fighter = m_state.fighters[attacker];
+    Fighter& defender = m_state.fighters[1 - attacker];
+    const FrameData& data = m_config.attacks[attack];
+    fighter.attackHit = 1;
+
+    // Frames until the attacker can act again
+    int recovery = data.GetTotalFrames() - attackFrame;
+
+    DuelHit hit{ attacker, static_cast<AttackType>(attack), 0.0f, false, counter, 0, 0 };
+
+    if ((defender.lastInput & Block) && defender.attack == NO_ATTACK && defender.hitstun == 0) {
+        defender.blockstun = std::max(defender.blockstun, data.blockstunFrames);
+        hit.blocked = true;
+        hit.frameAdvantage = defender.blockstun - recovery;
+        if (m_observer) m_observer->OnHit(hit);
+        return;
+    }
+
+    if (defender.hitstun == 0) {
+        fighter.comboHits = 0;
+        fighter.comboDamage = 0;
+    } else if (fighter.comboHits >= ComboSystem::MAX_COMBO_LENGTH) {
+        // Past the cap the defender drops out of the combo
+        defender.hitstun = 1;
+        return;
+    }
+    fighter.comboHits++;
+
+    DamageCalculator::DamageParams params{};
+    params.baseDamage = data.baseDamage;
+    params.attackerPower = 1.0f;
+    params.defenderDefense = m_config.defense;
+    params.damageType = DamageType::Physical;
+    params.attackType = data.attackType;
+    params.comboCount = fighter.comboHits - 1;
+    params.isCounter = counter;
+    params.isCritical = false;
+    params.attackerElement = ElementType{};
+    params.defenderElement = ElementType{};
+    params.defenderState = CharacterState{};
+
+    // A combo deals at most ComboSystem::MAX_DAMAGE_PERCENT of max health
+    Fixed damage = Fixed::FromFloat(m_damage.CalculateDamage(params));
+    Fixed comboLimit = Fixed::FromFloat(m_config.maxHealth * ComboSystem::MAX_DAMAGE_PERCENT);
+    damage = Fixed::Clamp(damage, Fixed(0), Fixed::Max(comboLimit - Fixed::FromRaw(fighter.comboDamage), Fixed(0)));
+    fighter.comboDamage += damage.Raw();
+    defender.health -= damage.Raw();
+
+    int hitstun = (Fixed(data.hitstunFrames) * Fixed::Pow(HITSTUN_DECAY, fighter.comboHits - 1)).ToInt();
+    if (counter) {
+        hitstun = hitstun * 3 / 2;
+    }
+    defender.hitstun = std::max(hitstun, 1);
+    defender.blockstun = 0;
+    defender.attack = NO_ATTACK;   // Interrupted
+
+    hit.damage = damage.ToFloat();
+    hit.comboHits = fighter.comboHits;
+    hit.frameAdvantage = defender.hitstun - recovery;
+    if (m_observer) m_observer->OnHit(hit);
+}
+
+} // namespace ArenaFighter
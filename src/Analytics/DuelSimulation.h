@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "BalanceConfig.h"
+#include "../Combat/DamageCalculator.h"
+#include "../Network/RollbackEngine.h"
+
+namespace ArenaFighter {
+
+struct DuelHit {
+    int attacker;
+    AttackType type;
+    float damage;          // After combo scaling; 0 when blocked
+    bool blocked;
+    bool counter;          // Interrupted the defender's own attack
+    int comboHits;         // This hit included; 0 when blocked
+    int frameAdvantage;    // Attacker's, counted from when both can act again
+};
+
+// What happens in a duel, for analytics. Events are raised again for
+// frames a rollback resimulates, so observe only confirmed playback such
+// as a replay.
+class DuelObserver {
+public:
+    virtual ~DuelObserver() = default;
+
+    virtual void OnAttack(int fighter, AttackType type) = 0;   // Startup began
+    virtual void OnHit(const DuelHit& hit) = 0;
+    virtual void OnComboEnd(int attacker) = 0;                 // The defender left hitstun
+    virtual void OnFrameEnd(uint32_t frame) = 0;
+};
+
+// One-on-one fight on a flat stage with the game's combat rules: attacks
+// follow their FrameData, damage comes from DamageCalculator, and combos
+// scale and cap as ComboSystem prescribes. An attack that connected can
+// be cancelled into a stronger one inside its cancel window. A hit on a
+// defender still in hitstun extends the combo; blocking stops the damage
+// but not the blockstun. All state is integer or fixed point, so replays
+// and rollback reproduce it exactly; nothing rolls the random generator.
+class DuelSimulation : public RollbackSimulation {
+public:
+    enum Buttons : uint32_t {
+        Left = 1, Right = 2, Block = 4,
+        Light = 8, Medium = 16, Heavy = 32, Special = 64, Ultimate = 128
+    };
+
+    static constexpr int32_t NO_ATTACK = -1;
+    static constexpr float STAGE_HALF_WIDTH = 400.0f;
+    static constexpr float MIN_SPACING = 50.0f;   // Fighters cannot walk through each other
+
+    struct Fighter {
+        int32_t x;             // Fixed raw
+        int32_t health;        // Fixed raw
+        int32_t mana;          // Fixed raw
+        int32_t attack;        // AttackType, or NO_ATTACK
+        int32_t attackFrame;   // Frames since startup began
+        int32_t attackHit;     // The current attack has connected
+        int32_t hitstun;
+        int32_t blockstun;
+        int32_t comboHits;     // Of the combo this fighter is landing
+        int32_t comboDamage;   // Fixed raw
+        uint32_t lastInput;
+    };
+
+    struct State {
+        uint32_t frame;
+        Fighter fighters[2];
+    };
+
+    explicit DuelSimulation(const BalanceConfig& config = BalanceConfig::Defaults());
+
+    size_t SaveState(uint8_t* buffer, size_t capacity) const override;
+    void LoadState(const uint8_t* data, size_t size) override;
+    size_t DescribeState(StateField* fields, size_t maxFields) const override;
+    void AdvanceFrame(const uint32_t* inputs, size_t playerCount) override;
+
+    void SetObserver(DuelObserver* observer) { m_observer = observer; }
+
+    const State& GetState() const { return m_state; }
+    const BalanceConfig& GetConfig() const { return m_config; }
+    bool IsOver() const;                 // A fighter is knocked out
+    float GetHealth(int fighter) const;
+
+private:
+    void StepFighter(int index, uint32_t input);
+    bool StartAttack(int index, uint32_t pressed);
+    bool Connects(int attacker) const;
+    void ResolveHit(int attacker, int32_t attack, int32_t attackFrame, bool counter);
+
+    BalanceConfig m_config;
+    DamageCalculator m_damage;
+    DuelObserver* m_observer;
+    State m_state;
+};
+
+} // namespace ArenaFighter
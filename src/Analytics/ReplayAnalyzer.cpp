@@ -0,0 +1,96 @@
+#include "ReplayAnalyzer.h"
+#include "DuelSimulation.h"
+#include "../Network/NetworkConfig.h"
+#include "../Network/Replay.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace ArenaFighter {
+
+ReplayAnalysis AnalyzeReplay(std::istream& replay, const BalanceConfig& config, BalanceStats& stats) {
+    ReplayAnalysis analysis;
+    ReplayReader reader(replay);
+    if (!reader.Open()) {
+        return analysis;
+    }
+
+    DuelSimulation simulation(config);
+    BalanceRecorder recorder(stats);
+    simulation.SetObserver(&recorder);
+
+    ReplayResult result = PlayReplay(reader, simulation);
+    recorder.FinishMatch(simulation);
+
+    analysis.frames = result.frames;
+    analysis.complete = result.complete;
+    analysis.verified = result.verified;
+    return analysis;
+}
+
+double BatchResult::GetRealTimeFactor() const {
+    double played = static_cast<double>(stats.frames) / NetworkConfig::TICK_RATE;
+    return busySeconds > 0.0 ? played / busySeconds : 0.0;
+}
+
+void ReplayBatch::AddFile(const std::string& path) {
+    m_sources.push_back(Source{ path, {} });
+}
+
+void ReplayBatch::AddData(std::string replay) {
+    m_sources.push_back(Source{ {}, std::move(replay) });
+}
+
+BatchResult ReplayBatch::Run(const BalanceConfig& config, unsigned threadCount) const {
+    using Clock = std::chrono::steady_clock;
+
+    BatchResult total;
+    std::mutex totalMutex;
+    std::atomic<size_t> next{0};
+
+    auto worker = [&]() {
+        BatchResult local;
+        Clock::time_point start = Clock::now();
+
+        for (size_t index = next++; index < m_sources.size(); index = next++) {
+            const Source& source = m_sources[index];
+            ReplayAnalysis analysis;
+            if (source.path.empty()) {
+                std::istringstream in(source.data);
+                analysis = AnalyzeReplay(in, config, local.stats);
+            } else {
+                std::ifstream in(source.path, std::ios::binary);
+                analysis = AnalyzeReplay(in, config, local.stats);
+            }
+
+            local.replays++;
+            local.unreadable += analysis.complete ? 0 : 1;
+            local.unverified += analysis.complete && !analysis.verified ? 1 : 0;
+        }
+
+        local.busySeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(totalMutex);
+        total.stats.Merge(local.stats);
+        total.replays += local.replays;
+        total.unreadable += local.unreadable;
+        total.unverified += local.unverified;
+        total.busySeconds += local.busySeconds;
+    };
+
+    std::vector<std::thread> threads;
+    unsigned count = std::max(1u, std::min(threadCount, static_cast<unsigned>(m_sources.size())));
+    for (unsigned i = 0; i < count; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return total;
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "BalanceConfig.h"
+#include "BalanceStats.h"
+
+namespace ArenaFighter {
+
+struct ReplayAnalysis {
+    uint32_t frames = 0;
+    bool complete = false;   // The stream ended properly
+    bool verified = false;   // Reached the recorded final state
+};
+
+// Re-simulates one recorded duel with config, without rendering or
+// pacing, and adds what happened to stats. With the tuning the match was
+// played with the replay verifies; with any other, the same inputs show
+// what the change would have done.
+ReplayAnalysis AnalyzeReplay(std::istream& replay, const BalanceConfig& config, BalanceStats& stats);
+
+struct BatchResult {
+    BalanceStats stats;
+    uint32_t replays = 0;
+    uint32_t unreadable = 0;    // Missing, not a replay, or cut off
+    uint32_t unverified = 0;    // Complete, but ended in another state
+    double busySeconds = 0.0;   // Summed over worker threads
+
+    // Seconds of play simulated per second of one core's time
+    double GetRealTimeFactor() const;
+};
+
+// Many replays, re-simulated in parallel. Each worker keeps its own
+// totals and they are merged at the end, so workers share nothing but
+// the index of the next replay.
+class ReplayBatch {
+public:
+    void AddFile(const std::string& path);
+    void AddData(std::string replay);
+    size_t GetCount() const { return m_sources.size(); }
+
+    BatchResult Run(const BalanceConfig& config, unsigned threadCount) const;
+
+private:
+    struct Source {
+        std::string path;   // Empty for in-memory replays
+        std::string data;
+    };
+
+    std::vector<Source> m_sources;
+};
+
+} // namespace ArenaFighter
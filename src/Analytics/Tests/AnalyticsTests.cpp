@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "../BalanceConfig.h"
+#include "../BalanceStats.h"
+#include "../DuelBot.h"
+#include "../DuelSimulation.h"
+#include "../ReplayAnalyzer.h"
+#include "../../Core/FixedPoint.h"
+#include "../../Network/NetworkConfig.h"
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace ArenaFighter {
+namespace Tests {
+
+namespace {
+
+struct HitLog : DuelObserver {
+    std::vector<DuelHit> hits;
+    int combosEnded = 0;
+
+    void OnAttack(int, AttackType) override {}
+    void OnHit(const DuelHit& hit) override { hits.push_back(hit); }
+    void OnComboEnd(int) override { combosEnded++; }
+    void OnFrameEnd(uint32_t) override {}
+};
+
+// Puts the fighters distance apart, facing each other
+void PlaceFighters(DuelSimulation& simulation, float distance) {
+    DuelSimulation::State state = simulation.GetState();
+    state.fighters[0].x = Fixed::FromFloat(-distance / 2).Raw();
+    state.fighters[1].x = Fixed::FromFloat(distance / 2).Raw();
+
+    uint8_t buffer[sizeof(state)];
+    std::memcpy(buffer, &state, sizeof(state));
+    simulation.LoadState(buffer, sizeof(buffer));
+}
+
+void RunFrames(DuelSimulation& simulation, uint32_t first, uint32_t second, int frames) {
+    for (int i = 0; i < frames; ++i) {
+        uint32_t inputs[2] = { first, second };
+        simulation.AdvanceFrame(inputs, 2);
+    }
+}
+
+ReplayBatch BotBatch(uint32_t matches) {
+    ReplayBatch batch;
+    for (uint32_t i = 0; i < matches; ++i) {
+        batch.AddData(RecordBotMatch(i + 1, 99 * NetworkConfig::TICK_RATE));
+    }
+    return batch;
+}
+
+} // namespace
+
+TEST(ComboSystemTest, StepsShorterThanHalfAFrameStillExpireTheCombo) {
+    // 240 Hz steps are a quarter frame each; rounding per step would
+    // never advance the clock
+    ComboSystem combo;
+    combo.RegisterHit(AttackType::Light, 50.0f, 1);
+
+    for (int i = 0; i < ComboSystem::COMBO_TIMEOUT_FRAMES * 4 - 1; ++i) {
+        combo.Update(1.0f / 240.0f);
+    }
+    EXPECT_TRUE(combo.IsActive());
+
+    combo.Update(1.0f / 240.0f);
+    EXPECT_FALSE(combo.IsActive());
+}
+
+TEST(BalanceConfigTest, SetChangesNamedValues) {
+    BalanceConfig config = BalanceConfig::Defaults();
+    EXPECT_EQ(config.GetAttack(AttackType::Heavy).startupFrames, 18);
+
+    EXPECT_TRUE(config.Set("heavy.startup", 14));
+    EXPECT_TRUE(config.Set("light.damage", 60));
+    EXPECT_TRUE(config.Set("health", 1200));
+    EXPECT_EQ(config.GetAttack(AttackType::Heavy).startupFrames, 14);
+    EXPECT_FLOAT_EQ(config.GetAttack(AttackType::Light).baseDamage, 60.0f);
+    EXPECT_FLOAT_EQ(config.maxHealth, 1200.0f);
+
+    EXPECT_FALSE(config.Set("heavy.reach", 1));
+    EXPECT_FALSE(config.Set("jab.startup", 1));
+}
+
+TEST(DuelSimulationTest, LightHitDamageAndAdvantage) {
+    DuelSimulation simulation;
+    HitLog log;
+    simulation.SetObserver(&log);
+    PlaceFighters(simulation, 60.0f);
+
+    const FrameData& light = simulation.GetConfig().GetAttack(AttackType::Light);
+    RunFrames(simulation, DuelSimulation::Light, 0, light.startupFrames + 1);
+
+    ASSERT_EQ(log.hits.size(), 1u);
+    const DuelHit& hit = log.hits[0];
+    EXPECT_EQ(hit.attacker, 0);
+    EXPECT_EQ(hit.type, AttackType::Light);
+    EXPECT_FALSE(hit.blocked);
+    EXPECT_EQ(hit.comboHits, 1);
+    EXPECT_GT(hit.damage, 0.0f);
+    EXPECT_LT(hit.damage, light.baseDamage);   // Reduced by defense
+    EXPECT_FLOAT_EQ(simulation.GetHealth(1), BASE_HEALTH - hit.damage);
+
+    // Hit on the first active frame: hitstun against what is left of the attack
+    EXPECT_EQ(hit.frameAdvantage, light.hitstunFrames - light.activeFrames - light.recoveryFrames);
+
+    RunFrames(simulation, 0, 0, light.hitstunFrames);
+    EXPECT_EQ(log.combosEnded, 1);
+}
+
+TEST(DuelSimulationTest, BlockedHitDealsNoDamage) {
+    DuelSimulation simulation;
+    HitLog log;
+    simulation.SetObserver(&log);
+    PlaceFighters(simulation, 60.0f);
+
+    const FrameData& medium = simulation.GetConfig().GetAttack(AttackType::Medium);
+    RunFrames(simulation, DuelSimulation::Medium, DuelSimulation::Block, medium.startupFrames + 1);
+
+    ASSERT_EQ(log.hits.size(), 1u);
+    EXPECT_TRUE(log.hits[0].blocked);
+    EXPECT_FLOAT_EQ(simulation.GetHealth(1), BASE_HEALTH);
+    EXPECT_LT(log.hits[0].frameAdvantage, 0);
+    EXPECT_EQ(simulation.GetState().fighters[1].blockstun, medium.blockstunFrames);
+}
+
+TEST(DuelSimulationTest, CancelChainsIntoAStrongerAttack) {
+    BalanceConfig config = BalanceConfig::Defaults();
+    config.Set("medium.startup", 4);
+    DuelSimulation simulation(config);
+    HitLog log;
+    simulation.SetObserver(&log);
+    PlaceFighters(simulation, 60.0f);
+
+    const FrameData& light = config.GetAttack(AttackType::Light);
+    RunFrames(simulation, DuelSimulation::Light, 0, light.cancelWindowStart + 1);
+    RunFrames(simulation, DuelSimulation::Medium, 0, 6);
+
+    ASSERT_EQ(log.hits.size(), 2u);
+    EXPECT_EQ(log.hits[1].type, AttackType::Medium);
+    EXPECT_EQ(log.hits[1].comboHits, 2);
+}
+
+TEST(ReplayAnalyzerTest, BotMatchVerifies) {
+    std::istringstream replay(RecordBotMatch(5, 99 * NetworkConfig::TICK_RATE));
+    BalanceStats stats;
+
+    ReplayAnalysis analysis = AnalyzeReplay(replay, BalanceConfig::Defaults(), stats);
+    EXPECT_TRUE(analysis.complete);
+    EXPECT_TRUE(analysis.verified);
+    EXPECT_EQ(stats.matches, 1u);
+    EXPECT_EQ(stats.frames, analysis.frames);
+    EXPECT_GT(stats.GetAttack(AttackType::Light).uses, 0u);
+    EXPECT_GT(stats.GetAttack(AttackType::Light).hits, 0u);
+}
+
+TEST(ReplayAnalyzerTest, ChangedDamageShowsInStats) {
+    ReplayBatch batch = BotBatch(20);
+    BalanceConfig stronger = BalanceConfig::Defaults();
+    stronger.Set("heavy.damage", 360);
+
+    BatchResult before = batch.Run(BalanceConfig::Defaults(), 1);
+    BatchResult after = batch.Run(stronger, 1);
+    EXPECT_EQ(before.unverified, 0u);
+    EXPECT_GT(after.unverified, 0u);
+
+    const AttackStats& heavyBefore = before.stats.GetAttack(AttackType::Heavy);
+    const AttackStats& heavyAfter = after.stats.GetAttack(AttackType::Heavy);
+    ASSERT_GT(heavyBefore.hits, 0u);
+    ASSERT_GT(heavyAfter.hits, 0u);
+    EXPECT_GT(heavyAfter.damage / heavyAfter.hits, 1.5 * heavyBefore.damage / heavyBefore.hits);
+}
+
+TEST(ReplayAnalyzerTest, ThreadsGiveTheSameTotals) {
+    ReplayBatch batch = BotBatch(24);
+
+    BatchResult single = batch.Run(BalanceConfig::Defaults(), 1);
+    BatchResult parallel = batch.Run(BalanceConfig::Defaults(), 4);
+    EXPECT_EQ(parallel.replays, single.replays);
+    EXPECT_EQ(parallel.stats.frames, single.stats.frames);
+    EXPECT_EQ(parallel.stats.knockouts, single.stats.knockouts);
+    for (int i = 0; i < BalanceConfig::ATTACK_KINDS; ++i) {
+        EXPECT_EQ(parallel.stats.attacks[i].uses, single.stats.attacks[i].uses);
+        EXPECT_EQ(parallel.stats.attacks[i].hits, single.stats.attacks[i].hits);
+        EXPECT_EQ(parallel.stats.attacks[i].advantageOnHit, single.stats.attacks[i].advantageOnHit);
+    }
+    for (int hits = 0; hits <= BalanceStats::MAX_COMBO; ++hits) {
+        EXPECT_EQ(parallel.stats.comboLengths[hits], single.stats.comboLengths[hits]);
+    }
+}
+
+// Balance passes re-simulate thousands of matches, so each core has to
+// get through them far faster than they were played
+TEST(ReplayAnalyzerTest, RealTimeFactorPerCore) {
+    ReplayBatch batch = BotBatch(50);
+
+    BatchResult result = batch.Run(BalanceConfig::Defaults(), 1);
+    std::cout << result.replays << " replays, " << result.stats.frames << " frames in "
+              << result.busySeconds * 1000.0 << " ms: " << result.GetRealTimeFactor()
+              << "x real time per core\n";
+
+    EXPECT_EQ(result.unreadable, 0u);
+    EXPECT_GT(result.GetRealTimeFactor(), 1000.0);
+}
+
+} // namespace Tests
+} // namespace ArenaFighter
@@ -162,20 +162,20 @@ void BloodConstruct::Sacrifice() {
 // MissBatCrimsonAuthority Constructor
 // ============================================================================
 
-MissBatCrimsonAuthority::MissBatCrimsonAuthority() {
+MissBatCrimsonAuthority::MissBatCrimsonAuthority()
+    : CharacterBase("Miss Bat", CharacterCategory::Animal, StatMode::Hybrid) {
     InitializeMissBatStats();
 }
 
 void MissBatCrimsonAuthority::InitializeMissBatStats() {
     // Very Hard difficulty character - complex mechanics
-    stats.maxHealth = 220.0f;
-    stats.health = 220.0f;
-    stats.attack = 100.0f;
-    stats.defense = 85.0f;
-    stats.speed = 100.0f;
-    stats.maxMana = 100.0f;
-    stats.mana = 100.0f;
-    stats.manaRegen = 5.0f;
+    m_maxHealth = 220.0f;
+    m_currentHealth = 220.0f;
+    m_powerModifier = 1.0f;
+    m_defense = 85.0f;
+    m_speed = 100.0f;
+    m_maxMana = 100.0f;
+    m_currentMana = 100.0f;
 
     // Authority starts at 0
     authorityGauge.current = 0.0f;
@@ -188,6 +188,189 @@ void MissBatCrimsonAuthority::InitializeMissBatStats() {
     bloodResonance.maximum = 20;
 }
 
+// ============================================================================
+// Rollback Snapshots
+// ============================================================================
+
+namespace {
+
+struct PuppetState {
+    float health;
+    float maxHealth;
+    float damage;
+    bool isAlive;
+    float x, y, z;
+    float bloodTaxTimer;
+};
+
+struct ConstructState {
+    ConstructType type;
+    float health;
+    float maxHealth;
+    float x, y, z;
+    float lifetime;
+    bool isEvolved;
+};
+
+struct MissBatState {
+    AuthorityGauge authorityGauge;
+    BloodEssence bloodEssence;
+    BloodResonanceStacks bloodResonance;
+
+    uint32_t puppetCount;
+    PuppetState puppets[MissBatCrimsonAuthority::MAX_PUPPETS];
+    uint32_t constructCount;
+    ConstructState constructs[MissBatCrimsonAuthority::MAX_CONSTRUCTS];
+    uint32_t stolenSkillCount;
+    int stolenSkills[MissBatCrimsonAuthority::MAX_STOLEN_SKILLS];
+
+    BloodForm currentForm;
+    float formDuration;
+    float formMasteryPoints;
+    bool isTranscendent;
+
+    float executionCastTimer;
+    int executionTargetId;
+    bool isExecuting;
+
+    bool isInUltimate;
+    float ultimateTimeRemaining;
+    bool ultimateRecovery;
+    float ultimateRecoveryTimer;
+};
+
+} // namespace
+
+void MissBatCrimsonAuthority::SaveState(CharacterSnapshot& snapshot) const {
+    CharacterBase::SaveState(snapshot);
+
+    MissBatState state;
+    std::memset(&state, 0, sizeof(state));
+    state.authorityGauge = authorityGauge;
+    state.bloodEssence = bloodEssence;
+    state.bloodResonance = bloodResonance;
+
+    state.puppetCount = 0;
+    for (const auto& puppet : bloodPuppets) {
+        if (!puppet || state.puppetCount >= MAX_PUPPETS) continue;
+        PuppetState& p = state.puppets[state.puppetCount++];
+        p.health = puppet->health;
+        p.maxHealth = puppet->maxHealth;
+        p.damage = puppet->damage;
+        p.isAlive = puppet->isAlive;
+        p.x = puppet->x;
+        p.y = puppet->y;
+        p.z = puppet->z;
+        p.bloodTaxTimer = puppet->bloodTaxTimer;
+    }
+
+    state.constructCount = 0;
+    for (const auto& construct : bloodConstructs) {
+        if (!construct || state.constructCount >= MAX_CONSTRUCTS) continue;
+        ConstructState& c = state.constructs[state.constructCount++];
+        c.type = construct->type;
+        c.health = construct->health;
+        c.maxHealth = construct->maxHealth;
+        c.x = construct->x;
+        c.y = construct->y;
+        c.z = construct->z;
+        c.lifetime = construct->lifetime;
+        c.isEvolved = construct->isEvolved;
+    }
+
+    state.stolenSkillCount = 0;
+    for (const auto& skill : stolenSkills) {
+        if (state.stolenSkillCount >= MAX_STOLEN_SKILLS) break;
+        state.stolenSkills[state.stolenSkillCount++] = skill.skillType;
+    }
+
+    state.currentForm = currentForm;
+    state.formDuration = formDuration;
+    state.formMasteryPoints = formMasteryPoints;
+    state.isTranscendent = isTranscendent;
+
+    state.executionCastTimer = executionCastTimer;
+    state.executionTargetId = executionTargetId;
+    state.isExecuting = isExecuting;
+
+    state.isInUltimate = isInUltimate;
+    state.ultimateTimeRemaining = ultimateTimeRemaining;
+    state.ultimateRecovery = ultimateRecovery;
+    state.ultimateRecoveryTimer = ultimateRecoveryTimer;
+
+    WriteCharacterData(snapshot, state);
+}
+
+bool MissBatCrimsonAuthority::LoadState(const CharacterSnapshot& snapshot) {
+    MissBatState state = {};
+    if (!CharacterBase::LoadState(snapshot) || !ReadCharacterData(snapshot, state)) {
+        return false;
+    }
+
+    authorityGauge = state.authorityGauge;
+    bloodEssence = state.bloodEssence;
+    bloodResonance = state.bloodResonance;
+
+    // Puppets and constructs are plain data, so live objects are
+    // overwritten in place and only missing slots allocate
+    bloodPuppets.resize(state.puppetCount);
+    for (uint32_t i = 0; i < state.puppetCount; ++i) {
+        auto& puppet = bloodPuppets[i];
+        if (!puppet) {
+            puppet = std::make_shared<BloodPuppet>(1.0f);
+        }
+
+        const PuppetState& p = state.puppets[i];
+        puppet->health = p.health;
+        puppet->maxHealth = p.maxHealth;
+        puppet->damage = p.damage;
+        puppet->isAlive = p.isAlive;
+        puppet->x = p.x;
+        puppet->y = p.y;
+        puppet->z = p.z;
+        puppet->bloodTaxTimer = p.bloodTaxTimer;
+    }
+
+    bloodConstructs.resize(state.constructCount);
+    for (uint32_t i = 0; i < state.constructCount; ++i) {
+        const ConstructState& c = state.constructs[i];
+        auto& construct = bloodConstructs[i];
+        if (!construct) {
+            construct = std::make_shared<BloodConstruct>(c.type);
+        }
+
+        construct->type = c.type;
+        construct->health = c.health;
+        construct->maxHealth = c.maxHealth;
+        construct->x = c.x;
+        construct->y = c.y;
+        construct->z = c.z;
+        construct->lifetime = c.lifetime;
+        construct->isEvolved = c.isEvolved;
+    }
+
+    stolenSkills.resize(state.stolenSkillCount);
+    for (uint32_t i = 0; i < state.stolenSkillCount; ++i) {
+        stolenSkills[i].skillType = state.stolenSkills[i];
+    }
+
+    currentForm = state.currentForm;
+    formDuration = state.formDuration;
+    formMasteryPoints = state.formMasteryPoints;
+    isTranscendent = state.isTranscendent;
+
+    executionCastTimer = state.executionCastTimer;
+    executionTargetId = state.executionTargetId;
+    isExecuting = state.isExecuting;
+
+    isInUltimate = state.isInUltimate;
+    ultimateTimeRemaining = state.ultimateTimeRemaining;
+    ultimateRecovery = state.ultimateRecovery;
+    ultimateRecoveryTimer = state.ultimateRecoveryTimer;
+
+    return true;
+}
+
 // ============================================================================
 // Core Update Loop
 // ============================================================================
@@ -389,8 +572,8 @@ void MissBatCrimsonAuthority::TransformToForm(BloodForm form) {
 
         case BloodForm::SanguineFortress:
             // +50% max HP, defensive bonuses
-            stats.maxHealth *= 1.5f;
-            stats.health = std::min(stats.health, stats.maxHealth);
+            m_maxHealth *= 1.5f;
+            m_currentHealth = std::min(m_currentHealth, m_maxHealth);
             break;
 
         case BloodForm::HemomagueWraith:
@@ -428,8 +611,8 @@ void MissBatCrimsonAuthority::EndTransformation() {
     // Remove form-specific effects
     if (currentForm == BloodForm::SanguineFortress) {
         // Restore original max HP
-        stats.maxHealth = 220.0f;
-        stats.health = std::min(stats.health, stats.maxHealth);
+        m_maxHealth = 220.0f;
+        m_currentHealth = std::min(m_currentHealth, m_maxHealth);
     }
 
     currentForm = BloodForm::None;
@@ -493,7 +676,7 @@ void MissBatCrimsonAuthority::CompleteExecution() {
 
     // Rewards
     authorityGauge.Generate(AuthorityGauge::EXECUTION);
-    stats.health = std::min(stats.health + 200.0f, stats.maxHealth);
+    m_currentHealth = std::min(m_currentHealth + 200.0f, m_maxHealth);
     bloodResonance.AddPermanentStack();
 
     // Ultimate extension during ultimate
@@ -531,7 +714,7 @@ void MissBatCrimsonAuthority::ActivateUltimate() {
     bloodResonance.maximum = UltimateEnhancements::MAX_RESONANCE_ULTIMATE;
 
     // Apply all stat bonuses
-    stats.speed *= (1.0f + UltimateEnhancements::MOVEMENT_SPEED_BONUS);
+    m_speed *= (1.0f + UltimateEnhancements::MOVEMENT_SPEED_BONUS);
 
     // Transform to all 4 forms simultaneously (quad-state)
     // TODO: Implement multi-form state
@@ -571,7 +754,7 @@ void MissBatCrimsonAuthority::EndUltimate() {
     isInUltimate = false;
 
     // Remove stat bonuses
-    stats.speed /= (1.0f + UltimateEnhancements::MOVEMENT_SPEED_BONUS);
+    m_speed /= (1.0f + UltimateEnhancements::MOVEMENT_SPEED_BONUS);
 
     // Reset resonance maximum
     bloodResonance.maximum = 20;
@@ -606,7 +789,7 @@ void MissBatCrimsonAuthority::CrimsonCataclysm() {
 // Combat Overrides
 // ============================================================================
 
-void MissBatCrimsonAuthority::ExecuteSpecialMove(Direction direction) {
+void MissBatCrimsonAuthority::ExecuteSpecialMove(InputDirection direction) {
     // TODO: Implement directional special moves
     // S+Up, S+Down, etc.
 }
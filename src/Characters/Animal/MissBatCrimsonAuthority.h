@@ -135,6 +135,14 @@ public:
     // Core Update
     void Update(float deltaTime) override;
 
+    // Rollback snapshots
+    void SaveState(CharacterSnapshot& snapshot) const override;
+    bool LoadState(const CharacterSnapshot& snapshot) override;
+
+    static constexpr int MAX_PUPPETS = 3;
+    static constexpr int MAX_CONSTRUCTS = 12;
+    static constexpr int MAX_STOLEN_SKILLS = 4;
+
     // Resource Management
     AuthorityGauge authorityGauge;
     BloodEssence bloodEssence;
@@ -211,7 +219,7 @@ public:
     static constexpr float ULTIMATE_RECOVERY_TIME = 3.0f;
 
     // Combat Overrides
-    void ExecuteSpecialMove(Direction direction) override;
+    void ExecuteSpecialMove(InputDirection direction) override;
     void ExecuteGearSkill(int index) override;
     void Block() override;
     bool CanUseSpecialMoves() const override;
@@ -1,13 +1,27 @@
 #include "CharacterBase.h"
 #include "CharacterCategory.h"
 #include "../Combat/CombatSystem.h"
-#include <random>
+#include "../Core/DeterministicRandom.h"
+#include "../Physics/Collider.h"
 #include <algorithm>
+#include <cstring>
 
 #include <iostream>
+#ifdef DFR_HEADLESS
+namespace ArenaFighter {
+// The server never animates; m_animator only has to be destructible
+class CharacterAnimator {};
+}
+#else
 #include "../Animation/CharacterAnimator.h"
+#endif
 namespace ArenaFighter {
 
+namespace {
+// Frame data is authored at 60 FPS
+constexpr float FRAME_TIME = 1.0f / 60.0f;
+}
+
 // Static member initialization
 int CharacterBase::s_nextId = 1;
 
@@ -15,7 +29,8 @@ CharacterBase::CharacterBase(const std::string& name, CharacterCategory category
     : m_id(s_nextId++)
     , m_name(name)
     , m_category(category)
-    , m_statMode(statMode) {
+    , m_statMode(statMode)
+    , m_rigidBody(std::make_unique<RigidBody>()) {
     
     // Apply category and stat mode modifiers
     ApplyStatModifiers();
@@ -32,6 +47,72 @@ CharacterBase::CharacterBase(const std::string& name, CharacterCategory category
 
 CharacterBase::~CharacterBase() = default;
 
+void CharacterBase::SaveState(CharacterSnapshot& snapshot) const {
+    // Desync detectors hash the whole blob, padding and unused character
+    // data included, so start from zero bytes
+    std::memset(&snapshot, 0, sizeof(snapshot));
+
+    snapshot.characterId = m_id;
+
+    snapshot.maxHealth = m_maxHealth;
+    snapshot.currentHealth = m_currentHealth;
+    snapshot.maxMana = m_maxMana;
+    snapshot.currentMana = m_currentMana;
+    snapshot.defense = m_defense;
+    snapshot.speed = m_speed;
+    snapshot.weight = m_weight;
+    snapshot.powerModifier = m_powerModifier;
+    snapshot.criticalChance = m_criticalChance;
+    snapshot.element = m_element;
+    snapshot.currentState = m_currentState;
+
+    std::memcpy(snapshot.gearSkillCooldowns, m_gearSkillCooldowns.data(), sizeof(snapshot.gearSkillCooldowns));
+    snapshot.currentGear = m_currentGear;
+    snapshot.lastSpecialDirection = m_lastSpecialDirection;
+
+    snapshot.stateTimer = m_stateTimer;
+    snapshot.manaRegenTimer = m_manaRegenTimer;
+    snapshot.blockDuration = m_blockDuration;
+    snapshot.stunDuration = m_stunDuration;
+
+    snapshot.facingDirection = m_facingDirection;
+    snapshot.airDashesRemaining = m_airDashesRemaining;
+
+    // Characters without extra state leave characterDataSize at 0
+}
+
+bool CharacterBase::LoadState(const CharacterSnapshot& snapshot) {
+    if (snapshot.characterId != m_id) {
+        return false;
+    }
+
+    m_maxHealth = snapshot.maxHealth;
+    m_currentHealth = snapshot.currentHealth;
+    m_maxMana = snapshot.maxMana;
+    m_currentMana = snapshot.currentMana;
+    m_defense = snapshot.defense;
+    m_speed = snapshot.speed;
+    m_weight = snapshot.weight;
+    m_powerModifier = snapshot.powerModifier;
+    m_criticalChance = snapshot.criticalChance;
+    m_element = snapshot.element;
+    m_currentState = snapshot.currentState;
+
+    std::memcpy(m_gearSkillCooldowns.data(), snapshot.gearSkillCooldowns, sizeof(snapshot.gearSkillCooldowns));
+    m_currentGear = snapshot.currentGear;
+    m_lastSpecialDirection = snapshot.lastSpecialDirection;
+
+    m_stateTimer = snapshot.stateTimer;
+    m_manaRegenTimer = snapshot.manaRegenTimer;
+    m_blockDuration = snapshot.blockDuration;
+    m_stunDuration = snapshot.stunDuration;
+
+    m_facingDirection = snapshot.facingDirection;
+    m_airDashesRemaining = snapshot.airDashesRemaining;
+
+    return true;
+}
+
 bool CharacterBase::IsInCounterState() const {
     // Counter state is when player is in startup frames of an attack
     // This is a simplified check - real implementation would check frame data
@@ -39,11 +120,7 @@ bool CharacterBase::IsInCounterState() const {
 }
 
 bool CharacterBase::RollCritical() const {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<> dis(0.0, 1.0);
-    
-    return dis(gen) < m_criticalChance;
+    return GetSimulationRandom().NextFloat() < m_criticalChance;
 }
 
 bool CharacterBase::CanAffordSkill(float manaCost) const {
@@ -70,7 +147,7 @@ void CharacterBase::RegenerateMana(float deltaTime) {
     // Regenerate mana every 0.1 seconds for smoother regen
     const float regenInterval = 0.1f;
     while (m_manaRegenTimer >= regenInterval) {
-        float regenAmount = CombatSystem::MANA_REGEN * regenInterval * regenModifier;
+        float regenAmount = MANA_REGEN * regenInterval * regenModifier;
         m_currentMana = std::min(m_maxMana, m_currentMana + regenAmount);
         m_manaRegenTimer -= regenInterval;
     }
@@ -80,10 +157,33 @@ void CharacterBase::TakeDamage(float damage) {
     m_currentHealth = std::max(0.0f, m_currentHealth - damage);
 }
 
+void CharacterBase::TakeDamage(const HitResult& hit) {
+    if (IsBlocking()) {
+        SetBlockstun(hit.blockstun);
+        return;
+    }
+
+    TakeDamage(hit.damage);
+    SetHitstun(hit.hitstun);
+}
+
 void CharacterBase::Heal(float amount) {
     m_currentHealth = std::min(m_maxHealth, m_currentHealth + amount);
 }
 
+void CharacterBase::SetHealth(float health) {
+    m_currentHealth = std::clamp(health, 0.0f, m_maxHealth);
+}
+
+void CharacterBase::SetMaxHealth(float maxHealth) {
+    m_maxHealth = std::max(1.0f, maxHealth);
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
+}
+
+void CharacterBase::SetMana(float mana) {
+    m_currentMana = std::clamp(mana, 0.0f, m_maxMana);
+}
+
 void CharacterBase::SetGearSkill(int index, const GearSkill& skill) {
     if (index >= 0 && index < 8) {
         m_gearSkills[index] = skill;
@@ -123,24 +223,20 @@ void CharacterBase::Update(float deltaTime) {
     if (m_currentState == CharacterState::Blocking) {
         m_blockDuration += deltaTime;
     }
-    
-    // Update character-specific systems if present
-    if (m_stanceSystem) {
-        // m_stanceSystem->Update(deltaTime);
-    }
-    if (m_evolutionSystem) {
-        // m_evolutionSystem->Update(deltaTime);
-    }
-    if (m_transformationSystem) {
-        // m_transformationSystem->Update(deltaTime);
+
+    // Landing restores the air dash
+    if (m_rigidBody->isGrounded) {
+        m_airDashesRemaining = 1;
     }
 }
 
 void CharacterBase::UpdateState(float deltaTime) {
+#ifndef DFR_HEADLESS
     // Update animation system
     if (m_animator) {
         m_animator->Update(deltaTime);
     }
+#endif
     m_stateTimer += deltaTime;
     
     // Auto-recover from certain states after time
@@ -159,6 +255,15 @@ void CharacterBase::UpdateState(float deltaTime) {
             }
             break;
             
+        case CharacterState::HitStun:
+        case CharacterState::Defending:
+            if (m_stateTimer >= m_stunDuration) {
+                m_currentState = CharacterState::Normal;
+                m_stateTimer = 0.0f;
+                m_stunDuration = 0.0f;
+            }
+            break;
+
         case CharacterState::ExecutingSpecial:
             // Special move completion is handled by combat system
             break;
@@ -169,6 +274,34 @@ void CharacterBase::UpdateState(float deltaTime) {
     }
 }
 
+bool CharacterBase::IsInStartup() const {
+    if (m_currentState != CharacterState::ExecutingSpecial) {
+        return false;
+    }
+
+    const SpecialMove* move = GetSpecialMove(m_lastSpecialDirection);
+    return move && m_stateTimer < move->startupFrames * FRAME_TIME;
+}
+
+void CharacterBase::ConsumeAirDash() {
+    if (m_airDashesRemaining > 0) {
+        --m_airDashesRemaining;
+    }
+}
+
+void CharacterBase::SetHitstun(int frames) {
+    m_currentState = CharacterState::HitStun;
+    m_stateTimer = 0.0f;
+    m_stunDuration = frames * FRAME_TIME;
+}
+
+void CharacterBase::SetBlockstun(int frames) {
+    // Blockstun keeps the guard up until it runs out
+    m_currentState = CharacterState::Defending;
+    m_stateTimer = 0.0f;
+    m_stunDuration = frames * FRAME_TIME;
+}
+
 void CharacterBase::ApplyStatModifiers() {
     // Get category manager
     auto& categoryMgr = CharacterCategoryManager::GetInstance();
@@ -245,6 +378,21 @@ void CharacterBase::StartGearSkillCooldown(int skillIndex) {
     }
 }
 
+void CharacterBase::ExecuteGearSkill(int skillIndex) {
+    if (skillIndex < 0 || skillIndex >= 8 || IsGearSkillOnCooldown(skillIndex)) {
+        return;
+    }
+
+    const GearSkill& skill = m_gearSkills[skillIndex];
+    if (!CanAffordSkill(skill.manaCost)) {
+        return;
+    }
+
+    ConsumeMana(skill.manaCost);
+    StartGearSkillCooldown(skillIndex);
+    OnSkillUse(skillIndex);
+}
+
 void CharacterBase::UpdateCooldowns(float deltaTime) {
     for (int i = 0; i < 8; ++i) {
         if (m_gearSkillCooldowns[i] > 0.0f) {
@@ -270,8 +418,8 @@ bool CharacterBase::HasSpecialMove(InputDirection direction) const {
 }
 
 bool CharacterBase::CanExecuteSpecialMove(InputDirection direction) const {
-    // Cannot execute special moves while blocking
-    if (IsBlocking()) {
+    // Cannot execute special moves while blocking or locked out
+    if (IsBlocking() || !CanUseSpecialMoves()) {
         return false;
     }
     
@@ -338,8 +486,19 @@ bool CharacterBase::CanExecuteSpecialMoveInStance(InputDirection direction, int
     return CanExecuteSpecialMove(direction);
 }
 
-} // namespace ArenaFighter
+#ifdef DFR_HEADLESS
+// Headless builds keep no animation data
+bool CharacterBase::InitializeAnimator(const std::string&) {
+    return false;
+}
+
+bool CharacterBase::LoadAnimation(const std::string&, const std::string&) {
+    return false;
+}
 
+void CharacterBase::PlayAnimation(const std::string&, bool) {
+}
+#else
 // Animation system implementation
 bool CharacterBase::InitializeAnimator(const std::string& skeletonPath) {
     if (!m_animator) {
@@ -361,3 +520,11 @@ bool CharacterBase::LoadAnimation(const std::string& name, const std::string& fi
 void CharacterBase::PlayAnimation(const std::string& stateName, bool forceRestart) {
     if (!m_animator) {
         std::cerr << "CharacterBase::PlayAnimation: Animator not initialized!" << std::endl;
+        return;
+    }
+    
+    m_animator->PlayState(stateName, forceRestart);
+}
+#endif // DFR_HEADLESS
+
+} // namespace ArenaFighter
@@ -4,6 +4,10 @@
 #include <array>
 #include <memory>
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include "../Combat/CombatEnums.h"
 #include "CharacterCategory.h"
 
@@ -12,10 +16,14 @@ namespace ArenaFighter {
 // Forward declarations
 class CombatSystem;
 class CharacterAnimator;
+class RigidBody;
+class Collider;
 struct FrameData;
+struct HitResult;
 enum class ElementType {
     Neutral,
     Fire,
+    Water,
     Ice,
     Lightning,
     Earth,
@@ -37,11 +45,15 @@ enum class CharacterState {
     ExecutingSpecial  // During special move execution
 };
 
+// Special moves are registered for the four directions. SpecialMoveSystem
+// also reads Neutral (S alone) and DownDown (Down+S, stance switch).
 enum class InputDirection {
     Up,
     Down,
     Left,
-    Right
+    Right,
+    Neutral,
+    DownDown
 };
 
 enum class CharacterCategory {
@@ -102,6 +114,54 @@ struct SpecialMove {
     int requiredStance = -1;  // -1 means any stance
 };
 
+/**
+ * @brief Flat rollback snapshot of one character
+ *
+ * Fixed size and trivially copyable, so saving or restoring a frame is a
+ * plain copy. Holds simulation state only: names, skill tables, animation
+ * and visual effects are rebuilt from the character definition and stay
+ * out of the blob. Subclass state lives in characterData.
+ */
+struct CharacterSnapshot {
+    static constexpr size_t CHARACTER_DATA_SIZE = 1024;
+
+    int32_t characterId;              // Guards against loading into another character
+
+    // Stats (transformations rewrite these)
+    float maxHealth;
+    float currentHealth;
+    float maxMana;
+    float currentMana;
+    float defense;
+    float speed;
+    float weight;
+    float powerModifier;
+    float criticalChance;
+    ElementType element;
+    CharacterState currentState;
+
+    // Gear and special moves
+    float gearSkillCooldowns[8];
+    int32_t currentGear;
+    InputDirection lastSpecialDirection;
+
+    // Timers
+    float stateTimer;
+    float manaRegenTimer;
+    float blockDuration;
+    float stunDuration;
+
+    // Physics-facing state (the rigid body is saved next to the snapshot)
+    int32_t facingDirection;
+    int32_t airDashesRemaining;
+
+    // Subclass state, written with CharacterBase::WriteCharacterData
+    uint32_t characterDataSize;
+    alignas(8) uint8_t characterData[CHARACTER_DATA_SIZE];
+};
+
+static_assert(std::is_trivially_copyable_v<CharacterSnapshot>, "CharacterSnapshot must stay a flat blob");
+
 /**
  * @brief Base class for all characters in DFR
  *
@@ -142,7 +202,11 @@ public:
 
     // Health management
     void TakeDamage(float damage);
+    void TakeDamage(const HitResult& hit);
     void Heal(float amount);
+    void SetHealth(float health);  // Clamped to [0, max]; modes and debug tools
+    void SetMaxHealth(float maxHealth);
+    void SetMana(float mana);
     bool IsAlive() const { return m_currentHealth > 0; }
 
     // State management
@@ -153,6 +217,7 @@ public:
     bool IsBlocking() const { return m_currentState == CharacterState::Blocking; }
     void StartBlocking();
     void StopBlocking();
+    virtual void Block() { StartBlocking(); }
 
     // Gear system - 4 gears x 2 skills = 8 total skills (WITH COOLDOWNS)
     const std::array<GearSkill, 8>& GetGearSkills() const { return m_gearSkills; }
@@ -169,6 +234,9 @@ public:
     float GetGearSkillCooldownRemaining(int skillIndex) const;
     void StartGearSkillCooldown(int skillIndex);
 
+    // Pays mana and starts the cooldown, then calls OnSkillUse
+    virtual void ExecuteGearSkill(int skillIndex);
+
     // Special move system - S+Direction inputs (MANA ONLY, NO COOLDOWN)
     void RegisterSpecialMove(InputDirection direction, const SpecialMove& move);
     const SpecialMove* GetSpecialMove(InputDirection direction) const;
@@ -177,11 +245,26 @@ public:
 
     // Execute special move
     bool CanExecuteSpecialMove(InputDirection direction) const;
-    void ExecuteSpecialMove(InputDirection direction);
+    virtual void ExecuteSpecialMove(InputDirection direction);
+    virtual bool CanUseSpecialMoves() const { return true; }
 
     // Helper for stance-based special moves
     bool CanExecuteSpecialMoveInStance(InputDirection direction, int currentStance) const;
 
+    // Physics - PhysicsEngine moves the body and tests the boxes
+    RigidBody* GetRigidBody() { return m_rigidBody.get(); }
+    const RigidBody* GetRigidBody() const { return m_rigidBody.get(); }
+    const std::vector<Collider*>& GetActiveHitboxes() const { return m_activeHitboxes; }
+    const std::vector<Collider*>& GetHurtboxes() const { return m_hurtboxes; }
+    bool IsInStartup() const;
+    float GetMovementSpeed() const { return m_speed; }
+    int GetFacingDirection() const { return m_facingDirection; }
+    void SetFacingDirection(int direction) { m_facingDirection = direction; }
+    bool CanAirDash() const { return m_airDashesRemaining > 0; }
+    void ConsumeAirDash();
+    void SetHitstun(int frames);
+    void SetBlockstun(int frames);
+
     // Animation system
     CharacterAnimator* GetAnimator() { return m_animator.get(); }
     const CharacterAnimator* GetAnimator() const { return m_animator.get(); }
@@ -207,6 +290,10 @@ public:
     std::string GetVisualTheme() const;
     std::string GetAuraType() const;
 
+    // Rollback snapshots - subclasses extend both and call the base first
+    virtual void SaveState(CharacterSnapshot& snapshot) const;
+    virtual bool LoadState(const CharacterSnapshot& snapshot);
+
 protected:
     // Core properties
     int m_id;
@@ -238,10 +325,12 @@ protected:
     std::unordered_map<InputDirection, SpecialMove> m_specialMoves;
     InputDirection m_lastSpecialDirection = InputDirection::Up;
 
-    // Character-specific systems (optional)
-    std::unique_ptr<class StanceSystem> m_stanceSystem;
-    std::unique_ptr<class EvolutionSystem> m_evolutionSystem;
-    std::unique_ptr<class TransformationSystem> m_transformationSystem;
+    // Physics body and boxes; characters fill the boxes from frame data
+    std::unique_ptr<RigidBody> m_rigidBody;
+    std::vector<Collider*> m_activeHitboxes;
+    std::vector<Collider*> m_hurtboxes;
+    int m_facingDirection = 1;  // 1 = right, -1 = left
+    int m_airDashesRemaining = 1;
 
     // Animation system
     std::unique_ptr<CharacterAnimator> m_animator;
@@ -249,6 +338,24 @@ protected:
     // Apply category and stat mode modifiers
     void ApplyStatModifiers();
 
+    // Copy a subclass's trivially copyable state in and out of the snapshot
+    template <typename T>
+    static void WriteCharacterData(CharacterSnapshot& snapshot, const T& data) {
+        static_assert(std::is_trivially_copyable_v<T>, "Character state must be trivially copyable");
+        static_assert(sizeof(T) <= CharacterSnapshot::CHARACTER_DATA_SIZE, "Character state too large");
+        std::memcpy(snapshot.characterData, &data, sizeof(T));
+        snapshot.characterDataSize = sizeof(T);
+    }
+
+    template <typename T>
+    static bool ReadCharacterData(const CharacterSnapshot& snapshot, T& data) {
+        if (snapshot.characterDataSize != sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&data, snapshot.characterData, sizeof(T));
+        return true;
+    }
+
 private:
     static int s_nextId;
 
@@ -256,19 +363,10 @@ private:
     float m_stateTimer = 0.0f;
     float m_manaRegenTimer = 0.0f;
     float m_blockDuration = 0.0f;  // Time spent blocking
+    float m_stunDuration = 0.0f;   // Hitstun or blockstun left to serve
 
     // Update cooldowns
     void UpdateCooldowns(float deltaTime);
 };
 
 } // namespace ArenaFighter
-
-// Hash function for InputDirection to use with unordered_map
-namespace std {
-    template<>
-    struct hash<ArenaFighter::InputDirection> {
-        size_t operator()(const ArenaFighter::InputDirection& dir) const {
-            return hash<int>()(static_cast<int>(dir));
-        }
-    };
-}
@@ -3,6 +3,7 @@
 #include <iostream>
 #include "Murim/HyukWoonSung.h"
 #include "System/Yuito.h"
+#include "System/CyberNinja.h"
 #include "GodsHeroes/HyoudouKotetsu.h"
 #include "Monsters/GobTheGoodGoblin.h"
 #include "Cultivation/Seraphina.h"
@@ -26,7 +27,16 @@ void CharacterFactory::RegisterCharacter(int id, const std::string& name,
     CharacterInfo info{id, name, category, description, true};
     m_characterInfo[id] = info;
     m_nameToId[name] = id;
-    m_roster.push_back(info);
+
+    // Registering an id again replaces it, so initializing twice does
+    // not duplicate the roster
+    auto existing = std::find_if(m_roster.begin(), m_roster.end(),
+                                 [id](const CharacterInfo& entry) { return entry.id == id; });
+    if (existing != m_roster.end()) {
+        *existing = info;
+    } else {
+        m_roster.push_back(info);
+    }
     
     // Sort roster by category then by name
     std::sort(m_roster.begin(), m_roster.end(),
@@ -126,9 +136,7 @@ void CharacterFactory::RegisterSystemCharacters() {
     // Cyber Ninja
     RegisterCharacter(103, "Cyber Ninja", CharacterCategory::System,
         "Stealth assassin with advanced cloaking and hacking abilities",
-        []() { return std::make_unique<CharacterBase>("Cyber Ninja",
-                                                      CharacterCategory::System,
-                                                      StatMode::Hybrid); });
+        []() { return std::make_unique<CyberNinja>(); });
 }
 
 void CharacterFactory::RegisterGodsHeroesCharacters() {
@@ -55,20 +55,20 @@ void ConvergenceMeter::FillToMax() {
 // Seraphina Constructor
 // ============================================================================
 
-Seraphina::Seraphina() {
+Seraphina::Seraphina()
+    : CharacterBase("Seraphina", CharacterCategory::Cultivation, StatMode::Hybrid) {
     InitializeSeraphinaStats();
 }
 
 void Seraphina::InitializeSeraphinaStats() {
     // S-Tier Cultivation stats
-    stats.maxHealth = 240.0f;
-    stats.health = 240.0f;
-    stats.attack = 105.0f;
-    stats.defense = 90.0f;
-    stats.speed = 110.0f;       // High mobility with wings
-    stats.maxMana = 100.0f;
-    stats.mana = 100.0f;
-    stats.manaRegen = 5.0f;
+    m_maxHealth = 240.0f;
+    m_currentHealth = 240.0f;
+    m_powerModifier = 1.05f;
+    m_defense = 90.0f;
+    m_speed = 110.0f;       // High mobility with wings
+    m_maxMana = 100.0f;
+    m_currentMana = 100.0f;
 
     // Cultivation resources start full
     cultivationEssence.current = 100.0f;
@@ -149,6 +149,93 @@ void Seraphina::Update(float deltaTime) {
     }
 }
 
+// ============================================================================
+// Rollback Snapshots
+// ============================================================================
+
+namespace {
+
+struct SeraphinaState {
+    CultivationEssence cultivationEssence;
+    ConvergenceMeter convergenceMeter;
+    DaoPath currentDao;
+    bool isInConvergenceState;
+    float convergenceTimeRemaining;
+    bool convergenceEnhanced;
+    bool angelsDesperationUsed;
+    bool isDaoAwakened;
+    float daoAwakeningTimer;
+    bool celestialAuthorityActive;
+    float celestialAuthorityTimer;
+    bool iceMirrorBombActive;
+    bool toxicShadowBombActive;
+    float cloneBombTimer;
+    bool glacialSymbolActive;
+    bool toxicSymbolActive;
+    float elementSymbolTimer;
+    bool heavensDominionActive;
+    float heavensDominionTimer;
+};
+
+} // namespace
+
+void Seraphina::SaveState(CharacterSnapshot& snapshot) const {
+    CharacterBase::SaveState(snapshot);
+
+    SeraphinaState state;
+    std::memset(&state, 0, sizeof(state));
+    state.cultivationEssence = cultivationEssence;
+    state.convergenceMeter = convergenceMeter;
+    state.currentDao = currentDao;
+    state.isInConvergenceState = isInConvergenceState;
+    state.convergenceTimeRemaining = convergenceTimeRemaining;
+    state.convergenceEnhanced = convergenceEnhanced;
+    state.angelsDesperationUsed = angelsDesperationUsed;
+    state.isDaoAwakened = isDaoAwakened;
+    state.daoAwakeningTimer = daoAwakeningTimer;
+    state.celestialAuthorityActive = celestialAuthorityActive;
+    state.celestialAuthorityTimer = celestialAuthorityTimer;
+    state.iceMirrorBombActive = iceMirrorBombActive;
+    state.toxicShadowBombActive = toxicShadowBombActive;
+    state.cloneBombTimer = cloneBombTimer;
+    state.glacialSymbolActive = glacialSymbolActive;
+    state.toxicSymbolActive = toxicSymbolActive;
+    state.elementSymbolTimer = elementSymbolTimer;
+    state.heavensDominionActive = heavensDominionActive;
+    state.heavensDominionTimer = heavensDominionTimer;
+
+    WriteCharacterData(snapshot, state);
+}
+
+bool Seraphina::LoadState(const CharacterSnapshot& snapshot) {
+    SeraphinaState state = {};
+    if (!CharacterBase::LoadState(snapshot) || !ReadCharacterData(snapshot, state)) {
+        return false;
+    }
+
+    cultivationEssence = state.cultivationEssence;
+    convergenceMeter = state.convergenceMeter;
+    currentDao = state.currentDao;
+    isInConvergenceState = state.isInConvergenceState;
+    convergenceTimeRemaining = state.convergenceTimeRemaining;
+    convergenceEnhanced = state.convergenceEnhanced;
+    angelsDesperationUsed = state.angelsDesperationUsed;
+    isDaoAwakened = state.isDaoAwakened;
+    daoAwakeningTimer = state.daoAwakeningTimer;
+    celestialAuthorityActive = state.celestialAuthorityActive;
+    celestialAuthorityTimer = state.celestialAuthorityTimer;
+    iceMirrorBombActive = state.iceMirrorBombActive;
+    toxicShadowBombActive = state.toxicShadowBombActive;
+    cloneBombTimer = state.cloneBombTimer;
+    glacialSymbolActive = state.glacialSymbolActive;
+    toxicSymbolActive = state.toxicSymbolActive;
+    elementSymbolTimer = state.elementSymbolTimer;
+    heavensDominionActive = state.heavensDominionActive;
+    heavensDominionTimer = state.heavensDominionTimer;
+
+    return true;
+}
+
 // ============================================================================
 // Resource Management
 // ============================================================================
@@ -249,7 +336,7 @@ void Seraphina::ApplyConvergenceEnhancements() {
 // ============================================================================
 
 void Seraphina::CheckEmergencyProtocol() {
-    float healthPercent = stats.health / stats.maxHealth;
+    float healthPercent = m_currentHealth / m_maxHealth;
 
     if (healthPercent <= 0.30f && !angelsDesperationUsed) {
         TriggerAngelsDesperateAscension();
@@ -305,7 +392,7 @@ float Seraphina::GetCooldownReduction() const {
 // Combat Overrides
 // ============================================================================
 
-void Seraphina::ExecuteSpecialMove(Direction direction) {
+void Seraphina::ExecuteSpecialMove(InputDirection direction) {
     if (!CanUseSpecialMoves()) {
         return;
     }
@@ -349,9 +436,9 @@ bool Seraphina::CanUseSpecialMoves() const {
 // ICE DAO TECHNIQUES
 // ============================================================================
 
-void Seraphina::IceDaoAbilities(Direction direction) {
+void Seraphina::IceDaoAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Glacial Feather Storm: 6 ice feathers seeking enemies
             if (cultivationEssence.CanAfford(TechniqueCosts::ASCENDING_TECHNIQUE * GetEssenceCostMultiplier())) {
                 cultivationEssence.Consume(TechniqueCosts::ASCENDING_TECHNIQUE * GetEssenceCostMultiplier());
@@ -361,7 +448,7 @@ void Seraphina::IceDaoAbilities(Direction direction) {
             }
             break;
 
-        case Direction::Left:
+        case InputDirection::Left:
             // Frozen Wing Sanctuary: Defensive ice barrier
             if (cultivationEssence.CanAfford(TechniqueCosts::RETREAT_TECHNIQUE * GetEssenceCostMultiplier())) {
                 cultivationEssence.Consume(TechniqueCosts::RETREAT_TECHNIQUE * GetEssenceCostMultiplier());
@@ -372,7 +459,7 @@ void Seraphina::IceDaoAbilities(Direction direction) {
             }
             break;
 
-        case Direction::Right:
+        case InputDirection::Right:
             // Blizzard Wing Rush: Ice storm charge
             if (cultivationEssence.CanAfford(TechniqueCosts::FORWARD_TECHNIQUE * GetEssenceCostMultiplier())) {
                 cultivationEssence.Consume(TechniqueCosts::FORWARD_TECHNIQUE * GetEssenceCostMultiplier());
@@ -382,7 +469,7 @@ void Seraphina::IceDaoAbilities(Direction direction) {
             }
             break;
 
-        case Direction::Down:
+        case InputDirection::Down:
             // Toggle Dao to Poison
             ToggleDao();
             break;
@@ -429,9 +516,9 @@ void Seraphina::IceDaoGearSkills(int index) {
 // POISON DAO TECHNIQUES
 // ============================================================================
 
-void Seraphina::PoisonDaoAbilities(Direction direction) {
+void Seraphina::PoisonDaoAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Toxic Wing Ascension: Diving poison strike
             if (cultivationEssence.CanAfford(TechniqueCosts::ASCENDING_TECHNIQUE * GetEssenceCostMultiplier())) {
                 cultivationEssence.Consume(TechniqueCosts::ASCENDING_TECHNIQUE * GetEssenceCostMultiplier());
@@ -441,7 +528,7 @@ void Seraphina::PoisonDaoAbilities(Direction direction) {
             }
             break;
 
-        case Direction::Left:
+        case InputDirection::Left:
             // Toxic Wing Escape: Untargetable poison mist
             if (cultivationEssence.CanAfford(TechniqueCosts::RETREAT_TECHNIQUE * GetEssenceCostMultiplier())) {
                 cultivationEssence.Consume(TechniqueCosts::RETREAT_TECHNIQUE * GetEssenceCostMultiplier());
@@ -452,7 +539,7 @@ void Seraphina::PoisonDaoAbilities(Direction direction) {
             }
             break;
 
-        case Direction::Right:
+        case InputDirection::Right:
             // Toxic Wing Dash: Teleport poison line
             if (cultivationEssence.CanAfford(TechniqueCosts::FORWARD_TECHNIQUE * GetEssenceCostMultiplier())) {
                 cultivationEssence.Consume(TechniqueCosts::FORWARD_TECHNIQUE * GetEssenceCostMultiplier());
@@ -463,7 +550,7 @@ void Seraphina::PoisonDaoAbilities(Direction direction) {
             }
             break;
 
-        case Direction::Down:
+        case InputDirection::Down:
             // Toggle Dao to Ice
             ToggleDao();
             break;
@@ -510,19 +597,19 @@ void Seraphina::PoisonDaoGearSkills(int index) {
 // CONVERGENCE STATE TECHNIQUES
 // ============================================================================
 
-void Seraphina::ConvergenceAbilities(Direction direction) {
+void Seraphina::ConvergenceAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Convergence version of ascending technique
             // TODO: Implement dual-element version
             break;
 
-        case Direction::Left:
+        case InputDirection::Left:
             // Convergence version of retreat technique
             // TODO: Implement dual-element version
             break;
 
-        case Direction::Right:
+        case InputDirection::Right:
             // Dimensional Rift Gate: Portal with dual effects
             if (cultivationEssence.CanAfford(TechniqueCosts::DIMENSIONAL_RIFT_GATE * GetEssenceCostMultiplier())) {
                 cultivationEssence.Consume(TechniqueCosts::DIMENSIONAL_RIFT_GATE * GetEssenceCostMultiplier());
@@ -533,7 +620,7 @@ void Seraphina::ConvergenceAbilities(Direction direction) {
             }
             break;
 
-        case Direction::Down:
+        case InputDirection::Down:
             // Can't toggle during Convergence
             break;
 
@@ -68,6 +68,10 @@ public:
     // Core Update
     void Update(float deltaTime) override;
 
+    // Rollback snapshots
+    void SaveState(CharacterSnapshot& snapshot) const override;
+    bool LoadState(const CharacterSnapshot& snapshot) override;
+
     // Resource Management
     CultivationEssence cultivationEssence;
     ConvergenceMeter convergenceMeter;
@@ -98,7 +102,7 @@ public:
     static constexpr float ENHANCED_CONVERGENCE_DURATION = 25.0f;
 
     // Emergency Protocol
-    bool angelsDesperation Used = false;
+    bool angelsDesperationUsed = false;
     void CheckEmergencyProtocol();
     void TriggerAngelsDesperateAscension();  // At 30% HP
 
@@ -114,24 +118,24 @@ public:
     // Would need to track per enemy in real implementation
 
     // Combat Overrides
-    void ExecuteSpecialMove(Direction direction) override;
+    void ExecuteSpecialMove(InputDirection direction) override;
     void ExecuteGearSkill(int index) override;
     void Block() override;
     bool CanUseSpecialMoves() const override;
 
     // Dao-Specific Abilities
     // Ice Dao Techniques
-    void IceDaoAbilities(Direction direction);
+    void IceDaoAbilities(InputDirection direction);
     void IceDaoGearSkills(int index);
     void IceDaoBlock();
 
     // Poison Dao Techniques
-    void PoisonDaoAbilities(Direction direction);
+    void PoisonDaoAbilities(InputDirection direction);
     void PoisonDaoGearSkills(int index);
     void PoisonDaoBlock();
 
     // Convergence State Techniques
-    void ConvergenceAbilities(Direction direction);
+    void ConvergenceAbilities(InputDirection direction);
     void ConvergenceGearSkills(int index);
     void ConvergenceBlock();
 
@@ -1,7 +1,9 @@
 #include "HyoudouKotetsu.h"
 #include "../../Combat/DamageCalculator.h"
+#include "../../Physics/Collider.h"
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 
 namespace ArenaFighter {
 
@@ -42,6 +44,43 @@ GodClone::GodClone(GodType type)
     , z(0.0f) {
 }
 
+void GodClone::SaveState(GodCloneSnapshot& snapshot) const {
+    std::memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.type = type;
+    snapshot.health = health;
+    snapshot.maxHealth = maxHealth;
+    std::copy(std::begin(damage), std::end(damage), snapshot.damage);
+    snapshot.x = x;
+    snapshot.y = y;
+    snapshot.z = z;
+    snapshot.speedMultiplier = speedMultiplier;
+    snapshot.isAlive = isAlive;
+
+    SaveAIState(snapshot);
+}
+
+void GodClone::LoadState(const GodCloneSnapshot& snapshot) {
+    health = snapshot.health;
+    maxHealth = snapshot.maxHealth;
+    std::copy(std::begin(snapshot.damage), std::end(snapshot.damage), damage);
+    x = snapshot.x;
+    y = snapshot.y;
+    z = snapshot.z;
+    speedMultiplier = snapshot.speedMultiplier;
+    isAlive = snapshot.isAlive;
+
+    LoadAIState(snapshot);
+}
+
+std::shared_ptr<GodClone> GodClone::Create(GodType type) {
+    switch (type) {
+        case GodType::Vulcanus: return std::make_shared<VulcanusClone>();
+        case GodType::Mercurius: return std::make_shared<MercuriusClone>();
+        case GodType::Diana: return std::make_shared<DianaClone>();
+    }
+    return nullptr;
+}
+
 // ============================================================================
 // Vulcanus Clone - Fire Titan
 // ============================================================================
@@ -112,6 +151,20 @@ void VulcanusClone::MoltenShield() {
     // TODO: Add timed buff system
 }
 
+void VulcanusClone::SaveAIState(GodCloneSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = attackTimer;
+    snapshot.aiTimers[1] = slamTimer;
+    snapshot.aiTimers[2] = shieldTimer;
+    snapshot.aiFlag = isShielded;
+}
+
+void VulcanusClone::LoadAIState(const GodCloneSnapshot& snapshot) {
+    attackTimer = snapshot.aiTimers[0];
+    slamTimer = snapshot.aiTimers[1];
+    shieldTimer = snapshot.aiTimers[2];
+    isShielded = snapshot.aiFlag;
+}
+
 // ============================================================================
 // Mercurius Clone - Swift Thief
 // ============================================================================
@@ -180,6 +233,20 @@ void MercuriusClone::WindStep() {
     // TODO: Implement
 }
 
+void MercuriusClone::SaveAIState(GodCloneSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = attackTimer;
+    snapshot.aiTimers[1] = stealTimer;
+    snapshot.aiTimers[2] = dodgeTimer;
+    snapshot.aiCounter = consecutiveHits;
+}
+
+void MercuriusClone::LoadAIState(const GodCloneSnapshot& snapshot) {
+    attackTimer = snapshot.aiTimers[0];
+    stealTimer = snapshot.aiTimers[1];
+    dodgeTimer = snapshot.aiTimers[2];
+    consecutiveHits = snapshot.aiCounter;
+}
+
 // ============================================================================
 // Diana Clone - Moonlight Huntress
 // ============================================================================
@@ -247,25 +314,39 @@ void DianaClone::HuntersMark() {
     // TODO: Implement marking system
 }
 
+void DianaClone::SaveAIState(GodCloneSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = attackTimer;
+    snapshot.aiTimers[1] = curseTimer;
+    snapshot.aiTimers[2] = markTimer;
+    snapshot.aiTimers[3] = maintainDistance;
+}
+
+void DianaClone::LoadAIState(const GodCloneSnapshot& snapshot) {
+    attackTimer = snapshot.aiTimers[0];
+    curseTimer = snapshot.aiTimers[1];
+    markTimer = snapshot.aiTimers[2];
+    maintainDistance = snapshot.aiTimers[3];
+}
+
 // ============================================================================
 // Hyoudou Kotetsu Constructor
 // ============================================================================
 
-HyoudouKotetsu::HyoudouKotetsu() {
+HyoudouKotetsu::HyoudouKotetsu()
+    : CharacterBase("Hyoudou Kotetsu", CharacterCategory::GodsHeroes, StatMode::Hybrid) {
     InitializeHyoudouStats();
     SetupBaseGearSkills();
 }
 
 void HyoudouKotetsu::InitializeHyoudouStats() {
     // S-Tier Stats - Balanced Divine Thief
-    stats.maxHealth = 250.0f;
-    stats.health = 250.0f;
-    stats.attack = 110.0f;      // High base damage
-    stats.defense = 85.0f;      // Moderate defense
-    stats.speed = 105.0f;       // Above average speed
-    stats.maxMana = 100.0f;
-    stats.mana = 100.0f;
-    stats.manaRegen = 5.0f;
+    m_maxHealth = 250.0f;
+    m_currentHealth = 250.0f;
+    m_powerModifier = 1.1f;      // High base damage
+    m_defense = 85.0f;      // Moderate defense
+    m_speed = 105.0f;       // Above average speed
+    m_maxMana = 100.0f;
+    m_currentMana = 100.0f;
 
     // Pantheon gauge starts at 0
     pantheonGauge.current = 0.0f;
@@ -303,6 +384,80 @@ void HyoudouKotetsu::Update(float deltaTime) {
     }
 }
 
+// ============================================================================
+// Rollback Snapshots
+// ============================================================================
+
+namespace {
+
+struct HyoudouState {
+    StolenPantheonGauge pantheonGauge;
+    CorruptionForm currentForm;
+    float corruptionTimeRemaining;
+    bool pantheonEndUsed;
+    int32_t vulcanusStackCount;
+    int32_t mercuriusStolenBuffs;
+    int32_t dianaMarkedEnemies;
+    uint32_t cloneCount;
+    GodCloneSnapshot clones[HyoudouKotetsu::MAX_GOD_CLONES];
+};
+
+} // namespace
+
+void HyoudouKotetsu::SaveState(CharacterSnapshot& snapshot) const {
+    CharacterBase::SaveState(snapshot);
+
+    HyoudouState state;
+    std::memset(&state, 0, sizeof(state));
+    state.pantheonGauge = pantheonGauge;
+    state.currentForm = currentForm;
+    state.corruptionTimeRemaining = corruptionTimeRemaining;
+    state.pantheonEndUsed = pantheonEndUsed;
+    state.vulcanusStackCount = vulcanusStackCount;
+    state.mercuriusStolenBuffs = mercuriusStolenBuffs;
+    state.dianaMarkedEnemies = dianaMarkedEnemies;
+    state.cloneCount = 0;
+
+    for (const auto& clone : godClones) {
+        if (clone && state.cloneCount < MAX_GOD_CLONES) {
+            clone->SaveState(state.clones[state.cloneCount++]);
+        }
+    }
+
+    WriteCharacterData(snapshot, state);
+}
+
+bool HyoudouKotetsu::LoadState(const CharacterSnapshot& snapshot) {
+    HyoudouState state = {};
+    if (!CharacterBase::LoadState(snapshot) || !ReadCharacterData(snapshot, state)) {
+        return false;
+    }
+
+    pantheonGauge = state.pantheonGauge;
+    currentForm = state.currentForm;
+    corruptionTimeRemaining = state.corruptionTimeRemaining;
+    pantheonEndUsed = state.pantheonEndUsed;
+    vulcanusStackCount = state.vulcanusStackCount;
+    mercuriusStolenBuffs = state.mercuriusStolenBuffs;
+    dianaMarkedEnemies = state.dianaMarkedEnemies;
+
+    // Clones summoned or dismissed inside the rollback window are recreated
+    godClones.resize(state.cloneCount);
+    for (uint32_t i = 0; i < state.cloneCount; ++i) {
+        const GodCloneSnapshot& cloneState = state.clones[i];
+        auto& clone = godClones[i];
+
+        if (!clone || clone->type != cloneState.type) {
+            clone = GodClone::Create(cloneState.type);
+        }
+        if (clone) {
+            clone->LoadState(cloneState);
+        }
+    }
+
+    return true;
+}
+
 // ============================================================================
 // Pantheon Gauge Generation
 // ============================================================================
@@ -342,9 +497,9 @@ bool HyoudouKotetsu::TransformToVulcanus() {
     vulcanusStackCount = 0;
 
     // Stat modifications: +30% attack, +20% defense, -10% speed
-    stats.attack *= 1.3f;
-    stats.defense *= 1.2f;
-    stats.speed *= 0.9f;
+    m_powerModifier *= 1.3f;
+    m_defense *= 1.2f;
+    m_speed *= 0.9f;
 
     return true;
 }
@@ -360,9 +515,9 @@ bool HyoudouKotetsu::TransformToMercurius() {
     mercuriusStolenBuffs = 0;
 
     // Stat modifications: +50% speed, +15% attack, -20% defense
-    stats.speed *= 1.5f;
-    stats.attack *= 1.15f;
-    stats.defense *= 0.8f;
+    m_speed *= 1.5f;
+    m_powerModifier *= 1.15f;
+    m_defense *= 0.8f;
 
     return true;
 }
@@ -378,8 +533,8 @@ bool HyoudouKotetsu::TransformToDiana() {
     dianaMarkedEnemies = 0;
 
     // Stat modifications: +25% attack, +30% speed, unchanged defense
-    stats.attack *= 1.25f;
-    stats.speed *= 1.3f;
+    m_powerModifier *= 1.25f;
+    m_speed *= 1.3f;
 
     return true;
 }
@@ -394,9 +549,9 @@ bool HyoudouKotetsu::TransformToCorruptedPluto() {
     corruptionTimeRemaining = PLUTO_DURATION;
 
     // Massive stat boost
-    stats.attack *= 1.5f;
-    stats.defense *= 1.3f;
-    stats.speed *= 1.4f;
+    m_powerModifier *= 1.5f;
+    m_defense *= 1.3f;
+    m_speed *= 1.4f;
 
     // Summon god clones
     SummonGodClones();
@@ -442,9 +597,11 @@ void HyoudouKotetsu::SummonGodClones() {
 }
 
 void HyoudouKotetsu::UpdateGodClones(float deltaTime) {
+    const DirectX::XMFLOAT3& position = GetRigidBody()->position;
+
     for (auto& clone : godClones) {
         if (clone && clone->IsAlive()) {
-            clone->UpdateAI(deltaTime, x, y, z);
+            clone->UpdateAI(deltaTime, position.x, position.y, position.z);
         }
     }
 
@@ -467,7 +624,7 @@ void HyoudouKotetsu::DismissGodClones() {
 // ============================================================================
 
 void HyoudouKotetsu::CheckPantheonEnd() {
-    float healthPercent = stats.health / stats.maxHealth;
+    float healthPercent = m_currentHealth / m_maxHealth;
 
     if (healthPercent <= 0.25f && !pantheonEndUsed) {
         TriggerPantheonEnd();
@@ -483,13 +640,13 @@ void HyoudouKotetsu::TriggerPantheonEnd() {
     corruptionTimeRemaining = PANTHEON_END_DURATION;  // Extended duration
 
     // Massive stat boost (even higher than normal Pluto)
-    stats.attack *= 1.8f;
-    stats.defense *= 1.5f;
-    stats.speed *= 1.6f;
+    m_powerModifier *= 1.8f;
+    m_defense *= 1.5f;
+    m_speed *= 1.6f;
 
     // Heal 50% HP
-    stats.health += stats.maxHealth * 0.5f;
-    stats.health = std::min(stats.health, stats.maxHealth);
+    m_currentHealth += m_maxHealth * 0.5f;
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
 
     // Summon enhanced god clones
     SummonGodClones();
@@ -501,7 +658,7 @@ void HyoudouKotetsu::TriggerPantheonEnd() {
 // Combat Overrides
 // ============================================================================
 
-void HyoudouKotetsu::ExecuteSpecialMove(Direction direction) {
+void HyoudouKotetsu::ExecuteSpecialMove(InputDirection direction) {
     if (!CanUseSpecialMoves()) {
         return;
     }
@@ -574,21 +731,21 @@ bool HyoudouKotetsu::CanUseSpecialMoves() const {
 // Base Form - Divine Thief Abilities
 // ============================================================================
 
-void HyoudouKotetsu::BaseDivineTheftAbilities(Direction direction) {
+void HyoudouKotetsu::BaseDivineTheftAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Ascending Theft (14 damage, launches enemy, steals buff)
             // TODO: Implement
             break;
-        case Direction::Down:
+        case InputDirection::Down:
             // Divine Snatch (15 damage ground slam, AOE theft)
             // TODO: Implement
             break;
-        case Direction::Left:
+        case InputDirection::Left:
             // Pantheon Surge (12 damage dash, generates +5 gauge)
             // TODO: Implement
             break;
-        case Direction::Right:
+        case InputDirection::Right:
             // God Breaker (18 damage heavy strike, breaks guard)
             // TODO: Implement
             break;
@@ -611,19 +768,19 @@ void HyoudouKotetsu::BaseDivineTheftGearSkills(int index) {
 // Form-Specific Abilities (Placeholders)
 // ============================================================================
 
-void HyoudouKotetsu::VulcanusAbilities(Direction direction) { /* TODO */ }
+void HyoudouKotetsu::VulcanusAbilities(InputDirection direction) { /* TODO */ }
 void HyoudouKotetsu::VulcanusBlock() { CharacterBase::Block(); }
 void HyoudouKotetsu::VulcanusGearSkills(int index) { /* TODO */ }
 
-void HyoudouKotetsu::MercuriusAbilities(Direction direction) { /* TODO */ }
+void HyoudouKotetsu::MercuriusAbilities(InputDirection direction) { /* TODO */ }
 void HyoudouKotetsu::MercuriusBlock() { CharacterBase::Block(); }
 void HyoudouKotetsu::MercuriusGearSkills(int index) { /* TODO */ }
 
-void HyoudouKotetsu::DianaAbilities(Direction direction) { /* TODO */ }
+void HyoudouKotetsu::DianaAbilities(InputDirection direction) { /* TODO */ }
 void HyoudouKotetsu::DianaBlock() { CharacterBase::Block(); }
 void HyoudouKotetsu::DianaGearSkills(int index) { /* TODO */ }
 
-void HyoudouKotetsu::PlutoAbilities(Direction direction) { /* TODO */ }
+void HyoudouKotetsu::PlutoAbilities(InputDirection direction) { /* TODO */ }
 void HyoudouKotetsu::PlutoBlock() { CharacterBase::Block(); }
 void HyoudouKotetsu::PlutoGearSkills(int index) { /* TODO */ }
 
@@ -56,6 +56,21 @@ enum class GodType {
     Diana       // Ranged support, debuffs
 };
 
+// Rollback image of one clone. Each god type packs its private AI state
+// into the generic ai* fields.
+struct GodCloneSnapshot {
+    GodType type;
+    float health;
+    float maxHealth;
+    float damage[4];
+    float x, y, z;
+    float speedMultiplier;
+    bool isAlive;
+    bool aiFlag;
+    float aiTimers[4];
+    int32_t aiCounter;
+};
+
 class GodClone {
 public:
     GodClone(GodType type);
@@ -75,6 +90,15 @@ public:
     virtual void OnDeath() = 0;
 
     bool IsAlive() const { return isAlive; }
+
+    // Rollback support
+    void SaveState(GodCloneSnapshot& snapshot) const;
+    void LoadState(const GodCloneSnapshot& snapshot);
+    static std::shared_ptr<GodClone> Create(GodType type);
+
+protected:
+    virtual void SaveAIState(GodCloneSnapshot& snapshot) const {}
+    virtual void LoadAIState(const GodCloneSnapshot& snapshot) {}
 };
 
 // Vulcanus Clone - Fire Titan
@@ -89,6 +113,10 @@ public:
     void ForgeStrike();     // Single target heavy hit
     void MoltenShield();    // Temporary invulnerability
 
+protected:
+    void SaveAIState(GodCloneSnapshot& snapshot) const override;
+    void LoadAIState(const GodCloneSnapshot& snapshot) override;
+
 private:
     float attackTimer = 0.0f;
     float slamTimer = 0.0f;
@@ -108,6 +136,10 @@ public:
     void StealBuff();           // Steal enemy buffs
     void WindStep();            // Teleport dodge
 
+protected:
+    void SaveAIState(GodCloneSnapshot& snapshot) const override;
+    void LoadAIState(const GodCloneSnapshot& snapshot) override;
+
 private:
     float attackTimer = 0.0f;
     float stealTimer = 0.0f;
@@ -127,6 +159,10 @@ public:
     void CurseShot();           // Debuff projectile
     void HuntersMark();         // Mark enemy for bonus damage
 
+protected:
+    void SaveAIState(GodCloneSnapshot& snapshot) const override;
+    void LoadAIState(const GodCloneSnapshot& snapshot) override;
+
 private:
     float attackTimer = 0.0f;
     float curseTimer = 0.0f;
@@ -145,6 +181,10 @@ public:
     // Core Update
     void Update(float deltaTime) override;
 
+    // Rollback snapshots (god clones included)
+    void SaveState(CharacterSnapshot& snapshot) const override;
+    bool LoadState(const CharacterSnapshot& snapshot) override;
+
     // Resource Management
     StolenPantheonGauge pantheonGauge;
     void GeneratePantheonPower(float amount);
@@ -167,6 +207,7 @@ public:
     bool IsCorrupted() const { return currentForm != CorruptionForm::None; }
 
     // God Clone Management (Pluto form only)
+    static constexpr size_t MAX_GOD_CLONES = 3;
     std::vector<std::shared_ptr<GodClone>> godClones;
     void SummonGodClones();
     void UpdateGodClones(float deltaTime);
@@ -178,34 +219,34 @@ public:
     void TriggerPantheonEnd();  // At 25% HP
 
     // Combat Overrides
-    void ExecuteSpecialMove(Direction direction) override;
+    void ExecuteSpecialMove(InputDirection direction) override;
     void ExecuteGearSkill(int index) override;
     void Block() override;
     bool CanUseSpecialMoves() const override;
 
     // Form-Specific Abilities
     // Base Form - Divine Thief
-    void BaseDivineTheftAbilities(Direction direction);
+    void BaseDivineTheftAbilities(InputDirection direction);
     void BaseDivineTheftGearSkills(int index);
     void BaseDivineTheftBlock();
 
     // Vulcanus Form - Fire Titan
-    void VulcanusAbilities(Direction direction);
+    void VulcanusAbilities(InputDirection direction);
     void VulcanusGearSkills(int index);
     void VulcanusBlock();
 
     // Mercurius Form - Swift Thief
-    void MercuriusAbilities(Direction direction);
+    void MercuriusAbilities(InputDirection direction);
     void MercuriusGearSkills(int index);
     void MercuriusBlock();
 
     // Diana Form - Moonlight Huntress
-    void DianaAbilities(Direction direction);
+    void DianaAbilities(InputDirection direction);
     void DianaGearSkills(int index);
     void DianaBlock();
 
     // Corrupted Pluto Form - Death God
-    void PlutoAbilities(Direction direction);
+    void PlutoAbilities(InputDirection direction);
     void PlutoGearSkills(int index);
     void PlutoBlock();
 
@@ -37,7 +37,8 @@ void EvolutionGauge::ApplyDeathPenalty() {
 // GobTheGoodGoblin Constructor
 // ============================================================================
 
-GobTheGoodGoblin::GobTheGoodGoblin() {
+GobTheGoodGoblin::GobTheGoodGoblin()
+    : CharacterBase("Gob the Good Goblin", CharacterCategory::Monsters, StatMode::Hybrid) {
     InitializeGobStats();
     TransformToGoblin();  // Start in Goblin form
 }
@@ -49,9 +50,8 @@ void GobTheGoodGoblin::InitializeGobStats() {
     baseStats.defense = 80.0f;
     baseStats.speed = 100.0f;
 
-    stats.maxMana = 100.0f;
-    stats.mana = 100.0f;
-    stats.manaRegen = 5.0f;
+    m_maxMana = 100.0f;
+    m_currentMana = 100.0f;
 
     // Evolution gauge starts at 0
     evolutionGauge.current = 0.0f;
@@ -89,6 +89,66 @@ void GobTheGoodGoblin::Update(float deltaTime) {
     }
 }
 
+// ============================================================================
+// Rollback Snapshots
+// ============================================================================
+
+namespace {
+
+// baseStats is fixed at construction and is not captured
+struct GobState {
+    EvolutionGauge evolutionGauge;
+    EvolutionForm currentForm;
+    bool emergencyProtocolUsed;
+    bool isInEvolutionAnimation;
+    float evolutionAnimationTimer;
+    int shadowPhaseChance;
+    int vulcanusForgeStacks;
+    int apostleDemonBuffDuration;
+    bool vajrayaksaMeterDrainPaused;
+};
+
+} // namespace
+
+void GobTheGoodGoblin::SaveState(CharacterSnapshot& snapshot) const {
+    CharacterBase::SaveState(snapshot);
+
+    GobState state;
+    std::memset(&state, 0, sizeof(state));
+    state.evolutionGauge = evolutionGauge;
+    state.currentForm = currentForm;
+    state.emergencyProtocolUsed = emergencyProtocolUsed;
+    state.isInEvolutionAnimation = isInEvolutionAnimation;
+    state.evolutionAnimationTimer = evolutionAnimationTimer;
+    state.shadowPhaseChance = shadowPhaseChance;
+    state.vulcanusForgeStacks = vulcanusForgeStacks;
+    state.apostleDemonBuffDuration = apostleDemonBuffDuration;
+    state.vajrayaksaMeterDrainPaused = vajrayaksaMeterDrainPaused;
+
+    WriteCharacterData(snapshot, state);
+}
+
+bool GobTheGoodGoblin::LoadState(const CharacterSnapshot& snapshot) {
+    GobState state = {};
+    if (!CharacterBase::LoadState(snapshot) || !ReadCharacterData(snapshot, state)) {
+        return false;
+    }
+
+    // The restored base snapshot already carries the form-modified stats,
+    // so the form is assigned directly instead of re-running the transform
+    evolutionGauge = state.evolutionGauge;
+    currentForm = state.currentForm;
+    emergencyProtocolUsed = state.emergencyProtocolUsed;
+    isInEvolutionAnimation = state.isInEvolutionAnimation;
+    evolutionAnimationTimer = state.evolutionAnimationTimer;
+    shadowPhaseChance = state.shadowPhaseChance;
+    vulcanusForgeStacks = state.vulcanusForgeStacks;
+    apostleDemonBuffDuration = state.apostleDemonBuffDuration;
+    vajrayaksaMeterDrainPaused = state.vajrayaksaMeterDrainPaused;
+
+    return true;
+}
+
 // ============================================================================
 // Evolution Gauge Generation
 // ============================================================================
@@ -182,33 +242,33 @@ void GobTheGoodGoblin::EvolveToForm(EvolutionForm newForm) {
 // ============================================================================
 
 void GobTheGoodGoblin::TransformToGoblin() {
-    stats.maxHealth = FormStatModifiers::Goblin::HP;
-    stats.health = std::min(stats.health, stats.maxHealth);
+    m_maxHealth = FormStatModifiers::Goblin::HP;
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
     ApplyFormStatModifications();
 }
 
 void GobTheGoodGoblin::TransformToHobgoblin() {
-    stats.maxHealth = FormStatModifiers::Hobgoblin::HP;
-    stats.health = std::min(stats.health, stats.maxHealth);
+    m_maxHealth = FormStatModifiers::Hobgoblin::HP;
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
     ApplyFormStatModifications();
 }
 
 void GobTheGoodGoblin::TransformToOgre() {
-    stats.maxHealth = FormStatModifiers::Ogre::HP;
-    stats.health = std::min(stats.health, stats.maxHealth);
+    m_maxHealth = FormStatModifiers::Ogre::HP;
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
     ApplyFormStatModifications();
     vulcanusForgeStacks = 0;
 }
 
 void GobTheGoodGoblin::TransformToApostleLord() {
-    stats.maxHealth = FormStatModifiers::ApostleLord::HP;
-    stats.health = std::min(stats.health, stats.maxHealth);
+    m_maxHealth = FormStatModifiers::ApostleLord::HP;
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
     ApplyFormStatModifications();
 }
 
 void GobTheGoodGoblin::TransformToVajrayaksa() {
-    stats.maxHealth = FormStatModifiers::Vajrayaksa::HP;
-    stats.health = std::min(stats.health, stats.maxHealth);
+    m_maxHealth = FormStatModifiers::Vajrayaksa::HP;
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
     ApplyFormStatModifications();
 
     // Vajrayaksa drains meter over time
@@ -217,9 +277,9 @@ void GobTheGoodGoblin::TransformToVajrayaksa() {
 
 void GobTheGoodGoblin::ApplyFormStatModifications() {
     // Apply form-specific stat multipliers
-    stats.attack = baseStats.attack * GetCurrentDamageMultiplier();
-    stats.defense = baseStats.defense / GetCurrentDefenseMultiplier();  // Inverted for damage taken
-    stats.speed = baseStats.speed * GetCurrentSpeedMultiplier();
+    m_powerModifier = baseStats.attack / 100.0f * GetCurrentDamageMultiplier();
+    m_defense = baseStats.defense / GetCurrentDefenseMultiplier();  // Inverted for damage taken
+    m_speed = baseStats.speed * GetCurrentSpeedMultiplier();
 }
 
 // ============================================================================
@@ -227,7 +287,7 @@ void GobTheGoodGoblin::ApplyFormStatModifications() {
 // ============================================================================
 
 void GobTheGoodGoblin::CheckEmergencyProtocol() {
-    float healthPercent = stats.health / stats.maxHealth;
+    float healthPercent = m_currentHealth / m_maxHealth;
 
     if (healthPercent <= 0.30f && !emergencyProtocolUsed) {
         TriggerEmergencyEvolution();
@@ -254,7 +314,7 @@ void GobTheGoodGoblin::TriggerEmergencyEvolution() {
             break;
         case EvolutionForm::Vajrayaksa:
             // Special: Full heal + meter drain stops
-            stats.health = stats.maxHealth;
+            m_currentHealth = m_maxHealth;
             vajrayaksaMeterDrainPaused = true;
             // Schedule resume after 10 seconds
             // TODO: Implement timed event system
@@ -266,8 +326,8 @@ void GobTheGoodGoblin::TriggerEmergencyEvolution() {
     EvolveToForm(nextForm);
 
     // Healing burst: +15% HP
-    stats.health += stats.maxHealth * 0.15f;
-    stats.health = std::min(stats.health, stats.maxHealth);
+    m_currentHealth += m_maxHealth * 0.15f;
+    m_currentHealth = std::min(m_currentHealth, m_maxHealth);
 
     // Temporary 30% damage reduction for 3 seconds
     // TODO: Implement buff system
@@ -345,7 +405,7 @@ float GobTheGoodGoblin::GetCurrentSizeMultiplier() const {
 // Combat Overrides
 // ============================================================================
 
-void GobTheGoodGoblin::ExecuteSpecialMove(Direction direction) {
+void GobTheGoodGoblin::ExecuteSpecialMove(InputDirection direction) {
     if (!CanUseSpecialMoves()) {
         return;
     }
@@ -418,17 +478,17 @@ bool GobTheGoodGoblin::CanUseSpecialMoves() const {
 // GOBLIN FORM ABILITIES (0-24%)
 // ============================================================================
 
-void GobTheGoodGoblin::GoblinAbilities(Direction direction) {
+void GobTheGoodGoblin::GoblinAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Panic Jump: Quick vertical escape, invincible frames
             // TODO: Implement
             break;
-        case Direction::Left:
+        case InputDirection::Left:
             // Survival Bite: Counter stance → bite heal 30 HP
             // TODO: Implement
             break;
-        case Direction::Right:
+        case InputDirection::Right:
             // Goblin Rush: Fast roll through enemies, steals 5% meter
             GenerateEvolutionEnergy(5.0f);
             // TODO: Implement roll mechanics
@@ -447,7 +507,7 @@ void GobTheGoodGoblin::GoblinGearSkills(int index) {
     switch (index) {
         case 0: // SD - Desperate Bite
             // Heals 30 HP + 7% meter
-            stats.health = std::min(stats.health + 30.0f, stats.maxHealth);
+            m_currentHealth = std::min(m_currentHealth + 30.0f, m_maxHealth);
             GenerateEvolutionEnergy(7.0f);
             // TODO: Implement bite attack
             break;
@@ -471,17 +531,17 @@ void GobTheGoodGoblin::GoblinGearSkills(int index) {
 // HOBGOBLIN FORM ABILITIES (25-49%)
 // ============================================================================
 
-void GobTheGoodGoblin::HobgoblinAbilities(Direction direction) {
+void GobTheGoodGoblin::HobgoblinAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Shadow Upper: Rising uppercut → air combo starter
             // TODO: Implement
             break;
-        case Direction::Left:
+        case InputDirection::Left:
             // Dark Counter: Counter stance → shadow explosion
             // TODO: Implement
             break;
-        case Direction::Right:
+        case InputDirection::Right:
             // Phantom Strike: Teleport behind enemy → backstab
             // TODO: Implement
             break;
@@ -523,17 +583,17 @@ void GobTheGoodGoblin::HobgoblinGearSkills(int index) {
 // OGRE FORM ABILITIES (50-74%)
 // ============================================================================
 
-void GobTheGoodGoblin::OgreAbilities(Direction direction) {
+void GobTheGoodGoblin::OgreAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Ogre Slam: Jump → crash with shockwave, breaks guard
             // TODO: Implement
             break;
-        case Direction::Left:
+        case InputDirection::Left:
             // Ground Quake: Stomp creating earth spikes forward
             // TODO: Implement
             break;
-        case Direction::Right:
+        case InputDirection::Right:
             // Brutal Charge: Armored rush grabbing first enemy
             // TODO: Implement
             break;
@@ -575,17 +635,17 @@ void GobTheGoodGoblin::OgreGearSkills(int index) {
 // APOSTLE LORD FORM ABILITIES (75-99%)
 // ============================================================================
 
-void GobTheGoodGoblin::ApostleLordAbilities(Direction direction) {
+void GobTheGoodGoblin::ApostleLordAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Demon Ascension: Fly up → rain 5 demon orbs
             // TODO: Implement
             break;
-        case Direction::Left:
+        case InputDirection::Left:
             // Lord's Territory: Create demon field buffing allies
             // TODO: Implement
             break;
-        case Direction::Right:
+        case InputDirection::Right:
             // Orb Barrage: Fire 3 homing demon orbs
             // TODO: Implement
             break;
@@ -627,17 +687,17 @@ void GobTheGoodGoblin::ApostleLordGearSkills(int index) {
 // VAJRAYAKSA OVERLORD FORM ABILITIES (100%)
 // ============================================================================
 
-void GobTheGoodGoblin::VajrayaksaAbilities(Direction direction) {
+void GobTheGoodGoblin::VajrayaksaAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Heaven Splitter: All 4 arms create energy pillar
             // TODO: Implement
             break;
-        case Direction::Left:
+        case InputDirection::Left:
             // Overlord's Decree: AOE fear + reset ally cooldowns
             // TODO: Implement
             break;
-        case Direction::Right:
+        case InputDirection::Right:
             // Thousand Arms Rush: Teleport → 20-hit barrage
             // TODO: Implement
             break;
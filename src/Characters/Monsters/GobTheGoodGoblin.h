@@ -57,6 +57,10 @@ public:
     // Core Update
     void Update(float deltaTime) override;
 
+    // Rollback snapshots
+    void SaveState(CharacterSnapshot& snapshot) const override;
+    bool LoadState(const CharacterSnapshot& snapshot) override;
+
     // Evolution Gauge Management
     EvolutionGauge evolutionGauge;
     void GenerateEvolutionEnergy(float amount);
@@ -97,34 +101,34 @@ public:
     bool vajrayaksaMeterDrainPaused = false;  // Vajrayaksa: Emergency drain pause
 
     // Combat Overrides
-    void ExecuteSpecialMove(Direction direction) override;
+    void ExecuteSpecialMove(InputDirection direction) override;
     void ExecuteGearSkill(int index) override;
     void Block() override;
     bool CanUseSpecialMoves() const override;
 
     // Form-Specific Abilities
     // Goblin Form (0-24%)
-    void GoblinAbilities(Direction direction);
+    void GoblinAbilities(InputDirection direction);
     void GoblinGearSkills(int index);
     void GoblinBlock();
 
     // Hobgoblin Form (25-49%)
-    void HobgoblinAbilities(Direction direction);
+    void HobgoblinAbilities(InputDirection direction);
     void HobgoblinGearSkills(int index);
     void HobgoblinBlock();
 
     // Ogre Form (50-74%)
-    void OgreAbilities(Direction direction);
+    void OgreAbilities(InputDirection direction);
     void OgreGearSkills(int index);
     void OgreBlock();
 
     // Apostle Lord Form (75-99%)
-    void ApostleLordAbilities(Direction direction);
+    void ApostleLordAbilities(InputDirection direction);
     void ApostleLordGearSkills(int index);
     void ApostleLordBlock();
 
     // Vajrayaksa Overlord Form (100%)
-    void VajrayaksaAbilities(Direction direction);
+    void VajrayaksaAbilities(InputDirection direction);
     void VajrayaksaGearSkills(int index);
     void VajrayaksaBlock();
 
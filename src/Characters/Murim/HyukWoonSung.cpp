@@ -18,8 +18,16 @@ HyukWoonSung::HyukWoonSung()
     // Set primary element based on stance
     m_element = ElementType::Neutral; // Changes with stance
     
-    // Initialize special moves (S+Direction inputs)
-    InitializeSpecialMoves();
+    // Build both stances' gear skills and S+Direction special moves up
+    // front, Dark first so it ends up parked
+    SetupDarkStanceSkills();
+    InitializeSpecialMoves(StanceType::Dark);
+    m_otherStanceSkills.gearSkills.swap(m_gearSkills);
+    m_otherStanceSkills.specialMoves.swap(m_specialMoves);
+    
+    SetupLightStanceSkills();
+    InitializeSpecialMoves(StanceType::Light);
+    m_skillStance = StanceType::Light;
 }
 
 void HyukWoonSung::Initialize() {
@@ -29,15 +37,20 @@ void HyukWoonSung::Initialize() {
     m_stanceSystem->SetOnStanceChange([this](StanceType oldStance, StanceType newStance) {
         UpdateStanceEffects();
         ApplyStanceModifiers();
-        // Update special moves when stance changes
-        InitializeSpecialMoves();
+        UseStanceSkills(newStance);
     });
     
-    // Setup initial skills based on Light stance
-    SetupLightStanceSkills();
+    UseStanceSkills(m_stanceSystem->GetCurrentStance());
+}
+
+void HyukWoonSung::UseStanceSkills(StanceType stance) {
+    if (stance == m_skillStance) {
+        return;
+    }
     
-    // Initialize special moves for current stance
-    InitializeSpecialMoves();
+    m_gearSkills.swap(m_otherStanceSkills.gearSkills);
+    m_specialMoves.swap(m_otherStanceSkills.specialMoves);
+    m_skillStance = stance;
 }
 
 void HyukWoonSung::SetupLightStanceSkills() {
@@ -263,6 +276,47 @@ void HyukWoonSung::Update(float deltaTime) {
     UpdateAuraVisuals();
 }
 
+namespace {
+
+struct HyukState {
+    StanceSystem::State stance;
+    float comboMultiplier;
+    bool isInUltimate;
+    float ultimateTimer;
+};
+
+} // namespace
+
+void HyukWoonSung::SaveState(CharacterSnapshot& snapshot) const {
+    CharacterBase::SaveState(snapshot);
+    
+    HyukState state;
+    std::memset(&state, 0, sizeof(state));
+    state.stance = m_stanceSystem->GetState();
+    state.comboMultiplier = m_comboMultiplier;
+    state.isInUltimate = m_isInUltimate;
+    state.ultimateTimer = m_ultimateTimer;
+    
+    WriteCharacterData(snapshot, state);
+}
+
+bool HyukWoonSung::LoadState(const CharacterSnapshot& snapshot) {
+    HyukState state = {};
+    if (!CharacterBase::LoadState(snapshot) || !ReadCharacterData(snapshot, state)) {
+        return false;
+    }
+    
+    // Only the stance comes back; both skill tables already exist
+    m_stanceSystem->SetState(state.stance);
+    UseStanceSkills(state.stance.stance);
+    
+    m_comboMultiplier = state.comboMultiplier;
+    m_isInUltimate = state.isInUltimate;
+    m_ultimateTimer = state.ultimateTimer;
+    
+    return true;
+}
+
 void HyukWoonSung::OnGearSwitch(int oldGear, int newGear) {
     // Play gear switch effect based on stance
     if (m_stanceSystem->GetCurrentStance() == StanceType::Light) {
@@ -289,11 +343,10 @@ void HyukWoonSung::SwitchStance(int stanceIndex) {
     PlayStanceEffect(m_stanceSystem->GetSwitchEffect());
     
     // Update skills based on new stance
+    UseStanceSkills(m_stanceSystem->GetCurrentStance());
     if (m_stanceSystem->GetCurrentStance() == StanceType::Light) {
-        SetupLightStanceSkills();
         m_element = ElementType::Light;
     } else {
-        SetupDarkStanceSkills();
         m_element = ElementType::Dark;
     }
 }
@@ -447,11 +500,11 @@ void HyukWoonSung::UpdateAuraVisuals() {
     // Apply aura visual
 }
 
-void HyukWoonSung::InitializeSpecialMoves() {
+void HyukWoonSung::InitializeSpecialMoves(StanceType stance) {
     // Clear existing special moves
     m_specialMoves.clear();
     
-    if (m_stanceSystem->GetCurrentStance() == StanceType::Light) {
+    if (stance == StanceType::Light) {
         // Light Stance special moves
         RegisterSpecialMove(InputDirection::Up, {
             "Spear Sea Impact",
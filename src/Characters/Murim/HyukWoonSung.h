@@ -2,7 +2,9 @@
 
 #include "../CharacterBase.h"
 #include "StanceSystem.h"
+#include <array>
 #include <memory>
+#include <unordered_map>
 
 namespace ArenaFighter {
 
@@ -27,6 +29,10 @@ public:
     void OnSkillUse(int skillIndex) override;
     void OnSpecialMoveExecute(InputDirection direction) override;
     
+    // Rollback snapshots
+    void SaveState(CharacterSnapshot& snapshot) const override;
+    bool LoadState(const CharacterSnapshot& snapshot) override;
+    
     // Stance system
     bool HasStanceSystem() const override { return true; }
     void SwitchStance(int stanceIndex) override;
@@ -65,6 +71,10 @@ private:
     static constexpr float MIND_SPLIT_DOUBLE_WILL_MANA = 35.0f;     // Dark S+←
     static constexpr float DEMON_GOD_STOMP_MANA = 40.0f;            // Dark S+↓
     static constexpr float ULTIMATE_MANA = 70.0f;
+
+    // Deprecated direct specials
+    static constexpr float DEMON_PALM_MANA = 25.0f;
+    static constexpr float RED_SOUL_MANA = 30.0f;
     
     // Special move damage values
     static constexpr float SPEAR_SEA_DAMAGE = 150.0f;
@@ -76,16 +86,29 @@ private:
     static constexpr float MIND_SPLIT_DOUBLE_WILL_DAMAGE = 200.0f;
     static constexpr float DEMON_GOD_STOMP_DAMAGE = 190.0f;
     static constexpr float ULTIMATE_DAMAGE = 350.0f;
+    static constexpr float DEMON_PALM_DAMAGE = 140.0f;
     
     // Character-specific properties
     float m_comboMultiplier = 1.0f;
     bool m_isInUltimate = false;
     float m_ultimateTimer = 0.0f;
     
+    // Skill tables of the stance not in use, built once with the active
+    // ones. Switching stance, or rolling back across a switch, swaps them
+    // with the base class tables, which moves strings and map nodes
+    // around without allocating.
+    struct StanceSkills {
+        std::array<GearSkill, 8> gearSkills;
+        std::unordered_map<InputDirection, SpecialMove> specialMoves;
+    };
+    StanceSkills m_otherStanceSkills;
+    StanceType m_skillStance = StanceType::Light;  // Stance the base tables hold
+    void UseStanceSkills(StanceType stance);
+    
     // Helper methods
     void SetupLightStanceSkills();
     void SetupDarkStanceSkills();
-    void InitializeSpecialMoves();  // Setup S+Direction special moves
+    void InitializeSpecialMoves(StanceType stance);  // Setup S+Direction special moves
     void UpdateStanceEffects();
     void ApplyStanceModifiers();
     
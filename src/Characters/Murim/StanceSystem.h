@@ -48,6 +48,20 @@ public:
     // Update system
     void Update(float deltaTime);
     
+    // Plain snapshot for rollback; restoring does not fire the stance callback
+    struct State {
+        StanceType stance;
+        float temperedGauge;
+        float switchCooldown;
+    };
+    
+    State GetState() const { return { m_currentStance, m_temperedGauge, m_switchCooldown }; }
+    void SetState(const State& state) {
+        m_currentStance = state.stance;
+        m_temperedGauge = state.temperedGauge;
+        m_switchCooldown = state.switchCooldown;
+    }
+    
     // Callbacks for stance changes
     void SetOnStanceChange(std::function<void(StanceType, StanceType)> callback) {
         m_onStanceChange = callback;
@@ -58,9 +72,7 @@ private:
     float m_temperedGauge = 0.0f;  // 0-100
     float m_switchCooldown = 0.0f; // Brief cooldown after switching
     
-    // Gauge gain rates
-    static constexpr float GAUGE_PER_HIT = 2.0f;
-    static constexpr float GAUGE_PER_COMBO = 5.0f;
+    // Gauge decay
     static constexpr float GAUGE_DECAY_RATE = 1.0f; // Per second
     static constexpr float MAX_GAUGE = 100.0f;
     
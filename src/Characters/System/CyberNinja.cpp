@@ -3,16 +3,12 @@
 
 namespace ArenaFighter {
 
-// Auto-register with factory
-REGISTER_CHARACTER(103, "Cyber Ninja", CharacterCategory::System,
-    "Stealth assassin with advanced cloaking and hacking abilities", CyberNinja)
-
 CyberNinja::CyberNinja() 
     : CharacterBase("Cyber Ninja", CharacterCategory::System, StatMode::Hybrid)
     , m_isStealthed(false)
     , m_stealthDuration(0.0f)
     , m_hackProgress(0.0f)
-    , m_hackTarget(nullptr)
+    , m_hackTargetId(-1)
     , m_digitalParticleTimer(0.0f)
     , m_cloakingActive(false) {
     
@@ -29,7 +25,7 @@ void CyberNinja::Initialize() {
     m_isStealthed = false;
     m_stealthDuration = 0.0f;
     m_hackProgress = 0.0f;
-    m_hackTarget = nullptr;
+    m_hackTargetId = -1;
 }
 
 void CyberNinja::InitializeGearSkills() {
@@ -39,6 +35,7 @@ void CyberNinja::InitializeGearSkills() {
         "cyber_cloak",           // animation
         25.0f,                   // mana cost
         0.0f,                    // no damage (utility)
+        2.0f,                    // cooldown
         AttackType::Special,
         8,                       // startup frames
         1,                       // active frames
@@ -53,6 +50,7 @@ void CyberNinja::InitializeGearSkills() {
         "shadow_strike",
         40.0f,                   // mana cost
         180.0f,                  // high damage from stealth
+        2.5f,                    // cooldown
         AttackType::Heavy,
         5,                       // fast startup
         3,                       // active
@@ -68,6 +66,7 @@ void CyberNinja::InitializeGearSkills() {
         "system_breach",
         35.0f,                   // mana cost
         50.0f,                   // damage over time
+        3.0f,                    // cooldown
         AttackType::Special,
         15,                      // longer startup
         20,                      // channel duration
@@ -82,6 +81,7 @@ void CyberNinja::InitializeGearSkills() {
         "emp_pulse",
         30.0f,                   // mana cost
         120.0f,                  // area damage
+        3.5f,                    // cooldown
         AttackType::Medium,
         10,                      // startup
         5,                       // active
@@ -97,6 +97,7 @@ void CyberNinja::InitializeGearSkills() {
         "quantum_dash",
         20.0f,                   // mana cost
         80.0f,                   // damage
+        4.0f,                    // cooldown
         AttackType::Light,
         3,                       // very fast
         2,                       // active
@@ -111,6 +112,7 @@ void CyberNinja::InitializeGearSkills() {
         "blade_cyclone",
         45.0f,                   // mana cost
         150.0f,                  // spinning attack
+        4.5f,                    // cooldown
         AttackType::Medium,
         12,                      // startup
         8,                       // active (multi-hit)
@@ -126,6 +128,7 @@ void CyberNinja::InitializeGearSkills() {
         "nano_shuriken",
         15.0f,                   // low mana cost
         60.0f,                   // damage per shuriken
+        5.0f,                    // cooldown
         AttackType::Light,
         6,                       // startup
         2,                       // active
@@ -140,6 +143,7 @@ void CyberNinja::InitializeGearSkills() {
         "hologram_trap",
         50.0f,                   // high mana cost
         200.0f,                  // explosion damage
+        5.5f,                    // cooldown
         AttackType::Special,
         18,                      // setup time
         1,                       // active
@@ -162,11 +166,11 @@ void CyberNinja::Update(float deltaTime) {
     }
     
     // Update hack progress
-    if (m_hackTarget) {
+    if (IsHacking()) {
         m_hackProgress += deltaTime * 0.25f; // 4 seconds to complete
         if (m_hackProgress >= 1.0f) {
             // Hack complete - apply debuff
-            m_hackTarget = nullptr;
+            m_hackTargetId = -1;
             m_hackProgress = 0.0f;
         }
     }
@@ -175,6 +179,47 @@ void CyberNinja::Update(float deltaTime) {
     m_digitalParticleTimer += deltaTime;
 }
 
+namespace {
+
+struct CyberNinjaState {
+    bool isStealthed;
+    float stealthDuration;
+    float hackProgress;
+    int32_t hackTargetId;
+};
+
+} // namespace
+
+void CyberNinja::SaveState(CharacterSnapshot& snapshot) const {
+    CharacterBase::SaveState(snapshot);
+    
+    CyberNinjaState state;
+    std::memset(&state, 0, sizeof(state));
+    state.isStealthed = m_isStealthed;
+    state.stealthDuration = m_stealthDuration;
+    state.hackProgress = m_hackProgress;
+    state.hackTargetId = m_hackTargetId;
+    
+    WriteCharacterData(snapshot, state);
+}
+
+bool CyberNinja::LoadState(const CharacterSnapshot& snapshot) {
+    CyberNinjaState state = {};
+    if (!CharacterBase::LoadState(snapshot) || !ReadCharacterData(snapshot, state)) {
+        return false;
+    }
+    
+    m_isStealthed = state.isStealthed;
+    m_stealthDuration = state.stealthDuration;
+    m_hackProgress = state.hackProgress;
+    m_hackTargetId = state.hackTargetId;
+    
+    // Visual timers are left running; only the cloak follows stealth
+    m_cloakingActive = m_isStealthed;
+    
+    return true;
+}
+
 void CyberNinja::OnGearSwitch(int oldGear, int newGear) {
     // Exit stealth when switching from stealth gear
     if (oldGear == 0 && m_isStealthed) {
@@ -182,8 +227,8 @@ void CyberNinja::OnGearSwitch(int oldGear, int newGear) {
     }
     
     // Cancel hack when switching from hacking gear
-    if (oldGear == 1 && m_hackTarget) {
-        m_hackTarget = nullptr;
+    if (oldGear == 1 && IsHacking()) {
+        m_hackTargetId = -1;
         m_hackProgress = 0.0f;
     }
 }
@@ -218,8 +263,8 @@ void CyberNinja::ExitStealthMode() {
 }
 
 void CyberNinja::InitiateHack(CharacterBase* target) {
-    if (target && !m_hackTarget && CanAffordSkill(m_gearSkills[2].manaCost)) {
-        m_hackTarget = target;
+    if (target && !IsHacking() && CanAffordSkill(m_gearSkills[2].manaCost)) {
+        m_hackTargetId = target->GetId();
         m_hackProgress = 0.0f;
         ConsumeMana(m_gearSkills[2].manaCost);
     }
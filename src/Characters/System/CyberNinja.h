@@ -22,14 +22,20 @@ public:
     void OnGearSwitch(int oldGear, int newGear) override;
     void OnSkillUse(int skillIndex) override;
     
+    // Rollback snapshots
+    void SaveState(CharacterSnapshot& snapshot) const override;
+    bool LoadState(const CharacterSnapshot& snapshot) override;
+    
     // Cyber Ninja specific abilities
     void EnterStealthMode();
     void ExitStealthMode();
     bool IsStealthed() const { return m_isStealthed; }
     
-    // Hacking abilities
+    // Hacking abilities. The target is kept by id, like every other
+    // reference to a character in snapshot state; -1 when not hacking.
     void InitiateHack(CharacterBase* target);
-    bool IsHacking() const { return m_hackTarget != nullptr; }
+    bool IsHacking() const { return m_hackTargetId >= 0; }
+    int GetHackTargetId() const { return m_hackTargetId; }
     
 private:
     // Initialize gear skills
@@ -39,7 +45,7 @@ private:
     bool m_isStealthed;
     float m_stealthDuration;
     float m_hackProgress;
-    CharacterBase* m_hackTarget;
+    int m_hackTargetId;
     
     // Visual effects
     float m_digitalParticleTimer;
@@ -1,7 +1,9 @@
 #include "Yuito.h"
 #include "../../Combat/DamageCalculator.h"
+#include "../../Physics/Collider.h"
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 
 namespace ArenaFighter {
 
@@ -50,25 +52,70 @@ void Pet::MarkUsedForFusion() {
     hasBeenUsedForFusion = true;
 }
 
+void Pet::SaveState(PetSnapshot& snapshot) const {
+    std::memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.type = type;
+    snapshot.tier = tier;
+    snapshot.health = health;
+    snapshot.maxHealth = maxHealth;
+    std::copy(std::begin(damage), std::end(damage), snapshot.damage);
+    snapshot.x = x;
+    snapshot.y = y;
+    snapshot.z = z;
+    snapshot.speedMultiplier = speedMultiplier;
+    snapshot.canFuse = canFuse;
+    snapshot.isAlive = isAlive;
+    snapshot.hasBeenUsedForFusion = hasBeenUsedForFusion;
+
+    SaveAIState(snapshot);
+}
+
+void Pet::LoadState(const PetSnapshot& snapshot) {
+    tier = snapshot.tier;   // Emergency protocol upgrades in place
+    health = snapshot.health;
+    maxHealth = snapshot.maxHealth;
+    std::copy(std::begin(snapshot.damage), std::end(snapshot.damage), damage);
+    x = snapshot.x;
+    y = snapshot.y;
+    z = snapshot.z;
+    speedMultiplier = snapshot.speedMultiplier;
+    canFuse = snapshot.canFuse;
+    isAlive = snapshot.isAlive;
+    hasBeenUsedForFusion = snapshot.hasBeenUsedForFusion;
+
+    LoadAIState(snapshot);
+}
+
 // ============================================================================
 // Yuito Constructor
 // ============================================================================
 
-Yuito::Yuito() {
+Yuito::Yuito()
+    : CharacterBase("Yuito", CharacterCategory::System, StatMode::Hybrid) {
     InitializeYuitoStats();
     SetupBaseGearSkills();
+
+    // Pets are created once, here; rollback restores reuse them
+    activePets.reserve(MAX_PETS);
+    for (PetType type : { PetType::Undead, PetType::Dragon, PetType::Beast, PetType::Mythic }) {
+        for (PetTier tier : { PetTier::Tier1, PetTier::Tier2, PetTier::Tier3 }) {
+            size_t first = FirstPoolSlot(type, tier);
+            for (size_t i = 0; i < MAX_PETS; ++i) {
+                petPool[first + i] = Pet::Create(type, tier);
+            }
+        }
+    }
 }
 
 void Yuito::InitializeYuitoStats() {
     // Yuito has the WORST stats in the game (base form)
-    stats.maxHealth = 210.0f;  // Lowest
-    stats.health = 210.0f;
-    stats.attack = 5.0f;        // Weakest
-    stats.defense = 60.0f;      // Paper thin
-    stats.speed = 95.0f;        // Below average
-    stats.maxMana = 100.0f;
-    stats.mana = 100.0f;
-    stats.manaRegen = 5.0f;
+    m_maxHealth = 210.0f;  // Lowest
+    m_currentHealth = 210.0f;
+    m_powerModifier = 0.05f;        // Weakest
+    m_defense = 60.0f;      // Paper thin
+    m_speed = 95.0f;        // Below average
+    m_maxMana = 100.0f;
+    m_currentMana = 100.0f;
 
     // Contract mana starts at 0
     contractMana.current = 0.0f;
@@ -109,6 +156,105 @@ void Yuito::Update(float deltaTime) {
     }
 }
 
+// ============================================================================
+// Rollback Snapshots
+// ============================================================================
+
+namespace {
+
+struct YuitoState {
+    ContractMana contractMana;
+    FusionForm currentFusion;
+    float fusionTimeRemaining;
+    bool emergencyProtocolUsed;
+    uint32_t petCount;
+    PetSnapshot pets[Yuito::MAX_PETS];
+};
+
+} // namespace
+
+void Yuito::SaveState(CharacterSnapshot& snapshot) const {
+    CharacterBase::SaveState(snapshot);
+
+    YuitoState state;
+    std::memset(&state, 0, sizeof(state));
+    state.contractMana = contractMana;
+    state.currentFusion = currentFusion;
+    state.fusionTimeRemaining = fusionTimeRemaining;
+    state.emergencyProtocolUsed = emergencyProtocolUsed;
+    state.petCount = 0;
+
+    for (const auto& pet : activePets) {
+        if (pet && state.petCount < MAX_PETS) {
+            pet->SaveState(state.pets[state.petCount++]);
+        }
+    }
+
+    WriteCharacterData(snapshot, state);
+}
+
+bool Yuito::LoadState(const CharacterSnapshot& snapshot) {
+    YuitoState state = {};
+    if (!CharacterBase::LoadState(snapshot) || !ReadCharacterData(snapshot, state)) {
+        return false;
+    }
+
+    contractMana = state.contractMana;
+    currentFusion = state.currentFusion;
+    fusionTimeRemaining = state.fusionTimeRemaining;
+    emergencyProtocolUsed = state.emergencyProtocolUsed;
+
+    // Slots that still hold a pool pet of the saved kind keep it; the rest
+    // are cleared first, then filled from the pool. activePets never
+    // grows past its reserved MAX_PETS, so nothing is allocated.
+    activePets.resize(state.petCount);
+    for (uint32_t i = 0; i < state.petCount; ++i) {
+        if (!IsPoolPet(activePets[i].get(), state.pets[i].type, state.pets[i].tier)) {
+            activePets[i].reset();
+        }
+    }
+    for (uint32_t i = 0; i < state.petCount; ++i) {
+        const PetSnapshot& petState = state.pets[i];
+        auto& pet = activePets[i];
+
+        if (!pet) {
+            pet = FindFreePoolPet(petState.type, petState.tier);
+        }
+        if (pet) {
+            pet->LoadState(petState);
+        }
+    }
+
+    return true;
+}
+
+size_t Yuito::FirstPoolSlot(PetType type, PetTier tier) {
+    size_t kind = static_cast<size_t>(type) * 3 + (static_cast<size_t>(tier) - 1);
+    return kind * MAX_PETS;
+}
+
+bool Yuito::IsPoolPet(const Pet* pet, PetType type, PetTier tier) const {
+    if (!pet) return false;
+
+    size_t first = FirstPoolSlot(type, tier);
+    for (size_t i = 0; i < MAX_PETS; ++i) {
+        if (petPool[first + i].get() == pet) return true;
+    }
+    return false;
+}
+
+std::shared_ptr<Pet> Yuito::FindFreePoolPet(PetType type, PetTier tier) const {
+    // At most MAX_PETS - 1 other slots are filled, so one is always free
+    size_t first = FirstPoolSlot(type, tier);
+    for (size_t i = 0; i < MAX_PETS; ++i) {
+        const auto& candidate = petPool[first + i];
+        if (std::find(activePets.begin(), activePets.end(), candidate) == activePets.end()) {
+            return candidate;
+        }
+    }
+    return nullptr;
+}
+
 // ============================================================================
 // Contract Mana Generation
 // ============================================================================
@@ -146,8 +292,8 @@ void Yuito::SummonPet(PetType type, PetTier tier) {
         case PetTier::Tier3: cost = 60.0f; break;
     }
 
-    if (!contractMana.CanAfford(cost)) {
-        return;  // Not enough mana
+    if (!contractMana.CanAfford(cost) || activePets.size() >= MAX_PETS) {
+        return;  // Not enough mana, or every pet slot is taken
     }
 
     contractMana.Consume(cost);
@@ -270,7 +416,7 @@ void Yuito::UpdateFusion(float deltaTime) {
 // ============================================================================
 
 void Yuito::CheckEmergencyProtocol() {
-    float healthPercent = stats.health / stats.maxHealth;
+    float healthPercent = m_currentHealth / m_maxHealth;
 
     if (healthPercent <= 0.30f && !emergencyProtocolUsed) {
         TriggerEmergencyProtocol();
@@ -299,12 +445,14 @@ std::shared_ptr<Pet> Yuito::FindNearestFusablePet() {
     std::shared_ptr<Pet> nearest = nullptr;
     float minDistance = std::numeric_limits<float>::max();
 
+    const DirectX::XMFLOAT3& position = GetRigidBody()->position;
+
     for (auto& pet : activePets) {
         if (pet && pet->CanBeFused()) {
             // Calculate distance
-            float dx = pet->x - x;
-            float dy = pet->y - y;
-            float dz = pet->z - z;
+            float dx = pet->x - position.x;
+            float dy = pet->y - position.y;
+            float dz = pet->z - position.z;
             float distance = std::sqrt(dx*dx + dy*dy + dz*dz);
 
             if (distance < minDistance) {
@@ -334,7 +482,7 @@ void Yuito::UpgradePetTier(std::shared_ptr<Pet> pet) {
 // Combat Overrides
 // ============================================================================
 
-void Yuito::ExecuteSpecialMove(Direction direction) {
+void Yuito::ExecuteSpecialMove(InputDirection direction) {
     // Base Yuito has NO special moves
     if (!CanUseSpecialMoves()) {
         return;  // Cannot use special moves without fusion
@@ -473,17 +621,17 @@ void Yuito::BaseFormAttack() {
 // ============================================================================
 
 // Skeleton Warrior (Little Skeleton Fusion)
-void Yuito::SkeletonWarriorAbilities(Direction direction) {
+void Yuito::SkeletonWarriorAbilities(InputDirection direction) {
     switch (direction) {
-        case Direction::Up:
+        case InputDirection::Up:
             // Rising Bones (12 damage uppercut, launches enemy)
             // TODO: Implement
             break;
-        case Direction::Left:
+        case InputDirection::Left:
             // Bone Spear (13 damage piercing projectile)
             // TODO: Implement
             break;
-        case Direction::Right:
+        case InputDirection::Right:
             // Bone Rush (multi-hit charge, 3x5 damage)
             // TODO: Implement
             break;
@@ -506,31 +654,31 @@ void Yuito::SkeletonWarriorGearSkills(int index) {
 // Additional fusion forms will be implemented similarly
 // For brevity, adding stubs for now
 
-void Yuito::UndeadOverlordAbilities(Direction direction) { /* TODO */ }
+void Yuito::UndeadOverlordAbilities(InputDirection direction) { /* TODO */ }
 void Yuito::UndeadOverlordBlock() { CharacterBase::Block(); }
 void Yuito::UndeadOverlordGearSkills(int index) { /* TODO */ }
 
-void Yuito::DragonKnightAbilities(Direction direction) { /* TODO */ }
+void Yuito::DragonKnightAbilities(InputDirection direction) { /* TODO */ }
 void Yuito::DragonKnightBlock() { CharacterBase::Block(); }
 void Yuito::DragonKnightGearSkills(int index) { /* TODO */ }
 
-void Yuito::ChaosDragonGodAbilities(Direction direction) { /* TODO */ }
+void Yuito::ChaosDragonGodAbilities(InputDirection direction) { /* TODO */ }
 void Yuito::ChaosDragonGodBlock() { CharacterBase::Block(); }
 void Yuito::ChaosDragonGodGearSkills(int index) { /* TODO */ }
 
-void Yuito::StormBeastAbilities(Direction direction) { /* TODO */ }
+void Yuito::StormBeastAbilities(InputDirection direction) { /* TODO */ }
 void Yuito::StormBeastBlock() { CharacterBase::Block(); }
 void Yuito::StormBeastGearSkills(int index) { /* TODO */ }
 
-void Yuito::VoidWalkerAbilities(Direction direction) { /* TODO */ }
+void Yuito::VoidWalkerAbilities(InputDirection direction) { /* TODO */ }
 void Yuito::VoidWalkerBlock() { CharacterBase::Block(); }
 void Yuito::VoidWalkerGearSkills(int index) { /* TODO */ }
 
-void Yuito::PhoenixAvatarAbilities(Direction direction) { /* TODO */ }
+void Yuito::PhoenixAvatarAbilities(InputDirection direction) { /* TODO */ }
 void Yuito::PhoenixAvatarBlock() { CharacterBase::Block(); }
 void Yuito::PhoenixAvatarGearSkills(int index) { /* TODO */ }
 
-void Yuito::TitanDestroyerAbilities(Direction direction) { /* TODO */ }
+void Yuito::TitanDestroyerAbilities(InputDirection direction) { /* TODO */ }
 void Yuito::TitanDestroyerBlock() { CharacterBase::Block(); }
 void Yuito::TitanDestroyerGearSkills(int index) { /* TODO */ }
 
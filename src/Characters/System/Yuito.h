@@ -2,6 +2,7 @@
 
 #include "../CharacterBase.h"
 #include "../../Combat/CombatEnums.h"
+#include <array>
 #include <vector>
 #include <memory>
 
@@ -58,6 +59,24 @@ enum class FusionForm {
     TitanDestroyer      // Chaos Titan fusion
 };
 
+// Rollback image of one pet. Each pet type packs its private AI state
+// into the generic ai* fields.
+struct PetSnapshot {
+    PetType type;
+    PetTier tier;
+    float health;
+    float maxHealth;
+    float damage[4];
+    float x, y, z;
+    float speedMultiplier;
+    bool canFuse;
+    bool isAlive;
+    bool hasBeenUsedForFusion;
+    bool aiFlags[2];
+    float aiTimers[3];
+    int32_t aiCounter;
+};
+
 // Pet Base Class (AI-controlled)
 class Pet {
 public:
@@ -88,6 +107,15 @@ public:
     // Check if can be fused
     bool CanBeFused() const;
     void MarkUsedForFusion();
+
+    // Rollback support
+    void SaveState(PetSnapshot& snapshot) const;
+    void LoadState(const PetSnapshot& snapshot);
+    static std::shared_ptr<Pet> Create(PetType type, PetTier tier);
+
+protected:
+    virtual void SaveAIState(PetSnapshot& /*snapshot*/) const {}
+    virtual void LoadAIState(const PetSnapshot& /*snapshot*/) {}
 };
 
 // Yuito - AI Pet Master
@@ -97,13 +125,15 @@ public:
     virtual ~Yuito() = default;
 
     // Character info
-    std::string GetName() const override { return "Yuito"; }
-    std::string GetCategory() const override { return "System"; }
-    std::string GetTier() const override { return "A"; }
+    std::string GetTier() const { return "A"; }
 
     // Core update
     void Update(float deltaTime) override;
 
+    // Rollback snapshots (pets included)
+    void SaveState(CharacterSnapshot& snapshot) const override;
+    bool LoadState(const CharacterSnapshot& snapshot) override;
+
     // Contract Mana System
     ContractMana contractMana;
     void GenerateContractMana(float amount);
@@ -113,7 +143,8 @@ public:
     void OnSuccessfulBlock();
 
     // Pet Management
-    std::vector<std::shared_ptr<Pet>> activePets;
+    static constexpr size_t MAX_PETS = 8;
+    std::vector<std::shared_ptr<Pet>> activePets;   // Capacity MAX_PETS, entries from petPool
     void SummonPet(PetType type, PetTier tier);
     void UpdatePets(float deltaTime);
     void RemoveDeadPets();
@@ -136,7 +167,7 @@ public:
     void TriggerEmergencyProtocol();
 
     // Combat overrides
-    void ExecuteSpecialMove(Direction direction) override;
+    void ExecuteSpecialMove(InputDirection direction) override;
     void ExecuteGearSkill(int index) override;
     void Block() override;
 
@@ -145,14 +176,14 @@ public:
     bool CanUseSpecialMoves() const;
 
     // Fusion-specific abilities
-    void SkeletonWarriorAbilities(Direction direction);
-    void UndeadOverlordAbilities(Direction direction);
-    void DragonKnightAbilities(Direction direction);
-    void ChaosDragonGodAbilities(Direction direction);
-    void StormBeastAbilities(Direction direction);
-    void VoidWalkerAbilities(Direction direction);
-    void PhoenixAvatarAbilities(Direction direction);
-    void TitanDestroyerAbilities(Direction direction);
+    void SkeletonWarriorAbilities(InputDirection direction);
+    void UndeadOverlordAbilities(InputDirection direction);
+    void DragonKnightAbilities(InputDirection direction);
+    void ChaosDragonGodAbilities(InputDirection direction);
+    void StormBeastAbilities(InputDirection direction);
+    void VoidWalkerAbilities(InputDirection direction);
+    void PhoenixAvatarAbilities(InputDirection direction);
+    void TitanDestroyerAbilities(InputDirection direction);
 
     // Enhanced gear skills (fusion-specific)
     void SkeletonWarriorGearSkills(int index);
@@ -183,6 +214,14 @@ private:
 
     // Upgrade pet tier (for emergency protocol)
     void UpgradePetTier(std::shared_ptr<Pet> pet);
+
+    // MAX_PETS of every pet type and tier, created with Yuito; LoadState
+    // only hands these out, so restoring a frame never allocates
+    static constexpr size_t PET_KINDS = 12;
+    std::array<std::shared_ptr<Pet>, PET_KINDS * MAX_PETS> petPool;
+    static size_t FirstPoolSlot(PetType type, PetTier tier);
+    bool IsPoolPet(const Pet* pet, PetType type, PetTier tier) const;
+    std::shared_ptr<Pet> FindFreePoolPet(PetType type, PetTier tier) const;
 };
 
 } // namespace ArenaFighter
@@ -1,5 +1,5 @@
 #include "YuitoPets.h"
-#include <cstdlib>
+#include "../../Core/DeterministicRandom.h"
 #include <cmath>
 
 namespace ArenaFighter {
@@ -363,7 +363,7 @@ SpiritWolf::SpiritWolf() : Pet(PetType::Beast, PetTier::Tier1) {
 void SpiritWolf::UpdateAI(float deltaTime) { /* TODO */ }
 void SpiritWolf::Attack() { /* TODO */ }
 void SpiritWolf::OnDeath() { isAlive = false; }
-bool SpiritWolf::TryDodge() { return (rand() % 100) < 25; }
+bool SpiritWolf::TryDodge() { return GetSimulationRandom().NextChance(25); }
 
 // Thunder Tiger
 ThunderTiger::ThunderTiger() : Pet(PetType::Beast, PetTier::Tier2) {
@@ -435,4 +435,158 @@ void ChaosTitan::EarthquakeAttack() { /* TODO */ }
 void ChaosTitan::GrabAndThrow() { /* TODO */ }
 void ChaosTitan::BecomeMoreAggressive() { isEnraged = true; }
 
+// ============================================================================
+// ROLLBACK AI STATE
+// ============================================================================
+
+std::shared_ptr<Pet> Pet::Create(PetType type, PetTier tier) {
+    switch (type) {
+        case PetType::Undead:
+            if (tier == PetTier::Tier1) return std::make_shared<BoneSoldier>();
+            if (tier == PetTier::Tier2) return std::make_shared<LittleSkeleton>();
+            return std::make_shared<SkeletonKing>();
+        case PetType::Dragon:
+            if (tier == PetTier::Tier1) return std::make_shared<FireDrake>();
+            if (tier == PetTier::Tier2) return std::make_shared<InfernoDragon>();
+            return std::make_shared<ChaosDragon>();
+        case PetType::Beast:
+            if (tier == PetTier::Tier1) return std::make_shared<SpiritWolf>();
+            if (tier == PetTier::Tier2) return std::make_shared<ThunderTiger>();
+            return std::make_shared<VoidBeast>();
+        case PetType::Mythic:
+            if (tier == PetTier::Tier1) return std::make_shared<GuardianGolem>();
+            if (tier == PetTier::Tier2) return std::make_shared<Phoenix>();
+            return std::make_shared<ChaosTitan>();
+    }
+    return nullptr;
+}
+
+void BoneSoldier::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = attackTimer;
+}
+void BoneSoldier::LoadAIState(const PetSnapshot& snapshot) {
+    attackTimer = snapshot.aiTimers[0];
+}
+
+void LittleSkeleton::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = dodgeTimer;
+    snapshot.aiTimers[1] = boneThrowTimer;
+    snapshot.aiTimers[2] = attackTimer;
+    snapshot.aiFlags[0] = isProtectingYuito;
+}
+void LittleSkeleton::LoadAIState(const PetSnapshot& snapshot) {
+    dodgeTimer = snapshot.aiTimers[0];
+    boneThrowTimer = snapshot.aiTimers[1];
+    attackTimer = snapshot.aiTimers[2];
+    isProtectingYuito = snapshot.aiFlags[0];
+}
+
+void SkeletonKing::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = summonTimer;
+    snapshot.aiTimers[1] = barrierTimer;
+    snapshot.aiTimers[2] = attackTimer;
+    snapshot.aiFlags[0] = hasResurrected;
+    snapshot.aiFlags[1] = deathAuraActive;
+}
+void SkeletonKing::LoadAIState(const PetSnapshot& snapshot) {
+    summonTimer = snapshot.aiTimers[0];
+    barrierTimer = snapshot.aiTimers[1];
+    attackTimer = snapshot.aiTimers[2];
+    hasResurrected = snapshot.aiFlags[0];
+    deathAuraActive = snapshot.aiFlags[1];
+}
+
+void FireDrake::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = fireballTimer;
+    snapshot.aiTimers[1] = maintainDistance;
+}
+void FireDrake::LoadAIState(const PetSnapshot& snapshot) {
+    fireballTimer = snapshot.aiTimers[0];
+    maintainDistance = snapshot.aiTimers[1];
+}
+
+void InfernoDragon::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = breathTimer;
+    snapshot.aiTimers[1] = diveBombTimer;
+    snapshot.aiFlags[0] = isAirborne;
+}
+void InfernoDragon::LoadAIState(const PetSnapshot& snapshot) {
+    breathTimer = snapshot.aiTimers[0];
+    diveBombTimer = snapshot.aiTimers[1];
+    isAirborne = snapshot.aiFlags[0];
+}
+
+void ChaosDragon::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = teleportTimer;
+    snapshot.aiTimers[1] = riftTimer;
+    snapshot.aiCounter = currentElement;
+}
+void ChaosDragon::LoadAIState(const PetSnapshot& snapshot) {
+    teleportTimer = snapshot.aiTimers[0];
+    riftTimer = snapshot.aiTimers[1];
+    currentElement = snapshot.aiCounter;
+}
+
+void SpiritWolf::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = hitAndRunTimer;
+    snapshot.aiCounter = packCount;
+}
+void SpiritWolf::LoadAIState(const PetSnapshot& snapshot) {
+    hitAndRunTimer = snapshot.aiTimers[0];
+    packCount = snapshot.aiCounter;
+}
+
+void ThunderTiger::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = roarTimer;
+    snapshot.aiTimers[1] = pounceTimer;
+    snapshot.aiCounter = hitCount;
+}
+void ThunderTiger::LoadAIState(const PetSnapshot& snapshot) {
+    roarTimer = snapshot.aiTimers[0];
+    pounceTimer = snapshot.aiTimers[1];
+    hitCount = snapshot.aiCounter;
+}
+
+void VoidBeast::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = voidZoneTimer;
+    snapshot.aiTimers[1] = phaseTimer;
+    snapshot.aiFlags[0] = isGuardingYuito;
+}
+void VoidBeast::LoadAIState(const PetSnapshot& snapshot) {
+    voidZoneTimer = snapshot.aiTimers[0];
+    phaseTimer = snapshot.aiTimers[1];
+    isGuardingYuito = snapshot.aiFlags[0];
+}
+
+void GuardianGolem::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = tauntTimer;
+    snapshot.aiFlags[0] = alwaysProtecting;
+}
+void GuardianGolem::LoadAIState(const PetSnapshot& snapshot) {
+    tauntTimer = snapshot.aiTimers[0];
+    alwaysProtecting = snapshot.aiFlags[0];
+}
+
+void Phoenix::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = healTimer;
+    snapshot.aiTimers[1] = zoneTimer;
+    snapshot.aiFlags[0] = hasResurrected;
+}
+void Phoenix::LoadAIState(const PetSnapshot& snapshot) {
+    healTimer = snapshot.aiTimers[0];
+    zoneTimer = snapshot.aiTimers[1];
+    hasResurrected = snapshot.aiFlags[0];
+}
+
+void ChaosTitan::SaveAIState(PetSnapshot& snapshot) const {
+    snapshot.aiTimers[0] = earthquakeTimer;
+    snapshot.aiTimers[1] = grabTimer;
+    snapshot.aiFlags[0] = isEnraged;
+}
+void ChaosTitan::LoadAIState(const PetSnapshot& snapshot) {
+    earthquakeTimer = snapshot.aiTimers[0];
+    grabTimer = snapshot.aiTimers[1];
+    isEnraged = snapshot.aiFlags[0];
+}
+
 } // namespace ArenaFighter
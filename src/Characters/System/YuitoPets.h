@@ -16,6 +16,10 @@ public:
     void Attack() override;
     void OnDeath() override;  // Explodes for 5 damage
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float attackTimer = 0.0f;
 };
@@ -28,7 +32,12 @@ public:
     void Attack() override;
     void OnDeath() override;
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
+    float attackTimer = 0.0f;
     float dodgeTimer = 0.0f;
     float boneThrowTimer = 0.0f;
     bool isProtectingYuito = false;
@@ -48,7 +57,12 @@ public:
     void ActivateDeathAura();
     bool Resurrect();  // Resurrects once at 30% HP
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
+    float attackTimer = 0.0f;
     float summonTimer = 0.0f;
     float barrierTimer = 0.0f;
     bool hasResurrected = false;
@@ -67,6 +81,10 @@ public:
     void Attack() override;
     void OnDeath() override;
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float fireballTimer = 0.0f;
     float maintainDistance = 100.0f;  // Stay away from enemies
@@ -84,6 +102,10 @@ public:
     void DiveBomb();
     void CreateFireWall();
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float breathTimer = 0.0f;
     float diveBombTimer = 0.0f;
@@ -103,6 +125,10 @@ public:
     void CreateDimensionalRift();
     void OpenEscapePortal();
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float teleportTimer = 0.0f;
     float riftTimer = 0.0f;
@@ -123,6 +149,10 @@ public:
 
     bool TryDodge();  // 25% chance
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float hitAndRunTimer = 0.0f;
     int packCount = 1;  // Gets stronger with more wolves
@@ -140,6 +170,10 @@ public:
     void LightningPounce();
     bool StunOnThirdHit();
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float roarTimer = 0.0f;
     int hitCount = 0;
@@ -158,6 +192,10 @@ public:
     void PhaseYuitoThroughDanger();
     void TeleportThreat();
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float voidZoneTimer = 0.0f;
     float phaseTimer = 0.0f;
@@ -179,6 +217,10 @@ public:
     void TauntEnemies();
     void PositionBetweenYuitoAndDanger();
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float tauntTimer = 0.0f;
     bool alwaysProtecting = true;
@@ -196,6 +238,10 @@ public:
     void CreateHealingZone();
     bool Resurrect();
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float healTimer = 0.0f;
     float zoneTimer = 0.0f;
@@ -214,6 +260,10 @@ public:
     void GrabAndThrow();
     void BecomeMoreAggressive();  // When low HP
 
+protected:
+    void SaveAIState(PetSnapshot& snapshot) const override;
+    void LoadAIState(const PetSnapshot& snapshot) override;
+
 private:
     float earthquakeTimer = 0.0f;
     float grabTimer = 0.0f;
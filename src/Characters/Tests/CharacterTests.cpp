@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include "../CharacterBase.h"
+#include "../CharacterFactory.h"
+#include "../Murim/HyukWoonSung.h"
+#include "../System/CyberNinja.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Counts heap allocations so rollback paths can be checked allocation free
+static std::atomic<size_t> g_allocationCount{0};
+
+// The whole unaligned family is replaced so every form pairs malloc with
+// free; aligned allocations keep the library's own pair. The scalar pair
+// stays out of line, or GCC sees malloc matched with operator delete
+// after inlining and warns
+[[gnu::noinline]] void* operator new(size_t size) {
+    g_allocationCount++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+
+namespace ArenaFighter {
+namespace Tests {
+
+class CharacterSnapshotTest : public ::testing::Test {
+protected:
+    std::vector<std::unique_ptr<CharacterBase>> roster;
+
+    void SetUp() override {
+        CharacterFactory& factory = CharacterFactory::GetInstance();
+        factory.InitializeDefaultCharacters();
+
+        for (const auto& info : factory.GetCharacterRoster()) {
+            auto character = factory.CreateCharacter(info.id);
+            if (character) {
+                roster.push_back(std::move(character));
+            }
+        }
+    }
+
+    void TearDown() override {
+        roster.clear();
+    }
+};
+
+TEST_F(CharacterSnapshotTest, RosterListsEachCharacterOnce) {
+    // SetUp initializes the factory singleton for every test
+    CharacterFactory::GetInstance().InitializeDefaultCharacters();
+
+    std::vector<int> ids;
+    for (const auto& info : CharacterFactory::GetInstance().GetCharacterRoster()) {
+        ids.push_back(info.id);
+    }
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(std::adjacent_find(ids.begin(), ids.end()), ids.end());
+    EXPECT_EQ(ids.size(), roster.size());
+}
+
+TEST_F(CharacterSnapshotTest, LoadRestoresSavedState) {
+    ASSERT_FALSE(roster.empty());
+
+    for (auto& character : roster) {
+        SCOPED_TRACE(character->GetName());
+
+        CharacterSnapshot saved;
+        character->SaveState(saved);
+
+        float health = character->GetCurrentHealth();
+        float mana = character->GetCurrentMana();
+        int gear = character->GetCurrentGear();
+
+        // Diverge from the snapshot the way a mispredicted frame would
+        character->TakeDamage(150.0f);
+        character->ConsumeMana(30.0f);
+        character->SwitchGear((gear + 1) % 4);
+        character->Update(1.0f / 60.0f);
+
+        ASSERT_TRUE(character->LoadState(saved));
+        EXPECT_FLOAT_EQ(character->GetCurrentHealth(), health);
+        EXPECT_FLOAT_EQ(character->GetCurrentMana(), mana);
+        EXPECT_EQ(character->GetCurrentGear(), gear);
+
+        // Subclass state must come back at the same size it was written
+        CharacterSnapshot restored;
+        character->SaveState(restored);
+        EXPECT_EQ(restored.characterDataSize, saved.characterDataSize);
+    }
+}
+
+TEST_F(CharacterSnapshotTest, SameStateGivesSameBytes) {
+    // Desync detection hashes raw snapshots, so nothing left over in the
+    // buffer (padding, unused character data) may leak into them
+    for (auto& character : roster) {
+        SCOPED_TRACE(character->GetName());
+
+        CharacterSnapshot first;
+        CharacterSnapshot second;
+        std::memset(&first, 0xAB, sizeof(first));
+        std::memset(&second, 0xCD, sizeof(second));
+        character->SaveState(first);
+        character->SaveState(second);
+        EXPECT_EQ(std::memcmp(&first, &second, sizeof(CharacterSnapshot)), 0);
+    }
+}
+
+TEST_F(CharacterSnapshotTest, RejectsSnapshotOfAnotherCharacter) {
+    ASSERT_GE(roster.size(), 2u);
+
+    CharacterSnapshot snapshot;
+    roster[0]->SaveState(snapshot);
+
+    float health = roster[1]->GetCurrentHealth();
+    EXPECT_FALSE(roster[1]->LoadState(snapshot));
+    EXPECT_FLOAT_EQ(roster[1]->GetCurrentHealth(), health);
+}
+
+TEST(CyberNinjaSnapshotTest, HackTargetIsRestoredById) {
+    CyberNinja ninja;
+    CharacterBase target("Target", CharacterCategory::System, StatMode::Hybrid);
+
+    CharacterSnapshot beforeHack;
+    ninja.SaveState(beforeHack);
+
+    ninja.InitiateHack(&target);
+    ASSERT_TRUE(ninja.IsHacking());
+    CharacterSnapshot duringHack;
+    ninja.SaveState(duringHack);
+
+    // Leaving the hacking gear cancels it; rolling back brings it back
+    ninja.OnGearSwitch(1, 2);
+    ASSERT_FALSE(ninja.IsHacking());
+    ASSERT_TRUE(ninja.LoadState(duringHack));
+    EXPECT_TRUE(ninja.IsHacking());
+    EXPECT_EQ(ninja.GetHackTargetId(), target.GetId());
+
+    ASSERT_TRUE(ninja.LoadState(beforeHack));
+    EXPECT_FALSE(ninja.IsHacking());
+}
+
+TEST(HyukWoonSungSnapshotTest, RollbackAcrossStanceSwitchDoesNotAllocate) {
+    HyukWoonSung hyuk;
+    hyuk.Initialize();
+
+    CharacterSnapshot light;
+    hyuk.SaveState(light);
+    std::string lightUp = hyuk.GetSpecialMove(InputDirection::Up)->name;
+    std::string lightGear = hyuk.GetGearSkills()[0].name;
+
+    hyuk.SwitchStance(static_cast<int>(StanceType::Dark));
+    ASSERT_EQ(hyuk.GetCurrentStance(), static_cast<int>(StanceType::Dark));
+    std::string darkUp = hyuk.GetSpecialMove(InputDirection::Up)->name;
+    ASSERT_NE(darkUp, lightUp);
+    CharacterSnapshot dark;
+    hyuk.SaveState(dark);
+
+    size_t allocationsBefore = g_allocationCount.load();
+    bool loaded = true;
+    for (int i = 0; i < 100; ++i) {
+        loaded &= hyuk.LoadState(light);
+        loaded &= hyuk.LoadState(dark);
+    }
+    EXPECT_TRUE(loaded);
+    EXPECT_EQ(g_allocationCount.load() - allocationsBefore, 0u);
+
+    // The restored stance brings its own skills back with it
+    ASSERT_TRUE(hyuk.LoadState(light));
+    EXPECT_EQ(hyuk.GetCurrentStance(), static_cast<int>(StanceType::Light));
+    EXPECT_EQ(hyuk.GetSpecialMove(InputDirection::Up)->name, lightUp);
+    EXPECT_EQ(hyuk.GetGearSkills()[0].name, lightGear);
+}
+
+TEST_F(CharacterSnapshotTest, SaveLoadPerformance) {
+    const int iterations = 100000;
+    CharacterSnapshot snapshot;
+
+    for (auto& character : roster) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (int i = 0; i < iterations; ++i) {
+            character->SaveState(snapshot);
+            character->LoadState(snapshot);
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        double microsPerRoundTrip = duration.count() / 1000.0 / iterations;
+
+        std::cout << character->GetName() << ": " << microsPerRoundTrip
+                  << " us per save+load (" << sizeof(CharacterSnapshot) << " byte snapshot, "
+                  << snapshot.characterDataSize << " bytes character data)" << std::endl;
+
+        // A 7-frame rollback restores every fighter once per tick
+        EXPECT_LT(microsPerRoundTrip, 2.0);
+    }
+}
+
+} // namespace Tests
+} // namespace ArenaFighter
@@ -60,7 +60,7 @@ void CombatSystem::Update(float deltaTime) {
     }
 }
 
-float CombatSystem::ProcessDamage(Character* attacker, Character* defender,
+float CombatSystem::ProcessDamage(CharacterBase* attacker, CharacterBase* defender,
                                  float baseDamage, DamageType damageType,
                                  AttackType attackType, int comboCount) {
     if (!attacker || !defender || !m_impl->damageCalculator) {
@@ -94,9 +94,7 @@ float CombatSystem::ProcessDamage(Character* attacker, Character* defender,
         finalDamage *= (1.0f - reduction);
         
         // Apply chip damage for blocked attacks
-        if (attackType != AttackType::Throw) { // Throws bypass block
-            finalDamage *= CHIP_DAMAGE_MULTIPLIER;
-        }
+        finalDamage *= CHIP_DAMAGE_MULTIPLIER;
     }
     
     // Apply combo damage limit (60% max health)
@@ -211,17 +209,17 @@ const FrameData* CombatSystem::GetFrameData(const std::string& characterName,
     return nullptr;
 }
 
-bool CombatSystem::CanAffordSkill(Character* character, float manaCost) const {
+bool CombatSystem::CanAffordSkill(CharacterBase* character, float manaCost) const {
     if (!character) return false;
     return character->GetCurrentMana() >= manaCost;
 }
 
-void CombatSystem::ConsumeMana(Character* character, float manaCost) {
+void CombatSystem::ConsumeMana(CharacterBase* character, float manaCost) {
     if (!character) return;
     character->ConsumeMana(manaCost);
 }
 
-bool CombatSystem::IsInHitstun(Character* character) const {
+bool CombatSystem::IsInHitstun(CharacterBase* character) const {
     if (!character) return false;
     auto it = m_impl->combatStates.find(character->GetId());
     if (it != m_impl->combatStates.end()) {
@@ -230,7 +228,7 @@ bool CombatSystem::IsInHitstun(Character* character) const {
     return false;
 }
 
-bool CombatSystem::IsInBlockstun(Character* character) const {
+bool CombatSystem::IsInBlockstun(CharacterBase* character) const {
     if (!character) return false;
     auto it = m_impl->combatStates.find(character->GetId());
     if (it != m_impl->combatStates.end()) {
@@ -239,11 +237,11 @@ bool CombatSystem::IsInBlockstun(Character* character) const {
     return false;
 }
 
-bool CombatSystem::CanAct(Character* character) const {
+bool CombatSystem::CanAct(CharacterBase* character) const {
     return !IsInHitstun(character) && !IsInBlockstun(character);
 }
 
-int CombatSystem::GetRemainingHitstun(Character* character) const {
+int CombatSystem::GetRemainingHitstun(CharacterBase* character) const {
     if (!character) return 0;
     auto it = m_impl->combatStates.find(character->GetId());
     if (it != m_impl->combatStates.end()) {
@@ -4,25 +4,17 @@
 #include <vector>
 #include <unordered_map>
 #include "CombatEnums.h"
+#include "FrameData.h"
 #include "SpecialMoveSystem.h"
 
 namespace ArenaFighter {
 
 // Forward declarations
-class Character;
+class CharacterBase;
 class DamageCalculator;
 class HitDetection;
 class ComboSystem;
 class SpecialMoveSystem;
-struct FrameData;
-
-// Combat state for tracking character states
-struct CombatState {
-    int hitstunFrames = 0;
-    int blockstunFrames = 0;
-    bool isBlocking = false;
-    float blockDamageReduction = 0.0f;
-};
 
 /**
  * @brief Core combat system managing all combat-related calculations and mechanics
@@ -46,7 +38,7 @@ public:
     void Update(float deltaTime);
 
     // Combat calculations
-    float ProcessDamage(Character* attacker, Character* defender, 
+    float ProcessDamage(CharacterBase* attacker, CharacterBase* defender, 
                        float baseDamage, DamageType damageType, 
                        AttackType attackType, int comboCount = 0);
 
@@ -69,14 +61,14 @@ public:
                                  const std::string& skillName) const;
 
     // Mana management
-    bool CanAffordSkill(Character* character, float manaCost) const;
-    void ConsumeMana(Character* character, float manaCost);
+    bool CanAffordSkill(CharacterBase* character, float manaCost) const;
+    void ConsumeMana(CharacterBase* character, float manaCost);
 
     // State queries
-    bool IsInHitstun(Character* character) const;
-    bool IsInBlockstun(Character* character) const;
-    bool CanAct(Character* character) const;
-    int GetRemainingHitstun(Character* character) const;
+    bool IsInHitstun(CharacterBase* character) const;
+    bool IsInBlockstun(CharacterBase* character) const;
+    bool CanAct(CharacterBase* character) const;
+    int GetRemainingHitstun(CharacterBase* character) const;
 
     // Input handling for special moves
     void HandleSpecialInput(int playerId, InputDirection direction, bool sPressed);
@@ -1,14 +1,29 @@
 #include "ComboSystem.h"
-#include <cmath>
+#include "../Core/FixedPoint.h"
 #include <algorithm>
 #include <numeric>
 
 namespace ArenaFighter {
 
+namespace {
+
+// Scaling factors are applied in fixed point so that every peer prorates
+// a combo identically; see Core/FixedPoint.h
+constexpr Fixed DAMAGE_SCALING_FIXED = Fixed::FromFloat(ComboSystem::DAMAGE_SCALING);
+constexpr Fixed HITSTUN_DECAY_FIXED = Fixed::FromFloat(ComboSystem::HITSTUN_DECAY);
+constexpr Fixed REPETITION_FIXED = Fixed::FromFloat(ProrationSystem::REPETITION_PENALTY);
+constexpr Fixed MINIMUM_SCALING_FIXED = Fixed::FromFloat(ProrationSystem::MINIMUM_SCALING);
+
+} // namespace
+
 // ComboSystem implementation
 ComboSystem::ComboSystem() 
     : m_totalDamage(0.0f)
-    , m_comboTimer(0.0f) {
+    , m_comboFramesRemaining(0)
+    , m_frame(0)
+    , m_partialFrame()
+    , m_comboStartFrame(0)
+    , m_lastHitFrame(0) {
 }
 
 ComboSystem::~ComboSystem() = default;
@@ -24,21 +39,21 @@ void ComboSystem::RegisterHit(AttackType type, float damage, int targetId) {
     hit.attackType = type;
     hit.damage = damage;
     hit.targetId = targetId;
-    hit.timestamp = std::chrono::steady_clock::now();
+    hit.frame = m_frame;
     hit.hitNumber = GetHitCount() + 1;
     
-    // If this is the first hit, record combo start time
+    // If this is the first hit, record combo start frame
     if (m_comboHits.empty()) {
-        m_comboStartTime = hit.timestamp;
+        m_comboStartFrame = hit.frame;
     }
     
     // Add hit and update totals
     m_comboHits.push_back(hit);
-    m_totalDamage += damage;
-    m_lastHitTime = hit.timestamp;
+    m_totalDamage = (Fixed::FromFloat(m_totalDamage) + Fixed::FromFloat(damage)).ToFloat();
+    m_lastHitFrame = hit.frame;
     
     // Reset combo timer
-    m_comboTimer = COMBO_TIMEOUT;
+    m_comboFramesRemaining = COMBO_TIMEOUT_FRAMES;
     
     // Update move usage tracking
     UpdateMoveUsage(type);
@@ -47,20 +62,32 @@ void ComboSystem::RegisterHit(AttackType type, float damage, int targetId) {
 void ComboSystem::Reset() {
     m_comboHits.clear();
     m_totalDamage = 0.0f;
-    m_comboTimer = 0.0f;
+    m_comboFramesRemaining = 0;
     m_moveUsage.clear();
 }
 
 void ComboSystem::Update(float deltaTime) {
+    // Callers step at a fixed 60 FPS, where 1/60 s converts to exactly one
+    // frame. Shorter steps leave a fixed-point remainder that carries over,
+    // so the clock still advances when they add up to a frame.
+    Fixed step = Fixed::FromFloat(deltaTime * FRAMES_PER_SECOND);
+    int frames = step.ToInt();
+    m_partialFrame += step - Fixed(frames);
+    if (m_partialFrame >= Fixed(1)) {
+        m_partialFrame -= Fixed(1);
+        ++frames;
+    }
+    m_frame += frames;
+    
     if (!IsActive()) {
         return;
     }
     
     // Update combo timer
-    m_comboTimer -= deltaTime;
+    m_comboFramesRemaining -= frames;
     
     // Reset if timeout
-    if (m_comboTimer <= 0.0f) {
+    if (m_comboFramesRemaining <= 0) {
         Reset();
     }
 }
@@ -71,15 +98,15 @@ float ComboSystem::GetCurrentScaling() const {
     }
     
     // Base scaling: 0.9^n
-    float scaling = std::pow(DAMAGE_SCALING, static_cast<float>(GetHitCount() - 1));
+    Fixed scaling = Fixed::Pow(DAMAGE_SCALING_FIXED, GetHitCount() - 1);
     
     // Apply repetition penalty if using same moves
     if (IsRepetitive()) {
-        scaling *= CalculateRepetitionPenalty();
+        scaling *= Fixed::FromFloat(CalculateRepetitionPenalty());
     }
     
     // Minimum scaling
-    return std::max(scaling, 0.1f);
+    return Fixed::Max(scaling, MINIMUM_SCALING_FIXED).ToFloat();
 }
 
 float ComboSystem::GetHitstunScaling() const {
@@ -88,7 +115,7 @@ float ComboSystem::GetHitstunScaling() const {
     }
     
     // Hitstun decay: 0.95^n
-    return std::pow(HITSTUN_DECAY, static_cast<float>(GetHitCount() - 1));
+    return Fixed::Pow(HITSTUN_DECAY_FIXED, GetHitCount() - 1).ToFloat();
 }
 
 bool ComboSystem::CanExtendCombo() const {
@@ -110,14 +137,12 @@ float ComboSystem::GetDamagePerSecond() const {
         return 0.0f;
     }
     
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        m_lastHitTime - m_comboStartTime).count() / 1000.0f;
-    
-    if (duration <= 0.0f) {
+    uint32_t frames = m_lastHitFrame - m_comboStartFrame;
+    if (frames == 0) {
         return m_totalDamage;
     }
     
-    return m_totalDamage / duration;
+    return m_totalDamage * FRAMES_PER_SECOND / static_cast<float>(frames);
 }
 
 float ComboSystem::GetAverageHitDamage() const {
@@ -159,17 +184,17 @@ void ComboSystem::UpdateMoveUsage(AttackType type) {
 }
 
 float ComboSystem::CalculateRepetitionPenalty() const {
-    float penalty = 1.0f;
+    Fixed penalty(1);
     
     for (const auto& usage : m_moveUsage) {
         if (usage.count >= 3) {
             // Each repetition beyond 2 reduces damage by 20%
             int excess = usage.count - 2;
-            penalty *= std::pow(0.8f, static_cast<float>(excess));
+            penalty *= Fixed::Pow(REPETITION_FIXED, excess);
         }
     }
     
-    return penalty;
+    return penalty.ToFloat();
 }
 
 // ProrationSystem implementation
@@ -178,23 +203,23 @@ ProrationSystem::ProrationSystem() {
 
 float ProrationSystem::CalculateProratedDamage(float baseDamage, int comboHit,
                                               bool isStarter, bool isRepetitive) {
-    float scaling = 1.0f;
+    Fixed scaling(1);
     
     // Apply combo scaling
-    scaling *= GetComboScaling(comboHit);
+    scaling *= Fixed::FromFloat(GetComboScaling(comboHit));
     
     // Apply starter scaling
-    scaling *= GetStarterScaling(isStarter, comboHit);
+    scaling *= Fixed::FromFloat(GetStarterScaling(isStarter, comboHit));
     
     // Apply repetition penalty
     if (isRepetitive) {
-        scaling *= REPETITION_PENALTY;
+        scaling *= REPETITION_FIXED;
     }
     
     // Clamp to minimum
-    scaling = ClampScaling(scaling);
+    scaling = Fixed::Max(scaling, MINIMUM_SCALING_FIXED);
     
-    return baseDamage * scaling;
+    return (Fixed::FromFloat(baseDamage) * scaling).ToFloat();
 }
 
 float ProrationSystem::GetComboScaling(int hitCount) const {
@@ -203,7 +228,7 @@ float ProrationSystem::GetComboScaling(int hitCount) const {
     }
     
     // LSFDC formula: 0.9^(n-1)
-    return std::pow(ComboSystem::DAMAGE_SCALING, static_cast<float>(hitCount - 1));
+    return Fixed::Pow(DAMAGE_SCALING_FIXED, hitCount - 1).ToFloat();
 }
 
 float ProrationSystem::GetStarterScaling(bool isStarter, int hitCount) const {
@@ -225,7 +250,7 @@ float ProrationSystem::GetRepetitionScaling(int sameMovesCount) const {
     
     // Each repetition beyond 2 applies penalty
     int excess = sameMovesCount - 2;
-    return std::pow(REPETITION_PENALTY, static_cast<float>(excess));
+    return Fixed::Pow(REPETITION_FIXED, excess).ToFloat();
 }
 
 float ProrationSystem::ClampScaling(float scaling) const {
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <vector>
-#include <chrono>
+#include <cstdint>
 #include "CombatEnums.h"
+#include "../Core/FixedPoint.h"
 
 namespace ArenaFighter {
 
@@ -13,7 +14,7 @@ struct ComboHit {
     AttackType attackType;
     float damage;
     int targetId;
-    std::chrono::steady_clock::time_point timestamp;
+    uint32_t frame;         // Combo clock frame the hit landed on
     int hitNumber;
 };
 
@@ -41,7 +42,7 @@ public:
     float GetTotalDamage() const { return m_totalDamage; }
     float GetCurrentScaling() const;
     float GetHitstunScaling() const;
-    bool IsActive() const { return !m_comboHits.empty() && m_comboTimer > 0.0f; }
+    bool IsActive() const { return !m_comboHits.empty() && m_comboFramesRemaining > 0; }
     bool CanExtendCombo() const;
     
     // Combo analysis
@@ -52,17 +53,23 @@ public:
     
     // Constants from CLAUDE.md
     static constexpr float COMBO_TIMEOUT = 1.5f;  // 1.5 seconds to continue combo
+    static constexpr int COMBO_TIMEOUT_FRAMES = 90;  // COMBO_TIMEOUT at 60 FPS
+    static constexpr int FRAMES_PER_SECOND = 60;
     static constexpr int MAX_COMBO_LENGTH = 15;
     static constexpr float DAMAGE_SCALING = 0.9f;
     static constexpr float HITSTUN_DECAY = 0.95f;
     static constexpr float MAX_DAMAGE_PERCENT = 0.6f;  // 60% max health
     
 private:
+    // Timing is counted in whole frames rather than wall-clock time so
+    // every rollback peer expires the combo on the same frame
     std::vector<ComboHit> m_comboHits;
     float m_totalDamage;
-    float m_comboTimer;
-    std::chrono::steady_clock::time_point m_comboStartTime;
-    std::chrono::steady_clock::time_point m_lastHitTime;
+    int m_comboFramesRemaining;
+    uint32_t m_frame;
+    Fixed m_partialFrame;   // Fraction of a frame carried between Update() calls
+    uint32_t m_comboStartFrame;
+    uint32_t m_lastHitFrame;
     
     // Repetition tracking
     struct MoveUsage {
@@ -1,5 +1,5 @@
 #include "DamageCalculator.h"
-#include <cmath>
+#include "../Core/FixedPoint.h"
 #include <algorithm>
 #include <vector>
 
@@ -44,64 +44,82 @@ bool DamageCalculator::Initialize() {
     return true;
 }
 
+namespace {
+
+// Every step of the damage formula runs in fixed point so that peers in a
+// rollback match compute bit-identical results. Floats are only touched
+// when converting inputs and the final value.
+constexpr Fixed COMBO_SCALING = Fixed::FromFloat(DamageCalculator::COMBO_SCALING_FACTOR);
+
+Fixed DefenseReduction(Fixed damage, Fixed defense) {
+    // LSFDC defense formula
+    return damage * (Fixed(100) / (Fixed(100) + defense));
+}
+
+Fixed ComboScaling(int hitCount) {
+    // LSFDC combo scaling: 0.9^n
+    return Fixed::Pow(COMBO_SCALING, std::max(hitCount, 0));
+}
+
+} // namespace
+
 float DamageCalculator::CalculateDamage(const DamageParams& params) {
     // Step 1: Base damage with power modifier
-    float damage = CalculateBaseDamage(params.baseDamage, params.attackerPower);
+    Fixed damage = Fixed::FromFloat(params.baseDamage) * Fixed::FromFloat(params.attackerPower);
     
     // Step 2: Apply defense reduction (LSFDC formula)
-    damage = CalculateDefenseReduction(damage, params.defenderDefense);
+    damage = DefenseReduction(damage, Fixed::FromFloat(params.defenderDefense));
     
     // Step 3: Element multiplier
-    float elementMult = GetElementMultiplier(params.attackerElement, params.defenderElement);
-    damage *= elementMult;
+    damage *= Fixed::FromFloat(GetElementMultiplier(params.attackerElement, params.defenderElement));
     
     // Step 4: Combo scaling
-    damage *= GetComboScaling(params.comboCount);
+    damage *= ComboScaling(params.comboCount);
     
     // Step 5: Counter hit bonus
     if (params.isCounter) {
-        damage *= GetCounterBonus();
+        damage *= Fixed::FromFloat(GetCounterBonus());
     }
     
     // Step 6: Critical hit
     if (params.isCritical) {
-        damage *= GetCriticalMultiplier();
+        damage *= Fixed::FromFloat(GetCriticalMultiplier());
     }
     
     // Step 7: State-based modifiers
-    damage *= GetStateModifier(params.defenderState);
+    damage *= Fixed::FromFloat(GetStateModifier(params.defenderState));
     
     // Step 8: Damage type modifiers
+    Fixed reduction = Fixed::FromFloat(params.damageReduction);
     switch (params.damageType) {
         case DamageType::True:
             // True damage ignores additional reductions
             break;
         case DamageType::Physical:
             // Physical damage can be further reduced by armor
-            damage *= (1.0f - params.damageReduction * 0.5f);
+            damage *= Fixed(1) - reduction * Fixed::FromRatio(1, 2);
             break;
         case DamageType::Magical:
             // Magical damage affected less by armor
-            damage *= (1.0f - params.damageReduction * 0.3f);
+            damage *= Fixed(1) - reduction * Fixed::FromRatio(3, 10);
             break;
     }
     
     // Step 9: Apply general damage reduction
-    damage *= (1.0f - params.damageReduction);
+    damage *= Fixed(1) - reduction;
     
     // Step 10: Minimum damage guarantee
-    damage = std::max(damage, MIN_DAMAGE);
+    damage = Fixed::Max(damage, Fixed::FromFloat(MIN_DAMAGE));
     
-    return damage;
+    return damage.ToFloat();
 }
 
 float DamageCalculator::CalculateBaseDamage(float baseDamage, float powerModifier) {
-    return baseDamage * powerModifier;
+    return (Fixed::FromFloat(baseDamage) * Fixed::FromFloat(powerModifier)).ToFloat();
 }
 
 float DamageCalculator::CalculateDefenseReduction(float damage, float defense) {
-    // LSFDC defense formula
-    return damage * (100.0f / (100.0f + defense));
+    return DefenseReduction(Fixed::FromFloat(damage), Fixed::FromFloat(defense)).ToFloat();
 }
 
 float DamageCalculator::GetElementMultiplier(ElementType attacker, ElementType defender) {
@@ -109,8 +127,7 @@ float DamageCalculator::GetElementMultiplier(ElementType attacker, ElementType d
 }
 
 float DamageCalculator::GetComboScaling(int hitCount) {
-    // LSFDC combo scaling: 0.9^n
-    return std::pow(COMBO_SCALING_FACTOR, static_cast<float>(hitCount));
+    return ComboScaling(hitCount).ToFloat();
 }
 
 float DamageCalculator::GetStateModifier(CharacterState state) {
@@ -142,11 +159,11 @@ float DamageCalculator::GetCriticalMultiplier() {
 
 int DamageCalculator::CalculateHitstun(float finalDamage, bool isCounter) {
     // LSFDC hitstun formula
-    int hitstun = static_cast<int>(finalDamage / 10.0f) + BASE_HITSTUN;
+    int hitstun = (Fixed::FromFloat(finalDamage) / Fixed(10)).ToInt() + BASE_HITSTUN;
     
     // Counter hit adds 50% more hitstun
     if (isCounter) {
-        hitstun = static_cast<int>(hitstun * 1.5f);
+        hitstun = hitstun * 3 / 2;
     }
     
     // Clamp between minimum and maximum values
@@ -155,14 +172,14 @@ int DamageCalculator::CalculateHitstun(float finalDamage, bool isCounter) {
 
 float DamageCalculator::CalculateKnockback(float finalDamage, float targetWeight) {
     // LSFDC knockback formula
-    const float BASE_KNOCKBACK = 5.0f;
-    const float WEIGHT_FACTOR = 100.0f / targetWeight;
+    const Fixed BASE_KNOCKBACK(5);
+    const Fixed WEIGHT_FACTOR = Fixed(100) / Fixed::FromFloat(targetWeight);
     
-    float knockback = BASE_KNOCKBACK + (finalDamage * 0.1f) * WEIGHT_FACTOR;
+    Fixed knockback = BASE_KNOCKBACK + Fixed::FromFloat(finalDamage) / Fixed(10) * WEIGHT_FACTOR;
     
     // Maximum knockback limit
-    const float MAX_KNOCKBACK = 30.0f;
-    return std::min(knockback, MAX_KNOCKBACK);
+    const Fixed MAX_KNOCKBACK(30);
+    return Fixed::Min(knockback, MAX_KNOCKBACK).ToFloat();
 }
 
 int DamageCalculator::CalculateBlockstun(AttackType attackType) {
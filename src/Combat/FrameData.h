@@ -203,6 +203,8 @@ struct CombatState {
     bool isAirborne = false;
     bool isCrouching = false;
     float comboScaling = 1.0f;
+    bool isBlocking = false;
+    float blockDamageReduction = 0.0f;
 };
 
 } // namespace ArenaFighter
\ No newline at end of file
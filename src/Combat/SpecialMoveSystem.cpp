@@ -23,7 +23,7 @@ void SpecialMoveSystem::update(float deltaTime) {
             m_blockState.m_canUseSpecials = false;
             
             if (m_character) {
-                m_character->setBlocking(true);
+                m_character->StartBlocking();
             }
         }
     }
@@ -62,7 +62,7 @@ void SpecialMoveSystem::handleSButtonRelease() {
         m_blockState.m_canUseSpecials = true;
         
         if (m_character) {
-            m_character->setBlocking(false);
+            m_character->StopBlocking();
         }
     }
     
@@ -105,33 +105,13 @@ bool SpecialMoveSystem::tryExecuteSpecialMove(InputDirection direction) {
         return false;
     }
     
-    // Get the special move for this direction
-    SpecialMove* move = m_character->getSpecialMove(direction);
-    if (!move) {
+    // The character checks the move, its mana and its stance, then pays
+    // and enters ExecutingSpecial
+    if (!m_character->CanExecuteSpecialMove(direction)) {
         return false;
     }
     
-    // Check mana
-    if (m_character->getCurrentMana() < move->m_manaCost) {
-        return false;
-    }
-    
-    // Execute the move
-    m_character->consumeMana(static_cast<float>(move->m_manaCost));
-    
-    // Set character state
-    m_character->startSpecialMove(
-        move->m_name,
-        move->m_startupFrames,
-        move->m_activeFrames,
-        move->m_recoveryFrames
-    );
-    
-    // Execute callback if provided
-    if (move->m_executeCallback) {
-        move->m_executeCallback(m_character);
-    }
-    
+    m_character->ExecuteSpecialMove(direction);
     return true;
 }
 
@@ -149,9 +129,10 @@ bool SpecialMoveSystem::canExecuteSpecialMove() const {
     // Check character state
     if (m_character) {
         // Can't use specials during hitstun, already in a move, etc
-        if (m_character->isInHitstun() || 
-            m_character->isPerformingMove() ||
-            m_character->isKnockedDown()) {
+        CharacterState state = m_character->GetCurrentState();
+        if (state == CharacterState::HitStun ||
+            state == CharacterState::ExecutingSpecial ||
+            state == CharacterState::KnockedDown) {
             return false;
         }
     }
@@ -165,20 +146,21 @@ bool SpecialMoveSystem::tryStanceSwitch() {
     }
     
     // Check if character supports stance switching
-    CharacterBase* stanceChar = dynamic_cast<CharacterBase*>(m_character);
-    if (!stanceChar || !stanceChar->hasStanceSystem()) {
+    if (!m_character->HasStanceSystem()) {
         return false;
     }
     
     // Can't switch during certain states
-    if (m_character->isInHitstun() || 
-        m_character->isPerformingMove() ||
-        m_character->isBlocking()) {
+    CharacterState state = m_character->GetCurrentState();
+    if (state == CharacterState::HitStun ||
+        state == CharacterState::ExecutingSpecial ||
+        m_character->IsBlocking()) {
         return false;
     }
     
-    // Perform stance switch
-    return stanceChar->switchStance();
+    // Stance characters have two stances
+    m_character->SwitchStance(1 - m_character->GetCurrentStance());
+    return true;
 }
 
 void SpecialMoveSystem::addToInputBuffer(InputDirection direction, bool sHeld) {
@@ -0,0 +1,89 @@
+#include "DeterministicRandom.h"
+#include <random>
+
+namespace ArenaFighter {
+
+void DeterministicRandom::Seed(uint64_t seed) {
+    // Reference PCG32 seeding: advance once, mix in the seed, advance again
+    m_state = 0;
+    NextU32();
+    m_state += seed;
+    NextU32();
+}
+
+uint32_t DeterministicRandom::NextU32() {
+    uint64_t oldState = m_state;
+    m_state = oldState * MULTIPLIER + INCREMENT;
+
+    uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+    uint32_t rotation = static_cast<uint32_t>(oldState >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+uint32_t DeterministicRandom::NextInt(uint32_t bound) {
+    if (bound == 0) {
+        return 0;
+    }
+
+    // Multiply-shift with rejection of the biased low range
+    uint64_t product = static_cast<uint64_t>(NextU32()) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+
+    if (low < bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = static_cast<uint64_t>(NextU32()) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+
+    return static_cast<uint32_t>(product >> 32);
+}
+
+int DeterministicRandom::NextRange(int minValue, int maxValue) {
+    if (maxValue <= minValue) {
+        return minValue;
+    }
+
+    uint32_t span = static_cast<uint32_t>(maxValue - minValue) + 1;
+    return minValue + static_cast<int>(NextInt(span));
+}
+
+float DeterministicRandom::NextFloat() {
+    return static_cast<float>(NextU32() >> 8) * (1.0f / 16777216.0f);
+}
+
+namespace {
+
+uint64_t MakeOfflineSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+// Set by ScopedSimulationRandom; the thread's own generator otherwise
+thread_local DeterministicRandom* t_installedRandom = nullptr;
+
+} // namespace
+
+DeterministicRandom& GetSimulationRandom() {
+    if (t_installedRandom) {
+        return *t_installedRandom;
+    }
+    thread_local DeterministicRandom random(MakeOfflineSeed());
+    return random;
+}
+
+void SeedSimulationRandom(uint64_t seed) {
+    GetSimulationRandom().Seed(seed);
+}
+
+ScopedSimulationRandom::ScopedSimulationRandom(DeterministicRandom& random)
+    : m_previous(t_installedRandom) {
+    t_installedRandom = &random;
+}
+
+ScopedSimulationRandom::~ScopedSimulationRandom() {
+    t_installedRandom = m_previous;
+}
+
+} // namespace ArenaFighter
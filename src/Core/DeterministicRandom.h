@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ArenaFighter {
+
+// PCG32 generator. The output sequence is fully specified by the seed,
+// unlike rand() or the std:: distributions, whose results differ between
+// standard libraries. Bounded values use integer math only. The whole
+// state is one 64-bit word, so it fits in a rollback snapshot.
+class DeterministicRandom {
+public:
+    explicit DeterministicRandom(uint64_t seed = 0) { Seed(seed); }
+
+    void Seed(uint64_t seed);
+
+    uint32_t NextU32();
+
+    // Uniform in [0, bound); returns 0 when bound is 0
+    uint32_t NextInt(uint32_t bound);
+
+    // Uniform in [minValue, maxValue], both inclusive
+    int NextRange(int minValue, int maxValue);
+
+    // Uniform in [0, 1) with 24 bits of resolution; exact in any FP mode
+    float NextFloat();
+
+    // True with the given percent chance (0-100)
+    bool NextChance(uint32_t percent) { return NextInt(100) < percent; }
+
+    uint64_t GetState() const { return m_state; }
+    void SetState(uint64_t state) { m_state = state; }
+
+private:
+    static constexpr uint64_t MULTIPLIER = 6364136223846793005ULL;
+    static constexpr uint64_t INCREMENT = 1442695040888963407ULL;
+
+    uint64_t m_state;
+};
+
+// Gameplay randomness for the match simulated on the calling thread. Every
+// roll that can change match state must come from here so that peers stay
+// in lockstep; purely cosmetic effects may keep their own generators.
+// Offline play starts from a nondeterministic seed; NetworkManager reseeds
+// it from MatchStartPacket::randomSeed when a networked match begins.
+// Simulations that roll back must save and restore GetState() with their
+// other state.
+DeterministicRandom& GetSimulationRandom();
+void SeedSimulationRandom(uint64_t seed);
+
+// Makes random the calling thread's simulation random until the scope
+// ends, for threads that take turns simulating several matches. Rolls and
+// reseeds inside the scope then only touch that match's generator.
+class ScopedSimulationRandom {
+public:
+    explicit ScopedSimulationRandom(DeterministicRandom& random);
+    ~ScopedSimulationRandom();
+
+    ScopedSimulationRandom(const ScopedSimulationRandom&) = delete;
+    ScopedSimulationRandom& operator=(const ScopedSimulationRandom&) = delete;
+
+private:
+    DeterministicRandom* m_previous;
+};
+
+} // namespace ArenaFighter
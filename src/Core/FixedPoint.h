@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ArenaFighter {
+
+// Signed 16.16 fixed-point number for gameplay math that has to come out
+// bit-identical on every peer. All arithmetic is integer; the only float
+// operations are the conversions at the edges, and both are exact or
+// correctly rounded, so compiler flags and FPU modes cannot change results.
+// Range is roughly +/-32767 with a resolution of 1/65536.
+class Fixed {
+public:
+    static constexpr int FRACTION_BITS = 16;
+    static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+    constexpr Fixed() : m_raw(0) {}
+    // Integers outside the range saturate, like FromFloat
+    constexpr Fixed(int value)
+        : m_raw(value > (INT32_MAX >> FRACTION_BITS) ? INT32_MAX
+              : value < (INT32_MIN >> FRACTION_BITS) ? INT32_MIN
+              : value * ONE) {}
+
+    static constexpr Fixed FromRaw(int32_t raw) {
+        Fixed result;
+        result.m_raw = raw;
+        return result;
+    }
+
+    // Rounds to the nearest step. float -> double and the scale by 2^16
+    // are exact, so the only rounding is the final, explicit one. Values
+    // outside the range saturate instead of wrapping; NaN becomes 0.
+    static constexpr Fixed FromFloat(float value) {
+        double scaled = static_cast<double>(value) * ONE;
+        double rounded = scaled >= 0.0 ? scaled + 0.5 : scaled - 0.5;
+        if (rounded >= static_cast<double>(INT32_MAX)) return FromRaw(INT32_MAX);
+        if (rounded <= static_cast<double>(INT32_MIN)) return FromRaw(INT32_MIN);
+        if (!(rounded == rounded)) return Fixed();
+        return FromRaw(static_cast<int32_t>(rounded));
+    }
+
+    // num / den without going through floating point
+    static constexpr Fixed FromRatio(int32_t num, int32_t den) {
+        return FromRaw(static_cast<int32_t>(static_cast<int64_t>(num) * ONE / den));
+    }
+
+    constexpr int32_t Raw() const { return m_raw; }
+    constexpr float ToFloat() const { return static_cast<float>(m_raw) / static_cast<float>(ONE); }
+    constexpr int ToInt() const { return m_raw >> FRACTION_BITS; }   // Floors
+
+    // Arithmetic
+    constexpr Fixed operator+(Fixed other) const { return FromRaw(m_raw + other.m_raw); }
+    constexpr Fixed operator-(Fixed other) const { return FromRaw(m_raw - other.m_raw); }
+    constexpr Fixed operator-() const { return FromRaw(-m_raw); }
+
+    // Round to nearest; the 64-bit intermediate cannot overflow
+    constexpr Fixed operator*(Fixed other) const {
+        int64_t product = static_cast<int64_t>(m_raw) * other.m_raw;
+        return FromRaw(static_cast<int32_t>((product + (ONE >> 1)) >> FRACTION_BITS));
+    }
+
+    // Truncates toward zero; dividing by zero is the caller's bug
+    constexpr Fixed operator/(Fixed other) const {
+        return FromRaw(static_cast<int32_t>(static_cast<int64_t>(m_raw) * ONE / other.m_raw));
+    }
+
+    constexpr Fixed& operator+=(Fixed other) { m_raw += other.m_raw; return *this; }
+    constexpr Fixed& operator-=(Fixed other) { m_raw -= other.m_raw; return *this; }
+    constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+    constexpr Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+    // Comparison
+    constexpr bool operator==(Fixed other) const { return m_raw == other.m_raw; }
+    constexpr bool operator!=(Fixed other) const { return m_raw != other.m_raw; }
+    constexpr bool operator<(Fixed other) const { return m_raw < other.m_raw; }
+    constexpr bool operator<=(Fixed other) const { return m_raw <= other.m_raw; }
+    constexpr bool operator>(Fixed other) const { return m_raw > other.m_raw; }
+    constexpr bool operator>=(Fixed other) const { return m_raw >= other.m_raw; }
+
+    // base^exponent by repeated squaring; replaces std::pow for the
+    // integer exponents used in combo and hitstun scaling
+    static constexpr Fixed Pow(Fixed base, int exponent) {
+        Fixed result(1);
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result *= base;
+            }
+            base *= base;
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    static constexpr Fixed Min(Fixed a, Fixed b) { return a < b ? a : b; }
+    static constexpr Fixed Max(Fixed a, Fixed b) { return a > b ? a : b; }
+    static constexpr Fixed Clamp(Fixed value, Fixed low, Fixed high) { return Min(Max(value, low), high); }
+
+private:
+    int32_t m_raw;
+};
+
+} // namespace ArenaFighter
@@ -1,6 +1,6 @@
 #include "BeastMode.h"
+#include "../Core/DeterministicRandom.h"
 #include <algorithm>
-#include <chrono>
 
 namespace ArenaFighter {
 
@@ -13,10 +13,6 @@ BeastMode::BeastMode(const BeastModeConfig& config)
     , m_beastTimer(0.0f)
     , m_transformTimer(0.0f) {
     
-    // Initialize RNG
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    m_rng.seed(seed);
-    
     // Update base config for beast mode
     m_config.maxPlayers = 8;
     m_config.roundTime = config.beastModeDuration;
@@ -163,8 +159,7 @@ void BeastMode::selectBeast() {
     if (m_players.empty()) return;
     
     // Random selection for now, can be modified for different selection methods
-    std::uniform_int_distribution<int> dist(0, m_players.size() - 1);
-    int beastIndex = dist(m_rng);
+    int beastIndex = GetSimulationRandom().NextRange(0, static_cast<int>(m_players.size()) - 1);
     
     m_currentBeastId = m_players[beastIndex]->getId();
     transformToBeast(m_currentBeastId);
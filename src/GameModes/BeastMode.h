@@ -1,7 +1,6 @@
 #pragma once
 
 #include "GameMode.h"
-#include <random>
 #include <map>
 
 namespace ArenaFighter {
@@ -52,7 +51,6 @@ private:
     // Round state
     float m_beastTimer;
     float m_transformTimer;
-    std::mt19937 m_rng;
     
     // Beast transformation
     void selectBeast();
@@ -1,6 +1,6 @@
 #include "DeathMatchMode.h"
+#include "../Core/DeterministicRandom.h"
 #include <algorithm>
-#include <random>
 
 namespace ArenaFighter {
 
@@ -10,10 +10,6 @@ DeathMatchMode::DeathMatchMode(const DeathMatchConfig& config)
     , m_nextItemSpawn(0.0f)
     , m_lastKillTime(0.0f) {
     
-    // Initialize RNG
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    m_rng.seed(seed);
-    
     // Update base config
     m_config.maxPlayers = 8;
     m_config.roundTime = config.matchDuration;
@@ -193,8 +189,8 @@ void DeathMatchMode::initializeSpawnPoints() {
 Vector3 DeathMatchMode::getRandomSpawnPoint() const {
     if (m_spawnPoints.empty()) return Vector3(0, 0, 0);
     
-    std::uniform_int_distribution<int> dist(0, m_spawnPoints.size() - 1);
-    return m_spawnPoints[dist(const_cast<std::mt19937&>(m_rng))];
+    int index = GetSimulationRandom().NextRange(0, static_cast<int>(m_spawnPoints.size()) - 1);
+    return m_spawnPoints[index];
 }
 
 Vector3 DeathMatchMode::getFarthestSpawnPoint(int playerId) const {
@@ -248,12 +244,11 @@ void DeathMatchMode::spawnItem() {
     if (m_itemSpawnPoints.empty()) return;
     
     // Select random spawn point
-    std::uniform_int_distribution<int> spawnDist(0, m_itemSpawnPoints.size() - 1);
-    Vector3 spawnPos = m_itemSpawnPoints[spawnDist(m_rng)];
+    DeterministicRandom& random = GetSimulationRandom();
+    Vector3 spawnPos = m_itemSpawnPoints[random.NextRange(0, static_cast<int>(m_itemSpawnPoints.size()) - 1)];
     
     // Select random item type
-    std::uniform_int_distribution<int> typeDist(0, static_cast<int>(ItemType::InstantUltimate));
-    ItemType itemType = static_cast<ItemType>(typeDist(m_rng));
+    ItemType itemType = static_cast<ItemType>(random.NextRange(0, static_cast<int>(ItemType::InstantUltimate)));
     
     // Create item
     SpawnableItem newItem{
@@ -68,7 +68,6 @@ private:
     std::vector<SpawnableItem> m_itemSpawns;
     std::vector<SpawnableItem> m_activeItems;
     float m_nextItemSpawn;
-    std::mt19937 m_rng;
     
     // Kill tracking
     std::deque<std::pair<int, int>> m_recentKills; // killer, victim
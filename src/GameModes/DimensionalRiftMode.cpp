@@ -1,6 +1,6 @@
 #include "DimensionalRiftMode.h"
+#include "../Core/DeterministicRandom.h"
 #include <algorithm>
-#include <random>
 #include <cmath>
 
 namespace ArenaFighter {
@@ -167,7 +167,7 @@ void DimensionalRiftMode::generateDungeon() {
         }
         else {
             // Random between combat and challenge
-            room.type = (rand() % 3 == 0) ? RoomType::Challenge : RoomType::Combat;
+            room.type = (GetSimulationRandom().NextInt(3) == 0) ? RoomType::Challenge : RoomType::Combat;
         }
         
         m_dungeon.push_back(room);
@@ -190,7 +190,7 @@ void DimensionalRiftMode::generateRoom(DungeonRoom& room) {
         case RoomType::Treasure:
             room.rewards.push_back({ItemType::HealthRestore, Vector3(0, 0, 0)});
             room.rewards.push_back({ItemType::ManaRestore, Vector3(5, 0, 0)});
-            if (rand() % 2 == 0) {
+            if (GetSimulationRandom().NextInt(2) == 0) {
                 room.rewards.push_back({ItemType::DamageBoost, Vector3(-5, 0, 0)});
             }
             break;
@@ -202,7 +202,7 @@ void DimensionalRiftMode::generateRoom(DungeonRoom& room) {
             
         default:
             // Random chance for loot
-            if (static_cast<float>(rand()) / RAND_MAX < m_riftConfig.lootDropRate) {
+            if (GetSimulationRandom().NextFloat() < m_riftConfig.lootDropRate) {
                 room.rewards.push_back({ItemType::HealthRestore, Vector3(0, 0, 0)});
             }
             break;
@@ -221,8 +221,8 @@ void DimensionalRiftMode::connectRooms() {
         // Add branching paths
         if (i > 0 && i < m_dungeon.size() - 2) {
             // 30% chance for additional connection
-            if (rand() % 100 < 30) {
-                int targetRoom = i + 2 + (rand() % 3);
+            if (GetSimulationRandom().NextChance(30)) {
+                int targetRoom = GetSimulationRandom().NextRange(i + 2, i + 4);
                 if (targetRoom < m_dungeon.size()) {
                     m_dungeon[i].connectedRooms.push_back(targetRoom);
                     m_dungeon[targetRoom].connectedRooms.push_back(i);
@@ -237,11 +237,11 @@ void DimensionalRiftMode::populateRoom(DungeonRoom& room) {
     
     switch (room.type) {
         case RoomType::Combat:
-            enemyCount = 3 + (rand() % 3); // 3-5 enemies
+            enemyCount = GetSimulationRandom().NextRange(3, 5); // 3-5 enemies
             break;
             
         case RoomType::Challenge:
-            enemyCount = 4 + (rand() % 3); // 4-6 enemies
+            enemyCount = GetSimulationRandom().NextRange(4, 6); // 4-6 enemies
             break;
             
         case RoomType::Elite:
@@ -525,11 +525,11 @@ void DimensionalRiftMode::spawnEnemies(const DungeonRoom& room) {
     
     switch (room.type) {
         case RoomType::Combat:
-            enemyCount = 3 + (rand() % 3);
+            enemyCount = GetSimulationRandom().NextRange(3, 5);
             break;
             
         case RoomType::Challenge:
-            enemyCount = 4 + (rand() % 3);
+            enemyCount = GetSimulationRandom().NextRange(4, 6);
             break;
             
         case RoomType::Elite:
@@ -623,7 +623,7 @@ void DimensionalRiftMode::onEnemyDefeated(std::shared_ptr<CharacterBase> enemy)
     m_progress.enemiesDefeated++;
     
     // Drop loot
-    if (static_cast<float>(rand()) / RAND_MAX < m_riftConfig.lootDropRate * m_lootMultiplier) {
+    if (GetSimulationRandom().NextFloat() < m_riftConfig.lootDropRate * m_lootMultiplier) {
         dropLoot(enemy->getPosition());
     }
     
@@ -633,7 +633,7 @@ void DimensionalRiftMode::onEnemyDefeated(std::shared_ptr<CharacterBase> enemy)
 
 void DimensionalRiftMode::dropLoot(const Vector3& position) {
     // Random loot type
-    int typeIndex = rand() % 8;
+    int typeIndex = GetSimulationRandom().NextRange(0, 7);
     ItemType lootType = static_cast<ItemType>(typeIndex);
     
     if (m_currentRoom) {
@@ -721,7 +721,7 @@ void DimensionalRiftMode::adjustDifficulty() {
 
 void DimensionalRiftMode::triggerEvent() {
     // Random events to keep gameplay interesting
-    int eventType = rand() % 3;
+    int eventType = GetSimulationRandom().NextRange(0, 2);
     
     switch (eventType) {
         case 0:
@@ -18,15 +18,16 @@ GameMode::GameMode(const MatchConfig& config)
 }
 
 void GameMode::initialize() {
-    // Initialize physics
-    m_physicsEngine->initialize();
-    m_physicsEngine->setGravity(XMFLOAT3(0, GRAVITY, 0));
+    // Initialize physics (gravity is a PhysicsEngine constant)
+    m_physicsEngine->Initialize();
     
     // Initialize combat system
-    m_combatSystem->initialize();
+    m_combatSystem->Initialize();
     
+#ifndef DFR_HEADLESS
     // Create UI based on mode
     m_gameUI = std::make_shared<GameModeUI>("GameModeUI", getModeType());
+#endif
     
     // Reserve space for players
     m_players.reserve(m_config.maxPlayers);
@@ -61,7 +62,9 @@ void GameMode::update(float deltaTime) {
             // Update round timer
             if (!m_config.infiniteTime) {
                 m_roundTimer -= deltaTime;
+#ifndef DFR_HEADLESS
                 m_gameUI->setMatchTime(m_roundTimer);
+#endif
                 
                 if (m_roundTimer <= 0) {
                     // Time out
@@ -71,19 +74,19 @@ void GameMode::update(float deltaTime) {
                 }
             }
             
-            // Update physics
-            m_physicsEngine->update(deltaTime);
-            
+            // Update physics; fighters' bodies are not colliders of the
+            // engine, so they are moved here
+            m_physicsEngine->Update(deltaTime);
+            for (auto& player : m_players) {
+                m_physicsEngine->ProcessMovement(player->GetRigidBody(), deltaTime);
+            }
+
             // Update combat
-            m_combatSystem->update(deltaTime);
+            m_combatSystem->Update(deltaTime);
             
-            // Update characters
+            // Update characters (mana regenerates in CharacterBase::Update)
             for (auto& player : m_players) {
-                player->update(deltaTime);
-                
-                // Update mana regeneration
-                float currentMana = player->getMana();
-                player->setMana(std::min(currentMana + MANA_REGEN_RATE * deltaTime, BASE_MANA));
+                player->Update(deltaTime);
             }
             
             // Check win conditions
@@ -128,10 +131,12 @@ void GameMode::update(float deltaTime) {
 }
 
 void GameMode::render() {
+#ifndef DFR_HEADLESS
     // Render game UI
     if (m_gameUI) {
         m_gameUI->render();
     }
+#endif
     
     // Mode-specific rendering handled by derived classes
 }
@@ -139,11 +144,11 @@ void GameMode::render() {
 void GameMode::shutdown() {
     // Clean up systems
     if (m_combatSystem) {
-        m_combatSystem->shutdown();
+        m_combatSystem->Shutdown();
     }
     
     if (m_physicsEngine) {
-        m_physicsEngine->shutdown();
+        m_physicsEngine->Shutdown();
     }
     
     // Clear players
@@ -151,32 +156,17 @@ void GameMode::shutdown() {
     m_roundResults.clear();
 }
 
+// A player's index is its slot in m_players
 void GameMode::addPlayer(std::shared_ptr<CharacterBase> character) {
-    if (m_players.size() < m_config.maxPlayers) {
+    if (character && m_players.size() < m_config.maxPlayers) {
         m_players.push_back(character);
-        
-        // Register with systems
-        m_physicsEngine->registerCharacter(character.get());
-        m_combatSystem->registerCharacter(character.get());
-        
-        // Set player index
-        character->setPlayerIndex(static_cast<int>(m_players.size()) - 1);
     }
 }
 
 void GameMode::removePlayer(int playerId) {
     if (playerId >= 0 && playerId < m_players.size()) {
-        // Unregister from systems
-        m_physicsEngine->unregisterCharacter(m_players[playerId].get());
-        m_combatSystem->unregisterCharacter(m_players[playerId].get());
-        
-        // Remove player
+        m_combatSystem->ResetCombo(m_players[playerId]->GetId());
         m_players.erase(m_players.begin() + playerId);
-        
-        // Update remaining player indices
-        for (int i = playerId; i < m_players.size(); ++i) {
-            m_players[i]->setPlayerIndex(i);
-        }
     }
 }
 
@@ -211,17 +201,8 @@ void GameMode::enterState(MatchState newState) {
             break;
             
         case MatchState::InProgress:
-            // Enable player input
-            for (auto& player : m_players) {
-                player->setInputEnabled(true);
-            }
-            break;
-            
         case MatchState::RoundEnd:
-            // Disable player input
-            for (auto& player : m_players) {
-                player->setInputEnabled(false);
-            }
+            // handleInput only reaches characters while InProgress
             break;
             
         case MatchState::Paused:
@@ -238,7 +219,9 @@ void GameMode::exitState(MatchState oldState) {
 
 void GameMode::startRound() {
     setState(MatchState::RoundStart);
+#ifndef DFR_HEADLESS
     m_gameUI->setRoundNumber(m_currentRound + 1);
+#endif
 }
 
 void GameMode::endRound(int winnerId, WinCondition condition) {
@@ -248,11 +231,23 @@ void GameMode::endRound(int winnerId, WinCondition condition) {
     result.winType = condition;
     result.timeTaken = m_config.roundTime - m_roundTimer;
     
+    result.remainingHealth = 0.0f;
+    result.remainingMana = 0.0f;
+    result.maxCombo = 0;
+    result.damageDealt = 0.0f;
+    
     if (winnerId >= 0 && winnerId < m_players.size()) {
-        result.remainingHealth = m_players[winnerId]->getHealth();
-        result.remainingMana = m_players[winnerId]->getMana();
-        result.maxCombo = m_combatSystem->getMaxCombo(winnerId);
-        result.damageDealt = m_combatSystem->getTotalDamage(winnerId);
+        const CharacterBase& winner = *m_players[winnerId];
+        result.remainingHealth = winner.GetCurrentHealth();
+        result.remainingMana = winner.GetCurrentMana();
+        result.maxCombo = m_combatSystem->GetComboCount(winner.GetId());
+        
+        // Everything the other players lost this round
+        for (int i = 0; i < m_players.size(); ++i) {
+            if (i != winnerId) {
+                result.damageDealt += m_players[i]->GetMaxHealth() - m_players[i]->GetCurrentHealth();
+            }
+        }
     }
     
     m_roundResults.push_back(result);
@@ -268,7 +263,7 @@ void GameMode::endRound(int winnerId, WinCondition condition) {
 bool GameMode::checkWinConditions() {
     // Check for knockouts
     for (int i = 0; i < m_players.size(); ++i) {
-        if (m_players[i]->getHealth() <= 0) {
+        if (!m_players[i]->IsAlive()) {
             // Find the winner (other player in 1v1)
             int winner = (i == 0) ? 1 : 0;
             endRound(winner, WinCondition::Knockout);
@@ -285,8 +280,8 @@ int GameMode::calculateRoundWinner() {
     float maxHealth = 0;
     
     for (int i = 0; i < m_players.size(); ++i) {
-        if (m_players[i]->getHealth() > maxHealth) {
-            maxHealth = m_players[i]->getHealth();
+        if (m_players[i]->GetCurrentHealth() > maxHealth) {
+            maxHealth = m_players[i]->GetCurrentHealth();
             winner = i;
         }
     }
@@ -301,8 +296,10 @@ void GameMode::spawnPlayers() {
     
     for (int i = 0; i < m_players.size(); ++i) {
         float xPos = centerX + (i - 0.5f * (m_players.size() - 1)) * spacing;
-        m_players[i]->setPosition(XMFLOAT3(xPos, 0, 0));
-        m_players[i]->setFacingRight(i == 0);
+        RigidBody* body = m_players[i]->GetRigidBody();
+        body->position = DirectX::XMFLOAT3(xPos, 0, 0);
+        body->velocity = DirectX::XMFLOAT3(0, 0, 0);
+        m_players[i]->SetFacingDirection(i == 0 ? 1 : -1);
     }
 }
 
@@ -311,10 +308,10 @@ void GameMode::resetPlayerPositions() {
 }
 
 void GameMode::resetPlayerStats() {
+    // Initialize() refills health and mana and clears the state
     for (auto& player : m_players) {
-        player->setHealth(BASE_HEALTH);
-        player->setMana(BASE_MANA);
-        player->resetCombo();
+        player->Initialize();
+        m_combatSystem->ResetCombo(player->GetId());
     }
 }
 
@@ -327,7 +324,7 @@ bool GameMode::isMatchActive() const {
 void GameMode::handleInput(int playerId, const InputCommand& input) {
     if (m_currentState == MatchState::InProgress) {
         if (playerId >= 0 && playerId < m_players.size()) {
-            m_players[playerId]->handleInput(input);
+            applyInput(*m_players[playerId], input);
         }
     }
     
@@ -341,6 +338,63 @@ void GameMode::handleInput(int playerId, const InputCommand& input) {
     }
 }
 
+void GameMode::applyInput(CharacterBase& character, const InputCommand& input) {
+    // Forward and Back follow the way the character faces
+    float facing = static_cast<float>(character.GetFacingDirection());
+    float stickX = 0.0f;
+    float stickY = 0.0f;
+    switch (input.direction) {
+        case StickDirection::Forward: stickX = facing; break;
+        case StickDirection::Back:    stickX = -facing; break;
+        case StickDirection::Up:      stickY = 1.0f; break;
+        case StickDirection::Down:    stickY = -1.0f; break;
+        case StickDirection::Neutral: break;
+    }
+    
+    if (input.action != InputAction::Block && character.IsBlocking()) {
+        character.StopBlocking();
+    }
+    
+    switch (input.action) {
+        case InputAction::Move:
+            m_physicsEngine->ProcessCharacterMovement(&character, DirectX::XMFLOAT2(stickX, 0.0f),
+                                                      PhysicsEngine::FIXED_TIMESTEP);
+            break;
+            
+        case InputAction::Jump:
+            m_physicsEngine->ProcessJump(&character, Physics::Constants::JUMP_FORCE);
+            break;
+            
+        case InputAction::Dash:
+            m_physicsEngine->ProcessAirDash(&character, DirectX::XMFLOAT2(stickX != 0.0f ? stickX : facing, stickY));
+            break;
+            
+        case InputAction::Block:
+            character.Block();
+            break;
+            
+        case InputAction::Special: {
+            // S+Direction; the character's table is in screen directions
+            InputDirection direction = InputDirection::Neutral;
+            if (stickY > 0.0f) {
+                direction = InputDirection::Up;
+            } else if (stickY < 0.0f) {
+                direction = InputDirection::Down;
+            } else if (stickX > 0.0f) {
+                direction = InputDirection::Right;
+            } else if (stickX < 0.0f) {
+                direction = InputDirection::Left;
+            }
+            character.ExecuteSpecialMove(direction);
+            break;
+        }
+            
+        default:
+            // Normal attacks are resolved by the combat system from frame data
+            break;
+    }
+}
+
 void GameMode::pauseGame() {
     if (m_currentState == MatchState::InProgress) {
         setState(MatchState::Paused);
@@ -407,15 +461,17 @@ int GameMode::getWinsForPlayer(int playerId) const {
 }
 
 void GameMode::updateUI() {
+#ifndef DFR_HEADLESS
     // Update player health and mana
     for (int i = 0; i < m_players.size(); ++i) {
-        m_gameUI->updatePlayerHealth(i, m_players[i]->getHealth());
-        m_gameUI->updatePlayerMana(i, m_players[i]->getMana());
+        m_gameUI->updatePlayerHealth(i, m_players[i]->GetCurrentHealth());
+        m_gameUI->updatePlayerMana(i, m_players[i]->GetCurrentMana());
         
         // Update combo display
-        int combo = m_combatSystem->getCurrentCombo(i);
+        int combo = m_combatSystem->GetComboCount(m_players[i]->GetId());
         m_gameUI->updateCombo(i, combo);
     }
+#endif
 }
 
 } // namespace ArenaFighter
\ No newline at end of file
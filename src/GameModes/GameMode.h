@@ -7,7 +7,12 @@
 #include "../Combat/CombatSystem.h"
 #include "../Network/NetworkManager.h"
 #include "../Physics/PhysicsEngine.h"
+#include "InputCommand.h"
+#ifdef DFR_HEADLESS
+namespace ArenaFighter { class GameModeUI; }
+#else
 #include "../UI/GameModeUI.h"
+#endif
 
 namespace ArenaFighter {
 
@@ -108,6 +113,10 @@ protected:
     virtual void resetPlayerPositions();
     virtual void resetPlayerStats();
 
+    // Drives one character from a command: movement through the physics
+    // engine, block and special moves through the character
+    void applyInput(CharacterBase& character, const InputCommand& input);
+
 public:
     GameMode(const MatchConfig& config);
     virtual ~GameMode() = default;
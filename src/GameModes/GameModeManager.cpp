@@ -59,7 +59,7 @@ bool GameModeManager::changeGameMode(GameModeID newMode) {
             if (auto* settings = getModeSettings<SurvivalConfig>(newMode)) {
                 auto* survMode = dynamic_cast<SurvivalMode*>(newGameMode.get());
                 if (survMode) {
-                    survMode->setConfig(*settings);
+                    survMode->setSurvivalConfig(*settings);
                 }
             }
             break;
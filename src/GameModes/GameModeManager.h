@@ -25,9 +25,12 @@ private:
     
     // Singleton pattern
     static GameModeManager* s_instance;
-    GameModeManager() : m_currentModeId(GameModeID::SinglePlayer) {}
 
 public:
+    // The client uses the singleton; the dedicated server owns one manager
+    // per match
+    GameModeManager() : m_currentModeId(GameModeID::SinglePlayer) {}
+
     // Get singleton instance
     static GameModeManager* getInstance() {
         if (!s_instance) {
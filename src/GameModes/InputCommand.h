@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ArenaFighter {
+
+// What a player asked for this frame, after the input layer has read
+// the pad or the network
+enum class InputAction {
+    None,
+    Move,
+    Jump,
+    Dash,
+    Block,
+    LightAttack,
+    MediumAttack,
+    HeavyAttack,
+    Special,
+    Pause
+};
+
+// Stick direction relative to the way the character faces
+enum class StickDirection {
+    Neutral,
+    Up,
+    Down,
+    Forward,
+    Back
+};
+
+struct InputCommand {
+    InputAction action = InputAction::None;
+    StickDirection direction = StickDirection::Neutral;
+
+    // Menu-style commands (dungeon and spectator controls)
+    bool isSpecialCommand = false;
+    std::string command;
+};
+
+// Wire form for InputBuffer and InputPacket: the action in the low byte,
+// the stick direction in the next. Menu commands never leave the machine.
+inline uint32_t PackInput(const InputCommand& input) {
+    return static_cast<uint32_t>(input.action) |
+           (static_cast<uint32_t>(input.direction) << 8);
+}
+
+inline InputCommand UnpackInput(uint32_t mask) {
+    InputCommand input;
+    input.action = static_cast<InputAction>(mask & 0xFF);
+    input.direction = static_cast<StickDirection>((mask >> 8) & 0xFF);
+    return input;
+}
+
+} // namespace ArenaFighter
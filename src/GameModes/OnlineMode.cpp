@@ -1,5 +1,8 @@
 #include "OnlineMode.h"
+#include "../Core/DeterministicRandom.h"
+#include "../Network/InputBuffer.h"
 #include <algorithm>
+#include <cstddef>
 #include <cstring>
 
 namespace ArenaFighter {
@@ -12,8 +15,15 @@ OnlineMode::OnlineMode(bool isHost)
       m_remotePlayerId(isHost ? 1 : 0),
       m_pingTime(0.0f),
       m_lastSyncTime(0.0f),
+      m_port(DEFAULT_PORT),
+      m_rollbackEngine(*this),
+      m_rollbackStarted(false),
+      m_tickAccumulator(0.0f),
       m_currentFrame(0),
       m_confirmedFrame(0),
+      m_localInput(0),
+      m_nextInputFrame(0),
+      m_nextInputId(0),
       m_connectionQuality(1.0f),
       m_droppedPackets(0) {
     
@@ -27,19 +37,21 @@ OnlineMode::OnlineMode(bool isHost)
 void OnlineMode::initialize() {
     GameMode::initialize();
     
-    // Initialize network manager for online play
-    m_networkManager->initialize();
-    m_networkManager->setTickRate(60); // 60Hz update rate
-    m_networkManager->setSendRate(30); // 30Hz send rate
-    
-    // Set up rollback buffer
-    m_rollbackBuffer = std::queue<RollbackFrame>();
+    // Tick and send rates come from NetworkConfig
+    m_networkManager->Initialize();
+    m_networkManager->RegisterPacketHandler(
+        static_cast<uint16_t>(PacketType::PlayerStateUpdate),
+        [this](NetworkPacket* packet) { applyRemoteState(*static_cast<PlayerStatePacket*>(packet)); });
+    m_networkManager->SetOnPlayerDisconnected([this](uint32_t) { handleDisconnection(); });
     
     // Start in disconnected state
     m_onlineState = OnlineState::Disconnected;
 }
 
 void OnlineMode::update(float deltaTime) {
+    // Pump the socket; received packets reach their handlers here
+    m_networkManager->Update(deltaTime);
+    
     // Update network state
     updateNetworkState(deltaTime);
     
@@ -48,83 +60,195 @@ void OnlineMode::update(float deltaTime) {
         // Receive network data
         receiveSyncData();
         
-        // Update with rollback
-        m_currentFrame++;
-        
-        // Store current state for rollback
-        RollbackFrame currentFrame;
-        currentFrame.frameNumber = m_currentFrame;
-        currentFrame.gameState.frameNumber = m_currentFrame;
-        currentFrame.gameState.gameTime = m_stateTimer;
-        
-        // Capture game state before update
-        for (int i = 0; i < 2; ++i) {
-            if (i < m_players.size() && m_players[i]) {
-                currentFrame.gameState.positions[i] = m_players[i]->getPosition();
-                currentFrame.gameState.health[i] = m_players[i]->getHealth();
-                currentFrame.gameState.mana[i] = m_players[i]->getMana();
-                currentFrame.gameState.states[i] = m_players[i]->getCurrentState();
-            }
+        // A client only has the host's buffer once its first input arrives
+        if (!m_rollbackStarted) {
+            m_rollbackStarted = startRollback();
         }
         
-        // Add to rollback buffer
-        m_rollbackBuffer.push(currentFrame);
-        
-        // Limit rollback buffer size
-        while (m_rollbackBuffer.size() > MAX_ROLLBACK_FRAMES) {
-            m_rollbackBuffer.pop();
+        // Fixed ticks, stretched like NetworkManager's while a peer catches up
+        if (m_rollbackStarted) {
+            m_tickAccumulator += deltaTime;
+            const float tickInterval = m_networkManager->GetTickScale() / NetworkConfig::TICK_RATE;
+            while (m_tickAccumulator >= tickInterval) {
+                sendLocalInput();
+                m_rollbackEngine.AdvanceFrame();
+                m_tickAccumulator -= tickInterval;
+            }
+            m_currentFrame = static_cast<int>(m_rollbackEngine.GetCurrentFrame());
         }
         
-        // Update base game
-        GameMode::update(deltaTime);
-        
         // Send sync data
         m_lastSyncTime += deltaTime;
         if (m_lastSyncTime >= 1.0f / 30.0f) { // 30Hz send rate
             sendSyncData();
             m_lastSyncTime = 0.0f;
         }
-        
-        // Lag compensation
-        compensateForLag(deltaTime);
     }
 }
 
 void OnlineMode::shutdown() {
-    // Disconnect from match
-    if (m_onlineState != OnlineState::Disconnected) {
-        // Send disconnect packet
-        NetworkPacket packet;
-        packet.type = PacketType::Disconnect;
-        packet.timestamp = m_currentFrame;
-        m_networkManager->sendPacket(packet);
-    }
+    stopRollback();
     
-    // Clean up network
-    m_networkManager->shutdown();
+    // Disconnect() tells the peer before closing the socket
+    m_networkManager->Disconnect();
+    m_networkManager->Shutdown();
+    m_onlineState = OnlineState::Disconnected;
     
     GameMode::shutdown();
 }
 
 void OnlineMode::handleInput(int playerId, const InputCommand& input) {
     // Only handle local player input
-    if (playerId == m_localPlayerId) {
-        // Add to input buffer for sending
-        m_inputBuffer.push(input);
-        
-        // Apply input locally (with prediction)
+    if (playerId != m_localPlayerId) {
+        return;
+    }
+    
+    // Menu commands never go through the simulation
+    if (input.isSpecialCommand) {
         GameMode::handleInput(playerId, input);
-        
-        // Send input immediately for responsiveness
-        if (m_onlineState == OnlineState::InMatch) {
-            NetworkPacket packet;
-            packet.type = PacketType::Input;
-            packet.playerId = m_localPlayerId;
-            packet.timestamp = m_currentFrame;
-            packet.inputData = input;
-            m_networkManager->sendPacket(packet);
-        }
+        return;
+    }
+    
+    // Sent with the next tick; the engine applies it on its frame
+    m_localInput = PackInput(input);
+}
+
+void OnlineMode::sendLocalInput() {
+    // Every frame up to the delayed one gets an input, so a growing delay
+    // leaves no gaps; a shrinking one holds the input until it catches up
+    uint32_t targetFrame = m_rollbackEngine.GetCurrentFrame() +
+                           static_cast<uint32_t>(std::max(0, m_networkManager->GetInputDelay()));
+    if (targetFrame < m_nextInputFrame) {
+        return;
+    }
+    
+    for (uint32_t frame = m_nextInputFrame; frame <= targetFrame; ++frame) {
+        m_networkManager->SendInput(frame, m_localInput, m_nextInputId++);
     }
+    m_nextInputFrame = targetFrame + 1;
+    m_localInput = 0;
+}
+
+bool OnlineMode::startRollback() {
+    InputBuffer* buffers[2] = {m_networkManager->GetInputBuffer(0), m_networkManager->GetInputBuffer(1)};
+    if (!buffers[0] || !buffers[1]) {
+        return false;
+    }
+    
+    // Player slots match m_players: the host is player 0
+    m_rollbackEngine.ClearPlayers();
+    m_rollbackEngine.AddPlayer(buffers[0]);
+    m_rollbackEngine.AddPlayer(buffers[1]);
+    m_rollbackEngine.Reset(1);
+    m_rollbackEngine.AttachDesyncDetector(&m_networkManager->GetDesyncDetector());
+    m_networkManager->AttachRollbackEngine(&m_rollbackEngine);
+    
+    m_tickAccumulator = 0.0f;
+    m_localInput = 0;
+    m_nextInputFrame = 1;
+    m_currentFrame = 1;
+    m_confirmedFrame = 0;
+    return true;
+}
+
+void OnlineMode::stopRollback() {
+    // NetworkManager frees a peer's buffer when it leaves
+    m_networkManager->AttachRollbackEngine(nullptr);
+    m_rollbackEngine.AttachDesyncDetector(nullptr);
+    m_rollbackEngine.ClearPlayers();
+    m_rollbackStarted = false;
+}
+
+size_t OnlineMode::SaveState(uint8_t* buffer, size_t capacity) const {
+    if (capacity < sizeof(OnlineMatchState) || m_players.size() > 2) {
+        return 0;
+    }
+    
+    // Zeroed first: padding is hashed along with the fields
+    OnlineMatchState state;
+    std::memset(&state, 0, sizeof(state));
+    state.randomState = GetSimulationRandom().GetState();
+    state.matchState = static_cast<int32_t>(m_currentState);
+    state.currentRound = m_currentRound;
+    state.roundTimer = m_roundTimer;
+    state.stateTimer = m_stateTimer;
+    state.roundResultCount = static_cast<uint32_t>(m_roundResults.size());
+    state.playerCount = static_cast<uint32_t>(m_players.size());
+    
+    for (size_t i = 0; i < m_players.size(); ++i) {
+        const RigidBody* body = m_players[i]->GetRigidBody();
+        OnlineMatchState::Body& saved = state.bodies[i];
+        saved.position = body->position;
+        saved.velocity = body->velocity;
+        saved.acceleration = body->acceleration;
+        saved.mass = body->mass;
+        saved.isKinematic = body->isKinematic;
+        saved.isGrounded = body->isGrounded;
+        saved.useGravity = body->useGravity;
+        m_players[i]->SaveState(state.players[i]);
+    }
+    
+    std::memcpy(buffer, &state, sizeof(state));
+    return sizeof(state);
+}
+
+void OnlineMode::LoadState(const uint8_t* data, size_t size) {
+    if (size != sizeof(OnlineMatchState)) {
+        return;
+    }
+    
+    // Copied out: the blob carries no alignment guarantee
+    OnlineMatchState state;
+    std::memcpy(&state, data, sizeof(state));
+    if (state.playerCount != m_players.size()) {
+        return;
+    }
+    
+    GetSimulationRandom().SetState(state.randomState);
+    m_currentState = static_cast<MatchState>(state.matchState);
+    m_currentRound = state.currentRound;
+    m_roundTimer = state.roundTimer;
+    m_stateTimer = state.stateTimer;
+    if (state.roundResultCount < m_roundResults.size()) {
+        m_roundResults.resize(state.roundResultCount);
+    }
+    
+    for (size_t i = 0; i < m_players.size(); ++i) {
+        RigidBody* body = m_players[i]->GetRigidBody();
+        const OnlineMatchState::Body& saved = state.bodies[i];
+        body->position = saved.position;
+        body->velocity = saved.velocity;
+        body->acceleration = saved.acceleration;
+        body->mass = saved.mass;
+        body->isKinematic = saved.isKinematic != 0;
+        body->isGrounded = saved.isGrounded != 0;
+        body->useGravity = saved.useGravity != 0;
+        m_players[i]->LoadState(state.players[i]);
+    }
+}
+
+void OnlineMode::AdvanceFrame(const uint32_t* inputs, size_t playerCount) {
+    // Slots are player indices; both go through the base class, since the
+    // override only records local input
+    for (size_t i = 0; i < playerCount && i < m_players.size(); ++i) {
+        GameMode::handleInput(static_cast<int>(i), UnpackInput(inputs[i]));
+    }
+    
+    GameMode::update(PhysicsEngine::FIXED_TIMESTEP);
+}
+
+size_t OnlineMode::DescribeState(StateField* fields, size_t maxFields) const {
+    const StateField layout[] = {
+        {"random", offsetof(OnlineMatchState, randomState), sizeof(uint64_t)},
+        {"match", offsetof(OnlineMatchState, matchState), offsetof(OnlineMatchState, bodies) - offsetof(OnlineMatchState, matchState)},
+        {"bodies[0]", offsetof(OnlineMatchState, bodies), sizeof(OnlineMatchState::Body)},
+        {"bodies[1]", offsetof(OnlineMatchState, bodies) + sizeof(OnlineMatchState::Body), sizeof(OnlineMatchState::Body)},
+        {"players[0]", offsetof(OnlineMatchState, players), sizeof(CharacterSnapshot)},
+        {"players[1]", offsetof(OnlineMatchState, players) + sizeof(CharacterSnapshot), sizeof(CharacterSnapshot)},
+    };
+    size_t count = std::min(maxFields, sizeof(layout) / sizeof(layout[0]));
+    std::copy(layout, layout + count, fields);
+    return count;
 }
 
 void OnlineMode::updateNetworkState(float deltaTime) {
@@ -147,17 +271,11 @@ void OnlineMode::updateNetworkState(float deltaTime) {
             break;
             
         case OnlineState::Connecting:
-            // Establish connection
-            if (m_isHost) {
-                if (m_networkManager->hasIncomingConnection()) {
-                    m_onlineState = OnlineState::Syncing;
-                    m_stateTimer = 0.0f;
-                }
-            } else {
-                if (m_networkManager->isConnected()) {
-                    m_onlineState = OnlineState::Syncing;
-                    m_stateTimer = 0.0f;
-                }
+            // The host waits for a client; a client for the host's reply
+            if (m_isHost ? m_networkManager->GetPlayerCount() >= 2
+                         : m_networkManager->GetConnectionState() != ConnectionState::Connecting) {
+                m_onlineState = OnlineState::Syncing;
+                m_stateTimer = 0.0f;
             }
             
             // Timeout after 30 seconds
@@ -212,150 +330,54 @@ void OnlineMode::updateNetworkState(float deltaTime) {
 }
 
 void OnlineMode::sendSyncData() {
-    NetworkPacket packet;
-    packet.type = PacketType::GameState;
-    packet.playerId = m_localPlayerId;
-    packet.timestamp = m_currentFrame;
-    
-    // Pack sync data
-    SyncData& sync = packet.syncData;
-    sync.frameNumber = m_currentFrame;
-    sync.gameTime = m_roundTimer;
-    
-    // Add player states
-    if (m_localPlayerId < m_players.size() && m_players[m_localPlayerId]) {
-        auto& player = m_players[m_localPlayerId];
-        sync.positions[m_localPlayerId] = player->getPosition();
-        sync.health[m_localPlayerId] = player->getHealth();
-        sync.mana[m_localPlayerId] = player->getMana();
-        sync.states[m_localPlayerId] = player->getCurrentState();
-    }
-    
-    // Send packet
-    m_networkManager->sendPacket(packet);
-}
-
-void OnlineMode::receiveSyncData() {
-    NetworkPacket packet;
-    while (m_networkManager->receivePacket(packet)) {
-        m_lastPacketTime = std::chrono::steady_clock::now();
-        
-        switch (packet.type) {
-            case PacketType::Input:
-                // Process remote input
-                if (packet.playerId == m_remotePlayerId) {
-                    m_lastRemoteInput = packet.inputData;
-                    
-                    // Check if we need to rollback
-                    if (packet.timestamp < m_currentFrame) {
-                        performRollback(packet.timestamp);
-                    }
-                    
-                    // Apply input
-                    GameMode::handleInput(m_remotePlayerId, packet.inputData);
-                }
-                break;
-                
-            case PacketType::GameState:
-                // Validate and sync state
-                if (packet.playerId == m_remotePlayerId) {
-                    const SyncData& remoteSync = packet.syncData;
-                    
-                    // Update remote player state
-                    if (m_remotePlayerId < m_players.size() && m_players[m_remotePlayerId]) {
-                        auto& remotePlayer = m_players[m_remotePlayerId];
-                        
-                        // Interpolate position for smoothness
-                        XMFLOAT3 targetPos = remoteSync.positions[m_remotePlayerId];
-                        XMFLOAT3 currentPos = remotePlayer->getPosition();
-                        
-                        // Simple lerp
-                        float lerpFactor = 0.5f;
-                        XMFLOAT3 newPos;
-                        newPos.x = currentPos.x + (targetPos.x - currentPos.x) * lerpFactor;
-                        newPos.y = currentPos.y + (targetPos.y - currentPos.y) * lerpFactor;
-                        newPos.z = currentPos.z + (targetPos.z - currentPos.z) * lerpFactor;
-                        
-                        remotePlayer->setPosition(newPos);
-                        remotePlayer->setHealth(remoteSync.health[m_remotePlayerId]);
-                        remotePlayer->setMana(remoteSync.mana[m_remotePlayerId]);
-                    }
-                    
-                    // Update confirmed frame
-                    m_confirmedFrame = std::max(m_confirmedFrame, remoteSync.frameNumber);
-                }
-                break;
-                
-            case PacketType::Disconnect:
-                handleDisconnection();
-                break;
-        }
-        
-        // Calculate ping
-        m_pingTime = m_networkManager->getPing();
-    }
-}
-
-void OnlineMode::performRollback(int toFrame) {
-    // Find the frame to rollback to
-    std::queue<RollbackFrame> tempQueue;
-    RollbackFrame* targetFrame = nullptr;
-    
-    while (!m_rollbackBuffer.empty()) {
-        RollbackFrame& frame = m_rollbackBuffer.front();
-        if (frame.frameNumber == toFrame) {
-            targetFrame = &frame;
-            break;
-        }
-        tempQueue.push(frame);
-        m_rollbackBuffer.pop();
-    }
-    
-    if (!targetFrame) {
-        // Can't rollback that far
+    if (m_localPlayerId >= m_players.size() || !m_players[m_localPlayerId]) {
         return;
     }
     
-    // Restore game state
-    for (int i = 0; i < 2; ++i) {
-        if (i < m_players.size() && m_players[i]) {
-            m_players[i]->setPosition(targetFrame->gameState.positions[i]);
-            m_players[i]->setHealth(targetFrame->gameState.health[i]);
-            m_players[i]->setMana(targetFrame->gameState.mana[i]);
-        }
-    }
+    // Delta-compressed against the last snapshot the peer acked
+    auto& player = m_players[m_localPlayerId];
+    PlayerStatePacket state;
+    state.playerId = m_localPlayerId;
+    const DirectX::XMFLOAT3& position = player->GetRigidBody()->position;
+    const DirectX::XMFLOAT3& velocity = player->GetRigidBody()->velocity;
+    state.position[0] = position.x;
+    state.position[1] = position.y;
+    state.position[2] = position.z;
+    state.velocity[0] = velocity.x;
+    state.velocity[1] = velocity.y;
+    state.velocity[2] = velocity.z;
+    state.rotation = 0.0f;
+    state.state = static_cast<uint16_t>(player->GetCurrentState());
+    state.health = static_cast<uint16_t>(player->GetCurrentHealth());
+    state.mana = static_cast<uint8_t>(player->GetCurrentMana());
+    state.currentGear = 0;
     
-    // Re-simulate frames
-    int framesToSimulate = m_currentFrame - toFrame;
-    for (int i = 0; i < framesToSimulate; ++i) {
-        // Update with stored/predicted inputs
-        GameMode::update(1.0f / 60.0f); // Fixed timestep
-    }
+    m_networkManager->SendPlayerState(state);
 }
 
-void OnlineMode::compensateForLag(float deltaTime) {
-    // Simple lag compensation
-    float lagCompensation = m_pingTime * 0.001f; // Convert to seconds
-    
-    // Predict ahead based on ping
-    if (m_localPlayerId < m_players.size() && m_players[m_localPlayerId]) {
-        // Local player prediction already handled by immediate input
+void OnlineMode::receiveSyncData() {
+    // Packets were dispatched in NetworkManager::Update and remote inputs
+    // went straight into the buffers RollbackEngine reads
+    InputBuffer* remoteInputs = m_networkManager->GetInputBuffer(m_remotePlayerId);
+    if (remoteInputs) {
+        m_confirmedFrame = static_cast<int>(remoteInputs->GetContiguousFrame());
     }
     
-    // Interpolate remote player
-    interpolateRemotePlayer(deltaTime);
+    m_pingTime = static_cast<float>(m_networkManager->GetNetworkStats().ping);
 }
 
-void OnlineMode::interpolateRemotePlayer(float deltaTime) {
-    // Smooth remote player movement
-    if (m_remotePlayerId < m_players.size() && m_players[m_remotePlayerId]) {
-        // Interpolation handled in receiveSyncData for now
-        // Could be expanded with more sophisticated interpolation
+void OnlineMode::applyRemoteState(const PlayerStatePacket& state) {
+    // The match is simulated from inputs alone; writing the peer's state
+    // into it would break resimulation, so state updates only show the
+    // connection is alive
+    if (static_cast<int>(state.playerId) == m_remotePlayerId) {
+        m_lastPacketTime = std::chrono::steady_clock::now();
     }
 }
 
 void OnlineMode::handleDisconnection() {
     m_onlineState = OnlineState::Disconnected;
+    stopRollback();
     
     // Pause the game
     if (m_currentState == MatchState::InProgress) {
@@ -367,24 +389,21 @@ void OnlineMode::handleDisconnection() {
 }
 
 void OnlineMode::attemptReconnection() {
-    // Try to reconnect to the match
-    if (m_networkManager->attemptReconnect()) {
+    // Only a client can dial back in; the host keeps listening
+    if (m_isHost || m_hostAddress.empty()) {
+        return;
+    }
+    
+    m_networkManager->Disconnect();
+    if (m_networkManager->ConnectToHost(m_hostAddress, m_port)) {
         m_onlineState = OnlineState::Syncing;
         m_stateTimer = 0.0f;
     }
 }
 
 void OnlineMode::resyncGameState() {
-    // Full state synchronization
-    NetworkPacket packet;
-    packet.type = PacketType::FullSync;
-    packet.playerId = m_localPlayerId;
-    packet.timestamp = m_currentFrame;
-    
-    // Pack complete game state
-    // This would include all necessary data to restore the match
-    
-    m_networkManager->sendReliablePacket(packet);
+    // A full snapshot goes out while no baseline has been acked yet
+    sendSyncData();
 }
 
 void OnlineMode::startMatchmaking() {
@@ -405,26 +424,29 @@ void OnlineMode::cancelMatchmaking() {
     }
 }
 
-void OnlineMode::connectToHost(const std::string& hostAddress) {
+void OnlineMode::connectToHost(const std::string& hostAddress, int port) {
     if (m_onlineState == OnlineState::Disconnected) {
         m_isHost = false;
         m_localPlayerId = 1;
         m_remotePlayerId = 0;
+        m_hostAddress = hostAddress;
+        m_port = port;
         
-        if (m_networkManager->connectTo(hostAddress)) {
+        if (m_networkManager->ConnectToHost(hostAddress, port)) {
             m_onlineState = OnlineState::Connecting;
             m_stateTimer = 0.0f;
         }
     }
 }
 
-void OnlineMode::hostMatch() {
+void OnlineMode::hostMatch(int port) {
     if (m_onlineState == OnlineState::Disconnected) {
         m_isHost = true;
         m_localPlayerId = 0;
         m_remotePlayerId = 1;
+        m_port = port;
         
-        if (m_networkManager->startHosting()) {
+        if (m_networkManager->StartHost(port)) {
             m_onlineState = OnlineState::Connecting;
             m_stateTimer = 0.0f;
         }
@@ -438,8 +460,7 @@ bool OnlineMode::isConnected() const {
 }
 
 void OnlineMode::setMaxRollbackFrames(int frames) {
-    // Would adjust rollback buffer size
-    // Limited to MAX_ROLLBACK_FRAMES
+    // The engine's ring is sized by NetworkConfig::MAX_ROLLBACK_FRAMES
 }
 
 int OnlineMode::getCurrentDelay() const {
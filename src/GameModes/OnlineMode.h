@@ -2,7 +2,7 @@
 
 #include "GameMode.h"
 #include "../Network/NetworkManager.h"
-#include <queue>
+#include "../Network/RollbackEngine.h"
 #include <chrono>
 
 namespace ArenaFighter {
@@ -18,25 +18,34 @@ enum class OnlineState {
     Reconnecting    // Attempting to reconnect
 };
 
-// Network synchronization data
-struct SyncData {
-    int frameNumber;
-    float gameTime;
-    InputCommand inputs[2];
-    XMFLOAT3 positions[2];
-    float health[2];
-    float mana[2];
-    CharacterState states[2];
-};
+// Everything one match tick can change, as the flat blob RollbackEngine
+// snapshots. Rigid bodies belong to the characters but are not part of
+// CharacterSnapshot, so they are stored next to it.
+struct OnlineMatchState {
+    struct Body {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT3 velocity;
+        DirectX::XMFLOAT3 acceleration;
+        float mass;
+        int32_t isKinematic;
+        int32_t isGrounded;
+        int32_t useGravity;
+    };
 
-// Rollback data for lag compensation
-struct RollbackFrame {
-    int frameNumber;
-    SyncData gameState;
-    std::vector<InputCommand> confirmedInputs;
+    uint64_t randomState;
+    int32_t matchState;
+    int32_t currentRound;
+    float roundTimer;
+    float stateTimer;
+    uint32_t roundResultCount;    // Results are only ever appended
+    uint32_t playerCount;
+    Body bodies[2];
+    CharacterSnapshot players[2];
 };
 
-class OnlineMode : public GameMode {
+// The match itself is the rollback simulation: RollbackEngine saves it
+// every tick and replays it from the inputs in NetworkManager's buffers.
+class OnlineMode : public GameMode, public RollbackSimulation {
 private:
     OnlineState m_onlineState;
     
@@ -46,16 +55,20 @@ private:
     int m_remotePlayerId;
     float m_pingTime;
     float m_lastSyncTime;
+    std::string m_hostAddress;
+    int m_port;
     
     // Rollback netcode
-    static constexpr int MAX_ROLLBACK_FRAMES = 7;
-    std::queue<RollbackFrame> m_rollbackBuffer;
+    RollbackEngine m_rollbackEngine;
+    bool m_rollbackStarted;
+    float m_tickAccumulator;
     int m_currentFrame;
     int m_confirmedFrame;
     
-    // Input prediction
-    std::queue<InputCommand> m_inputBuffer;
-    InputCommand m_lastRemoteInput;
+    // Local input, sent GetInputDelay() frames ahead of the simulation
+    uint32_t m_localInput;
+    uint32_t m_nextInputFrame;
+    uint16_t m_nextInputId;
     
     // Connection quality
     float m_connectionQuality;
@@ -65,23 +78,24 @@ private:
     // Synchronization methods
     void sendSyncData();
     void receiveSyncData();
-    void performRollback(int toFrame);
-    void predictInput(int playerId);
+    void applyRemoteState(const PlayerStatePacket& state);
+    void sendLocalInput();
+    
+    // Rollback
+    bool startRollback();
+    void stopRollback();
     
     // Network state management
     void updateNetworkState(float deltaTime);
     void handleDisconnection();
     void attemptReconnection();
     
-    // Lag compensation
-    void compensateForLag(float deltaTime);
-    void interpolateRemotePlayer(float deltaTime);
-    
     // Match validation
-    bool validateGameState(const SyncData& local, const SyncData& remote);
     void resyncGameState();
 
 public:
+    static constexpr int DEFAULT_PORT = 7777;
+    
     OnlineMode(bool isHost = false);
     virtual ~OnlineMode() = default;
     
@@ -91,6 +105,12 @@ public:
     void shutdown() override;
     void handleInput(int playerId, const InputCommand& input) override;
     
+    // RollbackSimulation: one fixed tick of the match per frame
+    size_t SaveState(uint8_t* buffer, size_t capacity) const override;
+    void LoadState(const uint8_t* data, size_t size) override;
+    void AdvanceFrame(const uint32_t* inputs, size_t playerCount) override;
+    size_t DescribeState(StateField* fields, size_t maxFields) const override;
+    
     // Network setup
     void setLocalPlayer(int playerId) { m_localPlayerId = playerId; }
     void setRemotePlayer(int playerId) { m_remotePlayerId = playerId; }
@@ -99,8 +119,8 @@ public:
     // Connection management
     void startMatchmaking();
     void cancelMatchmaking();
-    void connectToHost(const std::string& hostAddress);
-    void hostMatch();
+    void connectToHost(const std::string& hostAddress, int port = DEFAULT_PORT);
+    void hostMatch(int port = DEFAULT_PORT);
     
     // Network status
     OnlineState getOnlineState() const { return m_onlineState; }
@@ -110,7 +130,7 @@ public:
     
     // Mode specific implementations
     std::string getModeName() const override { return "Online"; }
-    GameModeType getModeType() const override { return GameModeType::Ranked1v1; }
+    GameModeType getModeType() const override { return GameModeType::Versus; }
     bool supportsOnline() const override { return true; }
     int getMinPlayers() const override { return 2; }
     int getMaxPlayers() const override { return 2; }
@@ -118,6 +138,7 @@ public:
     // Rollback controls
     void setMaxRollbackFrames(int frames);
     int getCurrentDelay() const;
+    const RollbackStats& getRollbackStats() const { return m_rollbackEngine.GetStats(); }
 };
 
 } // namespace ArenaFighter
\ No newline at end of file
@@ -1,13 +1,9 @@
 #include "SinglePlayerMode.h"
-#include <random>
+#include "../Core/DeterministicRandom.h"
 #include <algorithm>
 
 namespace ArenaFighter {
 
-// Random number generator for AI decisions
-static std::mt19937 s_rng(std::random_device{}());
-static std::uniform_real_distribution<float> s_dist(0.0f, 1.0f);
-
 SinglePlayerMode::SinglePlayerMode(AIDifficulty difficulty)
     : GameMode(MatchConfig()),
       m_difficulty(difficulty),
@@ -97,7 +93,7 @@ void SinglePlayerMode::updateAI(float deltaTime) {
         m_aiState.behaviorTimer = 0.0f;
         
         // Random behavior change
-        float roll = s_dist(s_rng);
+        float roll = GetSimulationRandom().NextFloat();
         if (roll < 0.3f) {
             m_aiState.currentBehavior = AIBehavior::Aggressive;
         } else if (roll < 0.6f) {
@@ -171,7 +167,7 @@ InputCommand SinglePlayerMode::calculateAIInput() {
         case AIBehavior::Random:
             // Completely random actions
             {
-                float roll = s_dist(s_rng);
+                float roll = GetSimulationRandom().NextFloat();
                 if (roll < 0.4f) {
                     input = getAttackInput();
                 } else if (roll < 0.6f) {
@@ -188,19 +184,19 @@ InputCommand SinglePlayerMode::calculateAIInput() {
 
 bool SinglePlayerMode::shouldAttack() const {
     float distance = getDistanceToPlayer();
-    float mana = m_aiCharacter->getMana();
+    float mana = m_aiCharacter->GetCurrentMana();
     
     // Check attack conditions
     bool inRange = distance < 150.0f; // Close combat range
     bool hasMana = mana >= 20.0f; // Minimum for special moves
-    bool aggressive = s_dist(s_rng) < m_aiState.aggressiveness;
+    bool aggressive = GetSimulationRandom().NextFloat() < m_aiState.aggressiveness;
     
     return inRange && hasMana && aggressive;
 }
 
 bool SinglePlayerMode::shouldDefend() const {
     bool playerAttacking = isPlayerAttacking();
-    bool defensive = s_dist(s_rng) < m_aiState.defensiveness;
+    bool defensive = GetSimulationRandom().NextFloat() < m_aiState.defensiveness;
     
     return playerAttacking && defensive;
 }
@@ -208,19 +204,19 @@ bool SinglePlayerMode::shouldDefend() const {
 bool SinglePlayerMode::shouldUseSkill(int skillIndex) const {
     // Check mana efficiency
     float manaCost = 20.0f + (skillIndex * 10.0f); // Example costs
-    float currentMana = m_aiCharacter->getMana();
+    float currentMana = m_aiCharacter->GetCurrentMana();
     
     if (currentMana < manaCost) {
         return false;
     }
     
     // Use skills based on mana efficiency setting
-    return s_dist(s_rng) < m_aiState.manaEfficiency;
+    return GetSimulationRandom().NextFloat() < m_aiState.manaEfficiency;
 }
 
 bool SinglePlayerMode::canStartCombo() const {
     // Check if AI should attempt a combo
-    return s_dist(s_rng) < m_aiState.comboAccuracy;
+    return GetSimulationRandom().NextFloat() < m_aiState.comboAccuracy;
 }
 
 InputCommand SinglePlayerMode::getAttackInput() {
@@ -228,27 +224,27 @@ InputCommand SinglePlayerMode::getAttackInput() {
     
     if (canStartCombo()) {
         // Attempt combo sequence
-        int comboType = static_cast<int>(s_dist(s_rng) * 3);
+        int comboType = static_cast<int>(GetSimulationRandom().NextFloat() * 3);
         
         switch (comboType) {
             case 0: // Light combo
                 input.action = InputAction::LightAttack;
-                input.direction = InputDirection::Neutral;
+                input.direction = StickDirection::Neutral;
                 break;
                 
             case 1: // Medium combo
                 input.action = InputAction::MediumAttack;
-                input.direction = InputDirection::Forward;
+                input.direction = StickDirection::Forward;
                 break;
                 
             case 2: // Heavy combo
                 input.action = InputAction::HeavyAttack;
-                input.direction = InputDirection::Down;
+                input.direction = StickDirection::Down;
                 break;
         }
     } else {
         // Random attack
-        float roll = s_dist(s_rng);
+        float roll = GetSimulationRandom().NextFloat();
         if (roll < 0.5f) {
             input.action = InputAction::LightAttack;
         } else if (roll < 0.8f) {
@@ -270,13 +266,13 @@ InputCommand SinglePlayerMode::getDefenseInput() {
     InputCommand input;
     
     // Block or evade
-    float roll = s_dist(s_rng);
+    float roll = GetSimulationRandom().NextFloat();
     if (roll < 0.7f) {
         input.action = InputAction::Block;
-        input.direction = InputDirection::Back;
+        input.direction = StickDirection::Back;
     } else {
         input.action = InputAction::Dash;
-        input.direction = (roll < 0.85f) ? InputDirection::Back : InputDirection::Forward;
+        input.direction = (roll < 0.85f) ? StickDirection::Back : StickDirection::Forward;
     }
     
     return input;
@@ -290,21 +286,21 @@ InputCommand SinglePlayerMode::getMovementInput() {
     if (distance > 200.0f) {
         // Move closer
         input.action = InputAction::Move;
-        input.direction = (m_playerCharacter->getPosition().x < m_aiCharacter->getPosition().x) 
-                          ? InputDirection::Back : InputDirection::Forward;
+        input.direction = (m_playerCharacter->GetRigidBody()->position.x < m_aiCharacter->GetRigidBody()->position.x) 
+                          ? StickDirection::Back : StickDirection::Forward;
         
         // Dash if far
-        if (distance > 400.0f && s_dist(s_rng) < 0.5f) {
+        if (distance > 400.0f && GetSimulationRandom().NextFloat() < 0.5f) {
             input.action = InputAction::Dash;
         }
     } else if (distance < 100.0f) {
         // Too close, create space
         input.action = InputAction::Move;
-        input.direction = (m_playerCharacter->getPosition().x < m_aiCharacter->getPosition().x) 
-                          ? InputDirection::Forward : InputDirection::Back;
+        input.direction = (m_playerCharacter->GetRigidBody()->position.x < m_aiCharacter->GetRigidBody()->position.x) 
+                          ? StickDirection::Forward : StickDirection::Back;
     } else {
         // Optimal range, neutral or jump
-        if (s_dist(s_rng) < 0.3f) {
+        if (GetSimulationRandom().NextFloat() < 0.3f) {
             input.action = InputAction::Jump;
         }
     }
@@ -317,8 +313,8 @@ float SinglePlayerMode::getDistanceToPlayer() const {
         return 0.0f;
     }
     
-    XMFLOAT3 playerPos = m_playerCharacter->getPosition();
-    XMFLOAT3 aiPos = m_aiCharacter->getPosition();
+    DirectX::XMFLOAT3 playerPos = m_playerCharacter->GetRigidBody()->position;
+    DirectX::XMFLOAT3 aiPos = m_aiCharacter->GetRigidBody()->position;
     
     return std::abs(playerPos.x - aiPos.x);
 }
@@ -328,9 +324,8 @@ bool SinglePlayerMode::isPlayerAttacking() const {
         return false;
     }
     
-    CharacterState state = m_playerCharacter->getCurrentState();
-    return state == CharacterState::Attacking || 
-           state == CharacterState::Special;
+    CharacterState state = m_playerCharacter->GetCurrentState();
+    return state == CharacterState::ExecutingSpecial;
 }
 
 bool SinglePlayerMode::isPlayerVulnerable() const {
@@ -338,10 +333,10 @@ bool SinglePlayerMode::isPlayerVulnerable() const {
         return false;
     }
     
-    CharacterState state = m_playerCharacter->getCurrentState();
-    return state == CharacterState::Recovery || 
-           state == CharacterState::Stunned ||
-           state == CharacterState::Falling;
+    CharacterState state = m_playerCharacter->GetCurrentState();
+    return state == CharacterState::HitStun || 
+           state == CharacterState::KnockedDown ||
+           state == CharacterState::GettingUp;
 }
 
 float SinglePlayerMode::predictPlayerPosition(float time) const {
@@ -350,8 +345,8 @@ float SinglePlayerMode::predictPlayerPosition(float time) const {
     }
     
     // Simple linear prediction
-    XMFLOAT3 pos = m_playerCharacter->getPosition();
-    XMFLOAT3 vel = m_playerCharacter->getVelocity();
+    DirectX::XMFLOAT3 pos = m_playerCharacter->GetRigidBody()->position;
+    DirectX::XMFLOAT3 vel = m_playerCharacter->GetRigidBody()->velocity;
     
     return pos.x + (vel.x * time);
 }
@@ -383,8 +378,7 @@ void SinglePlayerMode::setAICharacter(std::shared_ptr<CharacterBase> character)
         m_players[1] = character;
     }
     
-    // Mark as AI controlled
-    character->setAIControlled(true);
+    // updateAI() feeds this slot instead of a pad
 }
 
 } // namespace ArenaFighter
\ No newline at end of file
@@ -84,7 +84,7 @@ public:
     
     // Mode specific implementations
     std::string getModeName() const override { return "Single Player"; }
-    GameModeType getModeType() const override { return GameModeType::Ranked1v1; }
+    GameModeType getModeType() const override { return GameModeType::Versus; }
     bool supportsOnline() const override { return false; }
     int getMinPlayers() const override { return 2; } // Player + AI
     int getMaxPlayers() const override { return 2; }
@@ -1,11 +1,18 @@
 #include "SurvivalMode.h"
+#include "../Core/DeterministicRandom.h"
 #include <algorithm>
-#include <random>
 
 namespace ArenaFighter {
 
-static std::mt19937 s_rng(std::random_device{}());
-static std::uniform_real_distribution<float> s_dist(0.0f, 1.0f);
+namespace {
+
+// Wave grunt: base stats only, scaled by setupEnemy()
+class SurvivalEnemy : public CharacterBase {
+public:
+    SurvivalEnemy() : CharacterBase("Survival Enemy", CharacterCategory::Monsters) {}
+};
+
+} // namespace
 
 SurvivalMode::SurvivalMode(const SurvivalConfig& config)
     : GameMode(MatchConfig()),
@@ -48,19 +55,16 @@ void SurvivalMode::update(float deltaTime) {
     m_survivalStats.survivalTime += deltaTime;
     
     // Update physics and combat
-    m_physicsEngine->update(deltaTime);
-    m_combatSystem->update(deltaTime);
+    m_physicsEngine->Update(deltaTime);
+    m_combatSystem->Update(deltaTime);
     
     // Update player
     if (m_player) {
-        m_player->update(deltaTime);
-        
-        // Regenerate mana
-        float currentMana = m_player->getMana();
-        m_player->setMana(std::min(currentMana + MANA_REGEN_RATE * deltaTime, m_playerMaxMana));
+        // Mana regenerates in Update()
+        m_player->Update(deltaTime);
         
         // Check if player is defeated
-        if (m_player->getHealth() <= 0) {
+        if (m_player->GetCurrentHealth() <= 0) {
             endMatch();
             return;
         }
@@ -68,8 +72,8 @@ void SurvivalMode::update(float deltaTime) {
     
     // Update enemies
     for (auto& enemy : m_waveEnemies) {
-        if (enemy && enemy->getHealth() > 0) {
-            enemy->update(deltaTime);
+        if (enemy && enemy->GetCurrentHealth() > 0) {
+            enemy->Update(deltaTime);
         }
     }
     
@@ -159,7 +163,7 @@ WaveInfo SurvivalMode::generateWave(int waveNumber) {
         };
         
         for (int i = 0; i < wave.enemyCount; ++i) {
-            int index = static_cast<int>(s_dist(s_rng) * possibleEnemies.size());
+            int index = static_cast<int>(GetSimulationRandom().NextFloat() * possibleEnemies.size());
             wave.enemyTypes.push_back(possibleEnemies[index]);
         }
     }
@@ -176,25 +180,18 @@ void SurvivalMode::spawnWaveEnemies() {
     
     for (int i = 0; i < m_currentWaveInfo.enemyCount; ++i) {
         // Create enemy character (would use CharacterFactory)
-        auto enemy = std::make_shared<CharacterBase>();
+        auto enemy = std::make_shared<SurvivalEnemy>();
         
         // Setup enemy with appropriate difficulty
         setupEnemy(enemy, m_currentWaveInfo.difficultyMultiplier);
         
         // Position enemy
         float xPos = baseX + (i * spacing);
-        enemy->setPosition(XMFLOAT3(xPos, 0, 0));
-        enemy->setFacingRight(false);
+        enemy->GetRigidBody()->position = DirectX::XMFLOAT3(xPos, 0, 0);
+        enemy->SetFacingDirection(-1);
         
-        // Mark as AI controlled
-        enemy->setAIControlled(true);
-        
-        // Add to wave
+        // Add to wave; the wave AI drives it
         m_waveEnemies.push_back(enemy);
-        
-        // Register with systems
-        m_physicsEngine->registerCharacter(enemy.get());
-        m_combatSystem->registerCharacter(enemy.get());
     }
 }
 
@@ -203,9 +200,9 @@ void SurvivalMode::setupEnemy(std::shared_ptr<CharacterBase> enemy, float diffic
     float healthMultiplier = 0.7f + (difficulty * 0.3f); // 70% to 130%+ health
     float damageMultiplier = 0.8f + (difficulty * 0.2f); // 80% to 120%+ damage
     
-    enemy->setMaxHealth(BASE_HEALTH * healthMultiplier);
-    enemy->setHealth(BASE_HEALTH * healthMultiplier);
-    enemy->setMana(BASE_MANA);
+    enemy->SetMaxHealth(BASE_HEALTH * healthMultiplier);
+    enemy->SetHealth(BASE_HEALTH * healthMultiplier);
+    enemy->SetMana(BASE_MANA);
     
     // Set AI difficulty based on wave
     // Higher waves = smarter AI
@@ -215,10 +212,10 @@ void SurvivalMode::updatePowerUps(float deltaTime) {
     // Spawn power-ups periodically
     m_nextPowerUpTime -= deltaTime;
     if (m_nextPowerUpTime <= 0 && m_survivalConfig.allowHealthItems) {
-        if (s_dist(s_rng) < 0.3f) { // 30% chance
+        if (GetSimulationRandom().NextFloat() < 0.3f) { // 30% chance
             spawnPowerUp();
         }
-        m_nextPowerUpTime = 10.0f + s_dist(s_rng) * 20.0f; // 10-30 seconds
+        m_nextPowerUpTime = 10.0f + GetSimulationRandom().NextFloat() * 20.0f; // 10-30 seconds
     }
     
     // Update active power-ups
@@ -233,7 +230,7 @@ void SurvivalMode::updatePowerUps(float deltaTime) {
         
         // Check collection
         if (m_player) {
-            XMFLOAT3 playerPos = m_player->getPosition();
+            DirectX::XMFLOAT3 playerPos = m_player->GetRigidBody()->position;
             float distance = std::abs(playerPos.x - powerUp.position.x);
             
             if (distance < 50.0f && std::abs(playerPos.y - powerUp.position.y) < 100.0f) {
@@ -254,10 +251,10 @@ void SurvivalMode::spawnPowerUp() {
     PowerUp powerUp;
     
     // Random type based on player needs
-    float healthPercent = m_player ? m_player->getHealth() / m_playerMaxHealth : 1.0f;
-    float manaPercent = m_player ? m_player->getMana() / m_playerMaxMana : 1.0f;
+    float healthPercent = m_player ? m_player->GetCurrentHealth() / m_playerMaxHealth : 1.0f;
+    float manaPercent = m_player ? m_player->GetCurrentMana() / m_playerMaxMana : 1.0f;
     
-    float roll = s_dist(s_rng);
+    float roll = GetSimulationRandom().NextFloat();
     if (healthPercent < 0.3f && roll < 0.5f) {
         powerUp.type = PowerUpType::Health;
         powerUp.value = 0.3f; // 30% health
@@ -266,7 +263,7 @@ void SurvivalMode::spawnPowerUp() {
         powerUp.value = 0.5f; // 50% mana
     } else if (roll < 0.85f) {
         // Random buff
-        int buffType = static_cast<int>(s_dist(s_rng) * 3);
+        int buffType = static_cast<int>(GetSimulationRandom().NextFloat() * 3);
         switch (buffType) {
             case 0: powerUp.type = PowerUpType::Damage; break;
             case 1: powerUp.type = PowerUpType::Speed; break;
@@ -280,7 +277,7 @@ void SurvivalMode::spawnPowerUp() {
     }
     
     // Random position in arena
-    powerUp.position = XMFLOAT3(-300.0f + s_dist(s_rng) * 600.0f, 50.0f, 0);
+    powerUp.position = DirectX::XMFLOAT3(-300.0f + GetSimulationRandom().NextFloat() * 600.0f, 50.0f, 0);
     powerUp.lifetime = 15.0f; // 15 seconds to collect
     powerUp.active = true;
     
@@ -301,16 +298,16 @@ void SurvivalMode::applyPowerUpEffect(PowerUpType type, float value) {
         case PowerUpType::Health:
             {
                 float healAmount = m_playerMaxHealth * value;
-                float newHealth = std::min(m_player->getHealth() + healAmount, m_playerMaxHealth);
-                m_player->setHealth(newHealth);
+                float newHealth = std::min(m_player->GetCurrentHealth() + healAmount, m_playerMaxHealth);
+                m_player->SetHealth(newHealth);
             }
             break;
             
         case PowerUpType::Mana:
             {
                 float manaAmount = m_playerMaxMana * value;
-                float newMana = std::min(m_player->getMana() + manaAmount, m_playerMaxMana);
-                m_player->setMana(newMana);
+                float newMana = std::min(m_player->GetCurrentMana() + manaAmount, m_playerMaxMana);
+                m_player->SetMana(newMana);
             }
             break;
             
@@ -327,8 +324,8 @@ void SurvivalMode::applyPowerUpEffect(PowerUpType type, float value) {
             break;
             
         case PowerUpType::FullRestore:
-            m_player->setHealth(m_playerMaxHealth);
-            m_player->setMana(m_playerMaxMana);
+            m_player->SetHealth(m_playerMaxHealth);
+            m_player->SetMana(m_playerMaxMana);
             break;
     }
 }
@@ -338,7 +335,7 @@ void SurvivalMode::completeWave() {
     m_survivalStats.wavesCompleted++;
     
     // Check for perfect wave
-    if (m_player && m_player->getHealth() >= m_playerMaxHealth * 0.99f) {
+    if (m_player && m_player->GetCurrentHealth() >= m_playerMaxHealth * 0.99f) {
         m_survivalStats.perfectWaves++;
     }
     
@@ -351,8 +348,7 @@ void SurvivalMode::completeWave() {
     // Clear enemies
     for (auto& enemy : m_waveEnemies) {
         if (enemy) {
-            m_physicsEngine->unregisterCharacter(enemy.get());
-            m_combatSystem->unregisterCharacter(enemy.get());
+            m_combatSystem->ResetCombo(enemy->GetId());
         }
     }
     m_waveEnemies.clear();
@@ -365,7 +361,7 @@ void SurvivalMode::completeWave() {
         PowerUp reward;
         reward.type = PowerUpType::FullRestore;
         reward.value = 1.0f;
-        reward.position = XMFLOAT3(0, 50, 0);
+        reward.position = DirectX::XMFLOAT3(0, 50, 0);
         reward.lifetime = 30.0f;
         reward.active = true;
         m_activePowerUps.push_back(reward);
@@ -389,7 +385,7 @@ void SurvivalMode::prepareNextWave() {
 
 bool SurvivalMode::isWaveComplete() const {
     for (const auto& enemy : m_waveEnemies) {
-        if (enemy && enemy->getHealth() > 0) {
+        if (enemy && enemy->GetCurrentHealth() > 0) {
             return false;
         }
     }
@@ -400,14 +396,14 @@ void SurvivalMode::recoverPlayer() {
     if (!m_player) return;
     
     // Recover health
-    float currentHealth = m_player->getHealth();
+    float currentHealth = m_player->GetCurrentHealth();
     float healAmount = m_playerMaxHealth * m_survivalConfig.healthRecoveryPercent;
-    m_player->setHealth(std::min(currentHealth + healAmount, m_playerMaxHealth));
+    m_player->SetHealth(std::min(currentHealth + healAmount, m_playerMaxHealth));
     
     // Recover mana
-    float currentMana = m_player->getMana();
+    float currentMana = m_player->GetCurrentMana();
     float manaAmount = m_playerMaxMana * m_survivalConfig.manaRecoveryPercent;
-    m_player->setMana(std::min(currentMana + manaAmount, m_playerMaxMana));
+    m_player->SetMana(std::min(currentMana + manaAmount, m_playerMaxMana));
 }
 
 void SurvivalMode::setSurvivalPlayer(std::shared_ptr<CharacterBase> player) {
@@ -415,7 +411,7 @@ void SurvivalMode::setSurvivalPlayer(std::shared_ptr<CharacterBase> player) {
     addPlayer(player);
     
     // Store max values
-    m_playerMaxHealth = player->getMaxHealth();
+    m_playerMaxHealth = player->GetMaxHealth();
     m_playerMaxMana = BASE_MANA;
 }
 
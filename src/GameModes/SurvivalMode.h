@@ -51,7 +51,7 @@ enum class PowerUpType {
 // Power-up item
 struct PowerUp {
     PowerUpType type;
-    XMFLOAT3 position;
+    DirectX::XMFLOAT3 position;
     float lifetime;
     float value;
     bool active;
@@ -125,8 +125,8 @@ public:
     void resetStats() { m_survivalStats = SurvivalStats(); }
     
     // Configuration
-    void setConfig(const SurvivalConfig& config) { m_survivalConfig = config; }
-    SurvivalConfig getConfig() const { return m_survivalConfig; }
+    void setSurvivalConfig(const SurvivalConfig& config) { m_survivalConfig = config; }
+    SurvivalConfig getSurvivalConfig() const { return m_survivalConfig; }
     
     // Mode specific implementations
     std::string getModeName() const override { return "Survival"; }
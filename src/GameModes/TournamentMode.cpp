@@ -1,6 +1,6 @@
 #include "TournamentMode.h"
+#include "../Core/DeterministicRandom.h"
 #include <algorithm>
-#include <random>
 #include <cmath>
 
 namespace ArenaFighter {
@@ -370,10 +370,13 @@ void TournamentMode::seedPlayers() {
         playerIds.push_back(id);
     }
     
-    // Random shuffle
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(playerIds.begin(), playerIds.end(), g);
+    // Fisher-Yates on the simulation random, so every peer draws the same
+    // bracket; std::shuffle's sequence differs between standard libraries
+    DeterministicRandom& random = GetSimulationRandom();
+    for (size_t i = playerIds.size(); i > 1; --i) {
+        size_t j = random.NextInt(static_cast<uint32_t>(i));
+        std::swap(playerIds[i - 1], playerIds[j]);
+    }
     
     // Assign seeds
     for (int i = 0; i < playerIds.size(); ++i) {
@@ -23,8 +23,8 @@ TrainingMode::TrainingMode(const TrainingSettings& settings)
     m_stats = SessionStats();
     
     // Set default positions
-    m_resetPositions[0] = XMFLOAT3(-200.0f, 0.0f, 0.0f);
-    m_resetPositions[1] = XMFLOAT3(200.0f, 0.0f, 0.0f);
+    m_resetPositions[0] = DirectX::XMFLOAT3(-200.0f, 0.0f, 0.0f);
+    m_resetPositions[1] = DirectX::XMFLOAT3(200.0f, 0.0f, 0.0f);
 }
 
 void TrainingMode::initialize() {
@@ -45,29 +45,29 @@ void TrainingMode::update(float deltaTime) {
     // Skip normal win condition checks
     if (m_currentState == MatchState::InProgress) {
         // Update physics
-        m_physicsEngine->update(deltaTime);
+        m_physicsEngine->Update(deltaTime);
         
         // Update combat
-        m_combatSystem->update(deltaTime);
+        m_combatSystem->Update(deltaTime);
         
         // Update players
         for (int i = 0; i < m_players.size(); ++i) {
             auto& player = m_players[i];
-            player->update(deltaTime);
+            player->Update(deltaTime);
             
             // Apply training settings
             if (i == 0) { // Player 1
                 if (m_settings.infiniteHealth) {
-                    player->setHealth(BASE_HEALTH);
-                } else if (m_settings.autoHealthRegen && player->getHealth() < BASE_HEALTH) {
-                    player->setHealth(std::min(player->getHealth() + 50.0f * deltaTime, BASE_HEALTH));
+                    player->SetHealth(BASE_HEALTH);
+                } else if (m_settings.autoHealthRegen && player->GetCurrentHealth() < BASE_HEALTH) {
+                    player->SetHealth(std::min(player->GetCurrentHealth() + 50.0f * deltaTime, BASE_HEALTH));
                 }
                 
                 if (m_settings.infiniteMana) {
-                    player->setMana(BASE_MANA);
+                    player->SetMana(BASE_MANA);
                 } else if (m_settings.autoManaRegen) {
-                    float currentMana = player->getMana();
-                    player->setMana(std::min(currentMana + MANA_REGEN_RATE * 2.0f * deltaTime, BASE_MANA));
+                    // A second MANA_REGEN on top of Update()'s, so double speed
+                    player->SetMana(player->GetCurrentMana() + MANA_REGEN * deltaTime);
                 }
             }
         }
@@ -113,11 +113,11 @@ void TrainingMode::updateDummy(float deltaTime) {
     
     // Apply dummy settings
     if (m_settings.infiniteHealth) {
-        m_dummy->setHealth(BASE_HEALTH);
+        m_dummy->SetHealth(BASE_HEALTH);
     }
     
     if (m_settings.infiniteMana) {
-        m_dummy->setMana(BASE_MANA);
+        m_dummy->SetMana(BASE_MANA);
     }
     
     // Process dummy behavior
@@ -135,19 +135,19 @@ void TrainingMode::processDummyBehavior() {
             break;
             
         case TrainingSettings::Crouch:
-            dummyInput.direction = InputDirection::Down;
+            dummyInput.direction = StickDirection::Down;
             break;
             
         case TrainingSettings::Jump:
             // Jump repeatedly
-            if (m_dummy->getCurrentState() == CharacterState::Idle) {
+            if (m_dummy->GetCurrentState() == CharacterState::Normal) {
                 dummyInput.action = InputAction::Jump;
             }
             break;
             
         case TrainingSettings::Block:
             dummyInput.action = InputAction::Block;
-            dummyInput.direction = InputDirection::Back;
+            dummyInput.direction = StickDirection::Back;
             break;
             
         case TrainingSettings::CPU:
@@ -212,9 +212,9 @@ void TrainingMode::updateFrameDataTracking() {
     
     // Track current move's frame data
     auto& player = m_players[0];
-    CharacterState state = player->getCurrentState();
+    CharacterState state = player->GetCurrentState();
     
-    if (state == CharacterState::Attacking || state == CharacterState::Special) {
+    if (state == CharacterState::ExecutingSpecial) {
         // Get current move info (would need to be exposed by character)
         // For now, using placeholder data
         m_currentFrameData.moveName = "Current Move";
@@ -250,7 +250,7 @@ void TrainingMode::checkAutoReset() {
     bool shouldReset = distance > m_settings.resetDistance;
     
     for (auto& player : m_players) {
-        if (player->getCurrentState() == CharacterState::KnockedDown) {
+        if (player->GetCurrentState() == CharacterState::KnockedDown) {
             shouldReset = true;
             break;
         }
@@ -341,11 +341,11 @@ void TrainingMode::clearRecording() {
 
 void TrainingMode::resetPositions() {
     for (int i = 0; i < m_players.size(); ++i) {
-        m_players[i]->setPosition(m_resetPositions[i]);
-        m_players[i]->setHealth(BASE_HEALTH);
-        m_players[i]->setMana(BASE_MANA);
-        m_players[i]->resetCombo();
-        m_players[i]->setState(CharacterState::Idle);
+        m_players[i]->GetRigidBody()->position = m_resetPositions[i];
+        m_players[i]->SetHealth(BASE_HEALTH);
+        m_players[i]->SetMana(BASE_MANA);
+        m_combatSystem->ResetCombo(m_players[i]->GetId());
+        m_players[i]->SetState(CharacterState::Normal);
     }
     
     resetCombo();
@@ -353,14 +353,14 @@ void TrainingMode::resetPositions() {
 
 void TrainingMode::savePositions() {
     for (int i = 0; i < m_players.size(); ++i) {
-        m_resetPositions[i] = m_players[i]->getPosition();
+        m_resetPositions[i] = m_players[i]->GetRigidBody()->position;
     }
 }
 
 void TrainingMode::setStartingDistance(float distance) {
     m_settings.resetDistance = distance;
-    m_resetPositions[0] = XMFLOAT3(-distance / 2.0f, 0.0f, 0.0f);
-    m_resetPositions[1] = XMFLOAT3(distance / 2.0f, 0.0f, 0.0f);
+    m_resetPositions[0] = DirectX::XMFLOAT3(-distance / 2.0f, 0.0f, 0.0f);
+    m_resetPositions[1] = DirectX::XMFLOAT3(distance / 2.0f, 0.0f, 0.0f);
 }
 
 void TrainingMode::resetCombo() {
@@ -388,8 +388,8 @@ float TrainingMode::getDistanceToPlayer() const {
         return 0.0f;
     }
     
-    XMFLOAT3 p1Pos = m_players[0]->getPosition();
-    XMFLOAT3 p2Pos = m_players[1]->getPosition();
+    DirectX::XMFLOAT3 p1Pos = m_players[0]->GetRigidBody()->position;
+    DirectX::XMFLOAT3 p2Pos = m_players[1]->GetRigidBody()->position;
     
     return std::abs(p1Pos.x - p2Pos.x);
 }
@@ -79,7 +79,7 @@ private:
     float m_comboManaUsed;
     
     // Position reset
-    XMFLOAT3 m_resetPositions[2];
+    DirectX::XMFLOAT3 m_resetPositions[2];
     
     // Statistics
     struct SessionStats {
@@ -99,6 +99,7 @@ private:
     void updatePlayback(float deltaTime);
     void updateFrameDataTracking();
     void checkAutoReset();
+    float getDistanceToPlayer() const;
     void displayTrainingInfo();
 
 public:
@@ -144,7 +145,7 @@ public:
     
     // Mode specific implementations
     std::string getModeName() const override { return "Training"; }
-    GameModeType getModeType() const override { return GameModeType::Ranked1v1; } // Reuse UI
+    GameModeType getModeType() const override { return GameModeType::Versus; } // Reuse UI
     bool supportsOnline() const override { return false; }
     int getMinPlayers() const override { return 1; }
     int getMaxPlayers() const override { return 2; }
@@ -31,14 +31,16 @@ void VersusMode::initialize() {
     
     // Initialize switch cooldowns
     for (const auto& player : m_players) {
-        m_switchCooldowns[player->getId()] = 0.0f;
+        m_switchCooldowns[player->GetId()] = 0.0f;
     }
     
+#ifndef DFR_HEADLESS
     // Set up versus-specific UI elements
     if (m_gameUI) {
         // Additional UI setup for versus mode
         m_gameUI->setCharacterSlotMode(m_settings.slotMode);
     }
+#endif
 }
 
 void VersusMode::update(float deltaTime) {
@@ -126,8 +128,8 @@ void VersusMode::enterState(MatchState newState) {
 void VersusMode::checkDoubleKO() {
     // Check if both players are knocked out simultaneously
     if (m_players.size() >= 2) {
-        bool p1KO = m_players[0]->getHealth() <= 0;
-        bool p2KO = m_players[1]->getHealth() <= 0;
+        bool p1KO = m_players[0]->GetCurrentHealth() <= 0;
+        bool p2KO = m_players[1]->GetCurrentHealth() <= 0;
         
         if (p1KO && p2KO && !m_doubleKO) {
             m_doubleKO = true;
@@ -154,7 +156,7 @@ void VersusMode::handleSuddenDeath(float deltaTime) {
     
     // First hit wins in sudden death
     for (int i = 0; i < m_players.size(); ++i) {
-        if (m_players[i]->getHealth() < BASE_HEALTH) {
+        if (m_players[i]->GetCurrentHealth() < BASE_HEALTH) {
             // Other player wins
             int winner = (i == 0) ? 1 : 0;
             endRound(winner, WinCondition::Knockout);
@@ -171,7 +173,7 @@ void VersusMode::updatePlayerStatistics() {
         PlayerStats& stats = m_playerStats[i];
         
         // Update max combo
-        int currentCombo = m_combatSystem->getCurrentCombo(i);
+        int currentCombo = m_combatSystem->GetComboCount(m_players[i]->GetId());
         if (currentCombo > stats.maxComboLength) {
             stats.maxComboLength = currentCombo;
         }
@@ -233,8 +235,8 @@ void VersusMode::enableSuddenDeath() {
     
     // Reset both players to full health
     for (auto& player : m_players) {
-        player->setHealth(BASE_HEALTH);
-        player->setMana(BASE_MANA);
+        player->SetHealth(BASE_HEALTH);
+        player->SetMana(BASE_MANA);
     }
     
     // Announce sudden death (UI notification)
@@ -252,7 +254,7 @@ void VersusMode::setupCharacterSlots() {
     // This will be populated when players select characters
     // For now, just set up the structure
     for (const auto& player : m_players) {
-        m_activeCharacterIndex[player->getId()] = 0;
+        m_activeCharacterIndex[player->GetId()] = 0;
     }
 }
 
@@ -273,18 +275,14 @@ void VersusMode::setPlayerCharacters(int playerId, const std::vector<std::shared
         if (m_settings.slotMode == CharacterSlotMode::Single) {
             // Update the player reference
             for (int i = 0; i < m_players.size(); ++i) {
-                if (m_players[i]->getId() == playerId) {
+                if (m_players[i]->GetId() == playerId) {
                     m_players[i] = characters[0];
                     break;
                 }
             }
-        } else {
-            // In triple mode, activate the first character
-            characters[0]->setActive(true);
-            for (int i = 1; i < characters.size(); ++i) {
-                characters[i]->setActive(false);
-            }
         }
+        // In triple mode the active index picks the character; benched
+        // ones are simply not in m_players
     }
 }
 
@@ -355,7 +353,7 @@ void VersusMode::switchCharacter(int playerId, int direction) {
     
     // Skip dead characters
     int attempts = 0;
-    while (characters[newIndex]->isDead() && attempts < characters.size()) {
+    while (!characters[newIndex]->IsAlive() && attempts < characters.size()) {
         if (direction > 0) {
             newIndex = (newIndex + 1) % characters.size();
         } else {
@@ -365,21 +363,15 @@ void VersusMode::switchCharacter(int playerId, int direction) {
     }
     
     // If all other characters are dead, can't switch
-    if (characters[newIndex]->isDead()) {
+    if (!characters[newIndex]->IsAlive()) {
         return;
     }
     
     // Perform the switch
     if (newIndex != currentIndex) {
-        // Deactivate current character
-        characters[currentIndex]->setActive(false);
-        
-        // Get current position to maintain continuity
-        Vector3 currentPos = characters[currentIndex]->getPosition();
-        
-        // Activate new character
-        characters[newIndex]->setActive(true);
-        characters[newIndex]->setPosition(currentPos);
+        // The incoming character takes over the current position
+        DirectX::XMFLOAT3 currentPos = characters[currentIndex]->GetRigidBody()->position;
+        characters[newIndex]->GetRigidBody()->position = currentPos;
         
         // Update active index
         m_activeCharacterIndex[playerId] = newIndex;
@@ -389,16 +381,18 @@ void VersusMode::switchCharacter(int playerId, int direction) {
         
         // Update player reference for game mode
         for (int i = 0; i < m_players.size(); ++i) {
-            if (m_players[i]->getId() == playerId) {
+            if (m_players[i]->GetId() == playerId) {
                 m_players[i] = characters[newIndex];
                 break;
             }
         }
         
+#ifndef DFR_HEADLESS
         // Notify UI
         if (m_gameUI) {
             m_gameUI->onCharacterSwitch(playerId, currentIndex, newIndex);
         }
+#endif
     }
 }
 
@@ -413,7 +407,8 @@ bool VersusMode::canSwitchCharacter(int playerId) const {
     auto character = getActiveCharacter(playerId);
     if (character) {
         // Can't switch while in hitstun, during attacks, etc.
-        if (character->isInHitstun() || character->isAttacking()) {
+        CharacterState state = character->GetCurrentState();
+        if (state == CharacterState::HitStun || state == CharacterState::ExecutingSpecial) {
             return false;
         }
     }
@@ -2,6 +2,8 @@
 
 #include "GameMode.h"
 #include <array>
+#include <map>
+#include <vector>
 
 namespace ArenaFighter {
 
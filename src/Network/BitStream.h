@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ArenaFighter {
+
+// LSB-first bit packer over caller-owned bytes
+class BitWriter {
+public:
+    BitWriter(uint8_t* data, size_t capacity)
+        : m_data(data), m_capacity(capacity), m_bitPosition(0), m_overflowed(false) {}
+
+    void WriteBits(uint32_t value, int bits) {
+        for (int i = 0; i < bits; ++i) {
+            size_t byteIndex = m_bitPosition >> 3;
+            if (byteIndex >= m_capacity) {
+                m_overflowed = true;
+                return;
+            }
+
+            uint8_t mask = static_cast<uint8_t>(1u << (m_bitPosition & 7));
+            if (value & (1u << i)) {
+                m_data[byteIndex] |= mask;
+            } else {
+                m_data[byteIndex] &= static_cast<uint8_t>(~mask);
+            }
+            m_bitPosition++;
+        }
+    }
+
+    // Two's complement, truncated to the given width
+    void WriteSigned(int32_t value, int bits) {
+        WriteBits(static_cast<uint32_t>(value), bits);
+    }
+
+    void WriteBool(bool value) { WriteBits(value ? 1u : 0u, 1); }
+
+    // 7 bits per group plus a continue bit: 8 bits below 128, 40 at most
+    void WriteVarint(uint32_t value) {
+        while (value >= 0x80) {
+            WriteBits((value & 0x7F) | 0x80, 8);
+            value >>= 7;
+        }
+        WriteBits(value, 8);
+    }
+
+    size_t GetBitCount() const { return m_bitPosition; }
+    size_t GetByteCount() const { return (m_bitPosition + 7) >> 3; }
+    bool HasOverflowed() const { return m_overflowed; }
+
+private:
+    uint8_t* m_data;
+    size_t m_capacity;
+    size_t m_bitPosition;
+    bool m_overflowed;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : m_data(data), m_size(size), m_bitPosition(0), m_overflowed(false) {}
+
+    uint32_t ReadBits(int bits) {
+        uint32_t value = 0;
+        for (int i = 0; i < bits; ++i) {
+            size_t byteIndex = m_bitPosition >> 3;
+            if (byteIndex >= m_size) {
+                m_overflowed = true;
+                return 0;
+            }
+
+            if (m_data[byteIndex] & (1u << (m_bitPosition & 7))) {
+                value |= 1u << i;
+            }
+            m_bitPosition++;
+        }
+        return value;
+    }
+
+    // Sign-extends a value written by WriteSigned
+    int32_t ReadSigned(int bits) {
+        uint32_t value = ReadBits(bits);
+        uint32_t signBit = 1u << (bits - 1);
+        return static_cast<int32_t>((value ^ signBit) - signBit);
+    }
+
+    bool ReadBool() { return ReadBits(1) != 0; }
+
+    uint32_t ReadVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint32_t group = ReadBits(8);
+            value |= (group & 0x7F) << shift;
+            if (!(group & 0x80)) {
+                return value;
+            }
+        }
+        m_overflowed = true;   // More than five groups
+        return 0;
+    }
+
+    size_t GetByteCount() const { return (m_bitPosition + 7) >> 3; }
+    bool HasOverflowed() const { return m_overflowed; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_bitPosition;
+    bool m_overflowed;
+};
+
+} // namespace ArenaFighter
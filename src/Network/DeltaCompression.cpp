@@ -0,0 +1,164 @@
+#include "DeltaCompression.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+// DeltaStateEncoder implementation
+
+void DeltaStateEncoder::AddPeer(uint32_t peerId) {
+    if (std::find(m_peers.begin(), m_peers.end(), peerId) == m_peers.end()) {
+        m_peers.push_back(peerId);
+    }
+}
+
+void DeltaStateEncoder::RemovePeer(uint32_t peerId) {
+    m_peers.erase(std::remove(m_peers.begin(), m_peers.end(), peerId), m_peers.end());
+    
+    for (auto& [playerId, history] : m_players) {
+        history.peerAcks.erase(peerId);
+    }
+}
+
+void DeltaStateEncoder::Clear() {
+    m_players.clear();
+    m_peers.clear();
+}
+
+void DeltaStateEncoder::Encode(const PlayerStatePacket& state, DeltaStatePacket& out) {
+    PlayerHistory& history = m_players[state.playerId];
+    QuantizedPlayerState current = QuantizedPlayerState::FromPacket(state);
+    
+    uint32_t sequence = history.nextSequence++;
+    Snapshot& slot = history.snapshots[sequence % HISTORY_SIZE];
+    
+    // Pick the baseline before this snapshot can overwrite it
+    const Snapshot* baseline = FindBaseline(history);
+    
+    out.playerId = state.playerId;
+    out.snapshotId = static_cast<uint8_t>(sequence);
+    out.values = current;
+    
+    if (!baseline) {
+        out.hasBaseline = false;
+        out.changedFields = DeltaStatePacket::FieldAll;
+    } else {
+        const QuantizedPlayerState& base = baseline->state;
+        out.hasBaseline = true;
+        out.baselineId = static_cast<uint8_t>(baseline->sequence);
+        out.changedFields = 0;
+        
+        bool positionChanged = false;
+        bool velocityChanged = false;
+        for (int i = 0; i < 3; ++i) {
+            out.values.position[i] = current.position[i] - base.position[i];
+            out.values.velocity[i] = current.velocity[i] - base.velocity[i];
+            positionChanged |= out.values.position[i] != 0;
+            velocityChanged |= out.values.velocity[i] != 0;
+        }
+        
+        if (positionChanged) out.changedFields |= DeltaStatePacket::FieldPosition;
+        if (velocityChanged) out.changedFields |= DeltaStatePacket::FieldVelocity;
+        if (current.rotation != base.rotation) out.changedFields |= DeltaStatePacket::FieldRotation;
+        if (current.health != base.health) out.changedFields |= DeltaStatePacket::FieldHealth;
+        if (current.mana != base.mana) out.changedFields |= DeltaStatePacket::FieldMana;
+        if (current.state != base.state) out.changedFields |= DeltaStatePacket::FieldState;
+        if (current.currentGear != base.currentGear) out.changedFields |= DeltaStatePacket::FieldGear;
+    }
+    
+    slot.sequence = sequence;
+    slot.valid = true;
+    slot.state = current;
+}
+
+void DeltaStateEncoder::Acknowledge(uint32_t peerId, uint32_t playerId, uint8_t snapshotId) {
+    auto it = m_players.find(playerId);
+    if (it == m_players.end() || it->second.nextSequence == 0) {
+        return;
+    }
+    
+    PlayerHistory& history = it->second;
+    
+    // Expand the 8-bit id to the newest sequence that matches it
+    uint32_t newest = history.nextSequence - 1;
+    uint32_t sequence = newest - (static_cast<uint8_t>(newest - snapshotId));
+    
+    const Snapshot& slot = history.snapshots[sequence % HISTORY_SIZE];
+    if (!slot.valid || slot.sequence != sequence) {
+        return; // Too old to serve as a baseline
+    }
+    
+    auto ack = history.peerAcks.find(peerId);
+    if (ack == history.peerAcks.end() || sequence > ack->second) {
+        history.peerAcks[peerId] = sequence;
+    }
+}
+
+const DeltaStateEncoder::Snapshot* DeltaStateEncoder::FindBaseline(const PlayerHistory& history) const {
+    if (m_peers.empty()) {
+        return nullptr;
+    }
+    
+    // Oldest acknowledgement across peers is the newest state all of them hold
+    uint32_t common = UINT32_MAX;
+    for (uint32_t peerId : m_peers) {
+        auto ack = history.peerAcks.find(peerId);
+        if (ack == history.peerAcks.end()) {
+            return nullptr;
+        }
+        common = std::min(common, ack->second);
+    }
+    
+    // The slot about to be written must not be the baseline, and the
+    // receiver only keeps the last HISTORY_SIZE snapshots
+    uint32_t newest = history.nextSequence - 1;
+    if (newest - common >= HISTORY_SIZE) {
+        return nullptr;
+    }
+    
+    const Snapshot& slot = history.snapshots[common % HISTORY_SIZE];
+    return slot.valid && slot.sequence == common ? &slot : nullptr;
+}
+
+// DeltaStateDecoder implementation
+
+bool DeltaStateDecoder::Decode(const DeltaStatePacket& packet, PlayerStatePacket& out) {
+    auto& snapshots = m_players[packet.playerId];
+    QuantizedPlayerState state = packet.values;
+    
+    if (!packet.hasBaseline) {
+        // A full snapshot must carry every field
+        if (packet.changedFields != DeltaStatePacket::FieldAll) {
+            return false;
+        }
+    } else {
+        const Snapshot& baseline = snapshots[packet.baselineId % HISTORY_SIZE];
+        if (!baseline.valid || baseline.id != packet.baselineId) {
+            return false;
+        }
+        
+        const QuantizedPlayerState& base = baseline.state;
+        uint8_t changed = packet.changedFields;
+        
+        for (int i = 0; i < 3; ++i) {
+            state.position[i] = base.position[i] + (changed & DeltaStatePacket::FieldPosition ? packet.values.position[i] : 0);
+            state.velocity[i] = base.velocity[i] + (changed & DeltaStatePacket::FieldVelocity ? packet.values.velocity[i] : 0);
+        }
+        
+        if (!(changed & DeltaStatePacket::FieldRotation)) state.rotation = base.rotation;
+        if (!(changed & DeltaStatePacket::FieldHealth)) state.health = base.health;
+        if (!(changed & DeltaStatePacket::FieldMana)) state.mana = base.mana;
+        if (!(changed & DeltaStatePacket::FieldState)) state.state = base.state;
+        if (!(changed & DeltaStatePacket::FieldGear)) state.currentGear = base.currentGear;
+    }
+    
+    Snapshot& slot = snapshots[packet.snapshotId % HISTORY_SIZE];
+    slot.id = packet.snapshotId;
+    slot.valid = true;
+    slot.state = state;
+    
+    out.playerId = packet.playerId;
+    state.ToPacket(out);
+    return true;
+}
+
+} // namespace ArenaFighter
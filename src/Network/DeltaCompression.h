@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include "NetworkPacket.h"
+
+namespace ArenaFighter {
+
+// Sender side of the delta-state pipeline. Keeps a short history of the
+// snapshots sent for each player and, per peer, the newest one that peer
+// acknowledged. Each Encode() deltas against the newest snapshot every
+// peer holds, since the same datagram fans out to all of them.
+class DeltaStateEncoder {
+public:
+    // Must stay well below 256 so 8-bit snapshot ids are unambiguous
+    static constexpr size_t HISTORY_SIZE = 32;
+    
+    void AddPeer(uint32_t peerId);
+    void RemovePeer(uint32_t peerId);
+    void Clear();
+    
+    // Quantizes state and fills out with the fields that changed since
+    // the common baseline (or every field when there is none)
+    void Encode(const PlayerStatePacket& state, DeltaStatePacket& out);
+    
+    // Peer peerId now holds snapshotId of playerId's state
+    void Acknowledge(uint32_t peerId, uint32_t playerId, uint8_t snapshotId);
+
+private:
+    struct Snapshot {
+        uint32_t sequence = 0;
+        bool valid = false;
+        QuantizedPlayerState state;
+    };
+    
+    struct PlayerHistory {
+        std::array<Snapshot, HISTORY_SIZE> snapshots;
+        uint32_t nextSequence = 0;
+        std::unordered_map<uint32_t, uint32_t> peerAcks; // Peer -> acked sequence
+    };
+    
+    const Snapshot* FindBaseline(const PlayerHistory& history) const;
+    
+    std::unordered_map<uint32_t, PlayerHistory> m_players;
+    std::vector<uint32_t> m_peers;
+};
+
+// Receiver side: rebuilds full states from deltas and remembers them as
+// future baselines
+class DeltaStateDecoder {
+public:
+    static constexpr size_t HISTORY_SIZE = DeltaStateEncoder::HISTORY_SIZE;
+    
+    // Returns false if the packet is malformed or its baseline is unknown;
+    // in that case nothing must be acknowledged
+    bool Decode(const DeltaStatePacket& packet, PlayerStatePacket& out);
+    void Clear() { m_players.clear(); }
+
+private:
+    struct Snapshot {
+        uint8_t id = 0;
+        bool valid = false;
+        QuantizedPlayerState state;
+    };
+    
+    std::unordered_map<uint32_t, std::array<Snapshot, HISTORY_SIZE>> m_players;
+};
+
+} // namespace ArenaFighter
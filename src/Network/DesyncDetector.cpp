@@ -0,0 +1,306 @@
+#include "DesyncDetector.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace ArenaFighter {
+
+namespace {
+
+// XXH64 primes
+constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Read64(const uint8_t* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t Read32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * PRIME1;
+}
+
+inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator) {
+    hash ^= Round(0, accumulator);
+    return hash * PRIME1 + PRIME4;
+}
+
+} // namespace
+
+DesyncDetector::DesyncDetector(uint32_t interval)
+    : m_interval(std::max(interval, 1u))
+    , m_debugMode(false)
+    , m_matchedChecks(0)
+    , m_mismatchedChecks(0) {
+}
+
+uint64_t DesyncDetector::HashState(const uint8_t* data, size_t size) {
+    const uint8_t* ptr = data;
+    const uint8_t* end = data + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        // Four independent lanes per 32-byte stripe keep the multipliers
+        // pipelined; this loop is where nearly all the time goes
+        uint64_t v1 = PRIME1 + PRIME2;
+        uint64_t v2 = PRIME2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - PRIME1;
+
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = Round(v1, Read64(ptr));
+            v2 = Round(v2, Read64(ptr + 8));
+            v3 = Round(v3, Read64(ptr + 16));
+            v4 = Round(v4, Read64(ptr + 24));
+            ptr += 32;
+        } while (ptr <= limit);
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    } else {
+        hash = PRIME5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    while (ptr + 8 <= end) {
+        hash ^= Round(0, Read64(ptr));
+        hash = RotateLeft(hash, 27) * PRIME1 + PRIME4;
+        ptr += 8;
+    }
+
+    if (ptr + 4 <= end) {
+        hash ^= static_cast<uint64_t>(Read32(ptr)) * PRIME1;
+        hash = RotateLeft(hash, 23) * PRIME2 + PRIME3;
+        ptr += 4;
+    }
+
+    while (ptr < end) {
+        hash ^= (*ptr) * PRIME5;
+        hash = RotateLeft(hash, 11) * PRIME1;
+        ptr++;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void DesyncDetector::SetStateLayout(const StateField* fields, size_t count) {
+    m_layout.assign(fields, fields + count);
+}
+
+void DesyncDetector::SetDebugMode(bool enabled) {
+    m_debugMode = enabled;
+    m_localStates.resize(enabled ? HISTORY_SIZE : 0);
+}
+
+void DesyncDetector::RecordLocalState(uint32_t frame, const uint8_t* data, size_t size) {
+    StateHash local;
+    local.frame = frame;
+    local.hash = HashState(data, size);
+
+    if (m_debugMode) {
+        size_t fieldCount = std::min(m_layout.size(), StateHash::MAX_FIELDS);
+        for (size_t i = 0; i < fieldCount; ++i) {
+            const StateField& field = m_layout[i];
+            size_t offset = std::min<size_t>(field.offset, size);
+            size_t length = std::min<size_t>(field.size, size - offset);
+            local.fieldHashes[i] = HashState(data + offset, length);
+        }
+        local.fieldCount = static_cast<uint8_t>(fieldCount);
+
+        // Reuses the slot's capacity, so this stops allocating once the
+        // history has wrapped
+        m_localStates[GetSlotIndex(frame)].assign(data, data + size);
+    }
+
+    RecordLocal(local);
+}
+
+void DesyncDetector::RecordLocalHash(uint32_t frame, uint64_t hash) {
+    StateHash local;
+    local.frame = frame;
+    local.hash = hash;
+    RecordLocal(local);
+}
+
+void DesyncDetector::RecordLocal(const StateHash& local) {
+    Entry& slot = GetSlot(m_localHashes, local.frame);
+    slot.state = local;
+    slot.valid = true;
+
+    // Settle anything peers reported before we got here
+    for (auto& [playerId, history] : m_remoteHashes) {
+        Entry& remote = GetSlot(history, local.frame);
+        if (remote.valid && remote.state.frame == local.frame) {
+            Compare(playerId, local, remote.state);
+            remote.valid = false;
+        }
+    }
+}
+
+void DesyncDetector::RecordRemoteHash(uint32_t playerId, const StateHash& remote) {
+    if (!IsCheckFrame(remote.frame)) {
+        return;
+    }
+
+    const Entry& local = GetSlot(m_localHashes, remote.frame);
+    if (local.valid && local.state.frame == remote.frame) {
+        Compare(playerId, local.state, remote);
+        return;
+    }
+
+    Entry& slot = GetSlot(m_remoteHashes[playerId], remote.frame);
+    slot.state = remote;
+    slot.valid = true;
+}
+
+void DesyncDetector::RecordRemoteHash(uint32_t playerId, uint32_t frame, uint64_t hash) {
+    StateHash remote;
+    remote.frame = frame;
+    remote.hash = hash;
+    RecordRemoteHash(playerId, remote);
+}
+
+bool DesyncDetector::PopOutgoingHash(StateHash& out) {
+    const Entry* oldest = nullptr;
+
+    for (const Entry& entry : m_localHashes) {
+        if (!entry.valid || (m_lastSentFrame.has_value() && entry.state.frame <= *m_lastSentFrame)) {
+            continue;
+        }
+        if (!oldest || entry.state.frame < oldest->state.frame) {
+            oldest = &entry;
+        }
+    }
+
+    if (!oldest) {
+        return false;
+    }
+
+    out = oldest->state;
+    m_lastSentFrame = out.frame;
+    return true;
+}
+
+bool DesyncDetector::DumpLocalState(uint32_t frame, const std::string& path) const {
+    if (!m_debugMode) {
+        return false;
+    }
+
+    size_t index = GetSlotIndex(frame);
+    const Entry& entry = m_localHashes[index];
+    if (!entry.valid || entry.state.frame != frame) {
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    const std::vector<uint8_t>& state = m_localStates[index];
+    file.write(reinterpret_cast<const char*>(state.data()), static_cast<std::streamsize>(state.size()));
+    return file.good();
+}
+
+bool DesyncDetector::LoadStateDump(const std::string& path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+std::optional<StateDifference> DesyncDetector::FindFirstDifference(const std::vector<uint8_t>& a,
+                                                                   const std::vector<uint8_t>& b,
+                                                                   const std::vector<StateField>& layout) {
+    size_t common = std::min(a.size(), b.size());
+    auto mismatch = std::mismatch(a.begin(), a.begin() + common, b.begin());
+
+    size_t offset = static_cast<size_t>(mismatch.first - a.begin());
+    if (offset == common && a.size() == b.size()) {
+        return std::nullopt;
+    }
+
+    StateDifference difference{ static_cast<uint32_t>(offset), -1, nullptr, 0 };
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const StateField& field = layout[i];
+        if (offset >= field.offset && offset < static_cast<size_t>(field.offset) + field.size) {
+            difference.field = static_cast<int32_t>(i);
+            difference.fieldName = field.name;
+            difference.fieldOffset = static_cast<uint32_t>(offset - field.offset);
+            break;
+        }
+    }
+    return difference;
+}
+
+void DesyncDetector::Reset() {
+    m_localHashes = History{};
+    m_remoteHashes.clear();
+    m_lastSentFrame.reset();
+    m_firstDesync.reset();
+    m_matchedChecks = 0;
+    m_mismatchedChecks = 0;
+}
+
+void DesyncDetector::Compare(uint32_t playerId, const StateHash& local, const StateHash& remote) {
+    if (local.hash == remote.hash) {
+        m_matchedChecks++;
+        return;
+    }
+
+    m_mismatchedChecks++;
+
+    DesyncReport report{ local.frame, playerId, local.hash, remote.hash };
+
+    // Both sides hashed the same layout in debug mode: the first field
+    // whose hashes differ is where the states split
+    size_t fieldCount = std::min(local.fieldCount, remote.fieldCount);
+    for (size_t i = 0; i < fieldCount; ++i) {
+        if (local.fieldHashes[i] != remote.fieldHashes[i]) {
+            report.field = static_cast<int32_t>(i);
+            report.fieldName = i < m_layout.size() ? m_layout[i].name : nullptr;
+            break;
+        }
+    }
+
+    if (!m_firstDesync.has_value() || local.frame < m_firstDesync->frame) {
+        m_firstDesync = report;
+    }
+
+    if (m_onDesync) {
+        m_onDesync(report);
+    }
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "NetworkConfig.h"
+
+namespace ArenaFighter {
+
+// A named byte range of a saved simulation state. Simulations describe
+// their snapshot layout with these so a desync can be narrowed down to
+// the part of the state that diverged.
+struct StateField {
+    const char* name;
+    uint32_t offset;
+    uint32_t size;
+};
+
+// Hash of one confirmed frame. fieldHashes is only filled in debug mode.
+struct StateHash {
+    static constexpr size_t MAX_FIELDS = 8;
+
+    uint32_t frame = 0;
+    uint64_t hash = 0;
+    uint8_t fieldCount = 0;
+    uint64_t fieldHashes[MAX_FIELDS] = {};
+};
+
+struct DesyncReport {
+    uint32_t frame;        // Earliest frame that disagreed
+    uint32_t playerId;     // Peer whose hash differed
+    uint64_t localHash;
+    uint64_t remoteHash;
+    int32_t field = -1;               // First differing layout field, -1 if unknown
+    const char* fieldName = nullptr;
+};
+
+// First byte at which two dumped states differ
+struct StateDifference {
+    uint32_t offset;
+    int32_t field;             // Layout field containing offset, -1 if none
+    const char* fieldName;
+    uint32_t fieldOffset;      // offset relative to the field start
+};
+
+// Compares hashes of confirmed simulation state with every peer. By
+// default every confirmed frame is hashed. RollbackEngine records a local
+// hash once a frame can no longer be rolled back; NetworkManager sends it
+// out and records what peers report. Either side may arrive first, so
+// both are kept for the last HISTORY_SIZE checkpoints.
+//
+// In debug mode each layout field is hashed as well, and a copy of every
+// recorded local state is kept. A mismatch then names the first differing
+// field, and the local state can be dumped to disk and diffed against the
+// peer's dump with FindFirstDifference().
+class DesyncDetector {
+public:
+    static constexpr size_t HISTORY_SIZE = 128;
+
+    explicit DesyncDetector(uint32_t interval = NetworkConfig::DESYNC_CHECK_INTERVAL);
+
+    // 64-bit xxHash (XXH64, seed 0) over a saved state blob
+    static uint64_t HashState(const uint8_t* data, size_t size);
+
+    uint32_t GetInterval() const { return m_interval; }
+    bool IsCheckFrame(uint32_t frame) const { return frame % m_interval == 0; }
+
+    // Only the first StateHash::MAX_FIELDS fields are hashed separately
+    void SetStateLayout(const StateField* fields, size_t count);
+    const std::vector<StateField>& GetStateLayout() const { return m_layout; }
+
+    void SetDebugMode(bool enabled);
+    bool IsDebugMode() const { return m_debugMode; }
+
+    // Hashes a confirmed state; in debug mode also hashes its fields and
+    // keeps a copy for dumping
+    void RecordLocalState(uint32_t frame, const uint8_t* data, size_t size);
+    void RecordLocalHash(uint32_t frame, uint64_t hash);
+    void RecordRemoteHash(uint32_t playerId, const StateHash& remote);
+    void RecordRemoteHash(uint32_t playerId, uint32_t frame, uint64_t hash);
+
+    // Hands out each local hash once, oldest first, for sending to peers
+    bool PopOutgoingHash(StateHash& out);
+
+    bool HasDesynced() const { return m_firstDesync.has_value(); }
+    const std::optional<DesyncReport>& GetFirstDesync() const { return m_firstDesync; }
+    uint32_t GetMatchedChecks() const { return m_matchedChecks; }
+    uint32_t GetMismatchedChecks() const { return m_mismatchedChecks; }
+
+    // Called for every mismatching frame, not just the first
+    using OnDesyncCallback = std::function<void(const DesyncReport&)>;
+    void SetOnDesync(OnDesyncCallback callback) { m_onDesync = callback; }
+
+    // Debug mode only: writes the raw local state of frame to path.
+    // Fails once the frame has left the history.
+    bool DumpLocalState(uint32_t frame, const std::string& path) const;
+    static bool LoadStateDump(const std::string& path, std::vector<uint8_t>& data);
+
+    // Bisects two states of the same frame down to the first differing
+    // byte and names the layout field it belongs to
+    static std::optional<StateDifference> FindFirstDifference(const std::vector<uint8_t>& a,
+                                                              const std::vector<uint8_t>& b,
+                                                              const std::vector<StateField>& layout);
+
+    void Reset();
+
+private:
+    struct Entry {
+        StateHash state;
+        bool valid = false;
+    };
+    using History = std::array<Entry, HISTORY_SIZE>;
+
+    size_t GetSlotIndex(uint32_t frame) const { return (frame / m_interval) % HISTORY_SIZE; }
+    Entry& GetSlot(History& history, uint32_t frame) { return history[GetSlotIndex(frame)]; }
+
+    void RecordLocal(const StateHash& local);
+    void Compare(uint32_t playerId, const StateHash& local, const StateHash& remote);
+
+    uint32_t m_interval;
+    std::vector<StateField> m_layout;
+    bool m_debugMode;
+
+    History m_localHashes;
+    std::unordered_map<uint32_t, History> m_remoteHashes;   // Waiting for our hash
+
+    // Debug mode: local state bytes, parallel to m_localHashes
+    std::vector<std::vector<uint8_t>> m_localStates;
+
+    std::optional<uint32_t> m_lastSentFrame;
+    std::optional<DesyncReport> m_firstDesync;
+    uint32_t m_matchedChecks;
+    uint32_t m_mismatchedChecks;
+
+    OnDesyncCallback m_onDesync;
+};
+
+} // namespace ArenaFighter
@@ -13,6 +13,8 @@ InputBuffer::InputBuffer(uint32_t playerId)
     , m_lastConfirmedFrame(0)
     , m_lastReceivedFrame(0)
     , m_oldestFrame(0)
+    , m_contiguousFrame(0)
+    , m_predictor(std::make_unique<NGramPredictor>())
     , m_lastInput(0)
     , m_predictionAccuracy(1.0f)
     , m_predictionHits(0)
@@ -38,6 +40,46 @@ void InputBuffer::AddInput(const InputFrame& input) {
     if (m_oldestFrame == 0 || input.frame < m_oldestFrame) {
         m_oldestFrame = input.frame;
     }
+    
+    if (!input.predicted) {
+        AdvanceContiguousFrame();
+        RefreshPredictions();
+    }
+}
+
+size_t InputBuffer::AddInput(uint32_t firstFrame, const uint32_t* inputMasks, size_t count, uint16_t inputId) {
+    size_t added = 0;
+    
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t frame = firstFrame + static_cast<uint32_t>(i);
+        
+        auto existing = GetInput(frame);
+        if (existing.has_value() && !existing->predicted) {
+            continue; // Redundant copy of a frame we already have
+        }
+        
+        if (existing.has_value()) {
+            // Scores the prediction and overwrites it
+            ConfirmInput(frame, inputMasks[i], inputId);
+            if (frame >= m_lastReceivedFrame) {
+                m_lastInput = inputMasks[i];
+            }
+        } else {
+            InputFrame input;
+            input.frame = frame;
+            input.inputMask = inputMasks[i];
+            input.inputId = inputId;
+            input.timestamp = static_cast<uint16_t>(frame);
+            input.confirmed = true;
+            input.predicted = false;
+            AddInput(input);
+        }
+        added++;
+    }
+    
+    AdvanceContiguousFrame();
+    RefreshPredictions();
+    return added;
 }
 
 void InputBuffer::AddPredictedInput(uint32_t frame, uint32_t predictedMask) {
@@ -91,6 +133,10 @@ void InputBuffer::ConfirmInput(uint32_t frame, uint32_t inputMask, uint16_t inpu
             m_predictionHits++;
         } else {
             m_predictionMisses++;
+            
+            if (!m_mispredictedFrame.has_value() || frame < *m_mispredictedFrame) {
+                m_mispredictedFrame = frame;
+            }
         }
         
         // Update accuracy (rolling average)
@@ -154,10 +200,41 @@ std::vector<uint32_t> InputBuffer::GetUnconfirmedFrames() const {
     return unconfirmed;
 }
 
+void InputBuffer::SetPredictor(std::unique_ptr<InputPredictor> predictor) {
+    m_predictor = std::move(predictor);
+    
+    // Catch it up on what has already arrived
+    for (uint32_t frame = m_oldestFrame > 0 ? m_oldestFrame : 1; frame <= m_contiguousFrame; ++frame) {
+        m_predictor->Observe(GetInputMask(frame));
+    }
+}
+
 uint32_t InputBuffer::PredictNextInput() const {
-    // Simple prediction: return last input
-    // More sophisticated prediction could analyze patterns
-    return m_lastInput;
+    return PredictInput(m_lastReceivedFrame + 1);
+}
+
+uint32_t InputBuffer::PredictInput(uint32_t frame) const {
+    // The predictor has seen every frame up to the contiguous one
+    uint32_t framesAhead = frame > m_contiguousFrame ? frame - m_contiguousFrame : 1;
+    return m_predictor->Predict(framesAhead);
+}
+
+void InputBuffer::RefreshPredictions() {
+    // Everything after a misprediction is resimulated anyway, so guesses
+    // made before the correction arrived can be redone at no cost
+    if (!m_mispredictedFrame.has_value()) {
+        return;
+    }
+    
+    uint32_t first = std::max(*m_mispredictedFrame, m_contiguousFrame) + 1;
+    for (uint32_t frame = first; frame <= m_lastReceivedFrame; ++frame) {
+        if (!IsFrameInBuffer(frame)) continue;
+        
+        InputFrame& input = m_buffer[GetBufferIndex(frame)];
+        if (input.frame == frame && input.predicted) {
+            input.inputMask = PredictInput(frame);
+        }
+    }
 }
 
 void InputBuffer::UpdatePrediction(uint32_t frame, uint32_t actualInput) {
@@ -171,6 +248,10 @@ void InputBuffer::UpdatePrediction(uint32_t frame, uint32_t actualInput) {
             // Misprediction - update the input
             input.inputMask = actualInput;
             input.predicted = false;
+
+            if (!m_mispredictedFrame.has_value() || frame < *m_mispredictedFrame) {
+                m_mispredictedFrame = frame;
+            }
         }
     }
 }
@@ -184,10 +265,13 @@ void InputBuffer::Clear() {
     m_lastConfirmedFrame = 0;
     m_lastReceivedFrame = 0;
     m_oldestFrame = 0;
+    m_contiguousFrame = 0;
+    m_mispredictedFrame.reset();
     m_lastInput = 0;
     m_predictionHits = 0;
     m_predictionMisses = 0;
     m_predictionAccuracy = 1.0f;
+    m_predictor->Reset();
 }
 
 void InputBuffer::RemoveOldFrames(uint32_t currentFrame) {
@@ -223,6 +307,22 @@ size_t InputBuffer::GetBufferIndex(uint32_t frame) const {
     return frame % BUFFER_SIZE;
 }
 
+void InputBuffer::AdvanceContiguousFrame() {
+    // Frames that fell out of the ring can never be filled in
+    if (m_lastReceivedFrame >= BUFFER_SIZE && m_contiguousFrame < m_lastReceivedFrame - BUFFER_SIZE) {
+        m_contiguousFrame = m_lastReceivedFrame - BUFFER_SIZE;
+    }
+    
+    while (m_contiguousFrame < m_lastReceivedFrame) {
+        auto next = GetInput(m_contiguousFrame + 1);
+        if (!next.has_value() || next->predicted) {
+            break;
+        }
+        m_contiguousFrame++;
+        m_predictor->Observe(next->inputMask);
+    }
+}
+
 bool InputBuffer::IsFrameInBuffer(uint32_t frame) const {
     if (frame < m_oldestFrame || m_lastReceivedFrame == 0) {
         return false;
@@ -304,7 +404,7 @@ void InputBufferManager::PredictMissingInputs(uint32_t currentFrame) {
         // Predict inputs for frames we haven't received yet
         for (uint32_t frame = lastReceived + 1; frame <= currentFrame; ++frame) {
             if (!buffer->GetInput(frame).has_value()) {
-                uint32_t predicted = buffer->PredictNextInput();
+                uint32_t predicted = buffer->PredictInput(frame);
                 buffer->AddPredictedInput(frame, predicted);
             }
         }
@@ -4,6 +4,8 @@
 #include <vector>
 #include <unordered_map>
 #include <optional>
+#include <memory>
+#include "InputPredictor.h"
 
 namespace ArenaFighter {
 
@@ -30,6 +32,11 @@ public:
     void AddInput(const InputFrame& input);
     void AddPredictedInput(uint32_t frame, uint32_t predictedMask);
     
+    // Add a run of consecutive received frames starting at firstFrame.
+    // Frames already received are skipped and predicted ones are corrected.
+    // Returns the number of frames that were new.
+    size_t AddInput(uint32_t firstFrame, const uint32_t* inputMasks, size_t count, uint16_t inputId);
+    
     // Retrieve input for specific frame
     std::optional<InputFrame> GetInput(uint32_t frame) const;
     uint32_t GetInputMask(uint32_t frame) const;
@@ -41,13 +48,24 @@ public:
     // Rollback support
     uint32_t GetLastConfirmedFrame() const { return m_lastConfirmedFrame; }
     uint32_t GetLastReceivedFrame() const { return m_lastReceivedFrame; }
+    uint32_t GetContiguousFrame() const { return m_contiguousFrame; }
     bool NeedsRollback(uint32_t currentFrame) const;
+    
+    // Earliest frame whose prediction was contradicted by a received input
+    // since the last ClearMisprediction()
+    std::optional<uint32_t> GetMispredictedFrame() const { return m_mispredictedFrame; }
+    void ClearMisprediction() { m_mispredictedFrame.reset(); }
     std::vector<uint32_t> GetUnconfirmedFrames() const;
     
-    // Prediction helpers
-    uint32_t PredictNextInput() const;
+    // Prediction helpers. The predictor sees every frame once the frames
+    // before it have arrived; NGramPredictor by default.
+    void SetPredictor(std::unique_ptr<InputPredictor> predictor);
+    uint32_t PredictNextInput() const;                 // Frame after the last received one
+    uint32_t PredictInput(uint32_t frame) const;
     void UpdatePrediction(uint32_t frame, uint32_t actualInput);
     float GetPredictionAccuracy() const { return m_predictionAccuracy; }
+    uint32_t GetPredictionHits() const { return m_predictionHits; }
+    uint32_t GetPredictionMisses() const { return m_predictionMisses; }
     
     // Buffer management
     void Clear();
@@ -67,8 +85,11 @@ private:
     uint32_t m_lastConfirmedFrame;
     uint32_t m_lastReceivedFrame;
     uint32_t m_oldestFrame;
+    uint32_t m_contiguousFrame;   // Every frame up to here has been received
+    std::optional<uint32_t> m_mispredictedFrame;
     
     // Prediction stats
+    std::unique_ptr<InputPredictor> m_predictor;
     uint32_t m_lastInput;
     float m_predictionAccuracy;
     uint32_t m_predictionHits;
@@ -77,6 +98,8 @@ private:
     // Helper functions
     size_t GetBufferIndex(uint32_t frame) const;
     bool IsFrameInBuffer(uint32_t frame) const;
+    void AdvanceContiguousFrame();
+    void RefreshPredictions();
 };
 
 // Input buffer manager for all players
@@ -0,0 +1,223 @@
+#include "InputPredictor.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+namespace {
+
+constexpr float INITIAL_PRESS_FRAMES = 6.0f;
+constexpr float PRESS_SMOOTHING = 0.125f;
+
+// Halving every count in a context at this point keeps them in range and
+// lets newer habits overtake older ones
+constexpr uint16_t MAX_COUNT = 64;
+
+} // namespace
+
+// HoldReleasePredictor
+
+HoldReleasePredictor::HoldReleasePredictor(uint32_t heldMask)
+    : m_heldMask(heldMask)
+    , m_last(0)
+    , m_buttonFrames(0)
+    , m_pressFrames(INITIAL_PRESS_FRAMES) {
+}
+
+void HoldReleasePredictor::Observe(uint32_t inputMask) {
+    uint32_t buttons = inputMask & ~m_heldMask;
+    uint32_t lastButtons = m_last & ~m_heldMask;
+
+    if (buttons == lastButtons) {
+        m_buttonFrames++;
+    } else {
+        if (lastButtons != 0) {
+            m_pressFrames += (static_cast<float>(m_buttonFrames) - m_pressFrames) * PRESS_SMOOTHING;
+        }
+        m_buttonFrames = 1;
+    }
+    m_last = inputMask;
+}
+
+uint32_t HoldReleasePredictor::Predict(uint32_t framesAhead) const {
+    return Step(m_last, m_buttonFrames + framesAhead - 1);
+}
+
+uint32_t HoldReleasePredictor::Step(uint32_t mask, uint32_t runFrames) const {
+    if ((mask & ~m_heldMask) != 0 && static_cast<float>(runFrames) + 0.5f >= m_pressFrames) {
+        return mask & m_heldMask;
+    }
+    return mask;
+}
+
+void HoldReleasePredictor::Reset() {
+    m_last = 0;
+    m_buttonFrames = 0;
+    m_pressFrames = INITIAL_PRESS_FRAMES;
+}
+
+// NGramPredictor
+
+namespace {
+
+constexpr uint32_t NO_BUCKET = UINT32_MAX;
+constexpr uint32_t MAX_HITS = 1024;   // Fallback scores are halved here
+
+size_t HashContext(uint32_t mask, uint32_t previous, uint32_t bucket, size_t size) {
+    uint32_t hash = mask * 0x9E3779B1u;
+    hash ^= previous * 0x85EBCA77u;
+    hash ^= bucket * 0xC2B2AE3Du;
+    hash ^= hash >> 15;
+    return hash & (size - 1);
+}
+
+} // namespace
+
+void NGramPredictor::Context::Advance(uint32_t next) {
+    if (next == mask) {
+        run = std::min(run + 1, UINT32_MAX - 1);
+    } else {
+        previous = mask;
+        mask = next;
+        run = 1;
+    }
+}
+
+NGramPredictor::NGramPredictor(uint32_t heldMask)
+    : m_holdRelease(heldMask)
+    , m_tables(std::make_unique<Tables>()) {
+    Reset();
+}
+
+uint32_t NGramPredictor::GetBucket(uint32_t run) {
+    // Taps are told apart frame by frame, long holds only roughly
+    if (run <= 4) return run;
+    if (run <= 6) return 5;
+    if (run <= 8) return 6;
+    if (run <= 12) return 7;
+    if (run <= 16) return 8;
+    if (run <= 24) return 9;
+    if (run <= 32) return 10;
+    return 11;
+}
+
+NGramPredictor::Entry& NGramPredictor::FindEntry(Entry* table, size_t size,
+                                                 uint32_t mask, uint32_t previous, uint32_t bucket) {
+    return table[HashContext(mask, previous, bucket, size)];
+}
+
+void NGramPredictor::Count(Entry& entry, uint32_t mask, uint32_t previous, uint32_t bucket, uint32_t next) {
+    if (entry.bucket != bucket || entry.mask != mask || entry.previous != previous) {
+        // Evict whatever context shared the slot
+        entry = Entry{ mask, previous, bucket, 0, {} };
+    }
+
+    Candidate* slot = &entry.candidates[0];
+    for (Candidate& candidate : entry.candidates) {
+        if (candidate.count > 0 && candidate.mask == next) {
+            slot = &candidate;
+            break;
+        }
+        if (candidate.count < slot->count) {
+            slot = &candidate;
+        }
+    }
+    if (slot->count == 0 || slot->mask != next) {
+        entry.total -= slot->count;
+        *slot = Candidate{ next, 0 };
+    }
+
+    slot->count++;
+    entry.total++;
+    if (slot->count >= MAX_COUNT) {
+        entry.total = 0;
+        for (Candidate& candidate : entry.candidates) {
+            candidate.count /= 2;
+            entry.total += candidate.count;
+        }
+    }
+}
+
+bool NGramPredictor::PredictFrom(const Entry& entry, uint32_t mask, uint32_t previous, uint32_t bucket,
+                                 uint32_t& next) {
+    if (entry.bucket != bucket || entry.mask != mask || entry.previous != previous ||
+        entry.total < MIN_CONFIDENCE) {
+        return false;
+    }
+
+    // Ties go to holding the input, the cheaper mistake
+    const Candidate* best = nullptr;
+    for (const Candidate& candidate : entry.candidates) {
+        if (candidate.count == 0) continue;
+        if (!best || candidate.count > best->count ||
+            (candidate.count == best->count && candidate.mask == mask)) {
+            best = &candidate;
+        }
+    }
+
+    next = best->mask;
+    return true;
+}
+
+uint32_t NGramPredictor::PredictStep(const Context& context) const {
+    uint32_t bucket = GetBucket(context.run);
+    uint32_t next;
+
+    const Entry& longEntry = FindEntry(m_tables->longContexts.data(), LONG_TABLE_SIZE,
+                                       context.mask, context.previous, bucket);
+    if (PredictFrom(longEntry, context.mask, context.previous, bucket, next)) {
+        return next;
+    }
+
+    const Entry& shortEntry = FindEntry(m_tables->shortContexts.data(), SHORT_TABLE_SIZE,
+                                        context.mask, 0, bucket);
+    if (PredictFrom(shortEntry, context.mask, 0, bucket, next)) {
+        return next;
+    }
+
+    return m_holdReleaseHits > m_repeatHits ? m_holdRelease.Step(context.mask, context.run) : context.mask;
+}
+
+void NGramPredictor::Observe(uint32_t inputMask) {
+    if (m_observed) {
+        // Score both fallbacks on the guess they would have made
+        m_repeatHits += m_context.mask == inputMask ? 1 : 0;
+        m_holdReleaseHits += m_holdRelease.Predict(1) == inputMask ? 1 : 0;
+        if (m_repeatHits >= MAX_HITS || m_holdReleaseHits >= MAX_HITS) {
+            m_repeatHits /= 2;
+            m_holdReleaseHits /= 2;
+        }
+
+        uint32_t bucket = GetBucket(m_context.run);
+        Count(FindEntry(m_tables->longContexts.data(), LONG_TABLE_SIZE, m_context.mask, m_context.previous, bucket),
+              m_context.mask, m_context.previous, bucket, inputMask);
+        Count(FindEntry(m_tables->shortContexts.data(), SHORT_TABLE_SIZE, m_context.mask, 0, bucket),
+              m_context.mask, 0, bucket, inputMask);
+    }
+
+    m_holdRelease.Observe(inputMask);
+    m_context.Advance(inputMask);
+    m_observed = true;
+}
+
+uint32_t NGramPredictor::Predict(uint32_t framesAhead) const {
+    Context context = m_context;
+    for (uint32_t i = 0; i < framesAhead; ++i) {
+        context.Advance(PredictStep(context));
+    }
+    return context.mask;
+}
+
+void NGramPredictor::Reset() {
+    m_holdRelease.Reset();
+    m_repeatHits = 0;
+    m_holdReleaseHits = 0;
+    m_context = Context{};
+    m_observed = false;
+
+    Entry empty{};
+    empty.bucket = NO_BUCKET;
+    m_tables->longContexts.fill(empty);
+    m_tables->shortContexts.fill(empty);
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace ArenaFighter {
+
+// Guesses a remote player's upcoming inputs while they are still in
+// flight. InputBuffer feeds it every received frame in order and asks it
+// for frames past the newest one. Wrong guesses cost a rollback, so each
+// percent of accuracy saves resimulation work; a guess must be cheap, as
+// it runs for every missing frame of every tick.
+class InputPredictor {
+public:
+    virtual ~InputPredictor() = default;
+
+    // The input of the next frame, in frame order
+    virtual void Observe(uint32_t inputMask) = 0;
+
+    // Input framesAhead frames after the last observed one (1 = next)
+    virtual uint32_t Predict(uint32_t framesAhead) const = 0;
+
+    virtual void Reset() = 0;
+};
+
+// Repeats the last input; right for as long as nothing changes
+class RepeatLastPredictor : public InputPredictor {
+public:
+    void Observe(uint32_t inputMask) override { m_last = inputMask; }
+    uint32_t Predict(uint32_t) const override { return m_last; }
+    void Reset() override { m_last = 0; }
+
+private:
+    uint32_t m_last = 0;
+};
+
+// Directions are held, buttons are tapped. heldMask selects the direction
+// bits, which are repeated indefinitely. Buttons are predicted released
+// once they have been down for this player's usual press length, a
+// running average of their completed presses.
+class HoldReleasePredictor : public InputPredictor {
+public:
+    static constexpr uint32_t DEFAULT_HELD_MASK = 0xF;   // Up, Down, Left, Right
+
+    explicit HoldReleasePredictor(uint32_t heldMask = DEFAULT_HELD_MASK);
+
+    void Observe(uint32_t inputMask) override;
+    uint32_t Predict(uint32_t framesAhead) const override;
+    void Reset() override;
+
+    // The input after mask, which has been unchanged for runFrames
+    uint32_t Step(uint32_t mask, uint32_t runFrames) const;
+
+private:
+    uint32_t m_heldMask;
+    uint32_t m_last;
+    uint32_t m_buttonFrames;    // Frames the current buttons have been down
+    float m_pressFrames;        // Average press length
+};
+
+// Learns each player's habits online: counts which input followed each
+// recent context and predicts the most frequent one. The long context is
+// the current input, the one before it and how long the current one has
+// been held (exact up to four frames, bucketed beyond), so fixed-length
+// presses and repeated sequences such as combos and dash inputs are
+// picked up after a few repetitions. Contexts seen too rarely back off to
+// the current input and hold length alone, then to whichever of
+// RepeatLastPredictor and HoldReleasePredictor has been right more often
+// for this player.
+//
+// Both tables are direct-mapped and fixed-size, so observing and
+// predicting never allocate; counts are halved when one saturates, so old
+// habits fade. Predicting several frames ahead chains single-frame
+// guesses.
+class NGramPredictor : public InputPredictor {
+public:
+    static constexpr size_t LONG_TABLE_SIZE = 512;    // Contexts, power of two
+    static constexpr size_t SHORT_TABLE_SIZE = 128;
+    static constexpr size_t CANDIDATES = 4;           // Next inputs tracked per context
+    static constexpr uint16_t MIN_CONFIDENCE = 3;     // Observations before a context is trusted
+
+    explicit NGramPredictor(uint32_t heldMask = HoldReleasePredictor::DEFAULT_HELD_MASK);
+
+    void Observe(uint32_t inputMask) override;
+    uint32_t Predict(uint32_t framesAhead) const override;
+    void Reset() override;
+
+private:
+    struct Context {
+        uint32_t mask = 0;
+        uint32_t previous = 0;   // Last input that differed from mask
+        uint32_t run = 0;        // Frames mask has been held
+
+        void Advance(uint32_t next);
+    };
+
+    struct Candidate {
+        uint32_t mask;
+        uint16_t count;
+    };
+
+    struct Entry {
+        uint32_t mask;
+        uint32_t previous;
+        uint32_t bucket;         // Hold length bucket; NO_BUCKET when empty
+        uint32_t total;          // Sum of candidate counts
+        Candidate candidates[CANDIDATES];
+    };
+
+    struct Tables {
+        std::array<Entry, LONG_TABLE_SIZE> longContexts;
+        std::array<Entry, SHORT_TABLE_SIZE> shortContexts;   // previous is always 0
+    };
+
+    static uint32_t GetBucket(uint32_t run);
+    static Entry& FindEntry(Entry* table, size_t size, uint32_t mask, uint32_t previous, uint32_t bucket);
+    static void Count(Entry& entry, uint32_t mask, uint32_t previous, uint32_t bucket, uint32_t next);
+    static bool PredictFrom(const Entry& entry, uint32_t mask, uint32_t previous, uint32_t bucket, uint32_t& next);
+    uint32_t PredictStep(const Context& context) const;
+
+    HoldReleasePredictor m_holdRelease;
+    uint32_t m_repeatHits;         // One-frame hits of each fallback, decayed
+    uint32_t m_holdReleaseHits;
+
+    Context m_context;
+    bool m_observed;
+    std::unique_ptr<Tables> m_tables;
+};
+
+} // namespace ArenaFighter
@@ -0,0 +1,128 @@
+#include "LinkEmulator.h"
+#include <algorithm>
+#include <chrono>
+
+namespace ArenaFighter {
+
+namespace {
+
+double GetNowMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+LinkEmulator::LinkEmulator(uint32_t seed)
+    : m_nextOrder(0)
+    , m_random(seed)
+    , m_unit(0.0, 1.0) {
+}
+
+LinkEmulator::~LinkEmulator() {
+    Stop();
+}
+
+bool LinkEmulator::Start(const UdpEndpoint& server) {
+    Stop();
+    m_server = server;
+    return m_clientSocket.Open(0);
+}
+
+void LinkEmulator::Stop() {
+    m_clientSocket.Close();
+    m_routes.clear();
+    m_inFlight = {};
+}
+
+void LinkEmulator::SetConditions(const LinkConditions& toServer, const LinkConditions& toClient) {
+    m_conditions[ToServer] = toServer;
+    m_conditions[ToClient] = toClient;
+}
+
+LinkEmulator::Route* LinkEmulator::FindRoute(const UdpEndpoint& client) {
+    for (auto& route : m_routes) {
+        if (route->client == client) {
+            return route.get();
+        }
+    }
+
+    auto route = std::make_unique<Route>();
+    route->client = client;
+    route->serverSocket = std::make_unique<UdpSocket>();
+    if (!route->serverSocket->Open(0)) {
+        return nullptr;
+    }
+    m_routes.push_back(std::move(route));
+    return m_routes.back().get();
+}
+
+void LinkEmulator::Update() {
+    if (!m_clientSocket.IsOpen()) {
+        return;
+    }
+
+    double nowMs = GetNowMs();
+    UdpDatagram datagrams[UdpSocket::MAX_BATCH];
+
+    size_t count;
+    while ((count = m_clientSocket.ReceiveBatch(datagrams, UdpSocket::MAX_BATCH)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            if (Route* route = FindRoute(datagrams[i].endpoint)) {
+                Schedule(*route, ToServer, route->serverSocket.get(), m_server, datagrams[i], nowMs);
+            }
+        }
+    }
+
+    for (auto& route : m_routes) {
+        while ((count = route->serverSocket->ReceiveBatch(datagrams, UdpSocket::MAX_BATCH)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                Schedule(*route, ToClient, &m_clientSocket, route->client, datagrams[i], nowMs);
+            }
+        }
+    }
+
+    while (!m_inFlight.empty() && m_inFlight.top().deliveryMs <= nowMs) {
+        const InFlight& due = m_inFlight.top();
+        UdpDatagram datagram;
+        datagram.endpoint = due.destination;
+        datagram.data = due.data.data();
+        datagram.size = due.data.size();
+        due.socket->SendBatch(&datagram, 1);
+        m_stats[due.direction].delivered++;
+        m_inFlight.pop();
+    }
+}
+
+void LinkEmulator::Schedule(Route& route, Direction direction, UdpSocket* socket,
+                            const UdpEndpoint& destination, const UdpDatagram& datagram, double nowMs) {
+    const LinkConditions& conditions = m_conditions[direction];
+    LinkStats& stats = m_stats[direction];
+    stats.received++;
+
+    if (NextUnit() < conditions.loss) {
+        stats.dropped++;
+        return;
+    }
+
+    int copies = NextUnit() < conditions.duplicate ? 2 : 1;
+    stats.duplicated += copies - 1;
+
+    for (int copy = 0; copy < copies; ++copy) {
+        double deliveryMs = nowMs + conditions.latencyMs + conditions.jitterMs * NextUnit();
+
+        if (NextUnit() < conditions.reorder) {
+            // Held back; later datagrams overtake it
+            deliveryMs += conditions.reorderDelayMs;
+            stats.reordered++;
+        } else {
+            deliveryMs = std::max(deliveryMs, route.lastDeliveryMs[direction]);
+            route.lastDeliveryMs[direction] = deliveryMs;
+        }
+
+        m_inFlight.push(InFlight{ deliveryMs, m_nextOrder++, direction, socket, destination,
+                                  std::vector<uint8_t>(datagram.data, datagram.data + datagram.size) });
+    }
+}
+
+} // namespace ArenaFighter
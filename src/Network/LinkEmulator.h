@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+#include "UdpSocket.h"
+
+namespace ArenaFighter {
+
+// Impairments applied to one direction of an emulated link
+struct LinkConditions {
+    float latencyMs = 0.0f;    // One-way base delay
+    float jitterMs = 0.0f;     // Uniform extra delay in [0, jitterMs)
+    float loss = 0.0f;         // Fraction of datagrams dropped (0-1)
+    float reorder = 0.0f;      // Fraction held back behind later datagrams
+    float duplicate = 0.0f;    // Fraction delivered twice
+    float reorderDelayMs = 20.0f;   // How long a reordered datagram is held back
+};
+
+struct LinkStats {
+    uint64_t received = 0;
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;
+    uint64_t reordered = 0;
+    uint64_t duplicated = 0;
+};
+
+// In-process UDP relay that puts a bad network between two peers on
+// loopback. Clients connect to GetLocalPort() instead of the server; each
+// client gets its own server-facing socket, so the server sees them as
+// separate endpoints. Every datagram is delayed, dropped, held back or
+// duplicated according to the conditions of its direction.
+//
+// Jitter alone never reorders: like most real paths, a datagram is not
+// delivered before one sent earlier on the same route. Reordering happens
+// only at the configured rate. Outcomes are deterministic for a given
+// seed and arrival order.
+//
+// Nothing runs in the background: call Update() at least once a
+// millisecond from the thread that drives the peers.
+class LinkEmulator {
+public:
+    enum Direction { ToServer = 0, ToClient = 1 };
+
+    explicit LinkEmulator(uint32_t seed = 1);
+    ~LinkEmulator();
+
+    LinkEmulator(const LinkEmulator&) = delete;
+    LinkEmulator& operator=(const LinkEmulator&) = delete;
+
+    bool Start(const UdpEndpoint& server);
+    void Stop();
+    int GetLocalPort() const { return m_clientSocket.GetLocalPort(); }
+
+    void SetConditions(const LinkConditions& toServer, const LinkConditions& toClient);
+    void SetConditions(const LinkConditions& both) { SetConditions(both, both); }
+
+    // Forwards everything received and delivers what is due
+    void Update();
+
+    const LinkStats& GetStats(Direction direction) const { return m_stats[direction]; }
+    size_t GetInFlight() const { return m_inFlight.size(); }
+
+private:
+    struct Route {
+        UdpEndpoint client;
+        std::unique_ptr<UdpSocket> serverSocket;
+        double lastDeliveryMs[2] = {};   // By Direction
+    };
+
+    struct InFlight {
+        double deliveryMs;
+        uint64_t order;          // Ties go to the earlier datagram
+        Direction direction;
+        UdpSocket* socket;
+        UdpEndpoint destination;
+        std::vector<uint8_t> data;
+
+        bool operator>(const InFlight& other) const {
+            return deliveryMs != other.deliveryMs ? deliveryMs > other.deliveryMs : order > other.order;
+        }
+    };
+
+    Route* FindRoute(const UdpEndpoint& client);
+    void Schedule(Route& route, Direction direction, UdpSocket* socket, const UdpEndpoint& destination,
+                  const UdpDatagram& datagram, double nowMs);
+    double NextUnit() { return m_unit(m_random); }
+
+    UdpEndpoint m_server;
+    UdpSocket m_clientSocket;
+    std::vector<std::unique_ptr<Route>> m_routes;
+
+    LinkConditions m_conditions[2];
+    LinkStats m_stats[2];
+
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<InFlight>> m_inFlight;
+    uint64_t m_nextOrder;
+
+    std::mt19937 m_random;
+    std::uniform_real_distribution<double> m_unit;
+};
+
+} // namespace ArenaFighter
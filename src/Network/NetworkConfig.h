@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ArenaFighter {
+
+struct NetworkConfig {
+    static constexpr int TICK_RATE = 60;
+    static constexpr int SEND_RATE = 30;
+    static constexpr int MAX_ROLLBACK_FRAMES = 7;
+    static constexpr int INTERPOLATION_DELAY_MS = 100;
+    static constexpr int MAX_PREDICTION_FRAMES = 8;
+    static constexpr int PACKET_SIZE_LIMIT = 1400;
+    static constexpr int COMPRESSION_THRESHOLD = 256;
+    static constexpr int INITIAL_INPUT_DELAY = 3;      // Frames, until a round trip is measured
+    static constexpr int MIN_INPUT_DELAY = 1;
+    static constexpr int MAX_INPUT_DELAY = 8;
+    static constexpr int ROLLBACK_BUDGET_FRAMES = 3;   // Latency hidden by rollback, not delay
+    static constexpr int INPUT_DELAY_RAISE_TICKS = 10; // Min ticks between two raises
+    static constexpr int INPUT_DELAY_LOWER_TICKS = 120; // Target must stay lower this long
+    static constexpr int PING_INTERVAL_TICKS = 6;
+    static constexpr float TIME_SYNC_GAIN = 0.05f;     // Tick slowdown per frame of lead
+    static constexpr float MAX_TICK_SLOWDOWN = 0.1f;
+    static constexpr int MAX_DATAGRAMS_PER_SEND = 64;
+    static constexpr int NETWORK_THREAD_WAIT_MS = 100;   // Idle socket wait; sends and Stop() cut it short
+    static constexpr size_t PACKET_POOL_SIZE = 256;   // Pooled packets per class, per pool
+    static constexpr size_t SEND_QUEUE_SIZE = 1024;   // Queued packets per priority
+    static constexpr int INPUT_HISTORY_FRAMES = 8;
+    static constexpr int DESYNC_CHECK_INTERVAL = 1;   // Frames between state hashes
+    static constexpr int STATE_HASHES_PER_SYNC = 8;   // Hashes batched into one MatchSync
+};
+
+} // namespace ArenaFighter
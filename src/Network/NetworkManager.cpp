@@ -1,9 +1,16 @@
 #include "NetworkManager.h"
 #include "NetworkPacket.h"
 #include "InputBuffer.h"
+#include "RollbackEngine.h"
+#include "Replay.h"
+#include "../Core/DeterministicRandom.h"
 #include <iostream>
 #include <algorithm>
 #include <thread>
+#include <cstring>
+#include <cstddef>
+#include <cmath>
+#include <ctime>
 
 namespace ArenaFighter {
 
@@ -13,12 +20,17 @@ NetworkManager::NetworkManager()
     , m_tickAccumulator(0.0f)
     , m_sendAccumulator(0.0f)
     , m_sequenceNumber(0)
-    , m_lastReceivedSequence(0)
     , m_currentMatchId(0)
     , m_currentGameMode(0)
+    , m_currentStageId(0)
     , m_randomSeed(0)
-    , m_socket(nullptr)
-    , m_server(nullptr) {
+    , m_rollbackEngine(nullptr)
+    , m_nextPlayerId(2)
+    , m_isHost(false)
+    , m_sendArena(NetworkConfig::MAX_DATAGRAMS_PER_SEND, ReliableConnection::ACK_SIZE)
+    , m_desyncDumped(false)
+    , m_tickCount(0)
+    , m_lastInputFrame(0) {
     
     m_lastTickTime = std::chrono::steady_clock::now();
     m_lastSendTime = std::chrono::steady_clock::now();
@@ -34,6 +46,12 @@ bool NetworkManager::Initialize() {
     RegisterPacketHandler(static_cast<uint16_t>(PacketType::PlayerStateUpdate),
         [this](NetworkPacket* packet) { HandlePlayerState(packet); });
     
+    RegisterPacketHandler(static_cast<uint16_t>(PacketType::DeltaState),
+        [this](NetworkPacket* packet) { HandleDeltaState(packet); });
+    
+    RegisterPacketHandler(static_cast<uint16_t>(PacketType::Acknowledge),
+        [this](NetworkPacket* packet) { HandleAcknowledge(packet); });
+    
     RegisterPacketHandler(static_cast<uint16_t>(PacketType::InputCommand),
         [this](NetworkPacket* packet) { HandleInput(packet); });
     
@@ -46,6 +64,11 @@ bool NetworkManager::Initialize() {
     RegisterPacketHandler(static_cast<uint16_t>(PacketType::MatchStart),
         [this](NetworkPacket* packet) { HandleMatchStart(packet); });
     
+    RegisterPacketHandler(static_cast<uint16_t>(PacketType::MatchSync),
+        [this](NetworkPacket* packet) { HandleMatchSync(packet); });
+    
+    m_desyncDetector.SetOnDesync([this](const DesyncReport& report) { HandleDesync(report); });
+    
     // Initialize input buffer for local player
     m_playerInputBuffers[m_localPlayerId] = std::make_unique<InputBuffer>(m_localPlayerId);
     
@@ -58,12 +81,10 @@ void NetworkManager::Shutdown() {
     m_playerInputBuffers.clear();
     m_packetHandlers.clear();
     
-    while (!m_incomingPackets.empty()) {
-        m_incomingPackets.pop();
-    }
-    
-    while (!m_outgoingPackets.empty()) {
-        m_outgoingPackets.pop();
+    PacketPtr dropped;
+    for (auto& queue : m_outgoingPackets) {
+        while (queue.TryPop(dropped)) {
+        }
     }
 }
 
@@ -76,8 +97,8 @@ void NetworkManager::Update(float deltaTime) {
     m_tickAccumulator += deltaTime;
     m_sendAccumulator += deltaTime;
     
-    // Fixed tick update (60Hz)
-    const float tickInterval = 1.0f / NetworkConfig::TICK_RATE;
+    // Fixed tick update (60Hz), stretched while a peer catches up
+    const float tickInterval = m_timeSync.GetTickScale() / NetworkConfig::TICK_RATE;
     while (m_tickAccumulator >= tickInterval) {
         TickUpdate();
         m_tickAccumulator -= tickInterval;
@@ -90,7 +111,7 @@ void NetworkManager::Update(float deltaTime) {
         m_sendAccumulator -= sendInterval;
     }
     
-    // Process incoming packets
+    // Everything the network thread has received since the last frame
     ProcessIncomingPackets();
     
     // Update network stats
@@ -101,50 +122,347 @@ void NetworkManager::TickUpdate() {
     // Update input buffers
     UpdateInputBuffers();
     
-    // Check for rollback conditions
-    for (auto& [playerId, buffer] : m_playerInputBuffers) {
-        if (buffer->NeedsRollback(m_sequenceNumber)) {
-            m_stats.rollbackFrames++;
+    // The engine does the actual rollbacks; mirror what it resimulated
+    if (m_rollbackEngine) {
+        m_stats.rollbackFrames = static_cast<int>(m_rollbackEngine->GetStats().resimulatedFrames);
+    }
+    
+    SendStateHashes();
+    
+    // Adapt input delay and pacing to what the Pings have measured
+    m_tickCount++;
+    m_timeSync.Update();
+    if (m_tickCount % NetworkConfig::PING_INTERVAL_TICKS == 0) {
+        SendPings();
+    }
+    
+    m_stats.inputDelay = m_timeSync.GetInputDelay();
+    m_stats.frameAdvantage = m_timeSync.GetFrameAdvantage();
+    m_stats.tickScale = m_timeSync.GetTickScale();
+}
+
+void NetworkManager::SendPings() {
+    if (m_connectionState == ConnectionState::Connecting) {
+        return;
+    }
+    
+    // One per peer; the host's fan out to everyone and the others ignore them
+    for (const auto& peer : m_peers) {
+        auto ping = CreatePacket<TimeSyncPacket>(PacketType::Ping);
+        ping->playerId = m_localPlayerId;
+        ping->targetId = peer.playerId;
+        ping->frame = GetLocalFrame();
+        ping->frameTimestamp = GetTimestampMs();
+        ping->frameAdvantage = m_timeSync.GetFrameAdvantage(peer.playerId);
+        SendPacket(std::move(ping), false);
+    }
+}
+
+void NetworkManager::HandleTimeSync(const UdpEndpoint& source, NetworkPacket* packet, uint32_t arrivalMs) {
+    auto timing = static_cast<TimeSyncPacket*>(packet);
+    
+    auto peerIt = std::find_if(m_peers.begin(), m_peers.end(),
+        [&source](const RemotePeer& peer) { return peer.endpoint == source; });
+    if (peerIt == m_peers.end() || peerIt->playerId != timing->playerId ||
+        timing->targetId != m_localPlayerId) {
+        return;
+    }
+    
+    // How long the sender kept running on after sampling its frame
+    uint32_t queuedMs = timing->GetHeader().timestamp - timing->frameTimestamp;
+    m_timeSync.AddRemoteFrame(timing->playerId, GetLocalFrame(), timing->frame,
+                              static_cast<float>(queuedMs), timing->frameAdvantage);
+    
+    if (packet->GetType() == PacketType::Pong) {
+        // Take out the time the Ping sat with the peer
+        uint32_t heldMs = timing->GetHeader().timestamp - timing->receiveTimestamp;
+        uint32_t rtt = arrivalMs - timing->echoTimestamp - heldMs;
+        m_timeSync.AddRoundTrip(timing->playerId, static_cast<float>(rtt));
+        return;
+    }
+    
+    auto pong = CreatePacket<TimeSyncPacket>(PacketType::Pong);
+    pong->playerId = m_localPlayerId;
+    pong->targetId = timing->playerId;
+    pong->frame = GetLocalFrame();
+    pong->frameTimestamp = GetTimestampMs();
+    pong->frameAdvantage = m_timeSync.GetFrameAdvantage(timing->playerId);
+    pong->echoTimestamp = timing->GetHeader().timestamp;
+    pong->receiveTimestamp = arrivalMs;
+    SendPacket(std::move(pong), false);
+}
+
+uint32_t NetworkManager::GetLocalFrame() const {
+    // Without an engine the newest input frame stands in; every peer
+    // offsets it by the same input delay
+    return m_rollbackEngine ? m_rollbackEngine->GetCurrentFrame() : m_lastInputFrame;
+}
+
+void NetworkManager::SendStateHashes() {
+    // Usually one new hash per tick; after a stall confirms several
+    // frames at once they are batched rather than sent one by one
+    StateHash state;
+    PacketRef<MatchSyncPacket> syncPacket;
+    while (m_desyncDetector.PopOutgoingHash(state)) {
+        if (!syncPacket) {
+            syncPacket = CreatePacket<MatchSyncPacket>();
+            syncPacket->playerId = m_localPlayerId;
         }
+        
+        syncPacket->hashes[syncPacket->hashCount++] = state;
+        if (syncPacket->hashCount == MatchSyncPacket::MAX_HASHES) {
+            SendPacket(std::move(syncPacket), true);
+        }
+    }
+    
+    // Reliable, so no checkpoint goes uncompared, but unordered: a lost
+    // batch never holds up later ones
+    if (syncPacket) {
+        SendPacket(std::move(syncPacket), true);
+    }
+    
+    if (const auto& desync = m_desyncDetector.GetFirstDesync()) {
+        m_stats.desyncDetected = true;
+        m_stats.desyncFrame = desync->frame;
+        m_stats.desyncField = desync->fieldName;
     }
 }
 
+void NetworkManager::SetDesyncDebug(bool enabled, const std::string& dumpDirectory) {
+    m_desyncDetector.SetDebugMode(enabled);
+    m_desyncDumpDirectory = dumpDirectory;
+}
+
+void NetworkManager::HandleDesync(const DesyncReport& report) {
+    // Every frame after a divergence mismatches too; only the first one
+    // is worth a dump
+    if (!m_desyncDetector.IsDebugMode() || m_desyncDumped) {
+        return;
+    }
+    m_desyncDumped = true;
+    
+    std::string path = m_desyncDumpDirectory + "/desync_m" + std::to_string(m_currentMatchId) +
+                       "_f" + std::to_string(report.frame) + "_p" + std::to_string(m_localPlayerId) + ".bin";
+    bool dumped = m_desyncDetector.DumpLocalState(report.frame, path);
+    
+    std::cout << "Desync with player " << report.playerId << " at frame " << report.frame
+              << ": field " << (report.fieldName ? report.fieldName : "unknown")
+              << ", state " << (dumped ? "dumped to " + path : std::string("not dumped")) << "\n";
+}
+
 void NetworkManager::SendUpdate() {
-    // Send all queued packets
-    while (!m_outgoingPackets.empty()) {
-        auto packet = m_outgoingPackets.front();
-        m_outgoingPackets.pop();
+    if (!m_networkThread.IsRunning()) {
+        return;
+    }
+    
+    // Keep asking the host to admit us until it answers
+    if (m_connectionState == ConnectionState::Connecting) {
+        SystemPacket joinRequest(PacketType::PlayerJoined);
+        SendImmediate(joinRequest, m_server);
+    }
+    
+    // Coalesce queued packets into MTU-sized datagrams in the per-tick
+    // arena, Critical first. Once the arena is full the remaining, lower
+    // priority traffic waits for a later tick.
+    m_sendArena.Reset();
+    uint32_t nowMs = GetTimestampMs();
+    
+    bool budgetFull = false;
+    PacketPtr* front;
+    for (auto& queue : m_outgoingPackets) {
+        while (!budgetFull && queue.Peek(&front, 1) == 1) {
+            NetworkPacket& packet = **front;
+            
+            // Each peer's connection numbers, keeps and resends its own copy
+            if (packet.HasFlag(PacketFlags::Reliable)) {
+                for (auto& peer : m_peers) {
+                    peer.reliable->Add(packet, nowMs);
+                }
+                m_stats.packetsSent++;
+                front->reset();
+                queue.Pop();
+                continue;
+            }
+            
+            StampPacket(packet);
+            
+            if (m_sendArena.Write(packet) == 0 && m_sendArena.IsFull()) {
+                m_sequenceNumber--; // Not sent; its sequence goes to the next packet
+                budgetFull = true;
+                break;
+            }
+            
+            // Packets too large for any datagram are dropped here. The
+            // slot keeps its handle until reused, so release it now.
+            front->reset();
+            queue.Pop();
+        }
+    }
+    
+    // Every peer gets the shared datagrams, each ending in the peer's own
+    // reliable messages and ack trailer. The network thread batches them
+    // into as few syscalls as it can.
+    uint8_t tail[NetworkConfig::PACKET_SIZE_LIMIT];
+    for (auto& peer : m_peers) {
+        ReliableConnection& reliable = *peer.reliable;
         
-        // Set sequence and timestamp
-        packet->SetSequence(m_sequenceNumber++);
-        packet->SetTimestamp(static_cast<uint32_t>(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now().time_since_epoch()
-            ).count()
-        ));
+        auto send = [&](const uint8_t* data, size_t size, size_t tailSize) {
+            if (reliable.HasAcks()) {
+                reliable.WriteAcks(tail + tailSize);
+                tailSize += ReliableConnection::ACK_SIZE;
+            }
+            bool sent = size > 0 ? m_networkThread.Send(peer.endpoint, data, size, tail, tailSize)
+                                 : m_networkThread.Send(peer.endpoint, tail, tailSize);
+            if (sent) {
+                m_stats.datagramsSent++;
+                m_stats.bandwidth += static_cast<float>(size + tailSize);
+            }
+        };
         
-        // Calculate checksum
-        std::vector<uint8_t> buffer;
-        packet->Serialize(buffer);
-        packet->GetHeader().checksum = packet->CalculateChecksum(buffer);
+        size_t datagrams = m_sendArena.GetDatagramCount();
+        for (size_t i = 0; i < datagrams; ++i) {
+            size_t size = m_sendArena.GetDatagramSize(i);
+            
+            // Reliable messages fill what the last one has left
+            size_t tailSize = 0;
+            if (i + 1 == datagrams) {
+                tailSize = reliable.WriteDue(tail, ReliableConnection::MAX_MESSAGE_SIZE - size, nowMs);
+            }
+            send(m_sendArena.GetDatagramData(i), size, tailSize);
+        }
         
-        // TODO: Actually send packet via socket
-        // For now, just track stats
+        // Messages that did not fit, or acks with nothing to ride on
+        while (reliable.HasDue(nowMs) || (datagrams == 0 && reliable.HasNewAcks())) {
+            size_t tailSize = reliable.WriteDue(tail, ReliableConnection::MAX_MESSAGE_SIZE, nowMs);
+            if (tailSize == 0 && datagrams > 0) {
+                break;
+            }
+            send(tail, 0, tailSize);
+            datagrams++;
+        }
+    }
+    m_stats.packetsSent += static_cast<int>(m_sendArena.GetPacketCount());
+}
+
+void NetworkManager::StampPacket(NetworkPacket& packet) {
+    // Set sequence and timestamp
+    packet.SetSequence(m_sequenceNumber++);
+    packet.SetTimestamp(GetTimestampMs());
+}
+
+void NetworkManager::SendImmediate(NetworkPacket& packet, const UdpEndpoint& endpoint) {
+    uint8_t buffer[NetworkConfig::PACKET_SIZE_LIMIT];
+    
+    StampPacket(packet);
+    size_t size = packet.Serialize(buffer, sizeof(buffer));
+    if (size == 0) {
+        return;
+    }
+    
+    if (m_networkThread.Send(endpoint, buffer, size)) {
         m_stats.packetsSent++;
-        m_stats.bandwidth += static_cast<float>(buffer.size());
+        m_stats.datagramsSent++;
+        m_stats.bandwidth += static_cast<float>(size);
     }
 }
 
+void NetworkManager::HandleConnectionPacket(const UdpEndpoint& source, NetworkPacket* packet) {
+    auto systemPacket = static_cast<SystemPacket*>(packet);
+    
+    auto peerIt = std::find_if(m_peers.begin(), m_peers.end(),
+        [&source](const RemotePeer& peer) { return peer.endpoint == source; });
+    
+    if (packet->GetType() == PacketType::Disconnect) {
+        if (peerIt == m_peers.end()) {
+            return;
+        }
+        
+        uint32_t playerId = peerIt->playerId;
+        m_peers.erase(peerIt);
+        m_playerInputBuffers.erase(playerId);
+        m_remoteAckFrames.erase(playerId);
+        m_stateEncoder.RemovePeer(playerId);
+        m_timeSync.RemovePeer(playerId);
+        
+        if (!m_isHost) {
+            m_connectionState = ConnectionState::Disconnected;
+        }
+        
+        if (m_onPlayerDisconnected) {
+            m_onPlayerDisconnected(playerId);
+        }
+        return;
+    }
+    
+    if (m_isHost) {
+        // Admit new peers; repeat the answer for retransmitted requests
+        if (peerIt == m_peers.end()) {
+            RemotePeer peer;
+            peer.endpoint = source;
+            peer.playerId = m_nextPlayerId++;
+            m_peers.push_back(std::move(peer));
+            peerIt = m_peers.end() - 1;
+            
+            // peer was moved from; use the stored copy
+            uint32_t playerId = peerIt->playerId;
+            m_playerInputBuffers[playerId] = std::make_unique<InputBuffer>(playerId);
+            m_stateEncoder.AddPeer(playerId);
+            m_timeSync.AddPeer(playerId);
+            
+            if (m_onPlayerConnected) {
+                m_onPlayerConnected(playerId);
+            }
+        }
+        
+        SystemPacket accept(PacketType::PlayerJoined);
+        accept.playerId = peerIt->playerId;
+        SendImmediate(accept, source);
+    } else if (m_connectionState == ConnectionState::Connecting) {
+        SetLocalPlayerId(systemPacket->playerId);
+        m_connectionState = ConnectionState::Connected;
+    }
+}
+
+void NetworkManager::SetLocalPlayerId(uint32_t playerId) {
+    if (playerId == m_localPlayerId) {
+        return;
+    }
+    
+    m_playerInputBuffers.erase(m_localPlayerId);
+    m_localPlayerId = playerId;
+    m_playerInputBuffers[m_localPlayerId] = std::make_unique<InputBuffer>(m_localPlayerId);
+}
+
+int NetworkManager::GetLocalPort() const {
+    return m_networkThread.GetLocalPort();
+}
+
+bool NetworkManager::StartSocket(int port) {
+    auto socket = std::make_unique<UdpSocket>();
+    if (!socket->Open(port)) {
+        return false;
+    }
+    
+    m_networkThread.Start(std::move(socket));
+    return true;
+}
+
 bool NetworkManager::StartHost(int port) {
     if (m_connectionState != ConnectionState::Disconnected) {
         return false;
     }
     
-    // TODO: Implement actual socket creation and binding
-    std::cout << "Starting host on port " << port << std::endl;
+    if (!StartSocket(port)) {
+        std::cout << "Failed to open UDP port " << port << std::endl;
+        return false;
+    }
+    
+    std::cout << "Starting host on port " << GetLocalPort() << std::endl;
     
+    m_isHost = true;
+    m_nextPlayerId = 2;
     m_connectionState = ConnectionState::Connected;
-    m_localPlayerId = 1; // Host is always player 1
+    SetLocalPlayerId(1); // Host is always player 1
     
     return true;
 }
@@ -154,14 +472,30 @@ bool NetworkManager::ConnectToHost(const std::string& address, int port) {
         return false;
     }
     
-    m_connectionState = ConnectionState::Connecting;
+    UdpEndpoint server;
+    if (!UdpEndpoint::Resolve(address, port, server)) {
+        std::cout << "Failed to resolve " << address << std::endl;
+        return false;
+    }
+    
+    // Clients bind an ephemeral port
+    if (!StartSocket(0)) {
+        return false;
+    }
     
-    // TODO: Implement actual socket connection
     std::cout << "Connecting to " << address << ":" << port << std::endl;
     
-    // Simulate connection success
-    m_connectionState = ConnectionState::Connected;
-    m_localPlayerId = 2; // Client gets next available ID
+    m_isHost = false;
+    m_server = server;
+    m_peers.clear();
+    m_peers.push_back(RemotePeer{server, 1});
+    m_stateEncoder.AddPeer(1);
+    m_timeSync.AddPeer(1);
+    m_connectionState = ConnectionState::Connecting;
+    
+    // The host assigns our player id when it accepts the join request
+    SystemPacket joinRequest(PacketType::PlayerJoined);
+    SendImmediate(joinRequest, m_server);
     
     return true;
 }
@@ -171,61 +505,145 @@ void NetworkManager::Disconnect() {
         return;
     }
     
-    // Send disconnect packet
-    auto disconnectPacket = std::make_shared<NetworkPacket>(PacketType::Disconnect);
-    SendPacket(disconnectPacket, true);
+    // Send disconnect packet and flush it before the socket goes away
+    auto disconnectPacket = CreatePacket<SystemPacket>(PacketType::Disconnect);
+    disconnectPacket->playerId = m_localPlayerId;
+    SendPacket(std::move(disconnectPacket), true, true);
+    SendUpdate();
     
     m_connectionState = ConnectionState::Disconnected;
     
-    // TODO: Close actual socket
-    m_socket = nullptr;
-    m_server = nullptr;
+    m_networkThread.Stop();
+    m_peers.clear();
+    m_remoteAckFrames.clear();
+    m_stateEncoder.Clear();
+    m_stateDecoder.Clear();
+    m_desyncDetector.Reset();
+    m_timeSync.Reset();
+    m_server = UdpEndpoint{};
+    m_isHost = false;
 }
 
-void NetworkManager::SendPacket(std::shared_ptr<NetworkPacket> packet, bool reliable) {
+void NetworkManager::SendPacket(PacketPtr packet, bool reliable, bool ordered) {
     if (m_connectionState == ConnectionState::Disconnected) {
         return;
     }
     
-    if (reliable) {
+    if (reliable || ordered) {
         packet->AddFlag(PacketFlags::Reliable);
     }
+    if (ordered) {
+        packet->AddFlag(PacketFlags::Ordered);
+    }
     
-    m_outgoingPackets.push(packet);
+    // A backlog this deep means the link is saturated; the packet is
+    // dropped like any other loss
+    m_outgoingPackets[static_cast<size_t>(packet->GetPriority())].TryPush(std::move(packet));
+}
+
+void NetworkManager::SendPlayerState(const PlayerStatePacket& state) {
+    auto deltaPacket = CreatePacket<DeltaStatePacket>();
+    m_stateEncoder.Encode(state, *deltaPacket);
+    
+    // A lost delta is superseded by the next one, so no resend
+    SendPacket(std::move(deltaPacket), false);
 }
 
 void NetworkManager::ProcessIncomingPackets() {
-    // Process up to 10 packets per frame to avoid stalls
-    int packetsProcessed = 0;
-    while (!m_incomingPackets.empty() && packetsProcessed < 10) {
-        auto packet = m_incomingPackets.front();
-        m_incomingPackets.pop();
+    // Decoding already happened on the network thread, so draining
+    // everything is cheap and a burst never waits for the next frame
+    ReceivedPacket received;
+    while (m_networkThread.Receive(received)) {
+        // Clients only listen to their host
+        if (!m_isHost && received.source != m_server) {
+            continue;
+        }
+        
+        RemotePeer* peer = FindPeer(received.source);
+        if (peer && received.hasAcks) {
+            peer->reliable->ReadAcks(received.acks, received.arrivalMs);
+        }
+        if (!received.packet) {
+            continue;
+        }
+        
+        // Reliable packets are handled once, ordered ones in send order
+        if (received.packet->HasFlag(PacketFlags::Reliable)) {
+            if (!peer || peer->reliable->Receive(received.packet) != ReliableConnection::Arrival::Deliver) {
+                continue;
+            }
+        }
+        DispatchPacket(received);
         
-        ProcessPacket(packet.get());
-        packetsProcessed++;
-        m_stats.packetsReceived++;
+        // An ordered message may have let held ones through. Handling a
+        // Disconnect removes the peer, so look it up again each time.
+        PacketPtr ready;
+        while ((peer = FindPeer(received.source)) && peer->reliable->PopReady(ready)) {
+            received.packet = std::move(ready);
+            DispatchPacket(received);
+        }
     }
 }
 
+void NetworkManager::DispatchPacket(const ReceivedPacket& received) {
+    NetworkPacket* packet = received.packet.get();
+    if (RemotePeer* peer = FindPeer(received.source)) {
+        TrackPacketLoss(*peer, *packet);
+    }
+    
+    PacketType type = packet->GetType();
+    if (type == PacketType::PlayerJoined || type == PacketType::Disconnect) {
+        HandleConnectionPacket(received.source, packet);
+        return;
+    }
+    
+    // Timed by arrival, not by when this frame got around to it
+    if (type == PacketType::Ping || type == PacketType::Pong) {
+        HandleTimeSync(received.source, packet, received.arrivalMs);
+        return;
+    }
+    
+    ProcessPacket(packet);
+    m_stats.packetsReceived++;
+}
+
+NetworkManager::RemotePeer* NetworkManager::FindPeer(const UdpEndpoint& endpoint) {
+    auto peerIt = std::find_if(m_peers.begin(), m_peers.end(),
+        [&endpoint](const RemotePeer& peer) { return peer.endpoint == endpoint; });
+    return peerIt != m_peers.end() ? &*peerIt : nullptr;
+}
+
+void NetworkManager::TrackPacketLoss(RemotePeer& peer, const NetworkPacket& packet) {
+    // Reliable packets are numbered per channel
+    uint32_t sequence = packet.GetHeader().sequence;
+    if (packet.HasFlag(PacketFlags::Reliable) || (peer.hasSequence && sequence <= peer.lastSequence)) {
+        return;
+    }
+    
+    // A peer that joined late starts mid-stream
+    if (!peer.hasSequence) {
+        peer.lastSequence = sequence;
+        peer.hasSequence = true;
+        return;
+    }
+    
+    uint32_t expectedPackets = sequence - peer.lastSequence;
+    uint32_t lostPackets = expectedPackets - 1;
+    peer.packetLoss = (peer.packetLoss * 0.9f) +
+                      (static_cast<float>(lostPackets) / expectedPackets * 0.1f);
+    peer.lastSequence = sequence;
+    
+    // Each link's delay follows its own loss; stats show the worst
+    m_timeSync.SetPacketLoss(peer.playerId, peer.packetLoss);
+    m_stats.packetLoss = m_timeSync.GetPacketLoss();
+}
+
 void NetworkManager::RegisterPacketHandler(uint16_t packetType, 
                                          std::function<void(NetworkPacket*)> handler) {
     m_packetHandlers[packetType] = handler;
 }
 
 void NetworkManager::ProcessPacket(NetworkPacket* packet) {
-    // Update sequence tracking
-    uint32_t sequence = packet->GetHeader().sequence;
-    if (sequence > m_lastReceivedSequence) {
-        // Track packet loss
-        uint32_t expectedPackets = sequence - m_lastReceivedSequence;
-        if (expectedPackets > 1) {
-            uint32_t lostPackets = expectedPackets - 1;
-            m_stats.packetLoss = (m_stats.packetLoss * 0.9f) + 
-                                (static_cast<float>(lostPackets) / expectedPackets * 0.1f);
-        }
-        m_lastReceivedSequence = sequence;
-    }
-    
     // Find and execute handler
     auto it = m_packetHandlers.find(packet->GetHeader().type);
     if (it != m_packetHandlers.end()) {
@@ -234,13 +652,13 @@ void NetworkManager::ProcessPacket(NetworkPacket* packet) {
 }
 
 void NetworkManager::SendInput(uint32_t frame, uint32_t inputMask, uint16_t inputId) {
-    auto inputPacket = std::make_shared<InputPacket>();
+    auto inputPacket = CreatePacket<InputPacket>();
     inputPacket->playerId = m_localPlayerId;
-    inputPacket->inputMask = inputMask;
     inputPacket->inputId = inputId;
     inputPacket->timestamp = static_cast<uint16_t>(frame);
-    
-    SendPacket(inputPacket, true);
+    inputPacket->ackFrame = GetLocalAckFrame();
+    inputPacket->SetSingleInput(frame, inputMask);
+    m_lastInputFrame = std::max(m_lastInputFrame, frame);
     
     // Store in local buffer
     InputFrame localInput;
@@ -251,11 +669,88 @@ void NetworkManager::SendInput(uint32_t frame, uint32_t inputMask, uint16_t inpu
     localInput.confirmed = false;
     localInput.predicted = false;
     
-    if (auto buffer = m_playerInputBuffers[m_localPlayerId].get()) {
+    InputBuffer* buffer = m_playerInputBuffers[m_localPlayerId].get();
+    if (buffer) {
         buffer->AddInput(localInput);
+        
+        // Repeat every frame the slowest peer has not acknowledged yet
+        uint32_t oldestUnacked = GetRemoteAckFrame() + 1;
+        FillInputHistory(*inputPacket, *buffer, oldestUnacked);
+        
+        // After a loss burst more frames can be unacknowledged than one
+        // packet repeats. The oldest would then never be sent again and
+        // the peer would stall waiting for them, so send those as well.
+        uint32_t maxHistory = static_cast<uint32_t>(InputPacket::MAX_HISTORY);
+        uint32_t catchUpFrame = oldestUnacked + maxHistory - 1;
+        if (catchUpFrame < inputPacket->GetFirstFrame()) {
+            auto oldest = buffer->GetInput(catchUpFrame);
+            if (oldest.has_value()) {
+                auto catchUpPacket = CreatePacket<InputPacket>();
+                catchUpPacket->playerId = m_localPlayerId;
+                catchUpPacket->inputId = oldest->inputId;
+                catchUpPacket->timestamp = inputPacket->timestamp;
+                catchUpPacket->ackFrame = inputPacket->ackFrame;
+                catchUpPacket->SetSingleInput(catchUpFrame, oldest->inputMask);
+                FillInputHistory(*catchUpPacket, *buffer, oldestUnacked);
+                SendPacket(std::move(catchUpPacket), false);
+            }
+        }
+    }
+    
+    // Redundancy replaces resends, so inputs go unreliable
+    SendPacket(std::move(inputPacket), false);
+}
+
+void NetworkManager::FillInputHistory(InputPacket& packet, const InputBuffer& buffer, uint32_t firstFrame) const {
+    uint32_t frame = packet.frame;
+    uint32_t maxHistory = static_cast<uint32_t>(InputPacket::MAX_HISTORY);
+    firstFrame = std::max(firstFrame, frame + 1 >= maxHistory ? frame + 1 - maxHistory : 0);
+    
+    // Stop at the newest gap in our own history
+    uint32_t start = frame;
+    while (start > firstFrame) {
+        auto previous = buffer.GetInput(start - 1);
+        if (!previous.has_value()) break;
+        start--;
+    }
+    
+    packet.historyCount = static_cast<uint8_t>(frame - start + 1);
+    for (uint32_t f = start; f <= frame; ++f) {
+        packet.history[f - start] = buffer.GetInputMask(f);
     }
 }
 
+uint32_t NetworkManager::GetLocalAckFrame() const {
+    // One watermark covers every remote player, so report the lowest
+    uint32_t ackFrame = 0;
+    bool first = true;
+    
+    for (const auto& [playerId, buffer] : m_playerInputBuffers) {
+        if (playerId == m_localPlayerId) continue;
+        
+        if (first || buffer->GetContiguousFrame() < ackFrame) {
+            ackFrame = buffer->GetContiguousFrame();
+            first = false;
+        }
+    }
+    
+    return ackFrame;
+}
+
+uint32_t NetworkManager::GetRemoteAckFrame() const {
+    uint32_t ackFrame = 0;
+    bool first = true;
+    
+    for (const auto& [playerId, remoteAck] : m_remoteAckFrames) {
+        if (first || remoteAck < ackFrame) {
+            ackFrame = remoteAck;
+            first = false;
+        }
+    }
+    
+    return ackFrame;
+}
+
 bool NetworkManager::GetRemoteInput(uint32_t playerId, uint32_t frame, uint32_t& inputMask) {
     auto it = m_playerInputBuffers.find(playerId);
     if (it == m_playerInputBuffers.end()) {
@@ -280,9 +775,15 @@ void NetworkManager::ConfirmFrame(uint32_t frame) {
     }
 }
 
+InputBuffer* NetworkManager::GetInputBuffer(uint32_t playerId) {
+    auto it = m_playerInputBuffers.find(playerId);
+    return it != m_playerInputBuffers.end() ? it->second.get() : nullptr;
+}
+
 void NetworkManager::CreateMatch(const std::string& matchName, uint8_t gameMode, uint8_t stageId) {
     // TODO: Implement match creation
     m_currentGameMode = gameMode;
+    m_currentStageId = stageId;
 }
 
 void NetworkManager::JoinMatch(const std::string& matchCode) {
@@ -297,16 +798,27 @@ void NetworkManager::StartMatch() {
     m_connectionState = ConnectionState::InMatch;
     
     // Send match start packet
-    auto matchPacket = std::make_shared<MatchStartPacket>();
-    matchPacket->matchId = ++m_currentMatchId;
+    auto matchPacket = CreatePacket<MatchStartPacket>();
+    matchPacket->matchId = m_currentMatchId + 1;
     matchPacket->gameMode = m_currentGameMode;
+    matchPacket->stageId = m_currentStageId;
     matchPacket->randomSeed = static_cast<uint32_t>(std::time(nullptr));
     
-    SendPacket(matchPacket, true);
-    
-    if (m_onMatchStart) {
-        m_onMatchStart(m_currentMatchId, m_currentGameMode);
+    std::vector<uint32_t> playerIds = { m_localPlayerId };
+    for (const auto& [playerId, buffer] : m_playerInputBuffers) {
+        playerIds.push_back(playerId);
     }
+    std::sort(playerIds.begin(), playerIds.end());
+    playerIds.erase(std::unique(playerIds.begin(), playerIds.end()), playerIds.end());
+    
+    matchPacket->playerCount = static_cast<uint8_t>(std::min<size_t>(playerIds.size(), 8));
+    std::fill(std::begin(matchPacket->playerIds), std::end(matchPacket->playerIds), 0u);
+    std::copy(playerIds.begin(), playerIds.begin() + matchPacket->playerCount, matchPacket->playerIds);
+    
+    // The host simulates from the same seed it hands out
+    BeginMatch(*matchPacket);
+    
+    SendPacket(std::move(matchPacket), true, true);
 }
 
 void NetworkManager::EndMatch() {
@@ -319,15 +831,66 @@ void NetworkManager::EndMatch() {
     // TODO: Send match end packet
 }
 
+ReplayHeader NetworkManager::GetReplayHeader(uint32_t startFrame) const {
+    ReplayHeader header;
+    header.matchId = m_currentMatchId;
+    header.gameMode = m_currentGameMode;
+    header.stageId = m_currentStageId;
+    header.randomSeed = m_randomSeed;
+    header.startFrame = startFrame;
+    header.playerCount = static_cast<uint8_t>(std::min(m_matchPlayerIds.size(), ReplayHeader::MAX_PLAYERS));
+    std::copy(m_matchPlayerIds.begin(), m_matchPlayerIds.begin() + header.playerCount, header.playerIds);
+    return header;
+}
+
 void NetworkManager::HandlePlayerState(NetworkPacket* packet) {
     auto statePacket = static_cast<PlayerStatePacket*>(packet);
     
     // TODO: Update player state in game
 }
 
+void NetworkManager::HandleDeltaState(NetworkPacket* packet) {
+    auto deltaPacket = static_cast<DeltaStatePacket*>(packet);
+    
+    PlayerStatePacket statePacket;
+    if (!m_stateDecoder.Decode(*deltaPacket, statePacket)) {
+        return; // Baseline already gone; a later full snapshot recovers
+    }
+    
+    // Tell the sender this snapshot can serve as its next baseline
+    auto ackPacket = CreatePacket<SystemPacket>(PacketType::Acknowledge);
+    ackPacket->playerId = deltaPacket->playerId;
+    ackPacket->payload = (m_localPlayerId << 8) | deltaPacket->snapshotId;
+    SendPacket(std::move(ackPacket), false);
+    
+    auto it = m_packetHandlers.find(static_cast<uint16_t>(PacketType::PlayerStateUpdate));
+    if (it != m_packetHandlers.end()) {
+        it->second(&statePacket);
+    }
+}
+
+void NetworkManager::HandleAcknowledge(NetworkPacket* packet) {
+    auto ackPacket = static_cast<SystemPacket*>(packet);
+    
+    m_stateEncoder.Acknowledge(ackPacket->payload >> 8, ackPacket->playerId,
+                               static_cast<uint8_t>(ackPacket->payload & 0xFF));
+}
+
 void NetworkManager::HandleInput(NetworkPacket* packet) {
     auto inputPacket = static_cast<InputPacket*>(packet);
     
+    // The host's relay reaches every peer, the sender included
+    if (inputPacket->playerId == m_localPlayerId) {
+        return;
+    }
+    
+    // Clients only hear the host, so it passes each client's inputs on
+    // to the others unchanged; the sender keeps repeating its history
+    // until everyone acknowledges it, which covers relay loss too
+    if (m_isHost) {
+        SendPacket(CreatePacket<InputPacket>(*inputPacket), false);
+    }
+    
     // Add to appropriate input buffer
     auto it = m_playerInputBuffers.find(inputPacket->playerId);
     if (it == m_playerInputBuffers.end()) {
@@ -340,15 +903,17 @@ void NetworkManager::HandleInput(NetworkPacket* packet) {
         }
     }
     
-    InputFrame frame;
-    frame.frame = inputPacket->timestamp;
-    frame.inputMask = inputPacket->inputMask;
-    frame.inputId = inputPacket->inputId;
-    frame.timestamp = inputPacket->timestamp;
-    frame.confirmed = true;
-    frame.predicted = false;
+    if (inputPacket->historyCount == 0) {
+        return; // Malformed history
+    }
+    
+    // The whole redundant run goes in; frames we already hold are skipped
+    m_playerInputBuffers[inputPacket->playerId]->AddInput(
+        inputPacket->GetFirstFrame(), inputPacket->history,
+        inputPacket->historyCount, inputPacket->inputId);
     
-    m_playerInputBuffers[inputPacket->playerId]->AddInput(frame);
+    uint32_t& remoteAck = m_remoteAckFrames[inputPacket->playerId];
+    remoteAck = std::max(remoteAck, inputPacket->ackFrame);
 }
 
 void NetworkManager::HandleAttack(NetworkPacket* packet) {
@@ -366,9 +931,32 @@ void NetworkManager::HandleDamage(NetworkPacket* packet) {
 void NetworkManager::HandleMatchStart(NetworkPacket* packet) {
     auto matchPacket = static_cast<MatchStartPacket*>(packet);
     
-    m_currentMatchId = matchPacket->matchId;
-    m_currentGameMode = matchPacket->gameMode;
-    m_randomSeed = matchPacket->randomSeed;
+    BeginMatch(*matchPacket);
+}
+
+void NetworkManager::HandleMatchSync(NetworkPacket* packet) {
+    auto syncPacket = static_cast<MatchSyncPacket*>(packet);
+    
+    for (int i = 0; i < syncPacket->hashCount; ++i) {
+        m_desyncDetector.RecordRemoteHash(syncPacket->playerId, syncPacket->hashes[i]);
+    }
+}
+
+void NetworkManager::BeginMatch(const MatchStartPacket& settings) {
+    m_currentMatchId = settings.matchId;
+    m_currentGameMode = settings.gameMode;
+    m_currentStageId = settings.stageId;
+    m_randomSeed = settings.randomSeed;
+    m_matchPlayerIds.assign(settings.playerIds,
+                            settings.playerIds + std::min<size_t>(settings.playerCount, 8));
+    
+    // Every gameplay roll on every peer now comes from the same sequence
+    SeedSimulationRandom(m_randomSeed);
+    m_desyncDetector.Reset();
+    m_stats.desyncDetected = false;
+    m_stats.desyncFrame = 0;
+    m_stats.desyncField = nullptr;
+    m_desyncDumped = false;
     
     if (m_onMatchStart) {
         m_onMatchStart(m_currentMatchId, m_currentGameMode);
@@ -376,8 +964,9 @@ void NetworkManager::HandleMatchStart(NetworkPacket* packet) {
 }
 
 void NetworkManager::UpdateInputBuffers() {
-    // Remove old frames from all buffers
-    uint32_t currentFrame = m_sequenceNumber;
+    // Remove old frames from all buffers. This is a frame number; the
+    // packet sequence runs several times faster.
+    uint32_t currentFrame = GetLocalFrame();
     uint32_t oldFrameThreshold = currentFrame > 120 ? currentFrame - 120 : 0;
     
     for (auto& [playerId, buffer] : m_playerInputBuffers) {
@@ -391,7 +980,7 @@ void NetworkManager::PredictMissingInputs(uint32_t playerId, uint32_t frame) {
         return;
     }
     
-    uint32_t predictedInput = it->second->PredictNextInput();
+    uint32_t predictedInput = it->second->PredictInput(frame);
     it->second->AddPredictedInput(frame, predictedInput);
 }
 
@@ -402,7 +991,6 @@ void NetworkManager::UpdateNetworkStats() {
     
     if (elapsed >= 1000) { // Update every second
         CalculatePing();
-        TrackPacketLoss();
         
         // Calculate bandwidth in KB/s
         m_stats.bandwidth = (m_stats.bandwidth / elapsed) * 1000.0f / 1024.0f;
@@ -412,14 +1000,8 @@ void NetworkManager::UpdateNetworkStats() {
 }
 
 void NetworkManager::CalculatePing() {
-    // TODO: Implement actual ping calculation
-    // For now, simulate ping
-    m_stats.ping = 50 + (rand() % 20);
-}
-
-void NetworkManager::TrackPacketLoss() {
-    // Packet loss is already tracked in ProcessPacket
-    // This could implement additional tracking if needed
+    m_stats.ping = static_cast<int>(std::lround(m_timeSync.GetRoundTripTime()));
+    m_stats.jitter = m_timeSync.GetJitter();
 }
 
 } // namespace ArenaFighter
\ No newline at end of file
@@ -2,17 +2,31 @@
 
 #include <memory>
 #include <vector>
-#include <queue>
+#include <array>
 #include <unordered_map>
 #include <functional>
 #include <chrono>
+#include <string>
+#include <cstdint>
+#include "NetworkConfig.h"
+#include "SendArena.h"
+#include "UdpSocket.h"
+#include "NetworkThread.h"
+#include "PacketPool.h"
+#include "ReliableConnection.h"
+#include "SpscRing.h"
+#include "DeltaCompression.h"
+#include "DesyncDetector.h"
+#include "TimeSync.h"
 
 namespace ArenaFighter {
 
 // Forward declarations
-class NetworkPacket;
 class InputBuffer;
 class PacketHandler;
+class RollbackEngine;
+class MatchStartPacket;
+struct ReplayHeader;
 
 enum class ConnectionState {
     Disconnected,
@@ -21,27 +35,26 @@ enum class ConnectionState {
     InMatch
 };
 
-struct NetworkConfig {
-    static constexpr int TICK_RATE = 60;
-    static constexpr int SEND_RATE = 30;
-    static constexpr int MAX_ROLLBACK_FRAMES = 7;
-    static constexpr int INTERPOLATION_DELAY_MS = 100;
-    static constexpr int MAX_PREDICTION_FRAMES = 8;
-    static constexpr int PACKET_SIZE_LIMIT = 1400;
-    static constexpr int COMPRESSION_THRESHOLD = 256;
-    static constexpr int INPUT_BUFFER_SIZE = 3;
-};
-
 struct NetworkStats {
-    int ping = 0;
+    int ping = 0;              // Smoothed round trip to the slowest peer, ms
+    float jitter = 0.0f;       // Round-trip variation, ms
+    int inputDelay = NetworkConfig::INITIAL_INPUT_DELAY;
+    float frameAdvantage = 0.0f;  // Frames we run ahead of the furthest-behind peer
+    float tickScale = 1.0f;    // Tick interval stretch while waiting for a peer
     float packetLoss = 0.0f;
     int rollbackFrames = 0;
     int packetsReceived = 0;
     int packetsSent = 0;
+    int datagramsSent = 0;     // Packets are coalesced, so usually far fewer
     float bandwidth = 0.0f;
+    bool desyncDetected = false;
+    uint32_t desyncFrame = 0;  // First checkpoint that disagreed
+    const char* desyncField = nullptr;  // First differing state field, debug mode only
     std::chrono::steady_clock::time_point lastUpdate;
 };
 
+// Game-side networking. Every method runs on the game thread; the socket
+// itself is driven by a NetworkThread.
 class NetworkManager {
 public:
     NetworkManager();
@@ -57,8 +70,14 @@ public:
     bool ConnectToHost(const std::string& address, int port);
     void Disconnect();
     
-    // Packet handling
-    void SendPacket(std::shared_ptr<NetworkPacket> packet, bool reliable = true);
+    // Packet handling. Create outgoing packets here: they come from the
+    // manager's pool, so sending never allocates.
+    template <typename T, typename... Args>
+    PacketRef<T> CreatePacket(Args&&... args) { return m_packetPool.Acquire<T>(std::forward<Args>(args)...); }
+    // Reliable packets are resent until every peer acks them; ordered ones
+    // are also handled in send order, without waiting on unordered ones
+    void SendPacket(PacketPtr packet, bool reliable = true, bool ordered = false);
+    void SendPlayerState(const PlayerStatePacket& state);
     void ProcessIncomingPackets();
     void RegisterPacketHandler(uint16_t packetType, std::function<void(NetworkPacket*)> handler);
     
@@ -66,6 +85,24 @@ public:
     void SendInput(uint32_t frame, uint32_t inputMask, uint16_t inputId);
     bool GetRemoteInput(uint32_t playerId, uint32_t frame, uint32_t& inputMask);
     void ConfirmFrame(uint32_t frame);
+    InputBuffer* GetInputBuffer(uint32_t playerId);
+    
+    // Adaptive input delay: sample input for frame current + GetInputDelay().
+    // The fixed step of the game loop should be stretched by GetTickScale()
+    // so peers stay within a frame of each other; Update() paces its own
+    // ticks the same way.
+    int GetInputDelay() const { return m_timeSync.GetInputDelay(); }
+    float GetTickScale() const { return m_timeSync.GetTickScale(); }
+    
+    // Rollback stats are reported from this engine while attached
+    void AttachRollbackEngine(RollbackEngine* engine) { m_rollbackEngine = engine; }
+    
+    // State hashes exchanged with peers; attach it to the rollback engine
+    DesyncDetector& GetDesyncDetector() { return m_desyncDetector; }
+    
+    // Desync debug mode: peers also exchange per-field hashes, and the
+    // local state of the first mismatching frame is dumped to dumpDirectory
+    void SetDesyncDebug(bool enabled, const std::string& dumpDirectory = ".");
     
     // Match management
     void CreateMatch(const std::string& matchName, uint8_t gameMode, uint8_t stageId);
@@ -73,11 +110,16 @@ public:
     void StartMatch();
     void EndMatch();
     
+    // The current match's MatchStartPacket settings, players in slot
+    // order (ascending id, so the host first), for a ReplayWriter
+    ReplayHeader GetReplayHeader(uint32_t startFrame = 1) const;
+    
     // State queries
     ConnectionState GetConnectionState() const { return m_connectionState; }
     NetworkStats GetNetworkStats() const { return m_stats; }
     int GetLocalPlayerId() const { return m_localPlayerId; }
     int GetPlayerCount() const { return static_cast<int>(m_playerInputBuffers.size()); }
+    int GetLocalPort() const;
     
     // Callbacks
     using OnPlayerConnectedCallback = std::function<void(uint32_t playerId)>;
@@ -93,22 +135,41 @@ private:
     void TickUpdate();
     void SendUpdate();
     
+    // Transport
+    bool StartSocket(int port);
+    void SendImmediate(NetworkPacket& packet, const UdpEndpoint& endpoint);
+    void StampPacket(NetworkPacket& packet);
+    void HandleConnectionPacket(const UdpEndpoint& source, NetworkPacket* packet);
+    void DispatchPacket(const ReceivedPacket& received);
+    void SetLocalPlayerId(uint32_t playerId);
+    
     // Packet processing
     void ProcessPacket(NetworkPacket* packet);
     void HandlePlayerState(NetworkPacket* packet);
+    void HandleDeltaState(NetworkPacket* packet);
+    void HandleAcknowledge(NetworkPacket* packet);
     void HandleInput(NetworkPacket* packet);
     void HandleAttack(NetworkPacket* packet);
     void HandleDamage(NetworkPacket* packet);
     void HandleMatchStart(NetworkPacket* packet);
+    void HandleMatchSync(NetworkPacket* packet);
+    void BeginMatch(const MatchStartPacket& settings);
+    void SendStateHashes();
+    void HandleDesync(const DesyncReport& report);
+    void SendPings();
+    void HandleTimeSync(const UdpEndpoint& source, NetworkPacket* packet, uint32_t arrivalMs);
+    uint32_t GetLocalFrame() const;
     
     // Rollback support
     void UpdateInputBuffers();
     void PredictMissingInputs(uint32_t playerId, uint32_t frame);
+    void FillInputHistory(InputPacket& packet, const InputBuffer& buffer, uint32_t firstFrame) const;
+    uint32_t GetLocalAckFrame() const;
+    uint32_t GetRemoteAckFrame() const;
     
     // Network stats
     void UpdateNetworkStats();
     void CalculatePing();
-    void TrackPacketLoss();
     
 private:
     ConnectionState m_connectionState;
@@ -118,9 +179,9 @@ private:
     uint32_t m_localPlayerId;
     std::unordered_map<uint32_t, std::unique_ptr<InputBuffer>> m_playerInputBuffers;
     
-    // Packet handling
-    std::queue<std::shared_ptr<NetworkPacket>> m_incomingPackets;
-    std::queue<std::shared_ptr<NetworkPacket>> m_outgoingPackets;
+    // Packet handling. The pool is declared first so it outlives the queues.
+    PacketPool m_packetPool;
+    std::array<SpscRing<PacketPtr, NetworkConfig::SEND_QUEUE_SIZE>, 4> m_outgoingPackets; // By PacketPriority
     std::unordered_map<uint16_t, std::function<void(NetworkPacket*)>> m_packetHandlers;
     
     // Timing
@@ -131,13 +192,16 @@ private:
     
     // Sequence tracking
     uint32_t m_sequenceNumber;
-    uint32_t m_lastReceivedSequence;
     std::unordered_map<uint32_t, uint32_t> m_playerLastSequence;
+    std::unordered_map<uint32_t, uint32_t> m_remoteAckFrames; // Our input each player holds
     
     // Match state
     uint32_t m_currentMatchId;
     uint8_t m_currentGameMode;
+    uint8_t m_currentStageId;
     uint32_t m_randomSeed;
+    std::vector<uint32_t> m_matchPlayerIds;
+    RollbackEngine* m_rollbackEngine;
     
     // Callbacks
     OnPlayerConnectedCallback m_onPlayerConnected;
@@ -145,8 +209,43 @@ private:
     OnMatchStartCallback m_onMatchStart;
     
     // Socket implementation (platform specific)
-    void* m_socket;
-    void* m_server;
+    struct RemotePeer {
+        UdpEndpoint endpoint;
+        uint32_t playerId;
+        std::unique_ptr<ReliableConnection> reliable = std::make_unique<ReliableConnection>();
+        
+        // Each sender numbers its own stream, so loss is tracked per peer
+        uint32_t lastSequence = 0;     // Newest unreliable sequence received
+        bool hasSequence = false;
+        float packetLoss = 0.0f;       // Smoothed fraction lost, 0-1
+    };
+    
+    RemotePeer* FindPeer(const UdpEndpoint& endpoint);
+    void TrackPacketLoss(RemotePeer& peer, const NetworkPacket& packet);
+    
+    NetworkThread m_networkThread;       // Owns the socket while connected
+    UdpEndpoint m_server;                // Host endpoint when we are a client
+    std::vector<RemotePeer> m_peers;     // Every endpoint SendUpdate fans out to
+    uint32_t m_nextPlayerId;
+    bool m_isHost;
+    
+    // Per-tick wire buffer, allocated once and reused. Each datagram leaves
+    // room for the ack trailer of whichever peer it goes to.
+    SendArena m_sendArena;
+    
+    // Player state deltas against acknowledged baselines
+    DeltaStateEncoder m_stateEncoder;
+    DeltaStateDecoder m_stateDecoder;
+    
+    // Confirmed-state hashes compared with every peer
+    DesyncDetector m_desyncDetector;
+    std::string m_desyncDumpDirectory;
+    bool m_desyncDumped;
+    
+    // Ping/Pong timing and frame advantage per peer
+    TimeSync m_timeSync;
+    uint32_t m_tickCount;
+    uint32_t m_lastInputFrame;
 };
 
 } // namespace ArenaFighter
\ No newline at end of file
@@ -1,6 +1,12 @@
 #include "NetworkPacket.h"
+#include "NetworkConfig.h"
+#include "BitStream.h"
+#include "PacketPool.h"
 #include <cstring>
 #include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
 
 namespace ArenaFighter {
 
@@ -12,13 +18,17 @@ NetworkPacket::NetworkPacket(PacketType type) : m_priority(PacketPriority::Norma
     m_header.version = PacketHeader::PROTOCOL_VERSION;
 }
 
-uint16_t NetworkPacket::CalculateChecksum(const std::vector<uint8_t>& data) const {
+uint16_t NetworkPacket::CalculateChecksum(const std::vector<uint8_t>& data) {
+    return CalculateChecksum(data.data(), data.size());
+}
+
+uint16_t NetworkPacket::CalculateChecksum(const uint8_t* data, size_t size) {
     uint32_t sum = 0;
     
     // Skip checksum field in calculation
     size_t checksumOffset = offsetof(PacketHeader, checksum);
     
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < size; ++i) {
         if (i >= checksumOffset && i < checksumOffset + sizeof(uint16_t)) {
             continue; // Skip checksum field
         }
@@ -33,10 +43,36 @@ uint16_t NetworkPacket::CalculateChecksum(const std::vector<uint8_t>& data) cons
     return static_cast<uint16_t>(~sum);
 }
 
-void NetworkPacket::WriteHeader(std::vector<uint8_t>& buffer) const {
-    size_t startSize = buffer.size();
-    buffer.resize(startSize + sizeof(PacketHeader));
-    std::memcpy(buffer.data() + startSize, &m_header, sizeof(PacketHeader));
+void NetworkPacket::Serialize(std::vector<uint8_t>& buffer) const {
+    size_t offset = buffer.size();
+    buffer.resize(offset + NetworkConfig::PACKET_SIZE_LIMIT);
+    
+    size_t written = Serialize(buffer.data() + offset, NetworkConfig::PACKET_SIZE_LIMIT);
+    buffer.resize(offset + written);
+}
+
+size_t NetworkPacket::Serialize(uint8_t* buffer, size_t capacity) const {
+    PacketWriter writer(buffer, capacity);
+    
+    // Header goes first; size and checksum are patched once the payload is known
+    writer.Write(m_header);
+    WritePayload(writer);
+    
+    if (writer.HasOverflowed()) {
+        return 0;
+    }
+    
+    // Update packet size in header
+    PacketHeader& header = const_cast<PacketHeader&>(m_header);
+    header.size = static_cast<uint16_t>(writer.GetSize());
+    std::memcpy(buffer + offsetof(PacketHeader, size), &header.size, sizeof(header.size));
+    
+    // Each packet is sealed on its own so coalesced datagrams can be
+    // validated packet by packet
+    header.checksum = CalculateChecksum(buffer, writer.GetSize());
+    std::memcpy(buffer + offsetof(PacketHeader, checksum), &header.checksum, sizeof(header.checksum));
+    
+    return writer.GetSize();
 }
 
 void NetworkPacket::ReadHeader(const uint8_t* data) {
@@ -45,32 +81,15 @@ void NetworkPacket::ReadHeader(const uint8_t* data) {
 
 // PlayerStatePacket implementation
 
-void PlayerStatePacket::Serialize(std::vector<uint8_t>& buffer) const {
-    // Reserve space for efficiency
-    buffer.reserve(sizeof(PacketHeader) + 64);
-    
-    // Write header
-    WriteHeader(buffer);
-    
-    // Write packet data
-    size_t offset = buffer.size();
-    buffer.resize(offset + sizeof(playerId) + sizeof(position) + sizeof(velocity) + 
-                 sizeof(rotation) + sizeof(state) + sizeof(health) + 
-                 sizeof(mana) + sizeof(currentGear));
-    
-    uint8_t* ptr = buffer.data() + offset;
-    
-    std::memcpy(ptr, &playerId, sizeof(playerId)); ptr += sizeof(playerId);
-    std::memcpy(ptr, position, sizeof(position)); ptr += sizeof(position);
-    std::memcpy(ptr, velocity, sizeof(velocity)); ptr += sizeof(velocity);
-    std::memcpy(ptr, &rotation, sizeof(rotation)); ptr += sizeof(rotation);
-    std::memcpy(ptr, &state, sizeof(state)); ptr += sizeof(state);
-    std::memcpy(ptr, &health, sizeof(health)); ptr += sizeof(health);
-    std::memcpy(ptr, &mana, sizeof(mana)); ptr += sizeof(mana);
-    std::memcpy(ptr, &currentGear, sizeof(currentGear));
-    
-    // Update packet size in header
-    const_cast<PacketHeader&>(m_header).size = static_cast<uint16_t>(buffer.size());
+void PlayerStatePacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(playerId);
+    writer.Write(position);
+    writer.Write(velocity);
+    writer.Write(rotation);
+    writer.Write(state);
+    writer.Write(health);
+    writer.Write(mana);
+    writer.Write(currentGear);
 }
 
 void PlayerStatePacket::Deserialize(const uint8_t* data, size_t size) {
@@ -99,23 +118,68 @@ void PlayerStatePacket::Deserialize(const uint8_t* data, size_t size) {
 
 // InputPacket implementation
 
-void InputPacket::Serialize(std::vector<uint8_t>& buffer) const {
-    buffer.reserve(sizeof(PacketHeader) + 16);
-    
-    WriteHeader(buffer);
-    
-    size_t offset = buffer.size();
-    buffer.resize(offset + sizeof(playerId) + sizeof(inputMask) + 
-                 sizeof(inputId) + sizeof(timestamp));
-    
-    uint8_t* ptr = buffer.data() + offset;
+namespace {
+
+void WriteVarint(PacketWriter& writer, uint32_t value) {
+    while (value >= 0x80) {
+        writer.Write(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    writer.Write(static_cast<uint8_t>(value));
+}
+
+bool ReadVarint(const uint8_t*& ptr, size_t& remaining, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (remaining == 0) return false;
+        uint8_t byte = *ptr++;
+        remaining--;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void InputPacket::SetSingleInput(uint32_t inputFrame, uint32_t mask) {
+    frame = inputFrame;
+    inputMask = mask;
+    history[0] = mask;
+    historyCount = 1;
+}
+
+void InputPacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(playerId);
+    writer.Write(inputId);
+    writer.Write(timestamp);
+    writer.Write(frame);
+    writer.Write(ackFrame);
+    
+    // Without an explicit history the packet carries inputMask alone
+    if (historyCount == 0) {
+        writer.Write(static_cast<uint8_t>(1));
+        writer.Write(static_cast<uint8_t>(1));
+        WriteVarint(writer, inputMask);
+        return;
+    }
     
-    std::memcpy(ptr, &playerId, sizeof(playerId)); ptr += sizeof(playerId);
-    std::memcpy(ptr, &inputMask, sizeof(inputMask)); ptr += sizeof(inputMask);
-    std::memcpy(ptr, &inputId, sizeof(inputId)); ptr += sizeof(inputId);
-    std::memcpy(ptr, &timestamp, sizeof(timestamp));
+    writer.Write(historyCount);
     
-    const_cast<PacketHeader&>(m_header).size = static_cast<uint16_t>(buffer.size());
+    // Run-length encode the history, oldest first
+    uint32_t previous = 0;
+    for (int i = 0; i < historyCount; ) {
+        uint8_t runLength = 1;
+        while (i + runLength < historyCount && history[i + runLength] == history[i]) {
+            runLength++;
+        }
+        
+        writer.Write(runLength);
+        WriteVarint(writer, history[i] ^ previous);
+        
+        previous = history[i];
+        i += runLength;
+    }
 }
 
 void InputPacket::Deserialize(const uint8_t* data, size_t size) {
@@ -126,35 +190,55 @@ void InputPacket::Deserialize(const uint8_t* data, size_t size) {
     const uint8_t* ptr = data + sizeof(PacketHeader);
     size_t remaining = size - sizeof(PacketHeader);
     
-    if (remaining < sizeof(playerId) + sizeof(inputMask) + 
-                   sizeof(inputId) + sizeof(timestamp)) {
+    if (remaining < sizeof(playerId) + sizeof(inputId) + sizeof(timestamp) +
+                   sizeof(frame) + sizeof(ackFrame) + sizeof(historyCount)) {
         return;
     }
     
     std::memcpy(&playerId, ptr, sizeof(playerId)); ptr += sizeof(playerId);
-    std::memcpy(&inputMask, ptr, sizeof(inputMask)); ptr += sizeof(inputMask);
     std::memcpy(&inputId, ptr, sizeof(inputId)); ptr += sizeof(inputId);
-    std::memcpy(&timestamp, ptr, sizeof(timestamp));
+    std::memcpy(&timestamp, ptr, sizeof(timestamp)); ptr += sizeof(timestamp);
+    std::memcpy(&frame, ptr, sizeof(frame)); ptr += sizeof(frame);
+    std::memcpy(&ackFrame, ptr, sizeof(ackFrame)); ptr += sizeof(ackFrame);
+    std::memcpy(&historyCount, ptr, sizeof(historyCount)); ptr += sizeof(historyCount);
+    remaining -= sizeof(playerId) + sizeof(inputId) + sizeof(timestamp) +
+                 sizeof(frame) + sizeof(ackFrame) + sizeof(historyCount);
+    
+    if (historyCount == 0 || historyCount > MAX_HISTORY || historyCount > frame + 1) {
+        historyCount = 0;
+        return;
+    }
+    
+    uint32_t previous = 0;
+    for (int i = 0; i < historyCount; ) {
+        uint32_t delta;
+        if (remaining < 1) {
+            historyCount = 0;
+            return;
+        }
+        uint8_t runLength = *ptr++;
+        remaining--;
+        
+        if (runLength == 0 || i + runLength > historyCount || !ReadVarint(ptr, remaining, delta)) {
+            historyCount = 0;
+            return;
+        }
+        
+        previous ^= delta;
+        for (int r = 0; r < runLength; ++r) {
+            history[i++] = previous;
+        }
+    }
+    
+    inputMask = history[historyCount - 1];
 }
 
 // InputPredictionPacket implementation
 
-void InputPredictionPacket::Serialize(std::vector<uint8_t>& buffer) const {
-    buffer.reserve(sizeof(PacketHeader) + 32);
-    
-    WriteHeader(buffer);
-    
-    size_t offset = buffer.size();
-    buffer.resize(offset + sizeof(playerId) + sizeof(lastConfirmedInput) + 
-                 sizeof(predictedInputs));
-    
-    uint8_t* ptr = buffer.data() + offset;
-    
-    std::memcpy(ptr, &playerId, sizeof(playerId)); ptr += sizeof(playerId);
-    std::memcpy(ptr, &lastConfirmedInput, sizeof(lastConfirmedInput)); ptr += sizeof(lastConfirmedInput);
-    std::memcpy(ptr, predictedInputs, sizeof(predictedInputs));
-    
-    const_cast<PacketHeader&>(m_header).size = static_cast<uint16_t>(buffer.size());
+void InputPredictionPacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(playerId);
+    writer.Write(lastConfirmedInput);
+    writer.Write(predictedInputs);
 }
 
 void InputPredictionPacket::Deserialize(const uint8_t* data, size_t size) {
@@ -175,58 +259,135 @@ void InputPredictionPacket::Deserialize(const uint8_t* data, size_t size) {
     std::memcpy(predictedInputs, ptr, sizeof(predictedInputs));
 }
 
-// DeltaStatePacket implementation
+// QuantizedPlayerState implementation
 
-void DeltaStatePacket::Serialize(std::vector<uint8_t>& buffer) const {
-    buffer.reserve(sizeof(PacketHeader) + 64);
-    
-    WriteHeader(buffer);
+namespace {
+
+constexpr float TWO_PI = 6.28318530718f;
+// Keeps the difference of any two values inside the 20-bit delta width
+constexpr int32_t MAX_QUANTIZED = (1 << 18) - 1;
+
+int32_t QuantizeDistance(float value) {
+    float scaled = std::round(value * QuantizedPlayerState::POSITION_SCALE);
+    scaled = std::clamp(scaled, static_cast<float>(-MAX_QUANTIZED), static_cast<float>(MAX_QUANTIZED));
+    return static_cast<int32_t>(scaled);
+}
+
+} // namespace
+
+QuantizedPlayerState QuantizedPlayerState::FromPacket(const PlayerStatePacket& packet) {
+    QuantizedPlayerState quantized;
     
-    size_t offset = buffer.size();
-    buffer.resize(offset + sizeof(playerId) + sizeof(changedFields));
+    for (int i = 0; i < 3; ++i) {
+        quantized.position[i] = QuantizeDistance(packet.position[i]);
+        quantized.velocity[i] = QuantizeDistance(packet.velocity[i]);
+    }
     
-    uint8_t* ptr = buffer.data() + offset;
+    // Wrap radians into one turn before quantizing
+    const float steps = static_cast<float>(1 << ROTATION_BITS);
+    float turns = packet.rotation / TWO_PI;
+    turns -= std::floor(turns);
+    quantized.rotation = static_cast<uint16_t>(
+        static_cast<uint32_t>(std::round(turns * steps)) & ((1u << ROTATION_BITS) - 1));
+    
+    quantized.state = packet.state;
+    quantized.health = packet.health;
+    quantized.mana = packet.mana;
+    quantized.currentGear = packet.currentGear;
+    return quantized;
+}
+
+void QuantizedPlayerState::ToPacket(PlayerStatePacket& packet) const {
+    for (int i = 0; i < 3; ++i) {
+        packet.position[i] = static_cast<float>(position[i]) / POSITION_SCALE;
+        packet.velocity[i] = static_cast<float>(velocity[i]) / POSITION_SCALE;
+    }
     
-    std::memcpy(ptr, &playerId, sizeof(playerId)); ptr += sizeof(playerId);
-    std::memcpy(ptr, &changedFields, sizeof(changedFields)); ptr += sizeof(changedFields);
+    packet.rotation = static_cast<float>(rotation) / static_cast<float>(1 << ROTATION_BITS) * TWO_PI;
+    packet.state = state;
+    packet.health = health;
+    packet.mana = mana;
+    packet.currentGear = currentGear;
+}
+
+// DeltaStatePacket implementation
+
+namespace {
+
+// Vector components pick the narrowest of four widths with a 2-bit tag:
+// zero, 8-bit, 12-bit or 20-bit signed
+void WriteComponent(BitWriter& bits, int32_t value) {
+    if (value == 0) {
+        bits.WriteBits(0, 2);
+    } else if (value >= -128 && value < 128) {
+        bits.WriteBits(1, 2);
+        bits.WriteSigned(value, 8);
+    } else if (value >= -2048 && value < 2048) {
+        bits.WriteBits(2, 2);
+        bits.WriteSigned(value, 12);
+    } else {
+        bits.WriteBits(3, 2);
+        bits.WriteSigned(value, 20);
+    }
+}
+
+int32_t ReadComponent(BitReader& bits) {
+    switch (bits.ReadBits(2)) {
+        case 1: return bits.ReadSigned(8);
+        case 2: return bits.ReadSigned(12);
+        case 3: return bits.ReadSigned(20);
+        default: return 0;
+    }
+}
+
+// Every field changed and a five-group player id
+constexpr size_t MAX_DELTA_STATE_BYTES = 32;
+
+} // namespace
+
+void DeltaStatePacket::WritePayload(PacketWriter& writer) const {
+    uint8_t packed[MAX_DELTA_STATE_BYTES] = {};
+    BitWriter bits(packed, sizeof(packed));
+    
+    // Ids grow for as long as the host runs
+    bits.WriteVarint(playerId);
+    bits.WriteBits(snapshotId, 8);
+    bits.WriteBool(hasBaseline);
+    if (hasBaseline) {
+        bits.WriteBits(baselineId, 8);
+    }
+    bits.WriteBits(changedFields, 7);
     
     // Write only changed fields
-    if (changedFields & 0x01 && position) {
-        size_t currentSize = buffer.size();
-        buffer.resize(currentSize + sizeof(float) * 3);
-        ptr = buffer.data() + currentSize;
-        std::memcpy(ptr, position, sizeof(float) * 3);
+    if (changedFields & FieldPosition) {
+        for (int i = 0; i < 3; ++i) WriteComponent(bits, values.position[i]);
+    }
+    
+    if (changedFields & FieldVelocity) {
+        for (int i = 0; i < 3; ++i) WriteComponent(bits, values.velocity[i]);
     }
     
-    if (changedFields & 0x02 && velocity) {
-        size_t currentSize = buffer.size();
-        buffer.resize(currentSize + sizeof(float) * 3);
-        ptr = buffer.data() + currentSize;
-        std::memcpy(ptr, velocity, sizeof(float) * 3);
+    if (changedFields & FieldRotation) {
+        bits.WriteBits(values.rotation, QuantizedPlayerState::ROTATION_BITS);
     }
     
-    if (changedFields & 0x04 && rotation) {
-        size_t currentSize = buffer.size();
-        buffer.resize(currentSize + sizeof(float));
-        ptr = buffer.data() + currentSize;
-        std::memcpy(ptr, rotation, sizeof(float));
+    if (changedFields & FieldHealth) {
+        bits.WriteBits(values.health, 16);
     }
     
-    if (changedFields & 0x08 && health) {
-        size_t currentSize = buffer.size();
-        buffer.resize(currentSize + sizeof(uint16_t));
-        ptr = buffer.data() + currentSize;
-        std::memcpy(ptr, health, sizeof(uint16_t));
+    if (changedFields & FieldMana) {
+        bits.WriteBits(values.mana, 8);
     }
     
-    if (changedFields & 0x10 && mana) {
-        size_t currentSize = buffer.size();
-        buffer.resize(currentSize + sizeof(uint8_t));
-        ptr = buffer.data() + currentSize;
-        std::memcpy(ptr, mana, sizeof(uint8_t));
+    if (changedFields & FieldState) {
+        bits.WriteBits(values.state, 16);
     }
     
-    const_cast<PacketHeader&>(m_header).size = static_cast<uint16_t>(buffer.size());
+    if (changedFields & FieldGear) {
+        bits.WriteBits(values.currentGear, 8);
+    }
+    
+    writer.WriteBytes(packed, bits.GetByteCount());
 }
 
 void DeltaStatePacket::Deserialize(const uint8_t* data, size_t size) {
@@ -234,79 +395,61 @@ void DeltaStatePacket::Deserialize(const uint8_t* data, size_t size) {
     
     ReadHeader(data);
     
-    const uint8_t* ptr = data + sizeof(PacketHeader);
-    size_t remaining = size - sizeof(PacketHeader);
+    BitReader bits(data + sizeof(PacketHeader), size - sizeof(PacketHeader));
     
-    if (remaining < sizeof(playerId) + sizeof(changedFields)) {
-        return;
+    playerId = bits.ReadVarint();
+    snapshotId = static_cast<uint8_t>(bits.ReadBits(8));
+    hasBaseline = bits.ReadBool();
+    baselineId = hasBaseline ? static_cast<uint8_t>(bits.ReadBits(8)) : 0;
+    changedFields = static_cast<uint8_t>(bits.ReadBits(7));
+    values = QuantizedPlayerState{};
+    
+    // Read only changed fields
+    if (changedFields & FieldPosition) {
+        for (int i = 0; i < 3; ++i) values.position[i] = ReadComponent(bits);
     }
     
-    std::memcpy(&playerId, ptr, sizeof(playerId)); ptr += sizeof(playerId);
-    std::memcpy(&changedFields, ptr, sizeof(changedFields)); ptr += sizeof(changedFields);
-    remaining -= sizeof(playerId) + sizeof(changedFields);
+    if (changedFields & FieldVelocity) {
+        for (int i = 0; i < 3; ++i) values.velocity[i] = ReadComponent(bits);
+    }
     
-    // Read only changed fields
-    // Note: In real implementation, we'd allocate memory for these
-    // For now, we skip the data to move ptr forward
+    if (changedFields & FieldRotation) {
+        values.rotation = static_cast<uint16_t>(bits.ReadBits(QuantizedPlayerState::ROTATION_BITS));
+    }
     
-    if (changedFields & 0x01) { // position
-        if (remaining >= sizeof(float) * 3) {
-            ptr += sizeof(float) * 3;
-            remaining -= sizeof(float) * 3;
-        }
+    if (changedFields & FieldHealth) {
+        values.health = static_cast<uint16_t>(bits.ReadBits(16));
     }
     
-    if (changedFields & 0x02) { // velocity
-        if (remaining >= sizeof(float) * 3) {
-            ptr += sizeof(float) * 3;
-            remaining -= sizeof(float) * 3;
-        }
+    if (changedFields & FieldMana) {
+        values.mana = static_cast<uint8_t>(bits.ReadBits(8));
     }
     
-    if (changedFields & 0x04) { // rotation
-        if (remaining >= sizeof(float)) {
-            ptr += sizeof(float);
-            remaining -= sizeof(float);
-        }
+    if (changedFields & FieldState) {
+        values.state = static_cast<uint16_t>(bits.ReadBits(16));
     }
     
-    if (changedFields & 0x08) { // health
-        if (remaining >= sizeof(uint16_t)) {
-            ptr += sizeof(uint16_t);
-            remaining -= sizeof(uint16_t);
-        }
+    if (changedFields & FieldGear) {
+        values.currentGear = static_cast<uint8_t>(bits.ReadBits(8));
     }
     
-    if (changedFields & 0x10) { // mana
-        if (remaining >= sizeof(uint8_t)) {
-            ptr += sizeof(uint8_t);
-            remaining -= sizeof(uint8_t);
-        }
+    // Truncated packets decode to nothing
+    if (bits.HasOverflowed()) {
+        changedFields = 0;
+        hasBaseline = false;
     }
 }
 
 // AttackPacket implementation
 
-void AttackPacket::Serialize(std::vector<uint8_t>& buffer) const {
-    buffer.reserve(sizeof(PacketHeader) + 48);
-    
-    WriteHeader(buffer);
-    
-    size_t offset = buffer.size();
-    buffer.resize(offset + sizeof(attackerId) + sizeof(targetId) + sizeof(skillId) +
-                 sizeof(damage) + sizeof(hitType) + sizeof(comboCount) + sizeof(position));
-    
-    uint8_t* ptr = buffer.data() + offset;
-    
-    std::memcpy(ptr, &attackerId, sizeof(attackerId)); ptr += sizeof(attackerId);
-    std::memcpy(ptr, &targetId, sizeof(targetId)); ptr += sizeof(targetId);
-    std::memcpy(ptr, &skillId, sizeof(skillId)); ptr += sizeof(skillId);
-    std::memcpy(ptr, &damage, sizeof(damage)); ptr += sizeof(damage);
-    std::memcpy(ptr, &hitType, sizeof(hitType)); ptr += sizeof(hitType);
-    std::memcpy(ptr, &comboCount, sizeof(comboCount)); ptr += sizeof(comboCount);
-    std::memcpy(ptr, position, sizeof(position));
-    
-    const_cast<PacketHeader&>(m_header).size = static_cast<uint16_t>(buffer.size());
+void AttackPacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(attackerId);
+    writer.Write(targetId);
+    writer.Write(skillId);
+    writer.Write(damage);
+    writer.Write(hitType);
+    writer.Write(comboCount);
+    writer.Write(position);
 }
 
 void AttackPacket::Deserialize(const uint8_t* data, size_t size) {
@@ -333,24 +476,12 @@ void AttackPacket::Deserialize(const uint8_t* data, size_t size) {
 
 // DamagePacket implementation
 
-void DamagePacket::Serialize(std::vector<uint8_t>& buffer) const {
-    buffer.reserve(sizeof(PacketHeader) + 24);
-    
-    WriteHeader(buffer);
-    
-    size_t offset = buffer.size();
-    buffer.resize(offset + sizeof(targetId) + sizeof(damageDealt) + 
-                 sizeof(remainingHealth) + sizeof(hitReaction) + sizeof(stunFrames));
-    
-    uint8_t* ptr = buffer.data() + offset;
-    
-    std::memcpy(ptr, &targetId, sizeof(targetId)); ptr += sizeof(targetId);
-    std::memcpy(ptr, &damageDealt, sizeof(damageDealt)); ptr += sizeof(damageDealt);
-    std::memcpy(ptr, &remainingHealth, sizeof(remainingHealth)); ptr += sizeof(remainingHealth);
-    std::memcpy(ptr, &hitReaction, sizeof(hitReaction)); ptr += sizeof(hitReaction);
-    std::memcpy(ptr, &stunFrames, sizeof(stunFrames));
-    
-    const_cast<PacketHeader&>(m_header).size = static_cast<uint16_t>(buffer.size());
+void DamagePacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(targetId);
+    writer.Write(damageDealt);
+    writer.Write(remainingHealth);
+    writer.Write(hitReaction);
+    writer.Write(stunFrames);
 }
 
 void DamagePacket::Deserialize(const uint8_t* data, size_t size) {
@@ -375,25 +506,13 @@ void DamagePacket::Deserialize(const uint8_t* data, size_t size) {
 
 // MatchStartPacket implementation
 
-void MatchStartPacket::Serialize(std::vector<uint8_t>& buffer) const {
-    buffer.reserve(sizeof(PacketHeader) + 64);
-    
-    WriteHeader(buffer);
-    
-    size_t offset = buffer.size();
-    buffer.resize(offset + sizeof(matchId) + sizeof(playerIds) + sizeof(playerCount) +
-                 sizeof(gameMode) + sizeof(stageId) + sizeof(randomSeed));
-    
-    uint8_t* ptr = buffer.data() + offset;
-    
-    std::memcpy(ptr, &matchId, sizeof(matchId)); ptr += sizeof(matchId);
-    std::memcpy(ptr, playerIds, sizeof(playerIds)); ptr += sizeof(playerIds);
-    std::memcpy(ptr, &playerCount, sizeof(playerCount)); ptr += sizeof(playerCount);
-    std::memcpy(ptr, &gameMode, sizeof(gameMode)); ptr += sizeof(gameMode);
-    std::memcpy(ptr, &stageId, sizeof(stageId)); ptr += sizeof(stageId);
-    std::memcpy(ptr, &randomSeed, sizeof(randomSeed));
-    
-    const_cast<PacketHeader&>(m_header).size = static_cast<uint16_t>(buffer.size());
+void MatchStartPacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(matchId);
+    writer.Write(playerIds);
+    writer.Write(playerCount);
+    writer.Write(gameMode);
+    writer.Write(stageId);
+    writer.Write(randomSeed);
 }
 
 void MatchStartPacket::Deserialize(const uint8_t* data, size_t size) {
@@ -417,29 +536,202 @@ void MatchStartPacket::Deserialize(const uint8_t* data, size_t size) {
     std::memcpy(&randomSeed, ptr, sizeof(randomSeed));
 }
 
+// MatchSyncPacket implementation
+
+void MatchSyncPacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(playerId);
+    writer.Write(hashCount);
+    
+    for (int i = 0; i < hashCount; ++i) {
+        const StateHash& state = hashes[i];
+        writer.Write(state.frame);
+        writer.Write(state.hash);
+        writer.Write(state.fieldCount);
+        for (int f = 0; f < state.fieldCount; ++f) {
+            writer.Write(state.fieldHashes[f]);
+        }
+    }
+}
+
+void MatchSyncPacket::Deserialize(const uint8_t* data, size_t size) {
+    if (size < sizeof(PacketHeader)) return;
+    
+    ReadHeader(data);
+    
+    const uint8_t* ptr = data + sizeof(PacketHeader);
+    size_t remaining = size - sizeof(PacketHeader);
+    hashCount = 0;
+    
+    uint8_t count = 0;
+    if (remaining < sizeof(playerId) + sizeof(count)) {
+        return;
+    }
+    
+    std::memcpy(&playerId, ptr, sizeof(playerId)); ptr += sizeof(playerId);
+    std::memcpy(&count, ptr, sizeof(count)); ptr += sizeof(count);
+    remaining -= sizeof(playerId) + sizeof(count);
+    
+    // Keep every complete entry; a truncated tail is dropped
+    for (int i = 0; i < count && i < MAX_HASHES; ++i) {
+        StateHash& state = hashes[i];
+        if (remaining < sizeof(state.frame) + sizeof(state.hash) + sizeof(state.fieldCount)) {
+            return;
+        }
+        
+        std::memcpy(&state.frame, ptr, sizeof(state.frame)); ptr += sizeof(state.frame);
+        std::memcpy(&state.hash, ptr, sizeof(state.hash)); ptr += sizeof(state.hash);
+        std::memcpy(&state.fieldCount, ptr, sizeof(state.fieldCount)); ptr += sizeof(state.fieldCount);
+        remaining -= sizeof(state.frame) + sizeof(state.hash) + sizeof(state.fieldCount);
+        
+        size_t fieldBytes = state.fieldCount * sizeof(uint64_t);
+        if (state.fieldCount > StateHash::MAX_FIELDS || remaining < fieldBytes) {
+            return;
+        }
+        std::memcpy(state.fieldHashes, ptr, fieldBytes);
+        ptr += fieldBytes;
+        remaining -= fieldBytes;
+        
+        hashCount = static_cast<uint8_t>(i + 1);
+    }
+}
+
+// SystemPacket implementation
+
+void SystemPacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(playerId);
+    writer.Write(payload);
+}
+
+void SystemPacket::Deserialize(const uint8_t* data, size_t size) {
+    if (size < sizeof(PacketHeader)) return;
+    
+    ReadHeader(data);
+    
+    const uint8_t* ptr = data + sizeof(PacketHeader);
+    size_t remaining = size - sizeof(PacketHeader);
+    
+    if (remaining < sizeof(playerId) + sizeof(payload)) {
+        return;
+    }
+    
+    std::memcpy(&playerId, ptr, sizeof(playerId)); ptr += sizeof(playerId);
+    std::memcpy(&payload, ptr, sizeof(payload));
+}
+
+// TimeSyncPacket implementation
+
+void TimeSyncPacket::WritePayload(PacketWriter& writer) const {
+    writer.Write(playerId);
+    writer.Write(targetId);
+    writer.Write(frame);
+    writer.Write(frameTimestamp);
+    writer.Write(frameAdvantage);
+    writer.Write(echoTimestamp);
+    writer.Write(receiveTimestamp);
+}
+
+void TimeSyncPacket::Deserialize(const uint8_t* data, size_t size) {
+    if (size < sizeof(PacketHeader)) return;
+    
+    ReadHeader(data);
+    
+    const uint8_t* ptr = data + sizeof(PacketHeader);
+    size_t remaining = size - sizeof(PacketHeader);
+    
+    if (remaining < sizeof(playerId) + sizeof(targetId) + sizeof(frame) + sizeof(frameTimestamp) +
+                    sizeof(frameAdvantage) + sizeof(echoTimestamp) + sizeof(receiveTimestamp)) {
+        return;
+    }
+    
+    std::memcpy(&playerId, ptr, sizeof(playerId)); ptr += sizeof(playerId);
+    std::memcpy(&targetId, ptr, sizeof(targetId)); ptr += sizeof(targetId);
+    std::memcpy(&frame, ptr, sizeof(frame)); ptr += sizeof(frame);
+    std::memcpy(&frameTimestamp, ptr, sizeof(frameTimestamp)); ptr += sizeof(frameTimestamp);
+    std::memcpy(&frameAdvantage, ptr, sizeof(frameAdvantage)); ptr += sizeof(frameAdvantage);
+    std::memcpy(&echoTimestamp, ptr, sizeof(echoTimestamp)); ptr += sizeof(echoTimestamp);
+    std::memcpy(&receiveTimestamp, ptr, sizeof(receiveTimestamp));
+}
+
 // PacketFactory implementation
 
-std::unique_ptr<NetworkPacket> PacketFactory::CreatePacket(PacketType type) {
+namespace {
+
+// The one type switch behind both the heap and the pooled factory.
+// make receives a std::type_identity tag for the class to construct.
+template <typename Make>
+auto CreateByType(PacketType type, Make&& make) -> decltype(make(std::type_identity<SystemPacket>{}, type)) {
     switch (type) {
         case PacketType::PlayerStateUpdate:
-            return std::make_unique<PlayerStatePacket>();
+            return make(std::type_identity<PlayerStatePacket>{});
         case PacketType::InputCommand:
-            return std::make_unique<InputPacket>();
+            return make(std::type_identity<InputPacket>{});
         case PacketType::InputPrediction:
-            return std::make_unique<InputPredictionPacket>();
+            return make(std::type_identity<InputPredictionPacket>{});
         case PacketType::DeltaState:
-            return std::make_unique<DeltaStatePacket>();
+            return make(std::type_identity<DeltaStatePacket>{});
         case PacketType::AttackEvent:
-            return std::make_unique<AttackPacket>();
+            return make(std::type_identity<AttackPacket>{});
         case PacketType::DamageConfirmation:
-            return std::make_unique<DamagePacket>();
+            return make(std::type_identity<DamagePacket>{});
         case PacketType::MatchStart:
-            return std::make_unique<MatchStartPacket>();
+            return make(std::type_identity<MatchStartPacket>{});
+        case PacketType::MatchSync:
+            return make(std::type_identity<MatchSyncPacket>{});
+        case PacketType::Ping:
+        case PacketType::Pong:
+            return make(std::type_identity<TimeSyncPacket>{}, type);
+        case PacketType::PlayerJoined:
+        case PacketType::PlayerLeft:
+        case PacketType::Acknowledge:
+        case PacketType::Disconnect:
+            return make(std::type_identity<SystemPacket>{}, type);
         default:
             return nullptr;
     }
 }
 
+// A datagram is a run of back-to-back packets, each framed by its header.
+// Calls emit(data, size) for every packet whose checksum holds.
+template <typename Emit>
+void SplitDatagram(const uint8_t* data, size_t size, Emit&& emit) {
+    size_t offset = 0;
+    
+    while (size - offset >= sizeof(PacketHeader)) {
+        const uint8_t* packetData = data + offset;
+        
+        PacketHeader header;
+        std::memcpy(&header, packetData, sizeof(header));
+        
+        if (header.size < sizeof(PacketHeader) || header.size > size - offset) {
+            break; // Framing is broken; nothing after this point can be trusted
+        }
+        offset += header.size;
+        
+        // Drop corrupted packets but keep the rest of the datagram
+        if (header.checksum != NetworkPacket::CalculateChecksum(packetData, header.size)) {
+            continue;
+        }
+        
+        emit(packetData, static_cast<size_t>(header.size));
+    }
+}
+
+} // namespace
+
+std::unique_ptr<NetworkPacket> PacketFactory::CreatePacket(PacketType type) {
+    return CreateByType(type, [](auto tag, auto... args) -> std::unique_ptr<NetworkPacket> {
+        using Packet = typename decltype(tag)::type;
+        return std::make_unique<Packet>(args...);
+    });
+}
+
+PacketPtr PacketFactory::CreatePacket(PacketType type, PacketPool& pool) {
+    return CreateByType(type, [&pool](auto tag, auto... args) -> PacketPtr {
+        using Packet = typename decltype(tag)::type;
+        return pool.Acquire<Packet>(args...);
+    });
+}
+
 std::unique_ptr<NetworkPacket> PacketFactory::CreateFromData(const uint8_t* data, size_t size) {
     if (size < sizeof(PacketHeader)) {
         return nullptr;
@@ -456,4 +748,38 @@ std::unique_ptr<NetworkPacket> PacketFactory::CreateFromData(const uint8_t* data
     return packet;
 }
 
-} // namespace ArenaFighter
\ No newline at end of file
+size_t PacketFactory::CreateFromData(const uint8_t* data, size_t size,
+                                     std::vector<std::unique_ptr<NetworkPacket>>& packets) {
+    size_t created = 0;
+    SplitDatagram(data, size, [&](const uint8_t* packetData, size_t packetSize) {
+        PacketHeader header;
+        std::memcpy(&header, packetData, sizeof(header));
+        
+        auto packet = CreatePacket(static_cast<PacketType>(header.type));
+        if (packet) {
+            packet->Deserialize(packetData, packetSize);
+            packets.push_back(std::move(packet));
+            created++;
+        }
+    });
+    return created;
+}
+
+size_t PacketFactory::CreateFromData(const uint8_t* data, size_t size,
+                                     std::vector<PacketPtr>& packets, PacketPool& pool) {
+    size_t created = 0;
+    SplitDatagram(data, size, [&](const uint8_t* packetData, size_t packetSize) {
+        PacketHeader header;
+        std::memcpy(&header, packetData, sizeof(header));
+        
+        auto packet = CreatePacket(static_cast<PacketType>(header.type), pool);
+        if (packet) {
+            packet->Deserialize(packetData, packetSize);
+            packets.push_back(std::move(packet));
+            created++;
+        }
+    });
+    return created;
+}
+
+} // namespace ArenaFighter
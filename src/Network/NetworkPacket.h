@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <memory>
+#include "NetworkConfig.h"
+#include "DesyncDetector.h"
 
 namespace ArenaFighter {
 
@@ -65,14 +68,46 @@ struct PacketHeader {
     static constexpr uint8_t PROTOCOL_VERSION = 1;
 };
 
+// Bounded write cursor over caller-owned bytes; never allocates
+class PacketWriter {
+public:
+    PacketWriter(uint8_t* data, size_t capacity)
+        : m_data(data), m_capacity(capacity), m_size(0), m_overflowed(false) {}
+    
+    void WriteBytes(const void* src, size_t size) {
+        if (m_overflowed || m_size + size > m_capacity) {
+            m_overflowed = true;
+            return;
+        }
+        std::memcpy(m_data + m_size, src, size);
+        m_size += size;
+    }
+    
+    template <typename T>
+    void Write(const T& value) { WriteBytes(&value, sizeof(T)); }
+    
+    uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    bool HasOverflowed() const { return m_overflowed; }
+
+private:
+    uint8_t* m_data;
+    size_t m_capacity;
+    size_t m_size;
+    bool m_overflowed;
+};
+
 // Base network packet class
 class NetworkPacket {
 public:
     NetworkPacket(PacketType type);
     virtual ~NetworkPacket() = default;
     
-    // Serialization
-    virtual void Serialize(std::vector<uint8_t>& buffer) const = 0;
+    // Serialization. The raw-buffer overload is the allocation-free path;
+    // it returns the bytes written, or 0 if the packet does not fit.
+    void Serialize(std::vector<uint8_t>& buffer) const;
+    size_t Serialize(uint8_t* buffer, size_t capacity) const;
+    virtual void WritePayload(PacketWriter& writer) const = 0;
     virtual void Deserialize(const uint8_t* data, size_t size) = 0;
     
     // Header access
@@ -88,24 +123,39 @@ public:
     bool HasFlag(PacketFlags flag) const { return m_header.flags & static_cast<uint8_t>(flag); }
     
     // Calculate checksum for packet integrity
-    uint16_t CalculateChecksum(const std::vector<uint8_t>& data) const;
+    static uint16_t CalculateChecksum(const std::vector<uint8_t>& data);
+    static uint16_t CalculateChecksum(const uint8_t* data, size_t size);
     
 protected:
     PacketHeader m_header;
     PacketPriority m_priority;
     
     // Helper functions for serialization
-    void WriteHeader(std::vector<uint8_t>& buffer) const;
     void ReadHeader(const uint8_t* data);
 };
 
+class PacketPool;
+
+// Hands a pooled packet back to its pool; packets without one are deleted
+struct PacketDeleter {
+    PacketPool* pool = nullptr;
+    
+    void operator()(NetworkPacket* packet) const;
+};
+
+// Owning packet handles. Unlike shared_ptr there is no refcount, and a
+// pooled packet costs no allocation.
+template <typename T>
+using PacketRef = std::unique_ptr<T, PacketDeleter>;
+using PacketPtr = PacketRef<NetworkPacket>;
+
 // Game State Packets
 
 class PlayerStatePacket : public NetworkPacket {
 public:
     PlayerStatePacket() : NetworkPacket(PacketType::PlayerStateUpdate) {}
     
-    void Serialize(std::vector<uint8_t>& buffer) const override;
+    void WritePayload(PacketWriter& writer) const override;
     void Deserialize(const uint8_t* data, size_t size) override;
     
     uint32_t playerId;
@@ -118,19 +168,34 @@ public:
     uint8_t currentGear;
 };
 
+// Carries the newest input plus up to INPUT_HISTORY_FRAMES - 1 older,
+// still unacknowledged frames, so a lost packet is repaired by the next
+// one instead of a resend. The history goes on the wire as runs of
+// identical masks, each run storing the XOR delta to the previous run
+// as a varint.
 class InputPacket : public NetworkPacket {
 public:
+    static constexpr int MAX_HISTORY = NetworkConfig::INPUT_HISTORY_FRAMES;
+    
     InputPacket() : NetworkPacket(PacketType::InputCommand) {
         m_priority = PacketPriority::Critical;
     }
     
-    void Serialize(std::vector<uint8_t>& buffer) const override;
+    void WritePayload(PacketWriter& writer) const override;
     void Deserialize(const uint8_t* data, size_t size) override;
     
-    uint32_t playerId;
-    uint32_t inputMask;   // InputCommand flags
-    uint16_t inputId;     // Input sequence number
-    uint16_t timestamp;   // Client timestamp
+    // Fills history with a single frame
+    void SetSingleInput(uint32_t inputFrame, uint32_t mask);
+    uint32_t GetFirstFrame() const { return frame - historyCount + 1; }
+    
+    uint32_t playerId = 0;
+    uint32_t inputMask = 0;   // InputCommand flags of the newest frame
+    uint16_t inputId = 0;     // Input sequence number
+    uint16_t timestamp = 0;   // Client timestamp
+    uint32_t frame = 0;       // Frame of inputMask
+    uint32_t ackFrame = 0;    // Sender holds every remote input up to here
+    uint8_t historyCount = 0; // Frames in history, newest last
+    uint32_t history[MAX_HISTORY] = {};
 };
 
 class InputPredictionPacket : public NetworkPacket {
@@ -139,7 +204,7 @@ public:
         m_priority = PacketPriority::Critical;
     }
     
-    void Serialize(std::vector<uint8_t>& buffer) const override;
+    void WritePayload(PacketWriter& writer) const override;
     void Deserialize(const uint8_t* data, size_t size) override;
     
     uint32_t playerId;
@@ -147,22 +212,57 @@ public:
     uint16_t predictedInputs[8];  // Up to 8 predicted inputs
 };
 
+// Player state in wire units: position and velocity in 1/16 world units,
+// rotation in 1/1024 turns. Quantizing is the only lossy step of the
+// delta pipeline; everything after it is exact integer arithmetic.
+struct QuantizedPlayerState {
+    static constexpr float POSITION_SCALE = 16.0f;
+    static constexpr int ROTATION_BITS = 10;
+    
+    int32_t position[3] = {};
+    int32_t velocity[3] = {};
+    uint16_t rotation = 0;
+    uint16_t state = 0;
+    uint16_t health = 0;
+    uint8_t mana = 0;
+    uint8_t currentGear = 0;
+    
+    static QuantizedPlayerState FromPacket(const PlayerStatePacket& packet);
+    void ToPacket(PlayerStatePacket& packet) const;
+};
+
+// Bit-packed delta of one player's state against a baseline snapshot the
+// receiver has acknowledged. Without a baseline every field is sent
+// absolute. See DeltaStateEncoder/DeltaStateDecoder.
 class DeltaStatePacket : public NetworkPacket {
 public:
-    DeltaStatePacket() : NetworkPacket(PacketType::DeltaState) {}
+    enum Field : uint8_t {
+        FieldPosition = 0x01,
+        FieldVelocity = 0x02,
+        FieldRotation = 0x04,
+        FieldHealth = 0x08,
+        FieldMana = 0x10,
+        FieldState = 0x20,
+        FieldGear = 0x40,
+        FieldAll = 0x7F
+    };
+    
+    DeltaStatePacket() : NetworkPacket(PacketType::DeltaState) {
+        m_priority = PacketPriority::Important;
+    }
     
-    void Serialize(std::vector<uint8_t>& buffer) const override;
+    void WritePayload(PacketWriter& writer) const override;
     void Deserialize(const uint8_t* data, size_t size) override;
     
-    uint32_t playerId;
-    uint8_t changedFields;     // Bitmask of changed fields
+    uint32_t playerId = 0;
+    uint8_t changedFields = 0;     // Bitmask of changed fields
+    uint8_t snapshotId = 0;        // Id the receiver acknowledges
+    uint8_t baselineId = 0;        // Snapshot the delta applies to
+    bool hasBaseline = false;
     
-    // Optional fields based on changedFields bitmask
-    float* position = nullptr;
-    float* velocity = nullptr;
-    float* rotation = nullptr;
-    uint16_t* health = nullptr;
-    uint8_t* mana = nullptr;
+    // Fields flagged in changedFields; position and velocity hold the
+    // difference to the baseline when hasBaseline is set
+    QuantizedPlayerState values;
 };
 
 // Combat Packets
@@ -173,7 +273,7 @@ public:
         m_priority = PacketPriority::Critical;
     }
     
-    void Serialize(std::vector<uint8_t>& buffer) const override;
+    void WritePayload(PacketWriter& writer) const override;
     void Deserialize(const uint8_t* data, size_t size) override;
     
     uint32_t attackerId;
@@ -191,7 +291,7 @@ public:
         m_priority = PacketPriority::Critical;
     }
     
-    void Serialize(std::vector<uint8_t>& buffer) const override;
+    void WritePayload(PacketWriter& writer) const override;
     void Deserialize(const uint8_t* data, size_t size) override;
     
     uint32_t targetId;
@@ -207,7 +307,7 @@ class MatchStartPacket : public NetworkPacket {
 public:
     MatchStartPacket() : NetworkPacket(PacketType::MatchStart) {}
     
-    void Serialize(std::vector<uint8_t>& buffer) const override;
+    void WritePayload(PacketWriter& writer) const override;
     void Deserialize(const uint8_t* data, size_t size) override;
     
     uint32_t matchId;
@@ -218,11 +318,75 @@ public:
     uint32_t randomSeed;       // For synchronized RNG
 };
 
-// Packet factory
+// Hashes of the simulation state at recently confirmed frames, oldest
+// first; peers compare them to catch a desync as soon as it happens.
+// Per-field hashes are only sent by peers in desync debug mode.
+class MatchSyncPacket : public NetworkPacket {
+public:
+    static constexpr int MAX_HASHES = NetworkConfig::STATE_HASHES_PER_SYNC;
+    
+    MatchSyncPacket() : NetworkPacket(PacketType::MatchSync) {}
+    
+    void WritePayload(PacketWriter& writer) const override;
+    void Deserialize(const uint8_t* data, size_t size) override;
+    
+    uint32_t playerId = 0;
+    uint8_t hashCount = 0;
+    StateHash hashes[MAX_HASHES];
+};
+
+// System Packets
+
+class SystemPacket : public NetworkPacket {
+public:
+    SystemPacket(PacketType type) : NetworkPacket(type) {
+        m_priority = PacketPriority::Important;
+    }
+    
+    void WritePayload(PacketWriter& writer) const override;
+    void Deserialize(const uint8_t* data, size_t size) override;
+    
+    uint32_t playerId = 0;
+    uint32_t payload = 0;      // Type-specific value (assigned id, acked snapshot...)
+};
+
+// Ping and Pong, queued and coalesced like other traffic. Time spent in
+// send queues is measured rather than avoided: the Ping notes when its
+// frame was sampled, and the Pong when the Ping arrived, both against the
+// sender's own header timestamp. Both also carry the sender's frame and
+// its lead over the target so each side can run TimeSync.
+class TimeSyncPacket : public NetworkPacket {
+public:
+    TimeSyncPacket(PacketType type) : NetworkPacket(type) {
+        m_priority = PacketPriority::Critical;
+    }
+    
+    void WritePayload(PacketWriter& writer) const override;
+    void Deserialize(const uint8_t* data, size_t size) override;
+    
+    uint32_t playerId = 0;          // Sender
+    uint32_t targetId = 0;          // Peer being timed
+    uint32_t frame = 0;             // Sender's frame at frameTimestamp
+    uint32_t frameTimestamp = 0;
+    float frameAdvantage = 0.0f;    // Sender's lead over targetId, in frames
+    uint32_t echoTimestamp = 0;     // Pong only: the Ping's header timestamp
+    uint32_t receiveTimestamp = 0;  // Pong only: when the Ping arrived
+};
+
+// Packet factory. The pool overloads are the allocation-free path used
+// on the wire; the others allocate every packet.
 class PacketFactory {
 public:
     static std::unique_ptr<NetworkPacket> CreatePacket(PacketType type);
+    static PacketPtr CreatePacket(PacketType type, PacketPool& pool);
     static std::unique_ptr<NetworkPacket> CreateFromData(const uint8_t* data, size_t size);
+    
+    // De-multiplexes a coalesced datagram, appending every intact packet.
+    // Returns the number of packets appended.
+    static size_t CreateFromData(const uint8_t* data, size_t size,
+                                 std::vector<std::unique_ptr<NetworkPacket>>& packets);
+    static size_t CreateFromData(const uint8_t* data, size_t size,
+                                 std::vector<PacketPtr>& packets, PacketPool& pool);
 };
 
 } // namespace ArenaFighter
\ No newline at end of file
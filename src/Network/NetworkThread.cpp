@@ -0,0 +1,178 @@
+#include "NetworkThread.h"
+#include "NetworkPacket.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+namespace ArenaFighter {
+
+uint32_t GetTimestampMs() {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+NetworkThread::NetworkThread()
+    : m_running(false)
+    , m_sleeping(false)
+    , m_received(std::make_unique<SpscRing<ReceivedPacket, RECEIVE_RING_SIZE>>())
+    , m_sending(std::make_unique<SpscRing<OutgoingDatagram, SEND_RING_SIZE>>())
+    , m_receiveOverflows(0) {
+    // Room for the most packets a datagram can hold
+    m_decoded.reserve(NetworkConfig::PACKET_SIZE_LIMIT / sizeof(PacketHeader));
+}
+
+NetworkThread::~NetworkThread() {
+    Stop();
+}
+
+void NetworkThread::Start(std::unique_ptr<UdpSocket> socket) {
+    Stop();
+
+    m_socket = std::move(socket);
+    m_wakeup.Open();   // Without it sends wait out the poll timeout
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread([this] { Run(); });
+}
+
+void NetworkThread::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_running.store(false, std::memory_order_release);
+    m_wakeup.Signal();
+    m_thread.join();
+
+    m_socket->Close();
+    m_socket.reset();
+    m_wakeup.Close();
+
+    ReceivedPacket leftover;
+    while (m_received->TryPop(leftover)) {
+    }
+}
+
+bool NetworkThread::Send(const UdpEndpoint& endpoint, const uint8_t* data, size_t size) {
+    return Send(endpoint, data, size, nullptr, 0);
+}
+
+bool NetworkThread::Send(const UdpEndpoint& endpoint, const uint8_t* data, size_t size,
+                         const uint8_t* tail, size_t tailSize) {
+    if (!m_socket || size + tailSize > sizeof(OutgoingDatagram::data)) {
+        return false;
+    }
+
+    bool queued = m_sending->TryEmplace([&](OutgoingDatagram& slot) {
+        slot.endpoint = endpoint;
+        slot.size = size + tailSize;
+        std::memcpy(slot.data, data, size);
+        if (tailSize > 0) {
+            std::memcpy(slot.data + size, tail, tailSize);
+        }
+    });
+
+    if (!queued) {
+        return false;
+    }
+
+    // Pairs with the fence in Run(): either it sees this datagram before
+    // sleeping or we see it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.exchange(false)) {
+        m_wakeup.Signal();
+    }
+    return true;
+}
+
+bool NetworkThread::Receive(ReceivedPacket& out) {
+    return m_received->TryPop(out);
+}
+
+void NetworkThread::Run() {
+    m_packetPool.BindToCurrentThread();
+
+    while (m_running.load(std::memory_order_acquire)) {
+        FlushSends();
+
+        if (!ReceiveDatagrams()) {
+            // Announce the sleep, then look once more, so a Send() racing
+            // with it either lands before the check or signals the wakeup
+            m_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_sending->EmptyApprox() && m_running.load(std::memory_order_acquire)) {
+                m_socket->WaitForData(NetworkConfig::NETWORK_THREAD_WAIT_MS, &m_wakeup);
+            }
+            m_sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    // Whatever was queued before Stop(), e.g. a Disconnect
+    FlushSends();
+}
+
+void NetworkThread::FlushSends() {
+    OutgoingDatagram* pending[UdpSocket::MAX_BATCH];
+    UdpDatagram batch[UdpSocket::MAX_BATCH];
+
+    size_t count;
+    while ((count = m_sending->Peek(pending, UdpSocket::MAX_BATCH)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            batch[i].endpoint = pending[i]->endpoint;
+            batch[i].data = pending[i]->data;
+            batch[i].size = pending[i]->size;
+        }
+
+        // Datagrams the kernel refuses are dropped like any UDP loss
+        m_socket->SendBatch(batch, count);
+        m_sending->Pop(count);
+    }
+}
+
+bool NetworkThread::ReceiveDatagrams() {
+    UdpDatagram datagrams[UdpSocket::MAX_BATCH];
+    bool receivedAny = false;
+
+    size_t count;
+    while ((count = m_socket->ReceiveBatch(datagrams, UdpSocket::MAX_BATCH)) > 0) {
+        receivedAny = true;
+        uint32_t arrivalMs = GetTimestampMs();
+
+        for (size_t i = 0; i < count; ++i) {
+            // Split coalesced datagrams; corrupted packets are dropped
+            m_decoded.clear();
+            PacketFactory::CreateFromData(datagrams[i].data, datagrams[i].size, m_decoded, m_packetPool);
+
+            const uint8_t* acks = ReliableConnection::FindAckTrailer(datagrams[i].data, datagrams[i].size);
+            if (acks && m_decoded.empty()) {
+                m_decoded.emplace_back();   // Ack-only datagram
+            }
+
+            for (auto& packet : m_decoded) {
+                ReceivedPacket received;
+                received.source = datagrams[i].endpoint;
+                received.arrivalMs = arrivalMs;
+                received.packet = std::move(packet);
+                if (acks) {
+                    received.hasAcks = true;
+                    std::memcpy(received.acks, acks, sizeof(received.acks));
+                    acks = nullptr;
+                }
+
+                if (!m_received->TryPush(std::move(received))) {
+                    m_receiveOverflows.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        if (count < UdpSocket::MAX_BATCH) {
+            break;
+        }
+    }
+
+    return receivedAny;
+}
+
+} // namespace ArenaFighter
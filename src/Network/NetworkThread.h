@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "NetworkConfig.h"
+#include "NetworkPacket.h"
+#include "PacketPool.h"
+#include "ReliableConnection.h"
+#include "SpscRing.h"
+#include "UdpSocket.h"
+
+namespace ArenaFighter {
+
+// Steady clock in ms, wrapping every ~49 days. Packet timestamps and
+// arrival times both use it, so they can be compared directly.
+uint32_t GetTimestampMs();
+
+// A decoded packet and the time its datagram came off the socket. The
+// datagram's ack trailer, if any, rides on its first packet, or on an
+// entry without a packet when the datagram carried nothing else.
+struct ReceivedPacket {
+    UdpEndpoint source;
+    uint32_t arrivalMs = 0;
+    PacketPtr packet;
+    bool hasAcks = false;
+    uint8_t acks[ReliableConnection::ACK_SIZE];
+};
+
+// A serialized datagram waiting for the I/O thread
+struct OutgoingDatagram {
+    UdpEndpoint endpoint;
+    size_t size = 0;
+    uint8_t data[NetworkConfig::PACKET_SIZE_LIMIT];
+};
+
+// Owns the socket on a dedicated thread, so receiving no longer waits for
+// the game loop. The thread blocks on the socket, timestamps and decodes
+// each datagram as soon as it arrives, and sends whatever the game thread
+// has queued; a send to a sleeping thread wakes it at once. Both directions go through lock-free single-producer/
+// single-consumer rings. Only one game thread may call Send() and
+// Receive(). Decoded packets come from the thread's own pool and return
+// to it when the game thread drops them.
+class NetworkThread {
+public:
+    static constexpr size_t RECEIVE_RING_SIZE = 1024;   // Packets
+    static constexpr size_t SEND_RING_SIZE = 512;       // A full send tick to 8 peers
+
+    NetworkThread();
+    ~NetworkThread();
+
+    NetworkThread(const NetworkThread&) = delete;
+    NetworkThread& operator=(const NetworkThread&) = delete;
+
+    // Takes over an open socket and starts the thread
+    void Start(std::unique_ptr<UdpSocket> socket);
+
+    // Sends everything already queued, then joins the thread and closes
+    // the socket. Packets not yet collected are dropped.
+    void Stop();
+
+    bool IsRunning() const { return m_socket != nullptr; }
+    int GetLocalPort() const { return m_socket ? m_socket->GetLocalPort() : 0; }
+
+    // Copies the datagram into the send ring. Returns false if the ring is
+    // full or the thread is not running.
+    bool Send(const UdpEndpoint& endpoint, const uint8_t* data, size_t size);
+
+    // Same, with per-peer bytes appended to a datagram shared by all peers
+    bool Send(const UdpEndpoint& endpoint, const uint8_t* data, size_t size,
+              const uint8_t* tail, size_t tailSize);
+
+    // Next decoded packet, oldest first
+    bool Receive(ReceivedPacket& out);
+
+    // Packets dropped because the game thread fell RECEIVE_RING_SIZE behind
+    uint32_t GetReceiveOverflows() const { return m_receiveOverflows.load(std::memory_order_relaxed); }
+
+private:
+    void Run();
+    void FlushSends();
+    bool ReceiveDatagrams();
+
+    std::unique_ptr<UdpSocket> m_socket;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+
+    // Set by the I/O thread just before it blocks, so Send() signals only
+    // when someone is waiting rather than once per datagram
+    SocketWakeup m_wakeup;
+    std::atomic<bool> m_sleeping;
+
+    // Declared before anything holding its packets
+    PacketPool m_packetPool;
+
+    std::unique_ptr<SpscRing<ReceivedPacket, RECEIVE_RING_SIZE>> m_received;  // I/O thread -> game
+    std::unique_ptr<SpscRing<OutgoingDatagram, SEND_RING_SIZE>> m_sending;    // Game -> I/O thread
+
+    // I/O thread only: packets split out of the current datagram
+    std::vector<PacketPtr> m_decoded;
+
+    std::atomic<uint32_t> m_receiveOverflows;
+};
+
+} // namespace ArenaFighter
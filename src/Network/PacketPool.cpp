@@ -0,0 +1,65 @@
+#include "PacketPool.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+void PacketDeleter::operator()(NetworkPacket* packet) const {
+    if (pool) {
+        pool->Release(packet);
+    } else {
+        delete packet;
+    }
+}
+
+PacketPool::PacketPool(size_t packetsPerType)
+    : m_returned(std::make_unique<SpscRing<void*, RETURN_RING_SIZE>>())
+    , m_owner(std::this_thread::get_id())
+    , m_heapFallbacks(0) {
+    InitSlabs(std::min(packetsPerType, PACKETS_PER_TYPE), std::make_index_sequence<TYPE_COUNT>{});
+}
+
+void* PacketPool::TakeSlot(size_t typeIndex) {
+    Slab& slab = m_slabs[typeIndex];
+    if (slab.free.empty()) {
+        ReclaimReturned();
+        if (slab.free.empty()) {
+            return nullptr;
+        }
+    }
+
+    void* slot = slab.free.back();
+    slab.free.pop_back();
+    return slot;
+}
+
+void PacketPool::Release(NetworkPacket* packet) {
+    packet->~NetworkPacket();
+
+    void* slot = packet;
+    if (std::this_thread::get_id() == m_owner.load(std::memory_order_acquire)) {
+        for (Slab& slab : m_slabs) {
+            if (slab.Contains(slot)) {
+                slab.free.push_back(slot);
+                return;
+            }
+        }
+        return;
+    }
+
+    // Sized for the whole pool, so this cannot fail
+    m_returned->TryPush(std::move(slot));
+}
+
+void PacketPool::ReclaimReturned() {
+    void* slot;
+    while (m_returned->TryPop(slot)) {
+        for (Slab& slab : m_slabs) {
+            if (slab.Contains(slot)) {
+                slab.free.push_back(slot);
+                break;
+            }
+        }
+    }
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "NetworkConfig.h"
+#include "NetworkPacket.h"
+#include "SpscRing.h"
+
+namespace ArenaFighter {
+
+// Every packet class the pool keeps storage for
+using PooledPacketTypes = std::tuple<
+    PlayerStatePacket, InputPacket, InputPredictionPacket, DeltaStatePacket,
+    AttackPacket, DamagePacket, MatchStartPacket, MatchSyncPacket,
+    SystemPacket, TimeSyncPacket>;
+
+// Fixed slabs of storage per packet class, allocated once at construction.
+// Acquire() constructs a packet in a free slot and returns a handle whose
+// deleter puts the slot back. Once a slab is empty, packets of that class
+// fall back to the heap; GetHeapFallbacks() counts them.
+//
+// Acquire is for the owner thread only. Packets may be released on the
+// owner thread and on one other thread; the other thread's releases go
+// back through a lock-free ring that the owner drains when it runs short.
+// That covers packets decoded on the network thread and handled on the
+// game thread. Handles must not outlive their pool.
+class PacketPool {
+public:
+    static constexpr size_t PACKETS_PER_TYPE = NetworkConfig::PACKET_POOL_SIZE;
+    static constexpr size_t TYPE_COUNT = std::tuple_size_v<PooledPacketTypes>;
+
+    // packetsPerType is capped at PACKETS_PER_TYPE
+    explicit PacketPool(size_t packetsPerType = PACKETS_PER_TYPE);
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    template <typename T, typename... Args>
+    PacketRef<T> Acquire(Args&&... args);
+
+    // Makes the calling thread the owner. The constructing thread owns the
+    // pool until then.
+    void BindToCurrentThread() { m_owner.store(std::this_thread::get_id(), std::memory_order_release); }
+
+    // Owner thread only
+    size_t GetFreeCount(size_t typeIndex) const { return m_slabs[typeIndex].free.size(); }
+    size_t GetHeapFallbacks() const { return m_heapFallbacks; }
+
+    template <typename T>
+    static constexpr size_t TypeIndex() { return TypeIndexOf<T, PooledPacketTypes>::value; }
+
+private:
+    friend struct PacketDeleter;
+
+    template <typename T, typename Tuple>
+    struct TypeIndexOf;
+    template <typename T, typename... Rest>
+    struct TypeIndexOf<T, std::tuple<T, Rest...>> : std::integral_constant<size_t, 0> {};
+    template <typename T, typename First, typename... Rest>
+    struct TypeIndexOf<T, std::tuple<First, Rest...>>
+        : std::integral_constant<size_t, 1 + TypeIndexOf<T, std::tuple<Rest...>>::value> {};
+
+    struct Slab {
+        std::unique_ptr<std::byte[]> storage;
+        size_t slotSize = 0;
+        size_t slotCount = 0;
+        std::vector<void*> free;
+
+        bool Contains(const void* slot) const {
+            const std::byte* address = static_cast<const std::byte*>(slot);
+            return address >= storage.get() && address < storage.get() + slotSize * slotCount;
+        }
+    };
+
+    template <size_t... Index>
+    void InitSlabs(size_t packetsPerType, std::index_sequence<Index...>);
+
+    void* TakeSlot(size_t typeIndex);
+    void Release(NetworkPacket* packet);
+    void ReclaimReturned();
+
+    // Large enough for every slot of every slab, so a release never fails
+    static constexpr size_t RETURN_RING_SIZE = 4096;
+    static_assert(RETURN_RING_SIZE >= PACKETS_PER_TYPE * TYPE_COUNT, "Return ring must fit the whole pool");
+
+    std::array<Slab, TYPE_COUNT> m_slabs;
+    std::unique_ptr<SpscRing<void*, RETURN_RING_SIZE>> m_returned;   // Released off the owner thread
+    std::atomic<std::thread::id> m_owner;
+    size_t m_heapFallbacks;
+};
+
+template <typename T, typename... Args>
+PacketRef<T> PacketPool::Acquire(Args&&... args) {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Slab storage is not aligned for this packet");
+
+    void* slot = TakeSlot(TypeIndex<T>());
+    if (!slot) {
+        m_heapFallbacks++;
+        return PacketRef<T>(new T(std::forward<Args>(args)...), PacketDeleter{});
+    }
+
+    return PacketRef<T>(new (slot) T(std::forward<Args>(args)...), PacketDeleter{ this });
+}
+
+template <size_t... Index>
+void PacketPool::InitSlabs(size_t packetsPerType, std::index_sequence<Index...>) {
+    constexpr size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    constexpr size_t sizes[] = { sizeof(std::tuple_element_t<Index, PooledPacketTypes>)... };
+
+    for (size_t i = 0; i < TYPE_COUNT; ++i) {
+        Slab& slab = m_slabs[i];
+        slab.slotSize = (sizes[i] + alignment - 1) / alignment * alignment;
+        slab.slotCount = packetsPerType;
+        slab.storage = std::make_unique<std::byte[]>(slab.slotSize * slab.slotCount);
+
+        // Hand out the lowest addresses first
+        slab.free.reserve(slab.slotCount);
+        for (size_t slot = slab.slotCount; slot-- > 0;) {
+            slab.free.push_back(slab.storage.get() + slot * slab.slotSize);
+        }
+    }
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,294 @@
+#include "ReliableConnection.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ArenaFighter {
+
+namespace {
+
+constexpr uint16_t CHANNEL_BIT = 0x8000;
+
+uint16_t Distance(uint16_t from, uint16_t to) {
+    return static_cast<uint16_t>((to - from) & ReliableConnection::ID_MASK);
+}
+
+// Ids newer than another by less than half the id space count as ahead
+bool IsNewer(uint16_t id, uint16_t than) {
+    uint16_t distance = Distance(than, id);
+    return distance != 0 && distance <= ReliableConnection::ID_MASK / 2;
+}
+
+size_t ChannelOf(const NetworkPacket& packet) {
+    return static_cast<size_t>(packet.HasFlag(PacketFlags::Ordered) ? ReliableChannel::Ordered : ReliableChannel::Unordered);
+}
+
+} // namespace
+
+ReliableConnection::ReliableConnection() {
+    Reset();
+}
+
+void ReliableConnection::Reset() {
+    for (auto& channel : m_send) {
+        for (auto& message : channel.messages) {
+            message.pending = false;
+        }
+        channel.oldest = 0;
+        channel.next = 0;
+    }
+
+    for (auto& channel : m_receive) {
+        channel.newest = ID_MASK;
+        channel.bits = 0;
+        channel.any = false;
+        channel.expected = 0;
+        for (auto& packet : channel.held) {
+            packet.reset();
+        }
+    }
+
+    m_newAcks[0] = m_newAcks[1] = false;
+    m_ackTurn = 0;
+    m_smoothedRtt = 0.0f;
+    m_rttVariation = 0.0f;
+    m_stats = ReliabilityStats();
+}
+
+bool ReliableConnection::Add(NetworkPacket& packet, uint32_t nowMs) {
+    SendChannel& channel = m_send[ChannelOf(packet)];
+    Message& message = channel.messages[channel.next % MAX_PENDING];
+    if (message.pending) {
+        m_stats.dropped++;
+        return false;
+    }
+
+    packet.AddFlag(PacketFlags::Reliable);
+    packet.SetSequence(channel.next);
+    packet.SetTimestamp(nowMs);
+
+    message.data.resize(MAX_MESSAGE_SIZE);
+    size_t size = packet.Serialize(message.data.data(), message.data.size());
+    if (size == 0) {
+        m_stats.dropped++;
+        return false;
+    }
+    message.data.resize(size);
+    message.sends = 0;
+    message.pending = true;
+
+    channel.next = (channel.next + 1) & ID_MASK;
+    m_stats.messagesSent++;
+    return true;
+}
+
+uint32_t ReliableConnection::GetResendTimeout() const {
+    if (m_smoothedRtt <= 0.0f) {
+        return INITIAL_TIMEOUT_MS;
+    }
+
+    // As TCP does, allow four deviations of slack over the smoothed round trip
+    float timeout = m_smoothedRtt + 4.0f * m_rttVariation;
+    return std::clamp(static_cast<uint32_t>(std::ceil(timeout)), MIN_TIMEOUT_MS, MAX_TIMEOUT_MS);
+}
+
+bool ReliableConnection::IsDue(const SendChannel& channel, uint16_t id, uint32_t nowMs) const {
+    const Message& message = channel.messages[id % MAX_PENDING];
+    if (!message.pending) {
+        return false;
+    }
+    if (message.sends == 0) {
+        return true;
+    }
+
+    // Back off while the peer stays silent
+    uint32_t timeout = std::min(GetResendTimeout() << std::min<uint32_t>(message.sends - 1, 4), MAX_TIMEOUT_MS);
+    return nowMs - message.lastSentMs >= timeout;
+}
+
+bool ReliableConnection::HasDue(uint32_t nowMs) const {
+    for (const SendChannel& channel : m_send) {
+        // Only ids the peer's ack bits can still cover go out
+        uint16_t inFlight = std::min<uint16_t>(Distance(channel.oldest, channel.next), WINDOW);
+        for (uint16_t i = 0; i < inFlight; ++i) {
+            if (IsDue(channel, (channel.oldest + i) & ID_MASK, nowMs)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t ReliableConnection::WriteDue(uint8_t* out, size_t capacity, uint32_t nowMs) {
+    size_t written = 0;
+    for (SendChannel& channel : m_send) {
+        uint16_t inFlight = std::min<uint16_t>(Distance(channel.oldest, channel.next), WINDOW);
+        for (uint16_t i = 0; i < inFlight; ++i) {
+            uint16_t id = (channel.oldest + i) & ID_MASK;
+            if (!IsDue(channel, id, nowMs)) {
+                continue;
+            }
+
+            Message& message = channel.messages[id % MAX_PENDING];
+            if (message.data.size() > capacity - written) {
+                continue;
+            }
+            std::memcpy(out + written, message.data.data(), message.data.size());
+            written += message.data.size();
+
+            if (message.sends == 0) {
+                message.firstSentMs = nowMs;
+            } else {
+                m_stats.resends++;
+            }
+            message.lastSentMs = nowMs;
+            message.sends++;
+        }
+    }
+    return written;
+}
+
+void ReliableConnection::WriteAcks(uint8_t* out) {
+    // News first, otherwise the channels take turns
+    size_t channel = m_ackTurn;
+    if (!m_newAcks[channel] && (m_newAcks[1 - channel] || !m_receive[channel].any)) {
+        channel = 1 - channel;
+    }
+    m_newAcks[channel] = false;
+    m_ackTurn = static_cast<uint8_t>(1 - channel);
+
+    const ReceiveChannel& receive = m_receive[channel];
+    uint16_t ack = static_cast<uint16_t>(receive.newest | (channel ? CHANNEL_BIT : 0));
+    std::memcpy(out, &ack, sizeof(ack));
+    std::memcpy(out + sizeof(ack), &receive.bits, sizeof(receive.bits));
+}
+
+void ReliableConnection::ReadAcks(const uint8_t* trailer, uint32_t nowMs) {
+    uint16_t ack;
+    uint32_t bits;
+    std::memcpy(&ack, trailer, sizeof(ack));
+    std::memcpy(&bits, trailer + sizeof(ack), sizeof(bits));
+
+    SendChannel& channel = m_send[(ack & CHANNEL_BIT) ? 1 : 0];
+    uint16_t newest = ack & ID_MASK;
+
+    Acknowledge(channel, newest, nowMs);
+    for (uint16_t i = 0; i < ACK_BITS; ++i) {
+        if (bits & (1u << i)) {
+            Acknowledge(channel, (newest - 1 - i) & ID_MASK, nowMs);
+        }
+    }
+
+    while (channel.oldest != channel.next && !channel.messages[channel.oldest % MAX_PENDING].pending) {
+        channel.oldest = (channel.oldest + 1) & ID_MASK;
+    }
+}
+
+void ReliableConnection::Acknowledge(SendChannel& channel, uint16_t id, uint32_t nowMs) {
+    // Ids outside what is in flight are stale acks
+    if (Distance(channel.oldest, id) >= Distance(channel.oldest, channel.next)) {
+        return;
+    }
+
+    Message& message = channel.messages[id % MAX_PENDING];
+    if (!message.pending || message.sends == 0) {
+        return;
+    }
+    message.pending = false;
+    m_stats.acked++;
+
+    // A resent message's ack could answer any of its copies, so only
+    // messages sent once are timed
+    if (message.sends == 1) {
+        AddRoundTrip(static_cast<float>(nowMs - message.firstSentMs));
+    }
+}
+
+void ReliableConnection::AddRoundTrip(float rttMs) {
+    if (m_smoothedRtt <= 0.0f) {
+        m_smoothedRtt = std::max(rttMs, 1.0f);
+        m_rttVariation = rttMs / 2.0f;
+        return;
+    }
+
+    m_rttVariation = 0.75f * m_rttVariation + 0.25f * std::abs(m_smoothedRtt - rttMs);
+    m_smoothedRtt = 0.875f * m_smoothedRtt + 0.125f * rttMs;
+}
+
+ReliableConnection::Arrival ReliableConnection::Receive(PacketPtr& packet) {
+    size_t index = ChannelOf(*packet);
+    ReceiveChannel& channel = m_receive[index];
+    uint16_t id = packet->GetHeader().sequence & ID_MASK;
+
+    // The sender keeps at most WINDOW ids in flight, so anything the bits
+    // no longer cover was delivered long ago
+    if (IsNewer(id, channel.newest)) {
+        uint16_t shift = Distance(channel.newest, id);
+        uint64_t bits = shift > ACK_BITS ? 0 : static_cast<uint64_t>(channel.bits) << shift;
+        if (channel.any && shift <= ACK_BITS) {
+            bits |= 1ull << (shift - 1);   // The previous newest
+        }
+        channel.bits = static_cast<uint32_t>(bits);
+        channel.newest = id;
+        channel.any = true;
+    } else {
+        uint16_t age = Distance(id, channel.newest);
+        if (age == 0 || age > ACK_BITS || (channel.bits & (1u << (age - 1)))) {
+            m_newAcks[index] = true;   // Our ack was lost; repeat it
+            m_stats.duplicates++;
+            return Arrival::Duplicate;
+        }
+        channel.bits |= 1u << (age - 1);
+    }
+    m_newAcks[index] = true;
+
+    if (index == static_cast<size_t>(ReliableChannel::Unordered) || id == channel.expected) {
+        if (index == static_cast<size_t>(ReliableChannel::Ordered)) {
+            channel.expected = (channel.expected + 1) & ID_MASK;
+        }
+        m_stats.received++;
+        return Arrival::Deliver;
+    }
+
+    channel.held[id % MAX_PENDING] = std::move(packet);
+    m_stats.heldBack++;
+    return Arrival::Held;
+}
+
+bool ReliableConnection::PopReady(PacketPtr& out) {
+    ReceiveChannel& channel = m_receive[static_cast<size_t>(ReliableChannel::Ordered)];
+    PacketPtr& next = channel.held[channel.expected % MAX_PENDING];
+    if (!next) {
+        return false;
+    }
+
+    out = std::move(next);
+    channel.expected = (channel.expected + 1) & ID_MASK;
+    m_stats.received++;
+    return true;
+}
+
+const uint8_t* ReliableConnection::FindAckTrailer(const uint8_t* data, size_t size) {
+    // Walk the packet framing the way SplitDatagram() does
+    size_t offset = 0;
+    while (size - offset >= sizeof(PacketHeader)) {
+        PacketHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
+        if (header.size < sizeof(PacketHeader) || header.size > size - offset) {
+            return nullptr;
+        }
+        offset += header.size;
+    }
+    return size - offset == ACK_SIZE ? data + offset : nullptr;
+}
+
+size_t ReliableConnection::GetPendingCount(ReliableChannel channel) const {
+    const SendChannel& send = m_send[static_cast<size_t>(channel)];
+    size_t count = 0;
+    for (const Message& message : send.messages) {
+        count += message.pending ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace ArenaFighter
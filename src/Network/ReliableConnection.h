@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "NetworkConfig.h"
+#include "NetworkPacket.h"
+
+namespace ArenaFighter {
+
+// Reliable packets travel on one of two channels with their own message
+// ids, so a lost unordered message never holds up an ordered one and the
+// other way round. Unreliable packets bypass both.
+enum class ReliableChannel : uint8_t {
+    Unordered = 0,   // Delivered as soon as it arrives, e.g. MatchSync
+    Ordered = 1      // Delivered in send order, e.g. MatchStart, Disconnect
+};
+
+struct ReliabilityStats {
+    uint32_t messagesSent = 0;     // Added with Add()
+    uint32_t resends = 0;
+    uint32_t acked = 0;
+    uint32_t dropped = 0;          // Add() found no free slot
+    uint32_t received = 0;         // Delivered once each
+    uint32_t duplicates = 0;
+    uint32_t heldBack = 0;         // Ordered messages that arrived early
+};
+
+// Reliability for one peer. Every datagram to the peer ends in a 6-byte
+// ack trailer: the newest message id received on one channel and a
+// bitfield of the 32 ids before it. The channels take turns, the one with
+// news first, so a single trailer covers both and a lost datagram's acks
+// are repeated by the next. Unacked messages are resent once the resend
+// timeout, taken from the round trips the acks measure, has passed.
+//
+// The trailer is shorter than a PacketHeader, so SplitDatagram() stops in
+// front of it and older readers ignore it; FindAckTrailer() finds it.
+class ReliableConnection {
+public:
+    static constexpr size_t ACK_SIZE = 6;
+    static constexpr uint16_t ACK_BITS = 32;
+    static constexpr uint16_t WINDOW = ACK_BITS + 1;      // Unacked messages in flight per channel
+    static constexpr uint16_t MAX_PENDING = 64;           // Sent or waiting for the window, per channel
+    static constexpr uint16_t ID_MASK = 0x7FFF;           // The trailer's top bit is the channel
+    static constexpr size_t MAX_MESSAGE_SIZE = NetworkConfig::PACKET_SIZE_LIMIT - ACK_SIZE;
+
+    static constexpr uint32_t INITIAL_TIMEOUT_MS = 200;   // Until an ack has been timed
+    static constexpr uint32_t MIN_TIMEOUT_MS = 40;        // About one send interval of ack delay
+    static constexpr uint32_t MAX_TIMEOUT_MS = 2000;
+
+    ReliableConnection();
+
+    void Reset();
+
+    // Sending
+
+    // Gives the packet its channel's next message id and keeps a
+    // serialized copy until the peer acks it. The channel comes from
+    // PacketFlags::Ordered. Returns false, and counts it as dropped, if
+    // MAX_PENDING messages are still unacked or the packet is too large.
+    bool Add(NetworkPacket& packet, uint32_t nowMs);
+
+    // A message is due when it was never sent, or its resend timeout ran out
+    bool HasDue(uint32_t nowMs) const;
+
+    // Appends due messages, oldest first, while they fit. Returns the bytes
+    // written; a message that did not fit stays due.
+    size_t WriteDue(uint8_t* out, size_t capacity, uint32_t nowMs);
+
+    // Something arrived that the peer has not been told about yet; worth
+    // an ack-only datagram when nothing else is going out
+    bool HasNewAcks() const { return m_newAcks[0] || m_newAcks[1]; }
+
+    // Whether datagrams to the peer should carry a trailer at all
+    bool HasAcks() const { return m_receive[0].any || m_receive[1].any; }
+
+    // Writes ACK_SIZE bytes
+    void WriteAcks(uint8_t* out);
+
+    // Receiving
+
+    // Applies a trailer from the peer
+    void ReadAcks(const uint8_t* trailer, uint32_t nowMs);
+
+    enum class Arrival {
+        Deliver,     // Handle it now
+        Duplicate,   // Already delivered; drop it
+        Held         // Ordered and early; taken, comes back from PopReady()
+    };
+
+    // For packets with PacketFlags::Reliable
+    Arrival Receive(PacketPtr& packet);
+
+    // Held ordered messages whose turn has come, in order
+    bool PopReady(PacketPtr& out);
+
+    // The ack trailer at the end of a datagram, if it has one: what is left
+    // after the last packet is exactly ACK_SIZE bytes
+    static const uint8_t* FindAckTrailer(const uint8_t* data, size_t size);
+
+    // Stats
+    float GetRoundTrip() const { return m_smoothedRtt; }
+    uint32_t GetResendTimeout() const;
+    size_t GetPendingCount(ReliableChannel channel) const;
+    const ReliabilityStats& GetStats() const { return m_stats; }
+
+private:
+    struct Message {
+        std::vector<uint8_t> data;   // Serialized once; capacity is kept for reuse
+        uint32_t firstSentMs = 0;
+        uint32_t lastSentMs = 0;
+        uint32_t sends = 0;
+        bool pending = false;
+    };
+
+    struct SendChannel {
+        std::array<Message, MAX_PENDING> messages;   // By id % MAX_PENDING
+        uint16_t oldest = 0;    // Oldest id not yet acked
+        uint16_t next = 0;      // Id the next Add() gets
+    };
+
+    struct ReceiveChannel {
+        uint16_t newest = ID_MASK;   // One before the first id
+        uint32_t bits = 0;      // Bit i: id newest - 1 - i arrived
+        bool any = false;
+
+        // Ordered channel only
+        uint16_t expected = 0;
+        std::array<PacketPtr, MAX_PENDING> held;   // By id % MAX_PENDING, which survives the id wrap
+    };
+
+    bool IsDue(const SendChannel& channel, uint16_t id, uint32_t nowMs) const;
+    void Acknowledge(SendChannel& channel, uint16_t id, uint32_t nowMs);
+    void AddRoundTrip(float rttMs);
+
+    SendChannel m_send[2];
+    ReceiveChannel m_receive[2];
+    bool m_newAcks[2];
+    uint8_t m_ackTurn;
+
+    float m_smoothedRtt;      // 0 until the first sample
+    float m_rttVariation;
+    ReliabilityStats m_stats;
+};
+
+} // namespace ArenaFighter
@@ -0,0 +1,307 @@
+#include "Replay.h"
+#include "NetworkPacket.h"
+#include "DesyncDetector.h"
+#include "../Core/DeterministicRandom.h"
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace ArenaFighter {
+
+namespace {
+
+constexpr uint8_t MAGIC[4] = { 'D', 'F', 'R', 'P' };
+constexpr uint8_t FORMAT_VERSION = 1;
+
+// Footer flags
+constexpr uint8_t HAS_FINAL_HASH = 1;
+
+} // namespace
+
+ReplayHeader ReplayHeader::FromMatchStart(const MatchStartPacket& packet, uint32_t startFrame) {
+    ReplayHeader header;
+    header.matchId = packet.matchId;
+    header.gameMode = packet.gameMode;
+    header.stageId = packet.stageId;
+    header.randomSeed = packet.randomSeed;
+    header.startFrame = startFrame;
+    header.playerCount = static_cast<uint8_t>(std::min<size_t>(packet.playerCount, MAX_PLAYERS));
+    std::copy(packet.playerIds, packet.playerIds + header.playerCount, header.playerIds);
+    return header;
+}
+
+// ReplayWriter
+
+ReplayWriter::ReplayWriter(std::ostream& out)
+    : m_out(out)
+    , m_playerCount(0)
+    , m_current{}
+    , m_run(0)
+    , m_frameCount(0)
+    , m_bytesWritten(0)
+    , m_open(false) {
+}
+
+bool ReplayWriter::Begin(const ReplayHeader& header) {
+    if (m_open || header.playerCount == 0 || header.playerCount > ReplayHeader::MAX_PLAYERS) {
+        return false;
+    }
+
+    for (uint8_t byte : MAGIC) {
+        WriteByte(byte);
+    }
+    WriteByte(FORMAT_VERSION);
+    WriteVarint(header.matchId);
+    WriteByte(header.gameMode);
+    WriteByte(header.stageId);
+    for (int shift = 0; shift < 32; shift += 8) {
+        WriteByte(static_cast<uint8_t>(header.randomSeed >> shift));   // Random, a varint would not help
+    }
+    WriteVarint(header.startFrame);
+    WriteByte(header.playerCount);
+    for (uint8_t i = 0; i < header.playerCount; ++i) {
+        WriteVarint(header.playerIds[i]);
+    }
+
+    m_playerCount = header.playerCount;
+    std::fill(std::begin(m_current), std::end(m_current), 0u);
+    m_run = 0;
+    m_frameCount = 0;
+    m_open = m_out.good();
+    return m_open;
+}
+
+void ReplayWriter::AddFrame(const uint32_t* inputs) {
+    if (!m_open) {
+        return;
+    }
+    m_frameCount++;
+
+    uint8_t changed = 0;
+    for (size_t i = 0; i < m_playerCount; ++i) {
+        changed |= inputs[i] != m_current[i] ? static_cast<uint8_t>(1u << i) : 0;
+    }
+
+    // The very first frame always opens a record, even when all zero
+    if (changed == 0 && m_run > 0) {
+        m_run++;
+        return;
+    }
+
+    if (m_run > 0) {
+        WriteVarint(m_run);
+    }
+
+    WriteByte(changed);
+    for (size_t i = 0; i < m_playerCount; ++i) {
+        if (changed & (1u << i)) {
+            WriteVarint(inputs[i] ^ m_current[i]);
+            m_current[i] = inputs[i];
+        }
+    }
+    m_run = 1;
+}
+
+void ReplayWriter::Finish(std::optional<uint64_t> finalStateHash) {
+    if (!m_open) {
+        return;
+    }
+
+    if (m_run > 0) {
+        WriteVarint(m_run);
+    }
+
+    // A record of zero frames ends the inputs
+    WriteByte(0);
+    WriteVarint(0);
+
+    WriteVarint(m_frameCount);
+    WriteByte(finalStateHash.has_value() ? HAS_FINAL_HASH : 0);
+    if (finalStateHash.has_value()) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            WriteByte(static_cast<uint8_t>(*finalStateHash >> shift));
+        }
+    }
+
+    m_out.flush();
+    m_open = false;
+}
+
+void ReplayWriter::WriteByte(uint8_t value) {
+    m_out.put(static_cast<char>(value));
+    m_bytesWritten++;
+}
+
+void ReplayWriter::WriteVarint(uint32_t value) {
+    while (value >= 0x80) {
+        WriteByte(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    WriteByte(static_cast<uint8_t>(value));
+}
+
+// ReplayReader
+
+ReplayReader::ReplayReader(std::istream& in)
+    : m_in(in)
+    , m_current{}
+    , m_runLeft(0)
+    , m_framesRead(0)
+    , m_frameCount(0)
+    , m_open(false)
+    , m_complete(false) {
+}
+
+bool ReplayReader::Open() {
+    for (uint8_t expected : MAGIC) {
+        uint8_t byte;
+        if (!ReadByte(byte) || byte != expected) {
+            return false;
+        }
+    }
+
+    uint8_t version;
+    if (!ReadByte(version) || version != FORMAT_VERSION) {
+        return false;
+    }
+
+    ReplayHeader header;
+    uint8_t seedBytes[4];
+    if (!ReadVarint(header.matchId) || !ReadByte(header.gameMode) || !ReadByte(header.stageId) ||
+        !ReadByte(seedBytes[0]) || !ReadByte(seedBytes[1]) || !ReadByte(seedBytes[2]) || !ReadByte(seedBytes[3]) ||
+        !ReadVarint(header.startFrame) || !ReadByte(header.playerCount)) {
+        return false;
+    }
+    if (header.playerCount == 0 || header.playerCount > ReplayHeader::MAX_PLAYERS) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        header.randomSeed |= static_cast<uint32_t>(seedBytes[i]) << (i * 8);
+    }
+    for (uint8_t i = 0; i < header.playerCount; ++i) {
+        if (!ReadVarint(header.playerIds[i])) {
+            return false;
+        }
+    }
+
+    m_header = header;
+    std::fill(std::begin(m_current), std::end(m_current), 0u);
+    m_runLeft = 0;
+    m_framesRead = 0;
+    m_open = true;
+    m_complete = false;
+    return true;
+}
+
+bool ReplayReader::NextFrame(uint32_t* inputs) {
+    if (!m_open) {
+        return false;
+    }
+    if (m_runLeft == 0 && !ReadRecord()) {
+        m_open = false;
+        return false;
+    }
+
+    m_runLeft--;
+    m_framesRead++;
+    std::copy(m_current, m_current + m_header.playerCount, inputs);
+    return true;
+}
+
+bool ReplayReader::ReadRecord() {
+    uint8_t changed;
+    if (!ReadByte(changed)) {
+        return false;
+    }
+
+    uint32_t deltas[ReplayHeader::MAX_PLAYERS] = {};
+    for (uint8_t i = 0; i < m_header.playerCount; ++i) {
+        if ((changed & (1u << i)) && !ReadVarint(deltas[i])) {
+            return false;
+        }
+    }
+
+    uint32_t run;
+    if (!ReadVarint(run)) {
+        return false;
+    }
+
+    if (run == 0) {
+        uint8_t flags;
+        uint32_t frameCount;
+        if (!ReadVarint(frameCount) || !ReadByte(flags)) {
+            return false;
+        }
+        if (flags & HAS_FINAL_HASH) {
+            uint64_t hash = 0;
+            for (int shift = 0; shift < 64; shift += 8) {
+                uint8_t byte;
+                if (!ReadByte(byte)) {
+                    return false;
+                }
+                hash |= static_cast<uint64_t>(byte) << shift;
+            }
+            m_finalStateHash = hash;
+        }
+        m_frameCount = frameCount;
+        m_complete = frameCount == m_framesRead;
+        return false;
+    }
+
+    for (uint8_t i = 0; i < m_header.playerCount; ++i) {
+        m_current[i] ^= deltas[i];
+    }
+    m_runLeft = run;
+    return true;
+}
+
+bool ReplayReader::ReadByte(uint8_t& value) {
+    int c = m_in.get();
+    if (c == std::char_traits<char>::eof()) {
+        return false;
+    }
+    value = static_cast<uint8_t>(c);
+    return true;
+}
+
+bool ReplayReader::ReadVarint(uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte;
+        if (!ReadByte(byte)) return false;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Playback
+
+uint64_t HashSimulationState(const RollbackSimulation& simulation) {
+    std::vector<uint8_t> state(RollbackEngine::MAX_STATE_SIZE);
+    size_t size = simulation.SaveState(state.data(), state.size());
+    return DesyncDetector::HashState(state.data(), size);
+}
+
+ReplayResult PlayReplay(ReplayReader& reader, RollbackSimulation& simulation) {
+    ReplayResult result;
+    const ReplayHeader& header = reader.GetHeader();
+
+    // As NetworkManager does when the match starts
+    SeedSimulationRandom(header.randomSeed);
+
+    uint32_t inputs[ReplayHeader::MAX_PLAYERS];
+    while (reader.NextFrame(inputs)) {
+        simulation.AdvanceFrame(inputs, header.playerCount);
+        result.frames++;
+    }
+
+    result.complete = reader.IsComplete();
+    result.finalStateHash = HashSimulationState(simulation);
+    result.verified = result.complete && reader.GetFinalStateHash().has_value() &&
+                      *reader.GetFinalStateHash() == result.finalStateHash;
+    return result;
+}
+
+} // namespace ArenaFighter
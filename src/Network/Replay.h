@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include "RollbackEngine.h"
+
+namespace ArenaFighter {
+
+class MatchStartPacket;
+
+// Everything besides the inputs needed to play a match again: the
+// MatchStartPacket settings and the frame the simulation started on.
+// playerIds is in simulation slot order.
+struct ReplayHeader {
+    static constexpr size_t MAX_PLAYERS = RollbackEngine::MAX_PLAYERS;
+
+    uint32_t matchId = 0;
+    uint8_t gameMode = 0;
+    uint8_t stageId = 0;
+    uint32_t randomSeed = 0;
+    uint32_t startFrame = 1;
+    uint8_t playerCount = 0;
+    uint32_t playerIds[MAX_PLAYERS] = {};
+
+    static ReplayHeader FromMatchStart(const MatchStartPacket& packet, uint32_t startFrame = 1);
+};
+
+// Append-only replay stream: the header, then the confirmed input masks
+// of every frame, run-length encoded. Each record holds the players whose
+// input changed, their XOR deltas as varints, and how many frames the new
+// inputs were held. Held inputs cost nothing per frame, so a 99 second
+// round of normal play is a few kilobytes.
+//
+// Bytes go out as soon as a record is known, so a crash loses at most the
+// current run. Finish() ends the stream with the frame count and,
+// optionally, a hash of the final state for PlayReplay() to check.
+class ReplayWriter {
+public:
+    explicit ReplayWriter(std::ostream& out);
+
+    bool Begin(const ReplayHeader& header);
+
+    // The next frame's inputs, one mask per player slot
+    void AddFrame(const uint32_t* inputs);
+
+    void Finish(std::optional<uint64_t> finalStateHash = std::nullopt);
+
+    uint32_t GetFrameCount() const { return m_frameCount; }
+    size_t GetBytesWritten() const { return m_bytesWritten; }
+    bool IsOpen() const { return m_open; }
+
+private:
+    void WriteByte(uint8_t value);
+    void WriteVarint(uint32_t value);
+
+    std::ostream& m_out;
+    size_t m_playerCount;
+    uint32_t m_current[ReplayHeader::MAX_PLAYERS];
+    uint32_t m_run;           // Frames the current inputs have been held, not written yet
+    uint32_t m_frameCount;
+    size_t m_bytesWritten;
+    bool m_open;
+};
+
+class ReplayReader {
+public:
+    explicit ReplayReader(std::istream& in);
+
+    // Reads and checks the header
+    bool Open();
+    const ReplayHeader& GetHeader() const { return m_header; }
+
+    // The next frame's inputs, one mask per player slot. False at the end
+    // of the stream or where it was cut off.
+    bool NextFrame(uint32_t* inputs);
+
+    // Set once the end record has been read
+    bool IsComplete() const { return m_complete; }
+    uint32_t GetFrameCount() const { return m_frameCount; }
+    const std::optional<uint64_t>& GetFinalStateHash() const { return m_finalStateHash; }
+
+private:
+    bool ReadByte(uint8_t& value);
+    bool ReadVarint(uint32_t& value);
+    bool ReadRecord();
+
+    std::istream& m_in;
+    ReplayHeader m_header;
+    uint32_t m_current[ReplayHeader::MAX_PLAYERS];
+    uint32_t m_runLeft;
+    uint32_t m_framesRead;
+    uint32_t m_frameCount;
+    std::optional<uint64_t> m_finalStateHash;
+    bool m_open;
+    bool m_complete;
+};
+
+struct ReplayResult {
+    uint32_t frames = 0;
+    bool complete = false;      // The stream ended properly
+    bool verified = false;      // The final state hashed as recorded
+    uint64_t finalStateHash = 0;
+};
+
+// Seeds the simulation random generator from the header and steps
+// simulation through every recorded frame. simulation must be fresh, as
+// at the start of the recorded match.
+ReplayResult PlayReplay(ReplayReader& reader, RollbackSimulation& simulation);
+
+// Hash of the simulation's saved state, as recorded by Finish()
+uint64_t HashSimulationState(const RollbackSimulation& simulation);
+
+} // namespace ArenaFighter
@@ -0,0 +1,244 @@
+#include "RollbackEngine.h"
+#include "InputBuffer.h"
+#include "Replay.h"
+#include "SpectatorRelay.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+RollbackEngine::RollbackEngine(RollbackSimulation& simulation)
+    : m_simulation(simulation)
+    , m_storage(RING_SIZE * MAX_STATE_SIZE)
+    , m_inputs{}
+    , m_currentFrame(0)
+    , m_desyncDetector(nullptr)
+    , m_nextCheckFrame(0)
+    , m_replayWriter(nullptr)
+    , m_nextReplayFrame(0)
+    , m_spectatorRelay(nullptr)
+    , m_nextRelayFrame(0) {
+    
+    m_players.reserve(MAX_PLAYERS);
+}
+
+bool RollbackEngine::AddPlayer(InputBuffer* buffer) {
+    if (!buffer || m_players.size() >= MAX_PLAYERS) {
+        return false;
+    }
+    
+    m_players.push_back(buffer);
+    return true;
+}
+
+void RollbackEngine::ClearPlayers() {
+    m_players.clear();
+}
+
+void RollbackEngine::Reset(uint32_t frame) {
+    m_currentFrame = frame;
+    m_stats = RollbackStats{};
+    m_nextCheckFrame = GetFirstCheckFrame(frame);
+    m_nextReplayFrame = frame;
+    m_nextRelayFrame = frame;
+    
+    for (auto& snapshot : m_snapshots) {
+        snapshot = Snapshot{};
+    }
+    
+    for (InputBuffer* buffer : m_players) {
+        buffer->ClearMisprediction();
+    }
+}
+
+bool RollbackEngine::AdvanceFrame() {
+    // Find the earliest frame simulated with a wrong guess
+    bool mispredicted = false;
+    uint32_t rollbackFrame = m_currentFrame;
+    
+    for (InputBuffer* buffer : m_players) {
+        auto frame = buffer->GetMispredictedFrame();
+        if (frame.has_value() && *frame < rollbackFrame) {
+            rollbackFrame = *frame;
+            mispredicted = true;
+        }
+        buffer->ClearMisprediction();
+    }
+    
+    if (mispredicted && !Rollback(rollbackFrame)) {
+        m_stats.missedRollbacks++;
+    }
+    
+    if (!SaveSnapshot(m_currentFrame)) {
+        return false;
+    }
+    
+    GatherInputs(m_currentFrame);
+    m_simulation.AdvanceFrame(m_inputs, m_players.size());
+    m_currentFrame++;
+    
+    HashConfirmedSnapshots();
+    RecordConfirmedInputs();
+    return true;
+}
+
+void RollbackEngine::AttachDesyncDetector(DesyncDetector* detector) {
+    m_desyncDetector = detector;
+    m_nextCheckFrame = GetFirstCheckFrame(m_currentFrame);
+    
+    if (m_desyncDetector) {
+        StateField fields[StateHash::MAX_FIELDS];
+        size_t count = m_simulation.DescribeState(fields, StateHash::MAX_FIELDS);
+        m_desyncDetector->SetStateLayout(fields, count);
+    }
+}
+
+void RollbackEngine::AttachReplayWriter(ReplayWriter* writer) {
+    m_replayWriter = writer;
+    m_nextReplayFrame = m_currentFrame;
+}
+
+void RollbackEngine::AttachSpectatorRelay(SpectatorRelay* relay) {
+    m_spectatorRelay = relay;
+    m_nextRelayFrame = m_currentFrame;
+}
+
+void RollbackEngine::FinishReplay() {
+    if (!m_replayWriter) {
+        return;
+    }
+    
+    // The state after the last recorded frame is either the live one or
+    // the snapshot taken before the first frame left out
+    std::optional<uint64_t> finalStateHash;
+    const Snapshot& snapshot = m_snapshots[m_nextReplayFrame % RING_SIZE];
+    if (m_nextReplayFrame == m_currentFrame) {
+        finalStateHash = HashSimulationState(m_simulation);
+    } else if (snapshot.valid && snapshot.frame == m_nextReplayFrame) {
+        finalStateHash = DesyncDetector::HashState(GetSlotData(m_nextReplayFrame), snapshot.size);
+    }
+    
+    m_replayWriter->Finish(finalStateHash);
+    m_replayWriter = nullptr;
+}
+
+uint32_t RollbackEngine::GetConfirmedFrame() const {
+    uint32_t confirmedFrame = UINT32_MAX;
+    for (const InputBuffer* buffer : m_players) {
+        confirmedFrame = std::min(confirmedFrame, buffer->GetContiguousFrame());
+    }
+    return confirmedFrame;
+}
+
+void RollbackEngine::RecordConfirmedInputs() {
+    if ((!m_replayWriter && !m_spectatorRelay) || m_players.empty()) {
+        return;
+    }
+    
+    // Only frames already simulated, so FinishReplay() has their state
+    uint32_t lastFrame = std::min(GetConfirmedFrame(), m_currentFrame - 1);
+    uint32_t inputs[MAX_PLAYERS];
+    
+    for (; m_replayWriter && m_nextReplayFrame <= lastFrame; ++m_nextReplayFrame) {
+        GetConfirmedInputs(m_nextReplayFrame, inputs);
+        m_replayWriter->AddFrame(inputs);
+    }
+    
+    for (; m_spectatorRelay && m_nextRelayFrame <= lastFrame; ++m_nextRelayFrame) {
+        // The snapshot before a confirmed frame is final. One that already
+        // left the ring is skipped; joiners wait for the next keyframe.
+        const Snapshot& snapshot = m_snapshots[m_nextRelayFrame % RING_SIZE];
+        if (m_spectatorRelay->WantsKeyframe(m_nextRelayFrame) &&
+            snapshot.valid && snapshot.frame == m_nextRelayFrame) {
+            m_spectatorRelay->AddKeyframe(m_nextRelayFrame, GetSlotData(m_nextRelayFrame), snapshot.size);
+        }
+        
+        GetConfirmedInputs(m_nextRelayFrame, inputs);
+        m_spectatorRelay->AddFrame(inputs);
+    }
+}
+
+void RollbackEngine::GetConfirmedInputs(uint32_t frame, uint32_t* inputs) const {
+    for (size_t i = 0; i < m_players.size(); ++i) {
+        inputs[i] = m_players[i]->GetInputMask(frame);
+    }
+}
+
+void RollbackEngine::HashConfirmedSnapshots() {
+    if (!m_desyncDetector || m_players.empty()) {
+        return;
+    }
+    
+    // The snapshot of frame F is the state before F ran, so it is final
+    // once every input up to F - 1 is confirmed. Any rollback those inputs
+    // caused has already rewritten the ring at the top of AdvanceFrame.
+    uint32_t lastFinalFrame = std::min(GetConfirmedFrame() + 1, m_currentFrame - 1);
+    
+    while (m_nextCheckFrame <= lastFinalFrame) {
+        const Snapshot& snapshot = m_snapshots[m_nextCheckFrame % RING_SIZE];
+        if (snapshot.valid && snapshot.frame == m_nextCheckFrame) {
+            m_desyncDetector->RecordLocalState(m_nextCheckFrame, GetSlotData(m_nextCheckFrame), snapshot.size);
+        } else {
+            m_stats.missedStateChecks++;
+        }
+        
+        m_nextCheckFrame += m_desyncDetector->GetInterval();
+    }
+}
+
+uint32_t RollbackEngine::GetFirstCheckFrame(uint32_t frame) const {
+    if (!m_desyncDetector) {
+        return frame;
+    }
+    
+    uint32_t interval = m_desyncDetector->GetInterval();
+    return (frame + interval - 1) / interval * interval;
+}
+
+bool RollbackEngine::SaveSnapshot(uint32_t frame) {
+    Snapshot& snapshot = m_snapshots[frame % RING_SIZE];
+    snapshot.size = m_simulation.SaveState(GetSlotData(frame), MAX_STATE_SIZE);
+    snapshot.frame = frame;
+    snapshot.valid = snapshot.size > 0;
+    return snapshot.valid;
+}
+
+bool RollbackEngine::Rollback(uint32_t toFrame) {
+    const Snapshot& snapshot = m_snapshots[toFrame % RING_SIZE];
+    if (!snapshot.valid || snapshot.frame != toFrame) {
+        return false; // Older than the ring; the state stays as predicted
+    }
+    
+    m_simulation.LoadState(GetSlotData(toFrame), snapshot.size);
+    
+    // Replay up to, but not including, the frame about to be simulated
+    for (uint32_t frame = toFrame; frame < m_currentFrame; ++frame) {
+        if (frame != toFrame) {
+            SaveSnapshot(frame);
+        }
+        
+        GatherInputs(frame);
+        m_simulation.AdvanceFrame(m_inputs, m_players.size());
+    }
+    
+    uint32_t frames = m_currentFrame - toFrame;
+    m_stats.rollbacks++;
+    m_stats.resimulatedFrames += frames;
+    m_stats.lastRollbackFrames = frames;
+    m_stats.maxRollbackFrames = std::max(m_stats.maxRollbackFrames, frames);
+    return true;
+}
+
+void RollbackEngine::GatherInputs(uint32_t frame) {
+    for (size_t i = 0; i < m_players.size(); ++i) {
+        InputBuffer* buffer = m_players[i];
+        
+        // Guess missing inputs; ConfirmInput flags the guess if it was wrong
+        if (!buffer->GetInput(frame).has_value()) {
+            buffer->AddPredictedInput(frame, buffer->PredictInput(frame));
+        }
+        
+        m_inputs[i] = buffer->GetInputMask(frame);
+    }
+}
+
+} // namespace ArenaFighter
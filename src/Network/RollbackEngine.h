@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "NetworkConfig.h"
+#include "DesyncDetector.h"
+
+namespace ArenaFighter {
+
+class InputBuffer;
+class ReplayWriter;
+class SpectatorRelay;
+
+// Game-side hooks driven by RollbackEngine. AdvanceFrame must be
+// deterministic: the same saved state and inputs always produce the
+// same next state, or resimulation diverges between peers. SaveState has
+// to include GetSimulationRandom()'s state, and its output must not depend
+// on padding or pointers, since attached desync detectors hash it.
+class RollbackSimulation {
+public:
+    virtual ~RollbackSimulation() = default;
+    
+    // Write the full game state; return the bytes used, 0 if it did not fit
+    virtual size_t SaveState(uint8_t* buffer, size_t capacity) const = 0;
+    virtual void LoadState(const uint8_t* data, size_t size) = 0;
+    
+    // Step one fixed tick; inputs holds one mask per player slot
+    virtual void AdvanceFrame(const uint32_t* inputs, size_t playerCount) = 0;
+    
+    // Optional: names the parts of the SaveState blob so desync reports
+    // can point at the field that diverged. Returns the fields written.
+    virtual size_t DescribeState(StateField* /*fields*/, size_t /*maxFields*/) const { return 0; }
+};
+
+struct RollbackStats {
+    uint32_t rollbacks = 0;           // Restores performed
+    uint32_t resimulatedFrames = 0;   // Frames stepped again in total
+    uint32_t lastRollbackFrames = 0;
+    uint32_t maxRollbackFrames = 0;
+    uint32_t missedRollbacks = 0;     // Mispredictions older than the ring
+    uint32_t missedStateChecks = 0;   // Checkpoints confirmed only after leaving the ring
+};
+
+// Snapshots the simulation once per frame into a ring covering the last
+// MAX_ROLLBACK_FRAMES frames. Each AdvanceFrame() first checks the input
+// buffers for a contradicted prediction; if one is found it restores the
+// snapshot taken before that frame and replays every frame since with the
+// corrected inputs, then steps the new frame. Snapshot storage is
+// allocated once, so a tick never touches the heap.
+class RollbackEngine {
+public:
+    static constexpr size_t RING_SIZE = NetworkConfig::MAX_ROLLBACK_FRAMES + 1;
+    static constexpr size_t MAX_STATE_SIZE = 16 * 1024;
+    static constexpr size_t MAX_PLAYERS = 8;
+    
+    explicit RollbackEngine(RollbackSimulation& simulation);
+    
+    // Player slots in the order inputs are passed to the simulation
+    bool AddPlayer(InputBuffer* buffer);
+    void ClearPlayers();
+    
+    // Start counting from frame; forgets all snapshots
+    void Reset(uint32_t frame);
+    
+    // Hands each checkpoint snapshot to detector once all of its inputs
+    // are confirmed, along with the simulation's state layout
+    void AttachDesyncDetector(DesyncDetector* detector);
+    
+    // Appends each frame's inputs to writer once every player's input for
+    // it is confirmed, starting with the current frame. The writer must
+    // already have begun its stream.
+    void AttachReplayWriter(ReplayWriter* writer);
+    
+    // Feeds relay each confirmed frame's inputs the same way, along with
+    // the snapshot before every frame it wants a keyframe for. The relay
+    // must already have begun its broadcast.
+    void AttachSpectatorRelay(SpectatorRelay* relay);
+    
+    // Ends the attached replay with a hash of the state after its last
+    // frame and detaches it. Frames still unconfirmed are left out.
+    void FinishReplay();
+    
+    // Roll back if needed, then simulate the current frame. Inputs that
+    // have not arrived are predicted. Returns false if the state did not
+    // fit in a snapshot slot.
+    bool AdvanceFrame();
+    
+    uint32_t GetCurrentFrame() const { return m_currentFrame; }
+    const RollbackStats& GetStats() const { return m_stats; }
+
+private:
+    struct Snapshot {
+        uint32_t frame = 0;
+        size_t size = 0;
+        bool valid = false;
+    };
+    
+    bool SaveSnapshot(uint32_t frame);
+    bool Rollback(uint32_t toFrame);
+    void GatherInputs(uint32_t frame);
+    void HashConfirmedSnapshots();
+    void RecordConfirmedInputs();
+    void GetConfirmedInputs(uint32_t frame, uint32_t* inputs) const;
+    uint32_t GetConfirmedFrame() const;
+    uint32_t GetFirstCheckFrame(uint32_t frame) const;
+    uint8_t* GetSlotData(uint32_t frame) { return m_storage.data() + (frame % RING_SIZE) * MAX_STATE_SIZE; }
+    
+    RollbackSimulation& m_simulation;
+    std::vector<InputBuffer*> m_players;
+    std::vector<uint8_t> m_storage;
+    Snapshot m_snapshots[RING_SIZE];
+    uint32_t m_inputs[MAX_PLAYERS];
+    uint32_t m_currentFrame;
+    RollbackStats m_stats;
+    
+    DesyncDetector* m_desyncDetector;
+    uint32_t m_nextCheckFrame;
+    
+    ReplayWriter* m_replayWriter;
+    uint32_t m_nextReplayFrame;
+    
+    SpectatorRelay* m_spectatorRelay;
+    uint32_t m_nextRelayFrame;
+};
+
+} // namespace ArenaFighter
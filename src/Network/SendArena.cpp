@@ -0,0 +1,52 @@
+#include "SendArena.h"
+#include "NetworkPacket.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+SendArena::SendArena(size_t maxDatagrams, size_t reservedBytes)
+    : m_storage(maxDatagrams * SLOT_SIZE)
+    , m_sizes(maxDatagrams, 0)
+    , m_slotCapacity(SLOT_SIZE - std::min(reservedBytes, SLOT_SIZE))
+    , m_datagramCount(0)
+    , m_packetCount(0)
+    , m_bytesUsed(0) {
+}
+
+void SendArena::Reset() {
+    m_datagramCount = 0;
+    m_packetCount = 0;
+    m_bytesUsed = 0;
+}
+
+size_t SendArena::Write(const NetworkPacket& packet) {
+    // Coalesce into the open datagram while there is room
+    if (m_datagramCount > 0) {
+        size_t open = m_datagramCount - 1;
+        size_t used = m_sizes[open];
+        
+        size_t written = packet.Serialize(GetDatagramData(open) + used, m_slotCapacity - used);
+        if (written > 0) {
+            m_sizes[open] = static_cast<uint16_t>(used + written);
+            m_packetCount++;
+            m_bytesUsed += written;
+            return written;
+        }
+    }
+    
+    if (IsFull()) {
+        return 0;
+    }
+    
+    size_t written = packet.Serialize(GetDatagramData(m_datagramCount), m_slotCapacity);
+    if (written == 0) {
+        return 0;
+    }
+    
+    m_sizes[m_datagramCount++] = static_cast<uint16_t>(written);
+    m_packetCount++;
+    m_bytesUsed += written;
+    return written;
+}
+
+} // namespace ArenaFighter
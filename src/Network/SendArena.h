@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "NetworkConfig.h"
+
+namespace ArenaFighter {
+
+class NetworkPacket;
+
+// Fixed-capacity arena of datagram-sized slots for one send tick.
+// Packets are coalesced back to back into the open slot until it reaches
+// its capacity, then the next slot is opened. Storage is allocated once at
+// construction; Reset() rewinds it so the send path never touches the heap.
+class SendArena {
+public:
+    static constexpr size_t SLOT_SIZE = NetworkConfig::PACKET_SIZE_LIMIT;
+    
+    // reservedBytes are kept free at the end of every datagram, e.g. for a
+    // per-peer ack trailer appended at send time
+    explicit SendArena(size_t maxDatagrams = NetworkConfig::MAX_DATAGRAMS_PER_SEND, size_t reservedBytes = 0);
+    
+    // Rewind to empty; call once per send tick
+    void Reset();
+    
+    // Appends the packet to the open datagram, or to a fresh one if it does
+    // not fit. Returns the bytes written, or 0 if no slot has room left
+    // (IsFull) or the packet alone exceeds GetSlotCapacity().
+    size_t Write(const NetworkPacket& packet);
+    
+    // Datagram access
+    size_t GetDatagramCount() const { return m_datagramCount; }
+    uint8_t* GetDatagramData(size_t index) { return m_storage.data() + index * SLOT_SIZE; }
+    const uint8_t* GetDatagramData(size_t index) const { return m_storage.data() + index * SLOT_SIZE; }
+    size_t GetDatagramSize(size_t index) const { return m_sizes[index]; }
+    
+    // Stats
+    size_t GetSlotCapacity() const { return m_slotCapacity; }
+    size_t GetCapacity() const { return m_sizes.size(); }
+    size_t GetBytesUsed() const { return m_bytesUsed; }
+    size_t GetPacketCount() const { return m_packetCount; }
+    bool IsFull() const { return m_datagramCount == m_sizes.size(); }
+
+private:
+    std::vector<uint8_t> m_storage;
+    std::vector<uint16_t> m_sizes;
+    size_t m_slotCapacity;
+    size_t m_datagramCount;
+    size_t m_packetCount;
+    size_t m_bytesUsed;
+};
+
+} // namespace ArenaFighter
@@ -0,0 +1,602 @@
+#include "SpectatorRelay.h"
+#include "RollbackEngine.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+namespace {
+
+// Datagram kinds; every datagram starts with its kind and the match id
+constexpr uint8_t KEYFRAME_CHUNK = 1;
+constexpr uint8_t INPUT_BLOCK = 2;
+constexpr uint8_t STREAM_END = 3;
+
+// Kind, match id, frame, player count, state size, compressed size, offset
+constexpr size_t KEYFRAME_HEADER_SIZE = 1 + 4 + 4 + 1 + 4 + 4 + 4;
+constexpr size_t KEYFRAME_CHUNK_SIZE = NetworkConfig::PACKET_SIZE_LIMIT - KEYFRAME_HEADER_SIZE;
+
+// Kind, match id, first frame, frame count, player count
+constexpr size_t BLOCK_HEADER_SIZE = 1 + 4 + 4 + 2 + 1;
+
+void PutU8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+void PutU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PutVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Bounds-checked reads; once one fails, every later one fails too
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_pos(0), m_ok(true) {}
+
+    uint8_t U8() {
+        if (!m_ok || m_pos >= m_size) {
+            m_ok = false;
+            return 0;
+        }
+        return m_data[m_pos++];
+    }
+
+    uint16_t U16() {
+        uint16_t value = U8();
+        return static_cast<uint16_t>(value | (U8() << 8));
+    }
+
+    uint32_t U32() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            value |= static_cast<uint32_t>(U8()) << shift;
+        }
+        return value;
+    }
+
+    uint32_t Varint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = U8();
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        m_ok = false;
+        return 0;
+    }
+
+    const uint8_t* Rest() const { return m_data + m_pos; }
+    size_t Remaining() const { return m_ok ? m_size - m_pos : 0; }
+    bool IsOk() const { return m_ok; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos;
+    bool m_ok;
+};
+
+// Saved states are mostly zero padding, empty slots and cleared flags:
+// each run of zeros becomes a zero byte and the run length
+void CompressZeroRuns(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    for (size_t i = 0; i < size;) {
+        if (data[i] != 0) {
+            out.push_back(data[i++]);
+            continue;
+        }
+
+        size_t run = 1;
+        while (i + run < size && data[i + run] == 0) {
+            run++;
+        }
+        out.push_back(0);
+        PutVarint(out, static_cast<uint32_t>(run));
+        i += run;
+    }
+}
+
+bool DecompressZeroRuns(const std::vector<uint8_t>& data, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(size);
+
+    ByteReader reader(data.data(), data.size());
+    while (reader.Remaining() > 0 && out.size() <= size) {
+        uint8_t byte = reader.U8();
+        if (byte != 0) {
+            out.push_back(byte);
+        } else {
+            out.insert(out.end(), std::min<size_t>(reader.Varint(), size + 1 - out.size()), 0);
+        }
+    }
+    return reader.IsOk() && out.size() == size;
+}
+
+} // namespace
+
+// SpectatorRelay
+
+SpectatorRelay::SpectatorRelay(const SpectatorConfig& config)
+    : m_config(config)
+    , m_started(false)
+    , m_finished(false)
+    , m_nextFrame(0)
+    , m_clockFrame(0)
+    , m_current{}
+    , m_run(0) {
+
+    // Keyframes have to start a block, or joiners could not begin there
+    m_config.framesPerBlock = std::clamp(m_config.framesPerBlock, 1u, 0xFFFFu);
+    uint32_t blocks = std::max(1u, (m_config.keyframeInterval + m_config.framesPerBlock - 1) / m_config.framesPerBlock);
+    m_config.keyframeInterval = blocks * m_config.framesPerBlock;
+}
+
+bool SpectatorRelay::Begin(const ReplayHeader& header) {
+    if (header.playerCount == 0 || header.playerCount > ReplayHeader::MAX_PLAYERS) {
+        return false;
+    }
+
+    m_header = header;
+    m_started = true;
+    m_finished = false;
+    m_nextFrame = header.startFrame;
+    m_clockFrame = header.startFrame - 1;
+    m_blocks.clear();
+    m_keyframes.clear();
+    m_end.clear();
+    StartBlock();
+
+    for (Spectator& spectator : m_spectators) {
+        spectator.synced = false;
+    }
+    return true;
+}
+
+bool SpectatorRelay::WantsKeyframe(uint32_t frame) const {
+    return m_started && frame >= m_header.startFrame &&
+           (frame - m_header.startFrame) % m_config.keyframeInterval == 0;
+}
+
+void SpectatorRelay::AddKeyframe(uint32_t frame, const uint8_t* state, size_t size) {
+    if (!m_started || m_finished || frame != m_nextFrame || !WantsKeyframe(frame)) {
+        return;
+    }
+
+    std::vector<uint8_t> compressed;
+    CompressZeroRuns(state, size, compressed);
+
+    Keyframe keyframe;
+    keyframe.frame = frame;
+    size_t offset = 0;
+    do {
+        size_t length = std::min(KEYFRAME_CHUNK_SIZE, compressed.size() - offset);
+        std::vector<uint8_t> chunk;
+        chunk.reserve(KEYFRAME_HEADER_SIZE + length);
+        PutU8(chunk, KEYFRAME_CHUNK);
+        PutU32(chunk, m_header.matchId);
+        PutU32(chunk, frame);
+        PutU8(chunk, m_header.playerCount);
+        PutU32(chunk, static_cast<uint32_t>(size));
+        PutU32(chunk, static_cast<uint32_t>(compressed.size()));
+        PutU32(chunk, static_cast<uint32_t>(offset));
+        chunk.insert(chunk.end(), compressed.begin() + offset, compressed.begin() + offset + length);
+
+        m_stats.bytesEncoded += chunk.size();
+        keyframe.chunks.push_back(std::move(chunk));
+        offset += length;
+    } while (offset < compressed.size());
+
+    m_keyframes.push_back(std::move(keyframe));
+    m_stats.keyframesEncoded++;
+}
+
+void SpectatorRelay::AddFrame(const uint32_t* inputs) {
+    if (!m_started || m_finished) {
+        return;
+    }
+
+    // Records as in ReplayWriter, but every block starts from zero inputs
+    // so it decodes on its own
+    uint8_t changed = 0;
+    for (size_t i = 0; i < m_header.playerCount; ++i) {
+        changed |= inputs[i] != m_current[i] ? static_cast<uint8_t>(1u << i) : 0;
+    }
+
+    if (changed == 0 && m_run > 0) {
+        m_run++;
+    } else {
+        if (m_run > 0) {
+            PutVarint(m_open.data, m_run);
+        }
+        PutU8(m_open.data, changed);
+        for (size_t i = 0; i < m_header.playerCount; ++i) {
+            if (changed & (1u << i)) {
+                PutVarint(m_open.data, inputs[i] ^ m_current[i]);
+                m_current[i] = inputs[i];
+            }
+        }
+        m_run = 1;
+    }
+
+    m_open.frameCount++;
+    m_clockFrame = m_nextFrame++;
+    if (m_open.frameCount == m_config.framesPerBlock) {
+        SealBlock();
+    }
+}
+
+void SpectatorRelay::Finish() {
+    if (!m_started || m_finished) {
+        return;
+    }
+
+    SealBlock();
+    PutU8(m_end, STREAM_END);
+    PutU32(m_end, m_header.matchId);
+    PutU32(m_end, m_nextFrame);
+    m_finished = true;
+}
+
+void SpectatorRelay::StartBlock() {
+    m_open = Block();
+    m_open.firstFrame = m_nextFrame;
+    std::fill(std::begin(m_current), std::end(m_current), 0u);
+    m_run = 0;
+}
+
+void SpectatorRelay::SealBlock() {
+    if (m_open.frameCount == 0) {
+        return;
+    }
+    PutVarint(m_open.data, m_run);
+
+    Block block;
+    block.firstFrame = m_open.firstFrame;
+    block.frameCount = m_open.frameCount;
+    block.data.reserve(BLOCK_HEADER_SIZE + m_open.data.size());
+    PutU8(block.data, INPUT_BLOCK);
+    PutU32(block.data, m_header.matchId);
+    PutU32(block.data, block.firstFrame);
+    PutU16(block.data, static_cast<uint16_t>(block.frameCount));
+    PutU8(block.data, m_header.playerCount);
+    block.data.insert(block.data.end(), m_open.data.begin(), m_open.data.end());
+
+    m_stats.blocksEncoded++;
+    m_stats.bytesEncoded += block.data.size();
+    m_blocks.push_back(std::move(block));
+    StartBlock();
+}
+
+uint32_t SpectatorRelay::GetReleasedFrame() const {
+    int64_t released = static_cast<int64_t>(m_clockFrame) - m_config.delayFrames;
+    int64_t newest = static_cast<int64_t>(m_nextFrame) - 1;
+    return static_cast<uint32_t>(std::max<int64_t>(std::min(released, newest), m_header.startFrame - 1));
+}
+
+void SpectatorRelay::Prune() {
+    // Joiners start from the newest released keyframe, so older ones are
+    // no longer needed, nor are the blocks before it that every caught up
+    // spectator already has
+    uint32_t released = GetReleasedFrame();
+    while (m_keyframes.size() > 1 && m_keyframes[1].frame <= released + 1) {
+        m_keyframes.pop_front();
+    }
+    if (m_keyframes.empty()) {
+        return;
+    }
+
+    uint32_t oldestNeeded = m_keyframes.front().frame;
+    for (const Spectator& spectator : m_spectators) {
+        if (spectator.synced) {
+            oldestNeeded = std::min(oldestNeeded, spectator.nextFrame);
+        }
+    }
+    while (!m_blocks.empty() && m_blocks.front().firstFrame + m_blocks.front().frameCount <= oldestNeeded) {
+        m_blocks.pop_front();
+    }
+}
+
+void SpectatorRelay::AddSpectator(uint32_t spectatorId, const UdpEndpoint& endpoint) {
+    for (Spectator& spectator : m_spectators) {
+        if (spectator.id == spectatorId) {
+            spectator.endpoint = endpoint;
+            spectator.synced = false;
+            return;
+        }
+    }
+    m_spectators.push_back(Spectator{ spectatorId, endpoint, 0, false, false });
+}
+
+void SpectatorRelay::RemoveSpectator(uint32_t spectatorId) {
+    m_spectators.erase(
+        std::remove_if(m_spectators.begin(), m_spectators.end(),
+            [spectatorId](const Spectator& spectator) { return spectator.id == spectatorId; }),
+        m_spectators.end());
+}
+
+void SpectatorRelay::Resync(uint32_t spectatorId) {
+    for (Spectator& spectator : m_spectators) {
+        if (spectator.id == spectatorId) {
+            spectator.synced = false;
+        }
+    }
+}
+
+const std::vector<UdpDatagram>& SpectatorRelay::CollectDatagrams() {
+    m_datagrams.clear();
+    if (!m_started) {
+        return m_datagrams;
+    }
+
+    // After the last frame the delay still runs out one tick at a time
+    if (m_finished) {
+        m_clockFrame++;
+    }
+    Prune();
+
+    uint32_t released = GetReleasedFrame();
+    const Keyframe* newestKeyframe = nullptr;
+    for (const Keyframe& keyframe : m_keyframes) {
+        if (keyframe.frame <= released + 1) {
+            newestKeyframe = &keyframe;
+        }
+    }
+
+    for (Spectator& spectator : m_spectators) {
+        if (spectator.synced && !m_blocks.empty() && spectator.nextFrame < m_blocks.front().firstFrame) {
+            spectator.synced = false;
+        }
+        if (!spectator.synced) {
+            if (!newestKeyframe) {
+                continue;
+            }
+            for (const std::vector<uint8_t>& chunk : newestKeyframe->chunks) {
+                Queue(spectator, chunk);
+            }
+            spectator.nextFrame = newestKeyframe->frame;
+            spectator.synced = true;
+            spectator.ended = false;
+            m_stats.catchUps++;
+        }
+
+        // Blocks are all framesPerBlock long but the last, so the next one
+        // is found by index
+        while (!m_blocks.empty() && spectator.nextFrame >= m_blocks.front().firstFrame) {
+            size_t index = (spectator.nextFrame - m_blocks.front().firstFrame) / m_config.framesPerBlock;
+            if (index >= m_blocks.size()) {
+                break;
+            }
+            const Block& block = m_blocks[index];
+            if (block.firstFrame + block.frameCount - 1 > released) {
+                break;
+            }
+            Queue(spectator, block.data);
+            spectator.nextFrame = block.firstFrame + block.frameCount;
+        }
+
+        if (m_finished && !spectator.ended && spectator.nextFrame == m_nextFrame) {
+            Queue(spectator, m_end);
+            spectator.ended = true;
+        }
+    }
+    return m_datagrams;
+}
+
+size_t SpectatorRelay::Send(UdpSocket& socket) {
+    const std::vector<UdpDatagram>& datagrams = CollectDatagrams();
+
+    size_t sent = 0;
+    for (size_t i = 0; i < datagrams.size(); i += UdpSocket::MAX_BATCH) {
+        sent += socket.SendBatch(datagrams.data() + i, std::min(UdpSocket::MAX_BATCH, datagrams.size() - i));
+    }
+    return sent;
+}
+
+void SpectatorRelay::Queue(const Spectator& spectator, const std::vector<uint8_t>& data) {
+    UdpDatagram datagram;
+    datagram.endpoint = spectator.endpoint;
+    datagram.data = data.data();
+    datagram.size = data.size();
+    m_datagrams.push_back(datagram);
+
+    m_stats.datagramsQueued++;
+    m_stats.bytesQueued += data.size();
+}
+
+// SpectatorFeed
+
+SpectatorFeed::SpectatorFeed()
+    : m_matchId(0)
+    , m_playerCount(0)
+    , m_needsResync(false)
+    , m_keyframeFrame(0)
+    , m_stateSize(0)
+    , m_compressedSize(0)
+    , m_keyframeReady(false)
+    , m_streaming(false)
+    , m_playing(false)
+    , m_playFrame(0)
+    , m_receivedFrame(0)
+    , m_endFrame(0) {
+}
+
+bool SpectatorFeed::Receive(const uint8_t* data, size_t size) {
+    if (size < 5) {
+        return false;
+    }
+
+    switch (data[0]) {
+        case KEYFRAME_CHUNK:
+            return ReceiveKeyframe(data, size);
+        case INPUT_BLOCK:
+            return ReceiveBlock(data, size);
+        case STREAM_END: {
+            ByteReader reader(data + 1, size - 1);
+            uint32_t matchId = reader.U32();
+            uint32_t endFrame = reader.U32();
+            if (!reader.IsOk() || !m_streaming || matchId != m_matchId) {
+                return false;
+            }
+            m_endFrame = endFrame;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool SpectatorFeed::ReceiveKeyframe(const uint8_t* data, size_t size) {
+    ByteReader reader(data + 1, size - 1);
+    uint32_t matchId = reader.U32();
+    uint32_t frame = reader.U32();
+    uint8_t playerCount = reader.U8();
+    uint32_t stateSize = reader.U32();
+    uint32_t compressedSize = reader.U32();
+    uint32_t offset = reader.U32();
+    if (!reader.IsOk() || playerCount == 0 || playerCount > ReplayHeader::MAX_PLAYERS ||
+        stateSize > RollbackEngine::MAX_STATE_SIZE || compressedSize < reader.Remaining()) {
+        return false;
+    }
+
+    // The relay sends a keyframe's chunks back to back, starting over with
+    // the first one on every resync
+    if (offset == 0) {
+        m_keyframeFrame = frame;
+        m_stateSize = stateSize;
+        m_compressedSize = compressedSize;
+        m_compressed.clear();
+        m_streaming = false;
+    } else if (frame != m_keyframeFrame || offset != m_compressed.size() || m_streaming) {
+        m_needsResync = true;
+        return false;
+    }
+
+    m_compressed.insert(m_compressed.end(), reader.Rest(), reader.Rest() + reader.Remaining());
+    if (m_compressed.size() < m_compressedSize) {
+        return true;
+    }
+
+    if (m_compressed.size() != m_compressedSize || !DecompressZeroRuns(m_compressed, m_stateSize, m_keyframe)) {
+        m_needsResync = true;
+        return false;
+    }
+
+    m_matchId = matchId;
+    m_playerCount = playerCount;
+    m_keyframeReady = true;
+    m_streaming = true;
+    m_needsResync = false;
+    m_receivedFrame = frame;
+    m_inputs.clear();
+    m_endFrame = 0;
+    return true;
+}
+
+bool SpectatorFeed::ReceiveBlock(const uint8_t* data, size_t size) {
+    ByteReader reader(data + 1, size - 1);
+    uint32_t matchId = reader.U32();
+    uint32_t firstFrame = reader.U32();
+    uint16_t frameCount = reader.U16();
+    uint8_t playerCount = reader.U8();
+    if (!reader.IsOk() || frameCount == 0) {
+        return false;
+    }
+
+    // Every catch-up starts with a keyframe, so a block without one means
+    // its chunks were lost
+    if (!m_streaming || matchId != m_matchId || playerCount != m_playerCount) {
+        m_needsResync = true;
+        return false;
+    }
+    if (firstFrame + frameCount <= m_receivedFrame) {
+        return true;   // Already have it
+    }
+    if (firstFrame != m_receivedFrame) {
+        m_needsResync = true;
+        return false;
+    }
+
+    uint32_t current[ReplayHeader::MAX_PLAYERS] = {};
+    std::vector<uint32_t> frames;
+    frames.reserve(static_cast<size_t>(frameCount) * playerCount);
+    uint32_t decoded = 0;
+    while (decoded < frameCount) {
+        uint8_t changed = reader.U8();
+        for (uint8_t i = 0; i < playerCount; ++i) {
+            if (changed & (1u << i)) {
+                current[i] ^= reader.Varint();
+            }
+        }
+        uint32_t run = reader.Varint();
+        if (!reader.IsOk() || run == 0 || run > frameCount - decoded) {
+            m_needsResync = true;
+            return false;
+        }
+
+        for (uint32_t r = 0; r < run; ++r) {
+            frames.insert(frames.end(), current, current + playerCount);
+        }
+        decoded += run;
+    }
+
+    m_inputs.insert(m_inputs.end(), frames.begin(), frames.end());
+    m_receivedFrame += frameCount;
+    return true;
+}
+
+bool SpectatorFeed::LoadKeyframe(RollbackSimulation& simulation) {
+    if (!m_keyframeReady) {
+        return false;
+    }
+
+    simulation.LoadState(m_keyframe.data(), m_keyframe.size());
+    m_keyframeReady = false;
+    m_playing = true;
+    m_playFrame = m_keyframeFrame;
+    return true;
+}
+
+bool SpectatorFeed::NextFrame(uint32_t* inputs) {
+    // Frames after a keyframe that is not loaded yet do not follow on
+    // from the simulation's state
+    if (!m_playing || m_keyframeReady || m_inputs.empty()) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < m_playerCount; ++i) {
+        inputs[i] = m_inputs.front();
+        m_inputs.pop_front();
+    }
+    m_playFrame++;
+    return true;
+}
+
+uint32_t SpectatorFeed::CatchUp(RollbackSimulation& simulation) {
+    LoadKeyframe(simulation);
+
+    uint32_t frames = 0;
+    uint32_t inputs[ReplayHeader::MAX_PLAYERS];
+    while (NextFrame(inputs)) {
+        simulation.AdvanceFrame(inputs, m_playerCount);
+        frames++;
+    }
+    return frames;
+}
+
+bool SpectatorFeed::IsFinished() const {
+    return m_endFrame != 0 && m_playing && !m_keyframeReady && m_playFrame == m_endFrame;
+}
+
+} // namespace ArenaFighter
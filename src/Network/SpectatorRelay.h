@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "NetworkConfig.h"
+#include "Replay.h"
+#include "UdpSocket.h"
+
+namespace ArenaFighter {
+
+class RollbackSimulation;
+
+struct SpectatorConfig {
+    // Spectators see each frame this long after it was confirmed, so
+    // nobody can watch the broadcast to read an opponent's inputs
+    uint32_t delayFrames = 3 * NetworkConfig::TICK_RATE;
+
+    // Confirmed frames per inputs datagram
+    uint32_t framesPerBlock = 6;
+
+    // Frames between state snapshots late joiners start from; a multiple
+    // of framesPerBlock
+    uint32_t keyframeInterval = 5 * NetworkConfig::TICK_RATE;
+};
+
+struct SpectatorRelayStats {
+    uint32_t blocksEncoded = 0;
+    uint32_t keyframesEncoded = 0;
+    size_t bytesEncoded = 0;        // Once per block or keyframe, however many watch
+    uint64_t datagramsQueued = 0;   // One per spectator per block or chunk
+    uint64_t bytesQueued = 0;
+    uint32_t catchUps = 0;          // Joins and resyncs served from a keyframe
+};
+
+// Broadcasts one match to any number of spectators. The confirmed input
+// stream comes in once, frame by frame, and is cut into blocks that are
+// encoded once, run-length encoded as in a replay, and held back by
+// delayFrames. Every keyframeInterval frames a zero-run compressed state
+// snapshot is kept as well. A spectator that joins late, or lost a
+// datagram, gets the newest released keyframe and then every block since.
+//
+// All spectators receive the same encoded bytes: the datagrams returned
+// by CollectDatagrams() differ only in their endpoint, and SendBatch()
+// hands them to the kernel MAX_BATCH at a time, so a crowd costs the
+// server little more than a single viewer.
+class SpectatorRelay {
+public:
+    explicit SpectatorRelay(const SpectatorConfig& config = SpectatorConfig());
+
+    // Starts a new broadcast; spectators stay and are caught up again
+    bool Begin(const ReplayHeader& header);
+
+    // Whether frame should get a keyframe, passed before its inputs
+    bool WantsKeyframe(uint32_t frame) const;
+    // The state before frame ran, as saved by RollbackSimulation::SaveState
+    void AddKeyframe(uint32_t frame, const uint8_t* state, size_t size);
+
+    // The next confirmed frame's inputs, one mask per player slot
+    void AddFrame(const uint32_t* inputs);
+
+    // No more frames; the ones held back still go out, one per
+    // CollectDatagrams() call, followed by an end marker
+    void Finish();
+
+    void AddSpectator(uint32_t spectatorId, const UdpEndpoint& endpoint);
+    void RemoveSpectator(uint32_t spectatorId);
+    // The spectator missed a datagram; starts it over from a keyframe
+    void Resync(uint32_t spectatorId);
+    size_t GetSpectatorCount() const { return m_spectators.size(); }
+
+    // Everything due to every spectator, for UdpSocket::SendBatch(). Call
+    // once per tick; the data stays valid until the next call.
+    const std::vector<UdpDatagram>& CollectDatagrams();
+
+    // CollectDatagrams() sent through socket; returns the datagrams sent
+    size_t Send(UdpSocket& socket);
+
+    // Newest frame spectators may see
+    uint32_t GetReleasedFrame() const;
+    uint32_t GetNextFrame() const { return m_nextFrame; }
+    const SpectatorRelayStats& GetStats() const { return m_stats; }
+
+private:
+    struct Block {
+        uint32_t firstFrame = 0;
+        uint32_t frameCount = 0;
+        std::vector<uint8_t> data;
+    };
+
+    struct Keyframe {
+        uint32_t frame = 0;
+        std::vector<std::vector<uint8_t>> chunks;
+    };
+
+    struct Spectator {
+        uint32_t id;
+        UdpEndpoint endpoint;
+        uint32_t nextFrame;   // First frame not yet sent
+        bool synced;          // Has been sent a keyframe
+        bool ended;
+    };
+
+    void StartBlock();
+    void SealBlock();
+    void Prune();
+    void Queue(const Spectator& spectator, const std::vector<uint8_t>& data);
+
+    SpectatorConfig m_config;
+    ReplayHeader m_header;
+    bool m_started;
+    bool m_finished;
+
+    uint32_t m_nextFrame;       // Next frame AddFrame() will add
+    uint32_t m_clockFrame;      // Keeps advancing after Finish()
+
+    // Block being filled; sealed blocks are never changed again
+    Block m_open;
+    uint32_t m_current[ReplayHeader::MAX_PLAYERS];
+    uint32_t m_run;
+
+    std::deque<Block> m_blocks;         // Contiguous, oldest first
+    std::deque<Keyframe> m_keyframes;   // Oldest first
+    std::vector<uint8_t> m_end;
+
+    std::vector<Spectator> m_spectators;
+    std::vector<UdpDatagram> m_datagrams;
+    SpectatorRelayStats m_stats;
+};
+
+// Spectator side of SpectatorRelay: rebuilds keyframes and the input
+// stream from its datagrams. Blocks must arrive in order; after a gap
+// NeedsResync() stays set until a new keyframe has arrived, and the
+// spectator should ask the relay for one.
+class SpectatorFeed {
+public:
+    SpectatorFeed();
+
+    // False if the datagram is not from a relay or does not follow on
+    bool Receive(const uint8_t* data, size_t size);
+
+    bool NeedsResync() const { return m_needsResync; }
+
+    // A complete keyframe waits to be loaded; frames before it are dropped
+    bool HasKeyframe() const { return m_keyframeReady; }
+    bool LoadKeyframe(RollbackSimulation& simulation);
+
+    // The next frame's inputs once a keyframe was loaded; false when none
+    // has arrived yet
+    bool NextFrame(uint32_t* inputs);
+
+    // Loads a waiting keyframe, then steps simulation through every
+    // frame received. Returns the frames stepped.
+    uint32_t CatchUp(RollbackSimulation& simulation);
+
+    uint32_t GetNextFrame() const { return m_playFrame; }     // Frame NextFrame() yields
+    uint8_t GetPlayerCount() const { return m_playerCount; }
+    uint32_t GetMatchId() const { return m_matchId; }
+    bool IsFinished() const;                                 // Ended and fully played
+
+private:
+    bool ReceiveKeyframe(const uint8_t* data, size_t size);
+    bool ReceiveBlock(const uint8_t* data, size_t size);
+
+    uint32_t m_matchId;
+    uint8_t m_playerCount;
+    bool m_needsResync;
+
+    // Keyframe being assembled, then waiting to be loaded
+    uint32_t m_keyframeFrame;
+    uint32_t m_stateSize;
+    uint32_t m_compressedSize;
+    std::vector<uint8_t> m_compressed;
+    std::vector<uint8_t> m_keyframe;
+    bool m_keyframeReady;
+
+    bool m_streaming;                  // Blocks follow on from a complete keyframe
+    bool m_playing;                    // A keyframe was loaded
+    uint32_t m_playFrame;
+    uint32_t m_receivedFrame;          // Frame after the newest received
+    std::deque<uint32_t> m_inputs;     // Received, not yet played; playerCount per frame
+    uint32_t m_endFrame;               // 0 until the end marker arrives
+};
+
+} // namespace ArenaFighter
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace ArenaFighter {
+
+// Bounded lock-free queue between exactly one producer thread and one
+// consumer thread. Each index is written by one side only, so a push or
+// pop is a plain store with release ordering and no read-modify-write.
+// Each side also caches the other's index and rereads it only when the
+// ring looks full (or empty), so the shared cache lines are rarely touched.
+// Slots are reused in place: moving into a slot whose previous value has
+// been moved out keeps that value's storage (e.g. a vector's capacity).
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr size_t CAPACITY = Capacity;
+
+    SpscRing() = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only. Returns false, leaving value untouched, when full.
+    bool TryPush(T&& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) {
+                return false;
+            }
+        }
+
+        m_slots[tail & MASK] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only: fills the next slot in place. fill(T&) must not fail.
+    template <typename Fill>
+    bool TryEmplace(Fill&& fill) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) {
+                return false;
+            }
+        }
+
+        fill(m_slots[tail & MASK]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false when empty.
+    bool TryPop(T& out) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+
+        out = std::move(m_slots[head & MASK]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: points items at up to maxCount of the oldest elements
+    // without removing them, so they can be used in place. Release them
+    // with Pop() once done.
+    size_t Peek(T** items, size_t maxCount) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_cachedTail - head < maxCount) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+
+        size_t count = m_cachedTail - head;
+        if (count > maxCount) {
+            count = maxCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            items[i] = &m_slots[(head + i) & MASK];
+        }
+        return count;
+    }
+
+    void Pop(size_t count = 1) {
+        m_head.store(m_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Exact only while both sides are idle
+    size_t SizeApprox() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    bool EmptyApprox() const { return SizeApprox() == 0; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Consumer side
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;
+
+    // Producer side
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;
+
+    alignas(CACHE_LINE) std::array<T, Capacity> m_slots{};
+};
+
+} // namespace ArenaFighter
@@ -0,0 +1,2640 @@
+#include <gtest/gtest.h>
+#include "../NetworkManager.h"
+#include "../NetworkPacket.h"
+#include "../InputBuffer.h"
+#include "../UdpSocket.h"
+#include "../SendArena.h"
+#include "../DeltaCompression.h"
+#include "../RollbackEngine.h"
+#include "../DesyncDetector.h"
+#include "../TimeSync.h"
+#include "../SpscRing.h"
+#include "../NetworkThread.h"
+#include "../PacketPool.h"
+#include "../InputPredictor.h"
+#include "../LinkEmulator.h"
+#include "../Replay.h"
+#include "../SpectatorRelay.h"
+#include "../ReliableConnection.h"
+#include "../../Core/DeterministicRandom.h"
+#include "../../Soak/ArenaSimulation.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Counts global heap allocations so the serialization benchmark can
+// report allocations per tick
+static std::atomic<size_t> g_allocationCount{0};
+
+// The whole unaligned family is replaced so every form pairs malloc with
+// free; aligned allocations keep the library's own pair. The scalar pair
+// stays out of line, or GCC sees malloc matched with operator delete
+// after inlining and warns
+[[gnu::noinline]] void* operator new(size_t size) {
+    g_allocationCount++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+
+namespace ArenaFighter {
+namespace Tests {
+
+class NetworkLoopbackTest : public ::testing::Test {
+protected:
+    std::unique_ptr<NetworkManager> host;
+    std::unique_ptr<NetworkManager> client;
+
+    void SetUp() override {
+        host = std::make_unique<NetworkManager>();
+        client = std::make_unique<NetworkManager>();
+
+        ASSERT_TRUE(host->Initialize());
+        ASSERT_TRUE(client->Initialize());
+        ASSERT_TRUE(host->StartHost(0));
+        ASSERT_TRUE(client->ConnectToHost("127.0.0.1", host->GetLocalPort()));
+    }
+
+    void TearDown() override {
+        client.reset();
+        host.reset();
+    }
+
+    // Pump both managers one send tick at a time until done() or timeout
+    template <typename Predicate>
+    bool PumpUntil(Predicate done, int maxTicks = 200) {
+        const float sendInterval = 1.0f / NetworkConfig::SEND_RATE;
+        for (int i = 0; i < maxTicks; ++i) {
+            client->Update(sendInterval);
+            host->Update(sendInterval);
+            if (done()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+};
+
+// Connection Tests
+TEST_F(NetworkLoopbackTest, ClientIsAssignedPlayerIdByHost) {
+    uint32_t connectedId = 0;
+    host->SetOnPlayerConnected([&](uint32_t playerId) { connectedId = playerId; });
+
+    EXPECT_EQ(client->GetConnectionState(), ConnectionState::Connecting);
+    EXPECT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    EXPECT_EQ(host->GetLocalPlayerId(), 1);
+    EXPECT_EQ(client->GetLocalPlayerId(), 2);
+    EXPECT_EQ(connectedId, 2u);
+}
+
+TEST_F(NetworkLoopbackTest, InputReachesHost) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    uint32_t receivedMask = 0;
+    uint32_t receivedPlayer = 0;
+    host->RegisterPacketHandler(static_cast<uint16_t>(PacketType::InputCommand),
+        [&](NetworkPacket* packet) {
+            auto input = static_cast<InputPacket*>(packet);
+            receivedMask = input->inputMask;
+            receivedPlayer = input->playerId;
+        });
+
+    client->SendInput(10, 0x15, 1);
+
+    EXPECT_TRUE(PumpUntil([&] { return receivedMask != 0; }));
+    EXPECT_EQ(receivedMask, 0x15u);
+    EXPECT_EQ(receivedPlayer, 2u);
+}
+
+TEST_F(NetworkLoopbackTest, BurstOfInputsArrivesIntact) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    std::vector<uint32_t> masks;
+    host->RegisterPacketHandler(static_cast<uint16_t>(PacketType::InputCommand),
+        [&](NetworkPacket* packet) { masks.push_back(static_cast<InputPacket*>(packet)->inputMask); });
+
+    // Dozens of packets in a single send tick, as in an 8-player lobby
+    const int burst = 48;
+    for (int i = 0; i < burst; ++i) {
+        client->SendInput(100 + i, 0x100 + i, static_cast<uint16_t>(i));
+    }
+
+    EXPECT_TRUE(PumpUntil([&] { return masks.size() == burst; }));
+    ASSERT_EQ(masks.size(), static_cast<size_t>(burst));
+    for (int i = 0; i < burst; ++i) {
+        EXPECT_EQ(masks[i], 0x100u + i);
+    }
+}
+
+TEST_F(NetworkLoopbackTest, DisconnectNotifiesHost) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    uint32_t disconnectedId = 0;
+    host->SetOnPlayerDisconnected([&](uint32_t playerId) { disconnectedId = playerId; });
+
+    client->Disconnect();
+    EXPECT_EQ(client->GetConnectionState(), ConnectionState::Disconnected);
+
+    const float sendInterval = 1.0f / NetworkConfig::SEND_RATE;
+    for (int i = 0; i < 50 && disconnectedId == 0; ++i) {
+        host->Update(sendInterval);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(disconnectedId, 2u);
+}
+
+TEST_F(NetworkLoopbackTest, WholeBurstIsProcessedInOneUpdate) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    size_t received = 0;
+    host->RegisterPacketHandler(static_cast<uint16_t>(PacketType::InputCommand),
+        [&](NetworkPacket*) { received++; });
+
+    const int burst = 40;
+    for (int i = 0; i < burst; ++i) {
+        client->SendInput(200 + i, 0x1, static_cast<uint16_t>(i));
+    }
+    client->Update(1.0f / NetworkConfig::SEND_RATE);
+
+    // The host's network thread takes it off the socket meanwhile; a
+    // single frame then handles all of it
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    host->Update(0.0f);
+    EXPECT_EQ(received, static_cast<size_t>(burst));
+}
+
+TEST_F(NetworkLoopbackTest, HostRelaysInputsBetweenClients) {
+    auto second = std::make_unique<NetworkManager>();
+    ASSERT_TRUE(second->Initialize());
+    ASSERT_TRUE(second->ConnectToHost("127.0.0.1", host->GetLocalPort()));
+
+    auto pumpAll = [&](auto done) {
+        const float sendInterval = 1.0f / NetworkConfig::SEND_RATE;
+        for (int i = 0; i < 200; ++i) {
+            client->Update(sendInterval);
+            second->Update(sendInterval);
+            host->Update(sendInterval);
+            if (done()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    };
+    ASSERT_TRUE(pumpAll([&] {
+        return client->GetConnectionState() == ConnectionState::Connected &&
+               second->GetConnectionState() == ConnectionState::Connected;
+    }));
+    const uint32_t firstId = client->GetLocalPlayerId();
+    const uint32_t secondId = second->GetLocalPlayerId();
+    ASSERT_NE(firstId, secondId);
+
+    for (uint32_t frame = 1; frame <= 5; ++frame) {
+        client->SendInput(frame, 0x10 + frame, static_cast<uint16_t>(frame));
+        second->SendInput(frame, 0x20 + frame, static_cast<uint16_t>(frame));
+    }
+
+    EXPECT_TRUE(pumpAll([&] {
+        InputBuffer* fromFirst = second->GetInputBuffer(firstId);
+        InputBuffer* fromSecond = client->GetInputBuffer(secondId);
+        return fromFirst && fromSecond &&
+               fromFirst->GetContiguousFrame() >= 5 && fromSecond->GetContiguousFrame() >= 5;
+    }));
+
+    // Each client holds the other's inputs, and its own only once
+    ASSERT_NE(second->GetInputBuffer(firstId), nullptr);
+    ASSERT_NE(client->GetInputBuffer(secondId), nullptr);
+    for (uint32_t frame = 1; frame <= 5; ++frame) {
+        EXPECT_EQ(second->GetInputBuffer(firstId)->GetInputMask(frame), 0x10u + frame);
+        EXPECT_EQ(client->GetInputBuffer(secondId)->GetInputMask(frame), 0x20u + frame);
+    }
+    EXPECT_EQ(host->GetInputBuffer(firstId)->GetInputMask(5), 0x15u);
+    EXPECT_EQ(host->GetInputBuffer(secondId)->GetInputMask(5), 0x25u);
+
+    second.reset();
+}
+
+// Socket Tests
+TEST(UdpSocketTest, BatchedSendAndReceive) {
+    UdpSocket sender;
+    UdpSocket receiver;
+    ASSERT_TRUE(sender.Open(0));
+    ASSERT_TRUE(receiver.Open(0));
+
+    UdpEndpoint target;
+    ASSERT_TRUE(UdpEndpoint::Resolve("127.0.0.1", receiver.GetLocalPort(), target));
+
+    uint8_t payloads[16][4];
+    UdpDatagram out[16];
+    for (int i = 0; i < 16; ++i) {
+        for (int b = 0; b < 4; ++b) payloads[i][b] = static_cast<uint8_t>(i * 4 + b);
+        out[i].endpoint = target;
+        out[i].data = payloads[i];
+        out[i].size = sizeof(payloads[i]);
+    }
+    EXPECT_EQ(sender.SendBatch(out, 16), 16u);
+
+    UdpDatagram in[UdpSocket::MAX_BATCH];
+    size_t received = 0;
+    for (int attempt = 0; attempt < 100 && received < 16; ++attempt) {
+        received += receiver.ReceiveBatch(in + received, UdpSocket::MAX_BATCH - received);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(received, 16u);
+
+    // Nothing pending must not block
+    EXPECT_EQ(receiver.ReceiveBatch(in, UdpSocket::MAX_BATCH), 0u);
+}
+
+TEST(UdpSocketTest, WaitForDataWakesOnArrival) {
+    UdpSocket sender;
+    UdpSocket receiver;
+    ASSERT_TRUE(sender.Open(0));
+    ASSERT_TRUE(receiver.Open(0));
+
+    EXPECT_FALSE(receiver.WaitForData(1));
+
+    UdpEndpoint target;
+    ASSERT_TRUE(UdpEndpoint::Resolve("127.0.0.1", receiver.GetLocalPort(), target));
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    UdpDatagram out;
+    out.endpoint = target;
+    out.data = payload;
+    out.size = sizeof(payload);
+    ASSERT_EQ(sender.SendBatch(&out, 1), 1u);
+
+    EXPECT_TRUE(receiver.WaitForData(1000));
+}
+
+TEST(UdpSocketTest, WakeupCutsWaitShort) {
+    UdpSocket socket;
+    SocketWakeup wakeup;
+    ASSERT_TRUE(socket.Open(0));
+    ASSERT_TRUE(wakeup.Open());
+
+    // A signal sent before the wait is not lost
+    wakeup.Signal();
+    wakeup.Signal();
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(socket.WaitForData(5000, &wakeup));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+
+    // Both signals were drained, so the next wait times out
+    EXPECT_FALSE(socket.WaitForData(1, &wakeup));
+
+    std::thread signaller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        wakeup.Signal();
+    });
+    start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(socket.WaitForData(5000, &wakeup));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+    signaller.join();
+}
+
+// Link Emulator Tests
+namespace {
+
+// A server socket behind a LinkEmulator and a client socket pointed at it
+struct EmulatedLink {
+    UdpSocket server;
+    UdpSocket client;
+    LinkEmulator link;
+    UdpEndpoint toLink;
+
+    explicit EmulatedLink(uint32_t seed) : link(seed) {}
+
+    bool Open() {
+        UdpEndpoint serverEndpoint;
+        return server.Open(0) && client.Open(0) &&
+               UdpEndpoint::Resolve("127.0.0.1", server.GetLocalPort(), serverEndpoint) &&
+               link.Start(serverEndpoint) &&
+               UdpEndpoint::Resolve("127.0.0.1", link.GetLocalPort(), toLink);
+    }
+
+    void SendFromClient(uint32_t value) {
+        UdpDatagram out;
+        out.endpoint = toLink;
+        out.data = reinterpret_cast<const uint8_t*>(&value);
+        out.size = sizeof(value);
+        client.SendBatch(&out, 1);
+    }
+
+    // Pumps the link until nothing is in flight, collecting what the
+    // server receives
+    void Drain(std::vector<uint32_t>& received, UdpEndpoint* lastSource = nullptr) {
+        UdpDatagram in[UdpSocket::MAX_BATCH];
+        for (int idle = 0; idle < 20; ) {
+            link.Update();
+            size_t count = server.ReceiveBatch(in, UdpSocket::MAX_BATCH);
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t value;
+                std::memcpy(&value, in[i].data, sizeof(value));
+                received.push_back(value);
+                if (lastSource) {
+                    *lastSource = in[i].endpoint;
+                }
+            }
+            idle = (count == 0 && link.GetInFlight() == 0) ? idle + 1 : 0;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+};
+
+} // namespace
+
+TEST(LinkEmulatorTest, DelaysBothDirections) {
+    EmulatedLink emulated(1);
+    ASSERT_TRUE(emulated.Open());
+
+    LinkConditions toServer;
+    toServer.latencyMs = 30.0f;
+    LinkConditions toClient;
+    toClient.latencyMs = 10.0f;
+    emulated.link.SetConditions(toServer, toClient);
+
+    auto start = std::chrono::steady_clock::now();
+    emulated.SendFromClient(42);
+
+    std::vector<uint32_t> received;
+    UdpEndpoint source;
+    emulated.Drain(received, &source);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0], 42u);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(30));
+
+    // The reply goes back through the client's route
+    uint32_t reply = 7;
+    UdpDatagram out;
+    out.endpoint = source;
+    out.data = reinterpret_cast<const uint8_t*>(&reply);
+    out.size = sizeof(reply);
+    ASSERT_EQ(emulated.server.SendBatch(&out, 1), 1u);
+
+    UdpDatagram in;
+    size_t count = 0;
+    for (int attempt = 0; attempt < 200 && count == 0; ++attempt) {
+        emulated.link.Update();
+        count = emulated.client.ReceiveBatch(&in, 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(count, 1u);
+    EXPECT_EQ(std::memcmp(in.data, &reply, sizeof(reply)), 0);
+    EXPECT_EQ(emulated.link.GetStats(LinkEmulator::ToClient).delivered, 1u);
+}
+
+TEST(LinkEmulatorTest, ImpairmentsFollowTheConfiguredRates) {
+    EmulatedLink emulated(7);
+    ASSERT_TRUE(emulated.Open());
+
+    LinkConditions conditions;
+    conditions.jitterMs = 2.0f;
+    conditions.loss = 0.1f;
+    conditions.reorder = 0.05f;
+    conditions.duplicate = 0.05f;
+    conditions.reorderDelayMs = 5.0f;
+    emulated.link.SetConditions(conditions);
+
+    // Small bursts, so the loopback socket buffers never drop anything
+    const uint32_t count = 2000;
+    std::vector<uint32_t> received;
+    for (uint32_t i = 0; i < count; i += 100) {
+        for (uint32_t j = i; j < i + 100; ++j) {
+            emulated.SendFromClient(j);
+        }
+        emulated.Drain(received);
+    }
+
+    const LinkStats& stats = emulated.link.GetStats(LinkEmulator::ToServer);
+    EXPECT_EQ(stats.received, count);
+    EXPECT_EQ(stats.delivered, received.size());
+    EXPECT_EQ(stats.delivered, stats.received - stats.dropped + stats.duplicated);
+    EXPECT_NEAR(static_cast<double>(stats.dropped) / count, 0.1, 0.03);
+    EXPECT_NEAR(static_cast<double>(stats.duplicated) / count, 0.05, 0.02);
+    EXPECT_NEAR(static_cast<double>(stats.reordered) / count, 0.05, 0.02);
+
+    // Jitter alone keeps order: every datagram that arrives after a later
+    // one was held back on purpose
+    uint32_t late = 0;
+    uint32_t newest = 0;
+    for (uint32_t value : received) {
+        late += value < newest ? 1 : 0;
+        newest = std::max(newest, value);
+    }
+    EXPECT_GT(late, 0u);
+    EXPECT_LE(late, stats.reordered + stats.duplicated);
+}
+
+// Network Thread Tests
+TEST(SpscRingTest, RejectsPushWhenFullAndWrapsAround) {
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.TryPush(int(i)));
+    }
+    EXPECT_FALSE(ring.TryPush(4));
+
+    int value = -1;
+    for (int round = 0; round < 10; ++round) {
+        ASSERT_TRUE(ring.TryPop(value));
+        EXPECT_EQ(value, round);
+        EXPECT_TRUE(ring.TryPush(round + 4));
+    }
+    EXPECT_EQ(ring.SizeApprox(), 4u);
+}
+
+TEST(SpscRingTest, PreservesOrderAcrossThreads) {
+    auto ring = std::make_unique<SpscRing<uint32_t, 256>>();
+    const uint32_t count = 1000000;
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < count; ++i) {
+            while (!ring->TryPush(uint32_t(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        uint32_t* items[32];
+        size_t peeked = ring->Peek(items, 32);
+        if (peeked == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < peeked; ++i) {
+            ordered &= *items[i] == expected++;
+        }
+        ring->Pop(peeked);
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(ring->EmptyApprox());
+}
+
+TEST(NetworkThreadTest, TimestampsAndDecodesArrivals) {
+    NetworkThread receiver;
+    NetworkThread sender;
+    auto receiveSocket = std::make_unique<UdpSocket>();
+    auto sendSocket = std::make_unique<UdpSocket>();
+    ASSERT_TRUE(receiveSocket->Open(0));
+    ASSERT_TRUE(sendSocket->Open(0));
+    receiver.Start(std::move(receiveSocket));
+    sender.Start(std::move(sendSocket));
+
+    UdpEndpoint target;
+    ASSERT_TRUE(UdpEndpoint::Resolve("127.0.0.1", receiver.GetLocalPort(), target));
+
+    InputPacket input;
+    input.playerId = 3;
+    input.SetSingleInput(10, 0x5);
+    uint8_t buffer[NetworkConfig::PACKET_SIZE_LIMIT];
+    size_t size = input.Serialize(buffer, sizeof(buffer));
+    ASSERT_GT(size, 0u);
+
+    uint32_t sentMs = GetTimestampMs();
+    ASSERT_TRUE(sender.Send(target, buffer, size));
+
+    ReceivedPacket received;
+    bool arrived = false;
+    for (int attempt = 0; attempt < 1000 && !arrived; ++attempt) {
+        arrived = receiver.Receive(received);
+        if (!arrived) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(arrived);
+    EXPECT_EQ(received.packet->GetType(), PacketType::InputCommand);
+    EXPECT_EQ(static_cast<InputPacket*>(received.packet.get())->inputMask, 0x5u);
+    EXPECT_EQ(received.source.port, sender.GetLocalPort());
+
+    // Stamped when the I/O thread read it, not when we collected it
+    EXPECT_GE(received.arrivalMs - sentMs, 0u);
+    EXPECT_LE(received.arrivalMs - sentMs, 100u);
+
+    sender.Stop();
+    EXPECT_FALSE(sender.Send(target, buffer, size));
+}
+
+TEST(NetworkThreadTest, SendWakesIdleThread) {
+    NetworkThread receiver;
+    NetworkThread sender;
+    auto receiveSocket = std::make_unique<UdpSocket>();
+    auto sendSocket = std::make_unique<UdpSocket>();
+    ASSERT_TRUE(receiveSocket->Open(0));
+    ASSERT_TRUE(sendSocket->Open(0));
+    receiver.Start(std::move(receiveSocket));
+    sender.Start(std::move(sendSocket));
+
+    UdpEndpoint target;
+    ASSERT_TRUE(UdpEndpoint::Resolve("127.0.0.1", receiver.GetLocalPort(), target));
+    uint8_t buffer[NetworkConfig::PACKET_SIZE_LIMIT];
+    InputPacket input;
+    size_t size = input.Serialize(buffer, sizeof(buffer));
+
+    // Each send finds the I/O thread asleep in a wait far longer than the
+    // bound below, so only the wakeup gets it out in time
+    std::chrono::steady_clock::duration worst{};
+    for (int i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(sender.Send(target, buffer, size));
+        ReceivedPacket received;
+        while (!receiver.Receive(received)) {
+            ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+            std::this_thread::yield();
+        }
+        worst = std::max(worst, std::chrono::steady_clock::now() - start);
+    }
+
+    std::cout << "idle send to receive: worst "
+              << std::chrono::duration<double, std::micro>(worst).count() << " us\n";
+    EXPECT_LT(worst, std::chrono::milliseconds(NetworkConfig::NETWORK_THREAD_WAIT_MS / 2));
+
+    // Stop() does not wait out the poll either
+    auto stopStart = std::chrono::steady_clock::now();
+    sender.Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - stopStart, std::chrono::milliseconds(NetworkConfig::NETWORK_THREAD_WAIT_MS / 2));
+}
+
+// Serialization Tests
+TEST(PacketSerializationTest, ArenaMatchesVectorPath) {
+    AttackPacket attack;
+    attack.attackerId = 3;
+    attack.targetId = 7;
+    attack.skillId = 42;
+    attack.damage = 125.5f;
+    attack.hitType = 2;
+    attack.comboCount = 9;
+    attack.position[0] = 1.0f; attack.position[1] = 2.0f; attack.position[2] = 3.0f;
+
+    std::vector<uint8_t> vectorBytes;
+    attack.Serialize(vectorBytes);
+
+    SendArena arena(4);
+    size_t written = arena.Write(attack);
+    ASSERT_EQ(written, vectorBytes.size());
+    EXPECT_EQ(std::memcmp(arena.GetDatagramData(0), vectorBytes.data(), written), 0);
+
+    // Header carries the real size on the wire
+    auto decoded = PacketFactory::CreateFromData(arena.GetDatagramData(0), written);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(decoded->GetHeader().size, written);
+    auto decodedAttack = static_cast<AttackPacket*>(decoded.get());
+    EXPECT_EQ(decodedAttack->skillId, 42);
+    EXPECT_FLOAT_EQ(decodedAttack->damage, 125.5f);
+}
+
+TEST(PacketSerializationTest, ArenaRejectsWhenFull) {
+    SendArena arena(2);
+    InputPacket input;
+
+    size_t packets = 0;
+    while (arena.Write(input) > 0) {
+        packets++;
+    }
+
+    // Two MTU-sized datagrams worth of coalesced inputs, then no more room
+    std::vector<uint8_t> single;
+    input.Serialize(single);
+    size_t perDatagram = SendArena::SLOT_SIZE / single.size();
+    EXPECT_TRUE(arena.IsFull());
+    EXPECT_EQ(arena.GetDatagramCount(), 2u);
+    EXPECT_EQ(packets, perDatagram * 2);
+
+    arena.Reset();
+    EXPECT_EQ(arena.GetDatagramCount(), 0u);
+    EXPECT_GT(arena.Write(input), 0u);
+}
+
+// Coalescing Tests
+TEST(PacketCoalescingTest, SmallPacketsShareOneDatagram) {
+    SendArena arena;
+    for (uint32_t player = 1; player <= 8; ++player) {
+        InputPacket input;
+        input.playerId = player;
+        input.inputMask = 0x10 * player;
+        arena.Write(input);
+    }
+
+    EXPECT_EQ(arena.GetDatagramCount(), 1u);
+    EXPECT_EQ(arena.GetPacketCount(), 8u);
+    EXPECT_LE(arena.GetDatagramSize(0), static_cast<size_t>(NetworkConfig::PACKET_SIZE_LIMIT));
+
+    std::vector<std::unique_ptr<NetworkPacket>> packets;
+    EXPECT_EQ(PacketFactory::CreateFromData(arena.GetDatagramData(0), arena.GetDatagramSize(0), packets), 8u);
+    for (uint32_t player = 1; player <= 8; ++player) {
+        auto input = static_cast<InputPacket*>(packets[player - 1].get());
+        EXPECT_EQ(input->playerId, player);
+        EXPECT_EQ(input->inputMask, 0x10 * player);
+    }
+}
+
+TEST(PacketCoalescingTest, CorruptPacketIsDroppedAlone) {
+    SendArena arena;
+    InputPacket first;
+    first.inputMask = 1;
+    AttackPacket middle;
+    InputPacket last;
+    last.inputMask = 3;
+    arena.Write(first);
+    size_t middleOffset = arena.GetDatagramSize(0);
+    arena.Write(middle);
+    arena.Write(last);
+
+    // Flip a payload byte of the middle packet
+    arena.GetDatagramData(0)[middleOffset + sizeof(PacketHeader) + 1] ^= 0xFF;
+
+    std::vector<std::unique_ptr<NetworkPacket>> packets;
+    ASSERT_EQ(PacketFactory::CreateFromData(arena.GetDatagramData(0), arena.GetDatagramSize(0), packets), 2u);
+    EXPECT_EQ(static_cast<InputPacket*>(packets[0].get())->inputMask, 1u);
+    EXPECT_EQ(static_cast<InputPacket*>(packets[1].get())->inputMask, 3u);
+}
+
+TEST_F(NetworkLoopbackTest, CriticalPacketsAreSentFirst) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    std::vector<PacketType> order;
+    auto record = [&](NetworkPacket* packet) { order.push_back(packet->GetType()); };
+    host->RegisterPacketHandler(static_cast<uint16_t>(PacketType::PlayerStateUpdate), record);
+    host->RegisterPacketHandler(static_cast<uint16_t>(PacketType::InputCommand), record);
+
+    // Normal priority queued before Critical
+    client->SendPacket(client->CreatePacket<PlayerStatePacket>(), false);
+    client->SendInput(1, 0x1, 1);
+
+    // Both ride in the same datagram. Counted over this one send tick, as
+    // delivery now takes the host's network thread a moment.
+    int datagramsBefore = client->GetNetworkStats().datagramsSent;
+    client->Update(1.0f / NetworkConfig::SEND_RATE);
+    EXPECT_EQ(client->GetNetworkStats().datagramsSent - datagramsBefore, 1);
+
+    EXPECT_TRUE(PumpUntil([&] { return order.size() == 2; }));
+    ASSERT_EQ(order.size(), 2u);
+    EXPECT_EQ(order[0], PacketType::InputCommand);
+    EXPECT_EQ(order[1], PacketType::PlayerStateUpdate);
+}
+
+// Input Redundancy Tests
+TEST(InputRedundancyTest, HistoryRoundTripsThroughRunLengthEncoding) {
+    InputPacket packet;
+    packet.playerId = 2;
+    packet.frame = 40;
+    packet.ackFrame = 31;
+    packet.historyCount = 8;
+    const uint32_t masks[8] = {0x1, 0x1, 0x1, 0x5, 0x5, 0x80000004, 0x4, 0x4};
+    std::copy(masks, masks + 8, packet.history);
+    packet.inputMask = masks[7];
+
+    uint8_t buffer[NetworkConfig::PACKET_SIZE_LIMIT];
+    size_t size = packet.Serialize(buffer, sizeof(buffer));
+    ASSERT_GT(size, 0u);
+
+    InputPacket decoded;
+    decoded.Deserialize(buffer, size);
+    EXPECT_EQ(decoded.frame, 40u);
+    EXPECT_EQ(decoded.ackFrame, 31u);
+    EXPECT_EQ(decoded.GetFirstFrame(), 33u);
+    ASSERT_EQ(decoded.historyCount, 8);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(decoded.history[i], masks[i]);
+    }
+    EXPECT_EQ(decoded.inputMask, 0x4u);
+}
+
+TEST(InputRedundancyTest, HeldInputCompressesToOneRun) {
+    InputPacket held;
+    held.frame = 100;
+    held.historyCount = 8;
+    std::fill(held.history, held.history + 8, 0x21u);
+
+    InputPacket single;
+    single.SetSingleInput(100, 0x21);
+
+    uint8_t buffer[NetworkConfig::PACKET_SIZE_LIMIT];
+    size_t heldSize = held.Serialize(buffer, sizeof(buffer));
+    size_t singleSize = single.Serialize(buffer, sizeof(buffer));
+
+    // Eight held frames cost exactly as much as one
+    EXPECT_EQ(heldSize, singleSize);
+}
+
+TEST(InputRedundancyTest, RangeInsertCorrectsPredictions) {
+    InputBuffer buffer(2);
+    buffer.AddPredictedInput(1, 0x0);
+    buffer.AddPredictedInput(2, 0x0);
+
+    const uint32_t masks[3] = {0x0, 0x8, 0x8};
+    EXPECT_EQ(buffer.AddInput(1, masks, 3, 0), 3u);
+    EXPECT_EQ(buffer.GetInputMask(2), 0x8u);
+    EXPECT_FALSE(buffer.GetInput(2)->predicted);
+    EXPECT_EQ(buffer.GetContiguousFrame(), 3u);
+    EXPECT_FLOAT_EQ(buffer.GetPredictionAccuracy(), 0.5f);
+
+    // A redundant repeat adds nothing
+    EXPECT_EQ(buffer.AddInput(1, masks, 3, 0), 0u);
+}
+
+TEST(InputRedundancyTest, HistoryRecoversLostPackets) {
+    InputBuffer receiver(2);
+    const int frames = 601;
+    const int history = InputPacket::MAX_HISTORY;
+    std::vector<uint32_t> sent(frames + 1);
+
+    for (int frame = 1; frame <= frames; ++frame) {
+        sent[frame] = (frame / 7) & 0xF; // Buttons change every few frames
+
+        InputPacket packet;
+        packet.frame = frame;
+        packet.historyCount = static_cast<uint8_t>(std::min(frame, history));
+        for (int i = 0; i < packet.historyCount; ++i) {
+            packet.history[i] = sent[packet.GetFirstFrame() + i];
+        }
+
+        // Lose about 5% of packets, including back-to-back drops
+        if (frame % 20 == 0 || frame % 97 == 0 || frame % 97 == 1) {
+            continue;
+        }
+
+        uint8_t buffer[NetworkConfig::PACKET_SIZE_LIMIT];
+        size_t size = packet.Serialize(buffer, sizeof(buffer));
+        InputPacket decoded;
+        decoded.Deserialize(buffer, size);
+        receiver.AddInput(decoded.GetFirstFrame(), decoded.history, decoded.historyCount, 0);
+    }
+
+    EXPECT_EQ(receiver.GetContiguousFrame(), static_cast<uint32_t>(frames));
+    for (int frame = frames - 100; frame <= frames; ++frame) {
+        EXPECT_EQ(receiver.GetInputMask(frame), sent[frame]);
+    }
+}
+
+TEST_F(NetworkLoopbackTest, InputCarriesUnacknowledgedHistory) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    uint8_t lastHistoryCount = 0;
+    host->RegisterPacketHandler(static_cast<uint16_t>(PacketType::InputCommand),
+        [&](NetworkPacket* packet) { lastHistoryCount = static_cast<InputPacket*>(packet)->historyCount; });
+
+    // The host never sends input back, so nothing is ever acknowledged
+    for (uint32_t frame = 1; frame <= 12; ++frame) {
+        client->SendInput(frame, frame, static_cast<uint16_t>(frame));
+    }
+
+    EXPECT_TRUE(PumpUntil([&] { return lastHistoryCount != 0; }));
+    EXPECT_EQ(lastHistoryCount, InputPacket::MAX_HISTORY);
+}
+
+TEST_F(NetworkLoopbackTest, OldestUnacknowledgedInputsAreRepeated) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    int oldestWindowCount = 0;
+    uint32_t newestFrame = 0;
+    host->RegisterPacketHandler(static_cast<uint16_t>(PacketType::InputCommand),
+        [&](NetworkPacket* packet) {
+            auto input = static_cast<InputPacket*>(packet);
+            oldestWindowCount += input->GetFirstFrame() == 1 ? 1 : 0;
+            newestFrame = std::max(newestFrame, input->frame);
+        });
+
+    // Nothing is acknowledged, so frames 1-8 have fallen out of the
+    // newest packets' history and must be sent on their own
+    const uint32_t frames = 3 * InputPacket::MAX_HISTORY;
+    for (uint32_t frame = 1; frame <= frames; ++frame) {
+        client->SendInput(frame, frame, static_cast<uint16_t>(frame));
+    }
+
+    EXPECT_TRUE(PumpUntil([&] { return newestFrame == frames; }));
+    EXPECT_GT(oldestWindowCount, InputPacket::MAX_HISTORY);
+}
+
+// Input Prediction Tests
+namespace {
+
+// Walks left or right, then throws one of three combos made of short taps
+std::vector<uint32_t> ComboPlayerInputs(uint64_t seed, size_t count) {
+    struct Press { uint32_t mask; int frames; };
+    const std::vector<std::vector<Press>> combos = {
+        {{0x8, 3}, {0x0, 2}, {0x8, 3}, {0x0, 2}, {0xC, 4}},
+        {{0x2, 2}, {0x0, 2}, {0x2, 6}, {0xA, 3}},
+        {{0x4, 3}, {0x0, 4}, {0x8, 2}},
+    };
+
+    DeterministicRandom random(seed);
+    std::vector<uint32_t> inputs;
+    while (inputs.size() < count) {
+        uint32_t direction = random.NextChance(50) ? 0x1 : 0x2;
+        inputs.insert(inputs.end(), static_cast<size_t>(random.NextRange(8, 30)), direction);
+        for (const Press& press : combos[random.NextInt(3)]) {
+            inputs.insert(inputs.end(), static_cast<size_t>(press.frames), press.mask);
+        }
+    }
+    inputs.resize(count);
+    return inputs;
+}
+
+// Holds a random mask for a random time; nothing to learn
+std::vector<uint32_t> RandomHoldInputs(uint64_t seed, size_t count) {
+    DeterministicRandom random(seed);
+    std::vector<uint32_t> inputs;
+    while (inputs.size() < count) {
+        inputs.insert(inputs.end(), static_cast<size_t>(random.NextRange(4, 40)), random.NextInt(16));
+    }
+    inputs.resize(count);
+    return inputs;
+}
+
+float PredictionAccuracy(InputPredictor& predictor, const std::vector<uint32_t>& inputs, uint32_t framesAhead) {
+    size_t hits = 0;
+    for (size_t i = 0; i + framesAhead < inputs.size(); ++i) {
+        predictor.Observe(inputs[i]);
+        hits += predictor.Predict(framesAhead) == inputs[i + framesAhead] ? 1 : 0;
+    }
+    return static_cast<float>(hits) / static_cast<float>(inputs.size() - framesAhead);
+}
+
+} // namespace
+
+TEST(InputPredictionTest, NGramLearnsRepeatedCombos) {
+    std::vector<uint32_t> inputs = ComboPlayerInputs(3, 20000);
+
+    for (uint32_t framesAhead : {1u, 3u, 6u}) {
+        RepeatLastPredictor repeat;
+        NGramPredictor ngram(0x3);
+        float repeatAccuracy = PredictionAccuracy(repeat, inputs, framesAhead);
+        float ngramAccuracy = PredictionAccuracy(ngram, inputs, framesAhead);
+        std::cout << framesAhead << " frames ahead: repeat " << repeatAccuracy * 100.0f
+                  << "%, n-gram " << ngramAccuracy * 100.0f << "%\n";
+
+        EXPECT_GT(ngramAccuracy, repeatAccuracy + 0.05f);
+    }
+}
+
+TEST(InputPredictionTest, NGramIsNoWorseThanRepeatOnRandomHolds) {
+    std::vector<uint32_t> inputs = RandomHoldInputs(5, 20000);
+
+    RepeatLastPredictor repeat;
+    NGramPredictor ngram(0x3);
+    EXPECT_GE(PredictionAccuracy(ngram, inputs, 3), PredictionAccuracy(repeat, inputs, 3) - 0.01f);
+}
+
+TEST(InputPredictionTest, HoldReleaseLetsGoOfTappedButtons) {
+    HoldReleasePredictor predictor(0x3);
+
+    // Taps of three frames while holding right
+    for (int i = 0; i < 10; ++i) {
+        for (int frame = 0; frame < 3; ++frame) predictor.Observe(0x2 | 0x8);
+        for (int frame = 0; frame < 5; ++frame) predictor.Observe(0x2);
+    }
+
+    predictor.Observe(0x2 | 0x8);
+    EXPECT_EQ(predictor.Predict(1), 0x2u | 0x8u);
+    EXPECT_EQ(predictor.Predict(4), 0x2u);
+}
+
+TEST(InputPredictionTest, BufferScoresThePredictorsGuesses) {
+    InputBuffer buffer(2);
+    buffer.SetPredictor(std::make_unique<NGramPredictor>(0x3));
+
+    // Tap Fire for two frames every six; each guess is scored when the
+    // real input arrives
+    std::vector<uint32_t> inputs;
+    for (int i = 0; i < 200; ++i) {
+        inputs.push_back(i % 6 < 2 ? 0x8u : 0x0u);
+    }
+
+    for (uint32_t frame = 1; frame <= inputs.size(); ++frame) {
+        buffer.AddPredictedInput(frame, buffer.PredictInput(frame));
+        buffer.AddInput(frame, &inputs[frame - 1], 1, static_cast<uint16_t>(frame));
+        buffer.ClearMisprediction();
+    }
+
+    EXPECT_EQ(buffer.GetPredictionHits() + buffer.GetPredictionMisses(), inputs.size());
+    // Only the first few repetitions are guessed wrong
+    EXPECT_LT(buffer.GetPredictionMisses(), 12u);
+    EXPECT_FLOAT_EQ(buffer.GetPredictionAccuracy(),
+                    static_cast<float>(buffer.GetPredictionHits()) / static_cast<float>(inputs.size()));
+}
+
+TEST(InputPredictionTest, CorrectionRedoesLaterGuesses) {
+    InputBuffer buffer(2);
+    const uint32_t first = 0x1;
+    buffer.AddInput(1, &first, 1, 1);
+
+    for (uint32_t frame = 2; frame <= 5; ++frame) {
+        buffer.AddPredictedInput(frame, buffer.PredictInput(frame));
+    }
+    EXPECT_EQ(buffer.GetInputMask(5), 0x1u);
+
+    // Frame 2 turns out different; frames 3-5 will be resimulated, so
+    // they are guessed again from it
+    const uint32_t second = 0x2;
+    buffer.AddInput(2, &second, 1, 2);
+    ASSERT_EQ(buffer.GetMispredictedFrame(), std::optional<uint32_t>(2));
+    EXPECT_EQ(buffer.GetInputMask(5), 0x2u);
+    EXPECT_TRUE(buffer.GetInput(5)->predicted);
+}
+
+TEST(InputPredictionTest, PredictionCostsUnderOneMicrosecond) {
+    std::vector<uint32_t> inputs = ComboPlayerInputs(7, 20000);
+    NGramPredictor predictor(0x3);
+
+    const uint32_t maxAhead = static_cast<uint32_t>(NetworkConfig::MAX_ROLLBACK_FRAMES);
+    uint32_t sink = 0;
+    size_t calls = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t input : inputs) {
+        predictor.Observe(input);
+        for (uint32_t framesAhead = 1; framesAhead <= maxAhead; ++framesAhead) {
+            sink += predictor.Predict(framesAhead);
+            calls++;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double nsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    std::cout << "N-gram prediction: " << nsPerCall << " ns per call, up to "
+              << maxAhead << " frames ahead (" << sink % 2 << ")\n";
+    EXPECT_LT(nsPerCall, 1000.0);
+}
+
+// Performance Tests
+TEST(PacketSerializationTest, ArenaVersusVectorPerformance) {
+    // One 8-player DeathMatch send tick: state + input per player, a few hits
+    std::vector<std::unique_ptr<NetworkPacket>> tick;
+    for (uint32_t player = 1; player <= 8; ++player) {
+        auto state = std::make_unique<PlayerStatePacket>();
+        state->playerId = player;
+        tick.push_back(std::move(state));
+
+        auto input = std::make_unique<InputPacket>();
+        input->playerId = player;
+        tick.push_back(std::move(input));
+    }
+    for (int i = 0; i < 4; ++i) {
+        tick.push_back(std::make_unique<AttackPacket>());
+    }
+
+    const int ticks = 20000;
+
+    // Previous path: a fresh vector per packet
+    size_t vectorBytes = 0;
+    size_t allocationsBefore = g_allocationCount.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (const auto& packet : tick) {
+            std::vector<uint8_t> buffer;
+            packet->Serialize(buffer);
+            vectorBytes += buffer.size();
+        }
+    }
+    auto vectorTime = std::chrono::high_resolution_clock::now() - start;
+    size_t vectorAllocations = g_allocationCount.load() - allocationsBefore;
+
+    // Arena path: reset once per tick
+    SendArena arena;
+    size_t arenaBytes = 0;
+    allocationsBefore = g_allocationCount.load();
+    start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        arena.Reset();
+        for (const auto& packet : tick) {
+            arena.Write(*packet);
+        }
+        arenaBytes += arena.GetBytesUsed();
+    }
+    auto arenaTime = std::chrono::high_resolution_clock::now() - start;
+    size_t arenaAllocations = g_allocationCount.load() - allocationsBefore;
+
+    auto bytesPerSecond = [](size_t bytes, std::chrono::high_resolution_clock::duration elapsed) {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0;
+    };
+
+    std::cout << "vector path: " << bytesPerSecond(vectorBytes, vectorTime) / (1024.0 * 1024.0)
+              << " MB/s, " << static_cast<double>(vectorAllocations) / ticks << " allocs/tick\n";
+    std::cout << "arena path:  " << bytesPerSecond(arenaBytes, arenaTime) / (1024.0 * 1024.0)
+              << " MB/s, " << static_cast<double>(arenaAllocations) / ticks << " allocs/tick\n";
+
+    EXPECT_EQ(arenaBytes, vectorBytes);
+    EXPECT_EQ(arenaAllocations, 0u);
+    EXPECT_GE(vectorAllocations, static_cast<size_t>(ticks) * tick.size());
+}
+
+
+namespace {
+
+PlayerStatePacket MakePlayerState(uint32_t playerId) {
+    PlayerStatePacket state;
+    state.playerId = playerId;
+    for (int i = 0; i < 3; ++i) {
+        state.position[i] = 0.0f;
+        state.velocity[i] = 0.0f;
+    }
+    state.rotation = 0.0f;
+    state.state = 0;
+    state.health = 1000;
+    state.mana = 100;
+    state.currentGear = 0;
+    return state;
+}
+
+// Serialize and parse back, as the wire would
+DeltaStatePacket RoundTrip(const DeltaStatePacket& packet) {
+    std::vector<uint8_t> bytes;
+    packet.Serialize(bytes);
+
+    DeltaStatePacket parsed;
+    parsed.Deserialize(bytes.data(), bytes.size());
+    return parsed;
+}
+
+} // namespace
+
+TEST(DeltaStateTest, QuantizationErrorIsBounded) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> positionDist(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> rotationDist(-20.0f, 20.0f);
+    std::uniform_int_distribution<int> healthDist(0, 65535);
+
+    const float pi = 3.14159265f;
+    const float positionBound = 0.5f / QuantizedPlayerState::POSITION_SCALE + 1e-4f;
+    const float rotationBound = pi / (1 << QuantizedPlayerState::ROTATION_BITS) + 1e-4f;
+
+    for (int i = 0; i < 100000; ++i) {
+        PlayerStatePacket original = MakePlayerState(1);
+        for (int axis = 0; axis < 3; ++axis) {
+            original.position[axis] = positionDist(rng);
+            original.velocity[axis] = positionDist(rng);
+        }
+        original.rotation = rotationDist(rng);
+        original.health = static_cast<uint16_t>(healthDist(rng));
+
+        PlayerStatePacket restored = MakePlayerState(1);
+        QuantizedPlayerState::FromPacket(original).ToPacket(restored);
+
+        for (int axis = 0; axis < 3; ++axis) {
+            ASSERT_LE(std::abs(restored.position[axis] - original.position[axis]), positionBound);
+            ASSERT_LE(std::abs(restored.velocity[axis] - original.velocity[axis]), positionBound);
+        }
+
+        // Rotation is compared on the circle
+        float difference = std::remainder(restored.rotation - original.rotation, 2.0f * pi);
+        ASSERT_LE(std::abs(difference), rotationBound);
+        ASSERT_EQ(restored.health, original.health);
+    }
+}
+
+TEST(DeltaStateTest, LossyChannelReconstructsExactly) {
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> stepDist(-8.0f, 8.0f);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    DeltaStateEncoder encoder;
+    DeltaStateDecoder decoder;
+    encoder.AddPeer(2);
+
+    PlayerStatePacket state = MakePlayerState(1);
+    int decoded = 0;
+
+    for (int tick = 0; tick < 5000; ++tick) {
+        for (int axis = 0; axis < 3; ++axis) {
+            state.velocity[axis] = stepDist(rng) * 60.0f;
+            state.position[axis] += stepDist(rng);
+        }
+        state.rotation += stepDist(rng) * 0.1f;
+        if (percent(rng) < 10) state.health = static_cast<uint16_t>(state.health - 7);
+        if (percent(rng) < 5) state.state = static_cast<uint16_t>(percent(rng) % 12);
+
+        DeltaStatePacket packet;
+        encoder.Encode(state, packet);
+
+        // 20% of deltas and 20% of acks are lost
+        if (percent(rng) < 20) continue;
+
+        PlayerStatePacket received = MakePlayerState(0);
+        if (!decoder.Decode(RoundTrip(packet), received)) {
+            continue;
+        }
+        decoded++;
+
+        QuantizedPlayerState expected = QuantizedPlayerState::FromPacket(state);
+        QuantizedPlayerState actual = QuantizedPlayerState::FromPacket(received);
+        ASSERT_EQ(received.playerId, 1u);
+        ASSERT_EQ(std::memcmp(expected.position, actual.position, sizeof(expected.position)), 0);
+        ASSERT_EQ(std::memcmp(expected.velocity, actual.velocity, sizeof(expected.velocity)), 0);
+        ASSERT_EQ(expected.rotation, actual.rotation);
+        ASSERT_EQ(expected.health, actual.health);
+        ASSERT_EQ(expected.state, actual.state);
+
+        if (percent(rng) >= 20) {
+            encoder.Acknowledge(2, 1, packet.snapshotId);
+        }
+    }
+
+    EXPECT_GT(decoded, 3000);
+}
+
+TEST(DeltaStateTest, SteadyStateFitsInTenBytes) {
+    DeltaStateEncoder encoder;
+    DeltaStateDecoder decoder;
+    encoder.AddPeer(2);
+
+    // A player running across the stage at a constant speed
+    PlayerStatePacket state = MakePlayerState(3);
+    state.velocity[0] = 300.0f;
+    state.rotation = 1.5f;
+
+    size_t fullBytes = 0;
+    {
+        std::vector<uint8_t> bytes;
+        state.Serialize(bytes);
+        fullBytes = bytes.size() - sizeof(PacketHeader);
+    }
+
+    size_t totalBytes = 0;
+    const int ticks = 600;
+    for (int tick = 0; tick < ticks; ++tick) {
+        state.position[0] += 300.0f / NetworkConfig::TICK_RATE;
+
+        DeltaStatePacket packet;
+        encoder.Encode(state, packet);
+
+        std::vector<uint8_t> bytes;
+        packet.Serialize(bytes);
+        size_t payload = bytes.size() - sizeof(PacketHeader);
+
+        PlayerStatePacket received = MakePlayerState(0);
+        DeltaStatePacket parsed;
+        parsed.Deserialize(bytes.data(), bytes.size());
+        ASSERT_TRUE(decoder.Decode(parsed, received));
+        encoder.Acknowledge(2, 3, packet.snapshotId);
+
+        if (tick > 0) {
+            EXPECT_LT(payload, 10u);
+            totalBytes += payload;
+        }
+    }
+
+    std::cout << "full state: " << fullBytes << " bytes, delta state: "
+              << static_cast<double>(totalBytes) / (ticks - 1) << " bytes/player/tick\n";
+}
+
+TEST(DeltaStateTest, LargePlayerIdsSurviveTheWire) {
+    // A long-running host hands out ids well past a byte
+    for (uint32_t playerId : {1u, 127u, 128u, 300u, 70000u, 0xFFFFFFFFu}) {
+        DeltaStatePacket packet;
+        packet.playerId = playerId;
+        packet.snapshotId = 9;
+        packet.hasBaseline = true;
+        packet.baselineId = 8;
+        packet.changedFields = 0x7F;
+        for (int i = 0; i < 3; ++i) {
+            packet.values.position[i] = -300000;
+            packet.values.velocity[i] = 300000;
+        }
+        packet.values.health = 0xFFFF;
+        packet.values.state = 0xFFFF;
+
+        DeltaStatePacket parsed = RoundTrip(packet);
+        EXPECT_EQ(parsed.playerId, playerId);
+        EXPECT_EQ(parsed.snapshotId, 9);
+        EXPECT_EQ(parsed.values.position[2], -300000);
+        EXPECT_EQ(parsed.values.state, 0xFFFF);
+    }
+}
+
+
+namespace {
+
+uint32_t ScriptedInput(uint32_t player, uint32_t frame) {
+    // Changes every few frames so predictions regularly miss
+    uint32_t phase = (frame * (player + 3)) / 5;
+    uint32_t input = (phase % 3 == 0) ? ArenaSimulation::Right : ArenaSimulation::Left;
+    if (phase % 4 == 1) input |= ArenaSimulation::Jump;
+    if (frame % 3 == player) input |= ArenaSimulation::Fire;
+    return input;
+}
+
+void AddConfirmedInput(InputBuffer& buffer, uint32_t frame, uint32_t mask) {
+    buffer.AddInput(frame, &mask, 1, static_cast<uint16_t>(frame));
+}
+
+} // namespace
+
+TEST(RollbackTest, ResimulationMatchesConfirmedTimeline) {
+    const uint32_t frames = 600;
+    const uint32_t latency = 5;
+
+    // Reference: every input known in time
+    ArenaSimulation reference;
+    InputBuffer referenceLocal(1), referenceRemote(2);
+    RollbackEngine referenceEngine(reference);
+    referenceEngine.AddPlayer(&referenceLocal);
+    referenceEngine.AddPlayer(&referenceRemote);
+    referenceEngine.Reset(1);
+
+    // Online: the remote input arrives a few frames late
+    ArenaSimulation online;
+    InputBuffer local(1), remote(2);
+    RollbackEngine engine(online);
+    engine.AddPlayer(&local);
+    engine.AddPlayer(&remote);
+    engine.Reset(1);
+
+    for (uint32_t frame = 1; frame <= frames + latency; ++frame) {
+        if (frame <= frames) {
+            AddConfirmedInput(referenceLocal, frame, ScriptedInput(0, frame));
+            AddConfirmedInput(referenceRemote, frame, ScriptedInput(1, frame));
+            ASSERT_TRUE(referenceEngine.AdvanceFrame());
+        }
+
+        if (frame > latency) {
+            AddConfirmedInput(remote, frame - latency, ScriptedInput(1, frame - latency));
+        }
+        if (frame <= frames) {
+            AddConfirmedInput(local, frame, ScriptedInput(0, frame));
+            ASSERT_TRUE(engine.AdvanceFrame());
+        }
+    }
+
+    // Apply the last late inputs
+    engine.AdvanceFrame();
+    referenceEngine.AdvanceFrame();
+
+    const RollbackStats& stats = engine.GetStats();
+    EXPECT_GT(stats.rollbacks, 0u);
+    EXPECT_LE(stats.maxRollbackFrames, static_cast<uint32_t>(NetworkConfig::MAX_ROLLBACK_FRAMES));
+    EXPECT_EQ(stats.missedRollbacks, 0u);
+    EXPECT_EQ(referenceEngine.GetStats().rollbacks, 0u);
+
+    EXPECT_EQ(std::memcmp(&online.GetState(), &reference.GetState(), sizeof(ArenaSimulation::State)), 0);
+}
+
+TEST(RollbackTest, MispredictionOlderThanRingIsReported) {
+    ArenaSimulation simulation;
+    InputBuffer local(1), remote(2);
+    RollbackEngine engine(simulation);
+    engine.AddPlayer(&local);
+    engine.AddPlayer(&remote);
+    engine.Reset(1);
+
+    AddConfirmedInput(remote, 1, 0);
+    for (uint32_t frame = 1; frame <= 20; ++frame) {
+        AddConfirmedInput(local, frame, 0);
+        engine.AdvanceFrame();
+    }
+
+    // Frame 5 was predicted as idle, long out of the ring now
+    AddConfirmedInput(remote, 5, ArenaSimulation::Right);
+    AddConfirmedInput(local, 21, 0);
+    engine.AdvanceFrame();
+
+    EXPECT_EQ(engine.GetStats().rollbacks, 0u);
+    EXPECT_EQ(engine.GetStats().missedRollbacks, 1u);
+}
+
+TEST(RollbackTest, SevenFrameResimPerformance) {
+    const uint32_t rollback = static_cast<uint32_t>(NetworkConfig::MAX_ROLLBACK_FRAMES);
+
+    ArenaSimulation simulation;
+    InputBuffer local(1), remote(2);
+    RollbackEngine engine(simulation);
+    engine.AddPlayer(&local);
+    engine.AddPlayer(&remote);
+    engine.Reset(1);
+
+    // Worst case every tick: the remote input from 7 frames ago always
+    // contradicts its prediction, and the projectile pool stays busy
+    uint32_t frame = 1;
+    auto step = [&]() {
+        if (frame > rollback) {
+            uint32_t predicted = remote.GetInputMask(frame - rollback);
+            AddConfirmedInput(remote, frame - rollback, predicted ^ ArenaSimulation::Fire);
+        }
+        AddConfirmedInput(local, frame, ScriptedInput(0, frame));
+        engine.AdvanceFrame();
+        frame++;
+    };
+
+    for (int warmup = 0; warmup < 60; ++warmup) {
+        step();
+    }
+
+    const int ticks = 2000;
+    double worstMs = 0.0;
+    double totalMs = 0.0;
+    uint32_t rollbacksBefore = engine.GetStats().rollbacks;
+
+    for (int t = 0; t < ticks; ++t) {
+        auto start = std::chrono::high_resolution_clock::now();
+        step();
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        worstMs = std::max(worstMs, ms);
+        totalMs += ms;
+    }
+
+    std::cout << "7-frame rollback tick: avg " << totalMs / ticks << " ms, worst " << worstMs
+              << " ms, " << simulation.ActiveProjectiles() << " projectiles live\n";
+
+    EXPECT_EQ(engine.GetStats().rollbacks - rollbacksBefore, static_cast<uint32_t>(ticks));
+    EXPECT_EQ(engine.GetStats().lastRollbackFrames, rollback);
+    EXPECT_LT(worstMs, 3.0);
+}
+
+TEST(DesyncTest, MatchingHashesAreCounted) {
+    DesyncDetector detector(30);
+    detector.RecordLocalHash(30, 0x1234);
+    detector.RecordRemoteHash(2, 30, 0x1234);
+    detector.RecordRemoteHash(2, 60, 0x5678);
+    detector.RecordLocalHash(60, 0x5678);
+
+    EXPECT_EQ(detector.GetMatchedChecks(), 2u);
+    EXPECT_EQ(detector.GetMismatchedChecks(), 0u);
+    EXPECT_FALSE(detector.HasDesynced());
+}
+
+TEST(DesyncTest, MismatchReportsFrameAndPeer) {
+    DesyncDetector detector(30);
+    std::vector<DesyncReport> reports;
+    detector.SetOnDesync([&](const DesyncReport& report) { reports.push_back(report); });
+
+    // Remote hash arrives before ours
+    detector.RecordRemoteHash(3, 90, 0xBEEF);
+    detector.RecordLocalHash(60, 0xAAAA);
+    detector.RecordRemoteHash(3, 60, 0xBBBB);
+    detector.RecordLocalHash(90, 0xCAFE);
+
+    ASSERT_TRUE(detector.HasDesynced());
+    EXPECT_EQ(detector.GetFirstDesync()->frame, 60u);
+    EXPECT_EQ(detector.GetFirstDesync()->playerId, 3u);
+    EXPECT_EQ(detector.GetFirstDesync()->localHash, 0xAAAAu);
+    EXPECT_EQ(detector.GetFirstDesync()->remoteHash, 0xBBBBu);
+    EXPECT_EQ(detector.GetMismatchedChecks(), 2u);
+    EXPECT_EQ(reports.size(), 2u);
+
+    detector.Reset();
+    EXPECT_FALSE(detector.HasDesynced());
+}
+
+TEST(DesyncTest, OutgoingHashesAreHandedOutOnceInOrder) {
+    DesyncDetector detector(30);
+    detector.RecordLocalHash(60, 2);
+    detector.RecordLocalHash(30, 1);
+
+    StateHash state;
+    ASSERT_TRUE(detector.PopOutgoingHash(state));
+    EXPECT_EQ(state.frame, 30u);
+    EXPECT_EQ(state.hash, 1u);
+    ASSERT_TRUE(detector.PopOutgoingHash(state));
+    EXPECT_EQ(state.frame, 60u);
+    EXPECT_EQ(state.hash, 2u);
+    EXPECT_FALSE(detector.PopOutgoingHash(state));
+
+    detector.RecordLocalHash(90, 3);
+    ASSERT_TRUE(detector.PopOutgoingHash(state));
+    EXPECT_EQ(state.frame, 90u);
+}
+
+namespace {
+
+// One peer's view of a two player match: the remote player's inputs
+// arrive late and are rolled back over
+struct ArenaPeer {
+    ArenaSimulation simulation;
+    InputBuffer local{1};
+    InputBuffer remote{2};
+    RollbackEngine engine{simulation};
+    DesyncDetector detector;
+
+    explicit ArenaPeer(bool debug = false) {
+        detector.SetDebugMode(debug);
+        engine.AddPlayer(&local);
+        engine.AddPlayer(&remote);
+        engine.Reset(1);
+        engine.AttachDesyncDetector(&detector);
+    }
+
+    void ExchangeHashes(ArenaPeer& other) {
+        StateHash state;
+        while (detector.PopOutgoingHash(state)) {
+            other.detector.RecordRemoteHash(1, state);
+        }
+    }
+};
+
+void RunArenaMatch(ArenaPeer& a, ArenaPeer& b, uint32_t frames, uint32_t corruptFrame) {
+    const uint32_t latency = 4;
+
+    for (uint32_t frame = 1; frame <= frames + latency; ++frame) {
+        if (frame > latency) {
+            uint32_t late = frame - latency;
+            uint32_t input = ScriptedInput(1, late);
+            AddConfirmedInput(a.remote, late, input);
+            // Peer b sees a different value for one frame, as a stray
+            // nondeterministic branch would produce
+            AddConfirmedInput(b.remote, late, late == corruptFrame ? input ^ (ArenaSimulation::Left | ArenaSimulation::Right) : input);
+        }
+        if (frame <= frames) {
+            AddConfirmedInput(a.local, frame, ScriptedInput(0, frame));
+            AddConfirmedInput(b.local, frame, ScriptedInput(0, frame));
+            a.engine.AdvanceFrame();
+            b.engine.AdvanceFrame();
+        }
+
+        a.ExchangeHashes(b);
+        b.ExchangeHashes(a);
+    }
+}
+
+} // namespace
+
+TEST(DesyncTest, IdenticalPeersStayInSync) {
+    ArenaPeer a, b;
+    RunArenaMatch(a, b, 300, 0);
+
+    EXPECT_FALSE(a.detector.HasDesynced());
+    EXPECT_FALSE(b.detector.HasDesynced());
+    EXPECT_GE(a.detector.GetMatchedChecks(), 290u);
+    EXPECT_EQ(a.engine.GetStats().missedStateChecks, 0u);
+    EXPECT_GT(a.engine.GetStats().rollbacks, 0u);
+}
+
+TEST(DesyncTest, DivergenceIsReportedOnTheNextFrame) {
+    ArenaPeer a, b;
+    RunArenaMatch(a, b, 300, 40);
+
+    // The snapshot of frame 41 is the first one taken after the bad input
+    ASSERT_TRUE(a.detector.HasDesynced());
+    ASSERT_TRUE(b.detector.HasDesynced());
+    EXPECT_EQ(a.detector.GetFirstDesync()->frame, 41u);
+    EXPECT_EQ(b.detector.GetFirstDesync()->frame, 41u);
+    EXPECT_EQ(a.detector.GetFirstDesync()->fieldName, nullptr);
+    EXPECT_GE(a.detector.GetMatchedChecks(), 40u);
+}
+
+TEST(DesyncTest, DebugModeNamesFirstDifferingField) {
+    ArenaPeer a(true), b(true);
+    RunArenaMatch(a, b, 120, 40);
+
+    ASSERT_TRUE(a.detector.HasDesynced());
+    const DesyncReport& report = *a.detector.GetFirstDesync();
+    EXPECT_EQ(report.frame, 41u);
+    EXPECT_EQ(report.field, 2);
+    ASSERT_NE(report.fieldName, nullptr);
+    EXPECT_STREQ(report.fieldName, "fighters[1]");
+}
+
+TEST(DesyncTest, DumpsBisectToFirstDifferingByte) {
+    ArenaPeer a(true), b(true);
+    RunArenaMatch(a, b, 60, 40);
+
+    std::string pathA = ::testing::TempDir() + "desync_a.bin";
+    std::string pathB = ::testing::TempDir() + "desync_b.bin";
+    ASSERT_TRUE(a.detector.DumpLocalState(41, pathA));
+    ASSERT_TRUE(b.detector.DumpLocalState(41, pathB));
+    EXPECT_FALSE(a.detector.DumpLocalState(1000, pathA));
+
+    std::vector<uint8_t> stateA, stateB;
+    ASSERT_TRUE(DesyncDetector::LoadStateDump(pathA, stateA));
+    ASSERT_TRUE(DesyncDetector::LoadStateDump(pathB, stateB));
+    ASSERT_EQ(stateA.size(), sizeof(ArenaSimulation::State));
+
+    auto difference = DesyncDetector::FindFirstDifference(stateA, stateB, a.detector.GetStateLayout());
+    ASSERT_TRUE(difference.has_value());
+    EXPECT_STREQ(difference->fieldName, "fighters[1]");
+    // The flipped direction has already moved the fighter: x differs
+    EXPECT_LT(difference->fieldOffset, sizeof(float));
+    EXPECT_FALSE(DesyncDetector::FindFirstDifference(stateA, stateA, a.detector.GetStateLayout()).has_value());
+
+    std::remove(pathA.c_str());
+    std::remove(pathB.c_str());
+}
+
+TEST(DesyncTest, HashMatchesReferenceXxh64) {
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    const uint8_t abc[] = {'a', 'b', 'c'};
+
+    EXPECT_EQ(DesyncDetector::HashState(nullptr, 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(DesyncDetector::HashState(abc, sizeof(abc)), 0x44BC2CF5AD770999ULL);
+    EXPECT_EQ(DesyncDetector::HashState(data.data(), data.size()), 0x25275608A9CFC168ULL);
+}
+
+TEST(DesyncTest, MatchSyncRoundTripsThroughPacket) {
+    MatchSyncPacket packet;
+    packet.playerId = 3;
+    packet.hashCount = 2;
+    packet.hashes[0].frame = 100;
+    packet.hashes[0].hash = 0x1122334455667788ULL;
+    packet.hashes[1].frame = 101;
+    packet.hashes[1].hash = 0x99AABBCCDDEEFF00ULL;
+    packet.hashes[1].fieldCount = 2;
+    packet.hashes[1].fieldHashes[0] = 7;
+    packet.hashes[1].fieldHashes[1] = 8;
+
+    std::vector<uint8_t> buffer;
+    packet.Serialize(buffer);
+
+    MatchSyncPacket decoded;
+    decoded.Deserialize(buffer.data(), buffer.size());
+    ASSERT_EQ(decoded.hashCount, 2);
+    EXPECT_EQ(decoded.playerId, 3u);
+    EXPECT_EQ(decoded.hashes[0].frame, 100u);
+    EXPECT_EQ(decoded.hashes[0].hash, 0x1122334455667788ULL);
+    EXPECT_EQ(decoded.hashes[0].fieldCount, 0);
+    EXPECT_EQ(decoded.hashes[1].hash, 0x99AABBCCDDEEFF00ULL);
+    ASSERT_EQ(decoded.hashes[1].fieldCount, 2);
+    EXPECT_EQ(decoded.hashes[1].fieldHashes[1], 8u);
+
+    // A truncated tail keeps the complete entries
+    MatchSyncPacket truncated;
+    truncated.Deserialize(buffer.data(), buffer.size() - 4);
+    EXPECT_EQ(truncated.hashCount, 1);
+}
+
+TEST_F(NetworkLoopbackTest, PeersExchangeStateHashes) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+
+    for (uint32_t frame = 1; frame <= 40; ++frame) {
+        host->GetDesyncDetector().RecordLocalHash(frame, frame * 31);
+        client->GetDesyncDetector().RecordLocalHash(frame, frame < 25 ? frame * 31 : frame);
+    }
+
+    ASSERT_TRUE(PumpUntil([&] { return host->GetNetworkStats().desyncDetected; }));
+    EXPECT_EQ(host->GetNetworkStats().desyncFrame, 25u);
+    EXPECT_EQ(host->GetDesyncDetector().GetMatchedChecks(), 24u);
+}
+
+TEST(DesyncTest, HashCostPerFrame) {
+    // Worst case: a snapshot filling a whole rollback slot
+    std::vector<uint8_t> state(RollbackEngine::MAX_STATE_SIZE);
+    for (size_t i = 0; i < state.size(); ++i) {
+        state[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+
+    const int iterations = 20000;
+    uint64_t sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        state[0] = static_cast<uint8_t>(i);
+        sink ^= DesyncDetector::HashState(state.data(), state.size());
+    }
+    double us = std::chrono::duration<double, std::micro>(
+        std::chrono::high_resolution_clock::now() - start).count() / iterations;
+
+    std::cout << "State hash of " << state.size() / 1024 << " KB: " << us << " us ("
+              << state.size() / us / 1000.0 << " GB/s), sink " << (sink & 0xF) << "\n";
+    EXPECT_LT(us, 20.0);
+}
+
+namespace {
+
+// Local stand-in for a network path: every message arrives after a base
+// delay plus uniform jitter, a fixed fraction is dropped, and jitter can
+// reorder them. Deterministic for a given seed.
+template <typename Message>
+class SimulatedLink {
+public:
+    SimulatedLink(double delayMs, double jitterMs, double loss, uint32_t seed)
+        : m_delayMs(delayMs), m_jitterMs(jitterMs), m_loss(loss), m_random(seed) {}
+
+    void Send(double nowMs, const Message& message) {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        if (unit(m_random) < m_loss) {
+            return;
+        }
+        m_inFlight.push(InFlight{nowMs + m_delayMs + m_jitterMs * unit(m_random), message});
+    }
+
+    bool Receive(double nowMs, Message& message) {
+        if (m_inFlight.empty() || m_inFlight.top().arrival > nowMs) {
+            return false;
+        }
+        message = m_inFlight.top().message;
+        m_inFlight.pop();
+        return true;
+    }
+
+private:
+    struct InFlight {
+        double arrival;
+        Message message;
+        bool operator>(const InFlight& other) const { return arrival > other.arrival; }
+    };
+
+    double m_delayMs;
+    double m_jitterMs;
+    double m_loss;
+    std::mt19937 m_random;
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<InFlight>> m_inFlight;
+};
+
+struct TimingMessage {
+    bool pong;
+    double sentAtMs;        // Pinger's clock, echoed back in the Pong
+    uint32_t frame;
+    float advantage;
+};
+
+// One side of a match ticking on its own clock, which may run fast or
+// slow against real time, paced by its TimeSync
+struct SyncedPeer {
+    uint32_t id;
+    uint32_t remoteId;
+    double clockRate;
+    double clockMs = 0.0;
+    double accumulatorMs = 0.0;
+    uint32_t frame = 0;
+    TimeSync sync;
+
+    SyncedPeer(uint32_t playerId, uint32_t remotePlayerId, double rate)
+        : id(playerId), remoteId(remotePlayerId), clockRate(rate) {
+        sync.AddPeer(remoteId);
+    }
+
+    void Step(double realMs, float loss, SimulatedLink<TimingMessage>& out, double realNowMs) {
+        clockMs += realMs * clockRate;
+        accumulatorMs += realMs * clockRate;
+
+        const double frameMs = 1000.0 / NetworkConfig::TICK_RATE;
+        while (accumulatorMs >= frameMs * sync.GetTickScale()) {
+            accumulatorMs -= frameMs * sync.GetTickScale();
+            frame++;
+            sync.SetPacketLoss(remoteId, loss);
+            sync.Update();
+
+            if (frame % NetworkConfig::PING_INTERVAL_TICKS == 0) {
+                out.Send(realNowMs, TimingMessage{false, clockMs, frame, sync.GetFrameAdvantage(remoteId)});
+            }
+        }
+    }
+
+    void Deliver(SimulatedLink<TimingMessage>& in, SimulatedLink<TimingMessage>& out, double realNowMs) {
+        TimingMessage message;
+        while (in.Receive(realNowMs, message)) {
+            if (message.pong) {
+                sync.AddRoundTrip(remoteId, static_cast<float>(clockMs - message.sentAtMs));
+                continue;
+            }
+            sync.AddRemoteFrame(remoteId, frame, message.frame, 0.0f, message.advantage);
+            out.Send(realNowMs, TimingMessage{true, message.sentAtMs, frame, 0.0f});
+        }
+    }
+};
+
+struct LatencyRun {
+    int maxFrameGap = 0;          // After the warmup
+    int finalInputDelay[2] = {};
+    float maxTickScale[2] = {1.0f, 1.0f};
+};
+
+// Runs two peers over a symmetric simulated link for durationMs of real
+// time, in 1 ms steps
+LatencyRun RunLatencyHarness(double oneWayMs, double jitterMs, double loss,
+                             double rateB, uint32_t headStartB, double durationMs,
+                             double warmupMs = 5000.0) {
+    SyncedPeer a(1, 2, 1.0);
+    SyncedPeer b(2, 1, rateB);
+    b.frame = headStartB;
+
+    SimulatedLink<TimingMessage> aToB(oneWayMs, jitterMs, loss, 1);
+    SimulatedLink<TimingMessage> bToA(oneWayMs, jitterMs, loss, 2);
+
+    LatencyRun run;
+    for (double now = 0.0; now < durationMs; now += 1.0) {
+        a.Step(1.0, static_cast<float>(loss), aToB, now);
+        b.Step(1.0, static_cast<float>(loss), bToA, now);
+        a.Deliver(bToA, aToB, now);
+        b.Deliver(aToB, bToA, now);
+
+        if (now >= warmupMs) {
+            int gap = std::abs(static_cast<int>(a.frame) - static_cast<int>(b.frame));
+            run.maxFrameGap = std::max(run.maxFrameGap, gap);
+        }
+        run.maxTickScale[0] = std::max(run.maxTickScale[0], a.sync.GetTickScale());
+        run.maxTickScale[1] = std::max(run.maxTickScale[1], b.sync.GetTickScale());
+    }
+
+    run.finalInputDelay[0] = a.sync.GetInputDelay();
+    run.finalInputDelay[1] = b.sync.GetInputDelay();
+    return run;
+}
+
+} // namespace
+
+TEST(TimeSyncTest, RoundTripAndJitterAreSmoothed) {
+    TimeSync sync;
+    sync.AddRoundTrip(2, 100.0f);
+    EXPECT_FLOAT_EQ(sync.GetRoundTripTime(), 100.0f);
+
+    for (int i = 0; i < 200; ++i) {
+        sync.AddRoundTrip(2, i % 2 ? 90.0f : 110.0f);
+    }
+    EXPECT_NEAR(sync.GetRoundTripTime(), 100.0f, 3.0f);
+    EXPECT_NEAR(sync.GetJitter(), 10.0f, 3.0f);
+}
+
+TEST(TimeSyncTest, InputDelayRaisesFastAndLowersSlowly) {
+    TimeSync sync;
+    EXPECT_EQ(sync.GetInputDelay(), NetworkConfig::INITIAL_INPUT_DELAY);
+
+    // 200 ms: 100 ms flight + 33 ms send wait = 8 frames, 3 hidden by rollback
+    for (int i = 0; i < 20; ++i) sync.AddRoundTrip(2, 200.0f);
+    int ticks = 0;
+    while (sync.GetInputDelay() < 5 && ticks < 1000) {
+        sync.Update();
+        ticks++;
+    }
+    EXPECT_EQ(sync.GetTargetInputDelay(), 5);
+    EXPECT_LE(ticks, 2 * NetworkConfig::INPUT_DELAY_RAISE_TICKS + 1);
+
+    // Link improves: no change before the target has held for a while
+    for (int i = 0; i < 100; ++i) sync.AddRoundTrip(2, 20.0f);
+    sync.Update();
+    EXPECT_EQ(sync.GetTargetInputDelay(), NetworkConfig::MIN_INPUT_DELAY);
+    for (int i = 1; i < NetworkConfig::INPUT_DELAY_LOWER_TICKS - 1; ++i) sync.Update();
+    EXPECT_EQ(sync.GetInputDelay(), 5);
+    for (int i = 0; i < 4 * NetworkConfig::INPUT_DELAY_LOWER_TICKS; ++i) sync.Update();
+    EXPECT_EQ(sync.GetInputDelay(), NetworkConfig::MIN_INPUT_DELAY);
+}
+
+TEST(TimeSyncTest, LossOnlyDelaysTheLinkThatLosesPackets) {
+    // Peer 2 is far away, peer 3 close by
+    TimeSync sync;
+    for (int i = 0; i < 20; ++i) {
+        sync.AddRoundTrip(2, 200.0f);
+        sync.AddRoundTrip(3, 20.0f);
+    }
+    sync.Update();
+    EXPECT_EQ(sync.GetTargetInputDelay(), 5);
+
+    // The near link's loss is covered by its own slack
+    sync.SetPacketLoss(3, 0.2f);
+    sync.Update();
+    EXPECT_EQ(sync.GetTargetInputDelay(), 5);
+    EXPECT_FLOAT_EQ(sync.GetPacketLoss(), 0.2f);
+
+    // The far link needs another send interval
+    sync.SetPacketLoss(3, 0.0f);
+    sync.SetPacketLoss(2, 0.2f);
+    sync.Update();
+    EXPECT_GT(sync.GetTargetInputDelay(), 5);
+}
+
+TEST(TimeSyncTest, OnlyTheLeadingSideSlowsDown) {
+    TimeSync ahead, behind;
+    ahead.AddRoundTrip(2, 0.0f);
+    behind.AddRoundTrip(1, 0.0f);
+    ahead.AddRemoteFrame(2, 110, 100, 0.0f, -10.0f);
+    behind.AddRemoteFrame(1, 100, 110, 0.0f, 10.0f);
+    ahead.Update();
+    behind.Update();
+
+    EXPECT_FLOAT_EQ(ahead.GetFrameAdvantage(), 10.0f);
+    EXPECT_FLOAT_EQ(ahead.GetFrameCorrection(), 10.0f);
+    EXPECT_FLOAT_EQ(ahead.GetTickScale(), 1.0f + NetworkConfig::MAX_TICK_SLOWDOWN);
+    EXPECT_FLOAT_EQ(behind.GetTickScale(), 1.0f);
+}
+
+TEST(TimeSyncTest, DriftingClocksStayWithinOneFrame) {
+    // Peer B's clock runs 1% fast: unsynced it would lead by 36 frames
+    // after a minute
+    LatencyRun run = RunLatencyHarness(30.0, 8.0, 0.05, 1.01, 0, 60000.0);
+
+    std::cout << "Drift 1%, 60+16 ms RTT, 5% loss: max gap " << run.maxFrameGap
+              << " frames, B slowed by up to " << (run.maxTickScale[1] - 1.0f) * 100.0f
+              << "%, input delay " << run.finalInputDelay[0] << "/" << run.finalInputDelay[1] << "\n";
+
+    EXPECT_LE(run.maxFrameGap, 1);
+    EXPECT_GT(run.maxTickScale[1], 1.0f);
+    EXPECT_EQ(run.finalInputDelay[0], run.finalInputDelay[1]);
+}
+
+TEST(TimeSyncTest, LateStarterIsCaughtUp) {
+    // B started 12 frames early; the gap closes within a few seconds
+    LatencyRun run = RunLatencyHarness(50.0, 4.0, 0.0, 1.0, 12, 20000.0, 4000.0);
+    EXPECT_LE(run.maxFrameGap, 1);
+    EXPECT_FLOAT_EQ(run.maxTickScale[1], 1.0f + NetworkConfig::MAX_TICK_SLOWDOWN);
+    // The side that was behind corrects a small overshoot at most
+    EXPECT_LT(run.maxTickScale[0], 1.0f + NetworkConfig::MAX_TICK_SLOWDOWN / 2.0f);
+}
+
+TEST(TimeSyncTest, InputDelayTracksLinkLatency) {
+    LatencyRun lan = RunLatencyHarness(5.0, 1.0, 0.0, 1.0, 0, 10000.0);
+    LatencyRun far = RunLatencyHarness(90.0, 10.0, 0.0, 1.0, 0, 10000.0);
+
+    EXPECT_EQ(lan.finalInputDelay[0], NetworkConfig::MIN_INPUT_DELAY);
+    EXPECT_GE(far.finalInputDelay[0], 5);
+    EXPECT_LE(far.finalInputDelay[0], 7);
+}
+
+TEST_F(NetworkLoopbackTest, PingsSettleInputDelayOnFastLink) {
+    ASSERT_TRUE(PumpUntil([&] { return client->GetConnectionState() == ConnectionState::Connected; }));
+    EXPECT_EQ(client->GetInputDelay(), NetworkConfig::INITIAL_INPUT_DELAY);
+
+    // Loopback is far inside the rollback budget, so the delay drops to
+    // the minimum one step at a time
+    ASSERT_TRUE(PumpUntil([&] {
+        return host->GetInputDelay() == NetworkConfig::MIN_INPUT_DELAY &&
+               client->GetInputDelay() == NetworkConfig::MIN_INPUT_DELAY;
+    }, 1000));
+
+    EXPECT_EQ(client->GetNetworkStats().inputDelay, NetworkConfig::MIN_INPUT_DELAY);
+    EXPECT_LT(std::abs(client->GetNetworkStats().frameAdvantage), 1.0f);
+    EXPECT_LT(host->GetTickScale(), 1.01f);
+}
+
+// Packet Pool Tests
+namespace {
+
+// Scripted 8-player DeathMatch over loopback: every player sends its input
+// each tick and its state each send tick, and the host confirms a hit
+// twice a second. Returns heap allocations per simulated second, counted
+// across all eight peers and their network threads after warm-up.
+double RunDeathMatchAllocations(int warmupTicks, int measuredTicks) {
+    const float tickInterval = 1.0f / NetworkConfig::TICK_RATE;
+
+    std::vector<std::unique_ptr<NetworkManager>> peers;
+    peers.push_back(std::make_unique<NetworkManager>());
+    peers[0]->Initialize();
+    peers[0]->StartHost(0);
+    for (int i = 1; i < 8; ++i) {
+        peers.push_back(std::make_unique<NetworkManager>());
+        peers[i]->Initialize();
+        peers[i]->ConnectToHost("127.0.0.1", peers[0]->GetLocalPort());
+    }
+
+    for (int attempt = 0; attempt < 500 && peers[0]->GetPlayerCount() < 8; ++attempt) {
+        for (auto& peer : peers) peer->Update(tickInterval);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(peers[0]->GetPlayerCount(), 8);
+
+    peers[0]->CreateMatch("deathmatch", 1, 0);
+    peers[0]->StartMatch();
+
+    size_t allocationsBefore = 0;
+    for (int tick = 0; tick < warmupTicks + measuredTicks; ++tick) {
+        if (tick == warmupTicks) {
+            allocationsBefore = g_allocationCount.load();
+        }
+
+        uint32_t frame = static_cast<uint32_t>(tick);
+        for (auto& peer : peers) {
+            uint32_t mask = (frame / 12 + peer->GetLocalPlayerId()) % 4 == 0 ? 0x11u : 0x2u;
+            peer->SendInput(frame, mask, static_cast<uint16_t>(frame));
+
+            if (tick % 2 == 0) {
+                PlayerStatePacket state = MakePlayerState(peer->GetLocalPlayerId());
+                state.position[0] = static_cast<float>(tick) * 0.25f;
+                peer->SendPlayerState(state);
+            }
+        }
+
+        if (tick % 30 == 0) {
+            uint32_t targetId = 2 + (frame / 30) % 7;
+
+            auto attack = peers[0]->CreatePacket<AttackPacket>();
+            attack->attackerId = 1;
+            attack->targetId = targetId;
+            peers[0]->SendPacket(std::move(attack), true);
+
+            auto damage = peers[0]->CreatePacket<DamagePacket>();
+            damage->targetId = targetId;
+            peers[0]->SendPacket(std::move(damage), true);
+        }
+
+        for (auto& peer : peers) peer->Update(tickInterval);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    size_t allocations = g_allocationCount.load() - allocationsBefore;
+    return static_cast<double>(allocations) * NetworkConfig::TICK_RATE / measuredTicks;
+}
+
+// The packets RunDeathMatchAllocations creates, without the sockets: per
+// tick each player's input and, every other tick, its state, each sent
+// once and decoded by the seven other peers, plus an attack and a damage
+// packet twice a second. create(std::type_identity<T>) makes one packet,
+// with make_shared as before the pool or from a pool; held keeps a tick's
+// packets alive. Returns heap allocations per simulated second.
+template <typename Holder, typename Create>
+double RunDeathMatchPacketAllocations(int measuredTicks, Holder& held, Create&& create) {
+    const int players = 8;
+    size_t allocationsBefore = 0;
+    for (int tick = 0; tick < measuredTicks + 1; ++tick) {
+        if (tick == 1) {
+            allocationsBefore = g_allocationCount.load();   // After warm-up
+        }
+
+        for (int copy = 0; copy < players * players; ++copy) {
+            held.push_back(create(std::type_identity<InputPacket>{}));
+            if (tick % 2 == 0) held.push_back(create(std::type_identity<PlayerStatePacket>{}));
+        }
+        if (tick % 30 == 0) {
+            for (int copy = 0; copy < players; ++copy) {
+                held.push_back(create(std::type_identity<AttackPacket>{}));
+                held.push_back(create(std::type_identity<DamagePacket>{}));
+            }
+        }
+        held.clear();
+    }
+
+    size_t allocations = g_allocationCount.load() - allocationsBefore;
+    return static_cast<double>(allocations) * NetworkConfig::TICK_RATE / measuredTicks;
+}
+
+} // namespace
+
+TEST(PacketPoolTest, ReusesSlotsWithoutAllocating) {
+    PacketPool pool;
+    const void* first = pool.Acquire<InputPacket>().get();
+
+    size_t allocationsBefore = g_allocationCount.load();
+    for (int i = 0; i < 1000; ++i) {
+        auto input = pool.Acquire<InputPacket>();
+        input->SetSingleInput(static_cast<uint32_t>(i), 0x1);
+        PacketPtr packet = std::move(input);
+        EXPECT_EQ(packet.get(), first);
+    }
+    auto ping = PacketFactory::CreatePacket(PacketType::Ping, pool);
+    EXPECT_EQ(ping->GetType(), PacketType::Ping);
+
+    EXPECT_EQ(g_allocationCount.load() - allocationsBefore, 0u);
+    EXPECT_EQ(pool.GetHeapFallbacks(), 0u);
+}
+
+TEST(PacketPoolTest, FallsBackToHeapWhenExhausted) {
+    PacketPool pool(2);
+    const size_t inputIndex = PacketPool::TypeIndex<InputPacket>();
+    {
+        auto a = pool.Acquire<InputPacket>();
+        auto b = pool.Acquire<InputPacket>();
+        auto c = pool.Acquire<InputPacket>();
+        EXPECT_EQ(pool.GetFreeCount(inputIndex), 0u);
+        EXPECT_EQ(pool.GetHeapFallbacks(), 1u);
+
+        // Other classes have their own slab
+        auto state = pool.Acquire<PlayerStatePacket>();
+        EXPECT_EQ(pool.GetHeapFallbacks(), 1u);
+    }
+    EXPECT_EQ(pool.GetFreeCount(inputIndex), 2u);
+}
+
+TEST(PacketPoolTest, ReleasesFromAnotherThreadComeBack) {
+    PacketPool pool(4);
+    std::vector<PacketPtr> packets;
+    for (int i = 0; i < 4; ++i) {
+        packets.push_back(pool.Acquire<DeltaStatePacket>());
+    }
+
+    // As the game thread drops packets the network thread decoded
+    std::thread consumer([&] { packets.clear(); });
+    consumer.join();
+
+    for (int i = 0; i < 4; ++i) {
+        packets.push_back(pool.Acquire<DeltaStatePacket>());
+    }
+    EXPECT_EQ(pool.GetHeapFallbacks(), 0u);
+}
+
+TEST(PacketPoolTest, PooledDatagramDecodeMatchesHeapPath) {
+    SendArena arena;
+    InputPacket input;
+    input.playerId = 4;
+    input.SetSingleInput(30, 0x9);
+    SystemPacket ack(PacketType::Acknowledge);
+    ack.payload = 77;
+    arena.Write(input);
+    arena.Write(ack);
+
+    PacketPool pool;
+    std::vector<PacketPtr> packets;
+    ASSERT_EQ(PacketFactory::CreateFromData(arena.GetDatagramData(0), arena.GetDatagramSize(0), packets, pool), 2u);
+    EXPECT_EQ(static_cast<InputPacket*>(packets[0].get())->inputMask, 0x9u);
+    EXPECT_EQ(static_cast<SystemPacket*>(packets[1].get())->payload, 77u);
+}
+
+TEST(PacketPoolTest, DeathMatchAllocationsPerSecond) {
+    double allocationsPerSecond = RunDeathMatchAllocations(120, 600);
+
+    // The same packets, made the old way and the pooled way
+    std::vector<std::shared_ptr<NetworkPacket>> shared;
+    shared.reserve(256);
+    double sharedPerSecond = RunDeathMatchPacketAllocations(600, shared,
+        [](auto type) -> std::shared_ptr<NetworkPacket> {
+            return std::make_shared<typename decltype(type)::type>();
+        });
+
+    PacketPool pool;
+    std::vector<PacketPtr> pooled;
+    pooled.reserve(256);
+    double pooledPerSecond = RunDeathMatchPacketAllocations(600, pooled,
+        [&pool](auto type) -> PacketPtr { return pool.Acquire<typename decltype(type)::type>(); });
+
+    std::cout << "8-player DeathMatch: " << allocationsPerSecond << " allocs/s end to end\n";
+    std::cout << "packets only, make_shared: " << sharedPerSecond << " allocs/s\n";
+    std::cout << "packets only, pool:        " << pooledPerSecond << " allocs/s\n";
+
+    EXPECT_LT(allocationsPerSecond, 100.0);
+    EXPECT_EQ(pooledPerSecond, 0.0);
+    EXPECT_GT(sharedPerSecond, 1000.0);
+}
+
+// Replay Tests
+namespace {
+
+ReplayHeader TwoPlayerReplayHeader() {
+    ReplayHeader header;
+    header.matchId = 42;
+    header.gameMode = 1;
+    header.stageId = 3;
+    header.randomSeed = 0xDEADBEEF;
+    header.playerCount = 2;
+    header.playerIds[0] = 1;
+    header.playerIds[1] = 2;
+    return header;
+}
+
+// Writes both players' inputs frame by frame; returns the stream
+std::string WriteReplay(const std::vector<uint32_t>& first, const std::vector<uint32_t>& second, bool finish) {
+    std::ostringstream out;
+    ReplayWriter writer(out);
+    EXPECT_TRUE(writer.Begin(TwoPlayerReplayHeader()));
+    for (size_t i = 0; i < first.size(); ++i) {
+        uint32_t inputs[2] = { first[i], second[i] };
+        writer.AddFrame(inputs);
+    }
+    if (finish) {
+        writer.Finish();
+        EXPECT_EQ(writer.GetBytesWritten(), out.str().size());
+    }
+    return out.str();
+}
+
+} // namespace
+
+TEST(ReplayTest, RoundTripsHeaderAndInputs) {
+    std::vector<uint32_t> first = ComboPlayerInputs(1, 3000);
+    std::vector<uint32_t> second = RandomHoldInputs(2, 3000);
+    second[0] = 0;   // Both unchanged on the first frame
+    std::istringstream in(WriteReplay(first, second, true));
+
+    ReplayReader reader(in);
+    ASSERT_TRUE(reader.Open());
+    const ReplayHeader& header = reader.GetHeader();
+    EXPECT_EQ(header.matchId, 42u);
+    EXPECT_EQ(header.gameMode, 1);
+    EXPECT_EQ(header.stageId, 3);
+    EXPECT_EQ(header.randomSeed, 0xDEADBEEFu);
+    EXPECT_EQ(header.startFrame, 1u);
+    ASSERT_EQ(header.playerCount, 2);
+    EXPECT_EQ(header.playerIds[1], 2u);
+
+    uint32_t inputs[2];
+    for (size_t i = 0; i < first.size(); ++i) {
+        ASSERT_TRUE(reader.NextFrame(inputs)) << "frame " << i;
+        ASSERT_EQ(inputs[0], first[i]) << "frame " << i;
+        ASSERT_EQ(inputs[1], second[i]) << "frame " << i;
+    }
+    EXPECT_FALSE(reader.NextFrame(inputs));
+    EXPECT_TRUE(reader.IsComplete());
+    EXPECT_EQ(reader.GetFrameCount(), 3000u);
+    EXPECT_FALSE(reader.GetFinalStateHash().has_value());
+}
+
+TEST(ReplayTest, RecordedMatchPlaysBackToTheSameState) {
+    const uint32_t frames = 600;
+    const uint32_t latency = 5;
+
+    // Record the confirmed inputs of a match that rolls back regularly
+    ArenaPeer peer;
+    std::ostringstream out;
+    ReplayWriter writer(out);
+    ASSERT_TRUE(writer.Begin(TwoPlayerReplayHeader()));
+    SeedSimulationRandom(TwoPlayerReplayHeader().randomSeed);
+    peer.engine.AttachReplayWriter(&writer);
+
+    for (uint32_t frame = 1; frame <= frames + latency; ++frame) {
+        if (frame > latency) {
+            AddConfirmedInput(peer.remote, frame - latency, ScriptedInput(1, frame - latency));
+        }
+        AddConfirmedInput(peer.local, frame, ScriptedInput(0, frame));
+        peer.engine.AdvanceFrame();
+    }
+    EXPECT_GT(peer.engine.GetStats().rollbacks, 0u);
+
+    // The last frames are still predicted, so they are left out
+    uint32_t recorded = writer.GetFrameCount();
+    EXPECT_LT(recorded, frames + latency);
+    EXPECT_GE(recorded, frames);
+    peer.engine.FinishReplay();
+
+    std::istringstream in(out.str());
+    ReplayReader reader(in);
+    ASSERT_TRUE(reader.Open());
+    ArenaSimulation playback;
+    ReplayResult result = PlayReplay(reader, playback);
+    EXPECT_EQ(result.frames, recorded);
+    EXPECT_TRUE(result.complete);
+    EXPECT_TRUE(result.verified);
+
+    // The same frames simulated straight from the script
+    ArenaSimulation reference;
+    SeedSimulationRandom(TwoPlayerReplayHeader().randomSeed);
+    for (uint32_t frame = 1; frame <= recorded; ++frame) {
+        uint32_t inputs[2] = { ScriptedInput(0, frame), ScriptedInput(1, frame) };
+        reference.AdvanceFrame(inputs, 2);
+    }
+    EXPECT_EQ(std::memcmp(&playback.GetState(), &reference.GetState(), sizeof(ArenaSimulation::State)), 0);
+}
+
+TEST(ReplayTest, TruncatedStreamPlaysItsWholeRecords) {
+    std::vector<uint32_t> first = ComboPlayerInputs(5, 1000);
+    std::vector<uint32_t> second = ComboPlayerInputs(6, 1000);
+    std::string replay = WriteReplay(first, second, false);
+
+    // As left behind by a crash, cut in the middle of a record
+    std::istringstream in(replay.substr(0, replay.size() * 2 / 3 + 1));
+    ReplayReader reader(in);
+    ASSERT_TRUE(reader.Open());
+
+    uint32_t inputs[2];
+    uint32_t frames = 0;
+    while (reader.NextFrame(inputs)) {
+        ASSERT_EQ(inputs[0], first[frames]);
+        ASSERT_EQ(inputs[1], second[frames]);
+        frames++;
+    }
+    EXPECT_GT(frames, 500u);
+    EXPECT_LT(frames, 1000u);
+    EXPECT_FALSE(reader.IsComplete());
+
+    std::istringstream garbage("DFRX");
+    ReplayReader wrongMagic(garbage);
+    EXPECT_FALSE(wrongMagic.Open());
+}
+
+TEST(ReplayTest, NinetyNineSecondRoundSize) {
+    const size_t frames = 99 * NetworkConfig::TICK_RATE;
+
+    size_t comboBytes = WriteReplay(ComboPlayerInputs(7, frames), ComboPlayerInputs(8, frames), true).size();
+    size_t holdBytes = WriteReplay(RandomHoldInputs(7, frames), RandomHoldInputs(8, frames), true).size();
+    std::cout << "99 s round, " << frames << " frames: " << comboBytes << " bytes of combos, "
+              << holdBytes << " bytes of held inputs (raw masks: " << frames * 2 * sizeof(uint32_t) << ")\n";
+
+    EXPECT_LT(comboBytes, 20u * 1024u);
+    EXPECT_LT(holdBytes, 20u * 1024u);
+}
+
+// Spectator Relay Tests
+namespace {
+
+const UdpEndpoint SPECTATOR_ENDPOINTS[] = { { 0x7F000001, 7001 }, { 0x7F000001, 7002 } };
+
+// Hands the datagrams addressed to endpoint to feed, except the one at
+// index skip
+void Deliver(const std::vector<UdpDatagram>& datagrams, const UdpEndpoint& endpoint,
+             SpectatorFeed& feed, size_t skip = SIZE_MAX) {
+    size_t index = 0;
+    for (const UdpDatagram& datagram : datagrams) {
+        if (datagram.endpoint != endpoint) {
+            continue;
+        }
+        if (index++ != skip) {
+            feed.Receive(datagram.data, datagram.size);
+        }
+    }
+}
+
+// The scripted match from frame 1 up to, but not including, endFrame
+ArenaSimulation::State ScriptedState(uint32_t endFrame) {
+    ArenaSimulation reference;
+    for (uint32_t frame = 1; frame < endFrame; ++frame) {
+        uint32_t inputs[2] = { ScriptedInput(0, frame), ScriptedInput(1, frame) };
+        reference.AdvanceFrame(inputs, 2);
+    }
+    return reference.GetState();
+}
+
+} // namespace
+
+TEST(SpectatorRelayTest, LateJoinerCatchesUpFromKeyframe) {
+    const uint32_t frames = 600;
+    const uint32_t latency = 5;
+
+    SpectatorConfig config;
+    config.delayFrames = 60;
+    config.keyframeInterval = 120;
+    SpectatorRelay relay(config);
+    ASSERT_TRUE(relay.Begin(TwoPlayerReplayHeader()));
+
+    ArenaPeer peer;
+    peer.engine.AttachSpectatorRelay(&relay);
+    relay.AddSpectator(1, SPECTATOR_ENDPOINTS[0]);
+
+    SpectatorFeed early;
+    SpectatorFeed late;
+    ArenaSimulation earlyView;
+    ArenaSimulation lateView;
+
+    for (uint32_t frame = 1; frame <= frames + latency; ++frame) {
+        if (frame > latency) {
+            AddConfirmedInput(peer.remote, frame - latency, ScriptedInput(1, frame - latency));
+        }
+        if (frame <= frames) {
+            AddConfirmedInput(peer.local, frame, ScriptedInput(0, frame));
+        }
+        peer.engine.AdvanceFrame();
+        if (frame == 400) {
+            relay.AddSpectator(2, SPECTATOR_ENDPOINTS[1]);
+        }
+
+        const std::vector<UdpDatagram>& datagrams = relay.CollectDatagrams();
+        Deliver(datagrams, SPECTATOR_ENDPOINTS[0], early);
+        Deliver(datagrams, SPECTATOR_ENDPOINTS[1], late);
+        early.CatchUp(earlyView);
+        late.CatchUp(lateView);
+
+        // Nothing newer than the delay allows
+        uint32_t played = early.GetNextFrame() - 1;
+        ASSERT_LE(played + config.delayFrames, std::max(relay.GetNextFrame() - 1, config.delayFrames));
+    }
+    EXPECT_GT(peer.engine.GetStats().rollbacks, 0u);
+    EXPECT_GE(late.GetNextFrame(), 400u - config.delayFrames - config.keyframeInterval);
+
+    relay.Finish();
+    for (uint32_t tick = 0; tick <= config.delayFrames && !(early.IsFinished() && late.IsFinished()); ++tick) {
+        const std::vector<UdpDatagram>& datagrams = relay.CollectDatagrams();
+        Deliver(datagrams, SPECTATOR_ENDPOINTS[0], early);
+        Deliver(datagrams, SPECTATOR_ENDPOINTS[1], late);
+        early.CatchUp(earlyView);
+        late.CatchUp(lateView);
+    }
+    ASSERT_TRUE(early.IsFinished());
+    ASSERT_TRUE(late.IsFinished());
+    EXPECT_EQ(relay.GetStats().catchUps, 2u);
+
+    ArenaSimulation::State expected = ScriptedState(relay.GetNextFrame());
+    EXPECT_EQ(std::memcmp(&earlyView.GetState(), &expected, sizeof(expected)), 0);
+    EXPECT_EQ(std::memcmp(&lateView.GetState(), &expected, sizeof(expected)), 0);
+}
+
+TEST(SpectatorRelayTest, LostBlockResyncsFromKeyframe) {
+    const uint32_t frames = 900;
+
+    SpectatorConfig config;
+    config.delayFrames = 30;
+    config.keyframeInterval = 120;
+    SpectatorRelay relay(config);
+    ASSERT_TRUE(relay.Begin(TwoPlayerReplayHeader()));
+    relay.AddSpectator(1, SPECTATOR_ENDPOINTS[0]);
+
+    ArenaSimulation source;
+    SpectatorFeed feed;
+    ArenaSimulation view;
+    uint8_t state[RollbackEngine::MAX_STATE_SIZE];
+    bool lost = false;
+
+    for (uint32_t frame = 1; frame <= frames; ++frame) {
+        if (relay.WantsKeyframe(frame)) {
+            relay.AddKeyframe(frame, state, source.SaveState(state, sizeof(state)));
+        }
+        uint32_t inputs[2] = { ScriptedInput(0, frame), ScriptedInput(1, frame) };
+        relay.AddFrame(inputs);
+        source.AdvanceFrame(inputs, 2);
+
+        // One block goes missing on the way
+        const std::vector<UdpDatagram>& datagrams = relay.CollectDatagrams();
+        bool drop = frame == 300 && !datagrams.empty();
+        Deliver(datagrams, SPECTATOR_ENDPOINTS[0], feed, drop ? 0 : SIZE_MAX);
+        lost |= drop;
+
+        if (feed.NeedsResync()) {
+            relay.Resync(1);
+        }
+        feed.CatchUp(view);
+    }
+    ASSERT_TRUE(lost);
+    EXPECT_FALSE(feed.NeedsResync());
+    EXPECT_EQ(relay.GetStats().catchUps, 2u);
+
+    // Caught up again, and playing what the source played
+    uint32_t released = relay.GetReleasedFrame();
+    EXPECT_GE(feed.GetNextFrame() + config.framesPerBlock, released + 1);
+    ArenaSimulation::State expected = ScriptedState(feed.GetNextFrame());
+    EXPECT_EQ(std::memcmp(&view.GetState(), &expected, sizeof(expected)), 0);
+}
+
+// A tournament final: the relay's cost per tick with 500 spectators
+// against one, not counting the sendmmsg calls themselves
+TEST(SpectatorRelayTest, FiveHundredSpectatorsCostAboutOne) {
+    const size_t frames = 99 * NetworkConfig::TICK_RATE;
+    std::vector<uint32_t> first = ComboPlayerInputs(11, frames);
+    std::vector<uint32_t> second = ComboPlayerInputs(12, frames);
+
+    // Saved states of a real match, as the keyframes would see them
+    ArenaSimulation source;
+    std::vector<std::vector<uint8_t>> states(frames + 1);
+    for (size_t i = 0; i < frames; ++i) {
+        states[i].resize(RollbackEngine::MAX_STATE_SIZE);
+        states[i].resize(source.SaveState(states[i].data(), states[i].size()));
+        uint32_t inputs[2] = { first[i], second[i] };
+        source.AdvanceFrame(inputs, 2);
+    }
+
+    auto runBroadcast = [&](uint32_t spectators, SpectatorRelayStats& stats) {
+        SpectatorRelay relay;
+        relay.Begin(TwoPlayerReplayHeader());
+        for (uint32_t id = 1; id <= spectators; ++id) {
+            relay.AddSpectator(id, UdpEndpoint{ 0x0A000000 + id, 7000 });
+        }
+
+        size_t datagrams = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < frames; ++i) {
+            uint32_t frame = static_cast<uint32_t>(i + 1);
+            if (relay.WantsKeyframe(frame)) {
+                relay.AddKeyframe(frame, states[i].data(), states[i].size());
+            }
+            uint32_t inputs[2] = { first[i], second[i] };
+            relay.AddFrame(inputs);
+            datagrams += relay.CollectDatagrams().size();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        stats = relay.GetStats();
+        EXPECT_EQ(stats.datagramsQueued, datagrams);
+        return std::chrono::duration<double, std::micro>(elapsed).count() / frames;
+    };
+
+    SpectatorRelayStats one;
+    SpectatorRelayStats crowd;
+    double oneUs = runBroadcast(1, one);
+    double crowdUs = runBroadcast(500, crowd);
+    std::cout << "Spectator relay, 99 s: 1 spectator " << oneUs << " us/tick, 500 spectators "
+              << crowdUs << " us/tick; " << one.bytesEncoded << " bytes encoded, "
+              << crowd.datagramsQueued / frames << " datagrams/tick to the crowd\n";
+
+    // Encoded once, however many watch
+    EXPECT_EQ(crowd.bytesEncoded, one.bytesEncoded);
+    EXPECT_EQ(crowd.blocksEncoded, one.blocksEncoded);
+    EXPECT_EQ(crowd.datagramsQueued, one.datagramsQueued * 500);
+    EXPECT_LT(crowdUs, 20.0);
+}
+
+
+// Reliability Tests
+namespace {
+
+// One datagram from one peer's connection to the other's: shared bytes,
+// then the sender's due reliable messages and ack trailer. Whatever the
+// receiver would handle, in order, ends up in handled.
+size_t Transfer(ReliableConnection& from, ReliableConnection& to, uint32_t nowMs, bool lost,
+                std::vector<PacketPtr>& handled, PacketPool& pool, const NetworkPacket* shared = nullptr) {
+    uint8_t datagram[NetworkConfig::PACKET_SIZE_LIMIT];
+    size_t size = shared ? shared->Serialize(datagram, ReliableConnection::MAX_MESSAGE_SIZE) : 0;
+    size += from.WriteDue(datagram + size, ReliableConnection::MAX_MESSAGE_SIZE - size, nowMs);
+    if (from.HasAcks()) {
+        from.WriteAcks(datagram + size);
+        size += ReliableConnection::ACK_SIZE;
+    }
+    if (lost || size == 0) {
+        return size;
+    }
+
+    if (const uint8_t* acks = ReliableConnection::FindAckTrailer(datagram, size)) {
+        to.ReadAcks(acks, nowMs);
+    }
+
+    std::vector<PacketPtr> packets;
+    PacketFactory::CreateFromData(datagram, size, packets, pool);
+    for (PacketPtr& packet : packets) {
+        if (packet->HasFlag(PacketFlags::Reliable) &&
+            to.Receive(packet) != ReliableConnection::Arrival::Deliver) {
+            continue;
+        }
+        handled.push_back(std::move(packet));
+
+        PacketPtr ready;
+        while (to.PopReady(ready)) {
+            handled.push_back(std::move(ready));
+        }
+    }
+    return size;
+}
+
+// SystemPackets numbered by payload; PlayerLeft stands in for ordered
+// messages and Acknowledge for unordered ones
+SystemPacket Message(PacketType type, uint32_t payload, bool ordered) {
+    SystemPacket packet(type);
+    packet.payload = payload;
+    if (ordered) {
+        packet.AddFlag(PacketFlags::Ordered);
+    }
+    return packet;
+}
+
+uint32_t PayloadOf(const PacketPtr& packet) {
+    return static_cast<const SystemPacket*>(packet.get())->payload;
+}
+
+} // namespace
+
+TEST(ReliableConnectionTest, AcksAddSixBytesAndSplitIgnoresThem) {
+    PacketPool pool;
+    ReliableConnection host;
+    ReliableConnection client;
+    std::vector<PacketPtr> handled;
+
+    SystemPacket start = Message(PacketType::PlayerLeft, 1, true);
+    ASSERT_TRUE(host.Add(start, 0));
+    Transfer(host, client, 0, false, handled, pool);
+    ASSERT_EQ(handled.size(), 1u);
+
+    // The client's next input carries the ack and nothing else extra
+    InputPacket input;
+    input.SetSingleInput(5, 0x3);
+    uint8_t bare[NetworkConfig::PACKET_SIZE_LIMIT];
+    size_t bareSize = input.Serialize(bare, sizeof(bare));
+    EXPECT_EQ(ReliableConnection::FindAckTrailer(bare, bareSize), nullptr);
+
+    handled.clear();
+    size_t size = Transfer(client, host, 30, false, handled, pool, &input);
+    EXPECT_EQ(size, bareSize + ReliableConnection::ACK_SIZE);
+    ASSERT_EQ(handled.size(), 1u);
+    EXPECT_EQ(handled[0]->GetType(), PacketType::InputCommand);
+    EXPECT_EQ(host.GetPendingCount(ReliableChannel::Ordered), 0u);
+    EXPECT_FLOAT_EQ(host.GetRoundTrip(), 30.0f);
+}
+
+TEST(ReliableConnectionTest, LostMessageIsResentOnTimeout) {
+    PacketPool pool;
+    ReliableConnection host;
+    ReliableConnection client;
+    std::vector<PacketPtr> handled;
+
+    // Time a first round trip of 40ms
+    SystemPacket first = Message(PacketType::PlayerLeft, 1, true);
+    host.Add(first, 0);
+    Transfer(host, client, 0, false, handled, pool);
+    Transfer(client, host, 40, false, handled, pool);
+    uint32_t timeout = host.GetResendTimeout();
+    EXPECT_GE(timeout, 40u);
+    EXPECT_LT(timeout, ReliableConnection::INITIAL_TIMEOUT_MS);
+
+    SystemPacket second = Message(PacketType::Disconnect, 2, true);
+    host.Add(second, 100);
+    Transfer(host, client, 100, true, handled, pool);
+    EXPECT_FALSE(host.HasDue(100 + timeout - 1));
+    EXPECT_TRUE(host.HasDue(100 + timeout));
+
+    Transfer(host, client, 100 + timeout, false, handled, pool);
+    Transfer(client, host, 130 + timeout, false, handled, pool);
+    ASSERT_EQ(handled.size(), 2u);
+    EXPECT_EQ(PayloadOf(handled[1]), 2u);
+    EXPECT_EQ(host.GetPendingCount(ReliableChannel::Ordered), 0u);
+    EXPECT_EQ(host.GetStats().resends, 1u);
+
+    // With the ack lost instead, the resend is a duplicate and dropped
+    SystemPacket third = Message(PacketType::PlayerLeft, 3, true);
+    host.Add(third, 400);
+    Transfer(host, client, 400, false, handled, pool);
+    Transfer(client, host, 430, true, handled, pool);
+    Transfer(host, client, 400 + host.GetResendTimeout(), false, handled, pool);
+    EXPECT_EQ(handled.size(), 3u);
+    EXPECT_EQ(client.GetStats().duplicates, 1u);
+    EXPECT_EQ(host.GetStats().resends, 2u);
+}
+
+TEST(ReliableConnectionTest, LostUnorderedMessageBlocksNeitherInputsNorOrderedOnes) {
+    PacketPool pool;
+    ReliableConnection host;
+    ReliableConnection client;
+    std::vector<PacketPtr> handled;
+    InputPacket input;
+
+    SystemPacket unordered = Message(PacketType::Acknowledge, 10, false);
+    host.Add(unordered, 0);
+    Transfer(host, client, 0, true, handled, pool, &input);
+
+    // The next tick's input and ordered message go straight through
+    SystemPacket start = Message(PacketType::PlayerLeft, 20, true);
+    host.Add(start, 33);
+    Transfer(host, client, 33, false, handled, pool, &input);
+    ASSERT_EQ(handled.size(), 2u);
+    EXPECT_EQ(handled[0]->GetType(), PacketType::InputCommand);
+    EXPECT_EQ(PayloadOf(handled[1]), 20u);
+
+    // Now an ordered message is lost: the one after it waits, while
+    // unordered messages do not
+    handled.clear();
+    SystemPacket lostOrdered = Message(PacketType::PlayerLeft, 21, true);
+    host.Add(lostOrdered, 66);
+    Transfer(host, client, 66, true, handled, pool);
+
+    SystemPacket nextOrdered = Message(PacketType::PlayerLeft, 22, true);
+    SystemPacket nextUnordered = Message(PacketType::Acknowledge, 11, false);
+    host.Add(nextOrdered, 99);
+    host.Add(nextUnordered, 99);
+    Transfer(host, client, 99, false, handled, pool, &input);
+
+    ASSERT_EQ(handled.size(), 2u);
+    EXPECT_EQ(handled[0]->GetType(), PacketType::InputCommand);
+    EXPECT_EQ(PayloadOf(handled[1]), 11u);
+    EXPECT_EQ(client.GetStats().heldBack, 1u);
+
+    // Both lost messages are resent once their timeouts run out
+    handled.clear();
+    Transfer(host, client, 66 + ReliableConnection::INITIAL_TIMEOUT_MS, false, handled, pool);
+    ASSERT_EQ(handled.size(), 3u);
+    EXPECT_EQ(PayloadOf(handled[0]), 10u);
+    EXPECT_EQ(PayloadOf(handled[1]), 21u);
+    EXPECT_EQ(PayloadOf(handled[2]), 22u);
+}
+
+TEST(ReliableConnectionTest, LossyLinkDeliversEachMessageOnceInOrder) {
+    PacketPool pool;
+    ReliableConnection host;
+    ReliableConnection client;
+    DeterministicRandom random(20);
+    std::vector<PacketPtr> handled;
+    std::vector<PacketPtr> unused;
+
+    const uint32_t TICKS = 600;
+    uint32_t added = 0;
+    for (uint32_t tick = 0; tick < TICKS; ++tick) {
+        uint32_t nowMs = tick * 33;
+        if (tick < TICKS - 120 && tick % 3 == 0) {
+            SystemPacket ordered = Message(PacketType::PlayerLeft, added++, true);
+            SystemPacket unordered = Message(PacketType::Acknowledge, added++, false);
+            ASSERT_TRUE(host.Add(ordered, nowMs));
+            ASSERT_TRUE(host.Add(unordered, nowMs));
+        }
+
+        // 30% loss each way
+        Transfer(host, client, nowMs, random.NextChance(30), handled, pool);
+        Transfer(client, host, nowMs + 15, random.NextChance(30), unused, pool);
+    }
+
+    EXPECT_EQ(host.GetPendingCount(ReliableChannel::Ordered), 0u);
+    EXPECT_EQ(host.GetPendingCount(ReliableChannel::Unordered), 0u);
+    EXPECT_GT(host.GetStats().resends, 0u);
+
+    std::vector<uint32_t> ordered;
+    std::vector<uint32_t> unordered;
+    for (const PacketPtr& packet : handled) {
+        (packet->GetType() == PacketType::PlayerLeft ? ordered : unordered).push_back(PayloadOf(packet));
+    }
+    ASSERT_EQ(ordered.size() + unordered.size(), added);
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        EXPECT_EQ(ordered[i], i * 2);
+    }
+    std::sort(unordered.begin(), unordered.end());
+    for (size_t i = 0; i < unordered.size(); ++i) {
+        EXPECT_EQ(unordered[i], i * 2 + 1);
+    }
+}
+
+} // namespace Tests
+} // namespace ArenaFighter
@@ -0,0 +1,195 @@
+#include "TimeSync.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ArenaFighter {
+
+namespace {
+
+constexpr float FRAME_MS = 1000.0f / NetworkConfig::TICK_RATE;
+constexpr float SEND_INTERVAL_MS = 1000.0f / NetworkConfig::SEND_RATE;
+
+// Advantage samples arrive four times a second; heavier smoothing lags
+// enough to make the correction overshoot
+constexpr float ADVANTAGE_SMOOTHING = 0.5f;
+
+} // namespace
+
+TimeSync::TimeSync()
+    : m_inputDelay(NetworkConfig::INITIAL_INPUT_DELAY)
+    , m_targetInputDelay(NetworkConfig::INITIAL_INPUT_DELAY)
+    , m_ticksBelowTarget(0)
+    , m_ticksSinceChange(0)
+    , m_tickScale(1.0f) {
+}
+
+void TimeSync::AddPeer(uint32_t playerId) {
+    m_peers.try_emplace(playerId);
+}
+
+void TimeSync::RemovePeer(uint32_t playerId) {
+    m_peers.erase(playerId);
+}
+
+void TimeSync::Reset() {
+    m_peers.clear();
+    m_inputDelay = NetworkConfig::INITIAL_INPUT_DELAY;
+    m_targetInputDelay = NetworkConfig::INITIAL_INPUT_DELAY;
+    m_ticksBelowTarget = 0;
+    m_ticksSinceChange = 0;
+    m_tickScale = 1.0f;
+}
+
+void TimeSync::AddRoundTrip(uint32_t playerId, float rttMs) {
+    PeerTiming& peer = m_peers[playerId];
+
+    if (!peer.hasRoundTrip) {
+        peer.rtt = rttMs;
+        peer.jitter = 0.0f;
+        peer.hasRoundTrip = true;
+        return;
+    }
+
+    // RFC 6298 gains
+    peer.jitter += (std::abs(rttMs - peer.rtt) - peer.jitter) * 0.25f;
+    peer.rtt += (rttMs - peer.rtt) * 0.125f;
+}
+
+void TimeSync::AddRemoteFrame(uint32_t playerId, uint32_t localFrame, uint32_t remoteFrame,
+                              float queuedMs, float remoteAdvantage) {
+    PeerTiming& peer = m_peers[playerId];
+
+    // The peer has kept running while the packet was queued and in flight
+    float oneWayMs = peer.hasRoundTrip ? peer.rtt / 2.0f : 0.0f;
+    float remoteNow = static_cast<float>(remoteFrame) + (queuedMs + oneWayMs) / FRAME_MS;
+    float advantage = static_cast<float>(localFrame) - remoteNow;
+
+    if (!peer.hasFrames) {
+        peer.localAdvantage = advantage;
+        peer.remoteAdvantage = remoteAdvantage;
+        peer.hasFrames = true;
+        return;
+    }
+
+    peer.localAdvantage += (advantage - peer.localAdvantage) * ADVANTAGE_SMOOTHING;
+    peer.remoteAdvantage = remoteAdvantage;   // Already smoothed by the sender
+}
+
+void TimeSync::SetPacketLoss(uint32_t playerId, float packetLoss) {
+    m_peers[playerId].packetLoss = packetLoss;
+}
+
+void TimeSync::Update() {
+    // Input delay: follow the worst link. Raise quickly, since every
+    // frame short means deeper rollbacks; lower only once the link has
+    // been better for a while, as each change costs a repeated or
+    // dropped input frame.
+    bool measured = false;
+    int target = NetworkConfig::MIN_INPUT_DELAY;
+    for (const auto& [playerId, peer] : m_peers) {
+        if (peer.hasRoundTrip) {
+            target = std::max(target, CalculateTargetDelay(peer));
+            measured = true;
+        }
+    }
+    m_targetInputDelay = measured ? target : m_inputDelay;
+
+    m_ticksSinceChange++;
+    if (m_targetInputDelay > m_inputDelay) {
+        m_ticksBelowTarget = 0;
+        if (m_ticksSinceChange >= NetworkConfig::INPUT_DELAY_RAISE_TICKS) {
+            m_inputDelay++;
+            m_ticksSinceChange = 0;
+        }
+    } else if (m_targetInputDelay < m_inputDelay) {
+        if (++m_ticksBelowTarget >= NetworkConfig::INPUT_DELAY_LOWER_TICKS) {
+            m_inputDelay--;
+            m_ticksBelowTarget = 0;
+            m_ticksSinceChange = 0;
+        }
+    } else {
+        m_ticksBelowTarget = 0;
+    }
+
+    // The last tick ran long by m_tickScale - 1 frames. Between Pings,
+    // count that against our lead ourselves; otherwise the estimate lags
+    // behind and the correction overshoots.
+    float givenBack = m_tickScale - 1.0f;
+    for (auto& [playerId, peer] : m_peers) {
+        if (peer.hasFrames) {
+            peer.localAdvantage -= givenBack;
+            peer.remoteAdvantage += givenBack;
+        }
+    }
+
+    // Pacing: only the side that is ahead waits, in proportion to its lead
+    float correction = GetFrameCorrection();
+    m_tickScale = 1.0f + std::clamp(correction * NetworkConfig::TIME_SYNC_GAIN, 0.0f, NetworkConfig::MAX_TICK_SLOWDOWN);
+}
+
+int TimeSync::CalculateTargetDelay(const PeerTiming& peer) const {
+    // Time until a remote input can be simulated: flight time with a
+    // jitter margin, plus waiting for the next send tick. A lost packet is
+    // repaired by the redundant history of the next one.
+    float latencyMs = peer.rtt / 2.0f + 2.0f * peer.jitter + SEND_INTERVAL_MS;
+    if (peer.packetLoss > 0.01f) {
+        latencyMs += SEND_INTERVAL_MS;
+    }
+
+    int latencyFrames = static_cast<int>(std::ceil(latencyMs / FRAME_MS));
+    return std::clamp(latencyFrames - NetworkConfig::ROLLBACK_BUDGET_FRAMES,
+                      NetworkConfig::MIN_INPUT_DELAY, NetworkConfig::MAX_INPUT_DELAY);
+}
+
+float TimeSync::GetRoundTripTime() const {
+    float rtt = 0.0f;
+    for (const auto& [playerId, peer] : m_peers) {
+        rtt = std::max(rtt, peer.rtt);
+    }
+    return rtt;
+}
+
+float TimeSync::GetJitter() const {
+    float jitter = 0.0f;
+    for (const auto& [playerId, peer] : m_peers) {
+        jitter = std::max(jitter, peer.jitter);
+    }
+    return jitter;
+}
+
+float TimeSync::GetPacketLoss() const {
+    float packetLoss = 0.0f;
+    for (const auto& [playerId, peer] : m_peers) {
+        packetLoss = std::max(packetLoss, peer.packetLoss);
+    }
+    return packetLoss;
+}
+
+float TimeSync::GetFrameAdvantage(uint32_t playerId) const {
+    auto it = m_peers.find(playerId);
+    return it != m_peers.end() ? it->second.localAdvantage : 0.0f;
+}
+
+float TimeSync::GetFrameAdvantage() const {
+    bool first = true;
+    float advantage = 0.0f;
+    for (const auto& [playerId, peer] : m_peers) {
+        if (peer.hasFrames && (first || peer.localAdvantage > advantage)) {
+            advantage = peer.localAdvantage;
+            first = false;
+        }
+    }
+    return advantage;
+}
+
+float TimeSync::GetFrameCorrection() const {
+    float correction = 0.0f;
+    for (const auto& [playerId, peer] : m_peers) {
+        if (peer.hasFrames) {
+            correction = std::max(correction, (peer.localAdvantage - peer.remoteAdvantage) / 2.0f);
+        }
+    }
+    return correction;
+}
+
+} // namespace ArenaFighter
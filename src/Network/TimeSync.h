@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include "NetworkConfig.h"
+
+namespace ArenaFighter {
+
+// Link quality and clock alignment with every peer, fed by Ping/Pong.
+//
+// Round trips give RTT and jitter (smoothed as in TCP's RTO estimator);
+// those set the input delay needed to keep remote inputs inside the
+// rollback budget. Each Ping also carries the sender's frame and its
+// advantage over us. Our own advantage is how far our frame is ahead of
+// the peer's frame projected to now. Each side gives back half of the
+// difference between the two advantages, as GGPO does. The side that is
+// ahead slows its ticks slightly until both run within a frame of each
+// other, instead of one of them rolling back further and further.
+class TimeSync {
+public:
+    TimeSync();
+
+    void AddPeer(uint32_t playerId);
+    void RemovePeer(uint32_t playerId);
+    void Reset();
+
+    // One Ping/Pong round trip with playerId
+    void AddRoundTrip(uint32_t playerId, float rttMs);
+
+    // A Ping or Pong from playerId: the frame it was on, how long before
+    // sending that was, and its own advantage over us. localFrame is our
+    // frame on arrival.
+    void AddRemoteFrame(uint32_t playerId, uint32_t localFrame, uint32_t remoteFrame,
+                        float queuedMs, float remoteAdvantage);
+
+    // Fraction of playerId's packets lost (0-1); only that link's input
+    // delay target accounts for it
+    void SetPacketLoss(uint32_t playerId, float packetLoss);
+
+    // Once per tick: moves input delay toward its target and updates the
+    // tick scale
+    void Update();
+
+    // Frames between sampling an input and simulating it
+    int GetInputDelay() const { return m_inputDelay; }
+    int GetTargetInputDelay() const { return m_targetInputDelay; }
+
+    // Multiplier for the fixed tick interval; above 1 while we wait for a
+    // peer that is behind
+    float GetTickScale() const { return m_tickScale; }
+
+    // Worst values across peers
+    float GetRoundTripTime() const;
+    float GetJitter() const;
+    float GetPacketLoss() const;
+    float GetFrameAdvantage(uint32_t playerId) const;
+    float GetFrameAdvantage() const;   // Largest, i.e. the peer we lead most
+    float GetFrameCorrection() const;  // Frames we still have to give back
+
+private:
+    struct PeerTiming {
+        float rtt = 0.0f;
+        float jitter = 0.0f;
+        bool hasRoundTrip = false;
+        float packetLoss = 0.0f;
+
+        float localAdvantage = 0.0f;
+        float remoteAdvantage = 0.0f;
+        bool hasFrames = false;
+    };
+
+    int CalculateTargetDelay(const PeerTiming& peer) const;
+
+    std::unordered_map<uint32_t, PeerTiming> m_peers;
+
+    int m_inputDelay;
+    int m_targetInputDelay;
+    int m_ticksBelowTarget;     // Consecutive ticks the target sat below the delay
+    int m_ticksSinceChange;
+    float m_tickScale;
+};
+
+} // namespace ArenaFighter
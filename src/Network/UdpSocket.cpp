@@ -0,0 +1,428 @@
+#include "UdpSocket.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+namespace ArenaFighter {
+
+namespace {
+
+#ifdef _WIN32
+constexpr intptr_t INVALID_HANDLE = static_cast<intptr_t>(INVALID_SOCKET);
+#else
+constexpr intptr_t INVALID_HANDLE = -1;
+#endif
+
+sockaddr_in ToSockAddr(const UdpEndpoint& endpoint) {
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(endpoint.address);
+    addr.sin_port = htons(endpoint.port);
+    return addr;
+}
+
+UdpEndpoint FromSockAddr(const sockaddr_in& addr) {
+    UdpEndpoint endpoint;
+    endpoint.address = ntohl(addr.sin_addr.s_addr);
+    endpoint.port = ntohs(addr.sin_port);
+    return endpoint;
+}
+
+} // namespace
+
+bool UdpEndpoint::Resolve(const std::string& host, int port, UdpEndpoint& out) {
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        return false;
+    }
+
+    const auto* addr = reinterpret_cast<const sockaddr_in*>(result->ai_addr);
+    out.address = ntohl(addr->sin_addr.s_addr);
+    out.port = static_cast<uint16_t>(port);
+    freeaddrinfo(result);
+    return true;
+}
+
+UdpSocket::UdpSocket()
+    : m_handle(INVALID_HANDLE)
+    , m_localPort(0) {
+}
+
+UdpSocket::~UdpSocket() {
+    Close();
+}
+
+bool UdpSocket::Open(int port) {
+    Close();
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        return false;
+    }
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(sock, FIONBIO, &nonBlocking);
+    m_handle = static_cast<intptr_t>(sock);
+#else
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        return false;
+    }
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+    m_handle = sock;
+#endif
+
+    sockaddr_in addr = ToSockAddr(UdpEndpoint{INADDR_ANY, static_cast<uint16_t>(port)});
+    if (bind(static_cast<decltype(sock)>(m_handle),
+             reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        Close();
+        return false;
+    }
+
+    sockaddr_in bound;
+    socklen_t boundLen = sizeof(bound);
+    getsockname(static_cast<decltype(sock)>(m_handle), reinterpret_cast<sockaddr*>(&bound), &boundLen);
+    m_localPort = ntohs(bound.sin_port);
+
+    return true;
+}
+
+void UdpSocket::Close() {
+    if (m_handle == INVALID_HANDLE) {
+        return;
+    }
+
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(m_handle));
+    WSACleanup();
+#else
+    close(static_cast<int>(m_handle));
+#endif
+
+    m_handle = INVALID_HANDLE;
+    m_localPort = 0;
+}
+
+bool UdpSocket::IsOpen() const {
+    return m_handle != INVALID_HANDLE;
+}
+
+size_t UdpSocket::SendBatch(const UdpDatagram* datagrams, size_t count) {
+    if (!IsOpen() || count == 0) {
+        return 0;
+    }
+
+    size_t sent = 0;
+
+#if defined(__linux__)
+    sockaddr_in addrs[MAX_BATCH];
+    iovec iovs[MAX_BATCH];
+    mmsghdr msgs[MAX_BATCH];
+
+    while (sent < count) {
+        size_t batch = std::min(count - sent, MAX_BATCH);
+
+        for (size_t i = 0; i < batch; ++i) {
+            const UdpDatagram& datagram = datagrams[sent + i];
+            addrs[i] = ToSockAddr(datagram.endpoint);
+            iovs[i].iov_base = const_cast<uint8_t*>(datagram.data);
+            iovs[i].iov_len = datagram.size;
+
+            std::memset(&msgs[i], 0, sizeof(mmsghdr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(static_cast<int>(m_handle), msgs, static_cast<unsigned int>(batch), 0);
+        if (result <= 0) {
+            break; // Socket buffer full; the rest is dropped like any UDP loss
+        }
+        sent += static_cast<size_t>(result);
+    }
+#else
+    for (; sent < count; ++sent) {
+        const UdpDatagram& datagram = datagrams[sent];
+        sockaddr_in addr = ToSockAddr(datagram.endpoint);
+#ifdef _WIN32
+        int result = sendto(static_cast<SOCKET>(m_handle),
+                            reinterpret_cast<const char*>(datagram.data),
+                            static_cast<int>(datagram.size), 0,
+                            reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+#else
+        ssize_t result = sendto(static_cast<int>(m_handle), datagram.data, datagram.size, 0,
+                                reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+#endif
+        if (result < 0) {
+            break;
+        }
+    }
+#endif
+
+    return sent;
+}
+
+size_t UdpSocket::ReceiveBatch(UdpDatagram* datagrams, size_t maxCount) {
+    if (!IsOpen() || maxCount == 0) {
+        return 0;
+    }
+
+    size_t batch = std::min(maxCount, MAX_BATCH);
+    size_t received = 0;
+
+#if defined(__linux__)
+    sockaddr_in addrs[MAX_BATCH];
+    iovec iovs[MAX_BATCH];
+    mmsghdr msgs[MAX_BATCH];
+
+    for (size_t i = 0; i < batch; ++i) {
+        iovs[i].iov_base = m_receiveStorage[i];
+        iovs[i].iov_len = MAX_DATAGRAM_SIZE;
+
+        std::memset(&msgs[i], 0, sizeof(mmsghdr));
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int result = recvmmsg(static_cast<int>(m_handle), msgs, static_cast<unsigned int>(batch),
+                          MSG_DONTWAIT, nullptr);
+    if (result <= 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < result; ++i) {
+        datagrams[received].endpoint = FromSockAddr(addrs[i]);
+        datagrams[received].data = m_receiveStorage[i];
+        datagrams[received].size = msgs[i].msg_len;
+        received++;
+    }
+#else
+    for (; received < batch; ++received) {
+        sockaddr_in addr;
+        socklen_t addrLen = sizeof(addr);
+#ifdef _WIN32
+        int result = recvfrom(static_cast<SOCKET>(m_handle),
+                              reinterpret_cast<char*>(m_receiveStorage[received]),
+                              static_cast<int>(MAX_DATAGRAM_SIZE), 0,
+                              reinterpret_cast<sockaddr*>(&addr), &addrLen);
+#else
+        ssize_t result = recvfrom(static_cast<int>(m_handle), m_receiveStorage[received],
+                                  MAX_DATAGRAM_SIZE, 0,
+                                  reinterpret_cast<sockaddr*>(&addr), &addrLen);
+#endif
+        if (result <= 0) {
+            break; // Would block, nothing more pending
+        }
+
+        datagrams[received].endpoint = FromSockAddr(addr);
+        datagrams[received].data = m_receiveStorage[received];
+        datagrams[received].size = static_cast<size_t>(result);
+    }
+#endif
+
+    return received;
+}
+
+bool UdpSocket::WaitForData(int timeoutMs, SocketWakeup* wakeup) {
+    if (!IsOpen()) {
+        return false;
+    }
+    bool watchWakeup = wakeup && wakeup->IsOpen();
+
+#ifdef _WIN32
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(static_cast<SOCKET>(m_handle), &readable);
+    if (watchWakeup) {
+        FD_SET(static_cast<SOCKET>(wakeup->m_readHandle), &readable);
+    }
+
+    timeval timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+    if (select(0, &readable, nullptr, nullptr, &timeout) <= 0) {
+        return false;
+    }
+    if (watchWakeup && FD_ISSET(static_cast<SOCKET>(wakeup->m_readHandle), &readable)) {
+        wakeup->Drain();
+    }
+    return FD_ISSET(static_cast<SOCKET>(m_handle), &readable) != 0;
+#else
+    pollfd descriptors[2];
+    descriptors[0].fd = static_cast<int>(m_handle);
+    descriptors[0].events = POLLIN;
+    descriptors[0].revents = 0;
+    if (watchWakeup) {
+        descriptors[1].fd = static_cast<int>(wakeup->m_readHandle);
+        descriptors[1].events = POLLIN;
+        descriptors[1].revents = 0;
+    }
+
+    if (poll(descriptors, watchWakeup ? 2 : 1, timeoutMs) <= 0) {
+        return false;
+    }
+    if (watchWakeup && (descriptors[1].revents & POLLIN)) {
+        wakeup->Drain();
+    }
+    return (descriptors[0].revents & POLLIN) != 0;
+#endif
+}
+
+SocketWakeup::SocketWakeup()
+    : m_readHandle(INVALID_HANDLE)
+    , m_writeHandle(INVALID_HANDLE)
+    , m_port(0) {
+}
+
+SocketWakeup::~SocketWakeup() {
+    Close();
+}
+
+bool SocketWakeup::Open() {
+    Close();
+
+#if defined(_WIN32)
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        return false;
+    }
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(sock, FIONBIO, &nonBlocking);
+    m_readHandle = m_writeHandle = static_cast<intptr_t>(sock);
+
+    sockaddr_in addr = ToSockAddr(UdpEndpoint{INADDR_LOOPBACK, 0});
+    sockaddr_in bound;
+    int boundLen = sizeof(bound);
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(sock, reinterpret_cast<sockaddr*>(&bound), &boundLen) != 0) {
+        Close();
+        return false;
+    }
+    m_port = ntohs(bound.sin_port);
+#elif defined(__linux__)
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    m_readHandle = m_writeHandle = fd;
+#else
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+    m_readHandle = fds[0];
+    m_writeHandle = fds[1];
+#endif
+
+    return true;
+}
+
+void SocketWakeup::Close() {
+    if (m_readHandle == INVALID_HANDLE) {
+        return;
+    }
+
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(m_readHandle));
+    WSACleanup();
+#else
+    close(static_cast<int>(m_readHandle));
+    if (m_writeHandle != m_readHandle) {
+        close(static_cast<int>(m_writeHandle));
+    }
+#endif
+
+    m_readHandle = INVALID_HANDLE;
+    m_writeHandle = INVALID_HANDLE;
+    m_port = 0;
+}
+
+bool SocketWakeup::IsOpen() const {
+    return m_readHandle != INVALID_HANDLE;
+}
+
+void SocketWakeup::Signal() {
+    if (!IsOpen()) {
+        return;
+    }
+
+    // A full pipe or counter already means a wakeup is pending
+#if defined(_WIN32)
+    char byte = 0;
+    sockaddr_in self = ToSockAddr(UdpEndpoint{INADDR_LOOPBACK, m_port});
+    sendto(static_cast<SOCKET>(m_writeHandle), &byte, 1, 0,
+           reinterpret_cast<const sockaddr*>(&self), sizeof(self));
+#elif defined(__linux__)
+    uint64_t one = 1;
+    ssize_t written = write(static_cast<int>(m_writeHandle), &one, sizeof(one));
+    (void)written;
+#else
+    uint8_t byte = 0;
+    ssize_t written = write(static_cast<int>(m_writeHandle), &byte, 1);
+    (void)written;
+#endif
+}
+
+void SocketWakeup::Drain() {
+    if (!IsOpen()) {
+        return;
+    }
+
+#if defined(_WIN32)
+    char bytes[64];
+    while (recv(static_cast<SOCKET>(m_readHandle), bytes, sizeof(bytes), 0) > 0) {
+    }
+#elif defined(__linux__)
+    uint64_t count;
+    ssize_t drained = ::read(static_cast<int>(m_readHandle), &count, sizeof(count));
+    (void)drained;
+#else
+    uint8_t bytes[64];
+    while (::read(static_cast<int>(m_readHandle), bytes, sizeof(bytes)) > 0) {
+    }
+#endif
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace ArenaFighter {
+
+// IPv4 endpoint in host byte order
+struct UdpEndpoint {
+    uint32_t address = 0;
+    uint16_t port = 0;
+
+    bool operator==(const UdpEndpoint& other) const {
+        return address == other.address && port == other.port;
+    }
+    bool operator!=(const UdpEndpoint& other) const { return !(*this == other); }
+
+    static bool Resolve(const std::string& host, int port, UdpEndpoint& out);
+};
+
+// One datagram in a batched send or receive. For sends, data points at
+// caller-owned bytes; for receives, data points into the socket's own
+// receive storage and stays valid until the next ReceiveBatch call.
+struct UdpDatagram {
+    UdpEndpoint endpoint;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// Wakes a thread blocked in UdpSocket::WaitForData from another thread.
+// Linux uses an eventfd, other POSIX systems a self-pipe, and Windows a
+// loopback UDP socket, since select() only takes sockets there. Signals
+// before the wait are not lost; several collapse into one wakeup.
+class SocketWakeup {
+public:
+    SocketWakeup();
+    ~SocketWakeup();
+
+    SocketWakeup(const SocketWakeup&) = delete;
+    SocketWakeup& operator=(const SocketWakeup&) = delete;
+
+    bool Open();
+    void Close();
+    bool IsOpen() const;
+
+    // Safe from any thread; one syscall
+    void Signal();
+
+    // Clears pending signals without blocking
+    void Drain();
+
+private:
+    friend class UdpSocket;
+
+    intptr_t m_readHandle;
+    intptr_t m_writeHandle;
+    uint16_t m_port;   // Windows: where Signal() sends
+};
+
+// Non-blocking UDP socket with batched I/O.
+// On Linux, SendBatch and ReceiveBatch map to a single sendmmsg/recvmmsg
+// call per MAX_BATCH datagrams; other platforms fall back to a loop.
+class UdpSocket {
+public:
+    static constexpr size_t MAX_BATCH = 64;
+    static constexpr size_t MAX_DATAGRAM_SIZE = 1500; // Ethernet MTU
+
+    UdpSocket();
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Bind to the given port on all interfaces (0 = ephemeral)
+    bool Open(int port);
+    void Close();
+    bool IsOpen() const;
+    int GetLocalPort() const { return m_localPort; }
+
+    // Returns the number of datagrams handed to the kernel
+    size_t SendBatch(const UdpDatagram* datagrams, size_t count);
+
+    // Drains up to maxCount pending datagrams without blocking
+    size_t ReceiveBatch(UdpDatagram* datagrams, size_t maxCount);
+
+    // Blocks until a datagram is pending, wakeup is signalled or timeoutMs
+    // passes. Returns true if a datagram is pending. A signal is drained
+    // before returning.
+    bool WaitForData(int timeoutMs, SocketWakeup* wakeup = nullptr);
+
+private:
+    intptr_t m_handle;
+    int m_localPort;
+
+    // Receive storage reused across calls
+    uint8_t m_receiveStorage[MAX_BATCH][MAX_DATAGRAM_SIZE];
+};
+
+} // namespace ArenaFighter
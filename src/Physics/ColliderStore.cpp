@@ -0,0 +1,198 @@
+#include "ColliderStore.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DFR_COLLIDER_KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DFR_COLLIDER_KERNEL_SSE2
+#endif
+
+namespace ArenaFighter {
+
+namespace {
+
+// Never overlaps anything: min above max on both axes
+constexpr float EMPTY_MIN = std::numeric_limits<float>::max();
+constexpr float EMPTY_MAX = -std::numeric_limits<float>::max();
+
+#if defined(DFR_COLLIDER_KERNEL_SSE2)
+// Four entries starting at i; lane set when the entry matches
+uint32_t OverlapMask4(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                      const int32_t* typeBits, const int32_t* layer, const int32_t* layerMask,
+                      const ColliderStore::Query& query, size_t i) {
+    __m128 hit = _mm_and_ps(
+        _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX + i), _mm_set1_ps(query.maxX)),
+                   _mm_cmpge_ps(_mm_loadu_ps(maxX + i), _mm_set1_ps(query.minX))),
+        _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY + i), _mm_set1_ps(query.maxY)),
+                   _mm_cmpge_ps(_mm_loadu_ps(maxY + i), _mm_set1_ps(query.minY))));
+
+    // Filters reject a lane when their AND is zero
+    __m128i zero = _mm_setzero_si128();
+    __m128i rejected = _mm_or_si128(
+        _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(typeBits + i)),
+                                      _mm_set1_epi32(query.typeMask)), zero),
+        _mm_or_si128(
+            _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(layer + i)),
+                                          _mm_set1_epi32(query.layerMask)), zero),
+            _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(layerMask + i)),
+                                          _mm_set1_epi32(query.layer)), zero)));
+
+    return static_cast<uint32_t>(_mm_movemask_ps(_mm_andnot_ps(_mm_castsi128_ps(rejected), hit)));
+}
+#endif
+
+} // namespace
+
+const char* ColliderStore::GetKernelName() {
+#if defined(DFR_COLLIDER_KERNEL_AVX2)
+    return "AVX2";
+#elif defined(DFR_COLLIDER_KERNEL_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void ColliderStore::Clear() {
+    m_colliders.clear();
+    Pad(0);
+}
+
+void ColliderStore::Add(Collider* collider) {
+    if (!collider) return;
+
+    // Empty until the next Update() reads it
+    m_colliders.push_back(collider);
+    Pad(m_colliders.size() - 1);
+}
+
+void ColliderStore::Remove(Collider* collider) {
+    auto it = std::find(m_colliders.begin(), m_colliders.end(), collider);
+    if (it == m_colliders.end()) return;
+
+    // Order doesn't matter; the last entry takes the slot
+    size_t index = static_cast<size_t>(it - m_colliders.begin());
+    size_t last = m_colliders.size() - 1;
+    m_colliders[index] = m_colliders[last];
+    m_minX[index] = m_minX[last];
+    m_minY[index] = m_minY[last];
+    m_maxX[index] = m_maxX[last];
+    m_maxY[index] = m_maxY[last];
+    m_typeBits[index] = m_typeBits[last];
+    m_layer[index] = m_layer[last];
+    m_layerMask[index] = m_layerMask[last];
+    m_isBox[index] = m_isBox[last];
+
+    m_colliders.pop_back();
+    Pad(last);
+}
+
+void ColliderStore::Update() {
+    for (size_t i = 0; i < m_colliders.size(); ++i) {
+        const Collider* collider = m_colliders[i];
+
+        if (collider->IsActive()) {
+            AABB aabb = collider->GetAABB();
+            m_minX[i] = aabb.min.x;
+            m_minY[i] = aabb.min.y;
+            m_maxX[i] = aabb.max.x;
+            m_maxY[i] = aabb.max.y;
+        } else {
+            m_minX[i] = m_minY[i] = EMPTY_MIN;
+            m_maxX[i] = m_maxY[i] = EMPTY_MAX;
+        }
+
+        m_typeBits[i] = TypeBit(collider->GetType());
+        m_layer[i] = static_cast<int32_t>(collider->GetLayer());
+        m_layerMask[i] = collider->GetLayerMask();
+        m_isBox[i] = collider->GetShape() == ColliderShape::Box ? 1 : 0;
+    }
+}
+
+uint32_t ColliderStore::OverlapMask(const Query& query, size_t first) const {
+#if defined(DFR_COLLIDER_KERNEL_AVX2)
+    __m256 hit = _mm256_and_ps(
+        _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&m_minX[first]), _mm256_set1_ps(query.maxX), _CMP_LE_OQ),
+                      _mm256_cmp_ps(_mm256_loadu_ps(&m_maxX[first]), _mm256_set1_ps(query.minX), _CMP_GE_OQ)),
+        _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&m_minY[first]), _mm256_set1_ps(query.maxY), _CMP_LE_OQ),
+                      _mm256_cmp_ps(_mm256_loadu_ps(&m_maxY[first]), _mm256_set1_ps(query.minY), _CMP_GE_OQ)));
+
+    // Filters reject a lane when their AND is zero
+    __m256i zero = _mm256_setzero_si256();
+    __m256i rejected = _mm256_or_si256(
+        _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_typeBits[first])),
+                                            _mm256_set1_epi32(query.typeMask)), zero),
+        _mm256_or_si256(
+            _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_layer[first])),
+                                                _mm256_set1_epi32(query.layerMask)), zero),
+            _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_layerMask[first])),
+                                                _mm256_set1_epi32(query.layer)), zero)));
+
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_andnot_ps(_mm256_castsi256_ps(rejected), hit)));
+#elif defined(DFR_COLLIDER_KERNEL_SSE2)
+    const float* minX = m_minX.data();
+    const float* minY = m_minY.data();
+    const float* maxX = m_maxX.data();
+    const float* maxY = m_maxY.data();
+    const int32_t* typeBits = m_typeBits.data();
+    const int32_t* layer = m_layer.data();
+    const int32_t* layerMask = m_layerMask.data();
+
+    return OverlapMask4(minX, minY, maxX, maxY, typeBits, layer, layerMask, query, first) |
+           (OverlapMask4(minX, minY, maxX, maxY, typeBits, layer, layerMask, query, first + 4) << 4);
+#else
+    uint32_t mask = 0;
+    for (size_t lane = 0; lane < BATCH; ++lane) {
+        size_t i = first + lane;
+        bool hit = m_minX[i] <= query.maxX && m_maxX[i] >= query.minX &&
+                   m_minY[i] <= query.maxY && m_maxY[i] >= query.minY &&
+                   (m_typeBits[i] & query.typeMask) != 0 &&
+                   (m_layer[i] & query.layerMask) != 0 &&
+                   (m_layerMask[i] & query.layer) != 0;
+        mask |= hit ? (1u << lane) : 0u;
+    }
+    return mask;
+#endif
+}
+
+AABB ColliderStore::GetBounds(size_t index) const {
+    return AABB(DirectX::XMFLOAT2(m_minX[index], m_minY[index]),
+                DirectX::XMFLOAT2(m_maxX[index], m_maxY[index]));
+}
+
+ColliderStore::Query ColliderStore::MakeQuery(size_t index, int typeMask, float margin) const {
+    Query query;
+    query.minX = m_minX[index] - margin;
+    query.minY = m_minY[index] - margin;
+    query.maxX = m_maxX[index] + margin;
+    query.maxY = m_maxY[index] + margin;
+    query.typeMask = typeMask;
+    query.layer = m_layer[index];
+    query.layerMask = m_layerMask[index];
+    return query;
+}
+
+void ColliderStore::Pad(size_t firstEmpty) {
+    size_t count = m_colliders.size();
+    size_t padded = (count + BATCH - 1) / BATCH * BATCH;
+
+    m_minX.resize(padded);
+    m_minY.resize(padded);
+    m_maxX.resize(padded);
+    m_maxY.resize(padded);
+    m_typeBits.resize(padded);
+    m_layer.resize(padded);
+    m_layerMask.resize(padded);
+    m_isBox.resize(padded);
+
+    for (size_t i = firstEmpty; i < padded; ++i) {
+        m_minX[i] = m_minY[i] = EMPTY_MIN;
+        m_maxX[i] = m_maxY[i] = EMPTY_MAX;
+        m_typeBits[i] = 0;
+    }
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+#include "Collider.h"
+#include "CollisionFilter.h"
+
+namespace ArenaFighter {
+
+// Structure-of-arrays copy of the engine's colliders. Update() reads each
+// collider once per frame (one virtual GetAABB() apiece), and overlap
+// queries then run over flat float and int arrays, BATCH boxes per kernel
+// call: AVX2 when the build enables it, SSE2 on every x64 target, scalar
+// otherwise. Arrays are padded to a whole batch with empty boxes, so the
+// kernel never handles a tail.
+class ColliderStore {
+public:
+    static constexpr size_t BATCH = 8;
+
+    // One overlap query: bounds, then the filters an entry must pass
+    struct Query {
+        float minX, minY, maxX, maxY;
+        int typeMask;    // Bits of the CollisionTypes to accept, see TypeBit()
+        int layer;       // Entry's mask must include this layer...
+        int layerMask;   // ...and its layer must be in this mask
+    };
+
+    static int TypeBit(CollisionType type) { return CollisionFilter::TypeBit(type); }
+
+    // Name of the kernel compiled in, for benchmarks and logs
+    static const char* GetKernelName();
+
+    void Clear();
+    void Add(Collider* collider);
+    void Remove(Collider* collider);
+
+    // Re-reads every collider; inactive ones get empty bounds
+    void Update();
+
+    // Calls visit(index) for every entry matching query, as of the last
+    // Update(). Bounds are inclusive.
+    template <typename Visit>
+    void ForEachOverlap(const Query& query, Visit&& visit) const;
+
+    // Bit i set when entry first + i matches; first is a multiple of BATCH
+    uint32_t OverlapMask(const Query& query, size_t first) const;
+
+    // Entries
+    size_t GetCount() const { return m_colliders.size(); }
+    Collider* GetCollider(size_t index) const { return m_colliders[index]; }
+    int GetTypeBits(size_t index) const { return m_typeBits[index]; }
+    bool IsBox(size_t index) const { return m_isBox[index] != 0; }
+    AABB GetBounds(size_t index) const;
+
+    // Query for everything of typeMask overlapping entry's bounds that
+    // entry's layers allow, grown by margin on each side (negative shrinks)
+    Query MakeQuery(size_t index, int typeMask, float margin = 0.0f) const;
+
+private:
+    // Resizes to whole batches; entries from firstEmpty on match nothing
+    void Pad(size_t firstEmpty);
+
+    std::vector<Collider*> m_colliders;
+
+    // Padded to a multiple of BATCH
+    std::vector<float> m_minX, m_minY, m_maxX, m_maxY;
+    std::vector<int32_t> m_typeBits;
+    std::vector<int32_t> m_layer;
+    std::vector<int32_t> m_layerMask;
+    std::vector<uint8_t> m_isBox;
+};
+
+template <typename Visit>
+void ColliderStore::ForEachOverlap(const Query& query, Visit&& visit) const {
+    size_t count = m_colliders.size();
+    for (size_t first = 0; first < count; first += BATCH) {
+        uint32_t mask = OverlapMask(query, first);
+        while (mask) {
+            visit(first + static_cast<size_t>(std::countr_zero(mask)));
+            mask &= mask - 1;
+        }
+    }
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Collider.h"
+
+namespace ArenaFighter {
+
+// Which collider pairs are worth a narrow-phase test. Most overlaps in a
+// crowded match are between boxes nobody reacts to (a character's own
+// hurtboxes, two hurtboxes, stage pieces), so the broad phases drop them
+// with a type table lookup and the layer masks before any geometry.
+namespace CollisionFilter {
+
+constexpr int TYPE_COUNT = 6;
+
+// Symmetric; indexed by CollisionType
+constexpr bool INTERACTS[TYPE_COUNT][TYPE_COUNT] = {
+    //            Hurt   Hit    Push   Throw  Proj   Env
+    /* Hurtbox */ {false, true,  false, false, true,  false},
+    /* Hitbox  */ {true,  true,  false, false, true,  false},   // Hits and clashes
+    /* Pushbox */ {false, false, true,  true,  false, true },   // Bodies, throws, walls
+    /* Throwbox*/ {false, false, true,  false, false, false},
+    /* Proj    */ {true,  true,  false, false, true,  true },
+    /* Env     */ {false, false, true,  false, true,  false},
+};
+
+constexpr bool IsSymmetric() {
+    for (int a = 0; a < TYPE_COUNT; ++a) {
+        for (int b = 0; b < TYPE_COUNT; ++b) {
+            if (INTERACTS[a][b] != INTERACTS[b][a]) return false;
+        }
+    }
+    return true;
+}
+static_assert(IsSymmetric(), "CollisionFilter::INTERACTS must be symmetric");
+
+constexpr int TypeBit(CollisionType type) { return 1 << static_cast<int>(type); }
+
+// Bits of every type that type interacts with
+constexpr int InteractionMask(CollisionType type) {
+    int mask = 0;
+    for (int other = 0; other < TYPE_COUNT; ++other) {
+        if (INTERACTS[static_cast<int>(type)][other]) {
+            mask |= 1 << other;
+        }
+    }
+    return mask;
+}
+
+// A collider's filter inputs, copied into broad phase entries so the
+// test needs no collider access
+struct Key {
+    int typeBit;
+    int typeMask;
+    int layer;
+    int layerMask;
+};
+
+inline Key MakeKey(const Collider& collider) {
+    return Key{
+        TypeBit(collider.GetType()),
+        InteractionMask(collider.GetType()),
+        static_cast<int>(collider.GetLayer()),
+        collider.GetLayerMask()
+    };
+}
+
+// Types interact and each side's layer mask takes the other's layer
+inline bool Accepts(const Key& a, const Key& b) {
+    return (a.typeMask & b.typeBit) != 0 &&
+           (a.layerMask & b.layer) != 0 &&
+           (b.layerMask & a.layer) != 0;
+}
+
+} // namespace CollisionFilter
+
+} // namespace ArenaFighter
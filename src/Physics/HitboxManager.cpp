@@ -4,7 +4,9 @@
 namespace ArenaFighter {
 
 HitboxManager::HitboxManager()
-    : m_currentFrame(0)
+    : m_appliedFrame(nullptr)
+    , m_currentAnimation(-1)
+    , m_currentFrame(0)
     , m_facingDirection(1)
     , m_invulnerable(false)
     , m_rigidBody(nullptr) {
@@ -67,31 +69,85 @@ void HitboxManager::InitializeStandardBoxes() {
     m_throwbox->SetCenter({25, 30});
     m_throwbox->SetSize(50, 60);
     m_throwbox->SetActive(false);
+    
+    m_appliedFrame = nullptr;
 }
 
-void HitboxManager::UpdateBoxes(const std::string& animationName, int frame, int facingDirection) {
-    m_currentAnimation = animationName;
+void HitboxManager::UpdateBoxes(int animationId, int frame, int facingDirection) {
+    m_currentAnimation = animationId;
     m_currentFrame = frame;
     m_facingDirection = facingDirection;
     
-    // Look up animation data
-    auto it = m_animationData.find(animationName);
-    if (it != m_animationData.end() && frame < it->second.size()) {
-        ApplyFrameData(it->second[frame]);
-    }
+    if (animationId < 0 || animationId >= static_cast<int>(m_animations.size())) return;
+    
+    const AnimationRange& range = m_animations[animationId];
+    if (frame < 0 || static_cast<uint32_t>(frame) >= range.frameCount) return;
+    
+    size_t slot = (static_cast<size_t>(range.firstFrame) + frame) * 2 + (facingDirection < 0 ? 1 : 0);
+    const CompiledFrame* next = &m_compiledFrames[m_frameIndex[slot]];
+    
+    // Held frames compile to the same entry; the boxes already match
+    if (next == m_appliedFrame) return;
+    
+    ApplyFrame(*next);
+    m_appliedFrame = next;
 }
 
-void HitboxManager::ApplyFrameData(const FrameData& frameData) {
-    // Update hurtboxes
+void HitboxManager::UpdateBoxes(const std::string& animationName, int frame, int facingDirection) {
+    UpdateBoxes(GetAnimationId(animationName), frame, facingDirection);
+}
+
+HitboxManager::CompiledFrame HitboxManager::CompileFrame(const FrameData& frameData, int facingDirection) {
+    CompiledFrame compiled = {};
+    
     for (int i = 0; i < MAX_HURTBOXES; ++i) {
         const auto& hurtboxData = frameData.hurtboxes[i];
+        CompiledBox& box = compiled.hurtboxes[i];
+        
+        box.active = hurtboxData.active && !hurtboxData.invulnerable;
+        if (box.active) {
+            box.x = hurtboxData.x * facingDirection;
+            box.y = hurtboxData.y;
+            box.width = hurtboxData.width;
+            box.height = hurtboxData.height;
+        }
+    }
+    
+    for (int i = 0; i < MAX_HITBOXES; ++i) {
+        const auto& hitboxData = frameData.hitboxes[i];
+        CompiledHitbox& hitbox = compiled.hitboxes[i];
         
-        if (hurtboxData.active && !m_invulnerable && !hurtboxData.invulnerable) {
-            float x = hurtboxData.x;
-            ApplyFacingDirection(x);
+        hitbox.box.active = hitboxData.active;
+        if (hitbox.box.active) {
+            hitbox.box.x = hitboxData.x * facingDirection;
+            hitbox.box.y = hitboxData.y;
+            hitbox.box.width = hitboxData.width;
+            hitbox.box.height = hitboxData.height;
             
-            m_hurtboxes[i]->SetCenter({x, hurtboxData.y});
-            m_hurtboxes[i]->SetSize(hurtboxData.width, hurtboxData.height);
+            hitbox.damage = hitboxData.damage;
+            hitbox.hitstun = hitboxData.hitstun;
+            hitbox.blockstun = hitboxData.blockstun;
+            hitbox.knockbackX = hitboxData.knockback.x * facingDirection;
+            hitbox.knockbackY = hitboxData.knockback.y;
+            hitbox.priority = hitboxData.priority;
+        }
+    }
+    
+    compiled.throwboxActive = frameData.throwboxActive;
+    compiled.pushboxX = frameData.pushboxOffset.x * facingDirection;
+    compiled.pushboxY = frameData.pushboxOffset.y + 30;  // 30 is base Y
+    
+    return compiled;
+}
+
+void HitboxManager::ApplyFrame(const CompiledFrame& frame) {
+    // Update hurtboxes
+    for (int i = 0; i < MAX_HURTBOXES; ++i) {
+        const CompiledBox& box = frame.hurtboxes[i];
+        
+        if (box.active && !m_invulnerable) {
+            m_hurtboxes[i]->SetCenter({box.x, box.y});
+            m_hurtboxes[i]->SetSize(box.width, box.height);
             m_hurtboxes[i]->SetActive(true);
         } else {
             m_hurtboxes[i]->SetActive(false);
@@ -100,43 +156,29 @@ void HitboxManager::ApplyFrameData(const FrameData& frameData) {
     
     // Update hitboxes
     for (int i = 0; i < MAX_HITBOXES; ++i) {
-        const auto& hitboxData = frameData.hitboxes[i];
+        const CompiledHitbox& hitbox = frame.hitboxes[i];
         
-        if (hitboxData.active) {
-            float x = hitboxData.x;
-            ApplyFacingDirection(x);
-            
-            m_hitboxes[i]->SetCenter({x, hitboxData.y});
-            m_hitboxes[i]->SetSize(hitboxData.width, hitboxData.height);
+        if (hitbox.box.active) {
+            m_hitboxes[i]->SetCenter({hitbox.box.x, hitbox.box.y});
+            m_hitboxes[i]->SetSize(hitbox.box.width, hitbox.box.height);
             m_hitboxes[i]->SetActive(true);
             
             // Set combat properties
-            m_hitboxes[i]->SetDamage(hitboxData.damage);
-            m_hitboxes[i]->SetHitstun(hitboxData.hitstun);
-            m_hitboxes[i]->SetBlockstun(hitboxData.blockstun);
-            
-            // Apply facing direction to knockback
-            DirectX::XMFLOAT2 knockback = hitboxData.knockback;
-            knockback.x *= m_facingDirection;
-            m_hitboxes[i]->SetKnockback(knockback);
-            
-            m_hitboxes[i]->SetPriority(hitboxData.priority);
+            m_hitboxes[i]->SetDamage(hitbox.damage);
+            m_hitboxes[i]->SetHitstun(hitbox.hitstun);
+            m_hitboxes[i]->SetBlockstun(hitbox.blockstun);
+            m_hitboxes[i]->SetKnockback({hitbox.knockbackX, hitbox.knockbackY});
+            m_hitboxes[i]->SetPriority(hitbox.priority);
         } else {
             m_hitboxes[i]->SetActive(false);
         }
     }
     
     // Update throwbox
-    m_throwbox->SetActive(frameData.throwboxActive);
+    m_throwbox->SetActive(frame.throwboxActive);
     
     // Update pushbox offset
-    float pushboxX = frameData.pushboxOffset.x;
-    ApplyFacingDirection(pushboxX);
-    m_pushbox->SetCenter({pushboxX, frameData.pushboxOffset.y + 30});  // 30 is base Y
-}
-
-void HitboxManager::ApplyFacingDirection(float& x) {
-    x *= m_facingDirection;
+    m_pushbox->SetCenter({frame.pushboxX, frame.pushboxY});
 }
 
 std::vector<BoxCollider*> HitboxManager::GetActiveHitboxes() const {
@@ -166,15 +208,18 @@ std::vector<BoxCollider*> HitboxManager::GetHurtboxes() const {
 void HitboxManager::EnableHitbox(int index, bool enable) {
     if (index >= 0 && index < MAX_HITBOXES) {
         m_hitboxes[index]->SetActive(enable);
+        m_appliedFrame = nullptr;  // Next UpdateBoxes() restores the frame data
     }
 }
 
 void HitboxManager::EnableThrowbox(bool enable) {
     m_throwbox->SetActive(enable);
+    m_appliedFrame = nullptr;
 }
 
 void HitboxManager::SetInvulnerable(bool invulnerable) {
     m_invulnerable = invulnerable;
+    m_appliedFrame = nullptr;
     
     // Disable all hurtboxes when invulnerable
     if (invulnerable) {
@@ -200,8 +245,40 @@ void HitboxManager::SetRigidBody(RigidBody* body) {
     m_throwbox->SetRigidBody(body);
 }
 
-void HitboxManager::LoadAnimationData(const std::string& animationName, const std::vector<FrameData>& frames) {
-    m_animationData[animationName] = frames;
+int HitboxManager::LoadAnimationData(const std::string& animationName, const std::vector<FrameData>& frames) {
+    auto [it, inserted] = m_animationIds.try_emplace(animationName, static_cast<int>(m_animations.size()));
+    if (inserted) {
+        m_animations.push_back({});
+    }
+    
+    // Reloads append a fresh range; the old one is simply unused
+    AnimationRange& range = m_animations[it->second];
+    range.firstFrame = static_cast<uint32_t>(m_frameIndex.size() / 2);
+    range.frameCount = static_cast<uint32_t>(frames.size());
+    
+    for (size_t frame = 0; frame < frames.size(); ++frame) {
+        for (int facingDirection : { 1, -1 }) {
+            CompiledFrame compiled = CompileFrame(frames[frame], facingDirection);
+            
+            // Consecutive identical frames share an entry
+            size_t previous = m_frameIndex.size() - 2;
+            if (frame > 0 && m_compiledFrames[m_frameIndex[previous]] == compiled) {
+                m_frameIndex.push_back(m_frameIndex[previous]);
+            } else {
+                m_frameIndex.push_back(static_cast<uint32_t>(m_compiledFrames.size()));
+                m_compiledFrames.push_back(compiled);
+            }
+        }
+    }
+    
+    // The table may have moved
+    m_appliedFrame = nullptr;
+    return it->second;
+}
+
+int HitboxManager::GetAnimationId(const std::string& animationName) const {
+    auto it = m_animationIds.find(animationName);
+    return it != m_animationIds.end() ? it->second : -1;
 }
 
 } // namespace ArenaFighter
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include "Collider.h"
@@ -22,7 +24,9 @@ public:
     // Initialize with character-specific data
     void Initialize(const std::string& characterName);
     
-    // Update boxes based on animation state
+    // Update boxes based on animation state. Resolve the id once with
+    // GetAnimationId(); the name overload looks it up on every call.
+    void UpdateBoxes(int animationId, int frame, int facingDirection = 1);
     void UpdateBoxes(const std::string& animationName, int frame, int facingDirection = 1);
     
     // Get active collision boxes
@@ -65,8 +69,15 @@ public:
         DirectX::XMFLOAT2 pushboxOffset;  // Pushbox position adjustment
     };
     
-    // Load animation data
-    void LoadAnimationData(const std::string& animationName, const std::vector<FrameData>& frames);
+    // Compiles an animation's frames into the frame table and returns its
+    // id. Loading a name again replaces its frames under the same id.
+    int LoadAnimationData(const std::string& animationName, const std::vector<FrameData>& frames);
+    
+    // -1 when the animation was never loaded
+    int GetAnimationId(const std::string& animationName) const;
+    
+    // Distinct compiled frames, both facings, after deduplication
+    size_t GetCompiledFrameCount() const { return m_compiledFrames.size(); }
     
 private:
     // Collision boxes
@@ -75,11 +86,49 @@ private:
     std::unique_ptr<BoxCollider> m_pushbox;
     std::unique_ptr<BoxCollider> m_throwbox;
     
-    // Animation data storage
-    std::unordered_map<std::string, std::vector<FrameData>> m_animationData;
+    // One frame's final box state for one facing: offsets flipped,
+    // knockback flipped, nothing left to compute when it is applied
+    struct CompiledBox {
+        float x, y;
+        float width, height;
+        bool active;
+        bool operator==(const CompiledBox&) const = default;
+    };
+    
+    struct CompiledHitbox {
+        CompiledBox box;
+        float damage;
+        int hitstun;
+        int blockstun;
+        float knockbackX, knockbackY;
+        int priority;
+        bool operator==(const CompiledHitbox&) const = default;
+    };
+    
+    struct CompiledFrame {
+        CompiledBox hurtboxes[MAX_HURTBOXES];   // Frame invulnerability baked into active
+        CompiledHitbox hitboxes[MAX_HITBOXES];
+        bool throwboxActive;
+        float pushboxX, pushboxY;
+        bool operator==(const CompiledFrame&) const = default;
+    };
+    
+    struct AnimationRange {
+        uint32_t firstFrame;   // Into m_frameIndex, in units of two facings
+        uint32_t frameCount;
+    };
+    
+    // Frame table, written only by LoadAnimationData(). Entry
+    // (range.firstFrame + frame) * 2 + (facing < 0) of m_frameIndex picks
+    // the compiled frame; runs of identical frames share one.
+    std::unordered_map<std::string, int> m_animationIds;
+    std::vector<AnimationRange> m_animations;
+    std::vector<uint32_t> m_frameIndex;
+    std::vector<CompiledFrame> m_compiledFrames;
+    const CompiledFrame* m_appliedFrame;   // Last frame written to the boxes
     
     // Current state
-    std::string m_currentAnimation;
+    int m_currentAnimation;
     int m_currentFrame;
     int m_facingDirection;
     bool m_invulnerable;
@@ -91,11 +140,11 @@ private:
     // Initialize standard boxes based on character type
     void InitializeStandardBoxes();
     
-    // Apply frame data to boxes
-    void ApplyFrameData(const FrameData& frameData);
+    // Bake one FrameData for one facing
+    static CompiledFrame CompileFrame(const FrameData& frameData, int facingDirection);
     
-    // Flip box positions for facing direction
-    void ApplyFacingDirection(float& x);
+    // Apply a compiled frame to boxes
+    void ApplyFrame(const CompiledFrame& frame);
 };
 
 // Standard box configurations for different character archetypes
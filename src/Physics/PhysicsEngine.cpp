@@ -1,18 +1,34 @@
 #include "PhysicsEngine.h"
 #include "../Characters/CharacterBase.h"
+#include "../Core/FixedPoint.h"
 #include <algorithm>
+#include <cmath>
 
 namespace ArenaFighter {
 
+namespace {
+
+// Integration runs in fixed point so every rollback peer moves bodies
+// identically. RigidBody keeps float storage; values are converted at the
+// edges, which is exact in both directions apart from a deterministic
+// final rounding.
+Fixed ToFixed(float value) { return Fixed::FromFloat(value); }
+
+} // namespace
+
 PhysicsEngine::PhysicsEngine()
-    : m_debugDraw(false) {
+    : m_broadPhase(BroadPhase::Grid)
+    , m_debugDraw(false)
+    , m_collisionStats{} {
 }
 
 PhysicsEngine::~PhysicsEngine() {
     Shutdown();
 }
 
-bool PhysicsEngine::Initialize() {
+bool PhysicsEngine::Initialize(BroadPhase broadPhase) {
+    m_broadPhase = broadPhase;
+
     // Initialize spatial grid for optimization
     // Grid size based on typical fighting game stage dimensions
     m_spatialGrid = std::make_unique<SpatialGrid>(
@@ -23,20 +39,35 @@ bool PhysicsEngine::Initialize() {
         50.0f  // Cell size
     );
     
+    m_sweepAndPrune.reset();
+    if (m_broadPhase == BroadPhase::SweepAndPrune) {
+        // Keeps its colliders between frames, so pick up any added already
+        m_sweepAndPrune = std::make_unique<SweepAndPrune>();
+        for (auto* collider : m_colliders) {
+            m_sweepAndPrune->Insert(collider);
+        }
+    }
+    
     return true;
 }
 
 void PhysicsEngine::Shutdown() {
     ClearColliders();
     m_spatialGrid.reset();
+    m_sweepAndPrune.reset();
+}
+
+void PhysicsEngine::StepFrame() {
+    Update(FIXED_TIMESTEP);
 }
 
 void PhysicsEngine::Update(float deltaTime) {
     // Update spatial grid
     UpdateSpatialGrid();
+    m_colliderStore.Update();
     
     // Process all collisions
-    auto collisionResults = CheckAllCollisions();
+    const auto& collisionResults = CheckAllCollisions();
     
     // Resolve collisions
     for (const auto& result : collisionResults) {
@@ -82,28 +113,68 @@ bool PhysicsEngine::CheckCollision(const Collider* a, const Collider* b) const {
     }
 }
 
-std::vector<CollisionResult> PhysicsEngine::CheckAllCollisions() {
-    std::vector<CollisionResult> results;
+const std::vector<CollisionResult>& PhysicsEngine::CheckAllCollisions() {
+    m_collisionResults.clear();
+    m_collisionStats = {};
+    
+    // Both broad phases report each overlapping pair once, and only
+    // pairs CollisionFilter accepts
+    auto narrowPhase = [this](Collider* a, Collider* b) {
+        ProcessCollisionPair(a, b, m_collisionResults);
+    };
+    
+    if (m_sweepAndPrune) {
+        m_sweepAndPrune->ForEachPair(narrowPhase);
+    } else {
+        m_spatialGrid->ForEachPair(narrowPhase);
+    }
+    
+    return m_collisionResults;
+}
+
+const std::vector<CollisionResult>& PhysicsEngine::CheckHitboxes() {
+    m_hitResults.clear();
     
-    // Use spatial grid for broad phase
-    auto activeCells = m_spatialGrid->GetActiveCells();
+    const ColliderStore& store = m_colliderStore;
+    const int hitboxBit = ColliderStore::TypeBit(CollisionType::Hitbox);
+    const int hurtboxBit = ColliderStore::TypeBit(CollisionType::Hurtbox);
     
-    for (const auto& cellColliders : activeCells) {
-        // Check collisions within each cell
-        for (size_t i = 0; i < cellColliders.size(); ++i) {
-            for (size_t j = i + 1; j < cellColliders.size(); ++j) {
-                ProcessCollisionPair(cellColliders[i], cellColliders[j], results);
+    for (size_t i = 0; i < store.GetCount(); ++i) {
+        if (store.GetTypeBits(i) != hitboxBit) continue;
+        
+        // Shrinking the query by the tolerance matches CheckAABB()
+        ColliderStore::Query query = store.MakeQuery(i, hurtboxBit, -OVERLAP_TOLERANCE);
+        Collider* hitbox = store.GetCollider(i);
+        
+        store.ForEachOverlap(query, [&](size_t j) {
+            Collider* hurtbox = store.GetCollider(j);
+            if (hitbox->GetRigidBody() && hitbox->GetRigidBody() == hurtbox->GetRigidBody()) {
+                return;
             }
-        }
+            
+            // Bounds are exact for boxes; circles still need the real test
+            if (!store.IsBox(i) || !store.IsBox(j)) {
+                if (!CheckCollision(hitbox, hurtbox)) return;
+            }
+            
+            CollisionResult result = {};
+            result.colliderA = hitbox;
+            result.colliderB = hurtbox;
+            m_hitResults.push_back(result);
+        });
     }
     
-    return results;
+    return m_hitResults;
 }
 
 void PhysicsEngine::AddCollider(Collider* collider) {
     if (!collider) return;
     
     m_colliders.push_back(collider);
+    m_colliderStore.Add(collider);
+    if (m_sweepAndPrune) {
+        m_sweepAndPrune->Insert(collider);
+    }
     
     if (collider->GetRigidBody() && !collider->GetRigidBody()->IsKinematic()) {
         m_dynamicColliders.push_back(collider);
@@ -122,12 +193,22 @@ void PhysicsEngine::RemoveCollider(Collider* collider) {
     removeFromVector(m_colliders);
     removeFromVector(m_dynamicColliders);
     removeFromVector(m_staticColliders);
+    m_colliderStore.Remove(collider);
+    
+    if (m_sweepAndPrune) {
+        m_sweepAndPrune->Remove(collider);
+    }
 }
 
 void PhysicsEngine::ClearColliders() {
     m_colliders.clear();
     m_dynamicColliders.clear();
     m_staticColliders.clear();
+    m_colliderStore.Clear();
+    
+    if (m_sweepAndPrune) {
+        m_sweepAndPrune->Clear();
+    }
 }
 
 HitResult PhysicsEngine::ProcessHitDetection(CharacterBase* attacker, CharacterBase* defender) {
@@ -138,8 +219,8 @@ HitResult PhysicsEngine::ProcessHitDetection(CharacterBase* attacker, CharacterB
     }
     
     // Get active hitboxes from attacker
-    auto hitboxes = attacker->GetActiveHitboxes();
-    auto hurtboxes = defender->GetHurtboxes();
+    const auto& hitboxes = attacker->GetActiveHitboxes();
+    const auto& hurtboxes = defender->GetHurtboxes();
     
     // Check each hitbox against each hurtbox
     for (const auto& hitbox : hitboxes) {
@@ -189,13 +270,9 @@ void PhysicsEngine::ResolveHitPriority(const HitResult& hit1, const HitResult& h
 void PhysicsEngine::ApplyGravity(RigidBody* body, float deltaTime) {
     if (!body || body->IsKinematic()) return;
     
-    // Apply gravity
-    body->velocity.y += GRAVITY * deltaTime;
-    
-    // Clamp to max fall speed
-    if (body->velocity.y < MAX_FALL_SPEED) {
-        body->velocity.y = MAX_FALL_SPEED;
-    }
+    // Apply gravity, clamped to max fall speed
+    Fixed velocityY = ToFixed(body->velocity.y) + ToFixed(GRAVITY) * ToFixed(deltaTime);
+    body->velocity.y = Fixed::Max(velocityY, ToFixed(MAX_FALL_SPEED)).ToFloat();
 }
 
 void PhysicsEngine::ProcessMovement(RigidBody* body, float deltaTime) {
@@ -206,37 +283,47 @@ void PhysicsEngine::ProcessMovement(RigidBody* body, float deltaTime) {
         ApplyGravity(body, deltaTime);
     }
     
+    Fixed dt = ToFixed(deltaTime);
+    Fixed positionX = ToFixed(body->position.x);
+    Fixed positionY = ToFixed(body->position.y);
+    Fixed velocityX = ToFixed(body->velocity.x);
+    Fixed velocityY = ToFixed(body->velocity.y);
+    
     // Apply friction
-    float friction = body->isGrounded ? GROUND_FRICTION : AIR_FRICTION;
-    body->velocity.x *= friction;
+    velocityX *= ToFixed(body->isGrounded ? GROUND_FRICTION : AIR_FRICTION);
     
     // Update position
-    body->position.x += body->velocity.x * deltaTime;
-    body->position.y += body->velocity.y * deltaTime;
+    positionX += velocityX * dt;
+    positionY += velocityY * dt;
     
     // Check stage boundaries
-    if (body->position.x < STAGE_LEFT) {
-        body->position.x = STAGE_LEFT;
-        body->velocity.x = 0;
-    } else if (body->position.x > STAGE_RIGHT) {
-        body->position.x = STAGE_RIGHT;
-        body->velocity.x = 0;
+    if (positionX < ToFixed(STAGE_LEFT)) {
+        positionX = ToFixed(STAGE_LEFT);
+        velocityX = Fixed();
+    } else if (positionX > ToFixed(STAGE_RIGHT)) {
+        positionX = ToFixed(STAGE_RIGHT);
+        velocityX = Fixed();
     }
     
     // Ground check
-    if (body->position.y <= STAGE_GROUND) {
-        body->position.y = STAGE_GROUND;
-        body->velocity.y = 0;
+    if (positionY <= ToFixed(STAGE_GROUND)) {
+        positionY = ToFixed(STAGE_GROUND);
+        velocityY = Fixed();
         body->isGrounded = true;
     } else {
         body->isGrounded = false;
     }
     
     // Ceiling check
-    if (body->position.y > STAGE_CEILING) {
-        body->position.y = STAGE_CEILING;
-        body->velocity.y = 0;
+    if (positionY > ToFixed(STAGE_CEILING)) {
+        positionY = ToFixed(STAGE_CEILING);
+        velocityY = Fixed();
     }
+    
+    body->position.x = positionX.ToFloat();
+    body->position.y = positionY.ToFloat();
+    body->velocity.x = velocityX.ToFloat();
+    body->velocity.y = velocityY.ToFloat();
 }
 
 void PhysicsEngine::ApplyForce(RigidBody* body, const DirectX::XMFLOAT3& force) {
@@ -262,15 +349,17 @@ void PhysicsEngine::ProcessCharacterMovement(CharacterBase* character, const Dir
     if (!body) return;
     
     // Get character's movement speed
-    float speed = character->GetMovementSpeed();
+    Fixed speed = ToFixed(character->GetMovementSpeed());
+    Fixed inputX = ToFixed(input.x);
     
     // Apply movement
     if (body->isGrounded) {
         // Ground movement
-        body->velocity.x = input.x * speed;
+        body->velocity.x = (inputX * speed).ToFloat();
     } else {
         // Air movement (reduced control)
-        body->velocity.x += input.x * speed * 0.3f * deltaTime;
+        Fixed airControl = inputX * speed * Fixed::FromRatio(3, 10) * ToFixed(deltaTime);
+        body->velocity.x = (ToFixed(body->velocity.x) + airControl).ToFloat();
     }
     
     // Face direction based on input
@@ -299,7 +388,7 @@ void PhysicsEngine::ProcessAirDash(CharacterBase* character, const DirectX::XMFL
     if (!body || body->isGrounded) return;
     
     // Normalize direction
-    float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
     if (length > 0.0f) {
         DirectX::XMFLOAT2 normalizedDir = {
             direction.x / length,
@@ -350,16 +439,23 @@ void PhysicsEngine::ProcessPushback(CharacterBase* attacker, CharacterBase* defe
     if (!attackerBody || !defenderBody) return;
     
     // Calculate push direction
-    float direction = (defenderBody->position.x > attackerBody->position.x) ? 1.0f : -1.0f;
+    Fixed push = ToFixed(pushDistance);
+    if (defenderBody->position.x <= attackerBody->position.x) {
+        push = -push;
+    }
+    
+    Fixed attackerX = ToFixed(attackerBody->position.x);
+    Fixed defenderX = ToFixed(defenderBody->position.x);
     
     // Apply pushback (split between both characters if both grounded)
     if (attackerBody->isGrounded && defenderBody->isGrounded) {
-        attackerBody->position.x -= direction * pushDistance * 0.5f;
-        defenderBody->position.x += direction * pushDistance * 0.5f;
+        Fixed half = push * Fixed::FromRatio(1, 2);
+        attackerBody->position.x = (attackerX - half).ToFloat();
+        defenderBody->position.x = (defenderX + half).ToFloat();
     } else if (defenderBody->isGrounded) {
-        defenderBody->position.x += direction * pushDistance;
+        defenderBody->position.x = (defenderX + push).ToFloat();
     } else if (attackerBody->isGrounded) {
-        attackerBody->position.x -= direction * pushDistance;
+        attackerBody->position.x = (attackerX - push).ToFloat();
     }
 }
 
@@ -395,7 +491,23 @@ float PhysicsEngine::GetGroundHeight(float x) const {
 }
 
 std::vector<Collider*> PhysicsEngine::GetNearbyColliders(const DirectX::XMFLOAT2& position, float radius) const {
-    return m_spatialGrid->GetCollidersInRadius(position, radius);
+    if (!m_sweepAndPrune) {
+        return m_spatialGrid->GetCollidersInRadius(position, radius);
+    }
+    
+    // Same center-distance filter as the grid
+    AABB area(DirectX::XMFLOAT2(position.x - radius, position.y - radius),
+              DirectX::XMFLOAT2(position.x + radius, position.y + radius));
+    std::vector<Collider*> result;
+    m_sweepAndPrune->ForEachInAABB(area, [&](Collider* collider) {
+        DirectX::XMFLOAT2 center = collider->GetAABB().GetCenter();
+        float dx = center.x - position.x;
+        float dy = center.y - position.y;
+        if (dx * dx + dy * dy <= radius * radius) {
+            result.push_back(collider);
+        }
+    });
+    return result;
 }
 
 void PhysicsEngine::DrawDebugInfo() {
@@ -406,6 +518,11 @@ void PhysicsEngine::DrawDebugInfo() {
 }
 
 void PhysicsEngine::UpdateSpatialGrid() {
+    if (m_sweepAndPrune) {
+        m_sweepAndPrune->Update();
+        return;
+    }
+    
     m_spatialGrid->Clear();
     
     for (auto* collider : m_colliders) {
@@ -413,15 +530,16 @@ void PhysicsEngine::UpdateSpatialGrid() {
             m_spatialGrid->Insert(collider);
         }
     }
+    
+    m_spatialGrid->Build();
 }
 
 void PhysicsEngine::ProcessCollisionPair(Collider* a, Collider* b, std::vector<CollisionResult>& results) {
-    // Check collision layers
-    if (!a->CanCollideWith(b->GetLayer()) || !b->CanCollideWith(a->GetLayer())) {
-        return;
-    }
+    // Types and layers were checked in the broad phase
+    m_collisionStats.pairsTested++;
     
     if (CheckCollision(a, b)) {
+        m_collisionStats.pairsAccepted++;
         CollisionResult result;
         result.colliderA = a;
         result.colliderB = b;
@@ -457,8 +575,6 @@ void PhysicsEngine::ResolveCollision(const CollisionResult& result) {
 
 bool PhysicsEngine::CheckAABB(const AABB& a, const AABB& b) const {
     // LSFDC overlap tolerance
-    const float OVERLAP_TOLERANCE = 1.0f;
-    
     return !(a.min.x > b.max.x - OVERLAP_TOLERANCE ||
              a.max.x < b.min.x + OVERLAP_TOLERANCE ||
              a.min.y > b.max.y - OVERLAP_TOLERANCE ||
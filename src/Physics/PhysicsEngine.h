@@ -1,30 +1,57 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <DirectXMath.h>
 #include "Collider.h"
+#include "ColliderStore.h"
 #include "SpatialGrid.h"
+#include "SweepAndPrune.h"
 
 namespace ArenaFighter {
 
 // Forward declarations
 class CharacterBase;
 
+// Broad phase used to find candidate collider pairs
+enum class BroadPhase {
+    Grid,            // Uniform grid, rebuilt every frame
+    SweepAndPrune    // Persistent sort on X, each overlapping pair once
+};
+
+// Narrow phase counts for the last CheckAllCollisions()
+struct CollisionStats {
+    uint32_t pairsTested;     // Pairs the broad phase and CollisionFilter let through
+    uint32_t pairsAccepted;   // Pairs whose shapes overlapped
+};
+
 // LSFDC Physics Engine
 class PhysicsEngine {
 public:
     PhysicsEngine();
     ~PhysicsEngine();
 
-    bool Initialize();
+    bool Initialize(BroadPhase broadPhase = BroadPhase::Grid);
     void Shutdown();
     void Update(float deltaTime);
+    
+    // One deterministic tick for lockstep and rollback play
+    void StepFrame();
+    static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
 
     // Collision Detection
     bool CheckCollision(const Collider* a, const Collider* b) const;
-    std::vector<CollisionResult> CheckAllCollisions();
+    // Results are reused between calls, so the reference is only valid
+    // until the next call
+    const std::vector<CollisionResult>& CheckAllCollisions();
+    
+    // Every active hitbox against every hurtbox it overlaps, as of the
+    // last Update(), batched over the collider store. A character's
+    // boxes share its RigidBody and never hit each other. Same reuse
+    // rule as CheckAllCollisions().
+    const std::vector<CollisionResult>& CheckHitboxes();
     
     // Collider Management
     void AddCollider(Collider* collider);
@@ -59,10 +86,12 @@ public:
     
     // Spatial Optimization
     std::vector<Collider*> GetNearbyColliders(const DirectX::XMFLOAT2& position, float radius) const;
+    BroadPhase GetBroadPhase() const { return m_broadPhase; }
     
     // Debug
     void EnableDebugDraw(bool enable) { m_debugDraw = enable; }
     void DrawDebugInfo();
+    const CollisionStats& GetCollisionStats() const { return m_collisionStats; }
 
 private:
     // Collider storage
@@ -71,7 +100,14 @@ private:
     std::vector<Collider*> m_dynamicColliders;
     
     // Spatial partitioning
+    BroadPhase m_broadPhase;
     std::unique_ptr<SpatialGrid> m_spatialGrid;
+    std::unique_ptr<SweepAndPrune> m_sweepAndPrune;
+    std::vector<CollisionResult> m_collisionResults;
+    
+    // Flat copy of m_colliders for batched overlap tests
+    ColliderStore m_colliderStore;
+    std::vector<CollisionResult> m_hitResults;
     
     // Physics constants (LSFDC standards)
     static constexpr float GRAVITY = -1200.0f;           // Arcade gravity
@@ -80,6 +116,7 @@ private:
     static constexpr float AIR_FRICTION = 0.95f;         // Air friction
     static constexpr float WALL_BOUNCE_FACTOR = 0.7f;   // Wall bounce
     static constexpr float PUSHBACK_FRICTION = 0.9f;     // Pushback deceleration
+    static constexpr float OVERLAP_TOLERANCE = 1.0f;     // Boxes must overlap by more than this
     
     // Stage boundaries
     static constexpr float STAGE_LEFT = -400.0f;
@@ -89,6 +126,7 @@ private:
     
     // Debug
     bool m_debugDraw;
+    CollisionStats m_collisionStats;
     
     // Helper methods
     void UpdateSpatialGrid();
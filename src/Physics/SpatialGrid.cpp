@@ -9,79 +9,82 @@ SpatialGrid::SpatialGrid(float minX, float minY, float maxX, float maxY, float c
     , m_minY(minY)
     , m_maxX(maxX)
     , m_maxY(maxY)
-    , m_cellSize(cellSize) {
-    
+    , m_cellSize(cellSize)
+    , m_activeCellCount(0) {
+
     // Calculate grid dimensions
     m_gridWidth = static_cast<int>(std::ceil((maxX - minX) / cellSize));
     m_gridHeight = static_cast<int>(std::ceil((maxY - minY) / cellSize));
+
+    m_cellStart.assign(static_cast<size_t>(GetCellCount()) + 1, 0);
+    m_cursor.resize(static_cast<size_t>(GetCellCount()));
 }
 
 void SpatialGrid::Clear() {
-    m_cells.clear();
+    m_entries.clear();
+    m_cellEntries.clear();
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+    m_activeCellCount = 0;
 }
 
 void SpatialGrid::Insert(Collider* collider) {
     if (!collider || !collider->IsActive()) return;
-    
-    // Get AABB of collider
-    AABB aabb = collider->GetAABB();
-    
-    // Get all cells this collider overlaps
-    auto cellKeys = GetCellKeysForAABB(aabb);
-    
-    // Insert into each cell
-    for (const auto& key : cellKeys) {
-        m_cells[key].push_back(collider);
-    }
+
+    Entry entry;
+    entry.collider = collider;
+    entry.bounds = collider->GetAABB();
+    entry.cells = GetCellRange(entry.bounds);
+    entry.filter = CollisionFilter::MakeKey(*collider);
+    m_entries.push_back(entry);
 }
 
 void SpatialGrid::Remove(Collider* collider) {
     if (!collider) return;
-    
-    // Get AABB of collider
-    AABB aabb = collider->GetAABB();
-    
-    // Get all cells this collider might be in
-    auto cellKeys = GetCellKeysForAABB(aabb);
-    
-    // Remove from each cell
-    for (const auto& key : cellKeys) {
-        auto it = m_cells.find(key);
-        if (it != m_cells.end()) {
-            auto& colliders = it->second;
-            colliders.erase(
-                std::remove(colliders.begin(), colliders.end(), collider),
-                colliders.end()
-            );
-            
-            // Remove empty cells
-            if (colliders.empty()) {
-                m_cells.erase(it);
+
+    m_entries.erase(
+        std::remove_if(m_entries.begin(), m_entries.end(),
+            [collider](const Entry& entry) { return entry.collider == collider; }),
+        m_entries.end()
+    );
+    Build();
+}
+
+void SpatialGrid::Build() {
+    // Count each cell's colliders one slot ahead...
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+    for (const Entry& entry : m_entries) {
+        for (int y = entry.cells.minY; y <= entry.cells.maxY; ++y) {
+            for (int x = entry.cells.minX; x <= entry.cells.maxX; ++x) {
+                m_cellStart[GetCellIndex(x, y) + 1]++;
             }
         }
     }
-}
 
-std::vector<Collider*> SpatialGrid::GetCollidersInAABB(const AABB& aabb) const {
-    std::vector<Collider*> result;
-    std::unordered_map<Collider*, bool> addedColliders;
-    
-    // Get all cells that overlap with AABB
-    auto cellKeys = GetCellKeysForAABB(aabb);
-    
-    // Collect unique colliders from all cells
-    for (const auto& key : cellKeys) {
-        auto it = m_cells.find(key);
-        if (it != m_cells.end()) {
-            for (auto* collider : it->second) {
-                if (!addedColliders[collider]) {
-                    result.push_back(collider);
-                    addedColliders[collider] = true;
-                }
+    // ...so the running sum turns counts into start offsets
+    m_activeCellCount = 0;
+    for (size_t cell = 1; cell < m_cellStart.size(); ++cell) {
+        m_activeCellCount += m_cellStart[cell] > 0 ? 1 : 0;
+        m_cellStart[cell] += m_cellStart[cell - 1];
+    }
+
+    m_cellEntries.resize(m_cellStart.back());
+    std::copy(m_cellStart.begin(), m_cellStart.end() - 1, m_cursor.begin());
+
+    for (uint32_t index = 0; index < m_entries.size(); ++index) {
+        const CellRange& cells = m_entries[index].cells;
+        for (int y = cells.minY; y <= cells.maxY; ++y) {
+            for (int x = cells.minX; x <= cells.maxX; ++x) {
+                m_cellEntries[m_cursor[GetCellIndex(x, y)]++] = index;
             }
         }
     }
-    
+}
+
+std::vector<Collider*> SpatialGrid::GetCollidersInAABB(const AABB& aabb) const {
+    std::vector<Collider*> result;
+    ForEachInAABB(aabb, [&](uint32_t entry) {
+        result.push_back(m_entries[entry].collider);
+    });
     return result;
 }
 
@@ -92,76 +95,40 @@ std::vector<Collider*> SpatialGrid::GetCollidersInRadius(const DirectX::XMFLOAT2
     queryAABB.min.y = center.y - radius;
     queryAABB.max.x = center.x + radius;
     queryAABB.max.y = center.y + radius;
-    
-    // Get colliders in AABB
-    auto candidates = GetCollidersInAABB(queryAABB);
-    
+
     // Filter by actual radius
     std::vector<Collider*> result;
     float radiusSq = radius * radius;
-    
-    for (auto* collider : candidates) {
-        AABB colliderAABB = collider->GetAABB();
-        DirectX::XMFLOAT2 colliderCenter = colliderAABB.GetCenter();
-        
+
+    ForEachInAABB(queryAABB, [&](uint32_t entry) {
+        DirectX::XMFLOAT2 colliderCenter = m_entries[entry].bounds.GetCenter();
+
         float dx = colliderCenter.x - center.x;
         float dy = colliderCenter.y - center.y;
         float distSq = dx * dx + dy * dy;
-        
+
         if (distSq <= radiusSq) {
-            result.push_back(collider);
+            result.push_back(m_entries[entry].collider);
         }
-    }
-    
-    return result;
-}
+    });
 
-std::vector<std::vector<Collider*>> SpatialGrid::GetActiveCells() const {
-    std::vector<std::vector<Collider*>> result;
-    
-    for (const auto& [key, colliders] : m_cells) {
-        if (!colliders.empty()) {
-            result.push_back(colliders);
-        }
-    }
-    
     return result;
 }
 
-SpatialGrid::CellKey SpatialGrid::GetCellKey(float x, float y) const {
-    CellKey key;
-    key.x = static_cast<int>(std::floor((x - m_minX) / m_cellSize));
-    key.y = static_cast<int>(std::floor((y - m_minY) / m_cellSize));
-    return key;
-}
+SpatialGrid::CellRange SpatialGrid::GetCellRange(const AABB& aabb) const {
+    CellRange range;
+    range.minX = static_cast<int>(std::floor((aabb.min.x - m_minX) / m_cellSize));
+    range.maxX = static_cast<int>(std::floor((aabb.max.x - m_minX) / m_cellSize));
+    range.minY = static_cast<int>(std::floor((aabb.min.y - m_minY) / m_cellSize));
+    range.maxY = static_cast<int>(std::floor((aabb.max.y - m_minY) / m_cellSize));
 
-std::vector<SpatialGrid::CellKey> SpatialGrid::GetCellKeysForAABB(const AABB& aabb) const {
-    std::vector<CellKey> keys;
-    
-    // Get cell range
-    int minCellX = static_cast<int>(std::floor((aabb.min.x - m_minX) / m_cellSize));
-    int maxCellX = static_cast<int>(std::floor((aabb.max.x - m_minX) / m_cellSize));
-    int minCellY = static_cast<int>(std::floor((aabb.min.y - m_minY) / m_cellSize));
-    int maxCellY = static_cast<int>(std::floor((aabb.max.y - m_minY) / m_cellSize));
-    
-    // Clamp to grid bounds
-    minCellX = std::max(0, minCellX);
-    maxCellX = std::min(m_gridWidth - 1, maxCellX);
-    minCellY = std::max(0, minCellY);
-    maxCellY = std::min(m_gridHeight - 1, maxCellY);
-    
-    // Add all cells in range
-    for (int y = minCellY; y <= maxCellY; ++y) {
-        for (int x = minCellX; x <= maxCellX; ++x) {
-            keys.push_back({x, y});
-        }
-    }
-    
-    return keys;
-}
+    // Clamp to grid bounds; a box entirely outside ends up empty
+    range.minX = std::max(0, range.minX);
+    range.maxX = std::min(m_gridWidth - 1, range.maxX);
+    range.minY = std::max(0, range.minY);
+    range.maxY = std::min(m_gridHeight - 1, range.maxY);
 
-bool SpatialGrid::IsValidCell(int x, int y) const {
-    return x >= 0 && x < m_gridWidth && y >= 0 && y < m_gridHeight;
+    return range;
 }
 
-} // namespace ArenaFighter
\ No newline at end of file
+} // namespace ArenaFighter
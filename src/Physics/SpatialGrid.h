@@ -1,67 +1,152 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
-#include <unordered_map>
 #include <DirectXMath.h>
 #include "Collider.h"
+#include "CollisionFilter.h"
 
 namespace ArenaFighter {
 
-// Spatial grid for broad-phase collision detection
+// Spatial grid for broad-phase collision detection. The stage is a fixed
+// box of a few hundred cells, so every cell exists: one offset per cell
+// into a single index buffer. Build() counting-sorts the frame's inserted
+// colliders into that buffer, and queries scan contiguous index ranges
+// instead of chasing hash buckets. Storage is reused from frame to frame.
 class SpatialGrid {
 public:
     SpatialGrid(float minX, float minY, float maxX, float maxY, float cellSize);
     ~SpatialGrid() = default;
-    
+
     // Clear all colliders from grid
     void Clear();
-    
-    // Insert a collider into the grid
+
+    // Insert a collider; it shows up in queries after the next Build()
     void Insert(Collider* collider);
-    
-    // Remove a collider from the grid
+
+    // Remove a collider from the grid and rebuild
     void Remove(Collider* collider);
-    
+
+    // Sorts the inserted colliders into their cells; call once per frame
+    // after inserting
+    void Build();
+
     // Get all colliders in cells that overlap with given AABB
     std::vector<Collider*> GetCollidersInAABB(const AABB& aabb) const;
-    
+
     // Get all colliders within a radius
     std::vector<Collider*> GetCollidersInRadius(const DirectX::XMFLOAT2& center, float radius) const;
-    
-    // Get all active cells (cells containing colliders)
-    std::vector<std::vector<Collider*>> GetActiveCells() const;
-    
+
+    // Calls visit(entry) once for every collider in cells overlapping aabb.
+    // A collider spanning several of them is reported from the first one
+    // only, so no visited set is needed.
+    template <typename Visit>
+    void ForEachInAABB(const AABB& aabb, Visit&& visit) const;
+
+    // Calls visit(entries, count) for every non-empty cell
+    template <typename Visit>
+    void ForEachCell(Visit&& visit) const;
+
+    // Calls visit(a, b) once for every pair of entries whose bounds
+    // overlap and that CollisionFilter accepts, from the first cell the
+    // two share
+    template <typename Visit>
+    void ForEachPair(Visit&& visit) const;
+
+    // Entries are indices in insertion order
+    size_t GetEntryCount() const { return m_entries.size(); }
+    Collider* GetCollider(uint32_t entry) const { return m_entries[entry].collider; }
+    const AABB& GetBounds(uint32_t entry) const { return m_entries[entry].bounds; }
+
     // Debug info
     int GetCellCount() const { return m_gridWidth * m_gridHeight; }
-    int GetActiveCellCount() const { return static_cast<int>(m_cells.size()); }
-    
+    int GetActiveCellCount() const { return m_activeCellCount; }
+
 private:
     // Grid dimensions
     float m_minX, m_minY, m_maxX, m_maxY;
     float m_cellSize;
     int m_gridWidth, m_gridHeight;
-    
-    // Storage - using hash map for sparse grid
-    struct CellKey {
-        int x, y;
-        
-        bool operator==(const CellKey& other) const {
-            return x == other.x && y == other.y;
-        }
+
+    // Inclusive cell range, empty when outside the grid
+    struct CellRange {
+        int minX, minY, maxX, maxY;
     };
-    
-    struct CellKeyHash {
-        std::size_t operator()(const CellKey& key) const {
-            return std::hash<int>()(key.x) ^ (std::hash<int>()(key.y) << 1);
-        }
+
+    // Bounds are read once on insert, so queries make no virtual calls
+    struct Entry {
+        Collider* collider;
+        AABB bounds;
+        CellRange cells;
+        CollisionFilter::Key filter;
     };
-    
-    std::unordered_map<CellKey, std::vector<Collider*>, CellKeyHash> m_cells;
-    
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_cellStart;     // Cell c holds m_cellEntries[m_cellStart[c], m_cellStart[c + 1])
+    std::vector<uint32_t> m_cellEntries;   // Entry indices grouped by cell
+    std::vector<uint32_t> m_cursor;        // Build() scratch
+    int m_activeCellCount;
+
     // Helper methods
-    CellKey GetCellKey(float x, float y) const;
-    std::vector<CellKey> GetCellKeysForAABB(const AABB& aabb) const;
-    bool IsValidCell(int x, int y) const;
+    CellRange GetCellRange(const AABB& aabb) const;
+    int GetCellIndex(int x, int y) const { return y * m_gridWidth + x; }
 };
 
-} // namespace ArenaFighter
\ No newline at end of file
+template <typename Visit>
+void SpatialGrid::ForEachInAABB(const AABB& aabb, Visit&& visit) const {
+    CellRange range = GetCellRange(aabb);
+
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            int cell = GetCellIndex(x, y);
+            for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i) {
+                uint32_t entry = m_cellEntries[i];
+                const CellRange& cells = m_entries[entry].cells;
+
+                // The first cell the collider and the query share
+                if (x == std::max(range.minX, cells.minX) && y == std::max(range.minY, cells.minY)) {
+                    visit(entry);
+                }
+            }
+        }
+    }
+}
+
+template <typename Visit>
+void SpatialGrid::ForEachCell(Visit&& visit) const {
+    for (int cell = 0; cell < GetCellCount(); ++cell) {
+        uint32_t begin = m_cellStart[cell];
+        uint32_t end = m_cellStart[cell + 1];
+        if (end > begin) {
+            visit(m_cellEntries.data() + begin, static_cast<size_t>(end - begin));
+        }
+    }
+}
+
+template <typename Visit>
+void SpatialGrid::ForEachPair(Visit&& visit) const {
+    for (int y = 0; y < m_gridHeight; ++y) {
+        for (int x = 0; x < m_gridWidth; ++x) {
+            int cell = GetCellIndex(x, y);
+            for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i) {
+                const Entry& a = m_entries[m_cellEntries[i]];
+                for (uint32_t j = i + 1; j < m_cellStart[cell + 1]; ++j) {
+                    const Entry& b = m_entries[m_cellEntries[j]];
+
+                    // Overlapping boxes share a run of cells; only the
+                    // first of them reports the pair
+                    if (x == std::max(a.cells.minX, b.cells.minX) &&
+                        y == std::max(a.cells.minY, b.cells.minY) &&
+                        a.bounds.min.x <= b.bounds.max.x && b.bounds.min.x <= a.bounds.max.x &&
+                        a.bounds.min.y <= b.bounds.max.y && b.bounds.min.y <= a.bounds.max.y &&
+                        CollisionFilter::Accepts(a.filter, b.filter)) {
+                        visit(a.collider, b.collider);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace ArenaFighter
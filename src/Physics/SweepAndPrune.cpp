@@ -0,0 +1,81 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+namespace ArenaFighter {
+
+SweepAndPrune::SweepAndPrune()
+    : m_maxWidth(0.0f)
+    , m_lastSwaps(0) {
+}
+
+void SweepAndPrune::Clear() {
+    m_entries.clear();
+    m_maxWidth = 0.0f;
+}
+
+void SweepAndPrune::Insert(Collider* collider) {
+    if (!collider) return;
+
+    // Inactive until the next Update(), but placed by its current bounds
+    // so queries in between still binary-search a sorted array
+    AABB aabb = collider->GetAABB();
+    Entry entry = {};
+    entry.minX = aabb.min.x;
+    entry.maxX = aabb.max.x;
+    entry.minY = aabb.min.y;
+    entry.maxY = aabb.max.y;
+    entry.collider = collider;
+    entry.active = false;
+
+    auto it = std::upper_bound(m_entries.begin(), m_entries.end(), entry.minX,
+        [](float value, const Entry& other) { return value < other.minX; });
+    m_entries.insert(it, entry);
+}
+
+void SweepAndPrune::Remove(Collider* collider) {
+    // Erasing keeps the rest in order
+    m_entries.erase(
+        std::remove_if(m_entries.begin(), m_entries.end(),
+            [collider](const Entry& entry) { return entry.collider == collider; }),
+        m_entries.end()
+    );
+}
+
+void SweepAndPrune::Update() {
+    m_maxWidth = 0.0f;
+    for (Entry& entry : m_entries) {
+        AABB aabb = entry.collider->GetAABB();
+        entry.minX = aabb.min.x;
+        entry.maxX = aabb.max.x;
+        entry.minY = aabb.min.y;
+        entry.maxY = aabb.max.y;
+        entry.filter = CollisionFilter::MakeKey(*entry.collider);
+        entry.active = entry.collider->IsActive();
+        if (entry.active) {
+            m_maxWidth = std::max(m_maxWidth, entry.maxX - entry.minX);
+        }
+    }
+
+    // Insertion sort: nearly sorted input, so about one comparison each
+    m_lastSwaps = 0;
+    for (size_t i = 1; i < m_entries.size(); ++i) {
+        if (m_entries[i - 1].minX <= m_entries[i].minX) continue;
+
+        Entry moving = m_entries[i];
+        size_t j = i;
+        while (j > 0 && m_entries[j - 1].minX > moving.minX) {
+            m_entries[j] = m_entries[j - 1];
+            --j;
+        }
+        m_entries[j] = moving;
+        m_lastSwaps += static_cast<uint32_t>(i - j);
+    }
+}
+
+size_t SweepAndPrune::LowerBound(float minX) const {
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), minX,
+        [](const Entry& entry, float value) { return entry.minX < value; });
+    return static_cast<size_t>(it - m_entries.begin());
+}
+
+} // namespace ArenaFighter
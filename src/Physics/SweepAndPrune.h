@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Collider.h"
+#include "CollisionFilter.h"
+
+namespace ArenaFighter {
+
+// Sweep-and-prune broad phase on the X axis. Fighters spread out along a
+// side-view stage far more than they stack up, so sorting by min x leaves
+// few candidates per collider. Colliders stay registered between frames
+// and the sorted order is kept too: Update() re-reads the bounds and an
+// insertion sort restores the order, which costs little more than one
+// pass because bodies move only a few units per frame. Nothing is
+// allocated after the colliders are added.
+class SweepAndPrune {
+public:
+    SweepAndPrune();
+
+    void Clear();
+    void Insert(Collider* collider);
+    void Remove(Collider* collider);
+
+    // Re-reads every collider's bounds and active flag, then re-sorts
+    void Update();
+
+    // Calls visit(a, b) exactly once for every pair of active colliders
+    // whose bounds overlap and that CollisionFilter accepts, as of the
+    // last Update()
+    template <typename Visit>
+    void ForEachPair(Visit&& visit) const;
+
+    // Calls visit(collider) for every active collider whose bounds
+    // overlap aabb
+    template <typename Visit>
+    void ForEachInAABB(const AABB& aabb, Visit&& visit) const;
+
+    // Stats
+    size_t GetCount() const { return m_entries.size(); }
+    uint32_t GetLastSwapCount() const { return m_lastSwaps; }   // Insertion sort moves in the last Update()
+
+private:
+    struct Entry {
+        float minX, maxX, minY, maxY;
+        Collider* collider;
+        CollisionFilter::Key filter;
+        bool active;
+    };
+
+    size_t LowerBound(float minX) const;
+
+    std::vector<Entry> m_entries;   // By minX, kept sorted by Insert() and Update()
+    float m_maxWidth;               // Widest active box, bounds ForEachInAABB()'s search
+    uint32_t m_lastSwaps;
+};
+
+template <typename Visit>
+void SweepAndPrune::ForEachPair(Visit&& visit) const {
+    size_t count = m_entries.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Entry& a = m_entries[i];
+        if (!a.active) continue;
+
+        // Only later entries can start inside a, so each pair comes up once
+        for (size_t j = i + 1; j < count && m_entries[j].minX <= a.maxX; ++j) {
+            const Entry& b = m_entries[j];
+            if (b.active && a.minY <= b.maxY && b.minY <= a.maxY && CollisionFilter::Accepts(a.filter, b.filter)) {
+                visit(a.collider, b.collider);
+            }
+        }
+    }
+}
+
+template <typename Visit>
+void SweepAndPrune::ForEachInAABB(const AABB& aabb, Visit&& visit) const {
+    for (size_t i = LowerBound(aabb.min.x - m_maxWidth); i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        if (entry.minX > aabb.max.x) break;
+
+        if (entry.active && entry.maxX >= aabb.min.x && entry.minY <= aabb.max.y && aabb.min.y <= entry.maxY) {
+            visit(entry.collider);
+        }
+    }
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,1013 @@
+#include <gtest/gtest.h>
+#include "../Collider.h"
+#include "../ColliderStore.h"
+#include "../CollisionFilter.h"
+#include "../HitboxManager.h"
+#include "../SpatialGrid.h"
+#include "../SweepAndPrune.h"
+#include "../../Core/DeterministicRandom.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Counts global heap allocations so the broad phase tests can check that
+// a warmed-up frame allocates nothing
+static std::atomic<size_t> g_allocationCount{0};
+
+// The whole unaligned family is replaced so every form pairs malloc with
+// free; aligned allocations keep the library's own pair. The scalar pair
+// stays out of line, or GCC sees malloc matched with operator delete
+// after inlining and warns
+[[gnu::noinline]] void* operator new(size_t size) {
+    g_allocationCount++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+
+namespace ArenaFighter {
+namespace Tests {
+
+namespace {
+
+// The grid PhysicsEngine::Initialize() builds: the stage plus 100 units
+// of padding, 50-unit cells
+constexpr float GRID_MIN_X = -500.0f;
+constexpr float GRID_MIN_Y = -100.0f;
+constexpr float GRID_MAX_X = 500.0f;
+constexpr float GRID_MAX_Y = 700.0f;
+constexpr float CELL_SIZE = 50.0f;
+
+SpatialGrid MakeStageGrid() {
+    return SpatialGrid(GRID_MIN_X, GRID_MIN_Y, GRID_MAX_X, GRID_MAX_Y, CELL_SIZE);
+}
+
+bool Overlaps(const AABB& a, const AABB& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+// An 8-player DeathMatch: a pushbox and two hurtboxes per player, then
+// alternately projectiles and Yuito pets, all moving around the stage
+class DeathMatchScene {
+public:
+    DeathMatchScene(size_t colliderCount, uint64_t seed) : m_random(seed) {
+        for (size_t i = 0; i < colliderCount; ++i) {
+            Body body;
+            body.x = -380.0f + m_random.NextFloat() * 760.0f;
+            body.y = 20.0f + m_random.NextFloat() * 560.0f;
+            body.vx = (m_random.NextFloat() - 0.5f) * 12.0f;
+            body.vy = (m_random.NextFloat() - 0.5f) * 12.0f;
+
+            if (i < 24) {
+                auto box = std::make_unique<BoxCollider>(i % 3 == 0 ? 60.0f : 40.0f, i % 3 == 0 ? 120.0f : 50.0f);
+                box->SetType(i % 3 == 0 ? CollisionType::Pushbox : CollisionType::Hurtbox);
+                box->SetLayer(CollisionLayer::Player);
+                body.collider = std::move(box);
+            } else if (i % 2 == 0) {
+                auto projectile = std::make_unique<CircleCollider>(12.0f);
+                projectile->SetType(CollisionType::Projectile);
+                projectile->SetLayer(CollisionLayer::Projectile);
+                body.collider = std::move(projectile);
+            } else {
+                auto pet = std::make_unique<BoxCollider>(40.0f, 40.0f);
+                pet->SetType(CollisionType::Hitbox);
+                pet->SetLayer(CollisionLayer::Player);
+                body.collider = std::move(pet);
+            }
+            m_bodies.push_back(std::move(body));
+        }
+        Place();
+    }
+
+    void Step() {
+        for (Body& body : m_bodies) {
+            body.x += body.vx;
+            body.y += body.vy;
+            if (body.x < -400.0f || body.x > 400.0f) body.vx = -body.vx;
+            if (body.y < 0.0f || body.y > 600.0f) body.vy = -body.vy;
+        }
+        Place();
+    }
+
+    size_t GetCount() const { return m_bodies.size(); }
+    Collider* Get(size_t index) const { return m_bodies[index].collider.get(); }
+
+private:
+    struct Body {
+        std::unique_ptr<Collider> collider;
+        float x, y, vx, vy;
+    };
+
+    void Place() {
+        for (Body& body : m_bodies) {
+            DirectX::XMFLOAT2 position(body.x, body.y);
+            if (body.collider->GetShape() == ColliderShape::Box) {
+                static_cast<BoxCollider*>(body.collider.get())->SetCenter(position);
+            } else {
+                static_cast<CircleCollider*>(body.collider.get())->SetPosition(position);
+            }
+        }
+    }
+
+    DeterministicRandom m_random;
+    std::vector<Body> m_bodies;
+};
+
+// The hashed cell map SpatialGrid used to be, kept as the benchmark's
+// baseline
+class HashedGrid {
+public:
+    void Clear() { m_cells.clear(); }
+
+    void Insert(Collider* collider) {
+        AABB aabb = collider->GetAABB();
+        for (const CellKey& key : GetCellKeys(aabb)) {
+            m_cells[key].push_back(collider);
+        }
+    }
+
+    std::vector<std::vector<Collider*>> GetActiveCells() const {
+        std::vector<std::vector<Collider*>> result;
+        for (const auto& [key, colliders] : m_cells) {
+            result.push_back(colliders);
+        }
+        return result;
+    }
+
+private:
+    struct CellKey {
+        int x, y;
+        bool operator==(const CellKey& other) const { return x == other.x && y == other.y; }
+    };
+
+    struct CellKeyHash {
+        std::size_t operator()(const CellKey& key) const {
+            return std::hash<int>()(key.x) ^ (std::hash<int>()(key.y) << 1);
+        }
+    };
+
+    std::vector<CellKey> GetCellKeys(const AABB& aabb) const {
+        int width = static_cast<int>((GRID_MAX_X - GRID_MIN_X) / CELL_SIZE);
+        int height = static_cast<int>((GRID_MAX_Y - GRID_MIN_Y) / CELL_SIZE);
+        int minX = std::max(0, static_cast<int>(std::floor((aabb.min.x - GRID_MIN_X) / CELL_SIZE)));
+        int maxX = std::min(width - 1, static_cast<int>(std::floor((aabb.max.x - GRID_MIN_X) / CELL_SIZE)));
+        int minY = std::max(0, static_cast<int>(std::floor((aabb.min.y - GRID_MIN_Y) / CELL_SIZE)));
+        int maxY = std::min(height - 1, static_cast<int>(std::floor((aabb.max.y - GRID_MIN_Y) / CELL_SIZE)));
+
+        std::vector<CellKey> keys;
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x) {
+                keys.push_back({x, y});
+            }
+        }
+        return keys;
+    }
+
+    std::unordered_map<CellKey, std::vector<Collider*>, CellKeyHash> m_cells;
+};
+
+using ColliderPair = std::pair<Collider*, Collider*>;
+
+ColliderPair Ordered(Collider* a, Collider* b) {
+    return a < b ? ColliderPair(a, b) : ColliderPair(b, a);
+}
+
+bool Accepts(const Collider* a, const Collider* b) {
+    return CollisionFilter::Accepts(CollisionFilter::MakeKey(*a), CollisionFilter::MakeKey(*b));
+}
+
+// Every pair of active colliders whose bounds overlap and that the
+// filter accepts, sorted
+std::vector<ColliderPair> BruteForcePairs(const DeathMatchScene& scene) {
+    std::vector<ColliderPair> pairs;
+    for (size_t i = 0; i < scene.GetCount(); ++i) {
+        for (size_t j = i + 1; j < scene.GetCount(); ++j) {
+            Collider* a = scene.Get(i);
+            Collider* b = scene.Get(j);
+            if (a->IsActive() && b->IsActive() && Overlaps(a->GetAABB(), b->GetAABB()) && Accepts(a, b)) {
+                pairs.push_back(Ordered(a, b));
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+// Eight players, each with MAX_HITBOXES hitboxes, MAX_HURTBOXES
+// hurtboxes and a pushbox placed around it the way HitboxManager lays
+// them out, walking back and forth across the stage
+class PlayerScene {
+public:
+    static constexpr int PLAYERS = 8;
+    static constexpr int HITBOXES = 3;
+    static constexpr int HURTBOXES = 5;
+
+    explicit PlayerScene(uint64_t seed) : m_random(seed) {
+        for (int p = 0; p < PLAYERS; ++p) {
+            Player& player = m_players[p];
+            player.x = -350.0f + 100.0f * p;
+            player.y = m_random.NextFloat() * 100.0f;
+            player.vx = (m_random.NextFloat() - 0.5f) * 8.0f;
+
+            for (int i = 0; i < HURTBOXES; ++i) {
+                player.hurtboxes[i] = std::make_unique<BoxCollider>(40.0f, 35.0f);
+                player.hurtboxes[i]->SetType(CollisionType::Hurtbox);
+                player.hurtboxes[i]->SetLayer(CollisionLayer::Player);
+                player.hurtboxes[i]->SetRigidBody(&player.body);
+            }
+            for (int i = 0; i < HITBOXES; ++i) {
+                player.hitboxes[i] = std::make_unique<BoxCollider>(50.0f, 20.0f);
+                player.hitboxes[i]->SetType(CollisionType::Hitbox);
+                player.hitboxes[i]->SetLayer(CollisionLayer::Player);
+                player.hitboxes[i]->SetRigidBody(&player.body);
+            }
+            player.pushbox = std::make_unique<BoxCollider>(30.0f, 80.0f);
+            player.pushbox->SetLayer(CollisionLayer::Player);
+            player.pushbox->SetRigidBody(&player.body);
+        }
+        Place();
+    }
+
+    void Step() {
+        for (Player& player : m_players) {
+            player.x += player.vx;
+            if (player.x < -400.0f || player.x > 400.0f) player.vx = -player.vx;
+        }
+        Place();
+    }
+
+    template <typename Visit>
+    void ForEachCollider(Visit&& visit) const {
+        for (const Player& player : m_players) {
+            for (const auto& box : player.hitboxes) visit(box.get());
+            for (const auto& box : player.hurtboxes) visit(box.get());
+            visit(player.pushbox.get());
+        }
+    }
+
+    // Each character's hitboxes against every other character's
+    // hurtboxes, through the virtual interface the way
+    // PhysicsEngine::ProcessHitDetection() does it
+    size_t CountHitsVirtual() const {
+        size_t hits = 0;
+        for (int a = 0; a < PLAYERS; ++a) {
+            for (int d = 0; d < PLAYERS; ++d) {
+                if (a == d) continue;
+                for (const auto& hitbox : m_players[a].hitboxes) {
+                    for (const auto& hurtbox : m_players[d].hurtboxes) {
+                        hits += CheckVirtual(hitbox.get(), hurtbox.get()) ? 1 : 0;
+                    }
+                }
+            }
+        }
+        return hits;
+    }
+
+private:
+    struct Player {
+        std::unique_ptr<BoxCollider> hitboxes[HITBOXES];
+        std::unique_ptr<BoxCollider> hurtboxes[HURTBOXES];
+        std::unique_ptr<BoxCollider> pushbox;
+        RigidBody body;
+        float x, y, vx;
+    };
+
+    // PhysicsEngine::CheckCollision() for two colliders of unknown shape
+    static bool CheckVirtual(const Collider* a, const Collider* b) {
+        if (!a->IsActive() || !b->IsActive()) return false;
+        if (!a->CanCollideWith(b->GetLayer()) || !b->CanCollideWith(a->GetLayer())) return false;
+        if (a->GetShape() != ColliderShape::Box || b->GetShape() != ColliderShape::Box) return false;
+
+        const float tolerance = 1.0f;
+        AABB boxA = a->GetAABB();
+        AABB boxB = b->GetAABB();
+        return !(boxA.min.x > boxB.max.x - tolerance || boxA.max.x < boxB.min.x + tolerance ||
+                 boxA.min.y > boxB.max.y - tolerance || boxA.max.y < boxB.min.y + tolerance);
+    }
+
+    void Place() {
+        for (Player& player : m_players) {
+            for (int i = 0; i < HURTBOXES; ++i) {
+                player.hurtboxes[i]->SetCenter(DirectX::XMFLOAT2(player.x, player.y + 25.0f * i));
+            }
+            for (int i = 0; i < HITBOXES; ++i) {
+                player.hitboxes[i]->SetCenter(DirectX::XMFLOAT2(player.x + 40.0f + 15.0f * i, player.y + 30.0f * i + 20.0f));
+            }
+            player.pushbox->SetCenter(DirectX::XMFLOAT2(player.x, player.y + 40.0f));
+        }
+    }
+
+    DeterministicRandom m_random;
+    Player m_players[PLAYERS];
+};
+
+// PhysicsEngine::CheckHitboxes() over a store
+size_t CountHitsBatched(const ColliderStore& store) {
+    const int hitboxBit = ColliderStore::TypeBit(CollisionType::Hitbox);
+    const int hurtboxBit = ColliderStore::TypeBit(CollisionType::Hurtbox);
+
+    size_t hits = 0;
+    for (size_t i = 0; i < store.GetCount(); ++i) {
+        if (store.GetTypeBits(i) != hitboxBit) continue;
+
+        ColliderStore::Query query = store.MakeQuery(i, hurtboxBit, -1.0f);
+        RigidBody* owner = store.GetCollider(i)->GetRigidBody();
+        store.ForEachOverlap(query, [&](size_t j) {
+            hits += store.GetCollider(j)->GetRigidBody() != owner ? 1 : 0;
+        });
+    }
+    return hits;
+}
+
+// A move's frames: startup, three active frames with a swept hitbox,
+// recovery, most of them held for several ticks like real frame data
+std::vector<HitboxManager::FrameData> MakeAttackFrames(float reach) {
+    std::vector<HitboxManager::FrameData> frames;
+    for (int tick = 0; tick < 30; ++tick) {
+        HitboxManager::FrameData frame = StandardBoxes::MEDIUM_IDLE;
+        frame.pushboxOffset = { tick < 10 ? 0.0f : 5.0f, 0.0f };
+        frame.hurtboxes[3] = { 30.0f, 40.0f, 30.0f, 20.0f, tick >= 6 && tick < 24, false };
+        frame.hurtboxes[4] = { 0.0f, 80.0f, 20.0f, 20.0f, true, tick < 4 };
+
+        int active = tick >= 10 && tick < 16 ? (tick - 10) / 2 : -1;
+        if (active >= 0) {
+            HitboxManager::HitboxData& hitbox = frame.hitboxes[0];
+            hitbox = { reach + 10.0f * active, 40.0f, 40.0f, 20.0f, 60.0f, 18, 12, { 150.0f, 80.0f }, 2, true };
+        }
+        frame.throwboxActive = tick == 8;
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+// The string-keyed UpdateBoxes HitboxManager used to have, kept as the
+// benchmark's baseline
+class NamedHitboxes {
+public:
+    NamedHitboxes() {
+        for (auto& box : m_hurtboxes) box = std::make_unique<BoxCollider>();
+        for (auto& box : m_hitboxes) box = std::make_unique<BoxCollider>();
+        m_pushbox = std::make_unique<BoxCollider>();
+        m_throwbox = std::make_unique<BoxCollider>();
+    }
+
+    void LoadAnimationData(const std::string& name, const std::vector<HitboxManager::FrameData>& frames) {
+        m_animationData[name] = frames;
+    }
+
+    void UpdateBoxes(const std::string& animationName, int frame, int facingDirection) {
+        m_currentAnimation = animationName;
+        m_facingDirection = facingDirection;
+        auto it = m_animationData.find(animationName);
+        if (it != m_animationData.end() && frame < static_cast<int>(it->second.size())) {
+            Apply(it->second[frame]);
+        }
+    }
+
+private:
+    void Apply(const HitboxManager::FrameData& frameData) {
+        for (int i = 0; i < HitboxManager::MAX_HURTBOXES; ++i) {
+            const auto& data = frameData.hurtboxes[i];
+            if (data.active && !data.invulnerable) {
+                m_hurtboxes[i]->SetCenter({ data.x * m_facingDirection, data.y });
+                m_hurtboxes[i]->SetSize(data.width, data.height);
+                m_hurtboxes[i]->SetActive(true);
+            } else {
+                m_hurtboxes[i]->SetActive(false);
+            }
+        }
+        for (int i = 0; i < HitboxManager::MAX_HITBOXES; ++i) {
+            const auto& data = frameData.hitboxes[i];
+            if (data.active) {
+                m_hitboxes[i]->SetCenter({ data.x * m_facingDirection, data.y });
+                m_hitboxes[i]->SetSize(data.width, data.height);
+                m_hitboxes[i]->SetActive(true);
+                m_hitboxes[i]->SetDamage(data.damage);
+                m_hitboxes[i]->SetHitstun(data.hitstun);
+                m_hitboxes[i]->SetBlockstun(data.blockstun);
+                m_hitboxes[i]->SetKnockback({ data.knockback.x * m_facingDirection, data.knockback.y });
+                m_hitboxes[i]->SetPriority(data.priority);
+            } else {
+                m_hitboxes[i]->SetActive(false);
+            }
+        }
+        m_throwbox->SetActive(frameData.throwboxActive);
+        m_pushbox->SetCenter({ frameData.pushboxOffset.x * m_facingDirection, frameData.pushboxOffset.y + 30 });
+    }
+
+    std::unique_ptr<BoxCollider> m_hurtboxes[HitboxManager::MAX_HURTBOXES];
+    std::unique_ptr<BoxCollider> m_hitboxes[HitboxManager::MAX_HITBOXES];
+    std::unique_ptr<BoxCollider> m_pushbox;
+    std::unique_ptr<BoxCollider> m_throwbox;
+    std::unordered_map<std::string, std::vector<HitboxManager::FrameData>> m_animationData;
+    std::string m_currentAnimation;
+    int m_facingDirection = 1;
+};
+
+// Names long enough to defeat the small-string buffer, like real move
+// names with a character prefix
+const char* const ATTACK_NAMES[] = {
+    "Hyuk_Woon_Sung_standing_light_punch", "Hyuk_Woon_Sung_standing_heavy_punch",
+    "Hyuk_Woon_Sung_crouching_light_kick", "Hyuk_Woon_Sung_jumping_heavy_kick",
+};
+
+} // namespace
+
+TEST(SpatialGridTest, QueriesMatchBruteForce) {
+    DeathMatchScene scene(200, 3);
+    SpatialGrid grid = MakeStageGrid();
+    for (size_t i = 0; i < scene.GetCount(); ++i) {
+        grid.Insert(scene.Get(i));
+    }
+    grid.Build();
+    EXPECT_EQ(grid.GetCellCount(), 320);
+    EXPECT_GT(grid.GetActiveCellCount(), 0);
+
+    DeterministicRandom random(9);
+    for (int query = 0; query < 100; ++query) {
+        float x = -450.0f + random.NextFloat() * 900.0f;
+        float y = -50.0f + random.NextFloat() * 700.0f;
+        float size = 10.0f + random.NextFloat() * 200.0f;
+        AABB area(DirectX::XMFLOAT2(x, y), DirectX::XMFLOAT2(x + size, y + size));
+
+        std::vector<Collider*> found = grid.GetCollidersInAABB(area);
+        std::vector<Collider*> sorted = found;
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_EQ(std::unique(sorted.begin(), sorted.end()), sorted.end()) << "reported twice";
+
+        // Every collider that overlaps is found; the rest share a cell
+        for (size_t i = 0; i < scene.GetCount(); ++i) {
+            if (Overlaps(scene.Get(i)->GetAABB(), area)) {
+                EXPECT_TRUE(std::binary_search(sorted.begin(), sorted.end(), scene.Get(i)));
+            }
+        }
+    }
+}
+
+TEST(SpatialGridTest, RemoveAndRebuild) {
+    BoxCollider first(DirectX::XMFLOAT2(0.0f, 100.0f), 120.0f, 120.0f);
+    BoxCollider second(DirectX::XMFLOAT2(30.0f, 100.0f), 20.0f, 20.0f);
+    BoxCollider outside(DirectX::XMFLOAT2(2000.0f, 100.0f), 20.0f, 20.0f);
+
+    SpatialGrid grid = MakeStageGrid();
+    grid.Insert(&first);
+    grid.Insert(&second);
+    grid.Insert(&outside);
+    grid.Build();
+
+    AABB area(DirectX::XMFLOAT2(-100.0f, 0.0f), DirectX::XMFLOAT2(100.0f, 200.0f));
+    EXPECT_EQ(grid.GetCollidersInAABB(area).size(), 2u);
+    EXPECT_EQ(grid.GetCollidersInRadius(DirectX::XMFLOAT2(0.0f, 100.0f), 10.0f).size(), 1u);
+
+    grid.Remove(&first);
+    std::vector<Collider*> left = grid.GetCollidersInAABB(area);
+    ASSERT_EQ(left.size(), 1u);
+    EXPECT_EQ(left[0], &second);
+
+    grid.Clear();
+    grid.Build();
+    EXPECT_TRUE(grid.GetCollidersInAABB(area).empty());
+    EXPECT_EQ(grid.GetActiveCellCount(), 0);
+}
+
+// Broad phase per frame: rebuild the grid and walk every cell's pairs,
+// as PhysicsEngine::CheckAllCollisions() does, against the hashed map
+TEST(SpatialGridTest, BroadPhaseBenchmark) {
+    const int frames = 600;
+
+    for (size_t count : { 16u, 64u, 512u }) {
+        uint64_t hashedPairs = 0;
+        DeathMatchScene hashedScene(count, count);
+        HashedGrid hashed;
+        std::chrono::steady_clock::duration hashedTime{};
+        for (int frame = 0; frame < frames; ++frame) {
+            hashedScene.Step();
+            auto start = std::chrono::steady_clock::now();
+            hashed.Clear();
+            for (size_t i = 0; i < hashedScene.GetCount(); ++i) {
+                hashed.Insert(hashedScene.Get(i));
+            }
+            for (const auto& cell : hashed.GetActiveCells()) {
+                hashedPairs += cell.size() * (cell.size() - 1) / 2;
+            }
+            hashedTime += std::chrono::steady_clock::now() - start;
+        }
+
+        uint64_t densePairs = 0;
+        DeathMatchScene denseScene(count, count);
+        SpatialGrid dense = MakeStageGrid();
+        std::chrono::steady_clock::duration denseTime{};
+        for (int frame = 0; frame < frames; ++frame) {
+            denseScene.Step();
+            auto start = std::chrono::steady_clock::now();
+            dense.Clear();
+            for (size_t i = 0; i < denseScene.GetCount(); ++i) {
+                dense.Insert(denseScene.Get(i));
+            }
+            dense.Build();
+            dense.ForEachCell([&](const uint32_t*, size_t cellCount) {
+                densePairs += cellCount * (cellCount - 1) / 2;
+            });
+            denseTime += std::chrono::steady_clock::now() - start;
+        }
+
+        double hashedUs = std::chrono::duration<double, std::micro>(hashedTime).count() / frames;
+        double denseUs = std::chrono::duration<double, std::micro>(denseTime).count() / frames;
+        std::cout << count << " colliders: hashed grid " << hashedUs << " us/frame, dense grid "
+                  << denseUs << " us/frame (" << hashedUs / denseUs << "x), "
+                  << densePairs / frames << " cell pairs/frame\n";
+
+        // Same cells, so the same candidate pairs
+        EXPECT_EQ(densePairs, hashedPairs);
+        if (count >= 64) {
+            EXPECT_LT(denseUs, hashedUs);
+        }
+    }
+}
+
+// Both broad phases must report exactly the overlapping pairs the filter
+// accepts, each once, as the scene moves and colliders switch on and off
+TEST(SweepAndPruneTest, PairsMatchBruteForce) {
+    DeathMatchScene scene(200, 5);
+    SweepAndPrune sweep;
+    for (size_t i = 0; i < scene.GetCount(); ++i) {
+        sweep.Insert(scene.Get(i));
+    }
+
+    SpatialGrid grid = MakeStageGrid();
+    for (int frame = 0; frame < 30; ++frame) {
+        scene.Step();
+        scene.Get(frame)->SetActive(false);
+        if (frame >= 5) scene.Get(frame - 5)->SetActive(true);
+
+        std::vector<ColliderPair> expected = BruteForcePairs(scene);
+        ASSERT_FALSE(expected.empty());
+
+        sweep.Update();
+        std::vector<ColliderPair> swept;
+        sweep.ForEachPair([&](Collider* a, Collider* b) { swept.push_back(Ordered(a, b)); });
+        std::sort(swept.begin(), swept.end());
+        EXPECT_EQ(swept, expected) << "frame " << frame;
+
+        grid.Clear();
+        for (size_t i = 0; i < scene.GetCount(); ++i) {
+            grid.Insert(scene.Get(i));
+        }
+        grid.Build();
+        std::vector<ColliderPair> gridded;
+        grid.ForEachPair([&](Collider* a, Collider* b) { gridded.push_back(Ordered(a, b)); });
+        std::sort(gridded.begin(), gridded.end());
+        EXPECT_EQ(gridded, expected) << "frame " << frame;
+    }
+}
+
+TEST(SweepAndPruneTest, QueriesAndRemove) {
+    BoxCollider wide(DirectX::XMFLOAT2(0.0f, 100.0f), 600.0f, 20.0f);
+    BoxCollider near(DirectX::XMFLOAT2(250.0f, 100.0f), 20.0f, 20.0f);
+    BoxCollider far(DirectX::XMFLOAT2(250.0f, 500.0f), 20.0f, 20.0f);
+    for (BoxCollider* box : { &wide, &near, &far }) {
+        box->SetLayer(CollisionLayer::Player);
+    }
+
+    SweepAndPrune sweep;
+    sweep.Insert(&wide);
+    sweep.Insert(&near);
+    sweep.Insert(&far);
+    sweep.Update();
+
+    // wide starts far left of the query, so only the widest-box margin
+    // finds it
+    std::vector<Collider*> found;
+    AABB area(DirectX::XMFLOAT2(200.0f, 50.0f), DirectX::XMFLOAT2(280.0f, 150.0f));
+    sweep.ForEachInAABB(area, [&](Collider* collider) { found.push_back(collider); });
+    EXPECT_EQ(found.size(), 2u);
+
+    int pairs = 0;
+    sweep.ForEachPair([&](Collider*, Collider*) { ++pairs; });
+    EXPECT_EQ(pairs, 1);
+
+    sweep.Remove(&wide);
+    found.clear();
+    sweep.ForEachInAABB(area, [&](Collider* collider) { found.push_back(collider); });
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0], &near);
+
+    sweep.Clear();
+    EXPECT_EQ(sweep.GetCount(), 0u);
+}
+
+TEST(SweepAndPruneTest, InsertBetweenUpdatesKeepsQueriesSorted) {
+    DeathMatchScene scene(64, 64);
+    scene.Step();
+    SweepAndPrune sweep;
+    for (size_t i = 0; i < 32; ++i) {
+        sweep.Insert(scene.Get(i));
+    }
+    sweep.Update();
+
+    // Late joiners sit unsorted in the middle of the stage until the next
+    // Update(); queries must still find every active collider
+    for (size_t i = 32; i < scene.GetCount(); ++i) {
+        sweep.Insert(scene.Get(i));
+    }
+
+    AABB area(DirectX::XMFLOAT2(100.0f, -100.0f), DirectX::XMFLOAT2(400.0f, 700.0f));
+    size_t expected = 0;
+    for (size_t i = 0; i < 32; ++i) {
+        AABB bounds = scene.Get(i)->GetAABB();
+        if (scene.Get(i)->IsActive() && bounds.min.x <= area.max.x && area.min.x <= bounds.max.x &&
+            bounds.min.y <= area.max.y && area.min.y <= bounds.max.y) {
+            ++expected;
+        }
+    }
+    ASSERT_GT(expected, 0u);
+
+    size_t found = 0;
+    sweep.ForEachInAABB(area, [&](Collider*) { ++found; });
+    EXPECT_EQ(found, expected);
+
+    // Inserted entries join the pairs once Update() reads them
+    sweep.Update();
+    std::vector<ColliderPair> swept;
+    sweep.ForEachPair([&](Collider* a, Collider* b) { swept.push_back(Ordered(a, b)); });
+    std::sort(swept.begin(), swept.end());
+    EXPECT_EQ(swept, BruteForcePairs(scene));
+}
+
+// Per frame: update the broad phase and walk its pairs, as
+// PhysicsEngine::CheckAllCollisions() does for each BroadPhase
+TEST(SweepAndPruneTest, BroadPhaseBenchmark) {
+    const int frames = 600;
+
+    for (size_t count : { 16u, 64u, 512u }) {
+        uint64_t gridPairs = 0;
+        DeathMatchScene gridScene(count, count);
+        SpatialGrid grid = MakeStageGrid();
+        std::chrono::steady_clock::duration gridTime{};
+        for (int frame = 0; frame < frames; ++frame) {
+            gridScene.Step();
+            auto start = std::chrono::steady_clock::now();
+            grid.Clear();
+            for (size_t i = 0; i < gridScene.GetCount(); ++i) {
+                grid.Insert(gridScene.Get(i));
+            }
+            grid.Build();
+            grid.ForEachPair([&](Collider*, Collider*) { ++gridPairs; });
+            gridTime += std::chrono::steady_clock::now() - start;
+        }
+
+        uint64_t sweepPairs = 0;
+        uint64_t swaps = 0;
+        DeathMatchScene sweepScene(count, count);
+        SweepAndPrune sweep;
+        for (size_t i = 0; i < sweepScene.GetCount(); ++i) {
+            sweep.Insert(sweepScene.Get(i));
+        }
+        sweep.Update();
+        size_t allocations = g_allocationCount;
+        std::chrono::steady_clock::duration sweepTime{};
+        for (int frame = 0; frame < frames; ++frame) {
+            sweepScene.Step();
+            auto start = std::chrono::steady_clock::now();
+            sweep.Update();
+            sweep.ForEachPair([&](Collider*, Collider*) { ++sweepPairs; });
+            sweepTime += std::chrono::steady_clock::now() - start;
+            swaps += sweep.GetLastSwapCount();
+        }
+        allocations = g_allocationCount - allocations;
+
+        double gridUs = std::chrono::duration<double, std::micro>(gridTime).count() / frames;
+        double sweepUs = std::chrono::duration<double, std::micro>(sweepTime).count() / frames;
+        std::cout << count << " colliders: grid " << gridUs << " us/frame, sweep and prune "
+                  << sweepUs << " us/frame (" << gridUs / sweepUs << "x), "
+                  << sweepPairs / frames << " pairs/frame, "
+                  << swaps / frames << " swaps/frame\n";
+
+        // Same scene, so the same overlapping pairs
+        EXPECT_EQ(sweepPairs, gridPairs);
+        EXPECT_EQ(allocations, 0u);
+
+        // At match-sized counts; a 512-body crowd narrows the gap
+        if (count <= 64) {
+            EXPECT_LT(sweepUs, gridUs);
+        }
+    }
+}
+
+// The kernel must agree with the plain per-entry test for every filter
+TEST(ColliderStoreTest, OverlapsMatchBruteForce) {
+    EXPECT_EQ(ColliderStore::BATCH, 8u);
+    std::cout << "collider store kernel: " << ColliderStore::GetKernelName() << "\n";
+
+    const CollisionLayer layers[] = { CollisionLayer::Player, CollisionLayer::Enemy,
+                                      CollisionLayer::Projectile, CollisionLayer::Environment };
+    DeathMatchScene scene(203, 11);
+    DeterministicRandom random(4);
+    ColliderStore store;
+    for (size_t i = 0; i < scene.GetCount(); ++i) {
+        Collider* collider = scene.Get(i);
+        collider->SetType(static_cast<CollisionType>(random.NextInt(6)));
+        collider->SetLayer(layers[random.NextInt(4)]);
+        collider->SetLayerMask(random.NextChance(70) ? static_cast<int>(CollisionLayer::All) : 1 + static_cast<int>(random.NextInt(15)));
+        collider->SetActive(random.NextChance(90));
+        store.Add(collider);
+    }
+    store.Remove(scene.Get(17));
+    store.Remove(scene.Get(scene.GetCount() - 1));
+    store.Update();
+    ASSERT_EQ(store.GetCount(), scene.GetCount() - 2);
+
+    for (int q = 0; q < 200; ++q) {
+        float x = -450.0f + random.NextFloat() * 900.0f;
+        float y = -50.0f + random.NextFloat() * 700.0f;
+        float size = 10.0f + random.NextFloat() * 150.0f;
+        ColliderStore::Query query = { x, y, x + size, y + size, 1 + static_cast<int>(random.NextInt(63)),
+                                       static_cast<int>(layers[random.NextInt(4)]), 1 + static_cast<int>(random.NextInt(15)) };
+
+        std::vector<Collider*> expected;
+        for (size_t i = 0; i < scene.GetCount(); ++i) {
+            Collider* collider = scene.Get(i);
+            if (i == 17 || i == scene.GetCount() - 1 || !collider->IsActive()) continue;
+            AABB area(DirectX::XMFLOAT2(query.minX, query.minY), DirectX::XMFLOAT2(query.maxX, query.maxY));
+            if (Overlaps(collider->GetAABB(), area) &&
+                (ColliderStore::TypeBit(collider->GetType()) & query.typeMask) != 0 &&
+                (static_cast<int>(collider->GetLayer()) & query.layerMask) != 0 &&
+                (collider->GetLayerMask() & query.layer) != 0) {
+                expected.push_back(collider);
+            }
+        }
+
+        std::vector<Collider*> found;
+        store.ForEachOverlap(query, [&](size_t index) { found.push_back(store.GetCollider(index)); });
+        std::sort(expected.begin(), expected.end());
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(found, expected) << "query " << q;
+    }
+
+    store.Clear();
+    EXPECT_EQ(store.GetCount(), 0u);
+}
+
+// 8 players x 3 hitboxes x 5 hurtboxes: the virtual per-pair checks
+// against one store refresh plus a kernel pass per hitbox
+TEST(ColliderStoreTest, HitboxBenchmark) {
+    const int frames = 2000;
+
+    PlayerScene virtualScene(21);
+    size_t virtualHits = 0;
+    std::chrono::steady_clock::duration virtualTime{};
+    for (int frame = 0; frame < frames; ++frame) {
+        virtualScene.Step();
+        auto start = std::chrono::steady_clock::now();
+        virtualHits += virtualScene.CountHitsVirtual();
+        virtualTime += std::chrono::steady_clock::now() - start;
+    }
+
+    PlayerScene batchedScene(21);
+    ColliderStore store;
+    batchedScene.ForEachCollider([&](Collider* collider) { store.Add(collider); });
+    size_t batchedHits = 0;
+    size_t allocations = g_allocationCount;
+    std::chrono::steady_clock::duration batchedTime{};
+    for (int frame = 0; frame < frames; ++frame) {
+        batchedScene.Step();
+        auto start = std::chrono::steady_clock::now();
+        store.Update();
+        batchedHits += CountHitsBatched(store);
+        batchedTime += std::chrono::steady_clock::now() - start;
+    }
+    allocations = g_allocationCount - allocations;
+
+    double virtualUs = std::chrono::duration<double, std::micro>(virtualTime).count() / frames;
+    double batchedUs = std::chrono::duration<double, std::micro>(batchedTime).count() / frames;
+    std::cout << "8 players: virtual " << virtualUs << " us/frame, " << ColliderStore::GetKernelName()
+              << " store " << batchedUs << " us/frame (" << virtualUs / batchedUs << "x), "
+              << static_cast<double>(batchedHits) / frames << " hits/frame\n";
+
+    EXPECT_GT(virtualHits, 0u);
+    EXPECT_EQ(batchedHits, virtualHits);
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_LT(batchedUs, virtualUs);
+}
+
+TEST(CollisionFilterTest, TypesAndLayers) {
+    using CollisionFilter::InteractionMask;
+    using CollisionFilter::TypeBit;
+
+    EXPECT_TRUE(InteractionMask(CollisionType::Hitbox) & TypeBit(CollisionType::Hurtbox));
+    EXPECT_TRUE(InteractionMask(CollisionType::Pushbox) & TypeBit(CollisionType::Pushbox));
+    EXPECT_FALSE(InteractionMask(CollisionType::Hurtbox) & TypeBit(CollisionType::Hurtbox));
+    EXPECT_FALSE(InteractionMask(CollisionType::Environmental) & TypeBit(CollisionType::Environmental));
+
+    BoxCollider hitbox, hurtbox, other;
+    hitbox.SetType(CollisionType::Hitbox);
+    hurtbox.SetType(CollisionType::Hurtbox);
+    other.SetType(CollisionType::Hurtbox);
+    for (Collider* collider : { static_cast<Collider*>(&hitbox), static_cast<Collider*>(&hurtbox),
+                                static_cast<Collider*>(&other) }) {
+        collider->SetLayer(CollisionLayer::Player);
+    }
+    EXPECT_TRUE(Accepts(&hitbox, &hurtbox));
+    EXPECT_TRUE(Accepts(&hurtbox, &hitbox));
+    EXPECT_FALSE(Accepts(&hurtbox, &other));
+
+    // Either side's mask can refuse the other's layer
+    hurtbox.SetLayerMask(static_cast<int>(CollisionLayer::Projectile));
+    EXPECT_FALSE(Accepts(&hitbox, &hurtbox));
+    hurtbox.SetLayerMask(static_cast<int>(CollisionLayer::All));
+    hitbox.SetLayer(CollisionLayer::Enemy);
+    hitbox.SetLayerMask(static_cast<int>(CollisionLayer::Player));
+    EXPECT_TRUE(Accepts(&hitbox, &hurtbox));
+    hurtbox.SetLayerMask(static_cast<int>(CollisionLayer::Player));
+    EXPECT_FALSE(Accepts(&hitbox, &hurtbox));
+}
+
+// An 8-player match: the broad phase overlaps against what reaches the
+// narrow phase once the filter drops the pairs nobody reacts to
+TEST(CollisionFilterTest, DeathMatchPairCounts) {
+    const int frames = 300;
+
+    PlayerScene scene(21);
+    std::vector<Collider*> colliders;
+    scene.ForEachCollider([&](Collider* collider) { colliders.push_back(collider); });
+    SweepAndPrune sweep;
+    for (Collider* collider : colliders) {
+        sweep.Insert(collider);
+    }
+
+    uint64_t overlapping = 0;
+    uint64_t accepted = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        scene.Step();
+        for (size_t i = 0; i < colliders.size(); ++i) {
+            for (size_t j = i + 1; j < colliders.size(); ++j) {
+                overlapping += Overlaps(colliders[i]->GetAABB(), colliders[j]->GetAABB()) ? 1 : 0;
+            }
+        }
+        sweep.Update();
+        sweep.ForEachPair([&](Collider* a, Collider* b) {
+            EXPECT_TRUE(Accepts(a, b));
+            ++accepted;
+        });
+    }
+
+    std::cout << "8 players: " << overlapping / frames << " overlapping pairs/frame, "
+              << accepted / frames << " tested after filtering\n";
+    EXPECT_GT(accepted, 0u);
+    EXPECT_LT(accepted * 2, overlapping);
+}
+
+// Compiled frames must leave the boxes exactly where the frame data and
+// facing put them
+TEST(HitboxManagerTest, CompiledFramesMatchFrameData) {
+    std::vector<HitboxManager::FrameData> frames = MakeAttackFrames(50.0f);
+    HitboxManager manager;
+    manager.Initialize("Hyuk Woon Sung");
+    int id = manager.LoadAnimationData("jab", frames);
+    EXPECT_EQ(manager.GetAnimationId("jab"), id);
+    EXPECT_EQ(manager.GetAnimationId("missing"), -1);
+
+    // 30 frames per facing, but only the changes are stored
+    EXPECT_LT(manager.GetCompiledFrameCount(), 30u);
+
+    for (int facing : { 1, -1 }) {
+        for (int frame = 0; frame < static_cast<int>(frames.size()); ++frame) {
+            manager.UpdateBoxes(id, frame, facing);
+            const HitboxManager::FrameData& data = frames[frame];
+
+            std::vector<BoxCollider*> hurtboxes = manager.GetHurtboxes();
+            size_t expected = 0;
+            for (const auto& hurtbox : data.hurtboxes) {
+                if (!hurtbox.active || hurtbox.invulnerable) continue;
+                ASSERT_LT(expected, hurtboxes.size());
+                EXPECT_EQ(hurtboxes[expected]->GetCenter().x, hurtbox.x * facing);
+                EXPECT_EQ(hurtboxes[expected]->GetCenter().y, hurtbox.y);
+                EXPECT_EQ(hurtboxes[expected]->GetWidth(), hurtbox.width);
+                ++expected;
+            }
+            EXPECT_EQ(hurtboxes.size(), expected) << "frame " << frame;
+
+            std::vector<BoxCollider*> hitboxes = manager.GetActiveHitboxes();
+            ASSERT_EQ(hitboxes.size(), data.hitboxes[0].active ? 1u : 0u);
+            if (!hitboxes.empty()) {
+                EXPECT_EQ(hitboxes[0]->GetCenter().x, data.hitboxes[0].x * facing);
+                EXPECT_EQ(hitboxes[0]->GetKnockback().x, data.hitboxes[0].knockback.x * facing);
+                EXPECT_EQ(hitboxes[0]->GetDamage(), data.hitboxes[0].damage);
+            }
+
+            EXPECT_EQ(manager.GetThrowbox()->IsActive(), data.throwboxActive);
+            EXPECT_EQ(manager.GetPushbox()->GetCenter().x, data.pushboxOffset.x * facing);
+        }
+    }
+}
+
+TEST(HitboxManagerTest, OverridesAndReloads) {
+    HitboxManager manager;
+    manager.Initialize("Hyuk Woon Sung");
+    int id = manager.LoadAnimationData("jab", MakeAttackFrames(50.0f));
+    manager.UpdateBoxes(id, 0, 1);
+    EXPECT_EQ(manager.GetHurtboxes().size(), 3u);
+
+    // Held frame: the boxes are not rewritten, but overrides still clear
+    manager.SetInvulnerable(true);
+    manager.UpdateBoxes(id, 1, 1);
+    EXPECT_TRUE(manager.GetHurtboxes().empty());
+    manager.SetInvulnerable(false);
+    manager.UpdateBoxes(id, 2, 1);
+    EXPECT_EQ(manager.GetHurtboxes().size(), 3u);
+
+    manager.EnableThrowbox(true);
+    manager.UpdateBoxes(id, 3, 1);
+    EXPECT_FALSE(manager.GetThrowbox()->IsActive());
+
+    // Out of range frames and unknown ids leave the boxes alone
+    manager.UpdateBoxes(id, 12, 1);
+    manager.UpdateBoxes(id, 99, 1);
+    manager.UpdateBoxes(7, 0, 1);
+    ASSERT_EQ(manager.GetActiveHitboxes().size(), 1u);
+    EXPECT_EQ(manager.GetActiveHitboxes()[0]->GetCenter().x, 60.0f);
+
+    // Reloading keeps the id and the name overload finds it
+    EXPECT_EQ(manager.LoadAnimationData("jab", MakeAttackFrames(80.0f)), id);
+    manager.UpdateBoxes("jab", 12, -1);
+    ASSERT_EQ(manager.GetActiveHitboxes().size(), 1u);
+    EXPECT_EQ(manager.GetActiveHitboxes()[0]->GetCenter().x, -90.0f);
+}
+
+// Per character per tick: the string-keyed lookup and full rewrite
+// against the compiled table, for 8 characters cycling through moves
+TEST(HitboxManagerTest, UpdateBoxesBenchmark) {
+    const int characters = 8;
+    const int ticks = 20000;
+
+    std::vector<NamedHitboxes> named(characters);
+    std::vector<HitboxManager> compiled(characters);
+    int ids[4] = {};
+    for (int c = 0; c < characters; ++c) {
+        compiled[c].Initialize("Hyuk Woon Sung");
+        for (int a = 0; a < 4; ++a) {
+            std::vector<HitboxManager::FrameData> frames = MakeAttackFrames(40.0f + 10.0f * a);
+            named[c].LoadAnimationData(ATTACK_NAMES[a], frames);
+            ids[a] = compiled[c].LoadAnimationData(ATTACK_NAMES[a], frames);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        for (int c = 0; c < characters; ++c) {
+            int move = (tick / 30 + c) % 4;
+            named[c].UpdateBoxes(ATTACK_NAMES[move], tick % 30, c % 2 ? -1 : 1);
+        }
+    }
+    double namedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                     (static_cast<double>(ticks) * characters);
+
+    size_t allocations = g_allocationCount;
+    start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        for (int c = 0; c < characters; ++c) {
+            int move = (tick / 30 + c) % 4;
+            compiled[c].UpdateBoxes(ids[move], tick % 30, c % 2 ? -1 : 1);
+        }
+    }
+    double compiledNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                        (static_cast<double>(ticks) * characters);
+    allocations = g_allocationCount - allocations;
+
+    std::cout << "UpdateBoxes per character: by name " << namedNs << " ns, compiled "
+              << compiledNs << " ns (" << namedNs / compiledNs << "x)\n";
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_LT(compiledNs, namedNs);
+}
+
+} // namespace Tests
+} // namespace ArenaFighter
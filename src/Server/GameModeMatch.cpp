@@ -0,0 +1,51 @@
+#include "GameModeMatch.h"
+
+namespace ArenaFighter {
+
+GameModeMatch::GameModeMatch(GameModeID mode, int port)
+    : m_mode(mode)
+    , m_port(port) {
+}
+
+bool GameModeMatch::Start() {
+    if (!m_network.Initialize() || !m_network.StartHost(m_port)) {
+        return false;
+    }
+
+    if (!m_modes.changeGameMode(m_mode)) {
+        m_network.Shutdown();
+        return false;
+    }
+
+    m_modes.getCurrentMode()->startMatch();
+    return true;
+}
+
+void GameModeMatch::Tick(float deltaTime) {
+    // Inputs received this tick are simulated this tick
+    m_network.Update(deltaTime);
+    m_modes.update(deltaTime);
+}
+
+void GameModeMatch::Stop() {
+    m_modes.cleanup();
+    m_network.Shutdown();
+}
+
+bool GameModeMatch::IsFinished() const {
+    const GameMode* mode = m_modes.getCurrentMode();
+    return !mode || mode->getState() == MatchState::MatchEnd;
+}
+
+const char* GameModeMatch::GetKind() const {
+    switch (m_mode) {
+        case GameModeID::SinglePlayer: return "singleplayer";
+        case GameModeID::Versus:       return "versus";
+        case GameModeID::Online:       return "online";
+        case GameModeID::Training:     return "training";
+        case GameModeID::Survival:     return "survival";
+    }
+    return "match";
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ServerMatch.h"
+#include "../GameModes/GameModeManager.h"
+#include "../Network/NetworkManager.h"
+
+namespace ArenaFighter {
+
+// A real match: a game mode simulated authoritatively, with its clients
+// connected to a NetworkManager hosting on its own port. Each match owns
+// its GameModeManager and, through ServerMatch, its simulation random, so
+// matches share no simulation state.
+class GameModeMatch : public ServerMatch {
+public:
+    GameModeMatch(GameModeID mode, int port);
+
+    bool Start() override;
+    void Tick(float deltaTime) override;
+    void Stop() override;
+    bool IsFinished() const override;
+    const char* GetKind() const override;
+
+    int GetPort() const { return m_network.GetLocalPort(); }
+    GameModeManager& GetModes() { return m_modes; }
+    NetworkManager& GetNetwork() { return m_network; }
+
+private:
+    GameModeID m_mode;
+    int m_port;
+
+    GameModeManager m_modes;
+    NetworkManager m_network;
+};
+
+} // namespace ArenaFighter
@@ -0,0 +1,40 @@
+#pragma once
+
+// Stand-in for DirectXMath when external/DirectXMath is not checked out.
+// The simulation core only uses the plain float storage types, so those
+// are all this provides; they match the real ones in layout and in being
+// trivial (the default constructor leaves them uninitialized).
+
+namespace DirectX {
+
+struct XMFLOAT2 {
+    float x;
+    float y;
+
+    XMFLOAT2() = default;
+    constexpr XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+    explicit XMFLOAT2(const float* pArray) : x(pArray[0]), y(pArray[1]) {}
+};
+
+struct XMFLOAT3 {
+    float x;
+    float y;
+    float z;
+
+    XMFLOAT3() = default;
+    constexpr XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+    explicit XMFLOAT3(const float* pArray) : x(pArray[0]), y(pArray[1]), z(pArray[2]) {}
+};
+
+struct XMFLOAT4 {
+    float x;
+    float y;
+    float z;
+    float w;
+
+    XMFLOAT4() = default;
+    constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+    explicit XMFLOAT4(const float* pArray) : x(pArray[0]), y(pArray[1]), z(pArray[2]), w(pArray[3]) {}
+};
+
+} // namespace DirectX
@@ -0,0 +1,342 @@
+#include "MatchServer.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ArenaFighter {
+
+namespace {
+
+void StopMatch(ServerMatch& match) {
+    ScopedSimulationRandom random(match.GetRandom());
+    match.Stop();
+}
+
+void PinCurrentThread(int core) {
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#else
+    (void)core;
+#endif
+}
+
+} // namespace
+
+MatchServer::MatchServer(const ServerConfig& config)
+    : m_config(config)
+    , m_tickDelta(1.0f / static_cast<float>(std::max(config.tickRate, 1)))
+    , m_tickPeriod(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / std::max(config.tickRate, 1))))
+    , m_generation(0)
+    , m_busyWorkers(0)
+    , m_shutdown(false)
+    , m_nextMatchId(1)
+    , m_running(false)
+    , m_tickCount(0)
+    , m_finishedMatches(0)
+    , m_skippedTicks(0)
+    , m_migrations(0)
+    , m_statsInterval(0) {
+    int cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    int workerCount = config.workerCount > 0 ? config.workerCount : cores;
+
+    for (int i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        Worker& worker = *m_workers[i];
+        worker.thread = std::thread([this, &worker, i] { WorkerLoop(worker, i); });
+    }
+}
+
+MatchServer::~MatchServer() {
+    {
+        std::lock_guard<std::mutex> lock(m_tickMutex);
+        m_shutdown = true;
+    }
+    m_tickStart.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+        for (auto& slot : worker->slots) {
+            StopMatch(*slot->match);
+        }
+    }
+    for (auto& slot : m_pending) {
+        StopMatch(*slot->match);
+    }
+}
+
+uint32_t MatchServer::AddMatch(std::unique_ptr<ServerMatch> match) {
+    if (!match) {
+        return 0;
+    }
+    {
+        ScopedSimulationRandom random(match->GetRandom());
+        if (!match->Start()) {
+            return 0;
+        }
+    }
+
+    auto slot = std::make_unique<Slot>();
+    slot->match = std::move(match);
+    slot->id = m_nextMatchId.fetch_add(1, std::memory_order_relaxed);
+    uint32_t id = slot->id;
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.push_back(std::move(slot));
+    return id;
+}
+
+size_t MatchServer::GetMatchCount() const {
+    size_t count = 0;
+    for (const auto& worker : m_workers) {
+        count += worker->slots.size();
+    }
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    return count + m_pending.size();
+}
+
+void MatchServer::SetStatsCallback(uint64_t intervalTicks, StatsCallback callback) {
+    m_statsInterval = intervalTicks;
+    m_onStats = std::move(callback);
+}
+
+void MatchServer::Run() {
+    RunUntil(UINT64_MAX);
+}
+
+void MatchServer::RunTicks(uint64_t tickCount) {
+    RunUntil(m_tickCount + tickCount);
+}
+
+void MatchServer::RunUntil(uint64_t lastTick) {
+    m_running.store(true, std::memory_order_relaxed);
+    m_nextTickTime = Clock::now();
+
+    while (m_tickCount < lastTick && m_running.load(std::memory_order_relaxed)) {
+        if (m_config.tickMode == TickMode::Fixed) {
+            WaitForNextTick();
+        }
+        Tick();
+    }
+
+    m_running.store(false, std::memory_order_relaxed);
+}
+
+void MatchServer::WaitForNextTick() {
+    Clock::time_point now = Clock::now();
+    if (now < m_nextTickTime) {
+        std::this_thread::sleep_until(m_nextTickTime);
+    } else if (now - m_nextTickTime > m_tickPeriod * m_config.maxCatchUpTicks) {
+        // Too far behind (a stall, or a debugger break): running the
+        // backlog back to back would only push matches further behind
+        // their clients, so skip it
+        Clock::duration behind = now - m_nextTickTime;
+        uint64_t skipped = static_cast<uint64_t>(behind / m_tickPeriod);
+        m_skippedTicks += skipped;
+        m_nextTickTime += m_tickPeriod * skipped;
+    }
+
+    // Deadlines stay on the original grid, so oversleeping one tick
+    // shortens the wait for the next instead of drifting
+    m_nextTickTime += m_tickPeriod;
+}
+
+void MatchServer::Tick() {
+    AdoptPendingMatches();
+
+    Clock::time_point start = Clock::now();
+    {
+        std::unique_lock<std::mutex> lock(m_tickMutex);
+        m_generation++;
+        m_busyWorkers = static_cast<int>(m_workers.size());
+        m_tickStart.notify_all();
+        m_tickDone.wait(lock, [this] { return m_busyWorkers == 0; });
+    }
+    m_serverTicks.Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+
+    RemoveFinishedMatches();
+    m_tickCount++;
+
+    if (m_config.rebalanceInterval > 0 && m_tickCount % m_config.rebalanceInterval == 0) {
+        Rebalance();
+    }
+    if (m_onStats && m_statsInterval > 0 && m_tickCount % m_statsInterval == 0) {
+        m_onStats(*this);
+    }
+}
+
+void MatchServer::WorkerLoop(Worker& worker, int index) {
+    // With more workers than cores, let the OS spread them instead
+    int cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    if (m_config.pinWorkers && static_cast<int>(m_workers.size()) <= cores) {
+        PinCurrentThread(index);
+    }
+
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_tickMutex);
+            m_tickStart.wait(lock, [this, seen] { return m_shutdown || m_generation != seen; });
+            if (m_shutdown) {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        TickSlots(worker);
+
+        std::lock_guard<std::mutex> lock(m_tickMutex);
+        if (--m_busyWorkers == 0) {
+            m_tickDone.notify_one();
+        }
+    }
+}
+
+void MatchServer::TickSlots(Worker& worker) {
+    Clock::time_point last = Clock::now();
+    for (auto& slot : worker.slots) {
+        {
+            ScopedSimulationRandom random(slot->match->GetRandom());
+            slot->match->Tick(m_tickDelta);
+        }
+
+        Clock::time_point now = Clock::now();
+        uint64_t cost = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+        last = now;
+
+        slot->histogram.Record(cost);
+        slot->windowNs += cost;
+        slot->windowTicks++;
+    }
+}
+
+void MatchServer::AdoptPendingMatches() {
+    std::vector<std::unique_ptr<Slot>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pending);
+    }
+
+    for (auto& slot : pending) {
+        // Least loaded worker; fewest matches when nothing has been measured
+        Worker* target = nullptr;
+        float targetLoad = 0.0f;
+        for (auto& worker : m_workers) {
+            float load = GetWorkerLoad(*worker);
+            if (!target || load < targetLoad ||
+                (load == targetLoad && worker->slots.size() < target->slots.size())) {
+                target = worker.get();
+                targetLoad = load;
+            }
+        }
+        target->slots.push_back(std::move(slot));
+    }
+}
+
+void MatchServer::RemoveFinishedMatches() {
+    for (auto& worker : m_workers) {
+        auto& slots = worker->slots;
+        auto finished = std::stable_partition(slots.begin(), slots.end(),
+            [](const std::unique_ptr<Slot>& slot) { return !slot->match->IsFinished(); });
+        for (auto it = finished; it != slots.end(); ++it) {
+            StopMatch(*(*it)->match);
+            m_finishedMatches++;
+        }
+        slots.erase(finished, slots.end());
+    }
+}
+
+float MatchServer::GetWorkerLoad(const Worker& worker) const {
+    float load = 0.0f;
+    for (const auto& slot : worker.slots) {
+        load += slot->averageNs;
+    }
+    return load;
+}
+
+void MatchServer::Rebalance() {
+    for (auto& worker : m_workers) {
+        for (auto& slot : worker->slots) {
+            if (slot->windowTicks > 0) {
+                slot->averageNs = static_cast<float>(slot->windowNs) / static_cast<float>(slot->windowTicks);
+            }
+            slot->windowNs = 0;
+            slot->windowTicks = 0;
+        }
+    }
+
+    if (m_workers.size() < 2) {
+        return;
+    }
+
+    std::vector<float> loads;
+    loads.reserve(m_workers.size());
+    for (const auto& worker : m_workers) {
+        loads.push_back(GetWorkerLoad(*worker));
+    }
+
+    float minGap = static_cast<float>(std::chrono::duration_cast<std::chrono::nanoseconds>(m_tickPeriod).count())
+                 * m_config.rebalanceMinGap;
+
+    // A few moves per check at most; each one closes the widest gap
+    for (size_t move = 0; move < m_workers.size(); ++move) {
+        auto [lightest, heaviest] = std::minmax_element(loads.begin(), loads.end());
+        float gap = *heaviest - *lightest;
+        if (gap <= *heaviest * m_config.rebalanceThreshold || gap < minGap) {
+            return;
+        }
+
+        // The match closest to half the gap evens the pair out best. One
+        // costing the whole gap or more would only swap the imbalance.
+        Worker& from = *m_workers[heaviest - loads.begin()];
+        Worker& to = *m_workers[lightest - loads.begin()];
+        auto best = from.slots.end();
+        for (auto it = from.slots.begin(); it != from.slots.end(); ++it) {
+            float cost = (*it)->averageNs;
+            if (cost < gap && (best == from.slots.end() ||
+                std::abs(cost - gap / 2.0f) < std::abs((*best)->averageNs - gap / 2.0f))) {
+                best = it;
+            }
+        }
+        if (best == from.slots.end()) {
+            return;
+        }
+
+        float cost = (*best)->averageNs;
+        to.slots.push_back(std::move(*best));
+        from.slots.erase(best);
+        *heaviest -= cost;
+        *lightest += cost;
+        m_migrations++;
+    }
+}
+
+std::vector<MatchStats> MatchServer::GetMatchStats() const {
+    std::vector<MatchStats> stats;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        for (const auto& slot : m_workers[i]->slots) {
+            stats.push_back({ slot->id, slot->match->GetKind(), static_cast<int>(i),
+                              slot->averageNs, slot->histogram });
+        }
+    }
+    return stats;
+}
+
+} // namespace ArenaFighter
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ServerMatch.h"
+#include "TickHistogram.h"
+#include "../Network/NetworkConfig.h"
+
+namespace ArenaFighter {
+
+enum class TickMode {
+    Fixed,      // Every match ticks at exactly tickRate, paced by the wall clock
+    Uncapped    // Back to back, as fast as the CPU allows (tests, replays)
+};
+
+struct ServerConfig {
+    TickMode tickMode = TickMode::Fixed;
+    int tickRate = NetworkConfig::TICK_RATE;
+
+    // A fixed-rate server that falls further behind than this stops
+    // catching up and drops the missed wall time instead
+    int maxCatchUpTicks = 5;
+
+    // Worker threads ticking matches; 0 uses one per hardware thread
+    int workerCount = 0;
+    // Pin worker i to core i, so a match's state stays in one core's cache
+    bool pinWorkers = true;
+
+    // Ticks between load checks; each check compares the mean cost of
+    // every match over the interval. Moving a match costs it a cold cache,
+    // so shards are only rebalanced when the busiest worker carries more
+    // than rebalanceThreshold above the least busy one, and the difference
+    // is at least rebalanceMinGap of the tick period (smaller gaps do not
+    // threaten the tick budget and are mostly measurement noise).
+    int rebalanceInterval = NetworkConfig::TICK_RATE;
+    float rebalanceThreshold = 0.25f;
+    float rebalanceMinGap = 0.05f;
+};
+
+// Tick cost of one match since it was added
+struct MatchStats {
+    uint32_t matchId;
+    const char* kind;
+    int worker;
+    float averageNs;              // Mean over the last rebalance interval
+    TickHistogram histogram;
+};
+
+// Hosts many matches on a pool of worker threads. Each match belongs to
+// one worker (its shard) and stays there unless the shards become
+// unbalanced. All workers tick on a shared timeline: a server tick
+// starts every worker at once and completes when the last one is done,
+// and every match advances by one frame of 1/tickRate seconds per server
+// tick. In fixed mode server ticks are scheduled against absolute
+// deadlines, so sleep jitter does not accumulate and each match sees
+// exactly tickRate ticks per second.
+//
+// Adding, removing and rebalancing matches happen between server ticks,
+// while the workers are idle, so a match never runs on two threads.
+class MatchServer {
+public:
+    explicit MatchServer(const ServerConfig& config = ServerConfig());
+    ~MatchServer();
+
+    MatchServer(const MatchServer&) = delete;
+    MatchServer& operator=(const MatchServer&) = delete;
+
+    // Starts the match on the calling thread and schedules it from the
+    // next tick; safe to call while the server runs. Returns the match id,
+    // or 0 (dropping the match) if it fails to start.
+    uint32_t AddMatch(std::unique_ptr<ServerMatch> match);
+    size_t GetMatchCount() const;
+
+    // Runs until Stop() is called from any thread
+    void Run();
+    // Runs exactly tickCount ticks, then returns
+    void RunTicks(uint64_t tickCount);
+    void Stop() { m_running.store(false, std::memory_order_relaxed); }
+
+    // Advances every match by one frame, without pacing
+    void Tick();
+
+    uint64_t GetTickCount() const { return m_tickCount; }
+    uint64_t GetFinishedMatches() const { return m_finishedMatches; }
+    uint64_t GetSkippedTicks() const { return m_skippedTicks; }   // Fixed mode only
+    uint64_t GetMigrations() const { return m_migrations; }
+    int GetWorkerCount() const { return static_cast<int>(m_workers.size()); }
+    float GetTickDelta() const { return m_tickDelta; }
+
+    // Not while the server is running, except from the stats callback
+    std::vector<MatchStats> GetMatchStats() const;
+    const TickHistogram& GetServerTickHistogram() const { return m_serverTicks; }
+
+    // Called between ticks every intervalTicks ticks
+    using StatsCallback = std::function<void(const MatchServer&)>;
+    void SetStatsCallback(uint64_t intervalTicks, StatsCallback callback);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        std::unique_ptr<ServerMatch> match;
+        uint32_t id;
+        float averageNs = 0.0f;
+        uint64_t windowNs = 0;        // Cost since the last load check
+        uint32_t windowTicks = 0;
+        TickHistogram histogram;
+    };
+
+    struct alignas(64) Worker {
+        std::thread thread;
+        std::vector<std::unique_ptr<Slot>> slots;
+    };
+
+    void WorkerLoop(Worker& worker, int index);
+    void TickSlots(Worker& worker);
+
+    void RunUntil(uint64_t lastTick);
+    void WaitForNextTick();
+
+    void AdoptPendingMatches();
+    void RemoveFinishedMatches();
+    void Rebalance();
+    float GetWorkerLoad(const Worker& worker) const;
+
+    ServerConfig m_config;
+    float m_tickDelta;
+    Clock::duration m_tickPeriod;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // Tick handshake: Tick() bumps the generation, each worker ticks its
+    // shard once per generation and the last one to finish wakes Tick()
+    std::mutex m_tickMutex;
+    std::condition_variable m_tickStart;
+    std::condition_variable m_tickDone;
+    uint64_t m_generation;
+    int m_busyWorkers;
+    bool m_shutdown;
+
+    // Started but not yet assigned to a worker
+    mutable std::mutex m_pendingMutex;
+    std::vector<std::unique_ptr<Slot>> m_pending;
+    std::atomic<uint32_t> m_nextMatchId;
+
+    std::atomic<bool> m_running;
+
+    Clock::time_point m_nextTickTime;
+    uint64_t m_tickCount;
+    uint64_t m_finishedMatches;
+    uint64_t m_skippedTicks;
+    uint64_t m_migrations;
+
+    TickHistogram m_serverTicks;
+    uint64_t m_statsInterval;
+    StatsCallback m_onStats;
+};
+
+} // namespace ArenaFighter
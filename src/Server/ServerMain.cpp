@@ -0,0 +1,145 @@
+#include "GameModeMatch.h"
+#include "MatchServer.h"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace ArenaFighter;
+
+namespace {
+
+constexpr int DEFAULT_BASE_PORT = 7777;
+
+MatchServer* g_server = nullptr;
+
+void OnSignal(int) {
+    if (g_server) {
+        g_server->Stop();
+    }
+}
+
+// DeathMatch and BeastMode have no GameModeID or factory entry yet, so
+// they cannot be hosted here
+bool ParseMode(const std::string& name, GameModeID& mode) {
+    if (name == "online") {
+        mode = GameModeID::Online;
+    } else if (name == "versus") {
+        mode = GameModeID::Versus;
+    } else if (name == "training") {
+        mode = GameModeID::Training;
+    } else if (name == "survival") {
+        mode = GameModeID::Survival;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Tick cost per kind of match and for whole server ticks, for sizing hosts
+void PrintStats(const MatchServer& server) {
+    std::map<std::string, TickHistogram> byKind;
+    for (const MatchStats& stats : server.GetMatchStats()) {
+        byKind[stats.kind].Merge(stats.histogram);
+    }
+
+    auto print = [](const std::string& name, const TickHistogram& histogram) {
+        std::cout << "  " << name << ": p50 " << histogram.GetPercentile(0.5) / 1000
+                  << " us, p99 " << histogram.GetPercentile(0.99) / 1000
+                  << " us, max " << histogram.GetMax() / 1000 << " us" << std::endl;
+    };
+
+    std::cout << "Tick " << server.GetTickCount() << ": " << server.GetMatchCount() << " matches on "
+              << server.GetWorkerCount() << " workers, " << server.GetMigrations() << " migrations" << std::endl;
+    print("server tick", server.GetServerTickHistogram());
+    for (const auto& [kind, histogram] : byKind) {
+        print(kind, histogram);
+    }
+}
+
+void PrintUsage() {
+    std::cout << "Usage: dfr_server [options]\n"
+              << "  --matches N      Concurrent matches (default 1)\n"
+              << "  --port P         Port of the first match; match i listens on P + i (default "
+              << DEFAULT_BASE_PORT << ")\n"
+              << "  --mode NAME      online, versus, training or survival (default online)\n"
+              << "  --uncapped       Tick as fast as possible instead of at "
+              << NetworkConfig::TICK_RATE << " Hz\n"
+              << "  --ticks N        Exit after N ticks\n"
+              << "  --workers N      Worker threads (default: one per core)\n"
+              << "  --stats S        Print tick costs every S seconds\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int matchCount = 1;
+    int basePort = DEFAULT_BASE_PORT;
+    GameModeID mode = GameModeID::Online;
+    uint64_t tickLimit = 0;
+    int statsSeconds = 0;
+    ServerConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--matches" && hasValue) {
+            matchCount = std::atoi(argv[++i]);
+        } else if (arg == "--port" && hasValue) {
+            basePort = std::atoi(argv[++i]);
+        } else if (arg == "--mode" && hasValue) {
+            if (!ParseMode(argv[++i], mode)) {
+                std::cerr << "Unknown mode: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--uncapped") {
+            config.tickMode = TickMode::Uncapped;
+        } else if (arg == "--ticks" && hasValue) {
+            tickLimit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--workers" && hasValue) {
+            config.workerCount = std::atoi(argv[++i]);
+        } else if (arg == "--stats" && hasValue) {
+            statsSeconds = std::atoi(argv[++i]);
+        } else {
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    MatchServer server(config);
+    for (int i = 0; i < matchCount; ++i) {
+        if (!server.AddMatch(std::make_unique<GameModeMatch>(mode, basePort + i))) {
+            std::cerr << "Failed to start match on port " << basePort + i << std::endl;
+        }
+    }
+
+    if (server.GetMatchCount() == 0) {
+        return 1;
+    }
+    std::cout << "Running " << server.GetMatchCount() << " matches on "
+              << server.GetWorkerCount() << " workers" << std::endl;
+
+    if (statsSeconds > 0) {
+        server.SetStatsCallback(static_cast<uint64_t>(statsSeconds) * config.tickRate, PrintStats);
+    }
+
+    g_server = &server;
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    if (tickLimit > 0) {
+        server.RunTicks(tickLimit);
+    } else {
+        server.Run();
+    }
+
+    g_server = nullptr;
+    std::cout << "Stopped after " << server.GetTickCount() << " ticks, "
+              << server.GetFinishedMatches() << " matches finished, "
+              << server.GetSkippedTicks() << " ticks skipped" << std::endl;
+    PrintStats(server);
+    return 0;
+}
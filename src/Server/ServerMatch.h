@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include "../Core/DeterministicRandom.h"
+
+namespace ArenaFighter {
+
+// One match as the dedicated server runs it. Ticks always advance the
+// simulation by a whole fixed frame, whatever the wall clock did. Start()
+// and Stop() run on the thread that adds and removes matches; Tick() runs
+// on whichever worker the match is assigned to, one tick at a time.
+class ServerMatch {
+public:
+    virtual ~ServerMatch() = default;
+
+    // Sets up the match; a match that fails to start is dropped
+    virtual bool Start() = 0;
+    virtual void Tick(float deltaTime) = 0;
+    virtual void Stop() = 0;
+
+    // Checked after every tick; finished matches are stopped and removed
+    virtual bool IsFinished() const = 0;
+
+    // Groups tick costs by kind of match (e.g. "versus") in server stats
+    virtual const char* GetKind() const { return "match"; }
+
+    // This match's gameplay randomness. MatchServer installs it as the
+    // simulation random around Start(), Tick() and Stop(), so matches that
+    // share a worker never roll from or reseed each other's generator.
+    DeterministicRandom& GetRandom() { return m_random; }
+
+private:
+    // Until the match's NetworkManager reseeds it at match start
+    DeterministicRandom m_random{ GetSimulationRandom().NextU32() };
+};
+
+} // namespace ArenaFighter
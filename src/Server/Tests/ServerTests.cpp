@@ -0,0 +1,525 @@
+#include <gtest/gtest.h>
+#include "../GameModeMatch.h"
+#include "../MatchServer.h"
+#include "../../Characters/CharacterFactory.h"
+#include "../../Core/DeterministicRandom.h"
+#include "../../GameModes/OnlineMode.h"
+#include "../../Network/InputBuffer.h"
+#include "../../Network/NetworkManager.h"
+#include "../../Network/Replay.h"
+#include "../../Network/RollbackEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ArenaFighter {
+namespace Tests {
+
+// Counts its ticks and finishes after a set number of them
+class CountingMatch : public ServerMatch {
+public:
+    explicit CountingMatch(uint64_t finishAfter = UINT64_MAX, bool startOk = true)
+        : finishAfter(finishAfter), startOk(startOk) {}
+
+    bool Start() override { started = true; return startOk; }
+    void Tick(float deltaTime) override {
+        ticks++;
+        lastDelta = deltaTime;
+        if (log) {
+            log->push_back(this);
+        }
+    }
+    void Stop() override { stopped = true; }
+    bool IsFinished() const override { return ticks >= finishAfter; }
+
+    uint64_t finishAfter;
+    bool startOk;
+    bool started = false;
+    bool stopped = false;
+    uint64_t ticks = 0;
+    float lastDelta = 0.0f;
+    std::vector<const ServerMatch*>* log = nullptr;
+};
+
+void SpinFor(std::chrono::microseconds duration) {
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// Remembers every thread it ran on; turns expensive after a while, like a
+// lobby filling up
+class ShardedMatch : public CountingMatch {
+public:
+    explicit ShardedMatch(uint64_t heavyAfter = UINT64_MAX) : heavyAfter(heavyAfter) {}
+
+    void Tick(float deltaTime) override {
+        CountingMatch::Tick(deltaTime);
+        if (threads.empty() || threads.back() != std::this_thread::get_id()) {
+            threads.push_back(std::this_thread::get_id());
+        }
+        SpinFor(std::chrono::microseconds(ticks > heavyAfter ? 1000 : 10));
+    }
+    const char* GetKind() const override { return heavyAfter == UINT64_MAX ? "light" : "heavy"; }
+
+    uint64_t heavyAfter;
+    std::vector<std::thread::id> threads;
+};
+
+TEST(MatchServerTest, UncappedTicksEveryMatchOncePerTick) {
+    ServerConfig config;
+    config.tickMode = TickMode::Uncapped;
+    config.workerCount = 1;
+    MatchServer server(config);
+
+    std::vector<const ServerMatch*> order;
+    std::vector<CountingMatch*> matches;
+    for (int i = 0; i < 4; ++i) {
+        auto match = std::make_unique<CountingMatch>();
+        match->log = &order;
+        matches.push_back(match.get());
+        ASSERT_TRUE(server.AddMatch(std::move(match)));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    server.RunTicks(600);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(server.GetTickCount(), 600u);
+    for (CountingMatch* match : matches) {
+        EXPECT_EQ(match->ticks, 600u);
+        EXPECT_FLOAT_EQ(match->lastDelta, 1.0f / NetworkConfig::TICK_RATE);
+    }
+
+    // One worker runs its matches in the order they were added, every tick
+    ASSERT_EQ(order.size(), 2400u);
+    for (size_t i = 0; i < order.size(); ++i) {
+        EXPECT_EQ(order[i], matches[i % 4]);
+    }
+
+    // Ten seconds of match time, nowhere near ten seconds of wall time
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+}
+
+TEST(MatchServerTest, FixedModeTicksAtTickRate) {
+    MatchServer server;
+    auto match = std::make_unique<CountingMatch>();
+    CountingMatch* counted = match.get();
+    ASSERT_TRUE(server.AddMatch(std::move(match)));
+
+    // The first tick runs immediately, so 31 ticks span 30 periods
+    auto start = std::chrono::steady_clock::now();
+    server.RunTicks(31);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(counted->ticks, 31u);
+    EXPECT_GE(seconds, 30.0 / NetworkConfig::TICK_RATE);
+    EXPECT_LT(seconds, 30.0 / NetworkConfig::TICK_RATE + 0.1);
+    EXPECT_EQ(server.GetSkippedTicks(), 0u);
+}
+
+TEST(MatchServerTest, FinishedMatchesAreStoppedAndRemoved) {
+    ServerConfig config;
+    config.tickMode = TickMode::Uncapped;
+    MatchServer server(config);
+
+    auto shortMatch = std::make_unique<CountingMatch>(10);
+    auto longMatch = std::make_unique<CountingMatch>(20);
+    server.AddMatch(std::move(shortMatch));
+    server.AddMatch(std::move(longMatch));
+
+    server.RunTicks(10);
+    EXPECT_EQ(server.GetMatchCount(), 1u);
+    EXPECT_EQ(server.GetFinishedMatches(), 1u);
+
+    server.RunTicks(10);
+    EXPECT_EQ(server.GetMatchCount(), 0u);
+    EXPECT_EQ(server.GetFinishedMatches(), 2u);
+}
+
+TEST(MatchServerTest, MatchThatFailsToStartIsDropped) {
+    MatchServer server;
+    EXPECT_FALSE(server.AddMatch(std::make_unique<CountingMatch>(UINT64_MAX, false)));
+    EXPECT_FALSE(server.AddMatch(nullptr));
+    EXPECT_EQ(server.GetMatchCount(), 0u);
+}
+
+TEST(MatchServerTest, StopEndsRun) {
+    ServerConfig config;
+    config.tickMode = TickMode::Uncapped;
+    MatchServer server(config);
+
+    class StoppingMatch : public CountingMatch {
+    public:
+        explicit StoppingMatch(MatchServer& server) : m_server(server) {}
+        void Tick(float deltaTime) override {
+            CountingMatch::Tick(deltaTime);
+            if (ticks == 50) {
+                m_server.Stop();
+            }
+        }
+    private:
+        MatchServer& m_server;
+    };
+
+    server.AddMatch(std::make_unique<StoppingMatch>(server));
+    server.Run();
+    EXPECT_EQ(server.GetTickCount(), 50u);
+}
+
+TEST(TickHistogramTest, PercentilesAreWithinOneBucket) {
+    TickHistogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.Record(value * 1000);   // 1 us to 1 ms
+    }
+
+    EXPECT_EQ(histogram.GetCount(), 1000u);
+    EXPECT_EQ(histogram.GetMax(), 1000000u);
+    EXPECT_EQ(histogram.GetMean(), 500500u);
+
+    // Never below the true value, at most one sub-bucket (12.5%) above
+    uint64_t p50 = histogram.GetPercentile(0.5);
+    uint64_t p99 = histogram.GetPercentile(0.99);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 562500u);
+    EXPECT_GE(p99, 990000u);
+    EXPECT_LE(p99, 1000000u);   // Capped at the largest sample
+
+    // Every value lands in a bucket whose bounds contain it
+    for (uint64_t value : { 0ull, 7ull, 8ull, 9ull, 1023ull, 1024ull, 123456789ull }) {
+        int index = TickHistogram::BucketIndex(value);
+        EXPECT_LE(value, TickHistogram::BucketUpperBound(index));
+        if (index > 0) {
+            EXPECT_GT(value, TickHistogram::BucketUpperBound(index - 1));
+        }
+    }
+
+    TickHistogram merged;
+    merged.Merge(histogram);
+    merged.Merge(histogram);
+    EXPECT_EQ(merged.GetCount(), 2000u);
+    EXPECT_EQ(merged.GetPercentile(0.5), p50);
+}
+
+TEST(MatchServerTest, MatchesStayOnTheirWorker) {
+    ServerConfig config;
+    config.tickMode = TickMode::Uncapped;
+    config.workerCount = 4;
+    config.pinWorkers = false;
+    MatchServer server(config);
+
+    std::vector<ShardedMatch*> matches;
+    for (int i = 0; i < 8; ++i) {
+        auto match = std::make_unique<ShardedMatch>();
+        matches.push_back(match.get());
+        EXPECT_NE(server.AddMatch(std::move(match)), 0u);
+    }
+    server.RunTicks(120);
+
+    // Spread evenly, and never moved while costs are even
+    std::vector<int> perWorker(4, 0);
+    for (const MatchStats& stats : server.GetMatchStats()) {
+        perWorker[stats.worker]++;
+        EXPECT_EQ(stats.histogram.GetCount(), 120u);
+        EXPECT_STREQ(stats.kind, "light");
+    }
+    EXPECT_EQ(perWorker, std::vector<int>(4, 2));
+
+    for (ShardedMatch* match : matches) {
+        EXPECT_EQ(match->ticks, 120u);
+        EXPECT_EQ(match->threads.size(), 1u);
+    }
+    EXPECT_EQ(server.GetMigrations(), 0u);
+    EXPECT_EQ(server.GetServerTickHistogram().GetCount(), 120u);
+}
+
+TEST(MatchServerTest, RebalancesWhenMatchesGetExpensive) {
+    ServerConfig config;
+    config.tickMode = TickMode::Uncapped;
+    config.workerCount = 2;
+    config.pinWorkers = false;
+    config.rebalanceInterval = 30;
+    MatchServer server(config);
+
+    // Added round-robin, so both heavy matches start on worker 0
+    server.AddMatch(std::make_unique<ShardedMatch>(10));
+    server.AddMatch(std::make_unique<ShardedMatch>());
+    server.AddMatch(std::make_unique<ShardedMatch>(10));
+    server.AddMatch(std::make_unique<ShardedMatch>());
+
+    size_t statsCalls = 0;
+    server.SetStatsCallback(60, [&statsCalls](const MatchServer& running) {
+        statsCalls++;
+        EXPECT_EQ(running.GetMatchStats().size(), 4u);
+    });
+    server.RunTicks(180);
+
+    std::vector<int> heavyPerWorker(2, 0);
+    for (const MatchStats& stats : server.GetMatchStats()) {
+        if (std::string(stats.kind) == "heavy") {
+            heavyPerWorker[stats.worker]++;
+        }
+    }
+    EXPECT_EQ(heavyPerWorker, std::vector<int>(2, 1));
+    EXPECT_GE(server.GetMigrations(), 1u);
+    EXPECT_EQ(statsCalls, 3u);
+}
+
+// Hosts on loopback and rolls the simulation random every tick, as a game
+// mode does. The match starts on startTick, which reseeds the simulation
+// random from the seed the host hands out.
+class RollingMatch : public ShardedMatch {
+public:
+    RollingMatch(uint64_t heavyAfter, uint64_t startTick) : ShardedMatch(heavyAfter), startTick(startTick) {}
+
+    bool Start() override {
+        CountingMatch::Start();
+        return network.Initialize() && network.StartHost(0);
+    }
+    void Tick(float deltaTime) override {
+        ShardedMatch::Tick(deltaTime);
+        network.Update(deltaTime);
+        if (ticks == startTick) {
+            network.StartMatch();
+        }
+        if (ticks >= startTick) {
+            rolls.push_back(GetSimulationRandom().NextU32());
+        }
+    }
+    void Stop() override {
+        CountingMatch::Stop();
+        network.Shutdown();
+    }
+
+    uint64_t startTick;
+    NetworkManager network;
+    std::vector<uint32_t> rolls;
+};
+
+TEST(MatchServerTest, MatchesKeepTheirRandomAcrossWorkers) {
+    ServerConfig config;
+    config.tickMode = TickMode::Uncapped;
+    config.workerCount = 2;
+    config.pinWorkers = false;
+    config.rebalanceInterval = 30;
+    MatchServer server(config);
+
+    // Both heavy matches start on worker 0, so one of them migrates. Each
+    // pair shares a worker while the other one reseeds and rolls.
+    std::vector<RollingMatch*> matches;
+    for (int i = 0; i < 4; ++i) {
+        auto match = std::make_unique<RollingMatch>(i % 2 == 0 ? 10 : UINT64_MAX, 3 + i);
+        matches.push_back(match.get());
+        ASSERT_NE(server.AddMatch(std::move(match)), 0u);
+    }
+
+    uint64_t threadState = GetSimulationRandom().GetState();
+    server.RunTicks(120);
+    EXPECT_GE(server.GetMigrations(), 1u);
+    EXPECT_EQ(GetSimulationRandom().GetState(), threadState);
+
+    size_t migrated = 0;
+    for (RollingMatch* match : matches) {
+        migrated += match->threads.size() > 1 ? 1 : 0;
+
+        // Exactly the sequence of the match's own seed, from its start on
+        DeterministicRandom expected(match->network.GetReplayHeader(0).randomSeed);
+        ASSERT_EQ(match->rolls.size(), 120 - match->startTick + 1);
+        for (size_t i = 0; i < match->rolls.size(); ++i) {
+            ASSERT_EQ(match->rolls[i], expected.NextU32()) << "roll " << i;
+        }
+        EXPECT_EQ(match->GetRandom().GetState(), expected.GetState());
+    }
+    EXPECT_GE(migrated, 1u);
+}
+
+TEST(GameModeMatchTest, RealModesRunHeadless) {
+    // The actual game modes, characters and physics, as dfr_server runs them
+    const GameModeID modes[] = {GameModeID::Online, GameModeID::Versus,
+                                GameModeID::Training, GameModeID::Survival};
+    for (GameModeID mode : modes) {
+        GameModeMatch match(mode, 0);
+        ASSERT_TRUE(match.Start()) << match.GetKind();
+        EXPECT_GT(match.GetPort(), 0) << match.GetKind();
+
+        for (int i = 0; i < 600; ++i) {
+            match.Tick(1.0f / NetworkConfig::TICK_RATE);
+        }
+        EXPECT_FALSE(match.IsFinished()) << match.GetKind();
+        match.Stop();
+    }
+}
+
+// An online match between two real roster characters, already fighting,
+// stepped through RollbackEngine with inputs fed directly into buffers
+class OnlineRollbackTest : public ::testing::Test {
+protected:
+    struct Match {
+        OnlineMode mode;
+        DeterministicRandom random{42};
+        InputBuffer inputs[2] = {InputBuffer(0), InputBuffer(1)};
+        RollbackEngine engine{mode};
+
+        bool AdvanceFrame() {
+            ScopedSimulationRandom scope(random);
+            return engine.AdvanceFrame();
+        }
+    };
+
+    std::unique_ptr<Match> CreateMatch() {
+        CharacterFactory& factory = CharacterFactory::GetInstance();
+        factory.InitializeDefaultCharacters();
+        const auto& roster = factory.GetCharacterRoster();
+
+        auto match = std::make_unique<Match>();
+        match->mode.initialize();
+        for (int i = 0; i < 2 && i < static_cast<int>(roster.size()); ++i) {
+            match->mode.addPlayer(std::shared_ptr<CharacterBase>(factory.CreateCharacter(roster[i].id)));
+        }
+        match->mode.startMatch();
+        match->mode.setState(MatchState::InProgress);
+
+        match->engine.AddPlayer(&match->inputs[0]);
+        match->engine.AddPlayer(&match->inputs[1]);
+        match->engine.Reset(1);
+        return match;
+    }
+
+    static uint32_t ScriptedInput(uint32_t player, uint32_t frame) {
+        // Changes every few frames so predictions regularly miss
+        InputCommand input;
+        uint32_t phase = (frame * (player + 3)) / 5;
+        switch (phase % 6) {
+            case 0: input.action = InputAction::Move; input.direction = StickDirection::Forward; break;
+            case 1: input.action = InputAction::Move; input.direction = StickDirection::Back; break;
+            case 2: input.action = InputAction::Jump; break;
+            case 3: input.action = InputAction::Dash; input.direction = StickDirection::Forward; break;
+            case 4: input.action = InputAction::Block; break;
+            case 5: input.action = InputAction::Special; input.direction = StickDirection::Up; break;
+        }
+        return PackInput(input);
+    }
+
+    static void AddConfirmedInput(InputBuffer& buffer, uint32_t frame, uint32_t mask) {
+        buffer.AddInput(frame, &mask, 1, static_cast<uint16_t>(frame));
+    }
+};
+
+TEST_F(OnlineRollbackTest, StateFitsOneSnapshotSlot) {
+    auto match = CreateMatch();
+    ASSERT_EQ(match->mode.getPlayerCount(), 2);
+
+    uint8_t buffer[RollbackEngine::MAX_STATE_SIZE];
+    EXPECT_EQ(match->mode.SaveState(buffer, sizeof(buffer)), sizeof(OnlineMatchState));
+}
+
+TEST_F(OnlineRollbackTest, ResimulationMatchesConfirmedTimeline) {
+    const uint32_t frames = 600;
+    const uint32_t latency = 5;
+
+    // Reference: every input known in time
+    auto reference = CreateMatch();
+    // Online: the remote input arrives a few frames late
+    auto online = CreateMatch();
+
+    for (uint32_t frame = 1; frame <= frames + latency; ++frame) {
+        if (frame <= frames) {
+            AddConfirmedInput(reference->inputs[0], frame, ScriptedInput(0, frame));
+            AddConfirmedInput(reference->inputs[1], frame, ScriptedInput(1, frame));
+            ASSERT_TRUE(reference->AdvanceFrame());
+        }
+
+        if (frame > latency) {
+            AddConfirmedInput(online->inputs[1], frame - latency, ScriptedInput(1, frame - latency));
+        }
+        if (frame <= frames) {
+            AddConfirmedInput(online->inputs[0], frame, ScriptedInput(0, frame));
+            ASSERT_TRUE(online->AdvanceFrame());
+        }
+    }
+
+    // Apply the last late inputs
+    online->AdvanceFrame();
+    reference->AdvanceFrame();
+
+    const RollbackStats& stats = online->engine.GetStats();
+    EXPECT_GT(stats.rollbacks, 0u);
+    EXPECT_EQ(stats.missedRollbacks, 0u);
+    EXPECT_EQ(reference->engine.GetStats().rollbacks, 0u);
+
+    // Character ids differ between the two matches, so compare what they hold
+    EXPECT_EQ(online->mode.getState(), reference->mode.getState());
+    EXPECT_EQ(online->random.GetState(), reference->random.GetState());
+    for (int i = 0; i < 2; ++i) {
+        SCOPED_TRACE(i);
+        auto played = online->mode.getPlayer(i);
+        auto expected = reference->mode.getPlayer(i);
+        EXPECT_EQ(played->GetCurrentHealth(), expected->GetCurrentHealth());
+        EXPECT_EQ(played->GetCurrentMana(), expected->GetCurrentMana());
+        EXPECT_EQ(played->GetCurrentState(), expected->GetCurrentState());
+        EXPECT_EQ(played->GetCurrentGear(), expected->GetCurrentGear());
+        EXPECT_EQ(played->GetRigidBody()->position.x, expected->GetRigidBody()->position.x);
+        EXPECT_EQ(played->GetRigidBody()->position.y, expected->GetRigidBody()->position.y);
+        EXPECT_EQ(played->GetRigidBody()->velocity.x, expected->GetRigidBody()->velocity.x);
+        EXPECT_EQ(played->GetRigidBody()->velocity.y, expected->GetRigidBody()->velocity.y);
+    }
+}
+
+TEST_F(OnlineRollbackTest, SevenFrameResimPerformance) {
+    const uint32_t rollback = static_cast<uint32_t>(NetworkConfig::MAX_ROLLBACK_FRAMES);
+    auto match = CreateMatch();
+    InputBuffer& local = match->inputs[0];
+    InputBuffer& remote = match->inputs[1];
+
+    // Worst case every tick: the remote input from 7 frames ago always
+    // contradicts its prediction
+    uint32_t frame = 1;
+    auto step = [&]() {
+        if (frame > rollback) {
+            uint32_t predicted = remote.GetInputMask(frame - rollback);
+            uint32_t actual = ScriptedInput(1, frame - rollback);
+            if (actual == predicted) {
+                actual = PackInput(InputCommand{InputAction::Jump});
+                if (actual == predicted) {
+                    actual = PackInput(InputCommand{InputAction::Block});
+                }
+            }
+            AddConfirmedInput(remote, frame - rollback, actual);
+        }
+        AddConfirmedInput(local, frame, ScriptedInput(0, frame));
+        match->AdvanceFrame();
+        frame++;
+    };
+
+    for (int warmup = 0; warmup < 60; ++warmup) {
+        step();
+    }
+
+    const int ticks = 2000;
+    double worstMs = 0.0;
+    double totalMs = 0.0;
+    uint32_t rollbacksBefore = match->engine.GetStats().rollbacks;
+
+    for (int t = 0; t < ticks; ++t) {
+        auto start = std::chrono::high_resolution_clock::now();
+        step();
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        worstMs = std::max(worstMs, ms);
+        totalMs += ms;
+    }
+
+    std::cout << "Online match 7-frame rollback tick: avg " << totalMs / ticks << " ms, worst "
+              << worstMs << " ms, " << sizeof(OnlineMatchState) << " byte snapshot\n";
+
+    EXPECT_EQ(match->engine.GetStats().rollbacks - rollbacksBefore, static_cast<uint32_t>(ticks));
+    EXPECT_EQ(match->engine.GetStats().lastRollbackFrames, rollback);
+    EXPECT_LT(worstMs, 3.0);
+}
+
+} // namespace Tests
+} // namespace ArenaFighter
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace ArenaFighter {
+
+// Log-linear histogram of durations in nanoseconds, as in HdrHistogram:
+// each power of two is split into SUB_BUCKETS linear buckets, so any
+// recorded value is known to within 1/SUB_BUCKETS (12.5%) from 1 ns up
+// to about half an hour. Recording is a handful of integer operations
+// and never allocates.
+class TickHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = SUB_BUCKETS * (42 - SUB_BUCKET_BITS);
+
+    void Record(uint64_t nanoseconds) {
+        m_counts[BucketIndex(nanoseconds)]++;
+        m_count++;
+        m_sum += nanoseconds;
+        m_max = std::max(m_max, nanoseconds);
+    }
+
+    void Merge(const TickHistogram& other) {
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    void Reset() { *this = TickHistogram(); }
+
+    uint64_t GetCount() const { return m_count; }
+    uint64_t GetMax() const { return m_max; }
+    uint64_t GetMean() const { return m_count > 0 ? m_sum / m_count : 0; }
+
+    // Upper bound of the bucket holding the given fraction (0-1) of
+    // samples, so the true percentile is never underestimated
+    uint64_t GetPercentile(double fraction) const {
+        if (m_count == 0) {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(m_count));
+        rank = std::clamp<uint64_t>(rank, 1, m_count);
+
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) {
+                return std::min(BucketUpperBound(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    static int BucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<int>(value);
+        }
+
+        int msb = 63 - std::countl_zero(value);
+        int shift = msb - SUB_BUCKET_BITS;
+        int sub = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return std::min((shift + 1) * SUB_BUCKETS + sub, BUCKET_COUNT - 1);
+    }
+
+    // Largest value that falls into bucket index
+    static uint64_t BucketUpperBound(int index) {
+        if (index < SUB_BUCKETS) {
+            return static_cast<uint64_t>(index);
+        }
+
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+private:
+    std::array<uint32_t, BUCKET_COUNT> m_counts{};
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_max = 0;
+};
+
+} // namespace ArenaFighter
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "../Network/NetworkConfig.h"
+#include "../Network/RollbackEngine.h"
+
+namespace ArenaFighter {
+
+// Two fighters and a pool of projectiles with arcade movement, stage
+// bounds and hit checks; stands in for the real match state in network
+// tests and soak runs
+class ArenaSimulation : public RollbackSimulation {
+public:
+    static constexpr int MAX_PROJECTILES = 64;
+
+    enum Buttons : uint32_t { Left = 1, Right = 2, Jump = 4, Fire = 8 };
+
+    struct Fighter {
+        float x, y, vx, vy;
+        int32_t health;
+        int32_t cooldown;
+    };
+
+    struct Projectile {
+        float x, y, vx, vy;
+        int32_t owner;
+        int32_t lifetime;   // 0 = free slot
+    };
+
+    struct State {
+        uint32_t frame;
+        Fighter fighters[2];
+        Projectile projectiles[MAX_PROJECTILES];
+    };
+
+    ArenaSimulation() {
+        std::memset(&m_state, 0, sizeof(m_state));
+        m_state.fighters[0] = Fighter{-100.0f, 0.0f, 0.0f, 0.0f, 1000, 0};
+        m_state.fighters[1] = Fighter{100.0f, 0.0f, 0.0f, 0.0f, 1000, 0};
+    }
+
+    size_t SaveState(uint8_t* buffer, size_t capacity) const override {
+        if (capacity < sizeof(m_state)) return 0;
+        std::memcpy(buffer, &m_state, sizeof(m_state));
+        return sizeof(m_state);
+    }
+
+    void LoadState(const uint8_t* data, size_t size) override {
+        if (size == sizeof(m_state)) std::memcpy(&m_state, data, size);
+    }
+
+    size_t DescribeState(StateField* fields, size_t maxFields) const override {
+        const StateField layout[] = {
+            {"frame", offsetof(State, frame), sizeof(uint32_t)},
+            {"fighters[0]", offsetof(State, fighters), sizeof(Fighter)},
+            {"fighters[1]", offsetof(State, fighters) + sizeof(Fighter), sizeof(Fighter)},
+            {"projectiles", offsetof(State, projectiles), sizeof(m_state.projectiles)},
+        };
+        size_t count = std::min(maxFields, sizeof(layout) / sizeof(layout[0]));
+        std::copy(layout, layout + count, fields);
+        return count;
+    }
+
+    void AdvanceFrame(const uint32_t* inputs, size_t playerCount) override {
+        const float dt = 1.0f / NetworkConfig::TICK_RATE;
+        m_state.frame++;
+
+        for (size_t p = 0; p < 2 && p < playerCount; ++p) {
+            Fighter& fighter = m_state.fighters[p];
+            uint32_t input = inputs[p];
+
+            float target = (input & Right ? 300.0f : 0.0f) - (input & Left ? 300.0f : 0.0f);
+            fighter.vx += (target - fighter.vx) * 0.25f;
+            if ((input & Jump) && fighter.y <= 0.0f) fighter.vy = 700.0f;
+            fighter.vy = std::max(fighter.vy - 1200.0f * dt, -800.0f);
+
+            fighter.x = std::clamp(fighter.x + fighter.vx * dt, -400.0f, 400.0f);
+            fighter.y = std::max(fighter.y + fighter.vy * dt, 0.0f);
+            if (fighter.y <= 0.0f) fighter.vy = 0.0f;
+
+            if (fighter.cooldown > 0) fighter.cooldown--;
+            if ((input & Fire) && fighter.cooldown == 0) {
+                Spawn(static_cast<int32_t>(p));
+                fighter.cooldown = 2;
+            }
+        }
+
+        for (Projectile& projectile : m_state.projectiles) {
+            if (projectile.lifetime == 0) continue;
+
+            projectile.lifetime--;
+            projectile.vy -= 200.0f * dt;
+            projectile.x += projectile.vx * dt;
+            projectile.y += projectile.vy * dt;
+            if (projectile.x < -400.0f || projectile.x > 400.0f || projectile.y < 0.0f) {
+                projectile.lifetime = 0;
+                continue;
+            }
+
+            Fighter& target = m_state.fighters[1 - projectile.owner];
+            if (std::abs(projectile.x - target.x) < 30.0f && std::abs(projectile.y - target.y - 60.0f) < 60.0f) {
+                target.health -= 10;
+                target.vx += projectile.vx * 0.1f;
+                projectile.lifetime = 0;
+            }
+        }
+
+        // Opposing projectiles cancel each other out
+        for (int i = 0; i < MAX_PROJECTILES; ++i) {
+            Projectile& a = m_state.projectiles[i];
+            if (a.lifetime == 0) continue;
+            for (int j = i + 1; j < MAX_PROJECTILES; ++j) {
+                Projectile& b = m_state.projectiles[j];
+                if (b.lifetime == 0 || a.owner == b.owner) continue;
+                float dx = a.x - b.x;
+                float dy = a.y - b.y;
+                if (dx * dx + dy * dy < 400.0f) {
+                    a.lifetime = 0;
+                    b.lifetime = 0;
+                    break;
+                }
+            }
+        }
+    }
+
+    const State& GetState() const { return m_state; }
+
+    int ActiveProjectiles() const {
+        int count = 0;
+        for (const Projectile& projectile : m_state.projectiles) {
+            count += projectile.lifetime > 0;
+        }
+        return count;
+    }
+
+private:
+    void Spawn(int32_t owner) {
+        const Fighter& fighter = m_state.fighters[owner];
+        for (Projectile& projectile : m_state.projectiles) {
+            if (projectile.lifetime != 0) continue;
+            float direction = owner == 0 ? 1.0f : -1.0f;
+            projectile = Projectile{fighter.x, fighter.y + 60.0f, 500.0f * direction, 150.0f, owner, 90};
+            return;
+        }
+    }
+
+    State m_state;
+};
+
+} // namespace ArenaFighter
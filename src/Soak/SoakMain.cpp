@@ -0,0 +1,192 @@
+#include "SoakMatch.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ArenaFighter;
+
+namespace {
+
+struct LinkProfile {
+    const char* name;
+    LinkConditions conditions;   // Both directions
+};
+
+// From a clean LAN to a congested mobile link. Latencies are one-way.
+const LinkProfile PROFILES[] = {
+    { "clean",    {} },
+    { "lan",      { 1.0f, 1.0f, 0.0f, 0.0f, 0.0f } },
+    { "regional", { 20.0f, 4.0f, 0.005f, 0.0f, 0.0f } },
+    { "wifi",     { 15.0f, 15.0f, 0.02f, 0.01f, 0.005f } },
+    { "overseas", { 75.0f, 10.0f, 0.01f, 0.005f, 0.0f } },
+    { "mobile",   { 50.0f, 40.0f, 0.05f, 0.02f, 0.01f } },
+};
+
+constexpr size_t PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+struct ProfileTotals {
+    uint32_t matches = 0;
+    uint32_t failed = 0;
+    uint32_t incomplete = 0;
+    uint32_t desyncs = 0;
+    uint32_t replayMismatches = 0;
+    size_t maxReplayBytes = 0;
+    uint64_t rollbacks = 0;
+    uint64_t resimulatedFrames = 0;
+    uint32_t maxRollbackFrames = 0;
+    uint64_t missedRollbacks = 0;
+    uint64_t stallFrames = 0;
+    double predictionAccuracy = 0.0;   // Sum over matches
+    TickHistogram resimTime;
+    uint64_t firstFailedSeed = 0;
+
+    void Add(const SoakResult& result, uint64_t seed) {
+        matches++;
+        if (!result.Passed()) {
+            if (failed++ == 0) {
+                firstFailedSeed = seed;
+            }
+        }
+        incomplete += result.completed ? 0 : 1;
+        desyncs += (result.desyncReported || result.finalStateMismatch) ? 1 : 0;
+        replayMismatches += result.replayMismatch ? 1 : 0;
+        maxReplayBytes = std::max(maxReplayBytes, result.replayBytes);
+        rollbacks += result.rollbacks;
+        resimulatedFrames += result.resimulatedFrames;
+        maxRollbackFrames = std::max(maxRollbackFrames, result.maxRollbackFrames);
+        missedRollbacks += result.missedRollbacks;
+        stallFrames += result.stallFrames;
+        predictionAccuracy += result.predictionAccuracy;
+        resimTime.Merge(result.resimTime);
+    }
+};
+
+void PrintTotals(const char* name, const ProfileTotals& totals) {
+    if (totals.matches == 0) {
+        return;
+    }
+
+    std::cout << name << ": " << totals.matches << " matches, " << totals.failed << " failed ("
+              << totals.incomplete << " incomplete, " << totals.desyncs << " desynced, "
+              << totals.replayMismatches << " bad replays)";
+    if (totals.failed > 0) {
+        std::cout << ", first failing seed " << totals.firstFailedSeed;
+    }
+    std::cout << "\n  rollbacks " << totals.rollbacks / totals.matches << " per match, "
+              << totals.resimulatedFrames / totals.matches << " frames resimulated, deepest "
+              << totals.maxRollbackFrames << ", " << totals.missedRollbacks << " missed\n"
+              << "  prediction accuracy " << totals.predictionAccuracy / totals.matches * 100.0 << "%, "
+              << totals.stallFrames / totals.matches << " stalled frames per match\n"
+              << "  replays up to " << totals.maxReplayBytes << " bytes\n"
+              << "  rollback ticks: p50 " << totals.resimTime.GetPercentile(0.5) / 1000
+              << " us, p99 " << totals.resimTime.GetPercentile(0.99) / 1000
+              << " us, max " << totals.resimTime.GetMax() / 1000 << " us" << std::endl;
+}
+
+void PrintUsage() {
+    std::cout << "Usage: dfr_soak [options]\n"
+              << "  --matches N      Matches per link profile (default 100)\n"
+              << "  --parallel N     Matches played at once (default 64)\n"
+              << "  --frames N       Frames per match (default 600)\n"
+              << "  --seed S         Seed of the first match (default 1)\n"
+              << "  --profile NAME   Only this link profile:";
+    for (const LinkProfile& profile : PROFILES) {
+        std::cout << " " << profile.name;
+    }
+    std::cout << "\nExits with 1 if any match desynced, did not finish or did not replay." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t matchesPerProfile = 100;
+    uint32_t parallel = 64;
+    uint32_t frames = 600;
+    uint64_t firstSeed = 1;
+    std::string only;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--matches" && hasValue) {
+            matchesPerProfile = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (arg == "--parallel" && hasValue) {
+            parallel = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+        } else if (arg == "--frames" && hasValue) {
+            frames = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+        } else if (arg == "--seed" && hasValue) {
+            firstSeed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--profile" && hasValue) {
+            only = argv[++i];
+        } else {
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<size_t> profiles;
+    for (size_t i = 0; i < PROFILE_COUNT; ++i) {
+        if (only.empty() || only == PROFILES[i].name) {
+            profiles.push_back(i);
+        }
+    }
+    if (profiles.empty()) {
+        std::cerr << "Unknown profile: " << only << std::endl;
+        return 1;
+    }
+
+    // Matches spend nearly all their time waiting on the frame clock, so
+    // far more of them than there are cores can run at once
+    const uint32_t total = matchesPerProfile * static_cast<uint32_t>(profiles.size());
+    std::cout << "Playing " << total << " matches of " << frames << " frames, "
+              << parallel << " at a time" << std::endl;
+
+    ProfileTotals totals[PROFILE_COUNT];
+    std::mutex totalsMutex;
+    std::atomic<uint32_t> next{0};
+    std::atomic<uint32_t> done{0};
+
+    auto worker = [&]() {
+        for (uint32_t index = next++; index < total; index = next++) {
+            size_t profile = profiles[index % profiles.size()];
+            SoakConfig config;
+            config.toHost = PROFILES[profile].conditions;
+            config.toClient = PROFILES[profile].conditions;
+            config.frames = frames;
+            config.seed = firstSeed + index;
+
+            SoakResult result = RunSoakMatch(config);
+
+            std::lock_guard<std::mutex> lock(totalsMutex);
+            totals[profile].Add(result, config.seed);
+            uint32_t finished = ++done;
+            if (finished % 100 == 0) {
+                std::cout << finished << "/" << total << " done" << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < std::min(parallel, total); ++i) {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    uint32_t failed = 0;
+    for (size_t profile : profiles) {
+        PrintTotals(PROFILES[profile].name, totals[profile]);
+        failed += totals[profile].failed;
+    }
+
+    std::cout << (failed == 0 ? "PASS" : "FAIL") << ": " << failed << " of " << total
+              << " matches failed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+#include "SoakMatch.h"
+#include "ArenaSimulation.h"
+#include "../Core/DeterministicRandom.h"
+#include "../Network/InputBuffer.h"
+#include "../Network/NetworkManager.h"
+#include "../Network/Replay.h"
+#include "../Network/RollbackEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace ArenaFighter {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t HOST_ID = 1;
+constexpr uint32_t CLIENT_ID = 2;
+
+// Time left after the last frame for the final state hashes to cross
+constexpr float HASH_LINGER_SECONDS = 0.5f;
+
+// Holds a button combination for a while, then picks another; now and
+// then mashes, changing every frame. Prediction by repeating the last
+// input is right most of the time, but not always.
+class SoakBot {
+public:
+    explicit SoakBot(uint64_t seed) : m_random(seed), m_mask(0), m_framesLeft(0), m_mashing(false) {}
+
+    uint32_t NextInput() {
+        if (m_framesLeft == 0) {
+            m_mashing = m_random.NextChance(10);
+            m_framesLeft = static_cast<uint32_t>(m_random.NextRange(m_mashing ? 5 : 4, m_mashing ? 15 : 40));
+            m_mask = m_random.NextInt(16);
+        }
+        m_framesLeft--;
+
+        if (m_mashing) {
+            m_mask ^= 1u << m_random.NextInt(4);
+        }
+        return m_mask;
+    }
+
+private:
+    DeterministicRandom m_random;
+    uint32_t m_mask;
+    uint32_t m_framesLeft;
+    bool m_mashing;
+};
+
+class SoakPeer {
+public:
+    SoakPeer(uint32_t remoteId, uint64_t botSeed, uint32_t frames)
+        : m_remoteId(remoteId), m_frames(frames), m_bot(botSeed), m_remote(nullptr),
+          m_replayWriter(m_replay), m_inMatch(false), m_accumulator(0.0f), m_lastSentFrame(0), m_lastMask(0),
+          m_stallFrames(0) {
+        m_network.SetOnMatchStart([this](uint32_t, uint8_t) { m_inMatch = true; });
+    }
+
+    NetworkManager& GetNetwork() { return m_network; }
+    bool IsInMatch() const { return m_inMatch; }
+    bool IsFinished() const { return m_engine && m_engine->GetCurrentFrame() > m_frames; }
+    const ArenaSimulation& GetSimulation() const { return m_simulation; }
+    const RollbackEngine* GetEngine() const { return m_engine.get(); }
+    const InputBuffer* GetRemoteBuffer() const { return m_remote; }
+    uint32_t GetStallFrames() const { return m_stallFrames; }
+    const TickHistogram& GetResimTime() const { return m_resimTime; }
+    std::string GetReplay() const { return m_replay.str(); }
+
+    void Step(float deltaTime) {
+        m_network.Update(deltaTime);
+        if (!m_inMatch) {
+            return;
+        }
+
+        // Our inputs go out from the start; the engine waits for the
+        // peer's first one, which creates its input buffer
+        if (!m_engine && !TryBegin()) {
+            SendInputs(1);
+            return;
+        }
+
+        m_accumulator += deltaTime;
+        const float interval = m_network.GetTickScale() / NetworkConfig::TICK_RATE;
+        while (m_accumulator >= interval && !IsFinished()) {
+            m_accumulator -= interval;
+            uint32_t frame = m_engine->GetCurrentFrame();
+            SendInputs(frame);
+
+            // Never run further ahead than a rollback can repair, and only
+            // simulate the last frame once every input for it is in, so the
+            // final state is confirmed
+            uint32_t remoteFrame = m_remote->GetContiguousFrame();
+            if (remoteFrame + NetworkConfig::MAX_ROLLBACK_FRAMES < frame ||
+                (frame == m_frames && remoteFrame < frame)) {
+                m_stallFrames++;
+                continue;
+            }
+
+            uint32_t rollbacks = m_engine->GetStats().rollbacks;
+            Clock::time_point start = Clock::now();
+            m_engine->AdvanceFrame();
+            if (m_engine->GetStats().rollbacks != rollbacks) {
+                m_resimTime.Record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+            }
+        }
+
+        if (IsFinished()) {
+            m_engine->FinishReplay();
+
+            // Keep repeating the tail in case its last packets were lost
+            SendInputs(m_frames);
+        }
+    }
+
+private:
+    bool TryBegin() {
+        InputBuffer* local = m_network.GetInputBuffer(static_cast<uint32_t>(m_network.GetLocalPlayerId()));
+        m_remote = m_network.GetInputBuffer(m_remoteId);
+        if (!local || !m_remote) {
+            return false;
+        }
+
+        m_remote->SetPredictor(std::make_unique<NGramPredictor>(ArenaSimulation::Left | ArenaSimulation::Right));
+
+        m_engine = std::make_unique<RollbackEngine>(m_simulation);
+        // Same slot order on both peers: host first
+        if (m_remoteId == HOST_ID) {
+            m_engine->AddPlayer(m_remote);
+            m_engine->AddPlayer(local);
+        } else {
+            m_engine->AddPlayer(local);
+            m_engine->AddPlayer(m_remote);
+        }
+        m_engine->Reset(1);
+        m_engine->AttachDesyncDetector(&m_network.GetDesyncDetector());
+        if (m_replayWriter.Begin(m_network.GetReplayHeader(1))) {
+            m_engine->AttachReplayWriter(&m_replayWriter);
+        }
+        m_network.AttachRollbackEngine(m_engine.get());
+        return true;
+    }
+
+    // Samples the bot up to frame + input delay. When the delay grows the
+    // last input is repeated over the gap; when it shrinks, nothing is
+    // sampled until the frames catch up.
+    void SendInputs(uint32_t frame) {
+        uint32_t target = std::min(frame + static_cast<uint32_t>(m_network.GetInputDelay()), m_frames);
+        if (target <= m_lastSentFrame) {
+            if (m_lastSentFrame > 0) {
+                m_network.SendInput(m_lastSentFrame, m_lastMask, static_cast<uint16_t>(m_lastSentFrame));
+            }
+            return;
+        }
+
+        uint32_t mask = m_bot.NextInput();
+        while (m_lastSentFrame < target) {
+            m_lastSentFrame++;
+            m_lastMask = m_lastSentFrame == target ? mask : m_lastMask;
+            m_network.SendInput(m_lastSentFrame, m_lastMask, static_cast<uint16_t>(m_lastSentFrame));
+        }
+    }
+
+    uint32_t m_remoteId;
+    uint32_t m_frames;
+    NetworkManager m_network;
+    ArenaSimulation m_simulation;
+    std::unique_ptr<RollbackEngine> m_engine;
+    SoakBot m_bot;
+    InputBuffer* m_remote;
+    std::ostringstream m_replay;
+    ReplayWriter m_replayWriter;
+
+    bool m_inMatch;
+    float m_accumulator;
+    uint32_t m_lastSentFrame;
+    uint32_t m_lastMask;
+    uint32_t m_stallFrames;
+    TickHistogram m_resimTime;
+};
+
+float Seconds(Clock::duration duration) {
+    return std::chrono::duration<float>(duration).count();
+}
+
+// Plays replay into a fresh simulation; true if it ends where live did
+bool ReplayMatches(const std::string& replay, const ArenaSimulation& live) {
+    std::istringstream in(replay);
+    ReplayReader reader(in);
+    if (!reader.Open()) {
+        return false;
+    }
+
+    ArenaSimulation simulation;
+    ReplayResult result = PlayReplay(reader, simulation);
+    return result.verified &&
+        std::memcmp(&simulation.GetState(), &live.GetState(), sizeof(ArenaSimulation::State)) == 0;
+}
+
+} // namespace
+
+SoakResult RunSoakMatch(const SoakConfig& config) {
+    SoakResult result;
+    Clock::time_point start = Clock::now();
+
+    SoakPeer host(CLIENT_ID, config.seed * 2 + 1, config.frames);
+    SoakPeer client(HOST_ID, config.seed * 2 + 2, config.frames);
+    LinkEmulator link(static_cast<uint32_t>(config.seed));
+
+    UdpEndpoint hostEndpoint;
+    if (!host.GetNetwork().Initialize() || !client.GetNetwork().Initialize() ||
+        !host.GetNetwork().StartHost(0) ||
+        !UdpEndpoint::Resolve("127.0.0.1", host.GetNetwork().GetLocalPort(), hostEndpoint) ||
+        !link.Start(hostEndpoint) ||
+        !client.GetNetwork().ConnectToHost("127.0.0.1", link.GetLocalPort())) {
+        return result;
+    }
+
+    bool started = false;
+    bool impaired = false;
+    Clock::time_point finishedAt;
+    bool finished = false;
+    Clock::time_point last = start;
+
+    while (Seconds(Clock::now() - start) < config.timeoutSeconds) {
+        link.Update();
+
+        Clock::time_point now = Clock::now();
+        float deltaTime = Seconds(now - last);
+        last = now;
+
+        host.Step(deltaTime);
+        client.Step(deltaTime);
+        link.Update();
+
+        if (!started && client.GetNetwork().GetConnectionState() == ConnectionState::Connected &&
+            host.GetNetwork().GetPlayerCount() > 1) {
+            host.GetNetwork().StartMatch();
+            started = true;
+        }
+        if (!impaired && host.IsInMatch() && client.IsInMatch()) {
+            link.SetConditions(config.toHost, config.toClient);
+            impaired = true;
+        }
+
+        if (!finished && host.IsFinished() && client.IsFinished()) {
+            finished = true;
+            finishedAt = now;
+        }
+        if (finished && Seconds(now - finishedAt) >= HASH_LINGER_SECONDS) {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(250));
+    }
+
+    result.completed = finished;
+    result.seconds = Seconds(Clock::now() - start);
+    result.finalStateMismatch = finished &&
+        std::memcmp(&host.GetSimulation().GetState(), &client.GetSimulation().GetState(),
+                    sizeof(ArenaSimulation::State)) != 0;
+
+    float accuracy = 0.0f;
+    int peerIndex = 0;
+    for (SoakPeer* peer : { &host, &client }) {
+        DesyncDetector& detector = peer->GetNetwork().GetDesyncDetector();
+        result.desyncReported |= detector.HasDesynced();
+        result.hashChecks += detector.GetMatchedChecks();
+        result.stallFrames += peer->GetStallFrames();
+        result.resimTime.Merge(peer->GetResimTime());
+        result.finalInputDelay[peerIndex++] = peer->GetNetwork().GetInputDelay();
+
+        if (const RollbackEngine* engine = peer->GetEngine()) {
+            const RollbackStats& stats = engine->GetStats();
+            result.rollbacks += stats.rollbacks;
+            result.resimulatedFrames += stats.resimulatedFrames;
+            result.maxRollbackFrames = std::max(result.maxRollbackFrames, stats.maxRollbackFrames);
+            result.missedRollbacks += stats.missedRollbacks;
+        }
+        if (const InputBuffer* remote = peer->GetRemoteBuffer()) {
+            accuracy += remote->GetPredictionAccuracy() / 2.0f;
+        }
+
+        std::string replay = peer->GetReplay();
+        result.replayBytes = std::max(result.replayBytes, replay.size());
+        result.replayMismatch |= finished && !ReplayMatches(replay, peer->GetSimulation());
+    }
+    result.predictionAccuracy = accuracy;
+    result.link[LinkEmulator::ToServer] = link.GetStats(LinkEmulator::ToServer);
+    result.link[LinkEmulator::ToClient] = link.GetStats(LinkEmulator::ToClient);
+
+    client.GetNetwork().Shutdown();
+    host.GetNetwork().Shutdown();
+    return result;
+}
+
+} // namespace ArenaFighter
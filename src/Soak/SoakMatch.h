@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "../Network/LinkEmulator.h"
+#include "../Server/TickHistogram.h"
+
+namespace ArenaFighter {
+
+struct SoakConfig {
+    LinkConditions toHost;
+    LinkConditions toClient;
+    uint32_t frames = 600;          // Match length
+    uint64_t seed = 1;              // Bot scripts and link randomness
+    float timeoutSeconds = 60.0f;
+};
+
+struct SoakResult {
+    bool completed = false;           // Both peers simulated every frame in time
+    bool desyncReported = false;      // A peer's DesyncDetector saw differing hashes
+    bool finalStateMismatch = false;  // The two final states are not byte-identical
+    bool replayMismatch = false;      // A peer's replay did not play back to its final state
+    size_t replayBytes = 0;           // Largest of the two peers' replays
+    uint32_t hashChecks = 0;          // Matching hash comparisons, both peers
+    uint32_t rollbacks = 0;
+    uint32_t resimulatedFrames = 0;
+    uint32_t maxRollbackFrames = 0;
+    uint32_t missedRollbacks = 0;     // Corrections older than the snapshot ring
+    uint32_t stallFrames = 0;         // Frame intervals spent waiting for the peer
+    float predictionAccuracy = 0.0f;  // Mean of both peers' remote InputBuffers
+    int finalInputDelay[2] = {};
+    TickHistogram resimTime;          // Ticks that rolled back, nanoseconds
+    LinkStats link[2];                // By LinkEmulator::Direction
+    double seconds = 0.0;
+
+    bool Passed() const {
+        return completed && !desyncReported && !finalStateMismatch && !replayMismatch && missedRollbacks == 0;
+    }
+};
+
+// Plays one scripted bot match between a host and a client NetworkManager
+// on loopback, with a LinkEmulator in between. Each peer simulates an
+// ArenaSimulation through a RollbackEngine fed by its manager's input
+// buffers, so the whole path is exercised: input delay, redundancy,
+// prediction, rollback and state hash exchange. Each peer also records a
+// replay, which is played back afterwards and must end in the same state. Runs in real time on the
+// calling thread; a 600 frame match takes about ten seconds.
+//
+// The link is clean until both peers are in the match, since connecting
+// and starting a match are not retransmitted yet.
+SoakResult RunSoakMatch(const SoakConfig& config);
+
+} // namespace ArenaFighter
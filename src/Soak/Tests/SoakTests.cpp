@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "../SoakMatch.h"
+#include <iostream>
+
+namespace ArenaFighter {
+namespace Tests {
+
+TEST(SoakTest, CleanLinkStaysInSync) {
+    SoakConfig config;
+    config.frames = 240;
+
+    SoakResult result = RunSoakMatch(config);
+    EXPECT_TRUE(result.completed);
+    EXPECT_FALSE(result.desyncReported);
+    EXPECT_FALSE(result.finalStateMismatch);
+    EXPECT_GT(result.hashChecks, 0u);
+}
+
+// One short match on a bad link; dfr_soak plays thousands of these
+TEST(SoakTest, ImpairedLinkStaysInSync) {
+    SoakConfig config;
+    config.frames = 300;
+    config.seed = 3;
+    config.toHost = { 40.0f, 15.0f, 0.05f, 0.02f, 0.02f };
+    config.toClient = config.toHost;
+
+    SoakResult result = RunSoakMatch(config);
+    std::cout << "Impaired link: " << result.rollbacks << " rollbacks, deepest "
+              << result.maxRollbackFrames << ", prediction accuracy "
+              << result.predictionAccuracy * 100.0f << "%, rollback tick p99 "
+              << result.resimTime.GetPercentile(0.99) / 1000 << " us\n";
+
+    EXPECT_TRUE(result.Passed());
+    EXPECT_GT(result.rollbacks, 0u);
+    EXPECT_GT(result.link[LinkEmulator::ToServer].dropped, 0u);
+    EXPECT_GT(result.link[LinkEmulator::ToClient].dropped, 0u);
+}
+
+} // namespace Tests
+} // namespace ArenaFighter